@@ -35,8 +35,11 @@
  *
  * Benchmarks cover:
  * - Query protocol serialization/deserialization throughput
+ * - Compact binary (v2) wire encoding versus the v1 container encoding
+ * - Columnar versus row layout of wide, repetitive results
  * - Query router routing overhead (target: < 1ms)
  * - Auth middleware authentication throughput
+ * - JWT signature verifications per second per core
  * - Rate limiter performance
  * - Overall pipeline throughput (target: 10k+ queries/sec)
  */
@@ -51,11 +54,15 @@
 #include <vector>
 
 #include <kcenon/database_server/gateway/auth_middleware.h>
+#include <kcenon/database_server/gateway/jwt_validator.h>
 #include <kcenon/database_server/gateway/query_protocol.h>
 #include <kcenon/database_server/gateway/query_router.h>
 #include <kcenon/database_server/gateway/query_types.h>
+#include <kcenon/database_server/gateway/request_view.h>
+#include <kcenon/database_server/gateway/wire_format.h>
 
 #include <kcenon/common/config/feature_flags.h>
+#include <kcenon/database_server/gateway/container_compat.h>
 
 using namespace database_server::gateway;
 
@@ -150,6 +157,33 @@ protected:
 		return response;
 	}
 
+	/// Analytics-style result: timestamps, enum-like status, small counters, NULLs
+	query_response create_event_response(size_t row_count)
+	{
+		static const char* statuses[] = { "ok", "retry", "failed", "timeout" };
+		query_response response(message_counter_++);
+
+		for (size_t i = 0; i < row_count; ++i)
+		{
+			result_row row;
+			row.cells.emplace_back(static_cast<int64_t>(1700000000000 + i * 250));
+			row.cells.emplace_back(std::string(statuses[i % 7 == 0 ? 2 : i % 2]));
+			row.cells.emplace_back(static_cast<int64_t>(i % 50));
+			row.cells.emplace_back(static_cast<double>(i % 1000) * 0.25);
+			if (i % 10 == 0)
+			{
+				row.cells.emplace_back(std::monostate{});
+			}
+			else
+			{
+				row.cells.emplace_back(std::string("eu-west-1"));
+			}
+			response.rows.push_back(std::move(row));
+		}
+
+		return response;
+	}
+
 	auth_config auth_config_;
 	rate_limit_config rate_config_;
 	router_config router_config_;
@@ -201,6 +235,7 @@ BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, RouterOverhead)
 
 BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, AuthValidation)(benchmark::State& state)
 {
+	auth_config_.cache_validated_tokens = state.range(0) != 0;
 	auth_middleware middleware(auth_config_, rate_config_);
 	auto token = create_valid_token();
 
@@ -213,9 +248,13 @@ BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, AuthValidation)(benchmark::State& st
 	state.SetItemsProcessed(state.iterations());
 	state.counters["auth_attempts"] = middleware.metrics().total_auth_attempts.load();
 	state.counters["success_rate"] = middleware.metrics().success_rate();
+	state.counters["cache_hits"] = middleware.metrics().token_cache_hits.load();
 }
 
 BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, AuthValidation)
+	->ArgName("token_cache")
+	->Arg(0)
+	->Arg(1)
 	->Unit(benchmark::kNanosecond)
 	->Iterations(100000);
 
@@ -238,6 +277,110 @@ BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, AuthWithRateLimiting)
 	->Unit(benchmark::kNanosecond)
 	->Iterations(100000);
 
+namespace
+{
+
+std::string base64url_encode(std::string_view data)
+{
+	static constexpr char alphabet[]
+		= "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+	std::string out;
+	uint32_t buffer = 0;
+	int bits = 0;
+	for (unsigned char c : data)
+	{
+		buffer = (buffer << 8) | c;
+		bits += 8;
+		while (bits >= 6)
+		{
+			bits -= 6;
+			out.push_back(alphabet[(buffer >> bits) & 0x3f]);
+		}
+	}
+	if (bits > 0)
+	{
+		out.push_back(alphabet[(buffer << (6 - bits)) & 0x3f]);
+	}
+	return out;
+}
+
+/// Distinct signed tokens, so every verification computes a signature
+std::vector<auth_token> create_signed_tokens(jwt_algorithm algorithm, const std::string& secret,
+											 size_t count)
+{
+	auto expires = std::chrono::duration_cast<std::chrono::seconds>(
+					   (std::chrono::system_clock::now() + std::chrono::hours(1))
+						   .time_since_epoch())
+					   .count();
+	auto header = base64url_encode(std::string(R"({"alg":")") + to_string(algorithm)
+								   + R"(","typ":"JWT","kid":"bench"})");
+
+	std::vector<auth_token> tokens(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		auto input = header + "."
+					 + base64url_encode(R"({"sub":"client-)" + std::to_string(i)
+										+ R"(","exp":)" + std::to_string(expires)
+										+ R"(,"scope":"read write"})");
+		std::string signature;
+		if (algorithm == jwt_algorithm::hs512)
+		{
+			auto mac = hmac_sha512(secret).sign(input);
+			signature.assign(reinterpret_cast<const char*>(mac.data()), mac.size());
+		}
+		else
+		{
+			auto mac = hmac_sha256(secret).sign(input);
+			signature.assign(reinterpret_cast<const char*>(mac.data()), mac.size());
+		}
+		tokens[i].token = input + "." + base64url_encode(signature);
+		tokens[i].client_id = "client-" + std::to_string(i);
+	}
+	return tokens;
+}
+
+} // namespace
+
+/**
+ * Full verification (decode, HMAC, claims) of tokens the cache has not
+ * seen, as for a burst of new connections. "verifications_per_core" is
+ * the rate of one thread; runs with more threads show the scaling.
+ */
+static void BM_JwtVerification(benchmark::State& state)
+{
+	auto algorithm = static_cast<jwt_algorithm>(state.range(0));
+	const std::string secret(64, 'k');
+
+	jwt_validator validator;
+	validator.add_key({ "bench", algorithm, secret });
+	auto tokens = create_signed_tokens(algorithm, secret, 1024);
+
+	size_t index = 0;
+	for (auto _ : state)
+	{
+		auto result = validator.validate(tokens[index++ & 1023]);
+		if (!result.success)
+		{
+			state.SkipWithError(result.message.c_str());
+			break;
+		}
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	state.counters["verifications_per_core"] = benchmark::Counter(
+		static_cast<double>(state.iterations()),
+		benchmark::Counter::kIsRate | benchmark::Counter::kAvgThreads);
+}
+
+BENCHMARK(BM_JwtVerification)
+	->ArgName("alg")
+	->Arg(static_cast<int>(jwt_algorithm::hs256))
+	->Arg(static_cast<int>(jwt_algorithm::hs512))
+	->Unit(benchmark::kMicrosecond)
+	->Threads(1)
+	->ThreadPerCpu();
+
 // ============================================================================
 // Rate Limiter Benchmarks
 // ============================================================================
@@ -259,9 +402,13 @@ BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, RateLimiterCheck)
 	->Unit(benchmark::kNanosecond)
 	->Iterations(100000);
 
+// Args: client count, algorithm (0 = sliding window, 1 = GCRA, 2 = shared GCRA)
 BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, RateLimiterMultiClient)
 (benchmark::State& state)
 {
+	rate_config_.algorithm = static_cast<rate_limit_algorithm>(state.range(1));
+	rate_config_.shared_segment_name = "/database_server-bench-ratelimit";
+	(void)shared_gcra_limiter::remove(rate_config_.shared_segment_name);
 	rate_limiter limiter(rate_config_);
 	const int num_clients = state.range(0);
 	int client_index = 0;
@@ -276,13 +423,12 @@ BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, RateLimiterMultiClient)
 
 	state.SetItemsProcessed(state.iterations());
 	state.counters["clients"] = num_clients;
+	(void)shared_gcra_limiter::remove(rate_config_.shared_segment_name);
 }
 
 BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, RateLimiterMultiClient)
 	->Unit(benchmark::kNanosecond)
-	->Arg(10)
-	->Arg(100)
-	->Arg(1000);
+	->ArgsProduct({ { 10, 100, 1000 }, { 0, 1, 2 } });
 
 // ============================================================================
 // Query Protocol Benchmarks
@@ -363,6 +509,33 @@ BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, RequestDeserialize)
 	->Unit(benchmark::kMicrosecond)
 	->Iterations(10000);
 
+// Receive path: bytes -> value_container -> query_request
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, RequestDeserializeBytes)
+(benchmark::State& state)
+{
+	auto request = create_complex_request();
+	auto bytes = request.serialize()->serialize(
+		container_module::value_container::serialization_format::binary);
+	if (bytes.is_err())
+	{
+		state.SkipWithError("serialization failed");
+		return;
+	}
+	const auto& data = bytes.value();
+
+	for (auto _ : state)
+	{
+		auto result = query_request::deserialize(data);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, RequestDeserializeBytes)
+	->Unit(benchmark::kMicrosecond)
+	->Iterations(10000);
+
 BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, RequestRoundTrip)(benchmark::State& state)
 {
 	for (auto _ : state)
@@ -424,6 +597,213 @@ BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, ResponseDeserialize)
 
 #endif // KCENON_WITH_CONTAINER_SYSTEM
 
+// ============================================================================
+// Wire Protocol v2 Benchmarks
+// ============================================================================
+
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, WireV2RequestEncode)(benchmark::State& state)
+{
+	auto request = create_complex_request();
+	size_t bytes = 0;
+
+	for (auto _ : state)
+	{
+		auto frame = encode_wire_v2(request);
+		bytes = frame.size();
+		benchmark::DoNotOptimize(frame);
+	}
+
+	state.counters["frame_bytes"] = static_cast<double>(bytes);
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, WireV2RequestEncode)
+	->Unit(benchmark::kMicrosecond)
+	->Iterations(10000);
+
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, WireV2RequestDecode)(benchmark::State& state)
+{
+	auto frame = encode_wire_v2(create_complex_request());
+
+	for (auto _ : state)
+	{
+		auto result = decode_request_v2(frame);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, WireV2RequestDecode)
+	->Unit(benchmark::kMicrosecond)
+	->Iterations(10000);
+
+// View over the frame: strings stay in the buffer, params are only validated
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, RequestDeserializeView)(benchmark::State& state)
+{
+	auto frame = encode_wire_v2(create_complex_request());
+
+	for (auto _ : state)
+	{
+		auto result = query_request_view::parse(frame);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, RequestDeserializeView)
+	->Unit(benchmark::kMicrosecond)
+	->Iterations(10000);
+
+// View, then read every parameter without materializing it
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, RequestDeserializeViewParams)
+(benchmark::State& state)
+{
+	auto frame = encode_wire_v2(create_complex_request());
+
+	for (auto _ : state)
+	{
+		auto result = query_request_view::parse(frame);
+		size_t total = 0;
+		for (const auto& param : result.value().params)
+		{
+			total += param.name.size() + param.value.index();
+		}
+		benchmark::DoNotOptimize(total);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, RequestDeserializeViewParams)
+	->Unit(benchmark::kMicrosecond)
+	->Iterations(10000);
+
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, WireV2ResponseEncode)(benchmark::State& state)
+{
+	const size_t row_count = state.range(0);
+	auto response = create_result_response(row_count);
+	std::vector<uint8_t> frame;
+
+	for (auto _ : state)
+	{
+		frame.clear();
+		encode_wire_v2(response, frame);
+		benchmark::DoNotOptimize(frame.data());
+	}
+
+	state.counters["v2_bytes"] = static_cast<double>(frame.size());
+#if KCENON_WITH_CONTAINER_SYSTEM
+	auto v1 = response.serialize()->serialize(
+		container_module::value_container::serialization_format::binary);
+	if (v1.is_ok())
+	{
+		state.counters["v1_bytes"] = static_cast<double>(v1.value().size());
+	}
+#endif
+	state.SetItemsProcessed(state.iterations() * row_count);
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, WireV2ResponseEncode)
+	->Unit(benchmark::kMicrosecond)
+	->Arg(10)
+	->Arg(100)
+	->Arg(1000);
+
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, WireV2ResponseDecode)(benchmark::State& state)
+{
+	const size_t row_count = state.range(0);
+	auto frame = encode_wire_v2(create_result_response(row_count));
+
+	for (auto _ : state)
+	{
+		auto result = decode_response_v2(frame);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations() * row_count);
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, WireV2ResponseDecode)
+	->Unit(benchmark::kMicrosecond)
+	->Arg(10)
+	->Arg(100)
+	->Arg(1000);
+
+// Args: row count, layout (0 = rows, 1 = columnar)
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, WireV2LayoutEncode)(benchmark::State& state)
+{
+	const size_t row_count = state.range(0);
+	const auto layout = state.range(1) ? wire_row_layout::columnar : wire_row_layout::rows;
+	auto response = create_event_response(row_count);
+	std::vector<uint8_t> frame;
+
+	for (auto _ : state)
+	{
+		frame.clear();
+		encode_wire_v2(response, frame, layout);
+		benchmark::DoNotOptimize(frame.data());
+	}
+
+	state.counters["frame_bytes"] = static_cast<double>(frame.size());
+	state.SetItemsProcessed(state.iterations() * row_count);
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, WireV2LayoutEncode)
+	->Unit(benchmark::kMicrosecond)
+	->ArgsProduct({ { 100, 1000, 10000 }, { 0, 1 } });
+
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, WireV2LayoutDecode)(benchmark::State& state)
+{
+	const size_t row_count = state.range(0);
+	const auto layout = state.range(1) ? wire_row_layout::columnar : wire_row_layout::rows;
+	std::vector<uint8_t> frame;
+	encode_wire_v2(create_event_response(row_count), frame, layout);
+
+	for (auto _ : state)
+	{
+		auto result = decode_response_v2(frame);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations() * row_count);
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, WireV2LayoutDecode)
+	->Unit(benchmark::kMicrosecond)
+	->ArgsProduct({ { 100, 1000, 10000 }, { 0, 1 } });
+
+// Decode N small requests sent as one batch frame
+BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, WireV2BatchDecode)(benchmark::State& state)
+{
+	const size_t count = state.range(0);
+	std::vector<query_request> requests;
+	for (size_t i = 0; i < count; ++i)
+	{
+		requests.push_back(create_complex_request());
+	}
+	auto frame = encode_request_batch_v2(requests);
+
+	for (auto _ : state)
+	{
+		auto batch = decode_wire_v2_batch(frame);
+		for (auto entry : batch.value().frames)
+		{
+			auto request = decode_request_v2(entry);
+			benchmark::DoNotOptimize(request);
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, WireV2BatchDecode)
+	->Unit(benchmark::kMicrosecond)
+	->Arg(1)
+	->Arg(16)
+	->Arg(128);
+
 // ============================================================================
 // Full Pipeline Throughput Benchmarks
 // ============================================================================
@@ -512,9 +892,11 @@ BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, ConcurrentRouterThroughput)
 	->Arg(8)
 	->UseRealTime();
 
+// Args: thread count, algorithm (0 = sliding window, 1 = GCRA)
 BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, ConcurrentAuthThroughput)
 (benchmark::State& state)
 {
+	rate_config_.algorithm = static_cast<rate_limit_algorithm>(state.range(1));
 	auth_middleware middleware(auth_config_, rate_config_);
 	const int num_threads = state.range(0);
 
@@ -530,11 +912,12 @@ BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, ConcurrentAuthThroughput)
 		{
 			threads.emplace_back([&, t]() {
 				auto token = create_valid_token();
+				token.client_id += "-" + std::to_string(t);
 				std::string session_id = "session-" + std::to_string(t);
 
 				for (int i = 0; i < auths_per_thread; ++i)
 				{
-					auto result = middleware.authenticate(session_id, token);
+					auto result = middleware.check(session_id, token);
 					benchmark::DoNotOptimize(result);
 					total_auths.fetch_add(1);
 				}
@@ -555,10 +938,7 @@ BENCHMARK_DEFINE_F(GatewayBenchmarkFixture, ConcurrentAuthThroughput)
 
 BENCHMARK_REGISTER_F(GatewayBenchmarkFixture, ConcurrentAuthThroughput)
 	->Unit(benchmark::kMillisecond)
-	->Arg(1)
-	->Arg(2)
-	->Arg(4)
-	->Arg(8)
+	->ArgsProduct({ { 1, 2, 4, 8 }, { 0, 1 } })
 	->UseRealTime();
 
 // ============================================================================
@@ -0,0 +1,463 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file protocol_benchmarks.cpp
+ * @brief Response encoding cost across payload shapes and wire formats
+ *
+ * Every benchmark encodes or decodes one query_response of a given shape:
+ * rows (0 to 100k) x columns (1 to 100) x cell type, in each wire format
+ * the gateway can send:
+ * - v1: value_container binary encoding (only with container_system)
+ * - v2_rows: compact binary frame with length-prefixed rows
+ * - v2_columnar: compact binary frame with the columnar layout; results
+ *   the columnar codec cannot represent fall back to rows, reported by
+ *   the columnar counter
+ *
+ * Cell types: ints, short_strings (16 distinct values), long_text (1 KiB,
+ * all distinct), blobs (256 bytes) and nulls (every other cell null,
+ * otherwise int). Shapes above 1M cells or 64 MiB of cell data are skipped.
+ *
+ * Counters per message: wire_bytes, bytes_per_cell and allocations, the
+ * heap allocations one encode or decode makes (counted by replacing the
+ * global operator new in this executable). Throughput is reported as
+ * bytes/s of wire data and items/s of cells.
+ *
+ * For comparisons between builds, write the results as JSON:
+ * @code
+ * ./protocol_benchmarks --benchmark_out=protocol.json --benchmark_out_format=json
+ * ./protocol_benchmarks --benchmark_filter='Encode/v2_columnar/ints'
+ * @endcode
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <kcenon/database_server/gateway/query_protocol.h>
+#include <kcenon/database_server/gateway/wire_format.h>
+
+#include <kcenon/common/config/feature_flags.h>
+#include <kcenon/database_server/gateway/container_compat.h>
+
+using namespace database_server::gateway;
+
+// ============================================================================
+// Allocation counting
+// ============================================================================
+
+namespace
+{
+
+std::atomic<uint64_t> allocation_count{ 0 };
+
+void* counted_allocate(std::size_t size)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size == 0 ? 1 : size))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+void* counted_allocate(std::size_t size, std::align_val_t alignment)
+{
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	auto align = static_cast<std::size_t>(alignment);
+	if (void* pointer = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1)
+													  / align * align))
+	{
+		return pointer;
+	}
+	throw std::bad_alloc();
+}
+
+} // namespace
+
+void* operator new(std::size_t size) { return counted_allocate(size); }
+void* operator new[](std::size_t size) { return counted_allocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	return counted_allocate(size, alignment);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return counted_allocate(size, alignment);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return counted_allocate(size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	try
+	{
+		return counted_allocate(size);
+	}
+	catch (...)
+	{
+		return nullptr;
+	}
+}
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete[](void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept
+{
+	std::free(pointer);
+}
+
+namespace
+{
+
+/**
+ * @brief Heap allocations made by one call of fn
+ */
+template <typename Fn>
+uint64_t count_allocations(Fn&& fn)
+{
+	uint64_t before = allocation_count.load(std::memory_order_relaxed);
+	fn();
+	return allocation_count.load(std::memory_order_relaxed) - before;
+}
+
+// ============================================================================
+// Payload shapes
+// ============================================================================
+
+enum class wire_variant : int64_t
+{
+	v1 = 0,
+	v2_rows = 1,
+	v2_columnar = 2
+};
+
+enum class cell_kind : int64_t
+{
+	ints = 0,
+	short_strings = 1,
+	long_text = 2,
+	blobs = 3,
+	nulls = 4
+};
+
+const char* to_string(wire_variant variant)
+{
+	switch (variant)
+	{
+	case wire_variant::v1:
+		return "v1";
+	case wire_variant::v2_rows:
+		return "v2_rows";
+	case wire_variant::v2_columnar:
+		return "v2_columnar";
+	}
+	return "unknown";
+}
+
+const char* to_string(cell_kind kind)
+{
+	switch (kind)
+	{
+	case cell_kind::ints:
+		return "ints";
+	case cell_kind::short_strings:
+		return "short_strings";
+	case cell_kind::long_text:
+		return "long_text";
+	case cell_kind::blobs:
+		return "blobs";
+	case cell_kind::nulls:
+		return "nulls";
+	}
+	return "unknown";
+}
+
+constexpr size_t long_text_size = 1024;
+constexpr size_t blob_size = 256;
+constexpr size_t max_cells = 1'000'000;
+constexpr size_t max_cell_bytes = 64u << 20;
+
+size_t cell_bytes(cell_kind kind)
+{
+	switch (kind)
+	{
+	case cell_kind::long_text:
+		return long_text_size;
+	case cell_kind::blobs:
+		return blob_size;
+	default:
+		return 8;
+	}
+}
+
+query_response make_response(size_t row_count, size_t column_count, cell_kind kind)
+{
+	query_response response(1);
+	for (size_t c = 0; c < column_count; ++c)
+	{
+		column_metadata column;
+		column.name = "c" + std::to_string(c);
+		column.type_name = to_string(kind);
+		response.columns.push_back(std::move(column));
+	}
+
+	std::mt19937_64 rng(42);
+	std::uniform_int_distribution<int64_t> ints(0, 1'000'000);
+	std::uniform_int_distribution<int> letters('a', 'z');
+	std::uniform_int_distribution<int> bytes(0, 255);
+
+	response.rows.resize(row_count);
+	for (size_t r = 0; r < row_count; ++r)
+	{
+		auto& cells = response.rows[r].cells;
+		cells.reserve(column_count);
+		for (size_t c = 0; c < column_count; ++c)
+		{
+			switch (kind)
+			{
+			case cell_kind::ints:
+				cells.emplace_back(ints(rng));
+				break;
+			case cell_kind::short_strings:
+				cells.emplace_back("status_" + std::to_string(rng() % 16));
+				break;
+			case cell_kind::long_text:
+			{
+				std::string text(long_text_size, ' ');
+				for (auto& ch : text)
+				{
+					ch = static_cast<char>(letters(rng));
+				}
+				cells.emplace_back(std::move(text));
+				break;
+			}
+			case cell_kind::blobs:
+			{
+				std::vector<uint8_t> blob(blob_size);
+				for (auto& byte : blob)
+				{
+					byte = static_cast<uint8_t>(bytes(rng));
+				}
+				cells.emplace_back(std::move(blob));
+				break;
+			}
+			case cell_kind::nulls:
+				if ((r + c) % 2 == 0)
+				{
+					cells.emplace_back(std::monostate{});
+				}
+				else
+				{
+					cells.emplace_back(ints(rng));
+				}
+				break;
+			}
+		}
+	}
+	return response;
+}
+
+bool encode(const query_response& response, wire_variant variant, std::vector<uint8_t>& out)
+{
+	out.clear();
+	switch (variant)
+	{
+	case wire_variant::v1:
+	{
+#if KCENON_WITH_CONTAINER_SYSTEM
+		auto result = response.serialize()->serialize(
+			container_module::value_container::serialization_format::binary);
+		if (result.is_err())
+		{
+			return false;
+		}
+		out = std::move(result.value());
+		return true;
+#else
+		return false;
+#endif
+	}
+	case wire_variant::v2_rows:
+		encode_wire_v2(response, out, wire_row_layout::rows);
+		return true;
+	case wire_variant::v2_columnar:
+		encode_wire_v2(response, out, wire_row_layout::columnar);
+		return true;
+	}
+	return false;
+}
+
+// Args: wire variant, cell kind, rows, columns
+struct payload_shape
+{
+	wire_variant variant;
+	cell_kind kind;
+	size_t rows;
+	size_t columns;
+
+	explicit payload_shape(const benchmark::State& state)
+		: variant(static_cast<wire_variant>(state.range(0)))
+		, kind(static_cast<cell_kind>(state.range(1)))
+		, rows(static_cast<size_t>(state.range(2)))
+		, columns(static_cast<size_t>(state.range(3)))
+	{
+	}
+
+	[[nodiscard]] size_t cells() const noexcept { return rows * columns; }
+};
+
+void report(benchmark::State& state, const payload_shape& shape, const std::vector<uint8_t>& frame,
+			uint64_t allocations)
+{
+	state.SetLabel(std::string(to_string(shape.variant)) + "/" + to_string(shape.kind));
+	state.counters["wire_bytes"] = static_cast<double>(frame.size());
+	state.counters["bytes_per_cell"]
+		= static_cast<double>(frame.size()) / static_cast<double>(std::max<size_t>(shape.cells(), 1));
+	state.counters["allocations"] = static_cast<double>(allocations);
+	if (shape.variant == wire_variant::v2_columnar)
+	{
+		state.counters["columnar"] = frame.size() > 5 && (frame[5] & wire_flag_columnar) ? 1 : 0;
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * frame.size()));
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * shape.cells()));
+}
+
+void payload_matrix(benchmark::internal::Benchmark* benchmark)
+{
+	benchmark->ArgNames({ "format", "type", "rows", "cols" });
+#if KCENON_WITH_CONTAINER_SYSTEM
+	const int64_t first_variant = 0;
+#else
+	const int64_t first_variant = 1;
+#endif
+	for (int64_t variant = first_variant; variant <= 2; ++variant)
+	{
+		for (int64_t kind = 0; kind <= 4; ++kind)
+		{
+			for (int64_t rows : { 0, 1, 100, 10'000, 100'000 })
+			{
+				for (int64_t columns : { 1, 10, 100 })
+				{
+					size_t cells = static_cast<size_t>(rows * columns);
+					if (cells > max_cells
+						|| cells * cell_bytes(static_cast<cell_kind>(kind)) > max_cell_bytes)
+					{
+						continue;
+					}
+					benchmark->Args({ variant, kind, rows, columns });
+				}
+			}
+		}
+	}
+}
+
+} // namespace
+
+// ============================================================================
+// Benchmarks
+// ============================================================================
+
+static void ProtocolEncode(benchmark::State& state)
+{
+	payload_shape shape(state);
+	auto response = make_response(shape.rows, shape.columns, shape.kind);
+	std::vector<uint8_t> frame;
+
+	// Counted on a fresh buffer, as when a response is sent
+	uint64_t allocations = count_allocations([&] { encode(response, shape.variant, frame); });
+	if (frame.empty())
+	{
+		state.SkipWithError("encoding failed");
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		encode(response, shape.variant, frame);
+		benchmark::DoNotOptimize(frame.data());
+	}
+
+	report(state, shape, frame, allocations);
+}
+
+BENCHMARK(ProtocolEncode)->Apply(payload_matrix)->Unit(benchmark::kMicrosecond);
+
+static void ProtocolDecode(benchmark::State& state)
+{
+	payload_shape shape(state);
+	std::vector<uint8_t> frame;
+	if (!encode(make_response(shape.rows, shape.columns, shape.kind), shape.variant, frame))
+	{
+		state.SkipWithError("encoding failed");
+		return;
+	}
+
+	// Both v1 and v2 frames are accepted by query_response::deserialize()
+	auto decode = [&] { return query_response::deserialize(frame); };
+	uint64_t allocations = count_allocations([&] { benchmark::DoNotOptimize(decode()); });
+	if (decode().is_err())
+	{
+		state.SkipWithError("decoding failed");
+		return;
+	}
+
+	for (auto _ : state)
+	{
+		auto result = decode();
+		benchmark::DoNotOptimize(result);
+	}
+
+	report(state, shape, frame, allocations);
+}
+
+BENCHMARK(ProtocolDecode)->Apply(payload_matrix)->Unit(benchmark::kMicrosecond);
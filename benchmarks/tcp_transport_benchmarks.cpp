@@ -0,0 +1,394 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file tcp_transport_benchmarks.cpp
+ * @brief Throughput of the gateway TCP transports at high connection counts
+ *
+ * Compares the io_uring listener with the default network_system TCP
+ * server. Each iteration sends one framed 64-byte request on every open
+ * connection and waits until every connection has its echo back, so the
+ * reported items/s is requests served per second with N connections open.
+ *
+ * Both ends run in this process: N connections need about 2N file
+ * descriptors. The benchmark raises RLIMIT_NOFILE to the hard limit and
+ * skips sizes that still do not fit.
+ *
+ * @code
+ * ./tcp_transport_benchmarks --benchmark_filter=ManyConnections
+ * @endcode
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <kcenon/database_server/gateway/io_uring_listener.h>
+
+#include <kcenon/network/facade/tcp_facade.h>
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+constexpr size_t payload_size = 64;
+constexpr size_t frame_size = 4 + payload_size;
+
+/**
+ * @brief Raise the descriptor limit and check that N connections fit
+ */
+bool reserve_descriptors(size_t connections)
+{
+	struct rlimit limit{};
+	::getrlimit(RLIMIT_NOFILE, &limit);
+	limit.rlim_cur = limit.rlim_max;
+	::setrlimit(RLIMIT_NOFILE, &limit);
+	return connections * 2 + 256 <= limit.rlim_cur;
+}
+
+/**
+ * @class load_generator
+ * @brief Non-blocking loopback clients driven by one epoll loop
+ */
+class load_generator
+{
+public:
+	~load_generator()
+	{
+		for (int fd : clients_)
+		{
+			::close(fd);
+		}
+		if (epoll_fd_ >= 0)
+		{
+			::close(epoll_fd_);
+		}
+	}
+
+	bool connect(uint16_t port, size_t connections)
+	{
+		epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+
+		struct sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		for (size_t i = 0; i < connections; ++i)
+		{
+			int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+			if (fd < 0)
+			{
+				return false;
+			}
+			if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+			{
+				::close(fd);
+				return false;
+			}
+			int one = 1;
+			::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+			struct epoll_event event{};
+			event.events = EPOLLIN;
+			event.data.u64 = clients_.size();
+			::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
+			clients_.push_back(fd);
+		}
+		received_.assign(clients_.size(), 0);
+
+		request_.assign(frame_size, 'r');
+		request_[0] = 0;
+		request_[1] = 0;
+		request_[2] = 0;
+		request_[3] = static_cast<uint8_t>(payload_size);
+		return true;
+	}
+
+	/**
+	 * @brief Send one request per connection and wait for all echoes
+	 * @return false if responses stopped arriving
+	 */
+	bool round()
+	{
+		for (int fd : clients_)
+		{
+			if (::send(fd, request_.data(), request_.size(), MSG_NOSIGNAL)
+				!= static_cast<ssize_t>(request_.size()))
+			{
+				return false;
+			}
+		}
+
+		size_t complete = 0;
+		std::fill(received_.begin(), received_.end(), 0);
+		std::vector<struct epoll_event> events(1024);
+		uint8_t buffer[4096];
+
+		while (complete < clients_.size())
+		{
+			int ready = ::epoll_wait(epoll_fd_, events.data(), static_cast<int>(events.size()), 5000);
+			if (ready <= 0)
+			{
+				return false;
+			}
+			for (int i = 0; i < ready; ++i)
+			{
+				auto index = events[i].data.u64;
+				auto count = ::recv(clients_[index], buffer, sizeof(buffer), MSG_DONTWAIT);
+				if (count == 0)
+				{
+					return false;
+				}
+				if (count < 0)
+				{
+					continue;
+				}
+				received_[index] += static_cast<size_t>(count);
+				if (received_[index] == frame_size)
+				{
+					++complete;
+				}
+			}
+		}
+		return true;
+	}
+
+private:
+	int epoll_fd_ = -1;
+	std::vector<int> clients_;
+	std::vector<size_t> received_;
+	std::vector<uint8_t> request_;
+};
+
+void run_rounds(benchmark::State& state, load_generator& clients, size_t connections)
+{
+	for (auto _ : state)
+	{
+		if (!clients.round())
+		{
+			state.SkipWithError("Responses stopped arriving");
+			break;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(connections));
+	state.counters["connections"] = static_cast<double>(connections);
+}
+
+} // namespace
+
+// ============================================================================
+// io_uring Listener
+// ============================================================================
+
+static void BM_ManyConnections_IoUring(benchmark::State& state)
+{
+	auto connections = static_cast<size_t>(state.range(0));
+	if (!reserve_descriptors(connections))
+	{
+		state.SkipWithError("RLIMIT_NOFILE too low for this connection count");
+		return;
+	}
+	if (!io_uring_listener::is_supported())
+	{
+		state.SkipWithError("io_uring not available");
+		return;
+	}
+
+	io_uring_config config;
+	config.host = "127.0.0.1";
+	config.port = 0;
+	config.max_connections = static_cast<uint32_t>(connections);
+
+	io_uring_listener listener(config);
+
+	std::mutex mutex;
+	std::unordered_map<std::string, std::shared_ptr<session_transport>> sessions;
+	listener.set_connection_callback(
+		[&](std::shared_ptr<session_transport> session)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			sessions.emplace(std::string(session->id()), std::move(session));
+		});
+	listener.set_receive_callback(
+		[&](std::string_view id, const std::vector<uint8_t>& data)
+		{
+			std::shared_ptr<session_transport> session;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto it = sessions.find(std::string(id));
+				if (it != sessions.end())
+				{
+					session = it->second;
+				}
+			}
+			if (session)
+			{
+				(void)session->send(std::vector<uint8_t>(data));
+			}
+		});
+
+	if (listener.start().is_err())
+	{
+		state.SkipWithError("Failed to start io_uring listener");
+		return;
+	}
+
+	{
+		load_generator clients;
+		if (!clients.connect(listener.bound_port(), connections))
+		{
+			state.SkipWithError("Failed to open client connections");
+		}
+		else
+		{
+			run_rounds(state, clients, connections);
+		}
+
+		auto stats = listener.get_stats();
+		if (stats.enter_calls > 0)
+		{
+			state.counters["cqes_per_enter"]
+				= static_cast<double>(stats.cqes_processed) / static_cast<double>(stats.enter_calls);
+		}
+	}
+
+	listener.stop();
+}
+BENCHMARK(BM_ManyConnections_IoUring)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime()
+	->ArgName("connections")
+	->Arg(100)
+	->Arg(1000)
+	->Arg(10000);
+
+// ============================================================================
+// network_system TCP Server (default transport)
+// ============================================================================
+
+static void BM_ManyConnections_NetworkSystem(benchmark::State& state)
+{
+	auto connections = static_cast<size_t>(state.range(0));
+	if (!reserve_descriptors(connections))
+	{
+		state.SkipWithError("RLIMIT_NOFILE too low for this connection count");
+		return;
+	}
+
+	// The gateway runs this server on its configured port; use a fixed
+	// high port here since the facade does not report an ephemeral one
+	constexpr uint16_t port = 47432;
+	auto server = kcenon::network::facade::tcp_facade().create_server(
+		{.port = port, .server_id = "transport_benchmark"});
+	if (!server)
+	{
+		state.SkipWithError("network_system server unavailable");
+		return;
+	}
+
+	using network_session = kcenon::network::interfaces::i_session;
+	std::mutex mutex;
+	std::unordered_map<std::string, std::shared_ptr<network_session>> sessions;
+	server->set_connection_callback(
+		[&](std::shared_ptr<network_session> session)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			sessions.emplace(std::string(session->id()), std::move(session));
+		});
+	server->set_receive_callback(
+		[&](std::string_view id, const std::vector<uint8_t>& data)
+		{
+			// The facade delivers raw stream chunks; echoing them back
+			// returns the framed request byte for byte
+			std::shared_ptr<network_session> session;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				auto it = sessions.find(std::string(id));
+				if (it != sessions.end())
+				{
+					session = it->second;
+				}
+			}
+			if (session)
+			{
+				(void)session->send(std::vector<uint8_t>(data));
+			}
+		});
+
+	if (server->start(port).is_err())
+	{
+		state.SkipWithError("Failed to start network_system server");
+		return;
+	}
+
+	{
+		load_generator clients;
+		if (!clients.connect(port, connections))
+		{
+			state.SkipWithError("Failed to open client connections");
+		}
+		else
+		{
+			run_rounds(state, clients, connections);
+		}
+	}
+
+	(void)server->stop();
+}
+BENCHMARK(BM_ManyConnections_NetworkSystem)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime()
+	->ArgName("connections")
+	->Arg(100)
+	->Arg(1000)
+	->Arg(10000);
+
+#endif // __linux__
+
+BENCHMARK_MAIN();
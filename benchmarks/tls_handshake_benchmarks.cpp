@@ -0,0 +1,478 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file tls_handshake_benchmarks.cpp
+ * @brief Cost of full versus resumed TLS handshakes on the gateway listener
+ *
+ * Each iteration of the handshake benchmarks does what a reconnecting
+ * client does: open a loopback connection, complete the TLS handshake,
+ * exchange one small message and close. The resumed variants present the
+ * session received on the previous connection (TLS 1.3 clients use each
+ * ticket once), so the server skips the certificate exchange and key
+ * agreement. Client and server share this process; the server-side CPU
+ * time per handshake is reported separately from the listener's counters.
+ *
+ * The record benchmark echoes framed messages over one established
+ * connection and reports the listener's record-layer cost per byte.
+ *
+ * Uses a self-signed P-256 certificate generated at startup.
+ *
+ * @code
+ * ./tls_handshake_benchmarks --benchmark_filter=Handshake
+ * @endcode
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <kcenon/database_server/gateway/tls_listener.h>
+
+#if DATABASE_SERVER_HAS_TLS
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+/**
+ * @struct test_certificate
+ * @brief Self-signed certificate and key written to a temporary directory
+ */
+struct test_certificate
+{
+	std::filesystem::path directory;
+	std::string cert_file;
+	std::string key_file;
+
+	test_certificate()
+		: directory(std::filesystem::temp_directory_path()
+					/ ("tls_handshake_benchmarks_" + std::to_string(::getpid())))
+		, cert_file((directory / "server.crt").string())
+		, key_file((directory / "server.key").string())
+	{
+		std::filesystem::create_directories(directory);
+
+		EVP_PKEY* key = nullptr;
+		EVP_PKEY_CTX* key_context = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+		EVP_PKEY_keygen_init(key_context);
+		EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_context, NID_X9_62_prime256v1);
+		EVP_PKEY_keygen(key_context, &key);
+		EVP_PKEY_CTX_free(key_context);
+
+		X509* cert = X509_new();
+		ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+		X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+		X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+		X509_set_pubkey(cert, key);
+		X509_NAME* name = X509_get_subject_name(cert);
+		X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+								   reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+		X509_set_issuer_name(cert, name);
+		X509_sign(cert, key, EVP_sha256());
+
+		FILE* file = std::fopen(cert_file.c_str(), "w");
+		PEM_write_X509(file, cert);
+		std::fclose(file);
+		file = std::fopen(key_file.c_str(), "w");
+		PEM_write_PrivateKey(file, key, nullptr, nullptr, 0, nullptr, nullptr);
+		std::fclose(file);
+
+		X509_free(cert);
+		EVP_PKEY_free(key);
+	}
+
+	~test_certificate()
+	{
+		std::error_code ignored;
+		std::filesystem::remove_all(directory, ignored);
+	}
+};
+
+const test_certificate& certificate()
+{
+	static const test_certificate instance;
+	return instance;
+}
+
+/**
+ * @class echo_server
+ * @brief TLS listener that echoes every message back to its sender
+ */
+class echo_server
+{
+public:
+	explicit echo_server(bool enable_tickets)
+	{
+		tls_config config;
+		config.host = "127.0.0.1";
+		config.port = 0;
+		config.cert_file = certificate().cert_file;
+		config.key_file = certificate().key_file;
+		config.enable_session_tickets = enable_tickets;
+		listener_ = std::make_unique<tls_listener>(config);
+
+		listener_->set_connection_callback(
+			[this](std::shared_ptr<session_transport> session)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				sessions_.emplace(std::string(session->id()), std::move(session));
+			});
+		listener_->set_disconnection_callback(
+			[this](std::string_view id)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				sessions_.erase(std::string(id));
+			});
+		listener_->set_receive_callback(
+			[this](std::string_view id, const std::vector<uint8_t>& data)
+			{
+				std::shared_ptr<session_transport> session;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					auto it = sessions_.find(std::string(id));
+					if (it != sessions_.end())
+					{
+						session = it->second;
+					}
+				}
+				if (session)
+				{
+					(void)session->send(std::vector<uint8_t>(data));
+				}
+			});
+
+		started_ = listener_->start().is_ok();
+	}
+
+	~echo_server() { listener_->stop(); }
+
+	[[nodiscard]] bool started() const { return started_; }
+
+	[[nodiscard]] tls_listener& listener() { return *listener_; }
+
+private:
+	std::unique_ptr<tls_listener> listener_;
+	bool started_ = false;
+	std::mutex mutex_;
+	std::unordered_map<std::string, std::shared_ptr<session_transport>> sessions_;
+};
+
+SSL_CTX* create_client_context(int max_version)
+{
+	SSL_CTX* context = SSL_CTX_new(TLS_client_method());
+	SSL_CTX_set_max_proto_version(context, max_version);
+	SSL_CTX_set_verify(context, SSL_VERIFY_PEER, nullptr);
+	SSL_CTX_load_verify_locations(context, certificate().cert_file.c_str(), nullptr);
+	SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_CLIENT);
+	return context;
+}
+
+/**
+ * @class tls_connection
+ * @brief Blocking loopback TLS client connection
+ */
+class tls_connection
+{
+public:
+	tls_connection(SSL_CTX* context, uint16_t port, SSL_SESSION* session = nullptr)
+		: fd_(::socket(AF_INET, SOCK_STREAM, 0))
+		, ssl_(SSL_new(context))
+	{
+		struct sockaddr_in address{};
+		address.sin_family = AF_INET;
+		address.sin_port = htons(port);
+		address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		if (::connect(fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+		{
+			return;
+		}
+		int one = 1;
+		::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		SSL_set_fd(ssl_, fd_);
+		if (session != nullptr)
+		{
+			SSL_set_session(ssl_, session);
+		}
+		connected_ = SSL_connect(ssl_) == 1;
+	}
+
+	~tls_connection()
+	{
+		if (connected_)
+		{
+			SSL_shutdown(ssl_);
+		}
+		SSL_free(ssl_);
+		::close(fd_);
+	}
+
+	[[nodiscard]] bool connected() const { return connected_; }
+
+	[[nodiscard]] bool resumed() const { return SSL_session_reused(ssl_) == 1; }
+
+	[[nodiscard]] SSL_SESSION* session() const { return SSL_get1_session(ssl_); }
+
+	/**
+	 * @brief Send one framed message and read its echo
+	 */
+	bool echo(const std::vector<uint8_t>& framed)
+	{
+		if (SSL_write(ssl_, framed.data(), static_cast<int>(framed.size()))
+			!= static_cast<int>(framed.size()))
+		{
+			return false;
+		}
+		std::vector<uint8_t> reply(framed.size());
+		size_t offset = 0;
+		while (offset < reply.size())
+		{
+			size_t received = 0;
+			if (SSL_read_ex(ssl_, reply.data() + offset, reply.size() - offset, &received) != 1)
+			{
+				return false;
+			}
+			offset += received;
+		}
+		return true;
+	}
+
+private:
+	int fd_;
+	SSL* ssl_;
+	bool connected_ = false;
+};
+
+std::vector<uint8_t> framed_message(size_t payload_size)
+{
+	std::vector<uint8_t> framed(4 + payload_size, 'm');
+	framed[0] = static_cast<uint8_t>(payload_size >> 24);
+	framed[1] = static_cast<uint8_t>(payload_size >> 16);
+	framed[2] = static_cast<uint8_t>(payload_size >> 8);
+	framed[3] = static_cast<uint8_t>(payload_size);
+	return framed;
+}
+
+int tls_version(int64_t arg)
+{
+	return arg == 12 ? TLS1_2_VERSION : TLS1_3_VERSION;
+}
+
+/**
+ * @brief Run handshakes, optionally resuming a session from a priming connection
+ */
+void run_handshakes(benchmark::State& state, bool resume, bool enable_tickets)
+{
+	echo_server server(enable_tickets);
+	if (!server.started())
+	{
+		state.SkipWithError("Failed to start TLS listener");
+		return;
+	}
+	SSL_CTX* context = create_client_context(tls_version(state.range(0)));
+	uint16_t port = server.listener().bound_port();
+
+	// TLS 1.3 sessions arrive after the handshake; the echo collects them
+	auto message = framed_message(8);
+	SSL_SESSION* session = nullptr;
+	if (resume)
+	{
+		tls_connection priming(context, port);
+		if (!priming.connected() || !priming.echo(message))
+		{
+			state.SkipWithError("Priming connection failed");
+			SSL_CTX_free(context);
+			return;
+		}
+		session = priming.session();
+	}
+
+	auto before = server.listener().get_stats();
+	for (auto _ : state)
+	{
+		tls_connection connection(context, port, session);
+		if (!connection.connected() || connection.resumed() != resume
+			|| !connection.echo(message))
+		{
+			state.SkipWithError(resume ? "Session was not resumed" : "Handshake failed");
+			break;
+		}
+		if (resume)
+		{
+			SSL_SESSION_free(session);
+			session = connection.session();
+		}
+	}
+
+	// The server finishes the last handshake after the client does
+	auto expected = before.full_handshakes + before.resumed_handshakes
+					+ static_cast<uint64_t>(state.iterations());
+	auto after = server.listener().get_stats();
+	for (int i = 0; i < 1000 && after.full_handshakes + after.resumed_handshakes < expected; ++i)
+	{
+		::usleep(1000);
+		after = server.listener().get_stats();
+	}
+
+	state.SetItemsProcessed(state.iterations());
+	uint64_t handshakes = resume ? after.resumed_handshakes - before.resumed_handshakes
+								 : after.full_handshakes - before.full_handshakes;
+	uint64_t server_us = resume ? after.resumed_handshake_us - before.resumed_handshake_us
+								: after.full_handshake_us - before.full_handshake_us;
+	if (handshakes > 0)
+	{
+		state.counters["server_us_per_handshake"]
+			= static_cast<double>(server_us) / static_cast<double>(handshakes);
+	}
+	state.counters["resumption_ratio"] = after.resumption_ratio();
+
+	SSL_SESSION_free(session);
+	SSL_CTX_free(context);
+}
+
+} // namespace
+
+// ============================================================================
+// Handshakes
+// ============================================================================
+
+static void BM_TlsHandshake_Full(benchmark::State& state)
+{
+	run_handshakes(state, false, true);
+}
+BENCHMARK(BM_TlsHandshake_Full)
+	->Unit(benchmark::kMicrosecond)
+	->UseRealTime()
+	->ArgName("tls")
+	->Arg(12)
+	->Arg(13);
+
+static void BM_TlsHandshake_ResumedTicket(benchmark::State& state)
+{
+	run_handshakes(state, true, true);
+}
+BENCHMARK(BM_TlsHandshake_ResumedTicket)
+	->Unit(benchmark::kMicrosecond)
+	->UseRealTime()
+	->ArgName("tls")
+	->Arg(12)
+	->Arg(13);
+
+static void BM_TlsHandshake_ResumedCache(benchmark::State& state)
+{
+	run_handshakes(state, true, false);
+}
+BENCHMARK(BM_TlsHandshake_ResumedCache)
+	->Unit(benchmark::kMicrosecond)
+	->UseRealTime()
+	->ArgName("tls")
+	->Arg(12)
+	->Arg(13);
+
+// ============================================================================
+// Record Layer
+// ============================================================================
+
+static void BM_TlsEcho(benchmark::State& state)
+{
+	echo_server server(true);
+	if (!server.started())
+	{
+		state.SkipWithError("Failed to start TLS listener");
+		return;
+	}
+	SSL_CTX* context = create_client_context(TLS1_3_VERSION);
+
+	{
+		tls_connection connection(context, server.listener().bound_port());
+		auto message = framed_message(static_cast<size_t>(state.range(0)));
+		if (!connection.connected())
+		{
+			state.SkipWithError("Handshake failed");
+		}
+		else
+		{
+			auto before = server.listener().get_stats();
+			for (auto _ : state)
+			{
+				if (!connection.echo(message))
+				{
+					state.SkipWithError("Echo failed");
+					break;
+				}
+			}
+			auto after = server.listener().get_stats();
+
+			state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(message.size()));
+			auto bytes = (after.bytes_encrypted - before.bytes_encrypted)
+						 + (after.bytes_decrypted - before.bytes_decrypted);
+			if (bytes > 0)
+			{
+				state.counters["server_crypto_ns_per_byte"]
+					= static_cast<double>(after.record_crypto_ns - before.record_crypto_ns)
+					  / static_cast<double>(bytes);
+			}
+		}
+	}
+
+	SSL_CTX_free(context);
+}
+BENCHMARK(BM_TlsEcho)
+	->Unit(benchmark::kMicrosecond)
+	->UseRealTime()
+	->ArgName("payload")
+	->Arg(64)
+	->Arg(4096)
+	->Arg(65536)
+	->Arg(1024 * 1024);
+
+#endif // DATABASE_SERVER_HAS_TLS
+
+BENCHMARK_MAIN();
@@ -0,0 +1,417 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file transport_benchmarks.cpp
+ * @brief Round-trip latency of local client transports
+ *
+ * Benchmarks cover one request/response round trip for a cached SELECT
+ * over:
+ * - The shared-memory ring transport (with and without spinning)
+ * - The Unix domain socket listener
+ * - A raw TCP loopback socket (baseline)
+ *
+ * Each server answers from a query_cache holding the result, as the
+ * gateway does for a cache hit. The TCP baseline is a plain blocking
+ * loopback socket with the same framing, not the gateway's TCP transport
+ * (network_system or io_uring_listener): it shows the kernel cost the local
+ * transports avoid, and is reported as BM_RoundTrip_RawTcpSocket with a
+ * "raw socket baseline" label so it is not read as the gateway TCP path.
+ * tcp_transport_benchmarks measures the gateway TCP transports themselves.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kcenon/database_server/gateway/query_cache.h>
+#include <kcenon/database_server/gateway/query_protocol.h>
+#include <kcenon/database_server/gateway/shm_transport.h>
+#include <kcenon/database_server/gateway/unix_socket_listener.h>
+
+#include <kcenon/common/config/feature_flags.h>
+#include <kcenon/database_server/gateway/container_compat.h>
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+// ============================================================================
+// Cached SELECT responder
+// ============================================================================
+
+/**
+ * @brief Answers a SELECT from a query_cache, like the gateway on a cache hit
+ */
+class cached_select_responder
+{
+public:
+	cached_select_responder()
+		: cache_(make_cache_config())
+		, request_("SELECT id, name, email FROM users WHERE team_id = ?", query_type::select)
+	{
+		request_.header.message_id = 1;
+		request_.params.emplace_back("team_id", int64_t{7});
+
+		query_response response(request_.header.message_id);
+		response.columns = {{"id", "BIGINT", 20}, {"name", "TEXT", 25}, {"email", "TEXT", 25}};
+		for (int64_t i = 0; i < 10; ++i)
+		{
+			result_row row;
+			row.cells = {i, std::string("user_") + std::to_string(i),
+						 std::string("user_") + std::to_string(i) + "@example.com"};
+			response.rows.push_back(std::move(row));
+		}
+		(void)cache_.put(query_cache::make_key(request_), response, {"users"});
+
+#if KCENON_WITH_CONTAINER_SYSTEM
+		auto container = request_.serialize();
+		auto bytes = container->serialize(
+			container_module::value_container::serialization_format::binary);
+		request_bytes_ = bytes.is_ok() ? bytes.value() : std::vector<uint8_t>{};
+#else
+		// Without container_system, requests travel as their cache key and
+		// responses as a buffer of typical size
+		auto key = query_cache::make_key(request_);
+		request_bytes_.assign(key.begin(), key.end());
+		canned_response_.assign(640, 0x5a);
+#endif
+	}
+
+	[[nodiscard]] const std::vector<uint8_t>& request_bytes() const { return request_bytes_; }
+
+	std::vector<uint8_t> respond(const std::vector<uint8_t>& data)
+	{
+#if KCENON_WITH_CONTAINER_SYSTEM
+		auto request = query_request::deserialize(data);
+		if (request.is_err())
+		{
+			return {};
+		}
+		auto cached = cache_.get(query_cache::make_key(request.value()));
+		if (cached.is_err())
+		{
+			return {};
+		}
+		auto bytes = cached.value().serialize()->serialize(
+			container_module::value_container::serialization_format::binary);
+		return bytes.is_ok() ? std::move(bytes.value()) : std::vector<uint8_t>{};
+#else
+		auto cached = cache_.get(std::string(data.begin(), data.end()));
+		return cached.is_ok() ? canned_response_ : std::vector<uint8_t>{};
+#endif
+	}
+
+private:
+	static cache_config make_cache_config()
+	{
+		cache_config config;
+		config.enabled = true;
+		config.max_entries = 16;
+		config.ttl_seconds = 3600;
+		return config;
+	}
+
+	query_cache cache_;
+	query_request request_;
+	std::vector<uint8_t> request_bytes_;
+#if !KCENON_WITH_CONTAINER_SYSTEM
+	std::vector<uint8_t> canned_response_;
+#endif
+};
+
+std::string make_socket_path(const char* name)
+{
+	return "/tmp/dbgw_bench_" + std::to_string(::getpid()) + "_" + name + ".sock";
+}
+
+// ============================================================================
+// Blocking framed socket helpers (UDS and TCP clients, TCP server)
+// ============================================================================
+
+bool write_exact(int fd, const uint8_t* data, size_t size)
+{
+	while (size > 0)
+	{
+		auto written = ::send(fd, data, size, MSG_NOSIGNAL);
+		if (written <= 0)
+		{
+			return false;
+		}
+		data += written;
+		size -= static_cast<size_t>(written);
+	}
+	return true;
+}
+
+bool read_exact(int fd, uint8_t* data, size_t size)
+{
+	while (size > 0)
+	{
+		auto received = ::recv(fd, data, size, 0);
+		if (received <= 0)
+		{
+			return false;
+		}
+		data += received;
+		size -= static_cast<size_t>(received);
+	}
+	return true;
+}
+
+bool write_frame(int fd, const std::vector<uint8_t>& payload)
+{
+	std::vector<uint8_t> frame(4 + payload.size());
+	auto length = static_cast<uint32_t>(payload.size());
+	frame[0] = static_cast<uint8_t>(length >> 24);
+	frame[1] = static_cast<uint8_t>(length >> 16);
+	frame[2] = static_cast<uint8_t>(length >> 8);
+	frame[3] = static_cast<uint8_t>(length);
+	std::copy(payload.begin(), payload.end(), frame.begin() + 4);
+	return write_exact(fd, frame.data(), frame.size());
+}
+
+bool read_frame(int fd, std::vector<uint8_t>& payload)
+{
+	uint8_t header[4];
+	if (!read_exact(fd, header, 4))
+	{
+		return false;
+	}
+	auto length = (uint32_t{header[0]} << 24) | (uint32_t{header[1]} << 16)
+				  | (uint32_t{header[2]} << 8) | uint32_t{header[3]};
+	payload.resize(length);
+	return read_exact(fd, payload.data(), length);
+}
+
+/**
+ * @brief Registers a responder on a transport listener's callbacks
+ */
+void attach_responder(transport_listener& listener, cached_select_responder& responder)
+{
+	auto session = std::make_shared<std::shared_ptr<session_transport>>();
+	listener.set_connection_callback(
+		[session](std::shared_ptr<session_transport> connected)
+		{
+			std::atomic_store(session.get(), std::move(connected));
+		});
+	listener.set_receive_callback(
+		[session, &responder](std::string_view, const std::vector<uint8_t>& data)
+		{
+			if (auto current = std::atomic_load(session.get()))
+			{
+				(void)current->send(responder.respond(data));
+			}
+		});
+}
+
+} // namespace
+
+// ============================================================================
+// Shared-Memory Transport
+// ============================================================================
+
+static void BM_RoundTrip_SharedMemory(benchmark::State& state)
+{
+	cached_select_responder responder;
+
+	shm_transport_config config;
+	config.path = make_socket_path("shm");
+	config.spin_iterations = static_cast<uint32_t>(state.range(0));
+	shm_transport_listener listener(config);
+	attach_responder(listener, responder);
+	if (listener.start().is_err())
+	{
+		state.SkipWithError("Failed to start shared-memory listener");
+		return;
+	}
+
+	shm_client_config client_config;
+	client_config.spin_iterations = static_cast<uint32_t>(state.range(0));
+	shm_client client(client_config);
+	if (client.connect(config.path).is_err())
+	{
+		state.SkipWithError("Failed to connect shared-memory client");
+		return;
+	}
+
+	const auto& request = responder.request_bytes();
+	for (auto _ : state)
+	{
+		(void)client.send(request);
+		auto response = client.receive(std::chrono::seconds(5));
+		if (response.is_err())
+		{
+			state.SkipWithError("Round trip failed");
+			break;
+		}
+		benchmark::DoNotOptimize(response);
+	}
+
+	client.disconnect();
+	listener.stop();
+}
+BENCHMARK(BM_RoundTrip_SharedMemory)
+	->Unit(benchmark::kMicrosecond)
+	->UseRealTime()
+	->ArgName("spin")
+	->Arg(0)
+	->Arg(2000);
+
+// ============================================================================
+// Unix Domain Socket
+// ============================================================================
+
+static void BM_RoundTrip_UnixSocket(benchmark::State& state)
+{
+	cached_select_responder responder;
+
+	unix_socket_config config;
+	config.path = make_socket_path("uds");
+	unix_socket_listener listener(config);
+	attach_responder(listener, responder);
+	if (listener.start().is_err())
+	{
+		state.SkipWithError("Failed to start Unix socket listener");
+		return;
+	}
+
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	struct sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", config.path.c_str());
+	if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		state.SkipWithError("Failed to connect Unix socket client");
+		return;
+	}
+
+	const auto& request = responder.request_bytes();
+	std::vector<uint8_t> response;
+	for (auto _ : state)
+	{
+		if (!write_frame(fd, request) || !read_frame(fd, response))
+		{
+			state.SkipWithError("Round trip failed");
+			break;
+		}
+		benchmark::DoNotOptimize(response);
+	}
+
+	::close(fd);
+	listener.stop();
+}
+BENCHMARK(BM_RoundTrip_UnixSocket)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+// ============================================================================
+// Raw TCP Loopback Socket (baseline, not a gateway transport)
+// ============================================================================
+
+static void BM_RoundTrip_RawTcpSocket(benchmark::State& state)
+{
+	state.SetLabel("raw socket baseline");
+	cached_select_responder responder;
+
+	int listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	socklen_t length = sizeof(address);
+	if (::bind(listen_fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0
+		|| ::listen(listen_fd, 1) != 0
+		|| ::getsockname(listen_fd, reinterpret_cast<struct sockaddr*>(&address), &length) != 0)
+	{
+		::close(listen_fd);
+		state.SkipWithError("Failed to start TCP server");
+		return;
+	}
+
+	std::thread server(
+		[&]
+		{
+			int fd = ::accept(listen_fd, nullptr, nullptr);
+			int one = 1;
+			::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+			std::vector<uint8_t> request;
+			while (read_frame(fd, request) && write_frame(fd, responder.respond(request)))
+			{
+			}
+			::close(fd);
+		});
+
+	int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	int one = 1;
+	::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	bool connected
+		= ::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0;
+
+	const auto& request = responder.request_bytes();
+	std::vector<uint8_t> response;
+	for (auto _ : state)
+	{
+		if (!connected || !write_frame(fd, request) || !read_frame(fd, response))
+		{
+			state.SkipWithError("Round trip failed");
+			break;
+		}
+		benchmark::DoNotOptimize(response);
+	}
+
+	::shutdown(fd, SHUT_RDWR);
+	::close(fd);
+	if (!connected)
+	{
+		::shutdown(listen_fd, SHUT_RDWR);
+	}
+	server.join();
+	::close(listen_fd);
+}
+BENCHMARK(BM_RoundTrip_RawTcpSocket)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+#endif // __linux__
+
+BENCHMARK_MAIN();
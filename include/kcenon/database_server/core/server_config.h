@@ -86,6 +86,30 @@ struct network_config
 	std::string key_file;           ///< TLS private key file path
 	uint32_t max_connections = 100; ///< Maximum concurrent connections
 	uint32_t connection_timeout_ms = 30000; ///< Connection timeout in milliseconds
+	std::string transport = "network_system"; ///< TCP transport: network_system or io_uring
+
+	std::string unix_socket_path;             ///< Unix socket for local clients (empty = disabled)
+	uint32_t unix_socket_permissions = 0660;  ///< Socket file mode (octal in config file)
+	std::vector<uint32_t> unix_socket_trusted_uids; ///< Local uids authenticated without token
+	std::string shm_socket_path;              ///< Shared-memory transport handshake socket (empty = disabled)
+
+	std::string handoff_socket_path;          ///< Socket for zero-downtime restarts (empty = disabled)
+	uint32_t drain_timeout_ms = 30000;        ///< Max time to serve remaining clients after a handoff
+	bool takeover = false;                    ///< Take sockets over from the running server (--takeover)
+
+	bool load_shedding = true;                ///< Shed reads when requests queue persistently
+	uint32_t shed_target_delay_us = 5000;     ///< Acceptable standing queue delay
+	uint32_t shed_interval_us = 100000;       ///< Window over which the minimum delay is taken
+
+	uint32_t client_max_queries = 0;          ///< Queries executing per client (0 = unlimited)
+	uint32_t client_max_connections = 0;      ///< Pooled connections held per client (0 = unlimited)
+	uint32_t client_quota_queue_ms = 0;       ///< Wait for a client slot before rejecting (0 = reject)
+	uint32_t client_cost_per_second = 0;      ///< Query cost units per second per client (0 = unlimited)
+	uint32_t client_cost_burst = 0;           ///< Cost units a client may spend at once (0 = 2 s worth)
+
+	uint32_t columnar_min_rows = 1024;        ///< v2 results this large are sent by column (0 = on request only)
+	uint32_t max_batch_requests = 256;        ///< Largest accepted multi-request frame
+	uint32_t batch_concurrency = 4;           ///< Requests of one batch run at once (1 = in order)
 };
 
 /**
@@ -111,6 +135,11 @@ struct pool_config
 	uint32_t max_connections = 50;   ///< Maximum pool size
 	uint32_t idle_timeout_ms = 60000; ///< Idle connection timeout
 	uint32_t health_check_interval_ms = 30000; ///< Health check interval
+
+	bool circuit_breaker = false;          ///< Fail fast while the database is failing
+	uint32_t breaker_failure_percent = 50; ///< Failed share of recent queries that opens it
+	uint32_t breaker_slow_ms = 0;          ///< Queries this slow count against it (0 = off)
+	uint32_t breaker_open_ms = 5000;       ///< Time queries fail fast before probing recovery
 };
 
 /**
@@ -126,6 +155,31 @@ struct query_cache_config
 	bool enable_lru = true;                    ///< Enable LRU eviction policy
 };
 
+/**
+ * @struct memory_config
+ * @brief Global memory budget for the gateway
+ */
+struct memory_config
+{
+	size_t budget_mb = 0;              ///< Memory for cache, results and uploads (0 = unlimited)
+	uint32_t pressure_percent = 85;    ///< Budget usage where caching stops and large queries are shed
+	uint32_t large_query_rows = 10000; ///< SELECTs without a smaller max_rows are shed under pressure
+};
+
+/**
+ * @struct token_auth_config
+ * @brief Token verification for clients that authenticate with a token
+ */
+struct token_auth_config
+{
+	std::string jwt_secret_file;         ///< HMAC key for JWTs (empty = expiry check only)
+	std::string jwt_algorithm = "HS256"; ///< HS256 or HS512
+	std::string jwt_key_id;              ///< "kid" of tokens signed with the key (empty = none)
+	std::string jwt_issuer;              ///< Required "iss" (empty = not checked)
+	std::string jwt_audience;            ///< Required "aud" entry (empty = not checked)
+	uint32_t jwt_leeway_ms = 30000;      ///< Clock skew allowed for exp, nbf and iat
+};
+
 /**
  * @struct server_config
  * @brief Main server configuration
@@ -140,6 +194,8 @@ struct server_config
 	logging_config logging;               ///< Logging configuration
 	pool_config pool;                     ///< Connection pool configuration
 	query_cache_config cache;             ///< Query cache configuration
+	memory_config memory;                 ///< Memory budget configuration
+	token_auth_config auth;               ///< Token verification configuration
 
 	/**
 	 * @brief Load configuration from a YAML file
@@ -0,0 +1,202 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file audit_pipeline.h
+ * @brief Asynchronous, batched delivery of authentication audit events
+ *
+ * Audit sinks write files or talk to remote collectors, and calling them on
+ * the request path adds their latency to every authentication. The
+ * pipeline instead publishes each event into a bounded lock-free ring and
+ * a background thread hands them to the sink in batches.
+ *
+ * The ring is a fixed array of cells with per-cell sequence numbers
+ * (Vyukov's bounded queue): publishers claim a cell with a CAS on the
+ * tail, the consumer takes cells from the head. When the sink falls behind
+ * and the ring fills, publishers never wait. With drop_oldest they evict
+ * the oldest queued event to make room; with sample they keep one of every
+ * sample_rate new events that way and drop the others, so the retained
+ * events still span the whole overload. Every lost event is counted.
+ *
+ * ## Thread Safety
+ * publish() may be called from any number of threads and is lock-free.
+ * Callbacks run on the pipeline's thread, one batch at a time.
+ *
+ * @code
+ * using namespace database_server::gateway;
+ *
+ * audit_pipeline pipeline(audit_config{});
+ * pipeline.set_batch_callback([&](const std::vector<auth_event>& events) {
+ *     sink.write(events);
+ * });
+ *
+ * pipeline.publish(std::move(event)); // returns immediately
+ * @endcode
+ */
+
+#pragma once
+
+#include "auth_middleware.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct audit_metrics
+ * @brief Statistics for audit event delivery
+ */
+struct audit_metrics
+{
+	std::atomic<uint64_t> published{0};       ///< Events accepted into the queue
+	std::atomic<uint64_t> delivered{0};       ///< Events handed to the callback
+	std::atomic<uint64_t> batches{0};         ///< Callback invocations
+	std::atomic<uint64_t> dropped_oldest{0};  ///< Queued events evicted by newer ones
+	std::atomic<uint64_t> dropped_sampled{0}; ///< New events dropped while sampling
+
+	/**
+	 * @brief Events lost to overflow
+	 */
+	[[nodiscard]] uint64_t dropped() const noexcept
+	{
+		return dropped_oldest.load(std::memory_order_relaxed)
+			   + dropped_sampled.load(std::memory_order_relaxed);
+	}
+};
+
+/**
+ * @class audit_pipeline
+ * @brief Bounded MPSC queue of audit events with a batching consumer thread
+ */
+class audit_pipeline
+{
+public:
+	/**
+	 * @brief Constructs a pipeline and starts its consumer thread
+	 * @param config Queue capacity, batch size and overflow policy
+	 */
+	explicit audit_pipeline(const audit_config& config = audit_config{});
+
+	/**
+	 * @brief Delivers the queued events, then stops the consumer thread
+	 */
+	~audit_pipeline();
+
+	// Non-copyable, non-movable
+	audit_pipeline(const audit_pipeline&) = delete;
+	audit_pipeline& operator=(const audit_pipeline&) = delete;
+	audit_pipeline(audit_pipeline&&) = delete;
+	audit_pipeline& operator=(audit_pipeline&&) = delete;
+
+	/**
+	 * @brief Set a callback invoked once per event
+	 */
+	void set_callback(audit_callback_t callback);
+
+	/**
+	 * @brief Set a callback invoked once per batch
+	 *
+	 * Takes precedence over the per-event callback.
+	 */
+	void set_batch_callback(audit_batch_callback_t callback);
+
+	/**
+	 * @brief Whether a callback is set, so events are worth building
+	 */
+	[[nodiscard]] bool has_sink() const noexcept;
+
+	/**
+	 * @brief Queue an event for delivery
+	 * @return false if the event was dropped (sample policy, queue full)
+	 */
+	bool publish(auth_event event);
+
+	/**
+	 * @brief Wait until every queued event was delivered or dropped
+	 */
+	void flush();
+
+	/**
+	 * @brief Deliver the queued events and stop the consumer thread
+	 *
+	 * Events published afterwards are not delivered.
+	 */
+	void stop();
+
+	/**
+	 * @brief Number of events the queue holds
+	 */
+	[[nodiscard]] size_t capacity() const noexcept;
+
+	/**
+	 * @brief Get delivery metrics
+	 */
+	[[nodiscard]] const audit_metrics& metrics() const noexcept;
+
+private:
+	struct alignas(64) cell
+	{
+		std::atomic<size_t> sequence{0};
+		auth_event event;
+	};
+
+	bool try_push(auth_event& event);
+	bool try_pop(auth_event& event);
+	void deliver(const std::vector<auth_event>& batch);
+	void run();
+
+private:
+	audit_config config_;
+	std::unique_ptr<cell[]> cells_;
+	size_t mask_;
+
+	alignas(64) std::atomic<size_t> tail_{0}; ///< Next cell to publish into
+	alignas(64) std::atomic<size_t> head_{0}; ///< Next cell to consume
+	alignas(64) std::atomic<uint32_t> signal_{0}; ///< Bumped after each publish
+	std::atomic<uint64_t> overflows_{0};      ///< Publishes that found the queue full
+	std::atomic<bool> stopping_{false};
+	std::atomic<bool> has_sink_{false};
+	audit_metrics metrics_;
+
+	mutable std::mutex callback_mutex_;
+	audit_callback_t callback_;
+	audit_batch_callback_t batch_callback_;
+
+	std::thread consumer_;
+};
+
+} // namespace database_server::gateway
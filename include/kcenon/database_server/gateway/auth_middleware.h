@@ -39,15 +39,18 @@
  *
  * Features:
  * - Token-based authentication with pluggable validators
- * - Per-client rate limiting with sliding window
+ * - Per-client rate limiting with sliding window or GCRA
  * - Audit logging for security events
  * - Thread-safe metrics collection
  */
 
 #pragma once
 
+#include "gcra_limiter.h"
 #include "query_protocol.h"
 #include "query_types.h"
+#include "session_transport.h"
+#include "shared_gcra_limiter.h"
 
 #include <atomic>
 #include <chrono>
@@ -58,9 +61,39 @@
 #include <unordered_map>
 #include <vector>
 
+#include <kcenon/common/interfaces/executor_interface.h>
+
 namespace database_server::gateway
 {
 
+class token_cache;
+class audit_pipeline;
+
+/**
+ * @enum audit_overflow_policy
+ * @brief What the audit queue gives up when the sink falls behind
+ */
+enum class audit_overflow_policy : uint8_t
+{
+	drop_oldest = 0, ///< Evict the oldest queued event for each new one
+	sample = 1       ///< Keep one of every sample_rate new events, evicting the oldest
+};
+
+/**
+ * @struct audit_config
+ * @brief Configuration for audit event delivery
+ */
+struct audit_config
+{
+	/// Queue events and deliver them in batches on a background thread
+	/// instead of calling the audit callback on the request path
+	bool asynchronous = true;
+	size_t queue_capacity = 4096; ///< Queued events (rounded up to a power of two)
+	size_t max_batch = 256;       ///< Events per delivery
+	audit_overflow_policy overflow = audit_overflow_policy::drop_oldest;
+	uint32_t sample_rate = 16;    ///< While full, one of this many new events is kept (sample only)
+};
+
 /**
  * @struct auth_config
  * @brief Configuration for authentication middleware
@@ -70,6 +103,35 @@ struct auth_config
 	bool enabled = true;                  ///< Enable authentication
 	bool validate_on_each_request = false; ///< Validate token on every request
 	uint32_t token_refresh_window_ms = 300000; ///< Token refresh window (5 min)
+
+	/// Remember successful validations so each token reaches the validator
+	/// once per lifetime (see token_cache)
+	bool cache_validated_tokens = true;
+	size_t token_cache_capacity = 65536;   ///< Max cached tokens
+	uint32_t token_cache_ttl_ms = 300000;  ///< Cache lifetime of tokens without expiry
+
+	/// How long revocations last when the token's expiry is unknown; client
+	/// revocations always last this long, so it must cover the longest
+	/// token lifetime
+	uint32_t revocation_ttl_ms = 86400000;
+	size_t revocation_capacity = 65536;    ///< Max revoked tokens at once
+
+	/// Local peers (Unix socket) with these user IDs are authenticated by
+	/// their kernel credentials instead of a token
+	std::vector<uint32_t> trusted_peer_uids;
+
+	audit_config audit; ///< Delivery of events to the audit callback
+};
+
+/**
+ * @enum rate_limit_algorithm
+ * @brief How rate_limiter tracks clients
+ */
+enum class rate_limit_algorithm : uint8_t
+{
+	sliding_window = 0, ///< Timestamps of the requests in the window, one mutex
+	gcra = 1,           ///< One timestamp per client in sharded maps (see gcra_limiter)
+	shared_gcra = 2     ///< GCRA state shared by every process on the host (see shared_gcra_limiter)
 };
 
 /**
@@ -81,8 +143,11 @@ struct rate_limit_config
 	bool enabled = true;                  ///< Enable rate limiting
 	uint32_t requests_per_second = 100;   ///< Max requests per second
 	uint32_t burst_size = 200;            ///< Max burst size
-	uint32_t window_size_ms = 1000;       ///< Sliding window size
+	uint32_t window_size_ms = 1000;       ///< Sliding window size (sliding_window only)
 	uint32_t block_duration_ms = 60000;   ///< Block duration when limit exceeded
+	rate_limit_algorithm algorithm = rate_limit_algorithm::sliding_window;
+	std::string shared_segment_name = "/database_server-ratelimit"; ///< Segment (shared_gcra only)
+	uint32_t shared_segment_slots = shared_gcra_limiter::default_slots; ///< Clients the segment can track (shared_gcra only)
 };
 
 /**
@@ -147,6 +212,11 @@ struct auth_event
  */
 using audit_callback_t = std::function<void(const auth_event&)>;
 
+/**
+ * @brief Callback type for batched audit logging
+ */
+using audit_batch_callback_t = std::function<void(const std::vector<auth_event>&)>;
+
 /**
  * @struct auth_result
  * @brief Result of authentication validation
@@ -158,6 +228,8 @@ struct auth_result
 	std::string message;          ///< Error message if failed
 	std::string client_id;        ///< Validated client ID
 	std::vector<std::string> permissions; ///< Client permissions (optional)
+	uint64_t expires_at = 0;      ///< Expiry found by the validator (Unix epoch ms, 0 = unknown)
+	uint64_t issued_at = 0;       ///< Issue time found by the validator (Unix epoch ms, 0 = unknown)
 };
 
 /**
@@ -195,8 +267,8 @@ public:
  * @brief Simple token validator that checks expiration only
  *
  * This is the default validator that only checks if the token
- * is present and not expired. For production use, implement
- * a custom validator that verifies token signatures, claims, etc.
+ * is present and not expired. For production use, use jwt_validator
+ * or implement a custom validator that verifies token signatures.
  */
 class simple_token_validator : public auth_validator
 {
@@ -222,6 +294,13 @@ struct rate_limit_entry
  *
  * Implements per-client rate limiting using a sliding window algorithm.
  * Supports burst allowance and temporary blocking when limits are exceeded.
+ * With rate_limit_algorithm::gcra every call is forwarded to a
+ * gcra_limiter, which admits burst_size requests at once and
+ * requests_per_second on average without a global lock. With
+ * rate_limit_algorithm::shared_gcra the state lives in a shared_gcra_limiter
+ * segment so that all gateway processes on the host enforce one budget; if
+ * the segment cannot be opened the limiter falls back to gcra_limiter and
+ * shared_error() says why.
  *
  * Thread Safety:
  * - All public methods are thread-safe
@@ -280,10 +359,25 @@ public:
 	 */
 	[[nodiscard]] const rate_limit_config& config() const noexcept;
 
+	/**
+	 * @brief Whether the limits are enforced across processes
+	 * @return true if the shared-memory segment is in use
+	 */
+	[[nodiscard]] bool is_shared() const noexcept;
+
+	/**
+	 * @brief Why the shared-memory segment could not be used
+	 * @return Error message (empty unless shared_gcra fell back to gcra)
+	 */
+	[[nodiscard]] const std::string& shared_error() const noexcept;
+
 private:
 	rate_limit_config config_;
 	mutable std::mutex entries_mutex_;
 	std::unordered_map<std::string, rate_limit_entry> entries_;
+	std::unique_ptr<gcra_limiter> gcra_; ///< Set for rate_limit_algorithm::gcra
+	std::shared_ptr<shared_gcra_limiter> shared_; ///< Set for rate_limit_algorithm::shared_gcra
+	std::string shared_error_;
 };
 
 /**
@@ -301,6 +395,8 @@ struct auth_metrics
 	std::atomic<uint64_t> invalid_tokens{0};
 	std::atomic<uint64_t> rate_limited_requests{0};
 	std::atomic<uint64_t> permission_denied{0};
+	std::atomic<uint64_t> token_cache_hits{0};   ///< Tokens answered by the token cache
+	std::atomic<uint64_t> token_cache_misses{0}; ///< Tokens passed to the validator
 
 	/**
 	 * @brief Calculate authentication success rate
@@ -377,6 +473,8 @@ public:
 					const rate_limit_config& rate_config,
 					std::shared_ptr<auth_validator> validator);
 
+	~auth_middleware();
+
 	/**
 	 * @brief Authenticate a client request
 	 * @param session_id Session identifier
@@ -386,6 +484,41 @@ public:
 	[[nodiscard]] auth_result authenticate(const std::string& session_id,
 										   const auth_token& token);
 
+	/**
+	 * @brief Complete authentication with a token verified earlier
+	 * @param session_id Session identifier
+	 * @param token Authentication token
+	 * @param verified Result of verify() for this token
+	 * @return auth_result indicating success or failure
+	 *
+	 * Updates metrics, audit events and the session's client like
+	 * authenticate(), without calling the validator again.
+	 */
+	[[nodiscard]] auth_result authenticate(const std::string& session_id,
+										   const auth_token& token,
+										   auth_result verified);
+
+	/**
+	 * @brief Verify a token with the token cache or the validator
+	 * @param token Authentication token
+	 * @return Validator (or cached) result
+	 *
+	 * The expensive part of authenticate(), with no rate limiting and no
+	 * audit event, so it can run on another thread; pass the result to
+	 * check() or authenticate() afterwards.
+	 */
+	[[nodiscard]] auth_result verify(const auth_token& token);
+
+	/**
+	 * @brief Authenticate a local client by its kernel-verified credentials
+	 * @param session_id Session identifier
+	 * @param peer Peer credentials of the connection
+	 * @return Success with client ID "uid:<uid>" if the uid is trusted;
+	 *         otherwise failure without an audit event (fall back to a token)
+	 */
+	[[nodiscard]] auth_result authenticate_peer(const std::string& session_id,
+												const peer_credentials& peer);
+
 	/**
 	 * @brief Check rate limit for client
 	 * @param client_id Client identifier
@@ -402,6 +535,17 @@ public:
 	[[nodiscard]] auth_result check(const std::string& session_id,
 									const auth_token& token);
 
+	/**
+	 * @brief Full authentication check with a token verified earlier
+	 * @param session_id Session identifier
+	 * @param token Authentication token
+	 * @param verified Result of verify() for this token
+	 * @return auth_result with combined status
+	 */
+	[[nodiscard]] auth_result check(const std::string& session_id,
+									const auth_token& token,
+									auth_result verified);
+
 	/**
 	 * @brief Record session creation event
 	 * @param session_id Session identifier
@@ -419,9 +563,83 @@ public:
 	/**
 	 * @brief Set audit callback for logging events
 	 * @param callback Function to call for each auth event
+	 *
+	 * With audit_config::asynchronous the callback runs on the audit
+	 * pipeline's thread rather than the thread that caused the event.
 	 */
 	void set_audit_callback(audit_callback_t callback);
 
+	/**
+	 * @brief Set audit callback receiving events in batches
+	 * @param callback Function to call for each batch of auth events
+	 *
+	 * Takes precedence over the per-event callback. Without
+	 * audit_config::asynchronous every batch holds a single event.
+	 */
+	void set_audit_batch_callback(audit_batch_callback_t callback);
+
+	/**
+	 * @brief Wait until every emitted audit event reached the callback
+	 *
+	 * Returns at once without audit_config::asynchronous.
+	 */
+	void flush_audit_events();
+
+	/**
+	 * @brief Get the asynchronous audit pipeline
+	 * @return Pipeline with delivery and drop counters, or nullptr if
+	 *         events are delivered synchronously
+	 */
+	[[nodiscard]] const audit_pipeline* get_audit_pipeline() const noexcept;
+
+	/**
+	 * @brief Reject a token even if the validator would accept it
+	 *
+	 * Works whether or not validated tokens are cached. Sessions already
+	 * authenticated with the token are only affected when
+	 * validate_on_each_request is set.
+	 * @param token Token string
+	 * @return false if auth_config::revocation_capacity tokens are
+	 *         already revoked
+	 */
+	bool revoke_token(const std::string& token);
+
+	/**
+	 * @brief Reject every token issued to a client until now
+	 *
+	 * Tokens whose issue time the validator does not report are rejected
+	 * for auth_config::revocation_ttl_ms, including ones issued later.
+	 * @param client_id Client identifier
+	 * @return Number of cached tokens dropped
+	 */
+	size_t revoke_client_tokens(const std::string& client_id);
+
+	/**
+	 * @brief Check whether authenticating a token would call the validator
+	 * @param token Authentication token
+	 * @return false if authentication is disabled or the token cache can
+	 *         answer for the token
+	 */
+	[[nodiscard]] bool needs_validation(const auth_token& token) const;
+
+	/**
+	 * @brief Set executor for token verification
+	 * @param executor Shared pointer to executor
+	 *
+	 * When set, gateway_server runs verify() for requests whose token
+	 * needs_validation() on this executor and executes the request once it
+	 * returns, so signature checks for bursts of new connections do not
+	 * hold up other sessions.
+	 */
+	void set_executor(std::shared_ptr<kcenon::common::interfaces::IExecutor> executor);
+
+	/**
+	 * @brief Get the token verification executor
+	 * @return Shared pointer to executor, or nullptr if not set
+	 */
+	[[nodiscard]] std::shared_ptr<kcenon::common::interfaces::IExecutor> get_executor()
+		const noexcept;
+
 	/**
 	 * @brief Get authentication metrics
 	 * @return Reference to metrics structure
@@ -460,12 +678,18 @@ private:
 	std::shared_ptr<auth_validator> validator_;
 	rate_limiter rate_limiter_;
 	auth_metrics metrics_;
+	std::unique_ptr<token_cache> token_cache_; ///< Revocations, and validations if cached
 
 	mutable std::mutex callback_mutex_;
 	audit_callback_t audit_callback_;
+	audit_batch_callback_t audit_batch_callback_;
+	std::unique_ptr<audit_pipeline> audit_pipeline_; ///< Set if audit.asynchronous
 
 	mutable std::mutex sessions_mutex_;
 	std::unordered_map<std::string, std::string> session_client_map_; ///< session_id -> client_id
+
+	mutable std::mutex executor_mutex_;
+	std::shared_ptr<kcenon::common::interfaces::IExecutor> executor_;
 };
 
 } // namespace database_server::gateway
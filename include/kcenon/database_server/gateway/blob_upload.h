@@ -0,0 +1,312 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file blob_upload.h
+ * @brief Chunked upload of large binary query parameters
+ *
+ * A binary parameter sent inline has to arrive in one message and is
+ * copied into the container, into the query_param and again by anything
+ * that inspects it. Large parameters can instead be streamed with
+ * query_type::upload_chunk requests into a spill_buffer held for the
+ * session, and referenced from the query by a blob_ref parameter.
+ *
+ * spill_buffer keeps the data in memory up to a threshold and moves it to
+ * an unlinked temporary file beyond that, so the server's memory stays
+ * bounded by the chunk size rather than the blob size. A content digest is
+ * computed as the data arrives.
+ *
+ * Uploads belong to the session that created them, are dropped when it
+ * disconnects, and are released once a request has consumed them.
+ *
+ * ## Thread Safety
+ * blob_upload_store is thread-safe. A spill_buffer may be read from
+ * several threads; appends must not run concurrently with other calls.
+ *
+ * @code
+ * // Client: send the blob in 256 KB chunks, then reference it
+ * query_request chunk_request;
+ * chunk_request.type = query_type::upload_chunk;
+ * chunk_request.chunk = blob_chunk{"photo", 0, first_chunk, false};
+ * // ... further chunks, the last one with last = true ...
+ *
+ * query_request insert("INSERT INTO photos (data) VALUES (?)", query_type::insert);
+ * insert.params.emplace_back("data", blob_ref{"photo", nullptr});
+ *
+ * // Server: the handler reads the resolved content
+ * const auto& ref = std::get<blob_ref>(request.params[0].value);
+ * auto bytes = ref.content->read_all();
+ * @endcode
+ */
+
+#pragma once
+
+#include "memory_governor.h"
+#include "query_protocol.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Common system integration
+#include <kcenon/common/patterns/result.h>
+
+namespace database_server::gateway
+{
+
+/**
+ * @class spill_buffer
+ * @brief Append-only byte buffer that moves to a temporary file when large
+ */
+class spill_buffer
+{
+public:
+	/**
+	 * @brief Constructs an empty buffer
+	 * @param memory_limit Bytes kept in memory before spilling to disk
+	 * @param spill_directory Directory for the temporary file (empty = system default)
+	 */
+	explicit spill_buffer(size_t memory_limit, std::string spill_directory = {});
+
+	~spill_buffer();
+
+	// Non-copyable, non-movable
+	spill_buffer(const spill_buffer&) = delete;
+	spill_buffer& operator=(const spill_buffer&) = delete;
+	spill_buffer(spill_buffer&&) = delete;
+	spill_buffer& operator=(spill_buffer&&) = delete;
+
+	/**
+	 * @brief Append bytes, spilling to disk if the memory limit is exceeded
+	 */
+	[[nodiscard]] kcenon::common::VoidResult append(const uint8_t* data, size_t size);
+
+	/**
+	 * @brief Move the buffered bytes to the temporary file now
+	 */
+	[[nodiscard]] kcenon::common::VoidResult spill();
+
+	/**
+	 * @brief Copy bytes starting at offset into out
+	 * @return Number of bytes copied (less than size at the end of the buffer)
+	 */
+	[[nodiscard]] kcenon::common::Result<size_t> read(uint64_t offset, uint8_t* out,
+													  size_t size) const;
+
+	/**
+	 * @brief Copy the whole content into one vector
+	 */
+	[[nodiscard]] kcenon::common::Result<std::vector<uint8_t>> read_all() const;
+
+	[[nodiscard]] uint64_t size() const noexcept { return size_; }
+
+	/**
+	 * @brief Bytes currently held in memory (0 once spilled)
+	 */
+	[[nodiscard]] size_t memory_bytes() const noexcept { return memory_.size(); }
+
+	[[nodiscard]] bool is_spilled() const noexcept { return file_ != nullptr; }
+
+	/**
+	 * @brief 64-bit digest of the content, independent of how it was chunked
+	 */
+	[[nodiscard]] uint64_t digest() const noexcept;
+
+private:
+	kcenon::common::VoidResult open_file();
+	void update_digest(const uint8_t* data, size_t size) noexcept;
+
+private:
+	size_t memory_limit_;
+	std::string spill_directory_;
+	std::vector<uint8_t> memory_;
+	std::FILE* file_ = nullptr;
+	mutable std::mutex file_mutex_; ///< Serializes seek + read on the file
+	uint64_t size_ = 0;
+
+	uint64_t digest_state_ = 0;
+	uint8_t digest_tail_[8] = {}; ///< Bytes not yet forming a full 8-byte word
+	size_t digest_tail_size_ = 0;
+};
+
+/**
+ * @struct blob_upload_config
+ * @brief Configuration for chunked uploads
+ */
+struct blob_upload_config
+{
+	bool enabled = true;                          ///< Accept upload_chunk requests
+	uint64_t max_upload_bytes = 1ull << 30;       ///< Largest blob accepted (1 GB)
+	size_t memory_threshold_bytes = 1024 * 1024;  ///< Per upload, before spilling to disk
+	size_t max_memory_bytes = 64 * 1024 * 1024;   ///< All uploads; beyond it new data spills
+	size_t max_uploads_per_session = 16;          ///< Incomplete + unconsumed uploads
+	std::string spill_directory;                  ///< Temporary files (empty = system default)
+};
+
+/**
+ * @struct blob_upload_metrics
+ * @brief Statistics for chunked uploads
+ */
+struct blob_upload_metrics
+{
+	std::atomic<uint64_t> chunks_received{0};   ///< Accepted chunks
+	std::atomic<uint64_t> bytes_received{0};    ///< Accepted chunk bytes
+	std::atomic<uint64_t> uploads_completed{0}; ///< Uploads finished with a last chunk
+	std::atomic<uint64_t> uploads_spilled{0};   ///< Uploads moved to disk
+	std::atomic<uint64_t> uploads_rejected{0};  ///< Uploads dropped for exceeding a limit
+
+	/**
+	 * @brief Reset all metrics counters
+	 */
+	void reset() noexcept
+	{
+		chunks_received.store(0);
+		bytes_received.store(0);
+		uploads_completed.store(0);
+		uploads_spilled.store(0);
+		uploads_rejected.store(0);
+	}
+};
+
+/**
+ * @class blob_upload_store
+ * @brief Per-session registry of chunked uploads
+ */
+class blob_upload_store
+{
+public:
+	/**
+	 * @brief Constructs a store with configuration
+	 * @param config Upload configuration
+	 */
+	explicit blob_upload_store(const blob_upload_config& config = {});
+
+	~blob_upload_store() = default;
+
+	// Non-copyable, non-movable
+	blob_upload_store(const blob_upload_store&) = delete;
+	blob_upload_store& operator=(const blob_upload_store&) = delete;
+	blob_upload_store(blob_upload_store&&) = delete;
+	blob_upload_store& operator=(blob_upload_store&&) = delete;
+
+	/**
+	 * @brief Append a chunk, starting the upload at offset 0
+	 * @return Bytes received for the upload so far
+	 *
+	 * An upload exceeding max_upload_bytes is dropped.
+	 */
+	[[nodiscard]] kcenon::common::Result<uint64_t> append(const std::string& session_id,
+														  const blob_chunk& chunk);
+
+	/**
+	 * @brief Remove a completed upload and hand over its content
+	 */
+	[[nodiscard]] kcenon::common::Result<std::shared_ptr<const spill_buffer>> take(
+		const std::string& session_id, const std::string& upload_id);
+
+	/**
+	 * @brief Fill in the content of every blob_ref parameter of a request
+	 *
+	 * Consumes the referenced uploads; a reference repeated within the
+	 * request shares the content.
+	 */
+	[[nodiscard]] kcenon::common::VoidResult resolve(const std::string& session_id,
+													 query_request& request);
+
+	/**
+	 * @brief Drop all uploads of a session
+	 */
+	void remove_session(const std::string& session_id);
+
+	/**
+	 * @brief Drop all uploads
+	 */
+	void clear();
+
+	/**
+	 * @brief Number of uploads held (incomplete and unconsumed)
+	 */
+	[[nodiscard]] size_t upload_count() const;
+
+	/**
+	 * @brief Bytes of upload data held in memory
+	 */
+	[[nodiscard]] size_t memory_bytes() const noexcept;
+
+	/**
+	 * @brief Get upload metrics
+	 */
+	[[nodiscard]] const blob_upload_metrics& metrics() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const blob_upload_config& config() const noexcept;
+
+	/**
+	 * @brief Account upload data held in memory to a memory governor
+	 * @param governor Governor to charge, or nullptr to detach
+	 *
+	 * While the governor is under pressure, new data spills to disk.
+	 */
+	void set_memory_governor(std::shared_ptr<memory_governor> governor);
+
+private:
+	/**
+	 * @brief Track upload data entering or leaving memory (mutex_ held)
+	 */
+	void add_memory(size_t bytes);
+	void sub_memory(size_t bytes);
+
+	struct upload
+	{
+		std::shared_ptr<spill_buffer> buffer;
+		bool complete = false;
+	};
+
+	using session_uploads = std::unordered_map<std::string, upload>;
+
+	blob_upload_config config_;
+	blob_upload_metrics metrics_;
+
+	mutable std::mutex mutex_;
+	std::unordered_map<std::string, session_uploads> sessions_;
+	std::atomic<size_t> memory_bytes_{0};
+	std::shared_ptr<memory_governor> governor_;
+};
+
+} // namespace database_server::gateway
@@ -0,0 +1,244 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file client_quota.h
+ * @brief Per-client caps on in-flight queries and held connections
+ *
+ * The rate limiter bounds how often a client may send requests, not how
+ * much backend capacity it occupies: a client sending ten 30-second
+ * queries per second passes the limiter while holding hundreds of pooled
+ * connections. client_quota_manager caps, per client, the queries that
+ * are executing and the pooled connections they hold, so a few heavy
+ * callers cannot starve everyone else of the shared backend.
+ *
+ * A request over its client's quota waits up to queue_timeout_ms for one
+ * of the client's own slots to be released, then is rejected with
+ * status_code::rate_limited; with a zero timeout it is rejected at once.
+ * Only the offending client queues, other clients are admitted as usual.
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe. A slot may be released from any
+ * thread.
+ *
+ * @code
+ * using namespace database_server::gateway;
+ *
+ * client_quota_config config;
+ * config.enabled = true;
+ * config.max_in_flight_queries = 8;
+ * client_quota_manager quotas(config);
+ *
+ * auto slot = quotas.acquire(session.client_id, quota_kind::query);
+ * if (!slot) {
+ *     return query_response(id, status_code::rate_limited,
+ *                           "Too many concurrent queries for client");
+ * }
+ * // ... execute; the slot is released when it goes out of scope
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct client_quota_config
+ * @brief Configuration for per-client concurrency quotas
+ */
+struct client_quota_config
+{
+	bool enabled = false;               ///< Enforce and report per-client quotas
+	uint32_t max_in_flight_queries = 0; ///< Queries executing per client (0 = unlimited)
+	uint32_t max_held_connections = 0;  ///< Pooled connections held per client (0 = unlimited)
+	uint32_t queue_timeout_ms = 0;      ///< Wait for a slot before rejecting (0 = reject at once)
+	uint32_t max_queued = 16;           ///< Requests a client may have waiting for a slot
+};
+
+/**
+ * @enum quota_kind
+ * @brief Resource a quota slot accounts for
+ */
+enum class quota_kind
+{
+	query,     ///< A query admitted by the router
+	connection ///< A pooled connection held by a handler
+};
+
+/**
+ * @struct client_quota_usage
+ * @brief Snapshot of a client's quota usage and rejections
+ */
+struct client_quota_usage
+{
+	std::string client_id;
+	uint32_t in_flight_queries = 0;     ///< Queries currently executing
+	uint32_t held_connections = 0;      ///< Pooled connections currently held
+	uint32_t queued = 0;                ///< Requests currently waiting for a slot
+	uint64_t admitted = 0;              ///< Slots granted
+	uint64_t delayed = 0;               ///< Requests that had to wait for a slot
+	uint64_t rejected_queries = 0;      ///< Queries rejected over the in-flight quota
+	uint64_t rejected_connections = 0;  ///< Acquisitions rejected over the connection quota
+};
+
+/**
+ * @class client_quota_manager
+ * @brief Tracks and bounds per-client in-flight queries and held connections
+ */
+class client_quota_manager
+{
+	struct client_state;
+
+public:
+	/**
+	 * @class slot
+	 * @brief Move-only handle for one unit of a client's quota
+	 *
+	 * Converts to false when the request was rejected. A granted slot
+	 * returns its unit when released or destroyed.
+	 */
+	class slot
+	{
+	public:
+		slot() = default;
+		~slot();
+
+		slot(const slot&) = delete;
+		slot& operator=(const slot&) = delete;
+		slot(slot&& other) noexcept;
+		slot& operator=(slot&& other) noexcept;
+
+		/**
+		 * @brief Whether the slot was granted
+		 */
+		explicit operator bool() const noexcept { return granted_; }
+
+		/**
+		 * @brief Return the unit to the client's quota
+		 */
+		void release() noexcept;
+
+	private:
+		friend class client_quota_manager;
+
+		slot(std::shared_ptr<client_state> state, quota_kind kind) noexcept;
+
+		std::shared_ptr<client_state> state_; ///< Null for untracked or rejected slots
+		quota_kind kind_ = quota_kind::query;
+		bool granted_ = false;
+	};
+
+	/**
+	 * @brief Constructs a manager with configuration
+	 * @param config Quota limits and queueing behaviour
+	 */
+	explicit client_quota_manager(const client_quota_config& config = client_quota_config{});
+
+	~client_quota_manager() = default;
+
+	// Non-copyable, non-movable
+	client_quota_manager(const client_quota_manager&) = delete;
+	client_quota_manager& operator=(const client_quota_manager&) = delete;
+	client_quota_manager(client_quota_manager&&) = delete;
+	client_quota_manager& operator=(client_quota_manager&&) = delete;
+
+	/**
+	 * @brief Take one unit of a client's quota
+	 * @param client_id Client to charge (empty = not tracked, always granted)
+	 * @param kind Resource to account for
+	 * @return Granted slot, or an empty slot if the quota stayed exhausted
+	 *         for queue_timeout_ms
+	 *
+	 * Blocks the calling thread while the client waits for its own slots.
+	 */
+	[[nodiscard]] slot acquire(const std::string& client_id, quota_kind kind);
+
+	/**
+	 * @brief Usage of every tracked client
+	 */
+	[[nodiscard]] std::vector<client_quota_usage> usage() const;
+
+	/**
+	 * @brief Usage of one client, if it is tracked
+	 */
+	[[nodiscard]] std::optional<client_quota_usage> usage(const std::string& client_id) const;
+
+	/**
+	 * @brief Number of clients currently tracked
+	 */
+	[[nodiscard]] size_t size() const;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const client_quota_config& config() const noexcept;
+
+private:
+	struct client_state
+	{
+		std::mutex mutex;
+		std::condition_variable released; ///< Signalled whenever a slot is returned
+		uint32_t in_flight_queries = 0;
+		uint32_t held_connections = 0;
+		uint32_t queued = 0;
+		uint64_t admitted = 0;
+		uint64_t delayed = 0;
+		uint64_t rejected_queries = 0;
+		uint64_t rejected_connections = 0;
+	};
+
+	static constexpr size_t min_sweep_size = 1024;
+
+	[[nodiscard]] std::shared_ptr<client_state> state_for(const std::string& client_id);
+	[[nodiscard]] uint32_t limit_for(quota_kind kind) const noexcept;
+	static client_quota_usage snapshot(const std::string& client_id, client_state& state);
+	size_t sweep();
+
+private:
+	client_quota_config config_;
+
+	mutable std::shared_mutex clients_mutex_;
+	std::unordered_map<std::string, std::shared_ptr<client_state>> clients_;
+	size_t sweep_at_ = min_sweep_size; ///< Size at which the next insert sweeps
+};
+
+} // namespace database_server::gateway
@@ -0,0 +1,197 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file codel_controller.h
+ * @brief Queue-delay-based load shedding (CoDel)
+ *
+ * When the database slows down, requests queue at every stage and all of
+ * them get slower until clients time out: the server does the most work
+ * while delivering nothing useful. codel_controller watches how long work
+ * waited before being served (its sojourn time) and, once even the
+ * shortest wait of an interval stayed above the target delay, declares the
+ * stage overloaded. While overloaded, newly arriving low-priority work is
+ * rejected with status_code::server_busy, so the work already admitted
+ * keeps a bounded latency.
+ *
+ * As in CoDel, a standing queue is recognised by the minimum delay rather
+ * than the average, so short bursts are absorbed; a single sample below
+ * the target, or an interval without samples, ends the overload.
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe.
+ *
+ * @code
+ * using namespace database_server::gateway;
+ *
+ * codel_controller admission(codel_config{});
+ *
+ * // When work leaves the queue
+ * admission.record(std::chrono::microseconds(waited_us));
+ *
+ * // When new work arrives
+ * if (admission.should_shed(is_sheddable(request.type))) {
+ *     return query_response(id, status_code::server_busy, "Server overloaded");
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include "query_types.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct codel_config
+ * @brief Configuration for queue-delay-based load shedding
+ */
+struct codel_config
+{
+	bool enabled = true;              ///< Shed low-priority work when overloaded
+	uint32_t target_delay_us = 5000;  ///< Acceptable standing queue delay (5 ms)
+	uint32_t interval_us = 100000;    ///< Window for the minimum delay (100 ms)
+};
+
+/**
+ * @struct codel_metrics
+ * @brief Statistics for load shedding
+ */
+struct codel_metrics
+{
+	std::atomic<uint64_t> samples{0};           ///< Sojourn times recorded
+	std::atomic<uint64_t> shed{0};              ///< Requests rejected
+	std::atomic<uint64_t> overload_episodes{0}; ///< Transitions into the overloaded state
+
+	/**
+	 * @brief Reset all metrics counters
+	 */
+	void reset() noexcept
+	{
+		samples.store(0);
+		shed.store(0);
+		overload_episodes.store(0);
+	}
+};
+
+/**
+ * @brief Whether a request of this type may be shed under overload
+ *
+ * Reads and session bookkeeping are shed; writes, transactions and health
+ * checks are always admitted.
+ */
+constexpr bool is_sheddable(query_type type) noexcept
+{
+	switch (type)
+	{
+	case query_type::select:
+	case query_type::subscribe:
+	case query_type::upload_chunk:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * @class codel_controller
+ * @brief Tracks the minimum sojourn time of a queue and decides admission
+ */
+class codel_controller
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Constructs a controller with configuration
+	 * @param config Target delay and interval
+	 */
+	explicit codel_controller(const codel_config& config = codel_config{});
+
+	~codel_controller() = default;
+
+	// Non-copyable, non-movable
+	codel_controller(const codel_controller&) = delete;
+	codel_controller& operator=(const codel_controller&) = delete;
+	codel_controller(codel_controller&&) = delete;
+	codel_controller& operator=(codel_controller&&) = delete;
+
+	/**
+	 * @brief Record how long a unit of work waited before being served
+	 */
+	void record(std::chrono::microseconds sojourn);
+	void record(std::chrono::microseconds sojourn, clock::time_point now);
+
+	/**
+	 * @brief Decide whether newly arriving work must be rejected
+	 * @param sheddable Whether the work is low priority (see is_sheddable())
+	 * @return true if the work should be answered with server_busy
+	 */
+	[[nodiscard]] bool should_shed(bool sheddable);
+	[[nodiscard]] bool should_shed(bool sheddable, clock::time_point now);
+
+	/**
+	 * @brief Check whether the queue currently has a standing delay
+	 */
+	[[nodiscard]] bool is_overloaded() const noexcept;
+
+	/**
+	 * @brief Get load shedding metrics
+	 */
+	[[nodiscard]] const codel_metrics& metrics() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const codel_config& config() const noexcept;
+
+private:
+	void expire_interval(clock::time_point now);
+
+private:
+	codel_config config_;
+	std::chrono::microseconds target_;
+	std::chrono::microseconds interval_;
+	codel_metrics metrics_;
+
+	mutable std::mutex mutex_;
+	clock::time_point interval_end_{};
+	std::chrono::microseconds interval_min_{std::chrono::microseconds::max()};
+	std::atomic<bool> overloaded_{false};
+};
+
+} // namespace database_server::gateway
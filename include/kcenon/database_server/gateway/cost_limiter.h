@@ -0,0 +1,270 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file cost_limiter.h
+ * @brief Per-client rate limiting weighted by measured query cost
+ *
+ * A request-count limit treats a point lookup and a ten-second aggregation
+ * alike. cost_limiter gives each client an allowance of cost units per
+ * second instead, where a query's cost is derived from what it actually
+ * consumed: backend time, rows returned or affected, and result bytes.
+ *
+ * Since the cost is only known afterwards, every query is charged up front
+ * with the running estimate of its fingerprint (the SQL text with literals
+ * and whitespace normalised) and the difference is settled once it
+ * finished. A query that turned out more expensive than estimated leaves
+ * its client in debt, which delays the client's next queries; one that was
+ * cheaper refunds the difference. Estimates are exponentially weighted
+ * moving averages of the settled costs.
+ *
+ * Each client is tracked with a weighted GCRA: one theoretical arrival
+ * time that a query advances by its cost times the time one unit is worth.
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe.
+ *
+ * @code
+ * using namespace database_server::gateway;
+ *
+ * cost_limit_config config;
+ * config.enabled = true;
+ * config.units_per_second = 500;
+ * cost_limiter limiter(config);
+ *
+ * auto ticket = limiter.admit(client_id, request.sql);
+ * if (!ticket.admitted) {
+ *     return query_response(id, status_code::rate_limited, "Query cost budget exceeded");
+ * }
+ * auto response = run(request);
+ * limiter.settle(client_id, ticket, cost_limiter::measure(response));
+ * @endcode
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace database_server::gateway
+{
+
+struct query_response;
+
+/**
+ * @struct cost_limit_config
+ * @brief Configuration for cost-based rate limiting
+ *
+ * A query costs execution_time_us / unit_time_us + rows / unit_rows +
+ * bytes / unit_bytes units, and at least min_cost_units.
+ */
+struct cost_limit_config
+{
+	bool enabled = false;              ///< Charge queries by cost
+	double units_per_second = 1000.0;  ///< Sustained allowance per client
+	double burst_units = 2000.0;       ///< Units a client may spend at once
+	double unit_time_us = 1000.0;      ///< Backend time worth one unit (1 ms)
+	double unit_rows = 100.0;          ///< Rows worth one unit
+	double unit_bytes = 65536.0;       ///< Result bytes worth one unit
+	double min_cost_units = 1.0;       ///< Cost floor of any query
+	double initial_estimate_units = 1.0; ///< Estimate for a fingerprint never seen
+	double estimate_weight = 0.2;      ///< Weight of the newest cost in the moving average
+	size_t max_fingerprints = 4096;    ///< Estimates kept; beyond that arbitrary ones are dropped
+};
+
+/**
+ * @struct query_cost
+ * @brief What a query consumed
+ */
+struct query_cost
+{
+	uint64_t execution_time_us = 0; ///< Time spent executing
+	uint64_t rows = 0;              ///< Rows returned or affected
+	uint64_t bytes = 0;             ///< Result size
+};
+
+/**
+ * @struct cost_ticket
+ * @brief Up-front charge of an admitted query, needed to settle it
+ */
+struct cost_ticket
+{
+	bool admitted = false;  ///< Whether the client could afford the estimate
+	uint64_t fingerprint = 0;
+	double estimated_units = 0.0;
+};
+
+/**
+ * @struct cost_limit_metrics
+ * @brief Statistics for cost-based rate limiting
+ */
+struct cost_limit_metrics
+{
+	std::atomic<uint64_t> admitted{0};       ///< Queries charged up front
+	std::atomic<uint64_t> rejected{0};       ///< Queries over the client's allowance
+	std::atomic<uint64_t> settled{0};        ///< Queries whose measured cost was applied
+	std::atomic<uint64_t> underestimated{0}; ///< Settled queries that cost more than estimated
+	std::atomic<uint64_t> settled_units{0};  ///< Measured units, rounded per query
+
+	/**
+	 * @brief Reset all metrics counters
+	 */
+	void reset() noexcept
+	{
+		admitted.store(0);
+		rejected.store(0);
+		settled.store(0);
+		underestimated.store(0);
+		settled_units.store(0);
+	}
+};
+
+/**
+ * @class cost_limiter
+ * @brief Per-client allowance of query cost units per second
+ */
+class cost_limiter
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Constructs a limiter with configuration
+	 * @param config Allowance, burst and cost model
+	 */
+	explicit cost_limiter(const cost_limit_config& config = cost_limit_config{});
+
+	~cost_limiter() = default;
+
+	// Non-copyable, non-movable
+	cost_limiter(const cost_limiter&) = delete;
+	cost_limiter& operator=(const cost_limiter&) = delete;
+	cost_limiter(cost_limiter&&) = delete;
+	cost_limiter& operator=(cost_limiter&&) = delete;
+
+	/**
+	 * @brief Charge a client the estimated cost of a query
+	 * @param client_id Client to charge (empty = not limited)
+	 * @param sql Query text, used for the fingerprint
+	 * @return Ticket to settle the query with; not admitted if the client
+	 *         cannot afford the estimate
+	 */
+	[[nodiscard]] cost_ticket admit(const std::string& client_id, std::string_view sql);
+	[[nodiscard]] cost_ticket admit(const std::string& client_id, std::string_view sql,
+									clock::time_point now);
+
+	/**
+	 * @brief Replace the up-front charge of an admitted query by its cost
+	 *
+	 * Also folds the cost into the fingerprint's estimate. Tickets that
+	 * were not admitted are ignored.
+	 */
+	void settle(const std::string& client_id, const cost_ticket& ticket, const query_cost& cost);
+
+	/**
+	 * @brief Units a client could spend immediately
+	 */
+	[[nodiscard]] double available_units(const std::string& client_id) const;
+	[[nodiscard]] double available_units(const std::string& client_id,
+										 clock::time_point now) const;
+
+	/**
+	 * @brief Current cost estimate for a query text
+	 */
+	[[nodiscard]] double estimate(std::string_view sql) const;
+
+	/**
+	 * @brief Convert a measured cost into units
+	 */
+	[[nodiscard]] double units(const query_cost& cost) const noexcept;
+
+	/**
+	 * @brief Measure what an executed query consumed
+	 */
+	[[nodiscard]] static query_cost measure(const query_response& response);
+
+	/**
+	 * @brief Fingerprint of a query text
+	 *
+	 * Queries differing only in literal values, letter case outside
+	 * literals or whitespace share a fingerprint.
+	 */
+	[[nodiscard]] static uint64_t fingerprint(std::string_view sql) noexcept;
+
+	/**
+	 * @brief Number of clients currently tracked
+	 */
+	[[nodiscard]] size_t size() const;
+
+	/**
+	 * @brief Get cost limiting metrics
+	 */
+	[[nodiscard]] const cost_limit_metrics& metrics() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const cost_limit_config& config() const noexcept;
+
+private:
+	struct alignas(64) shard
+	{
+		mutable std::mutex mutex;
+		std::unordered_map<std::string, int64_t> tats; ///< Client -> theoretical arrival time (clock ns)
+		size_t sweep_at = min_sweep_size; ///< Size at which the next insert sweeps
+	};
+
+	static constexpr size_t shard_count = 16;
+	static constexpr size_t min_sweep_size = 1024;
+
+	static int64_t to_ns(clock::time_point time) noexcept;
+	[[nodiscard]] shard& shard_for(const std::string& client_id) const noexcept;
+	[[nodiscard]] double estimate_for(uint64_t fingerprint) const;
+	void record_estimate(uint64_t fingerprint, double units);
+
+private:
+	cost_limit_config config_;
+	double unit_ns_;      ///< Time one unit of allowance is worth
+	int64_t burst_ns_;    ///< How far ahead of the allowance a client may run
+	cost_limit_metrics metrics_;
+	mutable std::array<shard, shard_count> shards_;
+
+	mutable std::mutex estimates_mutex_;
+	std::unordered_map<uint64_t, double> estimates_; ///< Fingerprint -> moving average of units
+};
+
+} // namespace database_server::gateway
@@ -38,6 +38,8 @@
  *
  * Architecture:
  * - Uses tcp_facade / i_protocol_server from kcenon::network for TCP handling
+ * - Optional local listeners (Unix domain socket) feed the same pipeline
+ * - Optional listening-socket handoff for zero-downtime restarts
  * - Integrates with query_protocol for message serialization
  * - Provides callbacks for request handling
  */
@@ -45,19 +47,33 @@
 #pragma once
 
 #include "auth_middleware.h"
+#include "blob_upload.h"
+#include "codel_controller.h"
+#include "memory_governor.h"
+#include "invalidation_broadcaster.h"
+#include "listener_handoff.h"
 #include "query_protocol.h"
 #include "query_types.h"
+#include "result_delta.h"
+#include "session_transport.h"
+#include "tls_listener.h"
+#include "wire_format.h"
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 // Common system integration
+#include <kcenon/common/interfaces/executor_interface.h>
 #include <kcenon/common/patterns/result.h>
 
 // Forward declarations - network facade interfaces
@@ -70,6 +86,16 @@ class i_session;
 namespace database_server::gateway
 {
 
+/**
+ * @enum tcp_transport_type
+ * @brief Implementation serving the gateway's TCP port
+ */
+enum class tcp_transport_type
+{
+	network_system, ///< network_system tcp_facade server (default)
+	io_uring        ///< io_uring_listener (Linux, DATABASE_SERVER_HAS_IO_URING builds)
+};
+
 /**
  * @struct gateway_config
  * @brief Configuration for the gateway server
@@ -81,9 +107,47 @@ struct gateway_config
 	uint32_t max_connections = 1000;       ///< Maximum concurrent connections
 	uint32_t idle_timeout_ms = 300000;     ///< Idle connection timeout (5 min)
 	bool require_auth = true;              ///< Require authentication
+	tcp_transport_type tcp_transport = tcp_transport_type::network_system; ///< TCP implementation
+
+	/// Terminate TLS on the TCP port (requires a DATABASE_SERVER_HAS_TLS build).
+	/// When enabled, tls_listener serves the port regardless of tcp_transport.
+	bool enable_tls = false;
+	std::string tls_cert_file;             ///< PEM certificate chain
+	std::string tls_key_file;              ///< PEM private key
+
+	/// Unix domain socket path for co-located clients (empty = disabled)
+	std::string unix_socket_path;
+	uint32_t unix_socket_permissions = 0660; ///< Socket file mode
+
+	/// Handshake socket path for the shared-memory transport (empty = disabled).
+	/// Uses unix_socket_permissions for the socket file mode.
+	std::string shm_socket_path;
+
+	/// Handoff socket for zero-downtime restarts (empty = disabled). The
+	/// server offers its listening sockets to a successor on this path; the
+	/// network_system transport cannot be handed off.
+	std::string handoff_socket_path;
+	bool takeover = false;                 ///< Take the sockets over from the gateway serving handoff_socket_path
+	bool handoff_idle_connections = true;  ///< Also pass idle connections to the successor
 
 	auth_config auth;                      ///< Authentication configuration
 	rate_limit_config rate_limit;          ///< Rate limiting configuration
+	delta_config delta;                    ///< Delta-encoded result configuration
+	invalidation_config invalidation;      ///< Invalidation subscription configuration
+	blob_upload_config blob_upload;        ///< Chunked upload configuration
+	codel_config dispatch_admission;       ///< Load shedding on the wait for an executor worker
+	memory_governor_config memory;         ///< Global memory budget
+
+	/// v2 results with at least this many rows are sent column by column
+	/// (0 = only when the request asks for it)
+	size_t columnar_min_rows = 1024;
+
+	uint32_t max_batch_requests = 256; ///< Largest accepted request batch (v2)
+	uint32_t batch_concurrency = 4;    ///< Requests of one batch run at once (1 = in order)
+
+	/// Request bytes a session may have waiting for the executor (see
+	/// gateway_server::set_executor()); a session over the limit is disconnected
+	size_t max_queued_bytes = 8 * 1024 * 1024;
 };
 
 /**
@@ -98,8 +162,11 @@ struct client_session
 	uint64_t connected_at = 0;  ///< Connection timestamp
 	uint64_t last_activity = 0; ///< Last activity timestamp
 	uint64_t requests_count = 0; ///< Number of requests processed
+	std::optional<peer_credentials> peer; ///< Kernel-verified identity (local transports)
+	uint32_t wire_version = wire_version_v1; ///< Framing of the latest request (replies match)
 
-	std::shared_ptr<kcenon::network::interfaces::i_session> network_session;
+	std::shared_ptr<session_transport> transport; ///< Connection used for sending
+	std::shared_ptr<kcenon::network::interfaces::i_session> network_session; ///< TCP only
 };
 
 /**
@@ -124,7 +191,9 @@ using request_handler_t = std::function<query_response(
  *
  * Thread Safety:
  * - All public methods are thread-safe
- * - Callbacks may be invoked from I/O thread
+ * - Callbacks may be invoked from I/O thread, or from the executor when
+ *   one is set
+ * - Requests of one session are processed one at a time, in arrival order
  *
  * Usage Example:
  * @code
@@ -247,6 +316,24 @@ public:
 	 */
 	[[nodiscard]] const auth_middleware& get_auth_middleware() const noexcept;
 
+	/**
+	 * @brief Set executor that processes requests
+	 * @param executor Shared pointer to executor
+	 *
+	 * When set, requests are processed on this executor instead of the
+	 * transport I/O thread that received them, so one slow query does not
+	 * hold up the other connections served by that thread. Without one,
+	 * requests run on the I/O thread.
+	 */
+	void set_executor(std::shared_ptr<kcenon::common::interfaces::IExecutor> executor);
+
+	/**
+	 * @brief Get the request executor
+	 * @return Shared pointer to executor, or nullptr if not set
+	 */
+	[[nodiscard]] std::shared_ptr<kcenon::common::interfaces::IExecutor> get_executor()
+		const noexcept;
+
 	/**
 	 * @brief Set custom token validator
 	 * @param validator Custom validator implementation
@@ -259,12 +346,84 @@ public:
 	 */
 	void set_audit_callback(audit_callback_t callback);
 
+	/**
+	 * @brief Get delta-encoded result tracker
+	 * @return Const reference to the tracker (for metrics and memory usage)
+	 */
+	[[nodiscard]] const result_delta_tracker& get_delta_tracker() const noexcept;
+
+	/**
+	 * @brief Get invalidation broadcaster
+	 * @return Reference to the broadcaster (connect query_cache invalidations here)
+	 */
+	[[nodiscard]] invalidation_broadcaster& get_invalidation_broadcaster() noexcept;
+
+	/**
+	 * @brief Get chunked upload store
+	 * @return Const reference to the store (for metrics and memory usage)
+	 */
+	[[nodiscard]] const blob_upload_store& get_blob_upload_store() const noexcept;
+
+	/**
+	 * @brief Get the dispatch admission controller
+	 * @return Controller fed by how long sessions with requests wait for an
+	 *         executor worker (no samples without an executor)
+	 */
+	[[nodiscard]] const codel_controller& get_dispatch_admission() const noexcept;
+
+	/**
+	 * @brief Get the memory governor
+	 * @return Governor accounting results and uploads (attach the query
+	 *         cache here)
+	 */
+	[[nodiscard]] std::shared_ptr<memory_governor> get_memory_governor() const noexcept;
+
+	/**
+	 * @brief Get TLS handshake and record-layer counters
+	 * @return Counters of the TLS listener, or nullopt when TLS is disabled
+	 */
+	[[nodiscard]] std::optional<tls_stats> get_tls_stats() const;
+
+	/**
+	 * @brief Check whether a successor has taken over the listening sockets
+	 *
+	 * A draining server accepts no new connections and only serves the ones
+	 * it still has; stop it once connection_count() reaches zero.
+	 */
+	[[nodiscard]] bool is_draining() const noexcept;
+
 private:
+	/**
+	 * @brief Take over listening sockets from the gateway serving the handoff path
+	 */
+	kcenon::common::VoidResult receive_listeners(handoff_client& predecessor);
+
+	/**
+	 * @brief Serve the handoff socket for a successor
+	 */
+	kcenon::common::VoidResult start_handoff_server();
+
+	/**
+	 * @brief Stop accepting and detach idle connections (handoff thread)
+	 */
+	std::vector<handoff_socket> release_for_successor();
+
+	/**
+	 * @brief Find the listener with a given transport name
+	 */
+	[[nodiscard]] transport_listener* find_listener(std::string_view transport) const;
+
 	/**
 	 * @brief Handle new client connection
 	 */
 	void on_connection(std::shared_ptr<kcenon::network::interfaces::i_session> session);
 
+	/**
+	 * @brief Register a new client connection from any transport
+	 */
+	void on_transport_connection(std::shared_ptr<session_transport> transport,
+								 std::shared_ptr<kcenon::network::interfaces::i_session> network_session);
+
 	/**
 	 * @brief Handle client disconnection
 	 */
@@ -282,25 +441,179 @@ private:
 	void on_error(std::string_view network_session_id, std::error_code ec);
 
 	/**
-	 * @brief Process a query request
+	 * @struct session_queue
+	 * @brief Messages of one session waiting to be processed, in arrival order
+	 */
+	struct session_queue
+	{
+		std::mutex mutex;
+		std::deque<std::vector<uint8_t>> pending;
+		size_t pending_bytes = 0;
+		bool active = false; ///< Owned by a drain; later messages wait behind it
+	};
+
+	/**
+	 * @brief Queue a message behind earlier ones of its session
 	 */
-	void process_request(const std::string& session_id,
-						 const query_request& request);
+	void enqueue_message(const std::string& session_id,
+						 const std::shared_ptr<session_queue>& queue,
+						 const std::vector<uint8_t>& data);
+
+	/**
+	 * @brief Run session work on the executor (or inline without one)
+	 *
+	 * The wait for an executor worker feeds the dispatch admission controller.
+	 */
+	void dispatch(std::function<void()> work);
+
+	/**
+	 * @brief Process queued messages until the queue is empty
+	 */
+	void drain_session(const std::string& session_id,
+					   const std::shared_ptr<session_queue>& queue);
+
+	/**
+	 * @brief Decode and process one message of a session
+	 * @return false if the message waits for token verification; the drain
+	 *         of the session's queue then resumes after it completes
+	 */
+	bool process_message(const std::string& session_id,
+						 const std::shared_ptr<session_queue>& queue,
+						 const std::vector<uint8_t>& data);
+
+	/**
+	 * @struct request_outcome
+	 * @brief Response to one request, ready to be encoded
+	 */
+	struct request_outcome
+	{
+		query_response response;
+		wire_row_layout layout = wire_row_layout::rows;
+		memory_reservation reservation; ///< Holds the result's memory until sent
+	};
+
+	/**
+	 * @brief Process a query request and send its response
+	 * @return false if the request went to the auth executor for token
+	 *         verification; its continuation sends the response and
+	 *         resumes the session's queue
+	 */
+	bool process_request(const std::string& session_id,
+						 const std::shared_ptr<session_queue>& queue,
+						 query_request request);
+
+	/**
+	 * @brief Check whether a request's token must go to the validator
+	 *
+	 * Such tokens are verified on the auth middleware's executor, if one
+	 * is set, before the request is executed.
+	 */
+	[[nodiscard]] bool needs_token_validation(const std::string& session_id,
+											  const query_request& request) const;
+
+	/**
+	 * @brief Authenticate, admit and execute a query request
+	 * @param verified Token verification already done for the request, if any
+	 */
+	request_outcome execute_request(const std::string& session_id,
+									query_request request,
+									std::optional<auth_result> verified = std::nullopt);
+
+	/**
+	 * @struct request_batch
+	 * @brief Decoded requests of a batch frame and their outcomes
+	 */
+	struct request_batch;
+
+	/**
+	 * @brief Execute the requests of a batch frame and send one response batch
+	 * @return false if some of its tokens went to the auth executor for
+	 *         verification; the batch then continues like a single request
+	 */
+	bool process_batch(const std::string& session_id,
+					   const std::shared_ptr<session_queue>& queue,
+					   std::span<const uint8_t> data);
+
+	/**
+	 * @brief Execute every request of a batch, up to batch_concurrency at once
+	 *
+	 * This thread works through the batch together with helpers on the
+	 * executor and returns once every request has its outcome.
+	 */
+	void execute_batch(const std::string& session_id,
+					   const std::shared_ptr<request_batch>& batch);
+
+	/**
+	 * @brief Execute one request of a batch, turning exceptions into errors
+	 */
+	void execute_batch_request(const std::string& session_id,
+							   request_batch& batch,
+							   size_t index);
+
+	/**
+	 * @brief Send the responses of a batch as one response batch frame
+	 */
+	void send_batch(const std::string& session_id,
+					const std::vector<request_outcome>& outcomes);
+
+	/**
+	 * @brief Handle SUBSCRIBE / UNSUBSCRIBE requests
+	 */
+	query_response handle_subscription(const std::string& session_id,
+									   const query_request& request);
+
+	/**
+	 * @brief Handle UPLOAD_CHUNK requests
+	 */
+	query_response handle_upload_chunk(const std::string& session_id,
+									   const query_request& request);
 
 	/**
 	 * @brief Send response to client
 	 */
 	void send_response(const std::string& session_id,
-					   const query_response& response);
+					   const query_response& response,
+					   wire_row_layout layout = wire_row_layout::rows);
+
+	/**
+	 * @brief Push an invalidation event to a client
+	 * @return true if the event was handed to the session
+	 */
+	bool send_event(const std::string& session_id,
+					const invalidation_event& event);
+
+	/**
+	 * @brief Send serialized bytes to a client session
+	 * @return true if the data was handed to the session
+	 */
+	bool send_to_session(const std::string& session_id, std::vector<uint8_t>&& data);
+
+	/**
+	 * @brief Wire protocol version responses to a session are encoded in
+	 */
+	[[nodiscard]] uint32_t session_wire_version(const std::string& session_id) const;
 
 private:
 	gateway_config config_;
-	std::shared_ptr<kcenon::network::interfaces::i_protocol_server> server_;
+	std::shared_ptr<kcenon::network::interfaces::i_protocol_server> server_; ///< Null with io_uring or TLS
+	std::vector<std::unique_ptr<transport_listener>> transport_listeners_;
+	const tls_listener* tls_listener_ = nullptr; ///< Owned by transport_listeners_
+	std::unique_ptr<handoff_server> handoff_server_;
+	std::atomic<bool> draining_{false};
 	std::unique_ptr<auth_middleware> auth_middleware_;
+	std::unique_ptr<result_delta_tracker> delta_tracker_;
+	std::unique_ptr<invalidation_broadcaster> invalidation_broadcaster_;
+	std::unique_ptr<blob_upload_store> blob_uploads_;
+	std::unique_ptr<codel_controller> dispatch_admission_;
+	std::shared_ptr<memory_governor> memory_governor_;
 
 	mutable std::mutex sessions_mutex_;
 	std::unordered_map<std::string, client_session> sessions_;
 	std::unordered_map<std::string, std::string> network_id_map_;
+	std::unordered_map<std::string, std::shared_ptr<session_queue>> session_queues_;
+
+	mutable std::mutex executor_mutex_;
+	std::shared_ptr<kcenon::common::interfaces::IExecutor> executor_;
 
 	request_handler_t request_handler_;
 	std::function<void(const client_session&)> connection_callback_;
@@ -309,6 +622,10 @@ private:
 	std::atomic<bool> running_{false};
 	std::mutex stop_mutex_;
 	std::condition_variable stop_cv_;
+
+	/// Jobs queued or running on the request or auth executor; stop() waits for them
+	std::shared_ptr<std::atomic<size_t>> deferred_requests_
+		= std::make_shared<std::atomic<size_t>>(0);
 };
 
 } // namespace database_server::gateway
@@ -0,0 +1,229 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file gcra_limiter.h
+ * @brief Per-client rate limiting with the generic cell rate algorithm
+ *
+ * GCRA keeps one timestamp per client, the theoretical arrival time (TAT)
+ * of the next request if the client sent at exactly the configured rate.
+ * A request conforms when it does not arrive earlier than TAT minus the
+ * burst tolerance; a conforming request advances TAT by one emission
+ * interval (1 s / requests_per_second). This admits burst_size requests
+ * at once and requests_per_second on average, like a token bucket, with
+ * O(1) state and work per request.
+ *
+ * Clients are spread over independently locked shards. The common path
+ * takes its shard's lock shared and updates the client's TAT with a
+ * compare-and-swap; only the first request of a client takes the lock
+ * exclusively. A client whose TAT has passed carries no state a fresh
+ * entry would not, so such entries are dropped when a shard grows and by
+ * cleanup().
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe.
+ *
+ * @code
+ * using namespace database_server::gateway;
+ *
+ * gcra_limiter limiter(100, 200, 60000);
+ * if (!limiter.allow_request(client_id)) {
+ *     return query_response(id, status_code::rate_limited, "Rate limit exceeded");
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct gcra_params
+ * @brief Emission interval and burst tolerance of a GCRA limit
+ */
+struct gcra_params
+{
+	int64_t emission_ns = 0;  ///< Interval between requests at the sustained rate
+	int64_t tolerance_ns = 0; ///< How far ahead of the rate a client may run
+
+	/**
+	 * @brief Derive the parameters from a rate and a burst size
+	 */
+	static constexpr gcra_params from_rate(uint32_t requests_per_second,
+										   uint32_t burst_size) noexcept
+	{
+		gcra_params params;
+		params.emission_ns = 1'000'000'000 / std::max<int64_t>(requests_per_second, 1);
+		params.tolerance_ns = params.emission_ns * (std::max<int64_t>(burst_size, 1) - 1);
+		return params;
+	}
+
+	/**
+	 * @brief Whether a request at now conforms to a client's TAT
+	 */
+	[[nodiscard]] constexpr bool conforms(int64_t tat, int64_t now) const noexcept
+	{
+		return std::max(tat, now) - now <= tolerance_ns;
+	}
+
+	/**
+	 * @brief TAT after admitting a request at now
+	 */
+	[[nodiscard]] constexpr int64_t advance(int64_t tat, int64_t now) const noexcept
+	{
+		return std::max(tat, now) + emission_ns;
+	}
+
+	/**
+	 * @brief Requests a client could send immediately
+	 */
+	[[nodiscard]] constexpr uint32_t remaining(int64_t tat, int64_t now) const noexcept
+	{
+		int64_t used = std::max<int64_t>(tat - now, 0);
+		int64_t available = (tolerance_ns + emission_ns - used) / emission_ns;
+		return static_cast<uint32_t>(std::max<int64_t>(available, 0));
+	}
+};
+
+/**
+ * @class gcra_limiter
+ * @brief Sharded per-client GCRA rate limiter
+ */
+class gcra_limiter
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Construct a limiter
+	 * @param requests_per_second Sustained rate per client
+	 * @param burst_size Requests a client may send at once
+	 * @param block_duration_ms How long a client that exceeded the limit is
+	 *        rejected (0 = only the excess requests are rejected)
+	 */
+	gcra_limiter(uint32_t requests_per_second, uint32_t burst_size, uint32_t block_duration_ms);
+
+	~gcra_limiter() = default;
+
+	// Non-copyable, non-movable
+	gcra_limiter(const gcra_limiter&) = delete;
+	gcra_limiter& operator=(const gcra_limiter&) = delete;
+	gcra_limiter(gcra_limiter&&) = delete;
+	gcra_limiter& operator=(gcra_limiter&&) = delete;
+
+	/**
+	 * @brief Check and record a request of a client
+	 * @return true if the request is allowed
+	 */
+	[[nodiscard]] bool allow_request(const std::string& client_id);
+	[[nodiscard]] bool allow_request(const std::string& client_id, clock::time_point now);
+
+	/**
+	 * @brief Requests the client could send immediately
+	 */
+	[[nodiscard]] uint32_t remaining_requests(const std::string& client_id) const;
+	[[nodiscard]] uint32_t remaining_requests(const std::string& client_id,
+											  clock::time_point now) const;
+
+	/**
+	 * @brief Check if client is currently blocked
+	 */
+	[[nodiscard]] bool is_blocked(const std::string& client_id) const;
+	[[nodiscard]] bool is_blocked(const std::string& client_id, clock::time_point now) const;
+
+	/**
+	 * @brief Block expiration as Unix epoch milliseconds (0 if not blocked)
+	 */
+	[[nodiscard]] uint64_t block_expires_at(const std::string& client_id) const;
+
+	/**
+	 * @brief Forget a client's state
+	 */
+	void reset(const std::string& client_id);
+
+	/**
+	 * @brief Drop every client whose state has expired
+	 * @return Number of clients removed
+	 */
+	size_t cleanup();
+	size_t cleanup(clock::time_point now);
+
+	/**
+	 * @brief Number of clients currently tracked
+	 */
+	[[nodiscard]] size_t size() const;
+
+	/**
+	 * @brief Get the GCRA parameters
+	 */
+	[[nodiscard]] const gcra_params& params() const noexcept;
+
+private:
+	struct cell
+	{
+		std::atomic<int64_t> tat{0};           ///< Theoretical arrival time (clock ns)
+		std::atomic<int64_t> blocked_until{0}; ///< Block expiration (clock ns)
+	};
+
+	struct alignas(64) shard
+	{
+		mutable std::shared_mutex mutex;
+		std::unordered_map<std::string, std::unique_ptr<cell>> cells;
+		size_t sweep_at = min_sweep_size; ///< Size at which the next insert sweeps
+	};
+
+	static constexpr size_t shard_count = 64;
+	static constexpr size_t min_sweep_size = 1024;
+
+	static int64_t to_ns(clock::time_point time) noexcept;
+	[[nodiscard]] shard& shard_for(const std::string& client_id) const noexcept;
+	[[nodiscard]] bool is_idle(const cell& state, int64_t now) const noexcept;
+	[[nodiscard]] bool update(cell& state, int64_t now);
+	size_t sweep(shard& target, int64_t now);
+
+private:
+	gcra_params params_;
+	int64_t block_ns_;
+	mutable std::array<shard, shard_count> shards_;
+};
+
+} // namespace database_server::gateway
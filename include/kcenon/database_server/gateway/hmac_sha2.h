@@ -0,0 +1,105 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file hmac_sha2.h
+ * @brief SHA-256/SHA-512 and HMAC for token signatures
+ *
+ * A self-contained implementation (FIPS 180-4, RFC 2104) so that token
+ * verification does not depend on how the server was built; TLS support
+ * and its crypto library are optional.
+ *
+ * hmac_sha256 and hmac_sha512 hash the padded key once at construction
+ * and keep the inner and outer states, so signing a message costs the
+ * message blocks plus two finalizations.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace database_server::gateway
+{
+
+using sha256_digest = std::array<uint8_t, 32>;
+using sha512_digest = std::array<uint8_t, 64>;
+
+/**
+ * @brief SHA-256 of a byte string
+ */
+[[nodiscard]] sha256_digest sha256(std::string_view data) noexcept;
+
+/**
+ * @brief SHA-512 of a byte string
+ */
+[[nodiscard]] sha512_digest sha512(std::string_view data) noexcept;
+
+/**
+ * @class hmac_sha256
+ * @brief HMAC-SHA-256 with a fixed key
+ */
+class hmac_sha256
+{
+public:
+	explicit hmac_sha256(std::string_view key) noexcept;
+
+	[[nodiscard]] sha256_digest sign(std::string_view message) const noexcept;
+
+private:
+	std::array<uint32_t, 8> inner_{}; ///< State after key ^ ipad
+	std::array<uint32_t, 8> outer_{}; ///< State after key ^ opad
+};
+
+/**
+ * @class hmac_sha512
+ * @brief HMAC-SHA-512 with a fixed key
+ */
+class hmac_sha512
+{
+public:
+	explicit hmac_sha512(std::string_view key) noexcept;
+
+	[[nodiscard]] sha512_digest sign(std::string_view message) const noexcept;
+
+private:
+	std::array<uint64_t, 8> inner_{}; ///< State after key ^ ipad
+	std::array<uint64_t, 8> outer_{}; ///< State after key ^ opad
+};
+
+/**
+ * @brief Compare two byte strings in time independent of their contents
+ * @return true if equal (strings of different length compare unequal)
+ */
+[[nodiscard]] bool constant_time_equal(std::string_view a, std::string_view b) noexcept;
+
+} // namespace database_server::gateway
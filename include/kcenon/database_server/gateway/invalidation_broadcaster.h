@@ -0,0 +1,261 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file invalidation_broadcaster.h
+ * @brief Pushes cache invalidation events to subscribed client sessions
+ *
+ * Clients that cache read results in-process subscribe to the tables, or
+ * to the queries, behind those results. Invalidations produced by
+ * query_cache (write handlers, explicit invalidate() calls, clear()) are
+ * fanned out to the subscribed sessions as invalidation_event messages
+ * over their existing connection.
+ *
+ * Delivery guarantees:
+ * - Every session has its own sequence, starting at 1 with no gaps.
+ * - If an event cannot be delivered, the next event to that session carries
+ *   the resync flag, telling the client to drop everything it cached.
+ * - query_cache::clear() results in a resync event to every session.
+ *
+ * Table names are matched case-insensitively. A query subscription is
+ * identified by its query_cache::make_key() value and is notified both when
+ * that key is invalidated and when any table the query reads is written.
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe. publish() calls are serialized so that
+ * events reach each session in sequence order; the sender callback is
+ * invoked without the subscription lock held.
+ *
+ * @code
+ * using namespace database_server::gateway;
+ *
+ * invalidation_broadcaster broadcaster;
+ * broadcaster.set_sender([](const std::string& session_id, const invalidation_event& event) {
+ *     return send_to_client(session_id, event);
+ * });
+ *
+ * (void)broadcaster.subscribe_tables("session-1", {"users"});
+ * broadcaster.publish("users", {});   // session-1 receives sequence 1
+ * @endcode
+ */
+
+#pragma once
+
+#include "query_protocol.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Common system integration
+#include <kcenon/common/patterns/result.h>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct invalidation_config
+ * @brief Configuration for invalidation subscriptions
+ */
+struct invalidation_config
+{
+	bool enabled = true;                         ///< Accept subscribe requests
+	size_t max_subscriptions_per_session = 1024; ///< Tables + queries per session
+};
+
+/**
+ * @struct invalidation_metrics
+ * @brief Statistics for invalidation delivery
+ */
+struct invalidation_metrics
+{
+	std::atomic<uint64_t> invalidations_published{0}; ///< publish() calls
+	std::atomic<uint64_t> events_sent{0};             ///< Events delivered to sessions
+	std::atomic<uint64_t> send_failures{0};           ///< Events that could not be delivered
+	std::atomic<uint64_t> resyncs{0};                 ///< Events sent with the resync flag
+
+	/**
+	 * @brief Reset all metrics counters
+	 */
+	void reset() noexcept
+	{
+		invalidations_published.store(0);
+		events_sent.store(0);
+		send_failures.store(0);
+		resyncs.store(0);
+	}
+};
+
+/**
+ * @brief Delivers an event to a session; returns false if it was not sent
+ */
+using invalidation_sender_t
+	= std::function<bool(const std::string& session_id, const invalidation_event& event)>;
+
+/**
+ * @class invalidation_broadcaster
+ * @brief Subscription registry and fan-out for invalidation events
+ */
+class invalidation_broadcaster
+{
+public:
+	/**
+	 * @brief Constructs a broadcaster with configuration
+	 * @param config Subscription configuration
+	 */
+	explicit invalidation_broadcaster(const invalidation_config& config = invalidation_config{});
+
+	// Non-copyable, non-movable
+	invalidation_broadcaster(const invalidation_broadcaster&) = delete;
+	invalidation_broadcaster& operator=(const invalidation_broadcaster&) = delete;
+	invalidation_broadcaster(invalidation_broadcaster&&) = delete;
+	invalidation_broadcaster& operator=(invalidation_broadcaster&&) = delete;
+
+	/**
+	 * @brief Set the callback used to deliver events
+	 * @param sender Delivery callback
+	 */
+	void set_sender(invalidation_sender_t sender);
+
+	/**
+	 * @brief Subscribe a session to invalidations of tables
+	 * @param session_id Session identifier
+	 * @param tables Table names
+	 * @return Error if the session would exceed its subscription limit
+	 */
+	[[nodiscard]] kcenon::common::VoidResult subscribe_tables(
+		const std::string& session_id, const std::vector<std::string>& tables);
+
+	/**
+	 * @brief Subscribe a session to invalidations of a cached query
+	 * @param session_id Session identifier
+	 * @param cache_key Key from query_cache::make_key()
+	 * @param tables Tables the query reads
+	 * @return Error if the session would exceed its subscription limit
+	 */
+	[[nodiscard]] kcenon::common::VoidResult subscribe_query(
+		const std::string& session_id,
+		const std::string& cache_key,
+		const std::unordered_set<std::string>& tables);
+
+	/**
+	 * @brief Remove table subscriptions of a session
+	 */
+	void unsubscribe_tables(const std::string& session_id, const std::vector<std::string>& tables);
+
+	/**
+	 * @brief Remove a query subscription of a session
+	 */
+	void unsubscribe_query(const std::string& session_id, const std::string& cache_key);
+
+	/**
+	 * @brief Remove all subscriptions of a session
+	 */
+	void remove_session(const std::string& session_id);
+
+	/**
+	 * @brief Publish an invalidation to all interested sessions
+	 * @param table_name Invalidated table (empty for key-only invalidation)
+	 * @param cache_keys Invalidated query cache keys
+	 *
+	 * An empty table with no keys is treated as publish_resync().
+	 */
+	void publish(const std::string& table_name, const std::vector<std::string>& cache_keys);
+
+	/**
+	 * @brief Tell every subscribed session to drop its cached results
+	 */
+	void publish_resync();
+
+	/**
+	 * @brief Get number of subscriptions (tables + queries) held by a session
+	 */
+	[[nodiscard]] size_t subscription_count(const std::string& session_id) const;
+
+	/**
+	 * @brief Get number of sessions with at least one subscription
+	 */
+	[[nodiscard]] size_t session_count() const;
+
+	/**
+	 * @brief Get delivery metrics
+	 */
+	[[nodiscard]] const invalidation_metrics& metrics() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const invalidation_config& config() const noexcept;
+
+private:
+	/**
+	 * @struct session_state
+	 * @brief Subscriptions and delivery state of one session
+	 */
+	struct session_state
+	{
+		std::unordered_set<std::string> tables; ///< Subscribed tables (lowercase)
+		std::unordered_map<std::string, std::unordered_set<std::string>> queries; ///< key -> tables
+		uint64_t sequence = 0;       ///< Last sequence assigned
+		bool resync_pending = false; ///< Next event must carry resync
+	};
+
+	using index_map = std::unordered_map<std::string, std::unordered_set<std::string>>;
+
+	static std::string normalize(const std::string& table_name);
+	static void index_remove(index_map& index, const std::string& key, const std::string& session_id);
+	void remove_query_locked(const std::string& session_id, session_state& state,
+							 const std::string& cache_key);
+	void deliver(std::vector<std::pair<std::string, invalidation_event>>& events);
+
+private:
+	invalidation_config config_;
+
+	mutable std::mutex mutex_;
+	std::unordered_map<std::string, session_state> sessions_;
+	index_map table_index_;       ///< table -> sessions subscribed to the table
+	index_map query_table_index_; ///< table -> sessions with a query reading the table
+	index_map key_index_;         ///< cache key -> sessions subscribed to the query
+
+	std::mutex publish_mutex_;    ///< Keeps per-session delivery in sequence order
+	std::mutex sender_mutex_;
+	invalidation_sender_t sender_;
+
+	invalidation_metrics metrics_;
+};
+
+} // namespace database_server::gateway
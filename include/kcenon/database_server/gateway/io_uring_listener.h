@@ -0,0 +1,228 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file io_uring_listener.h
+ * @brief io_uring-based TCP transport for the gateway
+ *
+ * Alternative to the network_system TCP server for Linux hosts with many
+ * connections. All socket I/O for every connection is driven from one
+ * io_uring instance:
+ *
+ * - One multishot accept request serves every incoming connection.
+ * - Each connection has one multishot receive request that takes buffers
+ *   from a kernel-registered provided-buffer ring shared by all
+ *   connections, so idle connections hold no receive buffer. Kernels
+ *   where the ring is unavailable get the same buffers through
+ *   IORING_OP_PROVIDE_BUFFERS instead.
+ * - Responses queued by any thread are gathered per connection into one
+ *   vectored send (no payload copies), and all requests produced by one
+ *   loop iteration go to the kernel in a single submission.
+ *
+ * Messages use the same 4-byte big-endian length framing as the local
+ * transports. Sessions are presented as session_transport instances, so
+ * they enter the gateway's session and request pipeline unchanged.
+ *
+ * The listening socket and idle connections can be handed to another
+ * process for a zero-downtime restart (see listener_handoff.h). Idle
+ * connections are detached by cancelling their multishot receive.
+ *
+ * Uses the io_uring system calls directly (no liburing). Requires Linux
+ * 6.1 or later and a build with DATABASE_SERVER_HAS_IO_URING; start()
+ * returns an error otherwise.
+ *
+ * ## Thread Safety
+ * start() and stop() must not be called concurrently. Callbacks are invoked
+ * from the single I/O thread; session send() may be called from any thread.
+ *
+ * @code
+ * io_uring_config config;
+ * config.port = 5432;
+ *
+ * io_uring_listener listener(config);
+ * listener.set_receive_callback([](std::string_view id, const std::vector<uint8_t>& data) {
+ *     // Handle message
+ * });
+ * (void)listener.start();
+ * @endcode
+ */
+
+#pragma once
+
+#include "session_transport.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace database_server::gateway
+{
+
+namespace transport_detail
+{
+class io_uring_engine;
+} // namespace transport_detail
+
+/**
+ * @struct io_uring_config
+ * @brief Configuration for the io_uring TCP listener
+ */
+struct io_uring_config
+{
+	std::string host = "0.0.0.0";                  ///< Bind address (IPv4 or IPv6 literal)
+	uint16_t port = 5432;                          ///< TCP port (0 = ephemeral)
+	uint32_t max_connections = 10000;              ///< Maximum concurrent connections
+	size_t max_frame_bytes = 16 * 1024 * 1024;     ///< Maximum message size (16MB)
+	uint32_t queue_depth = 4096;                   ///< Submission queue entries
+	uint32_t buffer_count = 4096;                  ///< Provided receive buffers (power of two)
+	uint32_t buffer_size = 16384;                  ///< Bytes per receive buffer
+	size_t max_send_queue_bytes = 16 * 1024 * 1024; ///< Unsent bytes before a client is dropped
+};
+
+/**
+ * @struct io_uring_stats
+ * @brief Counters of the io_uring listener
+ */
+struct io_uring_stats
+{
+	uint64_t connections_accepted = 0; ///< Connections accepted since start
+	uint64_t enter_calls = 0;          ///< io_uring_enter system calls
+	uint64_t sqes_submitted = 0;       ///< Requests handed to the kernel
+	uint64_t cqes_processed = 0;       ///< Completions handled
+	uint64_t buffer_exhaustions = 0;   ///< Receives that found no free buffer
+};
+
+class io_uring_session;
+
+/**
+ * @class io_uring_listener
+ * @brief TCP listener driven by a single io_uring instance
+ */
+class io_uring_listener : public transport_listener
+{
+public:
+	/**
+	 * @brief Constructs a listener with configuration
+	 * @param config Listener configuration
+	 */
+	explicit io_uring_listener(const io_uring_config& config);
+
+	~io_uring_listener() override;
+
+	// Non-copyable, non-movable
+	io_uring_listener(const io_uring_listener&) = delete;
+	io_uring_listener& operator=(const io_uring_listener&) = delete;
+	io_uring_listener(io_uring_listener&&) = delete;
+	io_uring_listener& operator=(io_uring_listener&&) = delete;
+
+	/**
+	 * @brief Bind the port, set up the ring and start the I/O thread
+	 */
+	[[nodiscard]] kcenon::common::VoidResult start() override;
+
+	/**
+	 * @brief Close all connections and stop the I/O thread
+	 */
+	void stop() override;
+
+	[[nodiscard]] bool is_running() const noexcept override;
+
+	[[nodiscard]] size_t connection_count() const override;
+
+	[[nodiscard]] std::string_view transport_name() const override;
+
+	[[nodiscard]] int listen_fd() const noexcept override;
+
+	bool adopt_listen_fd(int fd) override;
+
+	void stop_accepting() override;
+
+	[[nodiscard]] std::vector<int> release_idle_connections(
+		const std::function<bool(std::string_view transport_id)>& eligible) override;
+
+	[[nodiscard]] kcenon::common::VoidResult adopt_connection(int fd) override;
+
+	/**
+	 * @brief Get the bound port (useful when configured with port 0)
+	 */
+	[[nodiscard]] uint16_t bound_port() const noexcept;
+
+	/**
+	 * @brief Get a snapshot of the listener counters
+	 */
+	[[nodiscard]] io_uring_stats get_stats() const;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const io_uring_config& config() const noexcept;
+
+	/**
+	 * @brief Check whether this build and kernel support the listener
+	 */
+	[[nodiscard]] static bool is_supported();
+
+private:
+	friend class transport_detail::io_uring_engine;
+
+	bool post(std::function<void()> task);
+
+	io_uring_config config_;
+
+	int listen_fd_ = -1;
+	uint16_t bound_port_ = 0;
+	std::thread io_thread_;
+	std::atomic<bool> running_{false};
+	std::atomic<bool> accept_enabled_{true};
+	std::unique_ptr<transport_detail::io_uring_engine> engine_;
+
+	std::mutex tasks_mutex_;
+	std::vector<std::function<void()>> tasks_; ///< Run on the I/O thread
+	bool tasks_open_ = false;
+
+	mutable std::mutex sessions_mutex_;
+	std::unordered_map<uint64_t, std::shared_ptr<io_uring_session>> sessions_;
+
+	std::atomic<uint64_t> connections_accepted_{0};
+	std::atomic<uint64_t> enter_calls_{0};
+	std::atomic<uint64_t> sqes_submitted_{0};
+	std::atomic<uint64_t> cqes_processed_{0};
+	std::atomic<uint64_t> buffer_exhaustions_{0};
+};
+
+} // namespace database_server::gateway
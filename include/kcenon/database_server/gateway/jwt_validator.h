@@ -0,0 +1,201 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file jwt_validator.h
+ * @brief Built-in validator for HMAC-signed JSON Web Tokens
+ *
+ * Verifies compact JWS tokens (RFC 7515/7519) signed with HS256 or HS512
+ * using the in-tree SHA-2 implementation, then checks the registered
+ * claims:
+ * - exp, nbf and iat against the current time, allowing leeway_ms of
+ *   clock skew; exp is required unless require_expiry is cleared
+ * - iss and aud against the configured issuer and audience
+ * - sub, which becomes the client ID and must match the client_id sent
+ *   with the token (when one is sent)
+ *
+ * Keys are selected by the kid header, so keys can be rotated by adding
+ * the new key, switching issuers over and removing the old key later.
+ * Tokens without a kid use the key added with an empty kid. The
+ * algorithm comes from the key, never from the token alone: a token whose
+ * alg differs from its key's algorithm is rejected.
+ *
+ * Verified tokens carry their expiry in auth_result::expires_at, which
+ * bounds how long auth_middleware's token cache keeps them.
+ *
+ * ## Thread Safety
+ * validate() may run concurrently with itself and with key changes.
+ */
+
+#pragma once
+
+#include "auth_middleware.h"
+#include "hmac_sha2.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+namespace database_server::gateway
+{
+
+/**
+ * @enum jwt_algorithm
+ * @brief Supported JWS signature algorithms
+ */
+enum class jwt_algorithm : uint8_t
+{
+	hs256 = 0, ///< HMAC with SHA-256
+	hs512 = 1  ///< HMAC with SHA-512
+};
+
+/**
+ * @brief Convert jwt_algorithm to its JWS "alg" name
+ */
+constexpr const char* to_string(jwt_algorithm algorithm) noexcept
+{
+	switch (algorithm)
+	{
+	case jwt_algorithm::hs256:
+		return "HS256";
+	case jwt_algorithm::hs512:
+		return "HS512";
+	default:
+		return "unknown";
+	}
+}
+
+/**
+ * @struct jwt_key
+ * @brief Signing key accepted by jwt_validator
+ */
+struct jwt_key
+{
+	std::string kid;                             ///< Key ID ("kid" header), may be empty
+	jwt_algorithm algorithm = jwt_algorithm::hs256; ///< Only tokens with this alg match
+	std::string secret;                          ///< Raw key bytes
+};
+
+/**
+ * @struct jwt_config
+ * @brief Claim checks applied by jwt_validator
+ */
+struct jwt_config
+{
+	std::string issuer;            ///< Required "iss" (empty = not checked)
+	std::string audience;          ///< Required entry of "aud" (empty = not checked)
+	uint32_t leeway_ms = 30000;    ///< Clock skew allowed for exp, nbf and iat
+	bool require_expiry = true;    ///< Reject tokens without "exp"
+	size_t max_token_size = 8192;  ///< Longer tokens are rejected before decoding
+
+	/// Claim copied into auth_result::permissions: a space-separated string
+	/// (as in OAuth "scope") or an array of strings
+	std::string permissions_claim = "scope";
+};
+
+/**
+ * @class jwt_validator
+ * @brief auth_validator for HS256/HS512 JSON Web Tokens
+ *
+ * Usage Example:
+ * @code
+ * jwt_config config;
+ * config.issuer = "https://auth.example.com";
+ * config.audience = "database_server";
+ *
+ * auto validator = std::make_shared<jwt_validator>(config);
+ * validator->add_key({ "2026-10", jwt_algorithm::hs256, secret });
+ * gateway.set_token_validator(validator);
+ * @endcode
+ */
+class jwt_validator : public auth_validator
+{
+public:
+	explicit jwt_validator(jwt_config config = jwt_config{});
+
+	/**
+	 * @brief Accept tokens signed with a key, replacing any key with its kid
+	 */
+	void add_key(const jwt_key& key);
+
+	/**
+	 * @brief Stop accepting tokens signed with a key
+	 * @return true if a key with this kid existed
+	 */
+	bool remove_key(const std::string& kid);
+
+	/**
+	 * @brief Number of keys currently accepted
+	 */
+	[[nodiscard]] size_t key_count() const;
+
+	/**
+	 * @brief Verify the signature and claims of a token
+	 */
+	[[nodiscard]] auth_result validate(const auth_token& token) override;
+
+	/**
+	 * @brief Verify a token at a given time
+	 * @param now_ms Current Unix epoch milliseconds
+	 */
+	[[nodiscard]] auth_result validate(const auth_token& token, uint64_t now_ms) const;
+
+	/**
+	 * @brief Number of signatures computed (tokens that got past decoding)
+	 */
+	[[nodiscard]] uint64_t verifications() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const jwt_config& config() const noexcept;
+
+private:
+	struct signing_key
+	{
+		jwt_algorithm algorithm;
+		std::variant<hmac_sha256, hmac_sha512> hmac;
+	};
+
+	[[nodiscard]] std::shared_ptr<const signing_key> find_key(const std::string& kid) const;
+
+private:
+	jwt_config config_;
+	mutable std::shared_mutex keys_mutex_;
+	std::unordered_map<std::string, std::shared_ptr<const signing_key>> keys_;
+	mutable std::atomic<uint64_t> verifications_{0};
+};
+
+} // namespace database_server::gateway
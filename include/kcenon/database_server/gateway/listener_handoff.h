@@ -0,0 +1,244 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file listener_handoff.h
+ * @brief Listening-socket handoff between gateway processes
+ *
+ * Restarting the gateway normally closes every connection, so all clients
+ * reconnect at once. For a zero-downtime restart the new process instead
+ * takes over the sockets of the running one over a Unix domain socket
+ * (the handoff socket), using SCM_RIGHTS:
+ *
+ * 1. The new process connects and sends a takeover request. The running
+ *    process only serves peers with its own effective uid.
+ * 2. The running process sends its listening sockets, each tagged with the
+ *    transport_listener::transport_name() of its owner.
+ * 3. The new process starts serving them and reports that it is listening.
+ *    Both processes share the same accept queue, so no connection attempt
+ *    is refused while this happens.
+ * 4. The running process stops accepting, detaches its idle connections
+ *    and sends them as well, then drains: connections that were busy stay
+ *    open until their clients close them or the drain timeout expires.
+ *
+ * If the new process fails before step 3, the running process keeps
+ * serving as if nothing happened.
+ *
+ * Every message is a fixed 16-byte record (type, version, transport name)
+ * carrying at most one descriptor.
+ *
+ * Not available on Windows; start() and the client calls return an error
+ * there.
+ *
+ * ## Thread Safety
+ * handoff_server serves takeovers on its own thread and invokes its
+ * callbacks from it; start() and stop() must not be called concurrently.
+ * handoff_client is not thread-safe.
+ *
+ * @code
+ * // Running process
+ * handoff_server server(config);
+ * server.set_listeners_provider([&] { return listening_sockets(); });
+ * server.set_release_callback([&] { return stop_accepting_and_detach_idle(); });
+ * server.set_completion_callback([&] { begin_drain(); });
+ * (void)server.start();
+ *
+ * // New process
+ * handoff_client client(config);
+ * auto listeners = client.receive_listeners();   // adopt, then start listening
+ * auto connections = client.confirm_listening(); // adopt idle connections
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Common system integration
+#include <kcenon/common/patterns/result.h>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct handoff_config
+ * @brief Configuration of the handoff socket
+ */
+struct handoff_config
+{
+	std::string path;              ///< Handoff socket file path
+	uint32_t permissions = 0600;   ///< Socket file mode
+	uint32_t timeout_ms = 10000;   ///< Max wait for each step of the exchange
+};
+
+/**
+ * @struct handoff_socket
+ * @brief A descriptor passed between processes
+ */
+struct handoff_socket
+{
+	std::string transport; ///< transport_name() of the listener that owns it
+	int fd = -1;           ///< Descriptor (owned by whoever holds the struct)
+};
+
+/**
+ * @brief Close a handed-off descriptor that will not be used
+ */
+void close_handoff_socket(handoff_socket& socket) noexcept;
+
+/**
+ * @class handoff_server
+ * @brief Hands the sockets of the running process to its successor
+ *
+ * Serves a single takeover; once it has completed the server stops and
+ * leaves the socket file to the successor.
+ */
+class handoff_server
+{
+public:
+	/// Returns the listening sockets to share (they stay owned by the listeners)
+	using listeners_provider_t = std::function<std::vector<handoff_socket>()>;
+	/// Stops accepting and returns detached connections (ownership passes to the server)
+	using release_callback_t = std::function<std::vector<handoff_socket>()>;
+	/// Called once everything was handed over
+	using completion_callback_t = std::function<void()>;
+
+	/**
+	 * @brief Constructs a handoff server with configuration
+	 * @param config Handoff socket configuration
+	 */
+	explicit handoff_server(const handoff_config& config);
+
+	~handoff_server();
+
+	// Non-copyable, non-movable
+	handoff_server(const handoff_server&) = delete;
+	handoff_server& operator=(const handoff_server&) = delete;
+	handoff_server(handoff_server&&) = delete;
+	handoff_server& operator=(handoff_server&&) = delete;
+
+	void set_listeners_provider(listeners_provider_t provider);
+	void set_release_callback(release_callback_t callback);
+	void set_completion_callback(completion_callback_t callback);
+
+	/**
+	 * @brief Bind the handoff socket and wait for a successor
+	 *
+	 * A stale socket file left by a previous run is replaced.
+	 */
+	[[nodiscard]] kcenon::common::VoidResult start();
+
+	/**
+	 * @brief Stop serving, aborting an exchange in progress
+	 *
+	 * The socket file is removed unless a takeover completed.
+	 */
+	void stop();
+
+	[[nodiscard]] bool is_running() const noexcept;
+
+	/**
+	 * @brief Check whether a successor has taken over
+	 */
+	[[nodiscard]] bool completed() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const handoff_config& config() const noexcept;
+
+private:
+	void serve();
+	bool exchange(int fd);
+
+private:
+	handoff_config config_;
+	listeners_provider_t listeners_provider_;
+	release_callback_t release_callback_;
+	completion_callback_t completion_callback_;
+
+	int listen_fd_ = -1;
+	int wake_fds_[2] = {-1, -1};
+	std::thread thread_;
+	std::atomic<bool> running_{false};
+	std::atomic<bool> completed_{false};
+};
+
+/**
+ * @class handoff_client
+ * @brief Takes over the sockets of a running gateway
+ *
+ * Descriptors returned by the calls below are owned by the caller.
+ */
+class handoff_client
+{
+public:
+	/// Error code returned when no process serves the handoff socket
+	static constexpr int no_predecessor = -3;
+
+	/**
+	 * @brief Constructs a client with configuration
+	 * @param config Handoff socket configuration
+	 */
+	explicit handoff_client(const handoff_config& config);
+
+	~handoff_client();
+
+	// Non-copyable, non-movable
+	handoff_client(const handoff_client&) = delete;
+	handoff_client& operator=(const handoff_client&) = delete;
+	handoff_client(handoff_client&&) = delete;
+	handoff_client& operator=(handoff_client&&) = delete;
+
+	/**
+	 * @brief Request a takeover and receive the listening sockets
+	 * @return Listening sockets, or error no_predecessor if nothing serves the path
+	 */
+	[[nodiscard]] kcenon::common::Result<std::vector<handoff_socket>> receive_listeners();
+
+	/**
+	 * @brief Report that the sockets are being served and receive idle connections
+	 *
+	 * After this call the previous process no longer accepts connections.
+	 */
+	[[nodiscard]] kcenon::common::Result<std::vector<handoff_socket>> confirm_listening();
+
+private:
+	handoff_config config_;
+	int fd_ = -1;
+};
+
+} // namespace database_server::gateway
@@ -0,0 +1,323 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file memory_governor.h
+ * @brief Global memory budget shared by the gateway subsystems
+ *
+ * The query cache, materialized results and per-session state each bound
+ * their own memory, but nothing bounds their sum: a burst of large results
+ * can push the process past its cgroup limit. memory_governor accounts every
+ * subsystem against one budget:
+ *
+ * - Work that must allocate (results) calls reserve() before allocating,
+ *   which first asks reclaimable subsystems (the cache) to give memory back
+ *   and fails when the budget is still exceeded. Results reserve
+ *   estimate_result() up front and resize() the reservation to their
+ *   actual size once materialized.
+ * - Optional memory (cache entries, uploads kept in memory) uses
+ *   try_charge(), which only succeeds below the pressure watermark.
+ * - Above the watermark, new queries expected to return many rows are shed
+ *   (should_shed()) and uploads go to disk.
+ *
+ * A budget of 0 keeps the accounting (usage per subsystem) without
+ * enforcing anything.
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe. Reclaimers run one at a time with the
+ * reclaimer registry locked, so unregistering one waits for a running
+ * reclaim; they may call release() but not set_reclaimer().
+ *
+ * @code
+ * auto governor = std::make_shared<memory_governor>(config);
+ *
+ * auto reservation = governor->reserve(memory_subsystem::results,
+ *                                      governor->estimate_result(request));
+ * if (reservation.is_err()) {
+ *     return query_response(id, status_code::server_busy, "Insufficient memory");
+ * }
+ * auto response = execute(request);
+ * if (!reservation.value().resize(query_cache::estimate_size(response))) {
+ *     return query_response(id, status_code::server_busy, "Insufficient memory");
+ * }
+ * // ... memory released when the reservation goes out of scope
+ * @endcode
+ */
+
+#pragma once
+
+#include "query_protocol.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+#include <kcenon/common/patterns/result.h>
+
+namespace database_server::gateway
+{
+
+/**
+ * @enum memory_subsystem
+ * @brief Consumers of gateway memory accounted by the governor
+ */
+enum class memory_subsystem : uint8_t
+{
+	cache = 0,        ///< Query result cache (reclaimable)
+	results = 1,      ///< Materialized responses awaiting serialization
+	sessions = 2      ///< Per-session state held in memory (chunked uploads)
+};
+
+/// Number of memory_subsystem values
+inline constexpr size_t memory_subsystem_count = 3;
+
+/**
+ * @brief Converts memory_subsystem to string representation
+ */
+constexpr const char* to_string(memory_subsystem subsystem) noexcept
+{
+	switch (subsystem)
+	{
+	case memory_subsystem::cache:
+		return "cache";
+	case memory_subsystem::results:
+		return "results";
+	case memory_subsystem::sessions:
+		return "sessions";
+	default:
+		return "unknown";
+	}
+}
+
+/**
+ * @struct memory_governor_config
+ * @brief Configuration for the global memory budget
+ */
+struct memory_governor_config
+{
+	size_t budget_bytes = 0;          ///< Memory for all subsystems (0 = account only)
+	double pressure_ratio = 0.85;     ///< Fraction of the budget where pressure starts
+	uint32_t large_query_rows = 10000; ///< SELECTs without a smaller max_rows are shed under pressure
+	size_t result_row_bytes = 256;     ///< Expected size of one result row, reserved before a query runs
+};
+
+/**
+ * @struct memory_governor_metrics
+ * @brief Statistics for memory governance
+ */
+struct memory_governor_metrics
+{
+	std::atomic<uint64_t> reservations_denied{0}; ///< reserve() calls over the budget
+	std::atomic<uint64_t> charges_denied{0};      ///< try_charge() calls over the watermark
+	std::atomic<uint64_t> bytes_reclaimed{0};     ///< Memory given back by reclaimers
+	std::atomic<uint64_t> queries_shed{0};        ///< Large queries rejected under pressure
+
+	/**
+	 * @brief Reset all metrics counters
+	 */
+	void reset() noexcept
+	{
+		reservations_denied.store(0);
+		charges_denied.store(0);
+		bytes_reclaimed.store(0);
+		queries_shed.store(0);
+	}
+};
+
+class memory_governor;
+
+/**
+ * @class memory_reservation
+ * @brief Memory reserved from a governor, released on destruction
+ */
+class memory_reservation
+{
+public:
+	memory_reservation() = default;
+	~memory_reservation();
+
+	memory_reservation(const memory_reservation&) = delete;
+	memory_reservation& operator=(const memory_reservation&) = delete;
+	memory_reservation(memory_reservation&& other) noexcept;
+	memory_reservation& operator=(memory_reservation&& other) noexcept;
+
+	/**
+	 * @brief Give the memory back to the governor
+	 */
+	void release() noexcept;
+
+	/**
+	 * @brief Grow or shrink the reservation to the given size
+	 * @return false, keeping the current size, if the governor cannot grant
+	 *         the additional memory
+	 */
+	[[nodiscard]] bool resize(size_t bytes);
+
+	/**
+	 * @brief Number of bytes held
+	 */
+	[[nodiscard]] size_t size() const noexcept { return bytes_; }
+
+private:
+	friend class memory_governor;
+
+	memory_reservation(memory_governor* governor, memory_subsystem subsystem, size_t bytes);
+
+	memory_governor* governor_ = nullptr;
+	memory_subsystem subsystem_ = memory_subsystem::results;
+	size_t bytes_ = 0;
+};
+
+/**
+ * @class memory_governor
+ * @brief Accounts gateway memory per subsystem against a global budget
+ */
+class memory_governor
+{
+public:
+	/**
+	 * @brief Reclaims up to the requested number of bytes, returns bytes freed
+	 */
+	using reclaimer_t = std::function<size_t(size_t bytes)>;
+
+	/**
+	 * @brief Constructs a governor with configuration
+	 * @param config Budget and pressure watermark
+	 */
+	explicit memory_governor(const memory_governor_config& config = memory_governor_config{});
+
+	~memory_governor() = default;
+
+	// Non-copyable, non-movable
+	memory_governor(const memory_governor&) = delete;
+	memory_governor& operator=(const memory_governor&) = delete;
+	memory_governor(memory_governor&&) = delete;
+	memory_governor& operator=(memory_governor&&) = delete;
+
+	/**
+	 * @brief Reserve memory that is about to be allocated
+	 * @param subsystem Subsystem the memory is accounted to
+	 * @param bytes Number of bytes
+	 * @return Reservation, or error if the budget is exhausted after reclaiming
+	 */
+	[[nodiscard]] kcenon::common::Result<memory_reservation> reserve(memory_subsystem subsystem,
+																	 size_t bytes);
+
+	/**
+	 * @brief Account optional memory if the governor is not under pressure
+	 * @return true if charged; the caller must release() it later
+	 */
+	[[nodiscard]] bool try_charge(memory_subsystem subsystem, size_t bytes);
+
+	/**
+	 * @brief Account memory that is already held, regardless of the budget
+	 */
+	void charge(memory_subsystem subsystem, size_t bytes) noexcept;
+
+	/**
+	 * @brief Return memory accounted with try_charge() or charge()
+	 */
+	void release(memory_subsystem subsystem, size_t bytes) noexcept;
+
+	/**
+	 * @brief Register the function that shrinks a subsystem under pressure
+	 * @param subsystem Subsystem the reclaimer frees memory from
+	 * @param reclaimer Callback, or nullptr to unregister
+	 */
+	void set_reclaimer(memory_subsystem subsystem, reclaimer_t reclaimer);
+
+	/**
+	 * @brief Decide whether a new query must be rejected to protect memory
+	 * @return true under pressure for SELECTs that may return more than
+	 *         large_query_rows rows
+	 */
+	[[nodiscard]] bool should_shed(const query_request& request);
+
+	/**
+	 * @brief Memory to reserve for a request's result before it is executed
+	 *
+	 * SELECTs are expected to return max_rows rows, or large_query_rows
+	 * without a limit; other requests return a single small response.
+	 */
+	[[nodiscard]] size_t estimate_result(const query_request& request) const noexcept;
+
+	/**
+	 * @brief Check whether usage is above the pressure watermark
+	 */
+	[[nodiscard]] bool under_pressure() const noexcept;
+
+	/**
+	 * @brief Memory currently accounted to a subsystem
+	 */
+	[[nodiscard]] size_t usage(memory_subsystem subsystem) const noexcept;
+
+	/**
+	 * @brief Memory currently accounted to all subsystems
+	 */
+	[[nodiscard]] size_t total_usage() const noexcept;
+
+	/**
+	 * @brief Get governance metrics
+	 */
+	[[nodiscard]] const memory_governor_metrics& metrics() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const memory_governor_config& config() const noexcept;
+
+private:
+	/**
+	 * @brief Add bytes to the total unless it would exceed the limit
+	 */
+	[[nodiscard]] bool try_add(size_t bytes, size_t limit) noexcept;
+
+	/**
+	 * @brief Ask reclaimable subsystems for memory
+	 */
+	size_t reclaim(size_t bytes);
+
+private:
+	memory_governor_config config_;
+	size_t watermark_bytes_ = 0;
+	memory_governor_metrics metrics_;
+
+	std::atomic<size_t> total_{0};
+	std::array<std::atomic<size_t>, memory_subsystem_count> usage_{};
+
+	std::mutex reclaimers_mutex_;
+	std::array<reclaimer_t, memory_subsystem_count> reclaimers_;
+};
+
+} // namespace database_server::gateway
@@ -40,10 +40,12 @@
  * - Automatic invalidation on write operations
  * - Thread-safe operation with reader/writer locks
  * - Configurable size limits and expiration times
+ * - Invalidation listener for pushing invalidations to subscribers
  */
 
 #pragma once
 
+#include "memory_governor.h"
 #include "query_protocol.h"
 #include "query_types.h"
 
@@ -59,6 +61,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 // Common system integration
 #include <kcenon/common/patterns/result.h>
@@ -92,6 +95,7 @@ struct cache_metrics
 	std::atomic<uint64_t> invalidations{0};  ///< Manual invalidation count
 	std::atomic<uint64_t> puts{0};           ///< Total put operations
 	std::atomic<uint64_t> skipped_too_large{0}; ///< Entries skipped due to size
+	std::atomic<uint64_t> skipped_memory_pressure{0}; ///< Entries skipped under memory pressure
 
 	/**
 	 * @brief Calculate cache hit rate
@@ -116,9 +120,21 @@ struct cache_metrics
 		invalidations.store(0);
 		puts.store(0);
 		skipped_too_large.store(0);
+		skipped_memory_pressure.store(0);
 	}
 };
 
+/**
+ * @brief Callback invoked after cache entries are invalidated
+ *
+ * Receives the invalidated table (empty for key-only invalidation) and the
+ * keys of the entries removed. An empty table together with an empty key
+ * list means the whole cache was cleared. Invoked after the cache lock is
+ * released, on the thread that triggered the invalidation.
+ */
+using invalidation_listener_t = std::function<void(
+	const std::string& table_name, const std::vector<std::string>& cache_keys)>;
+
 /**
  * @class query_cache
  * @brief Thread-safe LRU cache for query results with TTL support
@@ -166,9 +182,9 @@ public:
 	explicit query_cache(const cache_config& config = cache_config{});
 
 	/**
-	 * @brief Destructor
+	 * @brief Destructor (detaches from the memory governor)
 	 */
-	~query_cache() = default;
+	~query_cache();
 
 	// Non-copyable, non-movable
 	query_cache(const query_cache&) = delete;
@@ -224,6 +240,8 @@ public:
 	 *
 	 * Called when a write operation (INSERT/UPDATE/DELETE) occurs
 	 * on a table to ensure cached SELECT results are refreshed.
+	 * The invalidation listener is notified even when no entries were
+	 * cached, since clients may hold results for the table themselves.
 	 */
 	[[nodiscard]] kcenon::common::VoidResult invalidate(const std::string& table_name);
 
@@ -239,6 +257,12 @@ public:
 	 */
 	void clear();
 
+	/**
+	 * @brief Set the listener notified of invalidations
+	 * @param listener Callback, or nullptr to remove
+	 */
+	void set_invalidation_listener(invalidation_listener_t listener);
+
 	/**
 	 * @brief Get current cache metrics
 	 * @return Reference to metrics structure
@@ -268,6 +292,33 @@ public:
 	 */
 	[[nodiscard]] const cache_config& config() const noexcept;
 
+	/**
+	 * @brief Account cached entries to a memory governor
+	 * @param governor Governor to charge, or nullptr to detach
+	 *
+	 * Entries are only added while the governor is below its pressure
+	 * watermark, and the governor evicts LRU entries through shrink()
+	 * when other subsystems need the memory.
+	 */
+	void set_memory_governor(std::shared_ptr<memory_governor> governor);
+
+	/**
+	 * @brief Evict least recently used entries
+	 * @param bytes Estimated memory to free
+	 * @return Estimated memory freed
+	 */
+	size_t shrink(size_t bytes);
+
+	/**
+	 * @brief Get estimated memory retained by cached entries in bytes
+	 */
+	[[nodiscard]] size_t memory_usage() const;
+
+	/**
+	 * @brief Estimate the size of a response in bytes
+	 */
+	[[nodiscard]] static size_t estimate_size(const query_response& response);
+
 private:
 	/**
 	 * @struct cache_entry
@@ -297,14 +348,15 @@ private:
 	void evict_lru();
 
 	/**
-	 * @brief Estimate the size of a response in bytes
+	 * @brief Remove an entry from the cache (internal)
 	 */
-	[[nodiscard]] static size_t estimate_size(const query_response& response);
+	void remove_entry(cache_list::iterator it);
 
 	/**
-	 * @brief Remove an entry from the cache (internal)
+	 * @brief Notify the invalidation listener (must not hold mutex_)
 	 */
-	void remove_entry(cache_list::iterator it);
+	void notify_invalidation(const std::string& table_name,
+							 const std::vector<std::string>& cache_keys);
 
 private:
 	cache_config config_;
@@ -313,8 +365,13 @@ private:
 	cache_list lru_list_;   ///< LRU ordering (front = most recent)
 	cache_map cache_map_;   ///< Key to list iterator mapping
 	table_map table_map_;   ///< Table to cache keys mapping
+	size_t memory_bytes_ = 0; ///< Sum of entry estimated sizes
+	std::shared_ptr<memory_governor> governor_;
 
 	cache_metrics metrics_;
+
+	std::mutex listener_mutex_;
+	std::shared_ptr<invalidation_listener_t> listener_;
 };
 
 } // namespace database_server::gateway
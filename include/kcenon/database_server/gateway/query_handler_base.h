@@ -61,6 +61,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <type_traits>
 
 // Common system integration
@@ -77,6 +78,8 @@ namespace database_server::gateway
 
 // Forward declarations
 class query_cache;
+class codel_controller;
+class client_quota_manager;
 
 /**
  * @brief Context passed to query handlers for execution
@@ -89,6 +92,9 @@ struct handler_context
 	std::shared_ptr<pooling::connection_pool> pool;
 	std::shared_ptr<query_cache> cache;
 	uint32_t default_timeout_ms = 30000;
+	codel_controller* admission = nullptr; ///< Receives connection acquisition waits
+	client_quota_manager* quotas = nullptr; ///< Caps connections held per client
+	std::string client_id;                  ///< Client the query runs for (empty = untracked)
 };
 
 /**
@@ -96,6 +96,8 @@ class value_container;
 namespace database_server::gateway
 {
 
+class spill_buffer;
+
 /**
  * @struct message_header
  * @brief Common header for all protocol messages
@@ -125,6 +127,36 @@ struct auth_token
 	[[nodiscard]] bool is_valid() const noexcept;
 };
 
+/**
+ * @struct blob_ref
+ * @brief Binary parameter uploaded beforehand with upload_chunk requests
+ *
+ * Only the upload id travels with the request. The gateway resolves the
+ * reference against the session's completed uploads before the request
+ * reaches the handler; each upload can be referenced by one request.
+ */
+struct blob_ref
+{
+	std::string upload_id;                       ///< Id used in the upload_chunk requests
+	std::shared_ptr<const spill_buffer> content; ///< Set by the gateway (not serialized)
+};
+
+/**
+ * @struct blob_chunk
+ * @brief One piece of a chunked binary upload (query_type::upload_chunk)
+ *
+ * Chunks of an upload are sent in order; offset must equal the number of
+ * bytes the server has received so far, which every upload_chunk response
+ * reports in affected_rows.
+ */
+struct blob_chunk
+{
+	std::string upload_id;     ///< Client-chosen id, unique within the session
+	uint64_t offset = 0;       ///< Position of data within the blob
+	std::vector<uint8_t> data; ///< Chunk bytes
+	bool last = false;         ///< Completes the upload
+};
+
 /**
  * @struct query_param
  * @brief Parameter for prepared statements
@@ -139,7 +171,8 @@ struct query_param
 		int64_t,                 ///< Integer
 		double,                  ///< Floating point
 		std::string,             ///< String
-		std::vector<uint8_t>     ///< Binary data
+		std::vector<uint8_t>,    ///< Binary data
+		blob_ref                 ///< Binary data uploaded in chunks
 	>;
 
 	std::string name;      ///< Parameter name (for named parameters)
@@ -167,6 +200,16 @@ struct query_options
 	std::string isolation_level;  ///< Transaction isolation level
 	uint32_t max_rows = 0;        ///< Maximum rows to return (0 = unlimited)
 	bool include_metadata = true; ///< Include column metadata in response
+
+	/// Key column for delta-encoded results (empty = always send full results).
+	/// When set on a SELECT, the gateway keeps a snapshot of the last result
+	/// sent to this session and later responses carry only changed rows.
+	std::string delta_key_column;
+	uint64_t delta_base_version = 0; ///< result_version the client holds (0 = none)
+
+	/// Ask for the columnar row layout (v2 wire format only; the gateway also
+	/// picks it for results of at least gateway_config::columnar_min_rows rows)
+	bool columnar = false;
 };
 
 /**
@@ -184,6 +227,7 @@ struct query_request
 	std::string sql;                  ///< Query string or prepared statement ID
 	std::vector<query_param> params;  ///< Query parameters
 	query_options options;            ///< Execution options
+	std::optional<blob_chunk> chunk;  ///< Upload data (upload_chunk only)
 
 	query_request() = default;
 
@@ -255,6 +299,22 @@ struct result_row
 	std::vector<cell_value> cells;  ///< Cell values in column order
 };
 
+/**
+ * @struct result_delta
+ * @brief Row changes relative to a previously delivered result
+ *
+ * Rows are matched by the key column declared in
+ * query_options::delta_key_column. Inserted and updated rows carry all
+ * cells; deleted rows are identified by their key value only.
+ */
+struct result_delta
+{
+	uint64_t base_version = 0;                        ///< Version the delta applies to
+	std::vector<result_row> inserted;                 ///< Rows not present in the base
+	std::vector<result_row> updated;                  ///< Rows whose cells changed
+	std::vector<result_row::cell_value> deleted_keys; ///< Keys of rows no longer present
+};
+
 /**
  * @struct query_response
  * @brief Response message for database queries
@@ -271,6 +331,8 @@ struct query_response
 	uint64_t affected_rows = 0;               ///< Affected count (for INSERT/UPDATE/DELETE)
 	std::string error_message;                ///< Error details if status != OK
 	uint64_t execution_time_us = 0;           ///< Query execution time in microseconds
+	uint64_t result_version = 0;              ///< Snapshot version (delta mode, 0 = none)
+	std::optional<result_delta> delta;        ///< Set instead of rows for delta responses
 
 	query_response() = default;
 
@@ -317,4 +379,46 @@ struct query_response
 	[[nodiscard]] bool is_success() const noexcept;
 };
 
+/**
+ * @struct invalidation_event
+ * @brief Server-pushed notice that results cached by a client are stale
+ *
+ * Sent unsolicited (message_id 0, container message type
+ * "invalidation_event", or a v2 event frame to sessions using wire v2)
+ * to sessions that subscribed with
+ * query_type::subscribe. Sequence numbers are per session, start at 1
+ * and have no gaps; a gap or the resync flag means the client must drop
+ * every locally cached result covered by its subscriptions.
+ */
+struct invalidation_event
+{
+	message_header header;               ///< Message header
+	uint64_t sequence = 0;               ///< Per-session sequence number
+	std::vector<std::string> tables;     ///< Invalidated tables
+	std::vector<std::string> cache_keys; ///< Invalidated query cache keys
+	bool resync = false;                 ///< Drop all locally cached results
+
+	/**
+	 * @brief Serialize to container for network transmission
+	 * @return Shared pointer to serialized container
+	 */
+	[[nodiscard]] std::shared_ptr<container_module::value_container> serialize() const;
+
+	/**
+	 * @brief Deserialize from container
+	 * @param container The container to deserialize from
+	 * @return Result containing deserialized event or error
+	 */
+	static kcenon::common::Result<invalidation_event>
+	deserialize(std::shared_ptr<container_module::value_container> container);
+
+	/**
+	 * @brief Deserialize from byte array
+	 * @param data The byte array to deserialize from
+	 * @return Result containing deserialized event or error
+	 */
+	static kcenon::common::Result<invalidation_event>
+	deserialize(const std::vector<uint8_t>& data);
+};
+
 } // namespace database_server::gateway
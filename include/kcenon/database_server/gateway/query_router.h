@@ -41,11 +41,15 @@
  * - Round-robin load balancing across connections
  * - Priority-based query scheduling
  * - Query execution with timeout support
+ * - Fail-fast while the backend pool is failing (circuit breaker)
  * - Metrics collection for monitoring
  */
 
 #pragma once
 
+#include "client_quota.h"
+#include "codel_controller.h"
+#include "cost_limiter.h"
 #include "query_cache.h"
 #include "query_handler_base.h"
 #include "query_handlers.h"
@@ -66,6 +70,8 @@
 #include <kcenon/common/interfaces/executor_interface.h>
 #include <kcenon/common/patterns/result.h>
 
+#include <kcenon/database_server/resilience/circuit_breaker.h>
+
 // Forward declarations
 namespace database_server::pooling
 {
@@ -84,6 +90,10 @@ struct router_config
 	uint32_t default_timeout_ms = 30000;   ///< Default query timeout
 	uint32_t max_concurrent_queries = 100; ///< Maximum concurrent queries
 	bool enable_metrics = true;            ///< Enable metrics collection
+	codel_config admission;                ///< Load shedding on connection/executor waits
+	client_quota_config client_quotas;     ///< Per-client in-flight query and connection caps
+	cost_limit_config cost_limits;         ///< Per-client allowance of measured query cost
+	resilience::circuit_breaker_config circuit_breaker; ///< Fail fast while the pool is failing
 };
 
 /**
@@ -179,6 +189,22 @@ public:
 	 */
 	[[nodiscard]] kcenon::common::Result<query_response> execute(const query_request& request);
 
+	/**
+	 * @brief Execute a query request on behalf of a client
+	 * @param request The query request to execute
+	 * @param client_id Client charged against the per-client quotas
+	 * @return Result containing query response or error
+	 *
+	 * A client over its in-flight query quota waits up to
+	 * client_quota_config::queue_timeout_ms for one of its queries to
+	 * finish and is then answered with status_code::rate_limited, as is a
+	 * client that cannot afford the estimated cost of the query. While the
+	 * circuit breaker is open, queries are answered with
+	 * status_code::connection_failed without waiting for a connection.
+	 */
+	[[nodiscard]] kcenon::common::Result<query_response> execute(const query_request& request,
+																 const std::string& client_id);
+
 	/**
 	 * @brief Execute a query request asynchronously
 	 * @param request The query request to execute
@@ -190,6 +216,19 @@ public:
 	void execute_async(const query_request& request,
 					   std::function<void(query_response)> callback);
 
+	/**
+	 * @brief Execute a query request asynchronously on behalf of a client
+	 * @param request The query request to execute
+	 * @param client_id Client charged against the per-client quotas
+	 * @param callback Callback to invoke with response
+	 *
+	 * Admission is the same as execute(request, client_id); the callback
+	 * is invoked on a worker thread when the query completes.
+	 */
+	void execute_async(const query_request& request,
+					   const std::string& client_id,
+					   std::function<void(query_response)> callback);
+
 	/**
 	 * @brief Get current router metrics
 	 * @return Reference to metrics structure
@@ -266,7 +305,38 @@ public:
 	 */
 	[[nodiscard]] handler_context get_handler_context() const;
 
+	/**
+	 * @brief Get the admission controller
+	 * @return Controller fed by connection acquisition and executor queue waits
+	 *
+	 * While it reports a standing queue, execute() answers sheddable
+	 * requests with status_code::server_busy instead of queueing them.
+	 */
+	[[nodiscard]] const codel_controller& admission() const noexcept;
+
+	/**
+	 * @brief Get the per-client quota manager
+	 * @return Manager reporting each client's in-flight queries, held
+	 *         connections and rejections
+	 */
+	[[nodiscard]] const client_quota_manager& client_quotas() const noexcept;
+
+	/**
+	 * @brief Get the cost-based rate limiter
+	 * @return Limiter charging each client the measured cost of its queries
+	 */
+	[[nodiscard]] const cost_limiter& cost_limits() const noexcept;
+
+	/**
+	 * @brief Get the circuit breaker of the connection pool
+	 * @return Breaker fed by queries that could not reach the database or
+	 *         were slow; its metrics count the state transitions
+	 */
+	[[nodiscard]] const resilience::circuit_breaker& breaker() const noexcept;
+
 private:
+	friend class async_query_job;
+
 	/**
 	 * @brief Find handler for query type
 	 * @param type Query type to find handler for
@@ -277,7 +347,8 @@ private:
 	/**
 	 * @brief Execute query using appropriate handler
 	 */
-	[[nodiscard]] query_response execute_with_handler(const query_request& request);
+	[[nodiscard]] query_response execute_with_handler(const query_request& request,
+													  const std::string& client_id);
 
 	/**
 	 * @brief Record execution metrics
@@ -295,6 +366,10 @@ private:
 	std::shared_ptr<query_cache> cache_;
 	std::shared_ptr<kcenon::common::interfaces::IExecutor> executor_;
 	router_metrics metrics_;
+	mutable codel_controller admission_;
+	mutable client_quota_manager client_quotas_;
+	cost_limiter cost_limits_;
+	resilience::circuit_breaker breaker_;
 
 	std::atomic<uint64_t> active_queries_{0};
 	mutable std::mutex pool_mutex_;
@@ -80,6 +80,9 @@ enum class query_type : uint8_t
 	execute = 5,  ///< EXECUTE query - runs stored procedure
 	batch = 6,    ///< BATCH query - multiple queries in one request
 	ping = 7,     ///< PING - health check request
+	subscribe = 8,   ///< SUBSCRIBE - receive invalidation events for tables/queries
+	unsubscribe = 9, ///< UNSUBSCRIBE - stop receiving invalidation events
+	upload_chunk = 10, ///< UPLOAD_CHUNK - append a piece of a large binary parameter
 };
 
 /**
@@ -124,6 +127,12 @@ constexpr std::string_view to_string(query_type type) noexcept
 		return "BATCH";
 	case query_type::ping:
 		return "PING";
+	case query_type::subscribe:
+		return "SUBSCRIBE";
+	case query_type::unsubscribe:
+		return "UNSUBSCRIBE";
+	case query_type::upload_chunk:
+		return "UPLOAD_CHUNK";
 	default:
 		return "UNKNOWN";
 	}
@@ -186,6 +195,12 @@ inline query_type parse_query_type(std::string_view str) noexcept
 		return query_type::batch;
 	if (str == "PING" || str == "ping")
 		return query_type::ping;
+	if (str == "SUBSCRIBE" || str == "subscribe")
+		return query_type::subscribe;
+	if (str == "UNSUBSCRIBE" || str == "unsubscribe")
+		return query_type::unsubscribe;
+	if (str == "UPLOAD_CHUNK" || str == "upload_chunk")
+		return query_type::upload_chunk;
 	return query_type::unknown;
 }
 
@@ -0,0 +1,269 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file request_view.h
+ * @brief Non-owning view of a v2 request frame
+ *
+ * query_request_view::parse() validates a v2 request frame in place and
+ * exposes its fields as string_views and spans into the frame. Parameters
+ * are checked during parsing but only decoded while iterating over them,
+ * and nothing is copied until to_request() or to_param() is called.
+ *
+ * @code
+ * auto view = query_request_view::parse(frame);
+ * if (view.is_ok() && view.value().type == query_type::select)
+ * {
+ *     for (const auto& param : view.value().params)
+ *     {
+ *         // param.name and string values point into frame
+ *     }
+ *     query_request request = view.value().to_request();
+ * }
+ * @endcode
+ *
+ * ## Lifetime
+ * A view and everything obtained from it refer to the parsed buffer and
+ * must not outlive it.
+ */
+
+#pragma once
+
+#include "query_protocol.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <kcenon/common/patterns/result.h>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct blob_ref_view
+ * @brief Reference to a chunked upload, as found in a request frame
+ */
+struct blob_ref_view
+{
+	std::string_view upload_id;
+};
+
+/// Parameter value pointing into the frame (strings and bytes are not copied)
+using param_value_view = std::variant<
+	std::monostate,
+	bool,
+	int64_t,
+	double,
+	std::string_view,
+	std::span<const uint8_t>,
+	blob_ref_view>;
+
+/**
+ * @struct query_param_view
+ * @brief One request parameter, decoded on demand
+ */
+struct query_param_view
+{
+	std::string_view name;
+	param_value_view value;
+
+	/**
+	 * @brief Copy the parameter into an owning query_param
+	 */
+	[[nodiscard]] query_param to_param() const;
+};
+
+/**
+ * @class param_list_view
+ * @brief Lazily decoded parameter list of a request frame
+ */
+class param_list_view
+{
+public:
+	/**
+	 * @class iterator
+	 * @brief Input iterator decoding one parameter per step
+	 */
+	class iterator
+	{
+	public:
+		using iterator_category = std::input_iterator_tag;
+		using value_type = query_param_view;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const query_param_view*;
+		using reference = const query_param_view&;
+
+		iterator() = default;
+
+		reference operator*() const noexcept { return current_; }
+		pointer operator->() const noexcept { return &current_; }
+
+		iterator& operator++();
+		iterator operator++(int)
+		{
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+
+		bool operator==(const iterator& other) const noexcept
+		{
+			return remaining_ == other.remaining_;
+		}
+
+	private:
+		friend class param_list_view;
+
+		iterator(std::span<const uint8_t> data, size_t remaining);
+
+		void decode();
+
+		std::span<const uint8_t> data_;
+		size_t remaining_ = 0;
+		query_param_view current_;
+	};
+
+	param_list_view() = default;
+
+	[[nodiscard]] size_t size() const noexcept { return count_; }
+	[[nodiscard]] bool empty() const noexcept { return count_ == 0; }
+
+	[[nodiscard]] iterator begin() const { return iterator(data_, count_); }
+	[[nodiscard]] iterator end() const { return iterator(); }
+
+	/**
+	 * @brief Find a named parameter
+	 * @return First parameter with the name, or nullopt
+	 */
+	[[nodiscard]] std::optional<query_param_view> find(std::string_view name) const;
+
+	/**
+	 * @brief Copy all parameters into owning query_params
+	 */
+	[[nodiscard]] std::vector<query_param> to_params() const;
+
+private:
+	friend struct query_request_view;
+
+	param_list_view(std::span<const uint8_t> data, size_t count)
+		: data_(data)
+		, count_(count)
+	{
+	}
+
+	std::span<const uint8_t> data_; ///< Encoded parameters (already validated)
+	size_t count_ = 0;
+};
+
+/**
+ * @struct message_header_view
+ * @brief message_header fields of a request frame
+ */
+struct message_header_view
+{
+	uint64_t message_id = 0;
+	uint64_t timestamp = 0;
+	std::string_view correlation_id;
+};
+
+/**
+ * @struct auth_token_view
+ * @brief auth_token fields of a request frame
+ */
+struct auth_token_view
+{
+	std::string_view token;
+	std::string_view client_id;
+	uint64_t expires_at = 0;
+};
+
+/**
+ * @struct query_options_view
+ * @brief query_options fields of a request frame
+ */
+struct query_options_view
+{
+	uint32_t timeout_ms = 30000;
+	bool read_only = false;
+	bool include_metadata = true;
+	bool columnar = false;
+	std::string_view isolation_level;
+	uint32_t max_rows = 0;
+	std::string_view delta_key_column;
+	uint64_t delta_base_version = 0;
+};
+
+/**
+ * @struct blob_chunk_view
+ * @brief blob_chunk fields of a request frame
+ */
+struct blob_chunk_view
+{
+	std::string_view upload_id;
+	uint64_t offset = 0;
+	std::span<const uint8_t> data;
+	bool last = false;
+};
+
+/**
+ * @struct query_request_view
+ * @brief Request fields referring into a v2 request frame
+ */
+struct query_request_view
+{
+	message_header_view header;
+	auth_token_view token;
+	query_type type = query_type::unknown;
+	std::string_view sql;
+	param_list_view params;
+	query_options_view options;
+	std::optional<blob_chunk_view> chunk;
+
+	/**
+	 * @brief Validate a v2 request frame and map its fields
+	 * @return View into data, or error if the frame is malformed
+	 */
+	[[nodiscard]] static kcenon::common::Result<query_request_view> parse(
+		std::span<const uint8_t> data);
+
+	/**
+	 * @brief Copy the request into an owning query_request (header.version = 2)
+	 */
+	[[nodiscard]] query_request to_request() const;
+};
+
+} // namespace database_server::gateway
@@ -0,0 +1,229 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file result_delta.h
+ * @brief Delta-encoded results for repeated polling queries
+ *
+ * Clients that poll the same SELECT can opt in to delta encoding by setting
+ * query_options::delta_key_column. The gateway then remembers, per session,
+ * a compact snapshot of the last result it sent for that query and answers
+ * subsequent polls with only the inserted, updated and deleted rows.
+ *
+ * Snapshots store one key and one 64-bit row fingerprint per row rather than
+ * the rows themselves, and the total retained memory is bounded with LRU
+ * eviction across all sessions.
+ *
+ * Protocol:
+ * - The first response (or any response the client cannot apply as a delta)
+ *   is a full result carrying a non-zero result_version.
+ * - The client echoes that version back in query_options::delta_base_version.
+ * - If the server still holds that snapshot, the response carries a
+ *   result_delta with base_version set and an empty row list.
+ * - A result_version of 0 means the server kept no snapshot for the result
+ *   (too large, duplicate or NULL keys, unknown key column).
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe and serialized by an internal mutex.
+ *
+ * @code
+ * using namespace database_server::gateway;
+ *
+ * result_delta_tracker tracker(delta_config{});
+ *
+ * // After the handler produced a full response for a session
+ * tracker.apply(session_id, request, response);
+ * // response is now either a full result or a delta
+ *
+ * // On disconnect
+ * tracker.remove_session(session_id);
+ * @endcode
+ */
+
+#pragma once
+
+#include "query_protocol.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct delta_config
+ * @brief Configuration for delta-encoded results
+ */
+struct delta_config
+{
+	bool enabled = true;                        ///< Honor client delta requests
+	size_t max_snapshots = 10000;               ///< Maximum retained snapshots (all sessions)
+	size_t max_memory_bytes = 64 * 1024 * 1024; ///< Memory budget for all snapshots
+	size_t max_rows_per_snapshot = 100000;      ///< Larger results are never snapshotted
+	double max_change_ratio = 0.5; ///< Send a full result when more rows than this changed
+};
+
+/**
+ * @struct delta_metrics
+ * @brief Statistics for delta encoding
+ */
+struct delta_metrics
+{
+	std::atomic<uint64_t> delta_responses{0};   ///< Responses sent as deltas
+	std::atomic<uint64_t> full_responses{0};    ///< Opted-in responses sent in full
+	std::atomic<uint64_t> rows_suppressed{0};   ///< Unchanged rows not resent
+	std::atomic<uint64_t> evictions{0};         ///< Snapshots evicted for memory/count
+	std::atomic<uint64_t> not_snapshotted{0};   ///< Results that could not be snapshotted
+
+	/**
+	 * @brief Reset all metrics counters
+	 */
+	void reset() noexcept
+	{
+		delta_responses.store(0);
+		full_responses.store(0);
+		rows_suppressed.store(0);
+		evictions.store(0);
+		not_snapshotted.store(0);
+	}
+};
+
+/**
+ * @class result_delta_tracker
+ * @brief Per-session snapshot store that turns full results into deltas
+ */
+class result_delta_tracker
+{
+public:
+	/**
+	 * @brief Constructs a tracker with configuration
+	 * @param config Delta configuration
+	 */
+	explicit result_delta_tracker(const delta_config& config = delta_config{});
+
+	// Non-copyable, non-movable
+	result_delta_tracker(const result_delta_tracker&) = delete;
+	result_delta_tracker& operator=(const result_delta_tracker&) = delete;
+	result_delta_tracker(result_delta_tracker&&) = delete;
+	result_delta_tracker& operator=(result_delta_tracker&&) = delete;
+
+	/**
+	 * @brief Check whether a request/response pair is eligible for delta encoding
+	 * @param request The originating request
+	 * @param response The response produced by the handler
+	 * @return true if the request opted in and the response is a successful SELECT
+	 */
+	[[nodiscard]] bool is_eligible(const query_request& request,
+								   const query_response& response) const noexcept;
+
+	/**
+	 * @brief Record the result and rewrite the response as a delta if possible
+	 * @param session_id Session the response is sent to
+	 * @param request The originating request (carries key column and base version)
+	 * @param response Full response; replaced with a delta response when possible
+	 *
+	 * Does nothing for requests that did not opt in.
+	 */
+	void apply(const std::string& session_id,
+			   const query_request& request,
+			   query_response& response);
+
+	/**
+	 * @brief Drop all snapshots held for a session
+	 * @param session_id Session identifier
+	 */
+	void remove_session(const std::string& session_id);
+
+	/**
+	 * @brief Drop all snapshots
+	 */
+	void clear();
+
+	/**
+	 * @brief Get number of retained snapshots
+	 */
+	[[nodiscard]] size_t snapshot_count() const;
+
+	/**
+	 * @brief Get estimated memory retained by snapshots in bytes
+	 */
+	[[nodiscard]] size_t memory_usage() const;
+
+	/**
+	 * @brief Get delta metrics
+	 */
+	[[nodiscard]] const delta_metrics& metrics() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const delta_config& config() const noexcept;
+
+private:
+	/**
+	 * @struct snapshot
+	 * @brief Compact image of the last result sent for a (session, query) pair
+	 */
+	struct snapshot
+	{
+		std::string id;                                ///< session id + query key
+		std::string session_id;                        ///< Owning session
+		uint64_t version = 0;                          ///< Version sent to the client
+		uint64_t layout_hash = 0;                      ///< Column names + key column
+		std::unordered_map<std::string, uint64_t> rows; ///< Encoded key -> row fingerprint
+		size_t estimated_size = 0;                     ///< Estimated memory size
+	};
+
+	using snapshot_list = std::list<snapshot>;
+
+	void remove_snapshot(snapshot_list::iterator it);
+	void evict_to_fit(size_t incoming_size);
+
+private:
+	delta_config config_;
+	mutable std::mutex mutex_;
+
+	snapshot_list lru_list_; ///< LRU ordering (front = most recent)
+	std::unordered_map<std::string, snapshot_list::iterator> snapshot_map_;
+	std::unordered_map<std::string, std::unordered_set<std::string>> session_map_;
+	size_t memory_usage_ = 0;
+	uint64_t next_version_ = 1;
+
+	delta_metrics metrics_;
+};
+
+} // namespace database_server::gateway
@@ -0,0 +1,243 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file session_transport.h
+ * @brief Transport abstraction for gateway client sessions
+ *
+ * The gateway accepts TCP clients through kcenon::network. Additional
+ * listeners implemented in this repository (e.g. Unix domain sockets for
+ * co-located clients) expose their connections through session_transport
+ * so that all of them share the same session model and request pipeline.
+ *
+ * ## Thread Safety
+ * Implementations must allow send() and close() to be called from any
+ * thread. Listener callbacks are invoked from the listener's I/O thread.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Common system integration
+#include <kcenon/common/patterns/result.h>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct peer_credentials
+ * @brief Identity of the process on the other end of a local connection
+ *
+ * Obtained from the kernel (SO_PEERCRED on Linux, getpeereid() on BSD and
+ * macOS) and therefore cannot be forged by the client.
+ */
+struct peer_credentials
+{
+	int32_t pid = -1;  ///< Peer process ID (-1 if unavailable)
+	uint32_t uid = 0;  ///< Peer effective user ID
+	uint32_t gid = 0;  ///< Peer effective group ID
+};
+
+/**
+ * @class session_transport
+ * @brief A single client connection, independent of the wire transport
+ */
+class session_transport
+{
+public:
+	virtual ~session_transport() = default;
+
+	/**
+	 * @brief Get transport-level connection identifier (unique per listener)
+	 */
+	[[nodiscard]] virtual std::string_view id() const = 0;
+
+	/**
+	 * @brief Check if the connection is still open
+	 */
+	[[nodiscard]] virtual bool is_connected() const = 0;
+
+	/**
+	 * @brief Send one message to the client
+	 * @param data Serialized message
+	 * @return Error if the connection is closed or the write failed
+	 */
+	[[nodiscard]] virtual kcenon::common::VoidResult send(std::vector<uint8_t>&& data) = 0;
+
+	/**
+	 * @brief Close the connection
+	 */
+	virtual void close() = 0;
+
+	/**
+	 * @brief Get kernel-verified peer credentials, if the transport has them
+	 */
+	[[nodiscard]] virtual std::optional<peer_credentials> peer() const { return std::nullopt; }
+
+	/**
+	 * @brief Get transport name for logging ("tcp", "unix", ...)
+	 */
+	[[nodiscard]] virtual std::string_view transport_name() const = 0;
+};
+
+/**
+ * @class transport_listener
+ * @brief Accepts session_transport connections and reports their traffic
+ *
+ * Callbacks must be set before start().
+ */
+class transport_listener
+{
+public:
+	using connection_callback_t = std::function<void(std::shared_ptr<session_transport>)>;
+	using disconnection_callback_t = std::function<void(std::string_view transport_id)>;
+	using receive_callback_t
+		= std::function<void(std::string_view transport_id, const std::vector<uint8_t>& data)>;
+
+	virtual ~transport_listener() = default;
+
+	/**
+	 * @brief Start accepting connections
+	 */
+	[[nodiscard]] virtual kcenon::common::VoidResult start() = 0;
+
+	/**
+	 * @brief Stop accepting connections and close all open ones
+	 */
+	virtual void stop() = 0;
+
+	/**
+	 * @brief Check if the listener is running
+	 */
+	[[nodiscard]] virtual bool is_running() const noexcept = 0;
+
+	/**
+	 * @brief Get number of open connections
+	 */
+	[[nodiscard]] virtual size_t connection_count() const = 0;
+
+	/**
+	 * @brief Get transport name, matching its sessions' transport_name()
+	 */
+	[[nodiscard]] virtual std::string_view transport_name() const = 0;
+
+	// ---- Listening-socket handoff (zero-downtime restart) ----
+
+	/**
+	 * @brief Get the listening socket so it can be passed to another process
+	 * @return Descriptor, or -1 if not running or the listener cannot be handed off
+	 */
+	[[nodiscard]] virtual int listen_fd() const noexcept { return -1; }
+
+	/**
+	 * @brief Serve an already listening socket instead of binding one
+	 *
+	 * Must be called before start(). The listener takes ownership of @p fd;
+	 * a socket file belonging to it is treated as the listener's own.
+	 *
+	 * @return false if the listener cannot adopt a socket (fd is not taken)
+	 */
+	virtual bool adopt_listen_fd(int fd)
+	{
+		(void)fd;
+		return false;
+	}
+
+	/**
+	 * @brief Stop accepting new connections while serving the open ones
+	 *
+	 * Called after the listening socket was handed to another process.
+	 * The socket file, if any, now belongs to that process and is left in
+	 * place by stop().
+	 */
+	virtual void stop_accepting() {}
+
+	/**
+	 * @brief Detach idle connections so that another process can adopt them
+	 *
+	 * A connection is idle when it holds no partially received message and
+	 * no unsent data. Each detached connection is reported through the
+	 * disconnection callback but not shut down; the caller owns the returned
+	 * descriptors.
+	 *
+	 * @param eligible Called with the transport id of each idle connection
+	 * @return Detached descriptors (empty if the listener does not support it)
+	 */
+	[[nodiscard]] virtual std::vector<int> release_idle_connections(
+		const std::function<bool(std::string_view transport_id)>& eligible)
+	{
+		(void)eligible;
+		return {};
+	}
+
+	/**
+	 * @brief Serve a connected socket detached by another process
+	 *
+	 * Takes ownership of @p fd on success. The connection is reported
+	 * through the connection callback like an accepted one.
+	 */
+	[[nodiscard]] virtual kcenon::common::VoidResult adopt_connection(int fd)
+	{
+		(void)fd;
+		return kcenon::common::error_info{
+			-1, "Listener cannot adopt connections", "transport_listener"
+		};
+	}
+
+	void set_connection_callback(connection_callback_t callback)
+	{
+		connection_callback_ = std::move(callback);
+	}
+
+	void set_disconnection_callback(disconnection_callback_t callback)
+	{
+		disconnection_callback_ = std::move(callback);
+	}
+
+	void set_receive_callback(receive_callback_t callback)
+	{
+		receive_callback_ = std::move(callback);
+	}
+
+protected:
+	connection_callback_t connection_callback_;
+	disconnection_callback_t disconnection_callback_;
+	receive_callback_t receive_callback_;
+};
+
+} // namespace database_server::gateway
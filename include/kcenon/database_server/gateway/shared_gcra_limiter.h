@@ -0,0 +1,234 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file shared_gcra_limiter.h
+ * @brief Per-client GCRA rate limiting shared by every process on a host
+ *
+ * gcra_limiter keeps its state in process memory, so N gateway processes
+ * on one host admit N times the configured rate. shared_gcra_limiter
+ * keeps the same per-client state (TAT and block expiration, see
+ * gcra_params) in a named POSIX shared-memory segment, so every process
+ * that opens the segment enforces one budget.
+ *
+ * The segment holds a fixed open-addressing table. A client is found by
+ * a 64-bit FNV-1a hash of its id, which is stable across processes and
+ * builds, with linear probing over at most max_probes cells. Every field
+ * is a lock-free atomic and every update a compare-and-swap, so a process
+ * that dies mid-request cannot leave the table locked. Cells are never
+ * emptied: when a new client finds no free cell in its probe range it
+ * takes over one whose state has expired. A request of the previous
+ * owner racing with the takeover may be charged to the new owner, and
+ * two ids with the same 64-bit hash share a budget; both are rare enough
+ * to leave the limit approximate only in theory. When every cell in
+ * range is in use the request is admitted and counted in overflows().
+ *
+ * The first process creates and sizes the segment; later ones validate
+ * that their rate, burst, block duration and slot count match it. The
+ * segment outlives the processes until remove() is called.
+ *
+ * ## Platform
+ * Linux only; open() fails elsewhere. The timestamps come from
+ * steady_clock, which is CLOCK_MONOTONIC and shared by every process.
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe and process-safe.
+ *
+ * @code
+ * using namespace database_server::gateway;
+ *
+ * auto opened = shared_gcra_limiter::open("/database_server-ratelimit", 100, 200, 60000);
+ * if (opened.is_ok() && !opened.value()->allow_request(client_id)) {
+ *     return query_response(id, status_code::rate_limited, "Rate limit exceeded");
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include "gcra_limiter.h"
+
+#include <kcenon/common/patterns/result.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace database_server::gateway
+{
+
+/**
+ * @class shared_gcra_limiter
+ * @brief GCRA rate limiter whose state lives in a shared-memory segment
+ */
+class shared_gcra_limiter
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	static constexpr uint32_t default_slots = 65536; ///< Default table size
+	static constexpr size_t max_probes = 32;         ///< Cells searched per client
+
+	/**
+	 * @brief Open the named segment, creating it if it does not exist
+	 * @param name POSIX shared-memory name (leading '/', no other '/')
+	 * @param requests_per_second Sustained rate per client
+	 * @param burst_size Requests a client may send at once
+	 * @param block_duration_ms How long a client that exceeded the limit is
+	 *        rejected (0 = only the excess requests are rejected)
+	 * @param slots Table size, rounded up to a power of two
+	 * @return The limiter, or an error if the segment cannot be mapped or
+	 *         was created with different parameters
+	 */
+	[[nodiscard]] static kcenon::common::Result<std::shared_ptr<shared_gcra_limiter>> open(
+		const std::string& name, uint32_t requests_per_second, uint32_t burst_size,
+		uint32_t block_duration_ms, uint32_t slots = default_slots);
+
+	/**
+	 * @brief Remove the named segment
+	 *
+	 * Processes that have it mapped keep using it; the next open() creates
+	 * a fresh one.
+	 */
+	static kcenon::common::VoidResult remove(const std::string& name);
+
+	~shared_gcra_limiter();
+
+	// Non-copyable, non-movable
+	shared_gcra_limiter(const shared_gcra_limiter&) = delete;
+	shared_gcra_limiter& operator=(const shared_gcra_limiter&) = delete;
+	shared_gcra_limiter(shared_gcra_limiter&&) = delete;
+	shared_gcra_limiter& operator=(shared_gcra_limiter&&) = delete;
+
+	/**
+	 * @brief Check and record a request of a client
+	 * @return true if the request is allowed
+	 */
+	[[nodiscard]] bool allow_request(const std::string& client_id);
+	[[nodiscard]] bool allow_request(const std::string& client_id, clock::time_point now);
+
+	/**
+	 * @brief Requests the client could send immediately
+	 */
+	[[nodiscard]] uint32_t remaining_requests(const std::string& client_id) const;
+	[[nodiscard]] uint32_t remaining_requests(const std::string& client_id,
+											  clock::time_point now) const;
+
+	/**
+	 * @brief Check if client is currently blocked
+	 */
+	[[nodiscard]] bool is_blocked(const std::string& client_id) const;
+	[[nodiscard]] bool is_blocked(const std::string& client_id, clock::time_point now) const;
+
+	/**
+	 * @brief Block expiration as Unix epoch milliseconds (0 if not blocked)
+	 */
+	[[nodiscard]] uint64_t block_expires_at(const std::string& client_id) const;
+
+	/**
+	 * @brief Forget a client's state in every process
+	 */
+	void reset(const std::string& client_id);
+
+	/**
+	 * @brief Number of cells that hold a client whose state has not expired
+	 */
+	[[nodiscard]] size_t size() const;
+	[[nodiscard]] size_t size(clock::time_point now) const;
+
+	/**
+	 * @brief Number of cells in the table
+	 */
+	[[nodiscard]] size_t capacity() const noexcept;
+
+	/**
+	 * @brief Requests admitted because no cell was free, across all processes
+	 */
+	[[nodiscard]] uint64_t overflows() const noexcept;
+
+	/**
+	 * @brief Get the GCRA parameters
+	 */
+	[[nodiscard]] const gcra_params& params() const noexcept;
+
+	/**
+	 * @brief Get the segment name
+	 */
+	[[nodiscard]] const std::string& name() const noexcept;
+
+private:
+	struct alignas(64) segment_header
+	{
+		std::atomic<uint64_t> magic{0};     ///< Set last by the creator
+		uint32_t version = 0;
+		uint32_t slot_count = 0;
+		int64_t emission_ns = 0;
+		int64_t tolerance_ns = 0;
+		int64_t block_ns = 0;
+		std::atomic<uint64_t> overflows{0}; ///< Requests admitted without a cell
+	};
+
+	struct alignas(32) cell
+	{
+		std::atomic<uint64_t> key{0};          ///< Client hash (0 = never used)
+		std::atomic<int64_t> tat{0};           ///< Theoretical arrival time (clock ns)
+		std::atomic<int64_t> blocked_until{0}; ///< Block expiration (clock ns)
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free
+					  && std::atomic<int64_t>::is_always_lock_free,
+				  "shared-memory atomics must not fall back to process-local locks");
+
+	shared_gcra_limiter(std::string name, void* mapping, size_t mapping_size);
+
+	static int64_t to_ns(clock::time_point time) noexcept;
+	static uint64_t hash_of(const std::string& client_id) noexcept;
+	[[nodiscard]] size_t index_of(uint64_t hash) const noexcept;
+	[[nodiscard]] const cell* find(uint64_t hash) const noexcept;
+	[[nodiscard]] cell* claim(uint64_t hash, int64_t now) noexcept;
+	[[nodiscard]] bool is_idle(const cell& state, int64_t now) const noexcept;
+	[[nodiscard]] bool update(cell& state, int64_t now) noexcept;
+
+private:
+	std::string name_;
+	void* mapping_;
+	size_t mapping_size_;
+	segment_header* header_;
+	cell* cells_;
+	uint32_t shift_;
+	gcra_params params_;
+	int64_t block_ns_;
+};
+
+} // namespace database_server::gateway
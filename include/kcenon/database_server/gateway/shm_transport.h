@@ -0,0 +1,264 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file shm_transport.h
+ * @brief Shared-memory ring transport for co-located gateway clients
+ *
+ * For latency-critical callers on the same host, even the syscalls of a
+ * Unix domain socket are measurable. This transport moves message bytes
+ * through shared memory instead:
+ *
+ * - A client connects to a Unix domain socket (the handshake socket).
+ * - The server creates a sealed memfd segment holding two
+ *   single-producer/single-consumer byte rings (client-to-server and
+ *   server-to-client) plus one eventfd per ring direction for wakeups,
+ *   and passes the descriptors to the client with SCM_RIGHTS.
+ * - Messages are written to the rings using the same 4-byte big-endian
+ *   length framing as the stream transports, so frames larger than a ring
+ *   stream through it in chunks.
+ * - Waiting sides spin for a bounded number of iterations before
+ *   advertising that they sleep; a peer only pays for an eventfd write
+ *   when the other side is actually asleep.
+ * - The handshake socket stays open as the liveness channel: closing it
+ *   ends the session, and it provides kernel-verified peer credentials.
+ *
+ * Only available on Linux; start() and shm_client::connect() return an
+ * error elsewhere.
+ *
+ * ## Thread Safety
+ * start() and stop() must not be called concurrently. Callbacks are invoked
+ * from a single I/O thread; session send() may be called from any thread.
+ * shm_client::send() and shm_client::receive() may run on different
+ * threads, but neither may be called concurrently with itself, and
+ * connect() / disconnect() must not overlap with either.
+ *
+ * @code
+ * // Server side (normally created by gateway_server from gateway_config)
+ * shm_transport_config config;
+ * config.path = "/run/database_server/gateway-shm.sock";
+ * shm_transport_listener listener(config);
+ * (void)listener.start();
+ *
+ * // Client side
+ * shm_client client;
+ * if (client.connect("/run/database_server/gateway-shm.sock").is_ok()) {
+ *     (void)client.send(request_bytes);
+ *     auto response = client.receive(std::chrono::milliseconds(1000));
+ * }
+ * @endcode
+ */
+
+#pragma once
+
+#include "session_transport.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace database_server::gateway
+{
+
+namespace transport_detail
+{
+class shm_channel;
+class frame_decoder;
+} // namespace transport_detail
+
+/**
+ * @struct shm_transport_config
+ * @brief Configuration for the shared-memory transport listener
+ */
+struct shm_transport_config
+{
+	std::string path;                              ///< Handshake socket file path
+	uint32_t permissions = 0660;                   ///< Handshake socket file mode
+	uint32_t max_connections = 256;                ///< Maximum concurrent clients
+	size_t ring_capacity = 1024 * 1024;            ///< Bytes per ring (rounded up to a power of two)
+	size_t max_frame_bytes = 16 * 1024 * 1024;     ///< Maximum message size (16MB)
+	uint32_t send_timeout_ms = 5000;               ///< Max wait for ring space
+	uint32_t spin_iterations = 2000;               ///< Polls of an idle ring before sleeping
+};
+
+class shm_session;
+
+/**
+ * @class shm_transport_listener
+ * @brief Accepts shared-memory clients and polls their request rings
+ */
+class shm_transport_listener : public transport_listener
+{
+public:
+	/**
+	 * @brief Constructs a listener with configuration
+	 * @param config Listener configuration
+	 */
+	explicit shm_transport_listener(const shm_transport_config& config);
+
+	~shm_transport_listener() override;
+
+	// Non-copyable, non-movable
+	shm_transport_listener(const shm_transport_listener&) = delete;
+	shm_transport_listener& operator=(const shm_transport_listener&) = delete;
+	shm_transport_listener(shm_transport_listener&&) = delete;
+	shm_transport_listener& operator=(shm_transport_listener&&) = delete;
+
+	/**
+	 * @brief Bind the handshake socket and start the I/O thread
+	 */
+	[[nodiscard]] kcenon::common::VoidResult start() override;
+
+	/**
+	 * @brief Close all sessions, stop the I/O thread and remove the socket file
+	 */
+	void stop() override;
+
+	[[nodiscard]] bool is_running() const noexcept override;
+
+	[[nodiscard]] size_t connection_count() const override;
+
+	[[nodiscard]] std::string_view transport_name() const override;
+
+	/**
+	 * @brief Get the handshake socket (sessions themselves cannot be handed off)
+	 */
+	[[nodiscard]] int listen_fd() const noexcept override;
+
+	bool adopt_listen_fd(int fd) override;
+
+	void stop_accepting() override;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const shm_transport_config& config() const noexcept;
+
+private:
+	void io_loop();
+	bool poll_rings(const std::vector<std::shared_ptr<shm_session>>& sessions);
+	void service_sockets(const std::vector<std::shared_ptr<shm_session>>& sessions,
+						 int timeout_ms);
+	void accept_clients();
+	void drop_client(int fd);
+	void wake();
+
+private:
+	shm_transport_config config_;
+
+	int listen_fd_ = -1;
+	int wake_fds_[2] = {-1, -1};
+	std::thread io_thread_;
+	std::atomic<bool> running_{false};
+	std::atomic<bool> accepting_{true};
+	std::atomic<bool> owns_path_{true}; ///< Cleared once the socket file was handed off
+	uint64_t next_id_ = 0;
+
+	mutable std::mutex sessions_mutex_;
+	std::unordered_map<int, std::shared_ptr<shm_session>> sessions_;
+	bool sessions_changed_ = false; ///< I/O thread only: snapshot must be refreshed
+};
+
+/**
+ * @struct shm_client_config
+ * @brief Configuration for a shared-memory transport client
+ */
+struct shm_client_config
+{
+	uint32_t connect_timeout_ms = 5000;            ///< Max wait for the handshake
+	uint32_t send_timeout_ms = 5000;               ///< Max wait for ring space
+	size_t max_frame_bytes = 16 * 1024 * 1024;     ///< Maximum message size (16MB)
+	uint32_t spin_iterations = 2000;               ///< Polls of an idle ring before sleeping
+};
+
+/**
+ * @class shm_client
+ * @brief Client endpoint of the shared-memory transport
+ *
+ * Sends serialized query_request bytes and receives serialized
+ * query_response (or pushed event) bytes, exactly as a TCP client would.
+ */
+class shm_client
+{
+public:
+	explicit shm_client(shm_client_config config = {});
+	~shm_client();
+
+	shm_client(const shm_client&) = delete;
+	shm_client& operator=(const shm_client&) = delete;
+
+	/**
+	 * @brief Connect to a listener and map its rings
+	 * @param path Handshake socket path
+	 */
+	[[nodiscard]] kcenon::common::VoidResult connect(const std::string& path);
+
+	/**
+	 * @brief Close the connection and unmap the rings
+	 */
+	void disconnect();
+
+	/**
+	 * @brief Check whether the connection is open
+	 */
+	[[nodiscard]] bool is_connected() const noexcept;
+
+	/**
+	 * @brief Send one message
+	 * @param data Message payload
+	 */
+	[[nodiscard]] kcenon::common::VoidResult send(const std::vector<uint8_t>& data);
+
+	/**
+	 * @brief Receive one message
+	 * @param timeout Maximum time to wait
+	 * @return Message payload, or error on timeout or disconnection
+	 */
+	[[nodiscard]] kcenon::common::Result<std::vector<uint8_t>>
+	receive(std::chrono::milliseconds timeout);
+
+private:
+	shm_client_config config_;
+	std::unique_ptr<transport_detail::shm_channel> channel_;
+	std::unique_ptr<transport_detail::frame_decoder> decoder_;
+	std::deque<std::vector<uint8_t>> pending_;
+	std::atomic<bool> connected_{false};
+};
+
+} // namespace database_server::gateway
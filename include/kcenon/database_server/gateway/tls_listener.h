@@ -0,0 +1,255 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file tls_listener.h
+ * @brief TLS-terminating TCP transport for the gateway
+ *
+ * Serves the gateway's TCP port over TLS (1.2 or later) using OpenSSL.
+ * Each connection runs the TLS state machine over in-memory BIOs, so
+ * encryption and decryption are timed apart from socket I/O, and the
+ * decrypted stream uses the same 4-byte big-endian length framing as the
+ * other transports. A connection is presented to the gateway only after
+ * its handshake completes.
+ *
+ * Session resumption:
+ * - Session tickets (RFC 5077 / TLS 1.3 PSK) are issued by default. The
+ *   ticket keys are generated when the listener starts, so tickets stay
+ *   valid until the process restarts.
+ * - With tickets disabled, sessions are kept in a server-side cache of
+ *   session_cache_size entries instead.
+ * Either way, a reconnecting client that presents its previous session
+ * skips the certificate exchange of a full handshake. TLS 1.2 resumption
+ * also skips the key exchange; TLS 1.3 keeps an ephemeral key exchange for
+ * forward secrecy, so there the saving is mainly the certificate signature
+ * and its verification by the client.
+ *
+ * The listening socket can be handed to another process for a
+ * zero-downtime restart (see listener_handoff.h). Established connections
+ * cannot: their TLS state lives in this process, so they drain instead.
+ *
+ * Requires a build with DATABASE_SERVER_HAS_TLS (OpenSSL found at
+ * configure time); start() returns an error otherwise.
+ *
+ * ## Thread Safety
+ * start() and stop() must not be called concurrently. Callbacks are invoked
+ * from the single I/O thread; session send() may be called from any thread.
+ * get_stats() may be called from any thread.
+ *
+ * @code
+ * tls_config config;
+ * config.port = 5432;
+ * config.cert_file = "/etc/database_server/server.crt";
+ * config.key_file = "/etc/database_server/server.key";
+ *
+ * tls_listener listener(config);
+ * listener.set_receive_callback([](std::string_view id, const std::vector<uint8_t>& data) {
+ *     // Handle message
+ * });
+ * (void)listener.start();
+ *
+ * auto stats = listener.get_stats();
+ * double resumed = stats.resumption_ratio(); // percent of handshakes resumed
+ * @endcode
+ */
+
+#pragma once
+
+#include "session_transport.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace database_server::gateway
+{
+
+namespace transport_detail
+{
+struct tls_state;
+} // namespace transport_detail
+
+/**
+ * @struct tls_config
+ * @brief Configuration for the TLS listener
+ */
+struct tls_config
+{
+	std::string host = "0.0.0.0";                  ///< Bind address (IPv4 or IPv6 literal)
+	uint16_t port = 5432;                          ///< TCP port (0 = ephemeral)
+	std::string cert_file;                         ///< PEM certificate chain
+	std::string key_file;                          ///< PEM private key
+	uint32_t max_connections = 1000;               ///< Maximum concurrent connections
+	size_t max_frame_bytes = 16 * 1024 * 1024;     ///< Maximum message size (16MB)
+	uint32_t send_timeout_ms = 5000;               ///< Max wait for a full socket buffer
+	uint32_t handshake_timeout_ms = 10000;         ///< Drop clients that do not finish the handshake
+	bool enable_session_tickets = true;            ///< Stateless resumption via tickets
+	uint32_t session_cache_size = 20480;           ///< Server-side sessions (tickets disabled)
+	uint32_t session_lifetime_s = 7200;            ///< Lifetime of tickets and cached sessions
+};
+
+/**
+ * @struct tls_stats
+ * @brief Handshake and record-layer counters of the TLS listener
+ */
+struct tls_stats
+{
+	uint64_t full_handshakes = 0;      ///< Handshakes with certificate and key exchange
+	uint64_t resumed_handshakes = 0;   ///< Handshakes that resumed a previous session
+	uint64_t failed_handshakes = 0;    ///< Handshakes that failed or timed out
+	uint64_t full_handshake_us = 0;    ///< CPU time spent in full handshakes
+	uint64_t resumed_handshake_us = 0; ///< CPU time spent in resumed handshakes
+	double handshakes_per_second = 0.0; ///< Completed handshakes during the last second
+	uint64_t bytes_encrypted = 0;      ///< Plaintext bytes sent
+	uint64_t bytes_decrypted = 0;      ///< Plaintext bytes received
+	uint64_t record_crypto_ns = 0;     ///< Time spent encrypting and decrypting records
+
+	/**
+	 * @brief Percentage of completed handshakes that were resumed
+	 */
+	[[nodiscard]] double resumption_ratio() const noexcept;
+
+	/**
+	 * @brief Average CPU time of a full handshake in microseconds
+	 */
+	[[nodiscard]] double average_full_handshake_us() const noexcept;
+
+	/**
+	 * @brief Average CPU time of a resumed handshake in microseconds
+	 */
+	[[nodiscard]] double average_resumed_handshake_us() const noexcept;
+
+	/**
+	 * @brief Record-layer cost in nanoseconds per plaintext byte
+	 */
+	[[nodiscard]] double crypto_ns_per_byte() const noexcept;
+};
+
+class tls_session;
+
+/**
+ * @class tls_listener
+ * @brief Poll-based TCP listener that terminates TLS
+ */
+class tls_listener : public transport_listener
+{
+public:
+	/**
+	 * @brief Constructs a listener with configuration
+	 * @param config Listener configuration
+	 */
+	explicit tls_listener(const tls_config& config);
+
+	~tls_listener() override;
+
+	// Non-copyable, non-movable
+	tls_listener(const tls_listener&) = delete;
+	tls_listener& operator=(const tls_listener&) = delete;
+	tls_listener(tls_listener&&) = delete;
+	tls_listener& operator=(tls_listener&&) = delete;
+
+	/**
+	 * @brief Load the certificate and key, bind the port and start the I/O thread
+	 */
+	[[nodiscard]] kcenon::common::VoidResult start() override;
+
+	/**
+	 * @brief Close all connections and stop the I/O thread
+	 */
+	void stop() override;
+
+	[[nodiscard]] bool is_running() const noexcept override;
+
+	/**
+	 * @brief Number of open connections, including those still in the handshake
+	 */
+	[[nodiscard]] size_t connection_count() const override;
+
+	[[nodiscard]] std::string_view transport_name() const override;
+
+	[[nodiscard]] int listen_fd() const noexcept override;
+
+	bool adopt_listen_fd(int fd) override;
+
+	void stop_accepting() override;
+
+	/**
+	 * @brief Get the bound port (useful when configured with port 0)
+	 */
+	[[nodiscard]] uint16_t bound_port() const noexcept;
+
+	/**
+	 * @brief Get a snapshot of the handshake and record-layer counters
+	 */
+	[[nodiscard]] tls_stats get_stats() const;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const tls_config& config() const noexcept;
+
+	/**
+	 * @brief Check whether this build includes TLS support
+	 */
+	[[nodiscard]] static bool is_available() noexcept;
+
+private:
+	void io_loop();
+	void accept_clients();
+	void read_client(const std::shared_ptr<tls_session>& session);
+	void drop_client(int fd);
+	void expire_handshakes();
+	void wake();
+
+private:
+	tls_config config_;
+
+	int listen_fd_ = -1;
+	uint16_t bound_port_ = 0;
+	int wake_fds_[2] = {-1, -1};
+	std::thread io_thread_;
+	std::atomic<bool> running_{false};
+	std::atomic<bool> accepting_{true};
+	uint64_t next_id_ = 0;
+
+	// TLS context and counters, shared with sessions (which may outlive the listener)
+	std::shared_ptr<transport_detail::tls_state> state_;
+
+	mutable std::mutex sessions_mutex_;
+	std::unordered_map<int, std::shared_ptr<tls_session>> sessions_;
+};
+
+} // namespace database_server::gateway
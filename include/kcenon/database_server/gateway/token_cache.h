@@ -0,0 +1,214 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file token_cache.h
+ * @brief Cache of validated authentication tokens and revocation list
+ *
+ * With auth_config::validate_on_each_request, or a validator that checks
+ * signatures or asks a remote service, every request would pay for a full
+ * validation. token_cache remembers successful validations so a token is
+ * validated once and then accepted from memory until:
+ * - its expiry minus the refresh window, so tokens due for refresh go
+ *   back to the validator on every use; the expiry is the earlier of the
+ *   presented expires_at and auth_result::expires_at from the validator, or
+ * - ttl_ms after validation for tokens without an expiry.
+ *
+ * Failures are not cached, so a validator that starts accepting a token
+ * (for instance after a key rotation) is consulted again.
+ *
+ * ## Revocation
+ * Revocations are kept apart from the cached results, so they hold
+ * whether or not the token is cached (or caching is disabled with a
+ * capacity of 0):
+ * - A revoked token is rejected without consulting the validator until the
+ *   expiry it was cached with, or for revocation_ttl_ms if that is unknown.
+ *   At most revocation_capacity tokens are revoked at once.
+ * - A revoked client has its cached tokens dropped, and any of its tokens
+ *   issued before the revocation (or with an unknown issue time, see
+ *   auth_result::issued_at) is rejected for revocation_ttl_ms, which must
+ *   cover the longest token lifetime. Callers check validator results with
+ *   revoked() before accepting them.
+ *
+ * Entries are keyed by the SHA-256 digest of the token, so bearer tokens
+ * are not kept in memory, and also match the client_id and expires_at
+ * presented with it, since validators return results for the whole
+ * auth_token. They are spread over independently locked shards; when a
+ * shard is full, expired entries and then arbitrary ones are evicted.
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe. A validation that started before a
+ * revocation is not cached (see epoch()).
+ */
+
+#pragma once
+
+#include "auth_middleware.h"
+#include "hmac_sha2.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace database_server::gateway
+{
+
+/**
+ * @class token_cache
+ * @brief Sharded cache from token digest to successful auth_result
+ */
+class token_cache
+{
+public:
+	/**
+	 * @brief Construct a cache
+	 * @param capacity Maximum cached tokens (0 = revocations only)
+	 * @param ttl_ms Lifetime of entries for tokens without an expiry
+	 * @param refresh_window_ms Tokens this close to expiry are not served
+	 * @param revocation_ttl_ms Lifetime of client revocations and of token
+	 *        revocations without a known expiry
+	 * @param revocation_capacity Maximum revoked tokens
+	 */
+	token_cache(size_t capacity, uint32_t ttl_ms, uint32_t refresh_window_ms,
+				uint32_t revocation_ttl_ms = 86400000, size_t revocation_capacity = 65536);
+
+	~token_cache() = default;
+
+	// Non-copyable, non-movable
+	token_cache(const token_cache&) = delete;
+	token_cache& operator=(const token_cache&) = delete;
+	token_cache(token_cache&&) = delete;
+	token_cache& operator=(token_cache&&) = delete;
+
+	/**
+	 * @brief Look up a token
+	 * @param now_ms Current Unix epoch milliseconds
+	 * @return The cached result (a failure for revoked tokens), or nullopt
+	 *         if the validator must be consulted
+	 */
+	[[nodiscard]] std::optional<auth_result> find(const auth_token& token) const;
+	[[nodiscard]] std::optional<auth_result> find(const auth_token& token,
+												  uint64_t now_ms) const;
+
+	/**
+	 * @brief Check a validator's result against the revocations
+	 * @return true if the token or its client was revoked
+	 */
+	[[nodiscard]] bool revoked(const auth_token& token, const auth_result& result) const;
+	[[nodiscard]] bool revoked(const auth_token& token, const auth_result& result,
+							   uint64_t now_ms) const;
+
+	/**
+	 * @brief Revocation counter to read before validating a token
+	 */
+	[[nodiscard]] uint64_t epoch() const noexcept;
+
+	/**
+	 * @brief Cache a successful validation
+	 * @param epoch Value of epoch() read before the validation started; the
+	 *        result is dropped if a revocation happened since
+	 */
+	void insert(const auth_token& token, const auth_result& result, uint64_t epoch);
+	void insert(const auth_token& token, const auth_result& result, uint64_t epoch,
+				uint64_t now_ms);
+
+	/**
+	 * @brief Reject a token from now on
+	 * @return false if revocation_capacity tokens are already revoked
+	 */
+	bool revoke(const std::string& token);
+	bool revoke(const std::string& token, uint64_t now_ms);
+
+	/**
+	 * @brief Reject every token a client was issued until now
+	 * @return Number of cached tokens dropped
+	 */
+	size_t revoke_client(const std::string& client_id);
+	size_t revoke_client(const std::string& client_id, uint64_t now_ms);
+
+	/**
+	 * @brief Drop all entries and revocations
+	 */
+	void clear();
+
+	/**
+	 * @brief Number of entries, including revoked tokens
+	 */
+	[[nodiscard]] size_t size() const;
+
+private:
+	struct key_hash
+	{
+		size_t operator()(const sha256_digest& key) const noexcept;
+	};
+
+	struct entry
+	{
+		std::string client_id;       ///< Presented client_id
+		uint64_t expires_at = 0;     ///< Presented expires_at
+		uint64_t valid_until = 0;    ///< Entry lifetime (Unix epoch ms)
+		uint64_t accepted_until = 0; ///< Earliest known token expiry (0 = none)
+		auth_result result;
+	};
+
+	struct alignas(64) shard
+	{
+		mutable std::shared_mutex mutex;
+		std::unordered_map<sha256_digest, entry, key_hash> entries;
+		std::unordered_map<sha256_digest, uint64_t, key_hash> revoked; ///< Digest to end of revocation
+	};
+
+	static constexpr size_t shard_count = 16;
+
+	[[nodiscard]] shard& shard_for(const sha256_digest& key) const noexcept;
+	[[nodiscard]] bool client_revoked(const std::string& client_id, uint64_t issued_at,
+									  uint64_t now_ms) const;
+	void make_room(shard& target, uint64_t now_ms);
+
+private:
+	size_t shard_capacity_;
+	uint32_t ttl_ms_;
+	uint32_t refresh_window_ms_;
+	uint32_t revocation_ttl_ms_;
+	size_t shard_revocation_capacity_;
+	std::atomic<uint64_t> epoch_{0};
+	mutable std::array<shard, shard_count> shards_;
+
+	mutable std::shared_mutex clients_mutex_;
+	std::unordered_map<std::string, uint64_t> revoked_clients_; ///< Client to revocation time
+	std::atomic<size_t> revoked_client_count_{0};                ///< Skips the lock while empty
+};
+
+} // namespace database_server::gateway
@@ -0,0 +1,190 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file unix_socket_listener.h
+ * @brief Unix domain socket listener for co-located gateway clients
+ *
+ * Clients running on the same host as the gateway can connect through a
+ * Unix domain socket instead of TCP loopback. Connections are presented to
+ * the gateway as session_transport instances, so they share the session
+ * model, authentication and request pipeline with TCP clients.
+ *
+ * Wire format: every message is preceded by a 4-byte big-endian length.
+ * The payload is the same serialized query_request / query_response used
+ * over TCP.
+ *
+ * Peer credentials (pid, uid, gid) are read from the kernel when a client
+ * connects and are available through session_transport::peer().
+ *
+ * For zero-downtime restarts the listening socket can be handed to another
+ * process (listen_fd() / adopt_listen_fd()), and idle connections can be
+ * detached and adopted by it (release_idle_connections() /
+ * adopt_connection()); see listener_handoff.h.
+ *
+ * Not available on Windows; start() returns an error there.
+ *
+ * ## Thread Safety
+ * start() and stop() must not be called concurrently. Callbacks are invoked
+ * from a single I/O thread; session send() may be called from any thread.
+ *
+ * @code
+ * unix_socket_config config;
+ * config.path = "/run/database_server/gateway.sock";
+ *
+ * unix_socket_listener listener(config);
+ * listener.set_receive_callback([](std::string_view id, const std::vector<uint8_t>& data) {
+ *     // Handle message
+ * });
+ * (void)listener.start();
+ * @endcode
+ */
+
+#pragma once
+
+#include "session_transport.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace database_server::gateway
+{
+
+/**
+ * @struct unix_socket_config
+ * @brief Configuration for the Unix domain socket listener
+ */
+struct unix_socket_config
+{
+	std::string path;                              ///< Socket file path
+	uint32_t permissions = 0660;                   ///< Socket file mode
+	uint32_t max_connections = 1000;               ///< Maximum concurrent connections
+	size_t max_frame_bytes = 16 * 1024 * 1024;     ///< Maximum message size (16MB)
+	uint32_t send_timeout_ms = 5000;               ///< Max wait for a full socket buffer
+	size_t max_read_bytes = 256 * 1024;            ///< Bytes read from one client per poll round
+};
+
+class unix_socket_session;
+
+/**
+ * @class unix_socket_listener
+ * @brief Poll-based Unix domain socket listener
+ */
+class unix_socket_listener : public transport_listener
+{
+public:
+	/**
+	 * @brief Constructs a listener with configuration
+	 * @param config Listener configuration
+	 */
+	explicit unix_socket_listener(const unix_socket_config& config);
+
+	~unix_socket_listener() override;
+
+	// Non-copyable, non-movable
+	unix_socket_listener(const unix_socket_listener&) = delete;
+	unix_socket_listener& operator=(const unix_socket_listener&) = delete;
+	unix_socket_listener(unix_socket_listener&&) = delete;
+	unix_socket_listener& operator=(unix_socket_listener&&) = delete;
+
+	/**
+	 * @brief Bind the socket file and start the I/O thread
+	 *
+	 * A stale socket file left by a previous run is replaced; any other
+	 * kind of file at the path is an error.
+	 */
+	[[nodiscard]] kcenon::common::VoidResult start() override;
+
+	/**
+	 * @brief Close all connections, stop the I/O thread and remove the socket file
+	 */
+	void stop() override;
+
+	[[nodiscard]] bool is_running() const noexcept override;
+
+	[[nodiscard]] size_t connection_count() const override;
+
+	[[nodiscard]] std::string_view transport_name() const override;
+
+	[[nodiscard]] int listen_fd() const noexcept override;
+
+	bool adopt_listen_fd(int fd) override;
+
+	void stop_accepting() override;
+
+	[[nodiscard]] std::vector<int> release_idle_connections(
+		const std::function<bool(std::string_view transport_id)>& eligible) override;
+
+	[[nodiscard]] kcenon::common::VoidResult adopt_connection(int fd) override;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const unix_socket_config& config() const noexcept;
+
+private:
+	void io_loop();
+	void accept_clients();
+	void add_client(int fd);
+	void read_client(const std::shared_ptr<unix_socket_session>& session);
+	void drop_client(int fd);
+	bool post(std::function<void()> task);
+	void run_tasks();
+	void wake();
+
+private:
+	unix_socket_config config_;
+
+	int listen_fd_ = -1;
+	int wake_fds_[2] = {-1, -1};
+	std::thread io_thread_;
+	std::atomic<bool> running_{false};
+	std::atomic<bool> accepting_{true};
+	std::atomic<bool> owns_path_{true}; ///< Cleared once the socket file was handed off
+	uint64_t next_id_ = 0;
+
+	std::mutex tasks_mutex_;
+	std::vector<std::function<void()>> tasks_; ///< Run on the I/O thread
+	bool tasks_open_ = false;
+
+	mutable std::mutex sessions_mutex_;
+	std::unordered_map<int, std::shared_ptr<unix_socket_session>> sessions_;
+};
+
+} // namespace database_server::gateway
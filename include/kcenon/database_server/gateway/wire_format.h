@@ -0,0 +1,244 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file wire_format.h
+ * @brief Compact binary wire protocol (v2)
+ *
+ * Version 1 messages are value_container documents in which every field,
+ * column and cell is stored under a generated string key
+ * (`row_12_cell_3_value_string`), so the keys of a large result outweigh
+ * its data. Version 2 encodes the same messages directly into a byte
+ * buffer:
+ *
+ * @code
+ * frame    := magic "DBW2" | kind u8 | flags u8 | body
+ * header   := message_id varint | timestamp varint | correlation_id string
+ * string   := length varint | bytes
+ * value    := value_type_tag u8 | payload (bool u8, int64 zigzag varint,
+ *             double 8 bytes little-endian, string/bytes, blob_ref string)
+ * row      := byte length varint | cell count varint | value...
+ * @endcode
+ *
+ * Request and response bodies list the struct fields in declaration order
+ * (see wire_v2_serializer.cpp). Unsigned integers are LEB128 varints.
+ *
+ * ## Columnar Results
+ * With wire_flag_columnar set in a response frame, the rows section is
+ * laid out by column instead (see columnar_codec.h): per-column arrays
+ * with a null bitmap, dictionary-encoded low-cardinality strings and
+ * fixed-width frame-of-reference or delta-encoded integers. Decoders
+ * rebuild the same result_row vector from either layout. The gateway
+ * uses it when the request sets query_options::columnar or the result
+ * has at least gateway_config::columnar_min_rows rows.
+ *
+ * ## Batches
+ * A batch frame carries several independent requests (or their responses)
+ * in one network message:
+ *
+ * @code
+ * batch    := magic "DBW2" | kind u8 (3 or 4) | flags u8 | count varint
+ *             | (frame length varint | request or response frame)...
+ * @endcode
+ *
+ * The gateway answers a request batch with a response batch holding one
+ * response per request, in request order. The requests share the
+ * transport only: each succeeds or fails on its own and they run
+ * concurrently unless wire_flag_sequential is set.
+ *
+ * ## Events
+ * Invalidation events pushed to subscribed sessions use their own kind:
+ *
+ * @code
+ * event    := magic "DBW2" | kind u8 (5) | flags u8 (0) | header
+ *             | sequence varint | tables (count varint | string...)
+ *             | cache_keys (count varint | string...) | resync u8
+ * @endcode
+ *
+ * ## Negotiation
+ * A client opts in by sending v2 frames. query_request::deserialize() and
+ * query_response::deserialize() (and invalidation_event::deserialize())
+ * recognise the magic and decode either version; decoded messages carry
+ * header.version = 2, and the gateway answers and notifies each session
+ * in the version of its latest request.
+ *
+ * ## Thread Safety
+ * Encoding and decoding functions are stateless and may be called
+ * concurrently.
+ */
+
+#pragma once
+
+#include "query_protocol.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <kcenon/common/patterns/result.h>
+
+namespace database_server::gateway
+{
+
+/// message_header::version of value_container messages
+inline constexpr uint32_t wire_version_v1 = 1;
+
+/// message_header::version of compact binary messages
+inline constexpr uint32_t wire_version_v2 = 2;
+
+/// First bytes of every v2 frame
+inline constexpr std::array<uint8_t, 4> wire_v2_magic = { 'D', 'B', 'W', '2' };
+
+/// Size of the fixed v2 frame header (magic, kind, flags)
+inline constexpr size_t wire_v2_header_size = 6;
+
+/// Response frame flag: rows are laid out by column
+inline constexpr uint8_t wire_flag_columnar = 0x01;
+
+/// Request batch flag: execute the requests one after another, in order
+inline constexpr uint8_t wire_flag_sequential = 0x01;
+
+/**
+ * @enum wire_row_layout
+ * @brief How a response frame lays out its result rows
+ */
+enum class wire_row_layout : uint8_t
+{
+	rows,    ///< Row by row (length-prefixed rows of tagged cells)
+	columnar ///< Column by column (falls back to rows for ragged results)
+};
+
+/**
+ * @enum wire_message_kind
+ * @brief Message carried by a v2 frame
+ */
+enum class wire_message_kind : uint8_t
+{
+	request = 1,
+	response = 2,
+	request_batch = 3,
+	response_batch = 4,
+	event = 5
+};
+
+/**
+ * @struct wire_batch
+ * @brief Frames of a batch, referring into the decoded buffer
+ */
+struct wire_batch
+{
+	wire_message_kind kind = wire_message_kind::request_batch;
+	uint8_t flags = 0;
+	std::vector<std::span<const uint8_t>> frames; ///< Complete v2 frames
+};
+
+/**
+ * @brief Check whether a buffer starts with a v2 frame header
+ */
+[[nodiscard]] bool is_wire_v2(std::span<const uint8_t> data) noexcept;
+
+/**
+ * @brief Kind of a v2 frame, or nullopt if data does not start with one
+ */
+[[nodiscard]] std::optional<wire_message_kind> wire_v2_kind(std::span<const uint8_t> data) noexcept;
+
+/**
+ * @brief Encode a request as a v2 frame
+ */
+[[nodiscard]] std::vector<uint8_t> encode_wire_v2(const query_request& request);
+
+/**
+ * @brief Encode a response as a v2 frame
+ */
+[[nodiscard]] std::vector<uint8_t> encode_wire_v2(const query_response& response);
+
+/**
+ * @brief Append a response v2 frame to a buffer (reuses its capacity)
+ */
+void encode_wire_v2(const query_response& response, std::vector<uint8_t>& out,
+					wire_row_layout layout = wire_row_layout::rows);
+
+/**
+ * @brief Encode an invalidation event as a v2 frame
+ */
+[[nodiscard]] std::vector<uint8_t> encode_wire_v2(const invalidation_event& event);
+
+/**
+ * @brief Wrap encoded v2 frames in a batch frame
+ * @param kind request_batch or response_batch
+ * @param frames Frames of the matching single kind
+ */
+[[nodiscard]] std::vector<uint8_t> encode_wire_v2_batch(
+	wire_message_kind kind, std::span<const std::vector<uint8_t>> frames, uint8_t flags = 0);
+
+/**
+ * @brief Encode requests as one request batch frame
+ * @param sequential Ask the server to execute them in order
+ */
+[[nodiscard]] std::vector<uint8_t> encode_request_batch_v2(
+	std::span<const query_request> requests, bool sequential = false);
+
+/**
+ * @brief Split a batch frame into its frames (which are not decoded)
+ */
+[[nodiscard]] kcenon::common::Result<wire_batch> decode_wire_v2_batch(
+	std::span<const uint8_t> data);
+
+/**
+ * @brief Decode every response of a response batch frame
+ */
+[[nodiscard]] kcenon::common::Result<std::vector<query_response>> decode_response_batch_v2(
+	std::span<const uint8_t> data);
+
+/**
+ * @brief Decode a v2 request frame
+ * @return Request with header.version = 2, or error if the frame is malformed
+ */
+[[nodiscard]] kcenon::common::Result<query_request> decode_request_v2(
+	std::span<const uint8_t> data);
+
+/**
+ * @brief Decode a v2 response frame
+ * @return Response with header.version = 2, or error if the frame is malformed
+ */
+[[nodiscard]] kcenon::common::Result<query_response> decode_response_v2(
+	std::span<const uint8_t> data);
+
+/**
+ * @brief Decode a v2 event frame
+ * @return Event with header.version = 2, or error if the frame is malformed
+ */
+[[nodiscard]] kcenon::common::Result<invalidation_event> decode_event_v2(
+	std::span<const uint8_t> data);
+
+} // namespace database_server::gateway
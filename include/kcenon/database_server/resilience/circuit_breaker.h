@@ -0,0 +1,294 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file circuit_breaker.h
+ * @brief Fail-fast protection for a database backend
+ *
+ * While a database is unreachable every request still waits for its
+ * connection acquisition or query to time out, holding a worker thread
+ * and a client socket for the whole timeout. circuit_breaker watches the
+ * outcome and latency of the calls made to one backend and, once too many
+ * of them fail or are slow, opens: calls are then rejected immediately
+ * without touching the backend. After open_duration_ms it lets a few
+ * probe calls through (half-open); if they all succeed the breaker
+ * closes, and the first failure opens it again.
+ *
+ * Failures and slow calls are counted in a rolling window of
+ * window_buckets buckets spanning window_ms, and the breaker only trips
+ * once the window holds at least min_calls calls. Every admitted call
+ * carries a circuit_permit that must be passed back to record(); results
+ * of calls admitted before the last transition are ignored, so a slow
+ * call from before an outage cannot close a half-open breaker.
+ *
+ * ## Thread Safety
+ * All public methods are thread-safe. Rejecting a call while open reads
+ * two atomics; recording takes a short lock.
+ *
+ * @code
+ * using namespace database_server::resilience;
+ *
+ * circuit_breaker breaker(config);
+ *
+ * auto permit = breaker.admit();
+ * if (!permit.admitted) {
+ *     return error("Database unavailable");
+ * }
+ * auto started = std::chrono::steady_clock::now();
+ * auto result = backend->select_query(sql);
+ * breaker.record(permit, result.is_ok(), std::chrono::steady_clock::now() - started);
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace database_server::resilience
+{
+
+/**
+ * @struct circuit_breaker_config
+ * @brief Configuration for fail-fast protection of a backend
+ */
+struct circuit_breaker_config
+{
+	bool enabled = false;             ///< Reject calls while the backend is failing
+	uint32_t window_ms = 10000;       ///< Span of the rolling outcome window
+	uint32_t window_buckets = 10;     ///< Granularity of the window
+	uint32_t min_calls = 20;          ///< Calls in the window before the breaker may open
+	double failure_ratio = 0.5;       ///< Share of failed calls that opens the breaker
+	uint32_t slow_call_ms = 0;        ///< Calls at least this slow count as slow (0 = off)
+	double slow_call_ratio = 0.8;     ///< Share of slow calls that opens the breaker
+	uint32_t open_duration_ms = 5000; ///< Time calls are rejected before probing
+	uint32_t half_open_probes = 3;    ///< Probes admitted at once; all must succeed to close
+};
+
+/**
+ * @enum circuit_state
+ * @brief State of a circuit breaker
+ */
+enum class circuit_state : uint8_t
+{
+	closed = 0,   ///< Calls pass, outcomes are counted
+	open = 1,     ///< Calls are rejected
+	half_open = 2 ///< A limited number of probe calls pass
+};
+
+/**
+ * @brief Converts circuit_state enum to string representation.
+ * @param state The circuit state to convert.
+ * @return String representation of the circuit state.
+ */
+constexpr const char* to_string(circuit_state state) noexcept
+{
+	switch (state)
+	{
+	case circuit_state::closed:
+		return "closed";
+	case circuit_state::open:
+		return "open";
+	case circuit_state::half_open:
+		return "half_open";
+	default:
+		return "unknown";
+	}
+}
+
+/**
+ * @enum call_failure
+ * @brief Why a call to a backend did not succeed
+ */
+enum class call_failure : uint8_t
+{
+	none = 0,              ///< The call succeeded
+	query_error = 1,       ///< The database ran the query and rejected it
+	connection_failed = 2, ///< The database could not be reached or the connection broke
+	no_connection = 3,     ///< No connection to the database was available
+	timeout = 4            ///< The database did not answer in time
+};
+
+/**
+ * @brief Whether a failure means the backend itself is unavailable
+ *
+ * Only these count against a circuit breaker or trigger reconnection;
+ * errors a reachable database reports for a client's query (syntax errors,
+ * constraint violations) do neither.
+ *
+ * @param failure Classified outcome of the call
+ * @return true for connection_failed, no_connection and timeout
+ */
+constexpr bool is_backend_failure(call_failure failure) noexcept
+{
+	return failure == call_failure::connection_failed
+		   || failure == call_failure::no_connection || failure == call_failure::timeout;
+}
+
+/**
+ * @struct circuit_permit
+ * @brief Admission decision for one call, passed back to record()
+ */
+struct circuit_permit
+{
+	bool admitted = false;   ///< Whether the call may proceed
+	bool probe = false;      ///< Admitted as a half-open probe
+	uint64_t generation = 0; ///< Breaker transition the call was admitted under
+};
+
+/**
+ * @struct circuit_breaker_metrics
+ * @brief Statistics and state transitions of a circuit breaker
+ */
+struct circuit_breaker_metrics
+{
+	std::atomic<uint64_t> admitted{0};    ///< Calls let through
+	std::atomic<uint64_t> rejected{0};    ///< Calls failed fast
+	std::atomic<uint64_t> successes{0};   ///< Calls recorded as successful
+	std::atomic<uint64_t> failures{0};    ///< Calls recorded as failed
+	std::atomic<uint64_t> slow_calls{0};  ///< Calls recorded as slow
+	std::atomic<uint64_t> opened{0};      ///< Transitions into open
+	std::atomic<uint64_t> half_opened{0}; ///< Transitions into half-open
+	std::atomic<uint64_t> closed{0};      ///< Transitions from half-open into closed
+
+	/**
+	 * @brief Reset all metrics counters
+	 */
+	void reset() noexcept
+	{
+		admitted.store(0);
+		rejected.store(0);
+		successes.store(0);
+		failures.store(0);
+		slow_calls.store(0);
+		opened.store(0);
+		half_opened.store(0);
+		closed.store(0);
+	}
+};
+
+/**
+ * @class circuit_breaker
+ * @brief Closed/open/half-open breaker driven by error rate and latency
+ */
+class circuit_breaker
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	/**
+	 * @brief Constructs a breaker with configuration
+	 * @param config Thresholds, window and open duration
+	 */
+	explicit circuit_breaker(const circuit_breaker_config& config = circuit_breaker_config{});
+
+	~circuit_breaker() = default;
+
+	// Non-copyable, non-movable
+	circuit_breaker(const circuit_breaker&) = delete;
+	circuit_breaker& operator=(const circuit_breaker&) = delete;
+	circuit_breaker(circuit_breaker&&) = delete;
+	circuit_breaker& operator=(circuit_breaker&&) = delete;
+
+	/**
+	 * @brief Decide whether a call may reach the backend
+	 * @return Permit to pass to record(); not admitted while open or while
+	 *         all half-open probes are in flight. Always admitted when the
+	 *         breaker is disabled.
+	 */
+	[[nodiscard]] circuit_permit admit();
+	[[nodiscard]] circuit_permit admit(clock::time_point now);
+
+	/**
+	 * @brief Record the outcome of an admitted call
+	 * @param permit Permit returned by admit()
+	 * @param success Whether the backend served the call
+	 * @param latency How long the call took
+	 */
+	void record(const circuit_permit& permit, bool success, clock::duration latency);
+	void record(const circuit_permit& permit, bool success, clock::duration latency,
+				clock::time_point now);
+
+	/**
+	 * @brief Return an admitted call that never reached the backend
+	 */
+	void cancel(const circuit_permit& permit);
+
+	/**
+	 * @brief Current state
+	 */
+	[[nodiscard]] circuit_state state() const noexcept;
+
+	/**
+	 * @brief Get breaker metrics
+	 */
+	[[nodiscard]] const circuit_breaker_metrics& metrics() const noexcept;
+
+	/**
+	 * @brief Get configuration
+	 */
+	[[nodiscard]] const circuit_breaker_config& config() const noexcept;
+
+private:
+	struct bucket
+	{
+		int64_t index = -1; ///< Window slot (time / bucket span) the counts belong to
+		uint32_t calls = 0;
+		uint32_t failures = 0;
+		uint32_t slow = 0;
+	};
+
+	static int64_t to_ns(clock::time_point time) noexcept;
+	void open_locked(int64_t now);
+	void transition_locked(circuit_state next);
+	[[nodiscard]] bool should_open_locked(int64_t now) const;
+
+private:
+	circuit_breaker_config config_;
+	int64_t bucket_ns_;
+	int64_t open_ns_;
+	clock::duration slow_threshold_;
+	circuit_breaker_metrics metrics_;
+
+	std::atomic<circuit_state> state_{circuit_state::closed};
+	std::atomic<int64_t> open_until_{0};  ///< End of the open period (clock ns)
+	std::atomic<uint64_t> generation_{0}; ///< Incremented on every transition
+
+	mutable std::mutex mutex_;
+	std::vector<bucket> buckets_;
+	uint32_t probes_in_flight_ = 0;
+	uint32_t probe_successes_ = 0;
+};
+
+} // namespace database_server::resilience
@@ -200,6 +200,15 @@ public:
 	 */
 	[[nodiscard]] bool is_healthy() const noexcept;
 
+	/**
+	 * @brief Check whether the latest heartbeat failed
+	 * @return true if the last check_now() found the backend unreachable
+	 *
+	 * Reads the cached outcome of the background heartbeat; no query is
+	 * run. Query errors recorded with record_failure() do not change it.
+	 */
+	[[nodiscard]] bool heartbeat_failed() const noexcept;
+
 	/**
 	 * @brief Get current health score (0-100)
 	 * @return Health score
@@ -260,6 +269,7 @@ private:
 	std::atomic<uint64_t> failed_queries_{ 0 };
 	std::atomic<uint32_t> consecutive_failures_{ 0 };
 	std::atomic<uint32_t> consecutive_successes_{ 0 };
+	std::atomic<bool> heartbeat_failed_{ false };
 
 	// Latency tracking (moving average, last 10 samples)
 	std::vector<std::chrono::milliseconds> latency_history_;
@@ -33,17 +33,20 @@
  * @file resilient_database_connection.h
  * @brief Resilient database connection with automatic reconnection
  *
- * Provides automatic reconnection with exponential backoff, connection
- * health monitoring, and self-healing capabilities. Integrates patterns
+ * Provides background reconnection with jittered exponential backoff,
+ * connection health monitoring, and self-healing capabilities. Integrates patterns
  * from network_system's resilient_client for robust database connectivity.
  */
 
 #pragma once
 
+#include "circuit_breaker.h"
 #include "connection_health_monitor.h"
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -70,6 +73,7 @@ struct reconnection_config
 	double backoff_multiplier{ 2.0 };
 	uint32_t max_retries{ 10 };
 	bool enable_auto_reconnect{ true };
+	double jitter{ 0.5 }; ///< Fraction of each delay randomised away (0 = none, 1 = full)
 };
 
 /**
@@ -114,10 +118,14 @@ constexpr const char* to_string(connection_state state) noexcept
  * @brief Database connection wrapper with automatic reconnection
  *
  * Wraps any database_backend implementation and adds:
- * - Automatic reconnection with exponential backoff
+ * - Automatic reconnection on a background task with jittered exponential
+ *   backoff; queries fail fast while it runs so the caller can move to
+ *   another pooled connection instead of waiting out the backoff
  * - Connection health monitoring with heartbeat
  * - Graceful degradation on connection failures
  * - Configurable retry policies
+ * - Optional circuit breaker, shared by the connections to one backend,
+ *   that fails queries immediately while the backend is down
  *
  * Design Pattern:
  * - Decorator pattern: Wraps database_backend interface
@@ -128,6 +136,7 @@ constexpr const char* to_string(connection_state state) noexcept
  * - All public methods are thread-safe
  * - Internal state protected by mutex
  * - Atomic state tracking for lock-free reads
+ * - No lock is held while waiting between reconnection attempts
  *
  * Example Usage:
  * @code
@@ -140,27 +149,35 @@ constexpr const char* to_string(connection_state state) noexcept
  *   auto resilient = std::make_shared<resilient_database_connection>(
  *       std::move(backend), recon_config);
  *
- *   // Automatically reconnects on connection loss
+ *   // On connection loss this returns the error and reconnects in the background
  *   auto result = resilient->select_query("SELECT * FROM users");
  * @endcode
  */
+// Forward declaration for friend class
+class reconnect_job;
+
 class resilient_database_connection : public database::core::database_backend
 {
+	friend class reconnect_job;
+
 public:
 	/**
 	 * @brief Construct resilient connection wrapper
 	 * @param backend Underlying database backend to wrap
 	 * @param config Reconnection configuration
 	 * @param executor Optional executor for background tasks (health monitoring, etc.)
+	 * @param breaker Optional circuit breaker; while it is open queries fail
+	 *        without reaching the backend or attempting to reconnect
 	 */
 	explicit resilient_database_connection(
 		std::unique_ptr<database::core::database_backend> backend,
 		reconnection_config config = reconnection_config{},
-		std::shared_ptr<kcenon::common::interfaces::IExecutor> executor = nullptr);
+		std::shared_ptr<kcenon::common::interfaces::IExecutor> executor = nullptr,
+		std::shared_ptr<circuit_breaker> breaker = nullptr);
 
 	~resilient_database_connection() override;
 
-	// Disable copy and move (due to mutex and monitoring thread)
+	// Disable copy and move (due to mutex and background tasks)
 	resilient_database_connection(const resilient_database_connection&) = delete;
 	resilient_database_connection& operator=(const resilient_database_connection&)
 		= delete;
@@ -269,7 +286,11 @@ public:
 	[[nodiscard]] std::map<std::string, std::string> connection_info() const override;
 
 	/**
-	 * @brief Ensure connection is established (with retry)
+	 * @brief Ensure connection is established
+	 *
+	 * Never blocks on reconnection: when the connection is down this starts
+	 * the background reconnection task (if not already running) and fails.
+	 *
 	 * @return result<void>::ok() if connected, error otherwise
 	 */
 	kcenon::common::VoidResult ensure_connected();
@@ -303,12 +324,30 @@ public:
 	 */
 	[[nodiscard]] uint32_t get_retry_count() const noexcept;
 
+	/**
+	 * @brief Get the circuit breaker
+	 * @return Breaker passed at construction, or nullptr
+	 */
+	[[nodiscard]] std::shared_ptr<circuit_breaker> get_circuit_breaker() const noexcept;
+
 private:
 	/**
-	 * @brief Attempt to reconnect with exponential backoff
-	 * @return result<void>::ok() on successful reconnection
+	 * @brief Start the background reconnection task unless one is running
+	 * @return result<void>::ok() if a task is running, error if reconnection
+	 *         is disabled, the connection is shut down or retries are exhausted
+	 */
+	kcenon::common::VoidResult schedule_reconnect();
+
+	/**
+	 * @brief Background reconnection loop (runs in separate thread)
+	 * @param generation Task generation; the loop exits once it is superseded
 	 */
-	kcenon::common::VoidResult attempt_reconnect();
+	void reconnect_loop(uint64_t generation);
+
+	/**
+	 * @brief Stop the reconnection task and wait for it to exit
+	 */
+	void stop_reconnect();
 
 	/**
 	 * @brief Execute query operation with automatic retry
@@ -319,8 +358,24 @@ private:
 	template <typename Func>
 	auto execute_with_retry(Func&& operation) -> decltype(operation());
 
+	/**
+	 * @brief Classify a failed operation
+	 *
+	 * The connection is treated as lost if the backend reports itself
+	 * uninitialized or the health monitor's last heartbeat failed;
+	 * otherwise the error is the query's own. No heartbeat is run on the
+	 * caller's thread.
+	 *
+	 * @return query_error or connection_failed
+	 */
+	[[nodiscard]] call_failure classify_failure();
+
 	/**
 	 * @brief Calculate next retry delay using exponential backoff
+	 *
+	 * The delay is drawn uniformly from [(1 - jitter) * d, d] so connections
+	 * that failed together do not reconnect in lockstep.
+	 *
 	 * @return Delay duration for next retry
 	 */
 	[[nodiscard]] std::chrono::milliseconds calculate_next_delay();
@@ -341,6 +396,7 @@ private:
 	reconnection_config config_;
 	std::shared_ptr<kcenon::common::interfaces::IExecutor> executor_;
 	std::unique_ptr<connection_health_monitor> health_monitor_;
+	std::shared_ptr<circuit_breaker> breaker_;
 
 	database::core::connection_config connection_config_;
 	std::atomic<connection_state> state_{ connection_state::disconnected };
@@ -349,6 +405,13 @@ private:
 
 	mutable std::mutex mutex_;
 	std::string last_error_message_;
+
+	// Background reconnection
+	std::mutex reconnect_mutex_;           ///< Guards reconnect_future_ and the backoff wait
+	std::condition_variable reconnect_cv_; ///< Wakes the backoff wait on shutdown
+	std::future<void> reconnect_future_;
+	bool reconnect_stopped_{ false };      ///< Set by shutdown, cleared by initialize
+	uint64_t reconnect_generation_{ 0 };   ///< Bumped for every task started
 };
 
 } // namespace database_server::resilience
@@ -32,12 +32,17 @@
 #include <kcenon/database_server/server_app.h>
 
 #include <kcenon/database_server/gateway/gateway_server.h>
+#include <kcenon/database_server/gateway/jwt_validator.h>
+#include <kcenon/database_server/gateway/query_cache.h>
 #include <kcenon/database_server/gateway/query_router.h>
 #include <kcenon/database_server/logging/console_logger.h>
 #include <kcenon/database_server/pooling/connection_pool.h>
 
 #include <chrono>
 #include <csignal>
+#include <fstream>
+#include <iterator>
+#include <optional>
 #include <sstream>
 #include <thread>
 
@@ -145,6 +150,23 @@ bool server_app::do_initialize()
 	router_cfg.default_timeout_ms = config_.network.connection_timeout_ms;
 	router_cfg.max_concurrent_queries = config_.network.max_connections;
 	router_cfg.enable_metrics = true;
+	router_cfg.admission.enabled = config_.network.load_shedding;
+	router_cfg.admission.target_delay_us = config_.network.shed_target_delay_us;
+	router_cfg.admission.interval_us = config_.network.shed_interval_us;
+	router_cfg.client_quotas.enabled = config_.network.client_max_queries > 0
+									   || config_.network.client_max_connections > 0;
+	router_cfg.client_quotas.max_in_flight_queries = config_.network.client_max_queries;
+	router_cfg.client_quotas.max_held_connections = config_.network.client_max_connections;
+	router_cfg.client_quotas.queue_timeout_ms = config_.network.client_quota_queue_ms;
+	router_cfg.cost_limits.enabled = config_.network.client_cost_per_second > 0;
+	router_cfg.cost_limits.units_per_second = config_.network.client_cost_per_second;
+	router_cfg.cost_limits.burst_units = config_.network.client_cost_burst > 0
+											 ? config_.network.client_cost_burst
+											 : 2.0 * config_.network.client_cost_per_second;
+	router_cfg.circuit_breaker.enabled = config_.pool.circuit_breaker;
+	router_cfg.circuit_breaker.failure_ratio = config_.pool.breaker_failure_percent / 100.0;
+	router_cfg.circuit_breaker.slow_call_ms = config_.pool.breaker_slow_ms;
+	router_cfg.circuit_breaker.open_duration_ms = config_.pool.breaker_open_ms;
 
 	query_router_ = std::make_unique<gateway::query_router>(router_cfg);
 
@@ -157,9 +179,85 @@ bool server_app::do_initialize()
 	gw_config.port = config_.network.port;
 	gw_config.max_connections = config_.network.max_connections;
 	gw_config.idle_timeout_ms = config_.network.connection_timeout_ms;
+	gw_config.tcp_transport = config_.network.transport == "io_uring"
+								  ? gateway::tcp_transport_type::io_uring
+								  : gateway::tcp_transport_type::network_system;
+	gw_config.enable_tls = config_.network.enable_tls;
+	gw_config.tls_cert_file = config_.network.cert_file;
+	gw_config.tls_key_file = config_.network.key_file;
+	gw_config.unix_socket_path = config_.network.unix_socket_path;
+	gw_config.unix_socket_permissions = config_.network.unix_socket_permissions;
+	gw_config.shm_socket_path = config_.network.shm_socket_path;
+	gw_config.handoff_socket_path = config_.network.handoff_socket_path;
+	gw_config.takeover = config_.network.takeover;
+	gw_config.auth.trusted_peer_uids = config_.network.unix_socket_trusted_uids;
+	gw_config.dispatch_admission = router_cfg.admission;
+	gw_config.columnar_min_rows = config_.network.columnar_min_rows;
+	gw_config.max_batch_requests = config_.network.max_batch_requests;
+	gw_config.batch_concurrency = config_.network.batch_concurrency;
+	gw_config.memory.budget_bytes = config_.memory.budget_mb * 1024 * 1024;
+	gw_config.memory.pressure_ratio = config_.memory.pressure_percent / 100.0;
+	gw_config.memory.large_query_rows = config_.memory.large_query_rows;
 
 	gateway_ = std::make_unique<gateway::gateway_server>(gw_config);
 
+	// Check token signatures and claims instead of only the token's expiry
+	if (!config_.auth.jwt_secret_file.empty())
+	{
+		std::ifstream secret_file(config_.auth.jwt_secret_file, std::ios::binary);
+		std::string secret((std::istreambuf_iterator<char>(secret_file)),
+						   std::istreambuf_iterator<char>());
+
+		// The line break an editor leaves at the end is not part of the key
+		while (!secret.empty() && (secret.back() == '\n' || secret.back() == '\r'))
+		{
+			secret.pop_back();
+		}
+		if (secret.empty())
+		{
+			logger_->log(kcenon::common::interfaces::log_level::error,
+						 "JWT secret file is empty or unreadable: "
+							 + config_.auth.jwt_secret_file);
+			return false;
+		}
+
+		gateway::jwt_config jwt_cfg;
+		jwt_cfg.issuer = config_.auth.jwt_issuer;
+		jwt_cfg.audience = config_.auth.jwt_audience;
+		jwt_cfg.leeway_ms = config_.auth.jwt_leeway_ms;
+
+		auto validator = std::make_shared<gateway::jwt_validator>(jwt_cfg);
+		validator->add_key({ config_.auth.jwt_key_id,
+							 config_.auth.jwt_algorithm == "HS512"
+								 ? gateway::jwt_algorithm::hs512
+								 : gateway::jwt_algorithm::hs256,
+							 std::move(secret) });
+		gateway_->set_token_validator(std::move(validator));
+	}
+
+	// Attach the query cache. Write handlers invalidate it even when result
+	// caching is disabled, so sessions subscribed to invalidation events are
+	// notified either way.
+	gateway::cache_config cache_cfg;
+	cache_cfg.enabled = config_.cache.enabled;
+	cache_cfg.max_entries = config_.cache.max_entries;
+	cache_cfg.ttl_seconds = config_.cache.ttl_seconds;
+	cache_cfg.max_result_size_bytes = config_.cache.max_result_size_bytes;
+	cache_cfg.enable_lru = config_.cache.enable_lru;
+
+	auto cache = std::make_shared<gateway::query_cache>(cache_cfg);
+	cache->set_memory_governor(gateway_->get_memory_governor());
+	cache->set_invalidation_listener(
+		[this](const std::string& table_name, const std::vector<std::string>& cache_keys)
+		{
+			// An empty table with no keys (cache cleared) is published as a resync
+			if (gateway_)
+			{
+				gateway_->get_invalidation_broadcaster().publish(table_name, cache_keys);
+			}
+		});
+	query_router_->set_query_cache(std::move(cache));
+
 	// Set up connection callbacks for logging
 	gateway_->set_connection_callback(
 		[this](const gateway::client_session& session)
@@ -180,10 +278,12 @@ bool server_app::do_initialize()
 		[this](const gateway::client_session& session, const gateway::query_request& request)
 			-> gateway::query_response
 		{
-			(void)session; // Session info available for future enhancements (logging, rate limiting)
+			// Unauthenticated sessions are charged to their own quota
+			const auto& client_id
+				= session.client_id.empty() ? session.session_id : session.client_id;
 
 			// Execute query through query router
-			auto result = query_router_->execute(request);
+			auto result = query_router_->execute(request, client_id);
 			if (result.is_ok())
 			{
 				return std::move(result.value());
@@ -202,9 +302,35 @@ bool server_app::do_initialize()
 	logger_->log(kcenon::common::interfaces::log_level::info, init_msg.str());
 
 	std::ostringstream addr_msg;
-	addr_msg << "  Listen address: " << config_.network.host << ":" << config_.network.port;
+	addr_msg << "  Listen address: " << config_.network.host << ":" << config_.network.port
+			 << " (" << (config_.network.enable_tls ? "tls" : config_.network.transport) << ")";
 	logger_->log(kcenon::common::interfaces::log_level::info, addr_msg.str());
 
+	if (!config_.network.unix_socket_path.empty())
+	{
+		logger_->log(kcenon::common::interfaces::log_level::info,
+					 "  Unix socket: " + config_.network.unix_socket_path);
+	}
+
+	if (!config_.network.shm_socket_path.empty())
+	{
+		logger_->log(kcenon::common::interfaces::log_level::info,
+					 "  Shared-memory transport: " + config_.network.shm_socket_path);
+	}
+
+	if (!config_.auth.jwt_secret_file.empty())
+	{
+		logger_->log(kcenon::common::interfaces::log_level::info,
+					 "  Token verification: JWT " + config_.auth.jwt_algorithm);
+	}
+
+	if (!config_.network.handoff_socket_path.empty())
+	{
+		logger_->log(kcenon::common::interfaces::log_level::info,
+					 std::string("  Handoff socket: ") + config_.network.handoff_socket_path
+						 + (config_.network.takeover ? " (taking over)" : ""));
+	}
+
 	return true;
 }
 
@@ -244,10 +370,28 @@ int server_app::run()
 	logger_->log(kcenon::common::interfaces::log_level::info,
 				 std::string("Server is running. Press Ctrl+C to stop."));
 
-	// Main event loop - wait for shutdown signal
+	// Main event loop - wait for shutdown signal, or for the remaining
+	// clients to leave after a successor took over the sockets
+	std::optional<std::chrono::steady_clock::time_point> drain_deadline;
 	while (state_ == server_state::running)
 	{
 		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+		if (gateway_ && gateway_->is_draining())
+		{
+			auto now = std::chrono::steady_clock::now();
+			if (!drain_deadline)
+			{
+				drain_deadline = now + std::chrono::milliseconds(config_.network.drain_timeout_ms);
+				logger_->log(kcenon::common::interfaces::log_level::info,
+							 "Sockets handed over to the new server; draining "
+								 + std::to_string(gateway_->connection_count()) + " connections");
+			}
+			if (gateway_->connection_count() == 0 || now >= *drain_deadline)
+			{
+				stop();
+			}
+		}
 	}
 
 	state_ = server_state::stopped;
@@ -327,6 +471,13 @@ void server_app::set_executor(
 	{
 		query_router_->set_executor(executor_);
 	}
+
+	// Requests and token verification for new sessions run on the same executor
+	if (gateway_ && executor_)
+	{
+		gateway_->set_executor(executor_);
+		gateway_->get_auth_middleware().set_executor(executor_);
+	}
 }
 
 std::shared_ptr<kcenon::common::interfaces::ILogger> server_app::get_logger() const
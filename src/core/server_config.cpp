@@ -117,6 +117,91 @@ std::optional<server_config> server_config::load_from_file(const std::string& pa
 		{
 			config.network.connection_timeout_ms = static_cast<uint32_t>(std::stoul(value));
 		}
+		else if (key == "network.transport")
+		{
+			config.network.transport = value;
+		}
+		else if (key == "network.unix_socket_path")
+		{
+			config.network.unix_socket_path = value;
+		}
+		else if (key == "network.unix_socket_permissions")
+		{
+			config.network.unix_socket_permissions
+				= static_cast<uint32_t>(std::stoul(value, nullptr, 8));
+		}
+		else if (key == "network.shm_socket_path")
+		{
+			config.network.shm_socket_path = value;
+		}
+		else if (key == "network.handoff_socket_path")
+		{
+			config.network.handoff_socket_path = value;
+		}
+		else if (key == "network.drain_timeout_ms")
+		{
+			config.network.drain_timeout_ms = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.load_shedding")
+		{
+			config.network.load_shedding = (value == "true" || value == "1");
+		}
+		else if (key == "network.shed_target_delay_us")
+		{
+			config.network.shed_target_delay_us = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.shed_interval_us")
+		{
+			config.network.shed_interval_us = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.client_max_queries")
+		{
+			config.network.client_max_queries = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.client_max_connections")
+		{
+			config.network.client_max_connections = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.client_quota_queue_ms")
+		{
+			config.network.client_quota_queue_ms = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.client_cost_per_second")
+		{
+			config.network.client_cost_per_second = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.client_cost_burst")
+		{
+			config.network.client_cost_burst = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.columnar_min_rows")
+		{
+			config.network.columnar_min_rows = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.max_batch_requests")
+		{
+			config.network.max_batch_requests = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.batch_concurrency")
+		{
+			config.network.batch_concurrency = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "network.unix_socket_trusted_uids")
+		{
+			// Comma-separated list of user IDs
+			config.network.unix_socket_trusted_uids.clear();
+			std::stringstream uids(value);
+			std::string uid;
+			while (std::getline(uids, uid, ','))
+			{
+				trim(uid);
+				if (!uid.empty())
+				{
+					config.network.unix_socket_trusted_uids.push_back(
+						static_cast<uint32_t>(std::stoul(uid)));
+				}
+			}
+		}
 		else if (key == "logging.level")
 		{
 			config.logging.level = value;
@@ -145,6 +230,78 @@ std::optional<server_config> server_config::load_from_file(const std::string& pa
 		{
 			config.pool.health_check_interval_ms = static_cast<uint32_t>(std::stoul(value));
 		}
+		else if (key == "pool.circuit_breaker")
+		{
+			config.pool.circuit_breaker = (value == "true" || value == "1");
+		}
+		else if (key == "pool.breaker_failure_percent")
+		{
+			config.pool.breaker_failure_percent = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "pool.breaker_slow_ms")
+		{
+			config.pool.breaker_slow_ms = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "pool.breaker_open_ms")
+		{
+			config.pool.breaker_open_ms = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "cache.enabled")
+		{
+			config.cache.enabled = (value == "true" || value == "1");
+		}
+		else if (key == "cache.max_entries")
+		{
+			config.cache.max_entries = static_cast<size_t>(std::stoull(value));
+		}
+		else if (key == "cache.ttl_seconds")
+		{
+			config.cache.ttl_seconds = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "cache.max_result_size_bytes")
+		{
+			config.cache.max_result_size_bytes = static_cast<size_t>(std::stoull(value));
+		}
+		else if (key == "cache.enable_lru")
+		{
+			config.cache.enable_lru = (value == "true" || value == "1");
+		}
+		else if (key == "memory.budget_mb")
+		{
+			config.memory.budget_mb = static_cast<size_t>(std::stoull(value));
+		}
+		else if (key == "memory.pressure_percent")
+		{
+			config.memory.pressure_percent = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "memory.large_query_rows")
+		{
+			config.memory.large_query_rows = static_cast<uint32_t>(std::stoul(value));
+		}
+		else if (key == "auth.jwt_secret_file")
+		{
+			config.auth.jwt_secret_file = value;
+		}
+		else if (key == "auth.jwt_algorithm")
+		{
+			config.auth.jwt_algorithm = value;
+		}
+		else if (key == "auth.jwt_key_id")
+		{
+			config.auth.jwt_key_id = value;
+		}
+		else if (key == "auth.jwt_issuer")
+		{
+			config.auth.jwt_issuer = value;
+		}
+		else if (key == "auth.jwt_audience")
+		{
+			config.auth.jwt_audience = value;
+		}
+		else if (key == "auth.jwt_leeway_ms")
+		{
+			config.auth.jwt_leeway_ms = static_cast<uint32_t>(std::stoul(value));
+		}
 	}
 
 	return config;
@@ -202,6 +359,16 @@ std::vector<std::string> server_config::validation_errors() const
 		{
 			errors.push_back("TLS key file not found: " + network.key_file);
 		}
+
+		if (network.transport == "io_uring")
+		{
+			errors.push_back("TLS is not supported with the io_uring transport");
+		}
+	}
+
+	if (network.transport != "network_system" && network.transport != "io_uring")
+	{
+		errors.push_back("Unknown network transport: " + network.transport);
 	}
 
 	if (network.max_connections == 0)
@@ -209,12 +376,61 @@ std::vector<std::string> server_config::validation_errors() const
 		errors.push_back("Maximum connections must be greater than 0");
 	}
 
+	if (network.unix_socket_permissions > 0777)
+	{
+		errors.push_back("Unix socket permissions must be an octal file mode (e.g. 660)");
+	}
+
+	// The network_system server owns its socket internally
+	if ((!network.handoff_socket_path.empty() || network.takeover) && !network.enable_tls
+		&& network.transport == "network_system")
+	{
+		errors.push_back("Socket handoff requires the io_uring transport or TLS");
+	}
+
+	if (network.takeover && network.handoff_socket_path.empty())
+	{
+		errors.push_back("Takeover requested but no handoff socket path configured");
+	}
+
+	if (network.load_shedding && network.shed_interval_us <= network.shed_target_delay_us)
+	{
+		errors.push_back("Load shedding interval must be longer than the target delay");
+	}
+
+	if (network.client_max_queries > network.max_connections)
+	{
+		errors.push_back("Per-client query quota cannot exceed the connection limit");
+	}
+
+	if (memory.pressure_percent == 0 || memory.pressure_percent > 100)
+	{
+		errors.push_back("Memory pressure percent must be between 1 and 100");
+	}
+
+	if (!auth.jwt_secret_file.empty() && !std::filesystem::exists(auth.jwt_secret_file))
+	{
+		errors.push_back("JWT secret file not found: " + auth.jwt_secret_file);
+	}
+
+	if (auth.jwt_algorithm != "HS256" && auth.jwt_algorithm != "HS512")
+	{
+		errors.push_back("Invalid JWT algorithm: " + auth.jwt_algorithm
+						 + " (valid: HS256, HS512)");
+	}
+
 	// Validate pool configuration
 	if (pool.min_connections > pool.max_connections)
 	{
 		errors.push_back("Pool minimum connections cannot exceed maximum connections");
 	}
 
+	if (pool.circuit_breaker
+		&& (pool.breaker_failure_percent == 0 || pool.breaker_failure_percent > 100))
+	{
+		errors.push_back("Circuit breaker failure percent must be between 1 and 100");
+	}
+
 	// Validate logging configuration
 	if (logging.level != "debug" && logging.level != "info" && logging.level != "warn"
 		&& logging.level != "error")
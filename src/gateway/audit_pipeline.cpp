@@ -0,0 +1,262 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file audit_pipeline.cpp
+ * @brief Implementation of asynchronous audit event delivery
+ */
+
+#include <kcenon/database_server/gateway/audit_pipeline.h>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+
+namespace database_server::gateway
+{
+
+audit_pipeline::audit_pipeline(const audit_config& config)
+	: config_(config)
+{
+	size_t capacity = std::bit_ceil(std::max<size_t>(config_.queue_capacity, 2));
+	cells_ = std::make_unique<cell[]>(capacity);
+	mask_ = capacity - 1;
+	for (size_t i = 0; i < capacity; ++i)
+	{
+		cells_[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	config_.max_batch = std::max<size_t>(config_.max_batch, 1);
+	config_.sample_rate = std::max<uint32_t>(config_.sample_rate, 1);
+
+	consumer_ = std::thread([this] { run(); });
+}
+
+audit_pipeline::~audit_pipeline()
+{
+	stop();
+}
+
+void audit_pipeline::set_callback(audit_callback_t callback)
+{
+	std::lock_guard<std::mutex> lock(callback_mutex_);
+	callback_ = std::move(callback);
+	has_sink_.store(callback_ || batch_callback_, std::memory_order_relaxed);
+}
+
+void audit_pipeline::set_batch_callback(audit_batch_callback_t callback)
+{
+	std::lock_guard<std::mutex> lock(callback_mutex_);
+	batch_callback_ = std::move(callback);
+	has_sink_.store(callback_ || batch_callback_, std::memory_order_relaxed);
+}
+
+bool audit_pipeline::has_sink() const noexcept
+{
+	return has_sink_.load(std::memory_order_relaxed);
+}
+
+bool audit_pipeline::publish(auth_event event)
+{
+	while (!try_push(event))
+	{
+		bool keep = config_.overflow == audit_overflow_policy::drop_oldest
+					|| overflows_.fetch_add(1, std::memory_order_relaxed) % config_.sample_rate
+						   == 0;
+		if (!keep)
+		{
+			metrics_.dropped_sampled.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+
+		// Make room; the consumer may have done so meanwhile
+		auth_event evicted;
+		if (try_pop(evicted))
+		{
+			metrics_.dropped_oldest.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	metrics_.published.fetch_add(1, std::memory_order_relaxed);
+	signal_.fetch_add(1, std::memory_order_release);
+	signal_.notify_one();
+	return true;
+}
+
+void audit_pipeline::flush()
+{
+	while (!stopping_.load(std::memory_order_acquire)
+		   && metrics_.delivered.load(std::memory_order_acquire)
+					  + metrics_.dropped_oldest.load(std::memory_order_acquire)
+				  < metrics_.published.load(std::memory_order_acquire))
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+void audit_pipeline::stop()
+{
+	if (stopping_.exchange(true, std::memory_order_acq_rel))
+	{
+		return;
+	}
+
+	signal_.fetch_add(1, std::memory_order_release);
+	signal_.notify_one();
+	if (consumer_.joinable())
+	{
+		consumer_.join();
+	}
+}
+
+size_t audit_pipeline::capacity() const noexcept
+{
+	return mask_ + 1;
+}
+
+const audit_metrics& audit_pipeline::metrics() const noexcept
+{
+	return metrics_;
+}
+
+bool audit_pipeline::try_push(auth_event& event)
+{
+	size_t pos = tail_.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		auto& target = cells_[pos & mask_];
+		size_t sequence = target.sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+		if (diff == 0)
+		{
+			if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				target.event = std::move(event);
+				target.sequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false; // Full
+		}
+		else
+		{
+			pos = tail_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+bool audit_pipeline::try_pop(auth_event& event)
+{
+	size_t pos = head_.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		auto& target = cells_[pos & mask_];
+		size_t sequence = target.sequence.load(std::memory_order_acquire);
+		auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+		if (diff == 0)
+		{
+			if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				event = std::move(target.event);
+				target.sequence.store(pos + mask_ + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false; // Empty
+		}
+		else
+		{
+			pos = head_.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+void audit_pipeline::deliver(const std::vector<auth_event>& batch)
+{
+	// Callbacks are only ever invoked from this thread, so holding the
+	// mutex keeps a replaced callback from running after set_*() returned
+	std::lock_guard<std::mutex> lock(callback_mutex_);
+	if (batch_callback_)
+	{
+		batch_callback_(batch);
+	}
+	else if (callback_)
+	{
+		for (const auto& event : batch)
+		{
+			callback_(event);
+		}
+	}
+}
+
+void audit_pipeline::run()
+{
+	std::vector<auth_event> batch;
+	batch.reserve(config_.max_batch);
+
+	for (;;)
+	{
+		auto seen = signal_.load(std::memory_order_acquire);
+
+		auth_event event;
+		while (batch.size() < config_.max_batch && try_pop(event))
+		{
+			batch.push_back(std::move(event));
+		}
+
+		if (!batch.empty())
+		{
+			try
+			{
+				deliver(batch);
+			}
+			catch (...)
+			{
+				// A failing sink must not stop the delivery of later events
+			}
+			metrics_.batches.fetch_add(1, std::memory_order_relaxed);
+			metrics_.delivered.fetch_add(batch.size(), std::memory_order_release);
+			batch.clear();
+			continue;
+		}
+
+		if (stopping_.load(std::memory_order_acquire))
+		{
+			return;
+		}
+		signal_.wait(seen, std::memory_order_acquire);
+	}
+}
+
+} // namespace database_server::gateway
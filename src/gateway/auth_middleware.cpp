@@ -30,6 +30,8 @@
 // POSSIBILITY OF SUCH DAMAGE.
 
 #include <kcenon/database_server/gateway/auth_middleware.h>
+#include <kcenon/database_server/gateway/audit_pipeline.h>
+#include <kcenon/database_server/gateway/token_cache.h>
 
 #include <algorithm>
 
@@ -103,6 +105,26 @@ auth_result simple_token_validator::validate(const auth_token& token)
 rate_limiter::rate_limiter(const rate_limit_config& config)
 	: config_(config)
 {
+	if (config_.enabled && config_.algorithm == rate_limit_algorithm::shared_gcra)
+	{
+		auto opened = shared_gcra_limiter::open(
+			config_.shared_segment_name, config_.requests_per_second, config_.burst_size,
+			config_.block_duration_ms, config_.shared_segment_slots);
+		if (opened.is_ok())
+		{
+			shared_ = opened.value();
+		}
+		else
+		{
+			shared_error_ = opened.error().message;
+		}
+	}
+	if (config_.algorithm == rate_limit_algorithm::gcra
+		|| (config_.algorithm == rate_limit_algorithm::shared_gcra && !shared_))
+	{
+		gcra_ = std::make_unique<gcra_limiter>(
+			config_.requests_per_second, config_.burst_size, config_.block_duration_ms);
+	}
 }
 
 bool rate_limiter::allow_request(const std::string& client_id)
@@ -111,6 +133,14 @@ bool rate_limiter::allow_request(const std::string& client_id)
 	{
 		return true;
 	}
+	if (shared_)
+	{
+		return shared_->allow_request(client_id);
+	}
+	if (gcra_)
+	{
+		return gcra_->allow_request(client_id);
+	}
 
 	std::lock_guard<std::mutex> lock(entries_mutex_);
 
@@ -156,6 +186,14 @@ uint32_t rate_limiter::remaining_requests(const std::string& client_id) const
 	{
 		return UINT32_MAX;
 	}
+	if (shared_)
+	{
+		return shared_->remaining_requests(client_id);
+	}
+	if (gcra_)
+	{
+		return gcra_->remaining_requests(client_id);
+	}
 
 	std::lock_guard<std::mutex> lock(entries_mutex_);
 
@@ -188,6 +226,14 @@ bool rate_limiter::is_blocked(const std::string& client_id) const
 	{
 		return false;
 	}
+	if (shared_)
+	{
+		return shared_->is_blocked(client_id);
+	}
+	if (gcra_)
+	{
+		return gcra_->is_blocked(client_id);
+	}
 
 	std::lock_guard<std::mutex> lock(entries_mutex_);
 
@@ -202,6 +248,15 @@ bool rate_limiter::is_blocked(const std::string& client_id) const
 
 uint64_t rate_limiter::block_expires_at(const std::string& client_id) const
 {
+	if (shared_)
+	{
+		return shared_->block_expires_at(client_id);
+	}
+	if (gcra_)
+	{
+		return gcra_->block_expires_at(client_id);
+	}
+
 	std::lock_guard<std::mutex> lock(entries_mutex_);
 
 	auto it = entries_.find(client_id);
@@ -221,12 +276,34 @@ uint64_t rate_limiter::block_expires_at(const std::string& client_id) const
 
 void rate_limiter::reset(const std::string& client_id)
 {
+	if (shared_)
+	{
+		shared_->reset(client_id);
+		return;
+	}
+	if (gcra_)
+	{
+		gcra_->reset(client_id);
+		return;
+	}
+
 	std::lock_guard<std::mutex> lock(entries_mutex_);
 	entries_.erase(client_id);
 }
 
 void rate_limiter::cleanup()
 {
+	// Shared cells are reused in place once their state expires
+	if (shared_)
+	{
+		return;
+	}
+	if (gcra_)
+	{
+		gcra_->cleanup();
+		return;
+	}
+
 	std::lock_guard<std::mutex> lock(entries_mutex_);
 
 	auto now = current_timestamp_ms();
@@ -258,6 +335,16 @@ const rate_limit_config& rate_limiter::config() const noexcept
 	return config_;
 }
 
+bool rate_limiter::is_shared() const noexcept
+{
+	return shared_ != nullptr;
+}
+
+const std::string& rate_limiter::shared_error() const noexcept
+{
+	return shared_error_;
+}
+
 // ============================================================================
 // auth_metrics
 // ============================================================================
@@ -295,6 +382,8 @@ void auth_metrics::reset() noexcept
 	invalid_tokens.store(0, std::memory_order_relaxed);
 	rate_limited_requests.store(0, std::memory_order_relaxed);
 	permission_denied.store(0, std::memory_order_relaxed);
+	token_cache_hits.store(0, std::memory_order_relaxed);
+	token_cache_misses.store(0, std::memory_order_relaxed);
 }
 
 // ============================================================================
@@ -303,9 +392,7 @@ void auth_metrics::reset() noexcept
 
 auth_middleware::auth_middleware(const auth_config& auth_config,
 								 const rate_limit_config& rate_config)
-	: auth_config_(auth_config)
-	, validator_(std::make_shared<simple_token_validator>())
-	, rate_limiter_(rate_config)
+	: auth_middleware(auth_config, rate_config, nullptr)
 {
 }
 
@@ -316,10 +403,66 @@ auth_middleware::auth_middleware(const auth_config& auth_config,
 	, validator_(validator ? std::move(validator) : std::make_shared<simple_token_validator>())
 	, rate_limiter_(rate_config)
 {
+	// Revocations are kept even when validations are not cached
+	token_cache_ = std::make_unique<token_cache>(
+		auth_config_.cache_validated_tokens ? auth_config_.token_cache_capacity : 0,
+		auth_config_.token_cache_ttl_ms, auth_config_.token_refresh_window_ms,
+		auth_config_.revocation_ttl_ms, auth_config_.revocation_capacity);
+	if (auth_config_.audit.asynchronous)
+	{
+		audit_pipeline_ = std::make_unique<audit_pipeline>(auth_config_.audit);
+	}
 }
 
+auth_middleware::~auth_middleware() = default;
+
 auth_result auth_middleware::authenticate(const std::string& session_id,
 										  const auth_token& token)
+{
+	return authenticate(session_id, token, verify(token));
+}
+
+auth_result auth_middleware::verify(const auth_token& token)
+{
+	if (!auth_config_.enabled)
+	{
+		auth_result result;
+		result.success = true;
+		result.client_id = token.client_id;
+		return result;
+	}
+
+	if (auto cached = token_cache_->find(token))
+	{
+		metrics_.token_cache_hits.fetch_add(1, std::memory_order_relaxed);
+		return std::move(*cached);
+	}
+
+	if (auth_config_.cache_validated_tokens)
+	{
+		metrics_.token_cache_misses.fetch_add(1, std::memory_order_relaxed);
+	}
+	auto epoch = token_cache_->epoch();
+	auto result = validator_->validate(token);
+
+	// The validator does not know about revoked tokens and clients
+	if (result.success && token_cache_->revoked(token, result))
+	{
+		auto client_id = std::move(result.client_id);
+		result = auth_result{};
+		result.code = status_code::authentication_failed;
+		result.message = "Token has been revoked";
+		result.client_id = std::move(client_id);
+		return result;
+	}
+
+	token_cache_->insert(token, result, epoch);
+	return result;
+}
+
+auth_result auth_middleware::authenticate(const std::string& session_id,
+										  const auth_token& token,
+										  auth_result verified)
 {
 	metrics_.total_auth_attempts.fetch_add(1, std::memory_order_relaxed);
 
@@ -333,8 +476,7 @@ auth_result auth_middleware::authenticate(const std::string& session_id,
 		return result;
 	}
 
-	auto result = validator_->validate(token);
-
+	auto result = std::move(verified);
 	if (result.success)
 	{
 		metrics_.successful_auths.fetch_add(1, std::memory_order_relaxed);
@@ -350,7 +492,9 @@ auth_result auth_middleware::authenticate(const std::string& session_id,
 	{
 		metrics_.failed_auths.fetch_add(1, std::memory_order_relaxed);
 
-		if (token.is_expired())
+		bool expired = token.is_expired()
+					   || (result.expires_at != 0 && result.expires_at <= current_timestamp_ms());
+		if (expired)
 		{
 			metrics_.expired_tokens.fetch_add(1, std::memory_order_relaxed);
 			emit_event(auth_event_type::token_expired, token.client_id, session_id,
@@ -367,6 +511,37 @@ auth_result auth_middleware::authenticate(const std::string& session_id,
 	return result;
 }
 
+auth_result auth_middleware::authenticate_peer(const std::string& session_id,
+											   const peer_credentials& peer)
+{
+	auth_result result;
+
+	const auto& trusted = auth_config_.trusted_peer_uids;
+	if (std::find(trusted.begin(), trusted.end(), peer.uid) == trusted.end())
+	{
+		result.code = status_code::authentication_failed;
+		result.message = "Peer credentials not trusted";
+		return result;
+	}
+
+	metrics_.total_auth_attempts.fetch_add(1, std::memory_order_relaxed);
+	metrics_.successful_auths.fetch_add(1, std::memory_order_relaxed);
+
+	result.success = true;
+	result.code = status_code::ok;
+	result.client_id = "uid:" + std::to_string(peer.uid);
+
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		session_client_map_[session_id] = result.client_id;
+	}
+
+	emit_event(auth_event_type::auth_success, result.client_id, session_id,
+			   "peer pid=" + std::to_string(peer.pid) + " gid=" + std::to_string(peer.gid));
+
+	return result;
+}
+
 bool auth_middleware::check_rate_limit(const std::string& client_id)
 {
 	bool allowed = rate_limiter_.allow_request(client_id);
@@ -398,6 +573,22 @@ auth_result auth_middleware::check(const std::string& session_id,
 	return authenticate(session_id, token);
 }
 
+auth_result auth_middleware::check(const std::string& session_id,
+								   const auth_token& token,
+								   auth_result verified)
+{
+	if (!check_rate_limit(token.client_id.empty() ? session_id : token.client_id))
+	{
+		auth_result result;
+		result.success = false;
+		result.code = status_code::rate_limited;
+		result.message = "Rate limit exceeded";
+		return result;
+	}
+
+	return authenticate(session_id, token, std::move(verified));
+}
+
 void auth_middleware::on_session_created(const std::string& session_id,
 										 const std::string& client_id)
 {
@@ -427,10 +618,72 @@ void auth_middleware::on_session_destroyed(const std::string& session_id)
 
 void auth_middleware::set_audit_callback(audit_callback_t callback)
 {
+	if (audit_pipeline_)
+	{
+		audit_pipeline_->set_callback(std::move(callback));
+		return;
+	}
 	std::lock_guard<std::mutex> lock(callback_mutex_);
 	audit_callback_ = std::move(callback);
 }
 
+void auth_middleware::set_audit_batch_callback(audit_batch_callback_t callback)
+{
+	if (audit_pipeline_)
+	{
+		audit_pipeline_->set_batch_callback(std::move(callback));
+		return;
+	}
+	std::lock_guard<std::mutex> lock(callback_mutex_);
+	audit_batch_callback_ = std::move(callback);
+}
+
+void auth_middleware::flush_audit_events()
+{
+	if (audit_pipeline_)
+	{
+		audit_pipeline_->flush();
+	}
+}
+
+const audit_pipeline* auth_middleware::get_audit_pipeline() const noexcept
+{
+	return audit_pipeline_.get();
+}
+
+bool auth_middleware::revoke_token(const std::string& token)
+{
+	return token_cache_->revoke(token);
+}
+
+size_t auth_middleware::revoke_client_tokens(const std::string& client_id)
+{
+	return token_cache_->revoke_client(client_id);
+}
+
+bool auth_middleware::needs_validation(const auth_token& token) const
+{
+	if (!auth_config_.enabled)
+	{
+		return false;
+	}
+	return !token_cache_->find(token).has_value();
+}
+
+void auth_middleware::set_executor(
+	std::shared_ptr<kcenon::common::interfaces::IExecutor> executor)
+{
+	std::lock_guard<std::mutex> lock(executor_mutex_);
+	executor_ = std::move(executor);
+}
+
+std::shared_ptr<kcenon::common::interfaces::IExecutor> auth_middleware::get_executor()
+	const noexcept
+{
+	std::lock_guard<std::mutex> lock(executor_mutex_);
+	return executor_;
+}
+
 const auth_metrics& auth_middleware::metrics() const noexcept
 {
 	return metrics_;
@@ -456,13 +709,12 @@ void auth_middleware::emit_event(auth_event_type type,
 								 const std::string& session_id,
 								 const std::string& details)
 {
-	audit_callback_t callback;
+	if (audit_pipeline_ && !audit_pipeline_->has_sink())
 	{
-		std::lock_guard<std::mutex> lock(callback_mutex_);
-		callback = audit_callback_;
+		return;
 	}
 
-	if (callback)
+	auto make_event = [&]
 	{
 		auth_event event;
 		event.type = type;
@@ -470,8 +722,31 @@ void auth_middleware::emit_event(auth_event_type type,
 		event.session_id = session_id;
 		event.details = details;
 		event.timestamp = current_timestamp_ms();
+		return event;
+	};
+
+	// Off the request path: the pipeline's thread delivers in batches
+	if (audit_pipeline_)
+	{
+		audit_pipeline_->publish(make_event());
+		return;
+	}
+
+	audit_callback_t callback;
+	audit_batch_callback_t batch_callback;
+	{
+		std::lock_guard<std::mutex> lock(callback_mutex_);
+		callback = audit_callback_;
+		batch_callback = audit_batch_callback_;
+	}
 
-		callback(event);
+	if (batch_callback)
+	{
+		batch_callback(std::vector<auth_event>{make_event()});
+	}
+	else if (callback)
+	{
+		callback(make_event());
 	}
 }
 
@@ -0,0 +1,554 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file blob_upload.cpp
+ * @brief Implementation of chunked binary uploads
+ */
+
+#include <kcenon/database_server/gateway/blob_upload.h>
+
+#include <algorithm>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <cstdlib>
+#include <unistd.h>
+#endif
+
+namespace database_server::gateway
+{
+
+namespace
+{
+
+constexpr uint64_t digest_multiplier = 0x9E3779B97F4A7C15ULL;
+
+uint64_t mix64(uint64_t value) noexcept
+{
+	value ^= value >> 30;
+	value *= 0xBF58476D1CE4E5B9ULL;
+	value ^= value >> 27;
+	value *= 0x94D049BB133111EBULL;
+	value ^= value >> 31;
+	return value;
+}
+
+uint64_t absorb(uint64_t state, uint64_t word) noexcept
+{
+	state ^= mix64(word);
+	state = (state << 27) | (state >> 37);
+	return state * digest_multiplier;
+}
+
+bool seek_to(std::FILE* file, uint64_t offset) noexcept
+{
+#if defined(_WIN32)
+	return ::_fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+	return ::fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+bool seek_to_end(std::FILE* file) noexcept
+{
+#if defined(_WIN32)
+	return ::_fseeki64(file, 0, SEEK_END) == 0;
+#else
+	return ::fseeko(file, 0, SEEK_END) == 0;
+#endif
+}
+
+std::string upload_label(const std::string& upload_id)
+{
+	return "Upload '" + upload_id + "'";
+}
+
+} // namespace
+
+// ============================================================================
+// spill_buffer
+// ============================================================================
+
+spill_buffer::spill_buffer(size_t memory_limit, std::string spill_directory)
+	: memory_limit_(memory_limit)
+	, spill_directory_(std::move(spill_directory))
+{
+}
+
+spill_buffer::~spill_buffer()
+{
+	if (file_)
+	{
+		std::fclose(file_);
+	}
+}
+
+kcenon::common::VoidResult spill_buffer::open_file()
+{
+#if !defined(_WIN32)
+	if (!spill_directory_.empty())
+	{
+		std::string path = spill_directory_ + "/dbgw_blob_XXXXXX";
+		int fd = ::mkstemp(path.data());
+		if (fd < 0)
+		{
+			return kcenon::common::error_info{
+				-2, "Failed to create spill file in " + spill_directory_, "spill_buffer"
+			};
+		}
+		// Unlinked right away: the file disappears with the buffer or the process
+		::unlink(path.c_str());
+		file_ = ::fdopen(fd, "w+b");
+		if (!file_)
+		{
+			::close(fd);
+		}
+	}
+	else
+#endif
+	{
+		file_ = std::tmpfile();
+	}
+
+	if (!file_)
+	{
+		return kcenon::common::error_info{ -2, "Failed to create spill file", "spill_buffer" };
+	}
+	return kcenon::common::ok();
+}
+
+kcenon::common::VoidResult spill_buffer::spill()
+{
+	if (file_)
+	{
+		return kcenon::common::ok();
+	}
+
+	auto opened = open_file();
+	if (opened.is_err())
+	{
+		return opened;
+	}
+
+	if (!memory_.empty() && std::fwrite(memory_.data(), 1, memory_.size(), file_) != memory_.size())
+	{
+		return kcenon::common::error_info{ -3, "Failed to write spill file", "spill_buffer" };
+	}
+
+	std::vector<uint8_t>().swap(memory_);
+	return kcenon::common::ok();
+}
+
+kcenon::common::VoidResult spill_buffer::append(const uint8_t* data, size_t size)
+{
+	if (size == 0)
+	{
+		return kcenon::common::ok();
+	}
+
+	if (!file_ && memory_.size() + size > memory_limit_)
+	{
+		auto spilled = spill();
+		if (spilled.is_err())
+		{
+			return spilled;
+		}
+	}
+
+	if (file_)
+	{
+		std::lock_guard<std::mutex> lock(file_mutex_);
+		if (!seek_to_end(file_) || std::fwrite(data, 1, size, file_) != size)
+		{
+			return kcenon::common::error_info{ -3, "Failed to write spill file", "spill_buffer" };
+		}
+	}
+	else
+	{
+		memory_.insert(memory_.end(), data, data + size);
+	}
+
+	update_digest(data, size);
+	size_ += size;
+	return kcenon::common::ok();
+}
+
+kcenon::common::Result<size_t> spill_buffer::read(uint64_t offset, uint8_t* out,
+												  size_t size) const
+{
+	if (offset >= size_)
+	{
+		return size_t{0};
+	}
+	size = static_cast<size_t>(std::min<uint64_t>(size, size_ - offset));
+
+	if (!file_)
+	{
+		std::memcpy(out, memory_.data() + offset, size);
+		return size;
+	}
+
+	std::lock_guard<std::mutex> lock(file_mutex_);
+	std::fflush(file_);
+	if (!seek_to(file_, offset) || std::fread(out, 1, size, file_) != size)
+	{
+		return kcenon::common::error_info{ -4, "Failed to read spill file", "spill_buffer" };
+	}
+	return size;
+}
+
+kcenon::common::Result<std::vector<uint8_t>> spill_buffer::read_all() const
+{
+	if (!file_)
+	{
+		return memory_;
+	}
+
+	std::vector<uint8_t> content(static_cast<size_t>(size_));
+	auto result = read(0, content.data(), content.size());
+	if (result.is_err())
+	{
+		return result.error();
+	}
+	return content;
+}
+
+void spill_buffer::update_digest(const uint8_t* data, size_t size) noexcept
+{
+	// Complete a word started by the previous append
+	if (digest_tail_size_ > 0)
+	{
+		size_t take = std::min(size, sizeof(digest_tail_) - digest_tail_size_);
+		std::memcpy(digest_tail_ + digest_tail_size_, data, take);
+		digest_tail_size_ += take;
+		data += take;
+		size -= take;
+		if (digest_tail_size_ < sizeof(digest_tail_))
+		{
+			return;
+		}
+		uint64_t word;
+		std::memcpy(&word, digest_tail_, sizeof(word));
+		digest_state_ = absorb(digest_state_, word);
+		digest_tail_size_ = 0;
+	}
+
+	while (size >= sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, data, sizeof(word));
+		digest_state_ = absorb(digest_state_, word);
+		data += sizeof(word);
+		size -= sizeof(word);
+	}
+
+	std::memcpy(digest_tail_, data, size);
+	digest_tail_size_ = size;
+}
+
+uint64_t spill_buffer::digest() const noexcept
+{
+	uint64_t tail = 0;
+	std::memcpy(&tail, digest_tail_, digest_tail_size_);
+	return mix64(absorb(digest_state_, tail) ^ (size_ * digest_multiplier));
+}
+
+// ============================================================================
+// blob_upload_store
+// ============================================================================
+
+blob_upload_store::blob_upload_store(const blob_upload_config& config)
+	: config_(config)
+{
+}
+
+kcenon::common::Result<uint64_t> blob_upload_store::append(const std::string& session_id,
+														   const blob_chunk& chunk)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto& uploads = sessions_[session_id];
+	auto it = uploads.find(chunk.upload_id);
+	if (it == uploads.end())
+	{
+		if (chunk.offset != 0)
+		{
+			if (uploads.empty())
+			{
+				sessions_.erase(session_id);
+			}
+			return kcenon::common::error_info{
+				-3, upload_label(chunk.upload_id) + " not found", "blob_upload_store"
+			};
+		}
+		if (uploads.size() >= config_.max_uploads_per_session)
+		{
+			return kcenon::common::error_info{
+				-4, "Too many uploads in progress", "blob_upload_store"
+			};
+		}
+		it = uploads
+				 .emplace(chunk.upload_id,
+						  upload{ std::make_shared<spill_buffer>(config_.memory_threshold_bytes,
+																 config_.spill_directory) })
+				 .first;
+	}
+
+	auto& entry = it->second;
+	auto& buffer = *entry.buffer;
+	if (entry.complete)
+	{
+		return kcenon::common::error_info{
+			-5, upload_label(chunk.upload_id) + " is already complete", "blob_upload_store"
+		};
+	}
+	if (chunk.offset != buffer.size())
+	{
+		return kcenon::common::error_info{
+			-6,
+			"Chunk offset " + std::to_string(chunk.offset) + " does not match "
+				+ std::to_string(buffer.size()) + " bytes received",
+			"blob_upload_store"
+		};
+	}
+
+	auto drop = [&](kcenon::common::error_info error) -> kcenon::common::Result<uint64_t>
+	{
+		sub_memory(buffer.memory_bytes());
+		uploads.erase(it);
+		if (uploads.empty())
+		{
+			sessions_.erase(session_id);
+		}
+		metrics_.uploads_rejected.fetch_add(1);
+		return error;
+	};
+
+	if (buffer.size() + chunk.data.size() > config_.max_upload_bytes)
+	{
+		return drop(kcenon::common::error_info{
+			-7, upload_label(chunk.upload_id) + " exceeds "
+					+ std::to_string(config_.max_upload_bytes) + " bytes",
+			"blob_upload_store" });
+	}
+
+	size_t memory_before = buffer.memory_bytes();
+	bool was_spilled = buffer.is_spilled();
+
+	// Over the shared budget or under process memory pressure, new data goes
+	// to disk whatever the upload's size
+	kcenon::common::VoidResult written = kcenon::common::ok();
+	if (!was_spilled
+		&& (memory_bytes_.load() + chunk.data.size() > config_.max_memory_bytes
+			|| (governor_ && governor_->under_pressure())))
+	{
+		written = buffer.spill();
+	}
+	if (written.is_ok())
+	{
+		written = buffer.append(chunk.data.data(), chunk.data.size());
+	}
+
+	sub_memory(memory_before);
+	add_memory(buffer.memory_bytes());
+
+	if (written.is_err())
+	{
+		return drop(written.error());
+	}
+
+	if (!was_spilled && buffer.is_spilled())
+	{
+		metrics_.uploads_spilled.fetch_add(1);
+	}
+	metrics_.chunks_received.fetch_add(1);
+	metrics_.bytes_received.fetch_add(chunk.data.size());
+
+	if (chunk.last)
+	{
+		entry.complete = true;
+		metrics_.uploads_completed.fetch_add(1);
+	}
+	return buffer.size();
+}
+
+kcenon::common::Result<std::shared_ptr<const spill_buffer>> blob_upload_store::take(
+	const std::string& session_id, const std::string& upload_id)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto session_it = sessions_.find(session_id);
+	if (session_it == sessions_.end())
+	{
+		return kcenon::common::error_info{
+			-3, upload_label(upload_id) + " not found", "blob_upload_store"
+		};
+	}
+
+	auto& uploads = session_it->second;
+	auto it = uploads.find(upload_id);
+	if (it == uploads.end())
+	{
+		return kcenon::common::error_info{
+			-3, upload_label(upload_id) + " not found", "blob_upload_store"
+		};
+	}
+	if (!it->second.complete)
+	{
+		return kcenon::common::error_info{
+			-8, upload_label(upload_id) + " is not complete", "blob_upload_store"
+		};
+	}
+
+	std::shared_ptr<const spill_buffer> content = std::move(it->second.buffer);
+	sub_memory(content->memory_bytes());
+	uploads.erase(it);
+	if (uploads.empty())
+	{
+		sessions_.erase(session_it);
+	}
+	return content;
+}
+
+kcenon::common::VoidResult blob_upload_store::resolve(const std::string& session_id,
+													  query_request& request)
+{
+	std::unordered_map<std::string, std::shared_ptr<const spill_buffer>> resolved;
+
+	for (auto& param : request.params)
+	{
+		auto* ref = std::get_if<blob_ref>(&param.value);
+		if (!ref || ref->content)
+		{
+			continue;
+		}
+
+		if (auto it = resolved.find(ref->upload_id); it != resolved.end())
+		{
+			ref->content = it->second;
+			continue;
+		}
+
+		auto content = take(session_id, ref->upload_id);
+		if (content.is_err())
+		{
+			return content.error();
+		}
+		ref->content = content.value();
+		resolved.emplace(ref->upload_id, ref->content);
+	}
+	return kcenon::common::ok();
+}
+
+void blob_upload_store::remove_session(const std::string& session_id)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = sessions_.find(session_id);
+	if (it == sessions_.end())
+	{
+		return;
+	}
+	for (const auto& [id, entry] : it->second)
+	{
+		sub_memory(entry.buffer->memory_bytes());
+	}
+	sessions_.erase(it);
+}
+
+void blob_upload_store::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	sessions_.clear();
+	sub_memory(memory_bytes_.load());
+}
+
+size_t blob_upload_store::upload_count() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	size_t count = 0;
+	for (const auto& [session_id, uploads] : sessions_)
+	{
+		count += uploads.size();
+	}
+	return count;
+}
+
+size_t blob_upload_store::memory_bytes() const noexcept
+{
+	return memory_bytes_.load();
+}
+
+const blob_upload_metrics& blob_upload_store::metrics() const noexcept
+{
+	return metrics_;
+}
+
+const blob_upload_config& blob_upload_store::config() const noexcept
+{
+	return config_;
+}
+
+void blob_upload_store::set_memory_governor(std::shared_ptr<memory_governor> governor)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (governor_)
+	{
+		governor_->release(memory_subsystem::sessions, memory_bytes_.load());
+	}
+	governor_ = std::move(governor);
+	if (governor_)
+	{
+		governor_->charge(memory_subsystem::sessions, memory_bytes_.load());
+	}
+}
+
+void blob_upload_store::add_memory(size_t bytes)
+{
+	memory_bytes_.fetch_add(bytes);
+	if (governor_)
+	{
+		governor_->charge(memory_subsystem::sessions, bytes);
+	}
+}
+
+void blob_upload_store::sub_memory(size_t bytes)
+{
+	memory_bytes_.fetch_sub(bytes);
+	if (governor_)
+	{
+		governor_->release(memory_subsystem::sessions, bytes);
+	}
+}
+
+} // namespace database_server::gateway
@@ -0,0 +1,253 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file client_quota.cpp
+ * @brief Implementation of per-client concurrency quotas
+ */
+
+#include <kcenon/database_server/gateway/client_quota.h>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace database_server::gateway
+{
+
+// ============================================================================
+// client_quota_manager::slot
+// ============================================================================
+
+client_quota_manager::slot::slot(std::shared_ptr<client_state> state, quota_kind kind) noexcept
+	: state_(std::move(state))
+	, kind_(kind)
+	, granted_(true)
+{
+}
+
+client_quota_manager::slot::~slot()
+{
+	release();
+}
+
+client_quota_manager::slot::slot(slot&& other) noexcept
+	: state_(std::move(other.state_))
+	, kind_(other.kind_)
+	, granted_(std::exchange(other.granted_, false))
+{
+}
+
+client_quota_manager::slot& client_quota_manager::slot::operator=(slot&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		state_ = std::move(other.state_);
+		kind_ = other.kind_;
+		granted_ = std::exchange(other.granted_, false);
+	}
+	return *this;
+}
+
+void client_quota_manager::slot::release() noexcept
+{
+	granted_ = false;
+	if (!state_)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(state_->mutex);
+		auto& used = kind_ == quota_kind::query ? state_->in_flight_queries
+												: state_->held_connections;
+		--used;
+	}
+	state_->released.notify_all();
+	state_.reset();
+}
+
+// ============================================================================
+// client_quota_manager
+// ============================================================================
+
+client_quota_manager::client_quota_manager(const client_quota_config& config)
+	: config_(config)
+{
+}
+
+client_quota_manager::slot client_quota_manager::acquire(const std::string& client_id,
+														 quota_kind kind)
+{
+	if (!config_.enabled || client_id.empty())
+	{
+		return slot(nullptr, kind);
+	}
+
+	auto state = state_for(client_id);
+	auto limit = limit_for(kind);
+
+	std::unique_lock<std::mutex> lock(state->mutex);
+	auto& used = kind == quota_kind::query ? state->in_flight_queries
+										   : state->held_connections;
+	auto& rejected = kind == quota_kind::query ? state->rejected_queries
+											   : state->rejected_connections;
+	auto has_room = [&] { return limit == 0 || used < limit; };
+
+	if (!has_room())
+	{
+		if (config_.queue_timeout_ms == 0 || state->queued >= config_.max_queued)
+		{
+			++rejected;
+			return slot{};
+		}
+
+		++state->queued;
+		++state->delayed;
+		bool admitted = state->released.wait_for(
+			lock, std::chrono::milliseconds(config_.queue_timeout_ms), has_room);
+		--state->queued;
+		if (!admitted)
+		{
+			++rejected;
+			return slot{};
+		}
+	}
+
+	++used;
+	++state->admitted;
+	lock.unlock();
+	return slot(std::move(state), kind);
+}
+
+std::vector<client_quota_usage> client_quota_manager::usage() const
+{
+	std::shared_lock lock(clients_mutex_);
+	std::vector<client_quota_usage> result;
+	result.reserve(clients_.size());
+	for (const auto& [client_id, state] : clients_)
+	{
+		result.push_back(snapshot(client_id, *state));
+	}
+	return result;
+}
+
+std::optional<client_quota_usage> client_quota_manager::usage(
+	const std::string& client_id) const
+{
+	std::shared_lock lock(clients_mutex_);
+	auto it = clients_.find(client_id);
+	if (it == clients_.end())
+	{
+		return std::nullopt;
+	}
+	return snapshot(client_id, *it->second);
+}
+
+size_t client_quota_manager::size() const
+{
+	std::shared_lock lock(clients_mutex_);
+	return clients_.size();
+}
+
+const client_quota_config& client_quota_manager::config() const noexcept
+{
+	return config_;
+}
+
+std::shared_ptr<client_quota_manager::client_state> client_quota_manager::state_for(
+	const std::string& client_id)
+{
+	{
+		std::shared_lock lock(clients_mutex_);
+		auto it = clients_.find(client_id);
+		if (it != clients_.end())
+		{
+			return it->second;
+		}
+	}
+
+	std::unique_lock lock(clients_mutex_);
+	auto it = clients_.find(client_id);
+	if (it == clients_.end())
+	{
+		if (clients_.size() >= sweep_at_)
+		{
+			sweep();
+			sweep_at_ = std::max(min_sweep_size, clients_.size() * 2);
+		}
+		it = clients_.emplace(client_id, std::make_shared<client_state>()).first;
+	}
+	return it->second;
+}
+
+uint32_t client_quota_manager::limit_for(quota_kind kind) const noexcept
+{
+	return kind == quota_kind::query ? config_.max_in_flight_queries
+									 : config_.max_held_connections;
+}
+
+client_quota_usage client_quota_manager::snapshot(const std::string& client_id,
+												  client_state& state)
+{
+	std::lock_guard<std::mutex> lock(state.mutex);
+	client_quota_usage usage;
+	usage.client_id = client_id;
+	usage.in_flight_queries = state.in_flight_queries;
+	usage.held_connections = state.held_connections;
+	usage.queued = state.queued;
+	usage.admitted = state.admitted;
+	usage.delayed = state.delayed;
+	usage.rejected_queries = state.rejected_queries;
+	usage.rejected_connections = state.rejected_connections;
+	return usage;
+}
+
+size_t client_quota_manager::sweep()
+{
+	// Called with clients_mutex_ held exclusively: no new reference can be
+	// taken, so a state only the map owns is not in use by any slot or waiter
+	return std::erase_if(clients_,
+						 [](const auto& entry)
+						 {
+							 const auto& state = entry.second;
+							 if (state.use_count() != 1)
+							 {
+								 return false;
+							 }
+							 std::lock_guard<std::mutex> lock(state->mutex);
+							 return state->in_flight_queries == 0
+									&& state->held_connections == 0 && state->queued == 0;
+						 });
+}
+
+} // namespace database_server::gateway
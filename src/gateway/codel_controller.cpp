@@ -0,0 +1,137 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file codel_controller.cpp
+ * @brief Implementation of queue-delay-based load shedding
+ */
+
+#include <kcenon/database_server/gateway/codel_controller.h>
+
+#include <algorithm>
+
+namespace database_server::gateway
+{
+
+codel_controller::codel_controller(const codel_config& config)
+	: config_(config)
+	, target_(config.target_delay_us)
+	, interval_(std::max<uint32_t>(config.interval_us, 1))
+{
+}
+
+void codel_controller::record(std::chrono::microseconds sojourn)
+{
+	record(sojourn, clock::now());
+}
+
+void codel_controller::record(std::chrono::microseconds sojourn, clock::time_point now)
+{
+	if (!config_.enabled)
+	{
+		return;
+	}
+
+	metrics_.samples.fetch_add(1, std::memory_order_relaxed);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (now >= interval_end_)
+	{
+		expire_interval(now);
+	}
+	interval_min_ = std::min(interval_min_, sojourn);
+
+	// The queue drained below the target: stop shedding right away
+	if (sojourn < target_)
+	{
+		overloaded_.store(false);
+	}
+}
+
+bool codel_controller::should_shed(bool sheddable)
+{
+	return should_shed(sheddable, clock::now());
+}
+
+bool codel_controller::should_shed(bool sheddable, clock::time_point now)
+{
+	if (!config_.enabled || !sheddable || !overloaded_.load())
+	{
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (now >= interval_end_)
+		{
+			expire_interval(now);
+		}
+	}
+
+	if (!overloaded_.load())
+	{
+		return false;
+	}
+	metrics_.shed.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void codel_controller::expire_interval(clock::time_point now)
+{
+	// A window without samples means nothing was waiting
+	bool sampled = interval_min_ != std::chrono::microseconds::max();
+	bool overloaded = sampled && interval_min_ > target_;
+	if (overloaded && !overloaded_.load())
+	{
+		metrics_.overload_episodes.fetch_add(1, std::memory_order_relaxed);
+	}
+	overloaded_.store(overloaded);
+
+	interval_end_ = now + interval_;
+	interval_min_ = std::chrono::microseconds::max();
+}
+
+bool codel_controller::is_overloaded() const noexcept
+{
+	return overloaded_.load();
+}
+
+const codel_metrics& codel_controller::metrics() const noexcept
+{
+	return metrics_;
+}
+
+const codel_config& codel_controller::config() const noexcept
+{
+	return config_;
+}
+
+} // namespace database_server::gateway
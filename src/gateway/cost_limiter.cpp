@@ -0,0 +1,330 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file cost_limiter.cpp
+ * @brief Implementation of cost-based rate limiting
+ */
+
+#include <kcenon/database_server/gateway/cost_limiter.h>
+#include <kcenon/database_server/gateway/query_cache.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <functional>
+
+namespace database_server::gateway
+{
+
+namespace
+{
+
+bool is_identifier_char(char c) noexcept
+{
+	return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+} // namespace
+
+cost_limiter::cost_limiter(const cost_limit_config& config)
+	: config_(config)
+	, unit_ns_(1e9 / std::max(config.units_per_second, 1e-3))
+	, burst_ns_(static_cast<int64_t>(unit_ns_ * std::max(config.burst_units, 1.0)))
+{
+}
+
+cost_ticket cost_limiter::admit(const std::string& client_id, std::string_view sql)
+{
+	return admit(client_id, sql, clock::now());
+}
+
+cost_ticket cost_limiter::admit(const std::string& client_id, std::string_view sql,
+								clock::time_point now)
+{
+	cost_ticket ticket;
+	if (!config_.enabled || client_id.empty())
+	{
+		ticket.admitted = true;
+		return ticket;
+	}
+
+	ticket.fingerprint = fingerprint(sql);
+	ticket.estimated_units = estimate_for(ticket.fingerprint);
+
+	auto now_ns = to_ns(now);
+	auto charge_ns = static_cast<int64_t>(ticket.estimated_units * unit_ns_);
+	auto& target = shard_for(client_id);
+	{
+		std::lock_guard<std::mutex> lock(target.mutex);
+		auto it = target.tats.find(client_id);
+		if (it == target.tats.end())
+		{
+			// Sweep before inserting: the new entry would look idle
+			if (target.tats.size() >= target.sweep_at)
+			{
+				std::erase_if(target.tats, [&](const auto& entry) { return entry.second <= now_ns; });
+				target.sweep_at = std::max(min_sweep_size, target.tats.size() * 2);
+			}
+			it = target.tats.emplace(client_id, now_ns).first;
+		}
+
+		// An estimate above the burst is admitted once the client is idle
+		auto next = std::max(it->second, now_ns) + charge_ns;
+		ticket.admitted = it->second <= now_ns || next - now_ns <= burst_ns_;
+		if (ticket.admitted)
+		{
+			it->second = next;
+		}
+	}
+
+	if (ticket.admitted)
+	{
+		metrics_.admitted.fetch_add(1, std::memory_order_relaxed);
+	}
+	else
+	{
+		metrics_.rejected.fetch_add(1, std::memory_order_relaxed);
+	}
+	return ticket;
+}
+
+void cost_limiter::settle(const std::string& client_id, const cost_ticket& ticket,
+						  const query_cost& cost)
+{
+	if (!config_.enabled || client_id.empty() || !ticket.admitted)
+	{
+		return;
+	}
+
+	auto actual = units(cost);
+	record_estimate(ticket.fingerprint, actual);
+
+	auto delta_ns = static_cast<int64_t>((actual - ticket.estimated_units) * unit_ns_);
+	auto& target = shard_for(client_id);
+	{
+		std::lock_guard<std::mutex> lock(target.mutex);
+		auto it = target.tats.find(client_id);
+		if (it != target.tats.end())
+		{
+			it->second += delta_ns;
+		}
+		else if (delta_ns > 0)
+		{
+			// Swept while the query ran: only the debt is left to record
+			target.tats.emplace(client_id, to_ns(clock::now()) + delta_ns);
+		}
+	}
+
+	metrics_.settled.fetch_add(1, std::memory_order_relaxed);
+	metrics_.settled_units.fetch_add(static_cast<uint64_t>(std::llround(actual)),
+									 std::memory_order_relaxed);
+	if (actual > ticket.estimated_units)
+	{
+		metrics_.underestimated.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+double cost_limiter::available_units(const std::string& client_id) const
+{
+	return available_units(client_id, clock::now());
+}
+
+double cost_limiter::available_units(const std::string& client_id,
+									 clock::time_point now) const
+{
+	auto now_ns = to_ns(now);
+	int64_t tat = now_ns;
+	{
+		auto& target = shard_for(client_id);
+		std::lock_guard<std::mutex> lock(target.mutex);
+		auto it = target.tats.find(client_id);
+		if (it != target.tats.end())
+		{
+			tat = std::max(it->second, now_ns);
+		}
+	}
+	return std::max(0.0, static_cast<double>(burst_ns_ - (tat - now_ns)) / unit_ns_);
+}
+
+double cost_limiter::estimate(std::string_view sql) const
+{
+	return estimate_for(fingerprint(sql));
+}
+
+double cost_limiter::units(const query_cost& cost) const noexcept
+{
+	double units = static_cast<double>(cost.execution_time_us) / config_.unit_time_us
+				   + static_cast<double>(cost.rows) / config_.unit_rows
+				   + static_cast<double>(cost.bytes) / config_.unit_bytes;
+	return std::max(units, config_.min_cost_units);
+}
+
+query_cost cost_limiter::measure(const query_response& response)
+{
+	query_cost cost;
+	cost.execution_time_us = response.execution_time_us;
+	cost.rows = response.rows.size() + response.affected_rows;
+	cost.bytes = response.rows.empty() ? 0 : query_cache::estimate_size(response);
+	return cost;
+}
+
+uint64_t cost_limiter::fingerprint(std::string_view sql) noexcept
+{
+	// FNV-1a over the normalised text, without materialising it
+	uint64_t hash = 0xcbf29ce484222325ull;
+	auto feed = [&hash](char c)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 0x100000001b3ull;
+	};
+
+	bool pending_space = false;
+	char previous = ' ';
+	for (size_t i = 0; i < sql.size();)
+	{
+		char c = sql[i];
+		if (std::isspace(static_cast<unsigned char>(c)))
+		{
+			pending_space = previous != ' ';
+			++i;
+			continue;
+		}
+		if (pending_space)
+		{
+			feed(' ');
+			pending_space = false;
+		}
+
+		if (c == '\'')
+		{
+			// String literal, '' escapes a quote
+			for (++i; i < sql.size(); ++i)
+			{
+				if (sql[i] == '\'')
+				{
+					if (i + 1 < sql.size() && sql[i + 1] == '\'')
+					{
+						++i;
+						continue;
+					}
+					++i;
+					break;
+				}
+			}
+			c = '?';
+		}
+		else if (std::isdigit(static_cast<unsigned char>(c)) && !is_identifier_char(previous))
+		{
+			while (i < sql.size()
+				   && (std::isdigit(static_cast<unsigned char>(sql[i])) || sql[i] == '.'))
+			{
+				++i;
+			}
+			c = '?';
+		}
+		else
+		{
+			c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+			++i;
+		}
+
+		feed(c);
+		previous = c;
+	}
+	return hash;
+}
+
+size_t cost_limiter::size() const
+{
+	size_t total = 0;
+	for (const auto& target : shards_)
+	{
+		std::lock_guard<std::mutex> lock(target.mutex);
+		total += target.tats.size();
+	}
+	return total;
+}
+
+const cost_limit_metrics& cost_limiter::metrics() const noexcept
+{
+	return metrics_;
+}
+
+const cost_limit_config& cost_limiter::config() const noexcept
+{
+	return config_;
+}
+
+int64_t cost_limiter::to_ns(clock::time_point time) noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch())
+		.count();
+}
+
+cost_limiter::shard& cost_limiter::shard_for(const std::string& client_id) const noexcept
+{
+	static_assert(shard_count == 16, "the shift below selects one of 16 shards");
+
+	// Fibonacci hashing takes the high bits, unlike the maps' bucket index
+	uint64_t hash = std::hash<std::string>{}(client_id);
+	return shards_[(hash * 0x9E3779B97F4A7C15ull) >> 60];
+}
+
+double cost_limiter::estimate_for(uint64_t fingerprint) const
+{
+	std::lock_guard<std::mutex> lock(estimates_mutex_);
+	auto it = estimates_.find(fingerprint);
+	return it != estimates_.end() ? it->second : config_.initial_estimate_units;
+}
+
+void cost_limiter::record_estimate(uint64_t fingerprint, double units)
+{
+	std::lock_guard<std::mutex> lock(estimates_mutex_);
+	auto it = estimates_.find(fingerprint);
+	if (it != estimates_.end())
+	{
+		it->second += config_.estimate_weight * (units - it->second);
+		return;
+	}
+
+	if (config_.max_fingerprints == 0)
+	{
+		return;
+	}
+	if (estimates_.size() >= config_.max_fingerprints)
+	{
+		estimates_.erase(estimates_.begin());
+	}
+	estimates_.emplace(fingerprint, units);
+}
+
+} // namespace database_server::gateway
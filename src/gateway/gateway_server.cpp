@@ -31,7 +31,12 @@
 
 #include <kcenon/database_server/gateway/gateway_server.h>
 #include <kcenon/database_server/gateway/auth_middleware.h>
+#include <kcenon/database_server/gateway/io_uring_listener.h>
+#include <kcenon/database_server/gateway/query_cache.h>
+#include <kcenon/database_server/gateway/query_router.h>
 #include <kcenon/database_server/gateway/session_id_generator.h>
+#include <kcenon/database_server/gateway/shm_transport.h>
+#include <kcenon/database_server/gateway/unix_socket_listener.h>
 
 #include <kcenon/network/facade/tcp_facade.h>
 
@@ -39,7 +44,11 @@
 
 #include <kcenon/database_server/gateway/container_compat.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <exception>
+#include <future>
 
 namespace database_server::gateway
 {
@@ -55,6 +64,74 @@ uint64_t current_timestamp_ms()
 			.count());
 }
 
+/**
+ * @class network_session_transport
+ * @brief Adapts a kcenon::network TCP session to session_transport
+ */
+class network_session_transport : public session_transport
+{
+public:
+	explicit network_session_transport(
+		std::shared_ptr<kcenon::network::interfaces::i_session> session)
+		: session_(std::move(session))
+	{
+	}
+
+	[[nodiscard]] std::string_view id() const override { return session_->id(); }
+
+	[[nodiscard]] bool is_connected() const override { return session_->is_connected(); }
+
+	[[nodiscard]] kcenon::common::VoidResult send(std::vector<uint8_t>&& data) override
+	{
+		return session_->send(std::move(data));
+	}
+
+	void close() override { session_->close(); }
+
+	[[nodiscard]] std::string_view transport_name() const override { return "tcp"; }
+
+private:
+	std::shared_ptr<kcenon::network::interfaces::i_session> session_;
+};
+
+/**
+ * @brief Job the gateway hands to an executor
+ *
+ * Counted in the gateway's deferred request counter from construction to
+ * destruction, so stop() also waits for jobs the executor drops unrun.
+ */
+class deferred_job : public kcenon::common::interfaces::IJob
+{
+public:
+	deferred_job(std::shared_ptr<std::atomic<size_t>> pending, std::string name,
+				 std::function<void()> work)
+		: pending_(std::move(pending))
+		, name_(std::move(name))
+		, work_(std::move(work))
+	{
+		pending_->fetch_add(1, std::memory_order_relaxed);
+	}
+
+	~deferred_job() override
+	{
+		pending_->fetch_sub(1, std::memory_order_release);
+		pending_->notify_all();
+	}
+
+	kcenon::common::VoidResult execute() override
+	{
+		work_();
+		return kcenon::common::ok();
+	}
+
+	std::string get_name() const override { return name_; }
+
+private:
+	std::shared_ptr<std::atomic<size_t>> pending_;
+	std::string name_;
+	std::function<void()> work_;
+};
+
 } // namespace
 
 // ============================================================================
@@ -63,34 +140,109 @@ uint64_t current_timestamp_ms()
 
 gateway_server::gateway_server(const gateway_config& config)
 	: config_(config)
-	, server_(kcenon::network::facade::tcp_facade().create_server(
-		  {.port = config.port, .server_id = config.server_id}))
+	, server_(config.tcp_transport == tcp_transport_type::network_system && !config.enable_tls
+				  ? kcenon::network::facade::tcp_facade().create_server(
+						{.port = config.port, .server_id = config.server_id})
+				  : nullptr)
 	, auth_middleware_(std::make_unique<auth_middleware>(config.auth, config.rate_limit))
+	, delta_tracker_(std::make_unique<result_delta_tracker>(config.delta))
+	, invalidation_broadcaster_(std::make_unique<invalidation_broadcaster>(config.invalidation))
+	, blob_uploads_(std::make_unique<blob_upload_store>(config.blob_upload))
+	, dispatch_admission_(std::make_unique<codel_controller>(config.dispatch_admission))
+	, memory_governor_(std::make_shared<memory_governor>(config.memory))
 {
-	// Set up network callbacks using i_protocol_server interface
-	server_->set_connection_callback(
-		[this](std::shared_ptr<kcenon::network::interfaces::i_session> session)
-		{
-			on_connection(std::move(session));
-		});
+	blob_uploads_->set_memory_governor(memory_governor_);
 
-	server_->set_disconnection_callback(
-		[this](std::string_view session_id)
+	invalidation_broadcaster_->set_sender(
+		[this](const std::string& session_id, const invalidation_event& event)
 		{
-			on_disconnection(session_id);
+			return send_event(session_id, event);
 		});
 
-	server_->set_receive_callback(
-		[this](std::string_view session_id, const std::vector<uint8_t>& data)
-		{
-			on_message(session_id, data);
-		});
+	// Set up network callbacks using i_protocol_server interface
+	if (server_)
+	{
+		server_->set_connection_callback(
+			[this](std::shared_ptr<kcenon::network::interfaces::i_session> session)
+			{
+				on_connection(std::move(session));
+			});
 
-	server_->set_error_callback(
-		[this](std::string_view session_id, std::error_code ec)
-		{
-			on_error(session_id, ec);
-		});
+		server_->set_disconnection_callback(
+			[this](std::string_view session_id)
+			{
+				on_disconnection(session_id);
+			});
+
+		server_->set_receive_callback(
+			[this](std::string_view session_id, const std::vector<uint8_t>& data)
+			{
+				on_message(session_id, data);
+			});
+
+		server_->set_error_callback(
+			[this](std::string_view session_id, std::error_code ec)
+			{
+				on_error(session_id, ec);
+			});
+	}
+	else if (config_.enable_tls)
+	{
+		tls_config secure_config;
+		secure_config.port = config_.port;
+		secure_config.cert_file = config_.tls_cert_file;
+		secure_config.key_file = config_.tls_key_file;
+		secure_config.max_connections = config_.max_connections;
+		auto listener = std::make_unique<tls_listener>(secure_config);
+		tls_listener_ = listener.get();
+		transport_listeners_.push_back(std::move(listener));
+	}
+	else
+	{
+		io_uring_config uring_config;
+		uring_config.port = config_.port;
+		uring_config.max_connections = config_.max_connections;
+		transport_listeners_.push_back(std::make_unique<io_uring_listener>(uring_config));
+	}
+
+	if (!config_.unix_socket_path.empty())
+	{
+		unix_socket_config local_config;
+		local_config.path = config_.unix_socket_path;
+		local_config.permissions = config_.unix_socket_permissions;
+		local_config.max_connections = config_.max_connections;
+		transport_listeners_.push_back(std::make_unique<unix_socket_listener>(local_config));
+	}
+
+	if (!config_.shm_socket_path.empty())
+	{
+		shm_transport_config shm_config;
+		shm_config.path = config_.shm_socket_path;
+		shm_config.permissions = config_.unix_socket_permissions;
+		shm_config.max_connections = config_.max_connections;
+		transport_listeners_.push_back(std::make_unique<shm_transport_listener>(shm_config));
+	}
+
+	for (auto& listener : transport_listeners_)
+	{
+		listener->set_connection_callback(
+			[this](std::shared_ptr<session_transport> transport)
+			{
+				on_transport_connection(std::move(transport), nullptr);
+			});
+
+		listener->set_disconnection_callback(
+			[this](std::string_view transport_id)
+			{
+				on_disconnection(transport_id);
+			});
+
+		listener->set_receive_callback(
+			[this](std::string_view transport_id, const std::vector<uint8_t>& data)
+			{
+				on_message(transport_id, data);
+			});
+	}
 }
 
 gateway_server::~gateway_server()
@@ -110,18 +262,194 @@ kcenon::common::VoidResult gateway_server::start()
 		};
 	}
 
-	auto result = server_->start(config_.port);
-	if (result.is_err())
+	draining_ = false;
+
+	// Without a predecessor on the handoff path the sockets are bound as usual
+	std::unique_ptr<handoff_client> predecessor;
+	if (config_.takeover && !config_.handoff_socket_path.empty())
+	{
+		predecessor = std::make_unique<handoff_client>(
+			handoff_config{ .path = config_.handoff_socket_path });
+		auto takeover_result = receive_listeners(*predecessor);
+		if (takeover_result.is_err())
+		{
+			running_ = false;
+			return takeover_result.error();
+		}
+	}
+
+	if (server_)
+	{
+		auto result = server_->start(config_.port);
+		if (result.is_err())
+		{
+			running_ = false;
+			return kcenon::common::error_info{
+				-2, "Failed to start network server", "gateway_server"
+			};
+		}
+	}
+
+	for (auto& listener : transport_listeners_)
+	{
+		auto listener_result = listener->start();
+		if (listener_result.is_err())
+		{
+			for (auto& started : transport_listeners_)
+			{
+				started->stop();
+			}
+			if (server_)
+			{
+				(void)server_->stop();
+			}
+			running_ = false;
+			return kcenon::common::error_info{
+				-3, "Failed to start transport listener: " + listener_result.error().message,
+				"gateway_server"
+			};
+		}
+	}
+
+	// The predecessor stops accepting once told; its idle connections move here
+	if (predecessor)
+	{
+		auto connections = predecessor->confirm_listening();
+		if (connections.is_ok())
+		{
+			for (auto& connection : connections.value())
+			{
+				auto* listener = find_listener(connection.transport);
+				if (listener == nullptr || listener->adopt_connection(connection.fd).is_err())
+				{
+					close_handoff_socket(connection);
+				}
+			}
+		}
+	}
+
+	if (!config_.handoff_socket_path.empty())
+	{
+		auto handoff_result = start_handoff_server();
+		if (handoff_result.is_err())
+		{
+			for (auto& listener : transport_listeners_)
+			{
+				listener->stop();
+			}
+			if (server_)
+			{
+				(void)server_->stop();
+			}
+			running_ = false;
+			return handoff_result;
+		}
+	}
+
+	return kcenon::common::ok();
+}
+
+kcenon::common::VoidResult gateway_server::receive_listeners(handoff_client& predecessor)
+{
+	auto listeners = predecessor.receive_listeners();
+	if (listeners.is_err())
 	{
-		running_ = false;
+		if (listeners.error().code == handoff_client::no_predecessor)
+		{
+			return kcenon::common::ok();
+		}
 		return kcenon::common::error_info{
-			-2, "Failed to start network server", "gateway_server"
+			-4, "Takeover failed: " + listeners.error().message, "gateway_server"
 		};
 	}
 
+	// Sockets of listeners this configuration no longer has are closed;
+	// listeners that received none bind their own
+	for (auto& listener : listeners.value())
+	{
+		auto* owner = find_listener(listener.transport);
+		if (owner == nullptr || !owner->adopt_listen_fd(listener.fd))
+		{
+			close_handoff_socket(listener);
+		}
+	}
+	return kcenon::common::ok();
+}
+
+kcenon::common::VoidResult gateway_server::start_handoff_server()
+{
+	handoff_server_ = std::make_unique<handoff_server>(
+		handoff_config{ .path = config_.handoff_socket_path });
+
+	handoff_server_->set_listeners_provider(
+		[this]
+		{
+			std::vector<handoff_socket> sockets;
+			for (const auto& listener : transport_listeners_)
+			{
+				if (int fd = listener->listen_fd(); fd >= 0)
+				{
+					sockets.push_back({std::string(listener->transport_name()), fd});
+				}
+			}
+			return sockets;
+		});
+
+	handoff_server_->set_release_callback([this] { return release_for_successor(); });
+
+	handoff_server_->set_completion_callback([this] { draining_ = true; });
+
+	auto result = handoff_server_->start();
+	if (result.is_err())
+	{
+		handoff_server_.reset();
+		return kcenon::common::error_info{
+			-5, "Failed to start handoff server: " + result.error().message, "gateway_server"
+		};
+	}
 	return kcenon::common::ok();
 }
 
+std::vector<handoff_socket> gateway_server::release_for_successor()
+{
+	std::vector<handoff_socket> connections;
+	for (const auto& listener : transport_listeners_)
+	{
+		listener->stop_accepting();
+		if (!config_.handoff_idle_connections)
+		{
+			continue;
+		}
+
+		// Subscriptions are process state; their sessions stay and drain
+		auto fds = listener->release_idle_connections(
+			[this](std::string_view transport_id)
+			{
+				std::lock_guard<std::mutex> lock(sessions_mutex_);
+				auto it = network_id_map_.find(std::string(transport_id));
+				return it != network_id_map_.end()
+					   && invalidation_broadcaster_->subscription_count(it->second) == 0;
+			});
+		for (int fd : fds)
+		{
+			connections.push_back({std::string(listener->transport_name()), fd});
+		}
+	}
+	return connections;
+}
+
+transport_listener* gateway_server::find_listener(std::string_view transport) const
+{
+	for (const auto& listener : transport_listeners_)
+	{
+		if (listener->transport_name() == transport)
+		{
+			return listener.get();
+		}
+	}
+	return nullptr;
+}
+
 kcenon::common::VoidResult gateway_server::stop()
 {
 	if (!running_.exchange(false))
@@ -131,19 +459,44 @@ kcenon::common::VoidResult gateway_server::stop()
 		};
 	}
 
+	// Stop offering the sockets before the listeners close them
+	if (handoff_server_)
+	{
+		handoff_server_->stop();
+		handoff_server_.reset();
+	}
+
 	// Clear all sessions
 	{
 		std::lock_guard<std::mutex> lock(sessions_mutex_);
 		sessions_.clear();
 		network_id_map_.clear();
+		session_queues_.clear();
 	}
+	delta_tracker_->clear();
+	blob_uploads_->clear();
 
-	auto result = server_->stop();
-	if (result.is_err())
+	for (auto& listener : transport_listeners_)
 	{
-		return kcenon::common::error_info{
-			-2, "Failed to stop network server", "gateway_server"
-		};
+		listener->stop();
+	}
+
+	// Requests handed to the auth executor still use the middleware
+	for (auto pending = deferred_requests_->load(std::memory_order_acquire); pending != 0;
+		 pending = deferred_requests_->load(std::memory_order_acquire))
+	{
+		deferred_requests_->wait(pending);
+	}
+
+	if (server_)
+	{
+		auto result = server_->stop();
+		if (result.is_err())
+		{
+			return kcenon::common::error_info{
+				-2, "Failed to stop network server", "gateway_server"
+			};
+		}
 	}
 
 	stop_cv_.notify_all();
@@ -202,14 +555,18 @@ bool gateway_server::disconnect_client(const std::string& session_id)
 		return false;
 	}
 
-	if (auto& network_session = it->second.network_session)
+	if (auto& transport = it->second.transport)
 	{
 		// Remove reverse mapping before erasing session
-		network_id_map_.erase(std::string(network_session->id()));
-		network_session->close();
+		network_id_map_.erase(std::string(transport->id()));
+		transport->close();
 	}
 
+	delta_tracker_->remove_session(session_id);
+	invalidation_broadcaster_->remove_session(session_id);
+	blob_uploads_->remove_session(session_id);
 	sessions_.erase(it);
+	session_queues_.erase(session_id);
 	return true;
 }
 
@@ -228,11 +585,27 @@ const auth_middleware& gateway_server::get_auth_middleware() const noexcept
 	return *auth_middleware_;
 }
 
+void gateway_server::set_executor(
+	std::shared_ptr<kcenon::common::interfaces::IExecutor> executor)
+{
+	std::lock_guard<std::mutex> lock(executor_mutex_);
+	executor_ = std::move(executor);
+}
+
+std::shared_ptr<kcenon::common::interfaces::IExecutor> gateway_server::get_executor()
+	const noexcept
+{
+	std::lock_guard<std::mutex> lock(executor_mutex_);
+	return executor_;
+}
+
 void gateway_server::set_token_validator(std::shared_ptr<auth_validator> validator)
 {
 	// Recreate auth middleware with new validator
+	auto executor = auth_middleware_->get_executor();
 	auth_middleware_ = std::make_unique<auth_middleware>(
 		config_.auth, config_.rate_limit, std::move(validator));
+	auth_middleware_->set_executor(std::move(executor));
 }
 
 void gateway_server::set_audit_callback(audit_callback_t callback)
@@ -240,6 +613,45 @@ void gateway_server::set_audit_callback(audit_callback_t callback)
 	auth_middleware_->set_audit_callback(std::move(callback));
 }
 
+const result_delta_tracker& gateway_server::get_delta_tracker() const noexcept
+{
+	return *delta_tracker_;
+}
+
+invalidation_broadcaster& gateway_server::get_invalidation_broadcaster() noexcept
+{
+	return *invalidation_broadcaster_;
+}
+
+const blob_upload_store& gateway_server::get_blob_upload_store() const noexcept
+{
+	return *blob_uploads_;
+}
+
+const codel_controller& gateway_server::get_dispatch_admission() const noexcept
+{
+	return *dispatch_admission_;
+}
+
+std::shared_ptr<memory_governor> gateway_server::get_memory_governor() const noexcept
+{
+	return memory_governor_;
+}
+
+bool gateway_server::is_draining() const noexcept
+{
+	return draining_.load();
+}
+
+std::optional<tls_stats> gateway_server::get_tls_stats() const
+{
+	if (tls_listener_ == nullptr)
+	{
+		return std::nullopt;
+	}
+	return tls_listener_->get_stats();
+}
+
 void gateway_server::on_connection(
 	std::shared_ptr<kcenon::network::interfaces::i_session> session)
 {
@@ -248,8 +660,16 @@ void gateway_server::on_connection(
 		return;
 	}
 
+	auto transport = std::make_shared<network_session_transport>(session);
+	on_transport_connection(std::move(transport), std::move(session));
+}
+
+void gateway_server::on_transport_connection(
+	std::shared_ptr<session_transport> transport,
+	std::shared_ptr<kcenon::network::interfaces::i_session> network_session)
+{
 	auto session_id = generate_session_id();
-	auto network_id = std::string(session->id());
+	auto network_id = std::string(transport->id());
 	auto now = current_timestamp_ms();
 
 	client_session client;
@@ -257,7 +677,9 @@ void gateway_server::on_connection(
 	client.connected_at = now;
 	client.last_activity = now;
 	client.authenticated = !config_.require_auth;
-	client.network_session = session;
+	client.peer = transport->peer();
+	client.transport = transport;
+	client.network_session = std::move(network_session);
 
 	{
 		std::lock_guard<std::mutex> lock(sessions_mutex_);
@@ -266,12 +688,13 @@ void gateway_server::on_connection(
 		if (sessions_.size() >= config_.max_connections)
 		{
 			// Reject connection
-			session->close();
+			transport->close();
 			return;
 		}
 
 		sessions_[session_id] = client;
 		network_id_map_[network_id] = session_id;
+		session_queues_[session_id] = std::make_shared<session_queue>();
 	}
 
 	// Notify auth middleware of session creation
@@ -296,10 +719,14 @@ void gateway_server::on_disconnection(std::string_view network_session_id)
 		session_id = map_it->second;
 		network_id_map_.erase(map_it);
 		sessions_.erase(session_id);
+		session_queues_.erase(session_id);
 	}
 
 	// Notify auth middleware of session destruction
 	auth_middleware_->on_session_destroyed(session_id);
+	delta_tracker_->remove_session(session_id);
+	invalidation_broadcaster_->remove_session(session_id);
+	blob_uploads_->remove_session(session_id);
 
 	if (disconnection_callback_)
 	{
@@ -318,6 +745,7 @@ void gateway_server::on_message(
 
 	// Look up session by network session ID (O(1) hash lookup)
 	std::string session_id;
+	std::shared_ptr<session_queue> queue;
 	{
 		std::lock_guard<std::mutex> lock(sessions_mutex_);
 		auto map_it = network_id_map_.find(std::string(network_session_id));
@@ -326,6 +754,133 @@ void gateway_server::on_message(
 			return;
 		}
 		session_id = map_it->second;
+		if (auto it = session_queues_.find(session_id); it != session_queues_.end())
+		{
+			queue = it->second;
+		}
+	}
+	if (!queue)
+	{
+		return;
+	}
+
+	enqueue_message(session_id, queue, data);
+}
+
+void gateway_server::enqueue_message(
+	const std::string& session_id,
+	const std::shared_ptr<session_queue>& queue,
+	const std::vector<uint8_t>& data)
+{
+	auto executor = get_executor();
+	{
+		std::unique_lock<std::mutex> lock(queue->mutex);
+		if (queue->active)
+		{
+			// A client that keeps sending while its requests wait is cut off
+			// rather than buffered without bound
+			if (queue->pending_bytes + data.size() > config_.max_queued_bytes)
+			{
+				queue->pending.clear();
+				queue->pending_bytes = 0;
+				lock.unlock();
+				disconnect_client(session_id);
+				return;
+			}
+
+			queue->pending.push_back(data);
+			queue->pending_bytes += data.size();
+			return;
+		}
+		queue->active = true;
+
+		if (executor)
+		{
+			queue->pending.push_back(data);
+			queue->pending_bytes += data.size();
+		}
+	}
+
+	// Without an executor the first message runs here, without a copy
+	if (!executor)
+	{
+		if (!process_message(session_id, queue, data))
+		{
+			return;
+		}
+	}
+	dispatch([this, session_id, queue]() { drain_session(session_id, queue); });
+}
+
+void gateway_server::dispatch(std::function<void()> work)
+{
+	if (auto executor = get_executor())
+	{
+		// Load shedding follows how long sessions wait for a worker
+		auto submitted_at = std::chrono::steady_clock::now();
+		auto job = std::make_unique<deferred_job>(
+			deferred_requests_, "session_requests",
+			[this, work, submitted_at]()
+			{
+				dispatch_admission_->record(std::chrono::duration_cast<std::chrono::microseconds>(
+					std::chrono::steady_clock::now() - submitted_at));
+				work();
+			});
+		if (executor->execute(std::move(job)).is_ok())
+		{
+			return;
+		}
+	}
+
+	work();
+}
+
+void gateway_server::drain_session(const std::string& session_id,
+								   const std::shared_ptr<session_queue>& queue)
+{
+	while (true)
+	{
+		std::vector<uint8_t> message;
+		{
+			std::lock_guard<std::mutex> lock(queue->mutex);
+			if (queue->pending.empty())
+			{
+				queue->active = false;
+				return;
+			}
+			message = std::move(queue->pending.front());
+			queue->pending.pop_front();
+			queue->pending_bytes -= message.size();
+		}
+
+		// A request waiting for token verification resumes the drain itself
+		if (!process_message(session_id, queue, message))
+		{
+			return;
+		}
+	}
+}
+
+bool gateway_server::process_message(
+	const std::string& session_id,
+	const std::shared_ptr<session_queue>& queue,
+	const std::vector<uint8_t>& data)
+{
+	// Replies follow the framing of the client's latest request
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		auto it = sessions_.find(session_id);
+		if (it == sessions_.end())
+		{
+			return true;
+		}
+		it->second.wire_version = is_wire_v2(data) ? wire_version_v2 : wire_version_v1;
+	}
+
+	// Several independent requests in one message
+	if (wire_v2_kind(data) == wire_message_kind::request_batch)
+	{
+		return process_batch(session_id, queue, data);
 	}
 
 	// Deserialize request
@@ -337,7 +892,7 @@ void gateway_server::on_message(
 									  "Failed to parse request: " +
 										  request_result.error().message);
 		send_response(session_id, error_response);
-		return;
+		return true;
 	}
 
 	// Update last activity
@@ -350,7 +905,7 @@ void gateway_server::on_message(
 		}
 	}
 
-	process_request(session_id, request_result.value());
+	return process_request(session_id, queue, std::move(request_result.value()));
 }
 
 void gateway_server::on_error(
@@ -361,17 +916,97 @@ void gateway_server::on_error(
 	// Log error if logging is available
 }
 
-void gateway_server::process_request(
+bool gateway_server::process_request(
 	const std::string& session_id,
-	const query_request& request)
+	const std::shared_ptr<session_queue>& queue,
+	query_request request)
 {
-	// Handle ping request directly
+	// Only the token check moves to the auth executor, so a burst of new
+	// connections does not stall requests of other sessions. The session's
+	// queue stays active meanwhile: its later requests wait behind this one.
+	if (auto executor = auth_middleware_->get_executor();
+		executor && needs_token_validation(session_id, request))
+	{
+		auto message_id = request.header.message_id;
+		auto correlation_id = request.header.correlation_id;
+		auto job = std::make_unique<deferred_job>(
+			deferred_requests_, "token_verification",
+			[this, session_id, queue, request = std::move(request)]() mutable
+			{
+				auto verified = std::make_shared<auth_result>(
+					auth_middleware_->verify(request.token));
+				auto pending = std::make_shared<query_request>(std::move(request));
+				dispatch(
+					[this, session_id, queue, pending, verified]()
+					{
+						auto outcome
+							= execute_request(session_id, std::move(*pending), std::move(*verified));
+						send_response(session_id, outcome.response, outcome.layout);
+						drain_session(session_id, queue);
+					});
+			});
+		if (executor->execute(std::move(job)).is_ok())
+		{
+			return false;
+		}
+
+		query_response error_response(message_id, status_code::server_busy,
+									  "Token verification unavailable");
+		error_response.header.correlation_id = correlation_id;
+		send_response(session_id, error_response);
+		return true;
+	}
+
+	auto outcome = execute_request(session_id, std::move(request));
+	send_response(session_id, outcome.response, outcome.layout);
+	return true;
+}
+
+bool gateway_server::needs_token_validation(const std::string& session_id,
+										   const query_request& request) const
+{
+	if (!config_.require_auth || request.type == query_type::ping)
+	{
+		return false;
+	}
+
+	const auto& auth = auth_middleware_->get_auth_config();
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		auto it = sessions_.find(session_id);
+		if (it == sessions_.end())
+		{
+			return false;
+		}
+
+		// Trusted local peers never present a token
+		const auto& client = it->second;
+		const auto& trusted = auth.trusted_peer_uids;
+		if (client.peer
+			&& std::find(trusted.begin(), trusted.end(), client.peer->uid) != trusted.end())
+		{
+			return false;
+		}
+		if (client.authenticated && !auth.validate_on_each_request)
+		{
+			return false;
+		}
+	}
+
+	return auth_middleware_->needs_validation(request.token);
+}
+
+gateway_server::request_outcome gateway_server::execute_request(
+	const std::string& session_id,
+	query_request request,
+	std::optional<auth_result> verified)
+{
+	// Handle ping request directly
 	if (request.type == query_type::ping)
 	{
 		query_response response(request.header.message_id);
 		response.header.correlation_id = request.header.correlation_id;
-		send_response(session_id, response);
-		return;
+		return request_outcome{ std::move(response) };
 	}
 
 	// Get client session
@@ -389,21 +1024,36 @@ void gateway_server::process_request(
 		query_response error_response(request.header.message_id,
 									  status_code::error,
 									  "Session not found");
-		send_response(session_id, error_response);
-		return;
+		return request_outcome{ std::move(error_response) };
 	}
 
 	// Check authentication and rate limiting using middleware
 	if (config_.require_auth && !client->authenticated)
 	{
-		auto auth_result = auth_middleware_->check(session_id, request.token);
+		// Local peers with a trusted uid need no token, but are still rate limited
+		auth_result auth_result;
+		if (client->peer)
+		{
+			auth_result = auth_middleware_->authenticate_peer(session_id, *client->peer);
+			if (auth_result.success && !auth_middleware_->check_rate_limit(auth_result.client_id))
+			{
+				auth_result.success = false;
+				auth_result.code = status_code::rate_limited;
+				auth_result.message = "Rate limit exceeded";
+			}
+		}
+		if (!auth_result.success && auth_result.code != status_code::rate_limited)
+		{
+			auth_result = verified
+							  ? auth_middleware_->check(session_id, request.token, *verified)
+							  : auth_middleware_->check(session_id, request.token);
+		}
 		if (!auth_result.success)
 		{
 			query_response error_response(request.header.message_id,
 										  auth_result.code,
 										  auth_result.message);
-			send_response(session_id, error_response);
-			return;
+			return request_outcome{ std::move(error_response) };
 		}
 
 		// Mark as authenticated
@@ -418,14 +1068,31 @@ void gateway_server::process_request(
 	}
 	else if (config_.require_auth)
 	{
-		// Already authenticated, but still check rate limit
-		if (!auth_middleware_->check_rate_limit(client->client_id))
+		// Already authenticated. Sessions that authenticated with a token
+		// present it again if configured; the token cache answers those
+		// checks until the token nears expiry or is revoked.
+		bool peer_authenticated
+			= client->peer && client->client_id == "uid:" + std::to_string(client->peer->uid);
+		if (auth_middleware_->get_auth_config().validate_on_each_request && !peer_authenticated)
+		{
+			auto auth_result = verified
+								   ? auth_middleware_->check(session_id, request.token, *verified)
+								   : auth_middleware_->check(session_id, request.token);
+			if (!auth_result.success)
+			{
+				query_response error_response(request.header.message_id,
+											  auth_result.code,
+											  auth_result.message);
+				return request_outcome{ std::move(error_response) };
+			}
+		}
+		// Otherwise still check rate limit
+		else if (!auth_middleware_->check_rate_limit(client->client_id))
 		{
 			query_response error_response(request.header.message_id,
 										  status_code::rate_limited,
 										  "Rate limit exceeded");
-			send_response(session_id, error_response);
-			return;
+			return request_outcome{ std::move(error_response) };
 		}
 	}
 
@@ -435,60 +1102,527 @@ void gateway_server::process_request(
 		query_response error_response(request.header.message_id,
 									  status_code::invalid_query,
 									  "Invalid query request");
-		send_response(session_id, error_response);
-		return;
+		return request_outcome{ std::move(error_response) };
+	}
+
+	// Shed low-priority work while sessions keep waiting for a worker
+	if (dispatch_admission_->should_shed(is_sheddable(request.type)))
+	{
+		query_response error_response(request.header.message_id,
+									  status_code::server_busy,
+									  "Server overloaded, request shed");
+		error_response.header.correlation_id = request.header.correlation_id;
+		return request_outcome{ std::move(error_response) };
+	}
+
+	// Refuse queries that may materialize large results while memory is short
+	if (memory_governor_->should_shed(request))
+	{
+		query_response error_response(request.header.message_id,
+									  status_code::server_busy,
+									  "Insufficient memory, query shed");
+		error_response.header.correlation_id = request.header.correlation_id;
+		return request_outcome{ std::move(error_response) };
+	}
+
+	// Subscriptions are session state, handled by the gateway itself
+	if (request.type == query_type::subscribe || request.type == query_type::unsubscribe)
+	{
+		auto response = handle_subscription(session_id, request);
+		response.header.correlation_id = request.header.correlation_id;
+		return request_outcome{ std::move(response) };
+	}
+
+	// Uploads are session state, handled by the gateway itself
+	if (request.type == query_type::upload_chunk)
+	{
+		auto response = handle_upload_chunk(session_id, request);
+		response.header.correlation_id = request.header.correlation_id;
+		return request_outcome{ std::move(response) };
+	}
+
+	// Attach the content of uploaded binary parameters
+	if (auto resolved = blob_uploads_->resolve(session_id, request); resolved.is_err())
+	{
+		query_response error_response(request.header.message_id,
+									  status_code::not_found,
+									  resolved.error().message);
+		error_response.header.correlation_id = request.header.correlation_id;
+		return request_outcome{ std::move(error_response) };
 	}
 
 	// Invoke request handler
 	if (request_handler_)
 	{
+		// Reserve the expected result before the handler materializes it
+		auto reservation = memory_governor_->reserve(memory_subsystem::results,
+													 memory_governor_->estimate_result(request));
+		if (reservation.is_err())
+		{
+			query_response error_response(request.header.message_id,
+										  status_code::server_busy,
+										  "Insufficient memory for result");
+			error_response.header.correlation_id = request.header.correlation_id;
+			return request_outcome{ std::move(error_response) };
+		}
+
 		auto response = request_handler_(*client, request);
 		response.header.correlation_id = request.header.correlation_id;
-		send_response(session_id, response);
+
+		// Replace the full result with changed rows for opted-in polling queries
+		delta_tracker_->apply(session_id, request, response);
+
+		// Account the materialized result until it has been sent
+		request_outcome outcome;
+		outcome.reservation = std::move(reservation.value());
+		if (!outcome.reservation.resize(query_cache::estimate_size(response)))
+		{
+			response = query_response(request.header.message_id,
+									  status_code::server_busy,
+									  "Insufficient memory for result");
+			response.header.correlation_id = request.header.correlation_id;
+			(void)outcome.reservation.resize(query_cache::estimate_size(response));
+		}
+
+		bool columnar = request.options.columnar
+						|| (config_.columnar_min_rows > 0
+							&& response.rows.size() >= config_.columnar_min_rows);
+		outcome.layout = columnar ? wire_row_layout::columnar : wire_row_layout::rows;
+		outcome.response = std::move(response);
+		return outcome;
 	}
-	else
+
+	query_response error_response(request.header.message_id,
+								  status_code::error,
+								  "No request handler configured");
+	return request_outcome{ std::move(error_response) };
+}
+
+struct gateway_server::request_batch
+{
+	std::vector<std::optional<query_request>> requests;
+	std::vector<std::optional<auth_result>> verified; ///< Tokens verified on the auth executor
+	std::vector<request_outcome> outcomes;
+	std::vector<std::promise<void>> done; ///< Set once a claimed request has its outcome
+	std::atomic<size_t> next{ 0 };        ///< First request no thread has claimed yet
+	bool sequential = false;
+};
+
+bool gateway_server::process_batch(
+	const std::string& session_id,
+	const std::shared_ptr<session_queue>& queue,
+	std::span<const uint8_t> data)
+{
+	auto decoded = decode_wire_v2_batch(data);
+	if (decoded.is_err() || decoded.value().kind != wire_message_kind::request_batch)
 	{
-		query_response error_response(request.header.message_id,
-									  status_code::error,
-									  "No request handler configured");
+		query_response error_response(0, status_code::invalid_query,
+									  "Failed to parse request batch");
 		send_response(session_id, error_response);
+		return true;
+	}
+
+	const auto& frames = decoded.value().frames;
+	if (frames.size() > config_.max_batch_requests)
+	{
+		query_response error_response(0, status_code::invalid_query,
+									  "Request batch exceeds "
+										  + std::to_string(config_.max_batch_requests)
+										  + " requests");
+		send_response(session_id, error_response);
+		return true;
+	}
+
+	// Decode every request first; an entry that does not decode fails alone
+	auto batch = std::make_shared<request_batch>();
+	batch->requests.resize(frames.size());
+	batch->verified.resize(frames.size());
+	batch->outcomes.resize(frames.size());
+	batch->sequential = (decoded.value().flags & wire_flag_sequential) != 0;
+	for (size_t i = 0; i < frames.size(); ++i)
+	{
+		auto request = decode_request_v2(frames[i]);
+		if (request.is_err())
+		{
+			batch->outcomes[i].response = query_response(
+				0, status_code::invalid_query,
+				"Failed to parse request: " + request.error().message);
+			continue;
+		}
+
+		// Session state changes depend on the order they arrive in
+		auto type = request.value().type;
+		if (type == query_type::upload_chunk || type == query_type::subscribe
+			|| type == query_type::unsubscribe)
+		{
+			batch->sequential = true;
+		}
+		batch->requests[i] = std::move(request.value());
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		if (auto it = sessions_.find(session_id); it != sessions_.end())
+		{
+			it->second.last_activity = current_timestamp_ms();
+			it->second.requests_count += frames.size();
+		}
+	}
+
+	// Tokens go to the auth executor as for a single request, and the
+	// session's later messages wait behind the whole batch
+	std::vector<size_t> unverified;
+	auto auth_executor = auth_middleware_->get_executor();
+	for (size_t i = 0; auth_executor && i < frames.size(); ++i)
+	{
+		if (batch->requests[i] && needs_token_validation(session_id, *batch->requests[i]))
+		{
+			unverified.push_back(i);
+		}
+	}
+
+	if (!unverified.empty())
+	{
+		auto job = std::make_unique<deferred_job>(
+			deferred_requests_, "token_verification",
+			[this, session_id, queue, batch, unverified]()
+			{
+				for (auto index : unverified)
+				{
+					batch->verified[index]
+						= auth_middleware_->verify(batch->requests[index]->token);
+				}
+				dispatch(
+					[this, session_id, queue, batch]()
+					{
+						execute_batch(session_id, batch);
+						send_batch(session_id, batch->outcomes);
+						drain_session(session_id, queue);
+					});
+			});
+		if (auth_executor->execute(std::move(job)).is_ok())
+		{
+			return false;
+		}
+
+		for (auto index : unverified)
+		{
+			const auto& header = batch->requests[index]->header;
+			query_response error_response(header.message_id, status_code::server_busy,
+										  "Token verification unavailable");
+			error_response.header.correlation_id = header.correlation_id;
+			batch->outcomes[index].response = std::move(error_response);
+			batch->requests[index].reset();
+		}
 	}
+
+	execute_batch(session_id, batch);
+	send_batch(session_id, batch->outcomes);
+	return true;
 }
 
-void gateway_server::send_response(
-	const std::string& session_id,
-	const query_response& response)
+void gateway_server::execute_batch(const std::string& session_id,
+								   const std::shared_ptr<request_batch>& batch)
 {
-	std::shared_ptr<kcenon::network::interfaces::i_session> session;
+	auto executor = get_executor();
+	size_t count = batch->requests.size();
+	size_t workers = batch->sequential || !executor
+						 ? 1
+						 : std::min<size_t>(config_.batch_concurrency, count);
+	if (workers <= 1)
 	{
-		std::lock_guard<std::mutex> lock(sessions_mutex_);
-		auto it = sessions_.find(session_id);
-		if (it == sessions_.end())
+		for (size_t i = 0; i < count; ++i)
 		{
-			return;
+			execute_batch_request(session_id, *batch, i);
 		}
-		session = it->second.network_session;
+		return;
 	}
 
-	if (!session || !session->is_connected())
+	// Helpers claim requests the same way this thread does. Only requests a
+	// running thread has claimed are waited for, so a helper still queued on
+	// a busy executor holds nothing up.
+	batch->done.resize(count);
+	std::vector<std::future<void>> completions;
+	completions.reserve(count);
+	for (auto& done : batch->done)
+	{
+		completions.push_back(done.get_future());
+	}
+
+	auto drain = [this, session_id, batch]()
+	{
+		for (size_t i = batch->next.fetch_add(1); i < batch->requests.size();
+			 i = batch->next.fetch_add(1))
+		{
+			execute_batch_request(session_id, *batch, i);
+			batch->done[i].set_value();
+		}
+	};
+
+	for (size_t i = 1; i < workers; ++i)
+	{
+		dispatch(drain);
+	}
+	drain();
+
+	for (auto& completion : completions)
+	{
+		completion.wait();
+	}
+}
+
+void gateway_server::execute_batch_request(const std::string& session_id,
+										   request_batch& batch,
+										   size_t index)
+{
+	auto& request = batch.requests[index];
+	if (!request)
 	{
 		return;
 	}
 
-#if KCENON_WITH_CONTAINER_SYSTEM
-	auto container = response.serialize();
-	if (container)
+	auto message_id = request->header.message_id;
+	auto correlation_id = request->header.correlation_id;
+	std::string failure;
+	try
+	{
+		batch.outcomes[index]
+			= execute_request(session_id, std::move(*request), std::move(batch.verified[index]));
+		return;
+	}
+	catch (const std::exception& e)
+	{
+		failure = std::string("Request failed: ") + e.what();
+	}
+	catch (...)
+	{
+		failure = "Request failed";
+	}
+
+	// One failing request does not take the rest of the batch down
+	query_response error_response(message_id, status_code::error, failure);
+	error_response.header.correlation_id = correlation_id;
+	batch.outcomes[index] = request_outcome{ std::move(error_response) };
+}
+
+void gateway_server::send_batch(
+	const std::string& session_id,
+	const std::vector<request_outcome>& outcomes)
+{
+	std::vector<std::vector<uint8_t>> frames(outcomes.size());
+	for (size_t i = 0; i < outcomes.size(); ++i)
+	{
+		encode_wire_v2(outcomes[i].response, frames[i], outcomes[i].layout);
+	}
+	auto payload = encode_wire_v2_batch(wire_message_kind::response_batch, frames);
+	frames.clear();
+
+	(void)send_to_session(session_id, std::move(payload));
+}
+
+query_response gateway_server::handle_upload_chunk(
+	const std::string& session_id,
+	const query_request& request)
+{
+	if (!config_.blob_upload.enabled)
+	{
+		return query_response(request.header.message_id, status_code::permission_denied,
+							  "Chunked uploads are disabled");
+	}
+
+	auto result = blob_uploads_->append(session_id, *request.chunk);
+	if (result.is_err())
+	{
+		// Size and count limits reflect load; anything else means the client
+		// has to restart the upload or resume it from the bytes received
+		auto status = result.error().code == -7 || result.error().code == -4
+						  ? status_code::server_busy
+						  : status_code::invalid_query;
+		return query_response(request.header.message_id, status, result.error().message);
+	}
+
+	// Bytes received so far, the offset of the next chunk
+	query_response response(request.header.message_id);
+	response.affected_rows = result.value();
+	return response;
+}
+
+query_response gateway_server::handle_subscription(
+	const std::string& session_id,
+	const query_request& request)
+{
+	if (!config_.invalidation.enabled)
+	{
+		return query_response(request.header.message_id, status_code::permission_denied,
+							  "Invalidation subscriptions are disabled");
+	}
+
+	// With SQL, the request names a query (same key as query_cache::make_key);
+	// without SQL, every string parameter names a table.
+	std::string cache_key;
+	std::unordered_set<std::string> query_tables;
+	std::vector<std::string> tables;
+
+	if (!request.sql.empty())
+	{
+		cache_key = query_cache::make_key(request);
+		query_tables = query_router::extract_table_names(request.sql, query_type::select);
+	}
+	else
+	{
+		for (const auto& param : request.params)
+		{
+			if (const auto* name = std::get_if<std::string>(&param.value))
+			{
+				tables.push_back(*name);
+			}
+		}
+	}
+
+	auto& broadcaster = *invalidation_broadcaster_;
+
+	if (request.type == query_type::subscribe)
+	{
+		auto result = cache_key.empty()
+						  ? broadcaster.subscribe_tables(session_id, tables)
+						  : broadcaster.subscribe_query(session_id, cache_key, query_tables);
+		if (result.is_err())
+		{
+			return query_response(request.header.message_id, status_code::error,
+								  result.error().message);
+		}
+	}
+	else if (!cache_key.empty())
+	{
+		broadcaster.unsubscribe_query(session_id, cache_key);
+	}
+	else if (tables.empty())
 	{
+		broadcaster.remove_session(session_id);
+	}
+	else
+	{
+		broadcaster.unsubscribe_tables(session_id, tables);
+	}
+
+	// Acknowledge with the affected subscriptions so the client can map
+	// cache keys in later events back to its queries
+	query_response response(request.header.message_id);
+	response.affected_rows = broadcaster.subscription_count(session_id);
+
+	column_metadata kind_col;
+	kind_col.name = "kind";
+	kind_col.type_name = "TEXT";
+	column_metadata name_col;
+	name_col.name = "name";
+	name_col.type_name = "TEXT";
+	response.columns = {kind_col, name_col};
+
+	if (!cache_key.empty())
+	{
+		result_row row;
+		row.cells = {std::string("query"), cache_key};
+		response.rows.push_back(std::move(row));
+	}
+	for (const auto& table : tables)
+	{
+		result_row row;
+		row.cells = {std::string("table"), table};
+		response.rows.push_back(std::move(row));
+	}
+
+	return response;
+}
+
+void gateway_server::send_response(
+	const std::string& session_id,
+	const query_response& response,
+	wire_row_layout layout)
+{
+	std::vector<uint8_t> payload;
+	if (session_wire_version(session_id) == wire_version_v2)
+	{
+		encode_wire_v2(response, payload, layout);
+	}
+	else
+	{
+#if KCENON_WITH_CONTAINER_SYSTEM
+		auto container = response.serialize();
+		if (!container)
+		{
+			return;
+		}
 		auto result = container->serialize(
 			container_module::value_container::serialization_format::binary);
-		if (result.is_ok())
+		if (result.is_err())
 		{
-			(void)session->send(std::move(result.value()));
+			return;
 		}
+		payload = std::move(result.value());
+#else
+		return;
+#endif
+	}
+
+	(void)send_to_session(session_id, std::move(payload));
+}
+
+uint32_t gateway_server::session_wire_version(const std::string& session_id) const
+{
+	std::lock_guard<std::mutex> lock(sessions_mutex_);
+	auto it = sessions_.find(session_id);
+	return it != sessions_.end() ? it->second.wire_version : wire_version_v1;
+}
+
+bool gateway_server::send_event(
+	const std::string& session_id,
+	const invalidation_event& event)
+{
+	// Events follow the framing of the session's latest request
+	if (session_wire_version(session_id) == wire_version_v2)
+	{
+		return send_to_session(session_id, encode_wire_v2(event));
+	}
+
+#if KCENON_WITH_CONTAINER_SYSTEM
+	auto container = event.serialize();
+	if (!container)
+	{
+		return false;
+	}
+
+	auto result = container->serialize(
+		container_module::value_container::serialization_format::binary);
+	if (result.is_err())
+	{
+		return false;
 	}
+
+	return send_to_session(session_id, std::move(result.value()));
 #else
-	(void)response;
+	return false;
 #endif
 }
 
+bool gateway_server::send_to_session(const std::string& session_id, std::vector<uint8_t>&& data)
+{
+	std::shared_ptr<session_transport> session;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		auto it = sessions_.find(session_id);
+		if (it == sessions_.end())
+		{
+			return false;
+		}
+		session = it->second.transport;
+	}
+
+	if (!session || !session->is_connected())
+	{
+		return false;
+	}
+
+	return session->send(std::move(data)).is_ok();
+}
+
 } // namespace database_server::gateway
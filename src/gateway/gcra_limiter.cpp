@@ -0,0 +1,239 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file gcra_limiter.cpp
+ * @brief Implementation of the sharded GCRA rate limiter
+ */
+
+#include <kcenon/database_server/gateway/gcra_limiter.h>
+
+#include <functional>
+#include <mutex>
+
+namespace database_server::gateway
+{
+
+gcra_limiter::gcra_limiter(uint32_t requests_per_second, uint32_t burst_size,
+						   uint32_t block_duration_ms)
+	: params_(gcra_params::from_rate(requests_per_second, burst_size))
+	, block_ns_(static_cast<int64_t>(block_duration_ms) * 1'000'000)
+{
+}
+
+bool gcra_limiter::allow_request(const std::string& client_id)
+{
+	return allow_request(client_id, clock::now());
+}
+
+bool gcra_limiter::allow_request(const std::string& client_id, clock::time_point now)
+{
+	auto now_ns = to_ns(now);
+	auto& target = shard_for(client_id);
+
+	{
+		std::shared_lock lock(target.mutex);
+		auto it = target.cells.find(client_id);
+		if (it != target.cells.end())
+		{
+			return update(*it->second, now_ns);
+		}
+	}
+
+	std::unique_lock lock(target.mutex);
+	auto it = target.cells.find(client_id);
+	if (it == target.cells.end())
+	{
+		// Sweep before inserting: the new entry would look idle
+		if (target.cells.size() >= target.sweep_at)
+		{
+			sweep(target, now_ns);
+			target.sweep_at = std::max(min_sweep_size, target.cells.size() * 2);
+		}
+		it = target.cells.emplace(client_id, std::make_unique<cell>()).first;
+	}
+	return update(*it->second, now_ns);
+}
+
+uint32_t gcra_limiter::remaining_requests(const std::string& client_id) const
+{
+	return remaining_requests(client_id, clock::now());
+}
+
+uint32_t gcra_limiter::remaining_requests(const std::string& client_id,
+										  clock::time_point now) const
+{
+	auto now_ns = to_ns(now);
+	auto& target = shard_for(client_id);
+
+	std::shared_lock lock(target.mutex);
+	auto it = target.cells.find(client_id);
+	if (it == target.cells.end())
+	{
+		return params_.remaining(0, now_ns);
+	}
+	if (it->second->blocked_until.load(std::memory_order_relaxed) > now_ns)
+	{
+		return 0;
+	}
+	return params_.remaining(it->second->tat.load(std::memory_order_relaxed), now_ns);
+}
+
+bool gcra_limiter::is_blocked(const std::string& client_id) const
+{
+	return is_blocked(client_id, clock::now());
+}
+
+bool gcra_limiter::is_blocked(const std::string& client_id, clock::time_point now) const
+{
+	auto& target = shard_for(client_id);
+
+	std::shared_lock lock(target.mutex);
+	auto it = target.cells.find(client_id);
+	return it != target.cells.end()
+		   && it->second->blocked_until.load(std::memory_order_relaxed) > to_ns(now);
+}
+
+uint64_t gcra_limiter::block_expires_at(const std::string& client_id) const
+{
+	auto now = clock::now();
+	int64_t remaining_ns = 0;
+	{
+		auto& target = shard_for(client_id);
+		std::shared_lock lock(target.mutex);
+		auto it = target.cells.find(client_id);
+		if (it != target.cells.end())
+		{
+			remaining_ns = it->second->blocked_until.load(std::memory_order_relaxed) - to_ns(now);
+		}
+	}
+	if (remaining_ns <= 0)
+	{
+		return 0;
+	}
+
+	auto expires = std::chrono::system_clock::now() + std::chrono::nanoseconds(remaining_ns);
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::milliseconds>(expires.time_since_epoch())
+			.count());
+}
+
+void gcra_limiter::reset(const std::string& client_id)
+{
+	auto& target = shard_for(client_id);
+	std::unique_lock lock(target.mutex);
+	target.cells.erase(client_id);
+}
+
+size_t gcra_limiter::cleanup()
+{
+	return cleanup(clock::now());
+}
+
+size_t gcra_limiter::cleanup(clock::time_point now)
+{
+	auto now_ns = to_ns(now);
+	size_t removed = 0;
+	for (auto& target : shards_)
+	{
+		std::unique_lock lock(target.mutex);
+		removed += sweep(target, now_ns);
+	}
+	return removed;
+}
+
+size_t gcra_limiter::size() const
+{
+	size_t total = 0;
+	for (const auto& target : shards_)
+	{
+		std::shared_lock lock(target.mutex);
+		total += target.cells.size();
+	}
+	return total;
+}
+
+const gcra_params& gcra_limiter::params() const noexcept
+{
+	return params_;
+}
+
+int64_t gcra_limiter::to_ns(clock::time_point time) noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch())
+		.count();
+}
+
+gcra_limiter::shard& gcra_limiter::shard_for(const std::string& client_id) const noexcept
+{
+	static_assert(shard_count == 64, "the shift below selects one of 64 shards");
+
+	// Fibonacci hashing takes the high bits, unlike the maps' bucket index
+	uint64_t hash = std::hash<std::string>{}(client_id);
+	return shards_[(hash * 0x9E3779B97F4A7C15ull) >> 58];
+}
+
+bool gcra_limiter::is_idle(const cell& state, int64_t now) const noexcept
+{
+	return state.tat.load(std::memory_order_relaxed) <= now
+		   && state.blocked_until.load(std::memory_order_relaxed) <= now;
+}
+
+bool gcra_limiter::update(cell& state, int64_t now)
+{
+	if (state.blocked_until.load(std::memory_order_relaxed) > now)
+	{
+		return false;
+	}
+
+	int64_t tat = state.tat.load(std::memory_order_relaxed);
+	do
+	{
+		if (!params_.conforms(tat, now))
+		{
+			if (block_ns_ > 0)
+			{
+				state.blocked_until.store(now + block_ns_, std::memory_order_relaxed);
+			}
+			return false;
+		}
+	} while (!state.tat.compare_exchange_weak(tat, params_.advance(tat, now),
+											  std::memory_order_relaxed));
+	return true;
+}
+
+size_t gcra_limiter::sweep(shard& target, int64_t now)
+{
+	return std::erase_if(target.cells,
+						 [&](const auto& entry) { return is_idle(*entry.second, now); });
+}
+
+} // namespace database_server::gateway
@@ -0,0 +1,308 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <kcenon/database_server/gateway/hmac_sha2.h>
+
+#include <cstring>
+
+namespace database_server::gateway
+{
+
+namespace
+{
+
+struct sha256_traits
+{
+	using word = uint32_t;
+	static constexpr size_t block_size = 64;
+	static constexpr size_t length_size = 8;
+	static constexpr int sigma[4][3] = { { 2, 13, 22 }, { 6, 11, 25 }, { 7, 18, 3 }, { 17, 19, 10 } };
+
+	static constexpr std::array<word, 8> initial = {
+		0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+		0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+	};
+
+	static constexpr std::array<word, 64> k = {
+		0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+		0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+		0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+		0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+		0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+		0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+		0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+		0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+		0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+		0xc67178f2
+	};
+};
+
+struct sha512_traits
+{
+	using word = uint64_t;
+	static constexpr size_t block_size = 128;
+	static constexpr size_t length_size = 16;
+	static constexpr int sigma[4][3] = { { 28, 34, 39 }, { 14, 18, 41 }, { 1, 8, 7 }, { 19, 61, 6 } };
+
+	static constexpr std::array<word, 8> initial = {
+		0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+		0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179
+	};
+
+	static constexpr std::array<word, 80> k = {
+		0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
+		0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
+		0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
+		0x72be5d74f27b896f, 0x80deb1fe3b1696b1, 0x9bdc06a725c71235, 0xc19bf174cf692694,
+		0xe49b69c19ef14ad2, 0xefbe4786384f25e3, 0x0fc19dc68b8cd5b5, 0x240ca1cc77ac9c65,
+		0x2de92c6f592b0275, 0x4a7484aa6ea6e483, 0x5cb0a9dcbd41fbd4, 0x76f988da831153b5,
+		0x983e5152ee66dfab, 0xa831c66d2db43210, 0xb00327c898fb213f, 0xbf597fc7beef0ee4,
+		0xc6e00bf33da88fc2, 0xd5a79147930aa725, 0x06ca6351e003826f, 0x142929670a0e6e70,
+		0x27b70a8546d22ffc, 0x2e1b21385c26c926, 0x4d2c6dfc5ac42aed, 0x53380d139d95b3df,
+		0x650a73548baf63de, 0x766a0abb3c77b2a8, 0x81c2c92e47edaee6, 0x92722c851482353b,
+		0xa2bfe8a14cf10364, 0xa81a664bbc423001, 0xc24b8b70d0f89791, 0xc76c51a30654be30,
+		0xd192e819d6ef5218, 0xd69906245565a910, 0xf40e35855771202a, 0x106aa07032bbd1b8,
+		0x19a4c116b8d2d0c8, 0x1e376c085141ab53, 0x2748774cdf8eeb99, 0x34b0bcb5e19b48a8,
+		0x391c0cb3c5c95a63, 0x4ed8aa4ae3418acb, 0x5b9cca4f7763e373, 0x682e6ff3d6b2b8a3,
+		0x748f82ee5defb2fc, 0x78a5636f43172f60, 0x84c87814a1f0ab72, 0x8cc702081a6439ec,
+		0x90befffa23631e28, 0xa4506cebde82bde9, 0xbef9a3f7b2c67915, 0xc67178f2e372532b,
+		0xca273eceea26619c, 0xd186b8c721c0c207, 0xeada7dd6cde0eb1e, 0xf57d4f7fee6ed178,
+		0x06f067aa72176fba, 0x0a637dc5a2c898a6, 0x113f9804bef90dae, 0x1b710b35131c471b,
+		0x28db77f523047d84, 0x32caab7b40c72493, 0x3c9ebe0a15c9bebc, 0x431d67c49c100d4c,
+		0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817
+	};
+};
+
+/**
+ * SHA-2 compression and padding shared by both widths; Traits supplies the
+ * word type, constants and rotation amounts.
+ */
+template <typename Traits>
+struct sha2
+{
+	using word = typename Traits::word;
+	using state = std::array<word, 8>;
+	static constexpr size_t word_bits = sizeof(word) * 8;
+	static constexpr size_t block_size = Traits::block_size;
+
+	static constexpr word rotr(word x, int n) noexcept
+	{
+		return (x >> n) | (x << (word_bits - n));
+	}
+
+	static word load(const uint8_t* p) noexcept
+	{
+		word w = 0;
+		for (size_t i = 0; i < sizeof(word); ++i)
+		{
+			w = (w << 8) | p[i];
+		}
+		return w;
+	}
+
+	static void store(uint8_t* p, word w) noexcept
+	{
+		for (size_t i = sizeof(word); i-- > 0;)
+		{
+			p[i] = static_cast<uint8_t>(w);
+			w >>= 8;
+		}
+	}
+
+	static void compress(state& h, const uint8_t* block) noexcept
+	{
+		constexpr auto& s = Traits::sigma;
+		constexpr size_t rounds = Traits::k.size();
+
+		word w[rounds];
+		for (size_t i = 0; i < 16; ++i)
+		{
+			w[i] = load(block + i * sizeof(word));
+		}
+		for (size_t i = 16; i < rounds; ++i)
+		{
+			auto s0 = rotr(w[i - 15], s[2][0]) ^ rotr(w[i - 15], s[2][1]) ^ (w[i - 15] >> s[2][2]);
+			auto s1 = rotr(w[i - 2], s[3][0]) ^ rotr(w[i - 2], s[3][1]) ^ (w[i - 2] >> s[3][2]);
+			w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+		}
+
+		word a = h[0], b = h[1], c = h[2], d = h[3];
+		word e = h[4], f = h[5], g = h[6], hh = h[7];
+		for (size_t i = 0; i < rounds; ++i)
+		{
+			auto t1 = hh + (rotr(e, s[1][0]) ^ rotr(e, s[1][1]) ^ rotr(e, s[1][2]))
+					  + ((e & f) ^ (~e & g)) + Traits::k[i] + w[i];
+			auto t2 = (rotr(a, s[0][0]) ^ rotr(a, s[0][1]) ^ rotr(a, s[0][2]))
+					  + ((a & b) ^ (a & c) ^ (b & c));
+			hh = g;
+			g = f;
+			f = e;
+			e = d + t1;
+			d = c;
+			c = b;
+			b = a;
+			a = t1 + t2;
+		}
+
+		h[0] += a;
+		h[1] += b;
+		h[2] += c;
+		h[3] += d;
+		h[4] += e;
+		h[5] += f;
+		h[6] += g;
+		h[7] += hh;
+	}
+
+	/// Hash data after `prefix` bytes already absorbed into h
+	static std::array<uint8_t, sizeof(state)> finish(state h, uint64_t prefix,
+													 std::string_view data) noexcept
+	{
+		const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+		size_t remaining = data.size();
+		while (remaining >= block_size)
+		{
+			compress(h, bytes);
+			bytes += block_size;
+			remaining -= block_size;
+		}
+
+		uint8_t tail[block_size * 2] = {};
+		std::memcpy(tail, bytes, remaining);
+		tail[remaining] = 0x80;
+		size_t tail_size = remaining + 1 + Traits::length_size <= block_size ? block_size
+																			  : block_size * 2;
+		uint64_t bits = (prefix + data.size()) * 8;
+		for (size_t i = 0; i < 8; ++i)
+		{
+			tail[tail_size - 1 - i] = static_cast<uint8_t>(bits >> (i * 8));
+		}
+		for (size_t offset = 0; offset < tail_size; offset += block_size)
+		{
+			compress(h, tail + offset);
+		}
+
+		std::array<uint8_t, sizeof(state)> digest{};
+		for (size_t i = 0; i < h.size(); ++i)
+		{
+			store(digest.data() + i * sizeof(word), h[i]);
+		}
+		return digest;
+	}
+
+	/// Inner and outer states of HMAC for a key (RFC 2104)
+	static void hmac_states(std::string_view key, state& inner, state& outer) noexcept
+	{
+		uint8_t padded[block_size] = {};
+		if (key.size() > block_size)
+		{
+			auto digest = finish(Traits::initial, 0, key);
+			std::memcpy(padded, digest.data(), digest.size());
+		}
+		else
+		{
+			std::memcpy(padded, key.data(), key.size());
+		}
+
+		uint8_t pad[block_size];
+		for (size_t i = 0; i < block_size; ++i)
+		{
+			pad[i] = padded[i] ^ 0x36;
+		}
+		inner = Traits::initial;
+		compress(inner, pad);
+
+		for (size_t i = 0; i < block_size; ++i)
+		{
+			pad[i] = padded[i] ^ 0x5c;
+		}
+		outer = Traits::initial;
+		compress(outer, pad);
+	}
+
+	static std::array<uint8_t, sizeof(state)> hmac(const state& inner, const state& outer,
+												   std::string_view message) noexcept
+	{
+		auto inner_digest = finish(inner, block_size, message);
+		return finish(outer, block_size,
+					  std::string_view(reinterpret_cast<const char*>(inner_digest.data()),
+									   inner_digest.size()));
+	}
+};
+
+} // namespace
+
+sha256_digest sha256(std::string_view data) noexcept
+{
+	return sha2<sha256_traits>::finish(sha256_traits::initial, 0, data);
+}
+
+sha512_digest sha512(std::string_view data) noexcept
+{
+	return sha2<sha512_traits>::finish(sha512_traits::initial, 0, data);
+}
+
+hmac_sha256::hmac_sha256(std::string_view key) noexcept
+{
+	sha2<sha256_traits>::hmac_states(key, inner_, outer_);
+}
+
+sha256_digest hmac_sha256::sign(std::string_view message) const noexcept
+{
+	return sha2<sha256_traits>::hmac(inner_, outer_, message);
+}
+
+hmac_sha512::hmac_sha512(std::string_view key) noexcept
+{
+	sha2<sha512_traits>::hmac_states(key, inner_, outer_);
+}
+
+sha512_digest hmac_sha512::sign(std::string_view message) const noexcept
+{
+	return sha2<sha512_traits>::hmac(inner_, outer_, message);
+}
+
+bool constant_time_equal(std::string_view a, std::string_view b) noexcept
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+
+	uint8_t diff = 0;
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		diff |= static_cast<uint8_t>(a[i] ^ b[i]);
+	}
+	return diff == 0;
+}
+
+} // namespace database_server::gateway
@@ -0,0 +1,435 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <kcenon/database_server/gateway/invalidation_broadcaster.h>
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+
+namespace database_server::gateway
+{
+
+invalidation_broadcaster::invalidation_broadcaster(const invalidation_config& config)
+	: config_(config)
+{
+}
+
+void invalidation_broadcaster::set_sender(invalidation_sender_t sender)
+{
+	std::lock_guard<std::mutex> lock(sender_mutex_);
+	sender_ = std::move(sender);
+}
+
+kcenon::common::VoidResult invalidation_broadcaster::subscribe_tables(
+	const std::string& session_id, const std::vector<std::string>& tables)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto& state = sessions_[session_id];
+
+	std::unordered_set<std::string> added;
+	for (const auto& table : tables)
+	{
+		auto name = normalize(table);
+		if (!name.empty() && state.tables.find(name) == state.tables.end())
+		{
+			added.insert(std::move(name));
+		}
+	}
+
+	if (state.tables.size() + state.queries.size() + added.size()
+		> config_.max_subscriptions_per_session)
+	{
+		if (state.tables.empty() && state.queries.empty())
+		{
+			sessions_.erase(session_id);
+		}
+		return kcenon::common::error_info{
+			kcenon::common::error_codes::INVALID_ARGUMENT,
+			"Subscription limit exceeded",
+			"invalidation_broadcaster"};
+	}
+
+	for (const auto& name : added)
+	{
+		state.tables.insert(name);
+		table_index_[name].insert(session_id);
+	}
+
+	return kcenon::common::ok();
+}
+
+kcenon::common::VoidResult invalidation_broadcaster::subscribe_query(
+	const std::string& session_id,
+	const std::string& cache_key,
+	const std::unordered_set<std::string>& tables)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto& state = sessions_[session_id];
+
+	bool exists = state.queries.find(cache_key) != state.queries.end();
+	if (!exists
+		&& state.tables.size() + state.queries.size() + 1 > config_.max_subscriptions_per_session)
+	{
+		if (state.tables.empty() && state.queries.empty())
+		{
+			sessions_.erase(session_id);
+		}
+		return kcenon::common::error_info{
+			kcenon::common::error_codes::INVALID_ARGUMENT,
+			"Subscription limit exceeded",
+			"invalidation_broadcaster"};
+	}
+
+	if (exists)
+	{
+		remove_query_locked(session_id, state, cache_key);
+	}
+
+	std::unordered_set<std::string> normalized;
+	for (const auto& table : tables)
+	{
+		auto name = normalize(table);
+		if (!name.empty())
+		{
+			query_table_index_[name].insert(session_id);
+			normalized.insert(std::move(name));
+		}
+	}
+
+	state.queries[cache_key] = std::move(normalized);
+	key_index_[cache_key].insert(session_id);
+
+	return kcenon::common::ok();
+}
+
+void invalidation_broadcaster::unsubscribe_tables(const std::string& session_id,
+												  const std::vector<std::string>& tables)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = sessions_.find(session_id);
+	if (it == sessions_.end())
+	{
+		return;
+	}
+
+	for (const auto& table : tables)
+	{
+		auto name = normalize(table);
+		if (it->second.tables.erase(name) > 0)
+		{
+			index_remove(table_index_, name, session_id);
+		}
+	}
+}
+
+void invalidation_broadcaster::unsubscribe_query(const std::string& session_id,
+												 const std::string& cache_key)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = sessions_.find(session_id);
+	if (it == sessions_.end())
+	{
+		return;
+	}
+
+	remove_query_locked(session_id, it->second, cache_key);
+}
+
+void invalidation_broadcaster::remove_session(const std::string& session_id)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = sessions_.find(session_id);
+	if (it == sessions_.end())
+	{
+		return;
+	}
+
+	for (const auto& table : it->second.tables)
+	{
+		index_remove(table_index_, table, session_id);
+	}
+
+	// Copy keys since remove_query_locked modifies the map
+	std::vector<std::string> keys;
+	keys.reserve(it->second.queries.size());
+	for (const auto& [key, tables] : it->second.queries)
+	{
+		(void)tables;
+		keys.push_back(key);
+	}
+	for (const auto& key : keys)
+	{
+		remove_query_locked(session_id, it->second, key);
+	}
+
+	sessions_.erase(it);
+}
+
+void invalidation_broadcaster::publish(const std::string& table_name,
+									   const std::vector<std::string>& cache_keys)
+{
+	if (table_name.empty() && cache_keys.empty())
+	{
+		publish_resync();
+		return;
+	}
+
+	++metrics_.invalidations_published;
+
+	std::lock_guard<std::mutex> publish_lock(publish_mutex_);
+
+	std::vector<std::pair<std::string, invalidation_event>> events;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		// Ordered map keeps per-session key lists deterministic
+		std::map<std::string, invalidation_event> targets;
+		auto name = normalize(table_name);
+
+		if (!name.empty())
+		{
+			if (auto it = table_index_.find(name); it != table_index_.end())
+			{
+				for (const auto& session_id : it->second)
+				{
+					targets[session_id].tables.push_back(table_name);
+				}
+			}
+
+			if (auto it = query_table_index_.find(name); it != query_table_index_.end())
+			{
+				for (const auto& session_id : it->second)
+				{
+					const auto& state = sessions_[session_id];
+					for (const auto& [key, tables] : state.queries)
+					{
+						if (tables.find(name) != tables.end())
+						{
+							targets[session_id].cache_keys.push_back(key);
+						}
+					}
+				}
+			}
+		}
+
+		for (const auto& key : cache_keys)
+		{
+			if (auto it = key_index_.find(key); it != key_index_.end())
+			{
+				for (const auto& session_id : it->second)
+				{
+					auto& event_keys = targets[session_id].cache_keys;
+					if (std::find(event_keys.begin(), event_keys.end(), key) == event_keys.end())
+					{
+						event_keys.push_back(key);
+					}
+				}
+			}
+		}
+
+		events.reserve(targets.size());
+		for (auto& [session_id, event] : targets)
+		{
+			auto& state = sessions_[session_id];
+			event.header = message_header(0);
+			event.sequence = ++state.sequence;
+			event.resync = state.resync_pending;
+			state.resync_pending = false;
+			events.emplace_back(session_id, std::move(event));
+		}
+	}
+
+	deliver(events);
+}
+
+void invalidation_broadcaster::publish_resync()
+{
+	++metrics_.invalidations_published;
+
+	std::lock_guard<std::mutex> publish_lock(publish_mutex_);
+
+	std::vector<std::pair<std::string, invalidation_event>> events;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		events.reserve(sessions_.size());
+		for (auto& [session_id, state] : sessions_)
+		{
+			invalidation_event event;
+			event.header = message_header(0);
+			event.sequence = ++state.sequence;
+			event.resync = true;
+			state.resync_pending = false;
+			events.emplace_back(session_id, std::move(event));
+		}
+	}
+
+	deliver(events);
+}
+
+size_t invalidation_broadcaster::subscription_count(const std::string& session_id) const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = sessions_.find(session_id);
+	if (it == sessions_.end())
+	{
+		return 0;
+	}
+	return it->second.tables.size() + it->second.queries.size();
+}
+
+size_t invalidation_broadcaster::session_count() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return sessions_.size();
+}
+
+const invalidation_metrics& invalidation_broadcaster::metrics() const noexcept
+{
+	return metrics_;
+}
+
+const invalidation_config& invalidation_broadcaster::config() const noexcept
+{
+	return config_;
+}
+
+std::string invalidation_broadcaster::normalize(const std::string& table_name)
+{
+	std::string name = table_name;
+	std::transform(name.begin(), name.end(), name.begin(),
+				   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return name;
+}
+
+void invalidation_broadcaster::index_remove(index_map& index,
+											const std::string& key,
+											const std::string& session_id)
+{
+	auto it = index.find(key);
+	if (it == index.end())
+	{
+		return;
+	}
+
+	it->second.erase(session_id);
+	if (it->second.empty())
+	{
+		index.erase(it);
+	}
+}
+
+void invalidation_broadcaster::remove_query_locked(const std::string& session_id,
+												   session_state& state,
+												   const std::string& cache_key)
+{
+	auto it = state.queries.find(cache_key);
+	if (it == state.queries.end())
+	{
+		return;
+	}
+
+	for (const auto& table : it->second)
+	{
+		// Keep the table entry if another query of this session still reads it
+		bool still_used = false;
+		for (const auto& [key, tables] : state.queries)
+		{
+			if (key != cache_key && tables.find(table) != tables.end())
+			{
+				still_used = true;
+				break;
+			}
+		}
+		if (!still_used)
+		{
+			index_remove(query_table_index_, table, session_id);
+		}
+	}
+
+	index_remove(key_index_, cache_key, session_id);
+	state.queries.erase(it);
+}
+
+void invalidation_broadcaster::deliver(std::vector<std::pair<std::string, invalidation_event>>& events)
+{
+	if (events.empty())
+	{
+		return;
+	}
+
+	invalidation_sender_t sender;
+	{
+		std::lock_guard<std::mutex> lock(sender_mutex_);
+		sender = sender_;
+	}
+
+	std::vector<std::string> failed;
+	for (const auto& [session_id, event] : events)
+	{
+		if (event.resync)
+		{
+			++metrics_.resyncs;
+		}
+
+		if (sender && sender(session_id, event))
+		{
+			++metrics_.events_sent;
+		}
+		else
+		{
+			++metrics_.send_failures;
+			failed.push_back(session_id);
+		}
+	}
+
+	if (!failed.empty())
+	{
+		// The client missed an event: force it to start over on the next one
+		std::lock_guard<std::mutex> lock(mutex_);
+		for (const auto& session_id : failed)
+		{
+			if (auto it = sessions_.find(session_id); it != sessions_.end())
+			{
+				it->second.resync_pending = true;
+			}
+		}
+	}
+}
+
+} // namespace database_server::gateway
@@ -0,0 +1,778 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <kcenon/database_server/gateway/jwt_validator.h>
+
+#include <array>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace database_server::gateway
+{
+
+namespace
+{
+
+uint64_t current_timestamp_ms()
+{
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch())
+			.count());
+}
+
+auth_result failure(std::string message)
+{
+	auth_result result;
+	result.success = false;
+	result.code = status_code::authentication_failed;
+	result.message = std::move(message);
+	return result;
+}
+
+/**
+ * @brief Decode unpadded base64url (RFC 4648 section 5)
+ */
+std::optional<std::string> base64url_decode(std::string_view input)
+{
+	static constexpr auto table = []
+	{
+		std::array<int8_t, 256> t{};
+		t.fill(-1);
+		for (int i = 0; i < 26; ++i)
+		{
+			t['A' + i] = static_cast<int8_t>(i);
+			t['a' + i] = static_cast<int8_t>(26 + i);
+		}
+		for (int i = 0; i < 10; ++i)
+		{
+			t['0' + i] = static_cast<int8_t>(52 + i);
+		}
+		t['-'] = 62;
+		t['_'] = 63;
+		return t;
+	}();
+
+	if (input.size() % 4 == 1)
+	{
+		return std::nullopt;
+	}
+
+	std::string output;
+	output.reserve(input.size() * 3 / 4);
+	uint32_t buffer = 0;
+	int bits = 0;
+	for (char c : input)
+	{
+		auto value = table[static_cast<uint8_t>(c)];
+		if (value < 0)
+		{
+			return std::nullopt;
+		}
+		buffer = (buffer << 6) | static_cast<uint32_t>(value);
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			output.push_back(static_cast<char>((buffer >> bits) & 0xff));
+		}
+	}
+	// Leftover bits must be zero for a canonical encoding
+	if ((buffer & ((1u << bits) - 1)) != 0)
+	{
+		return std::nullopt;
+	}
+	return output;
+}
+
+/**
+ * @struct json_value
+ * @brief Claim value as far as the validator needs it
+ *
+ * Nested objects are skipped, and arrays keep only their string elements.
+ */
+struct json_value
+{
+	enum class kind : uint8_t
+	{
+		string,
+		number,
+		boolean,
+		null,
+		array,
+		object
+	};
+
+	kind type = kind::null;
+	std::string text;                 ///< string
+	double number = 0;                ///< number
+	std::vector<std::string> strings; ///< String elements of an array
+};
+
+using json_object = std::unordered_map<std::string, json_value>;
+
+/**
+ * @class json_reader
+ * @brief Parser for the flat JSON objects of JWT headers and claim sets
+ */
+class json_reader
+{
+public:
+	explicit json_reader(std::string_view text)
+		: text_(text)
+	{
+	}
+
+	/// Parse a complete document that must be one object
+	bool read_document(json_object& object)
+	{
+		skip_whitespace();
+		if (!read_object(&object, 0))
+		{
+			return false;
+		}
+		skip_whitespace();
+		return pos_ == text_.size();
+	}
+
+private:
+	static constexpr int max_depth = 16;
+
+	bool read_object(json_object* object, int depth)
+	{
+		if (depth > max_depth || !consume('{'))
+		{
+			return false;
+		}
+		skip_whitespace();
+		if (consume('}'))
+		{
+			return true;
+		}
+
+		do
+		{
+			skip_whitespace();
+			std::string key;
+			if (!read_string(key))
+			{
+				return false;
+			}
+			skip_whitespace();
+			if (!consume(':'))
+			{
+				return false;
+			}
+			skip_whitespace();
+
+			json_value value;
+			if (!read_value(value, depth))
+			{
+				return false;
+			}
+			// Duplicate claims are ambiguous between parsers; refuse them
+			if (object && !object->emplace(std::move(key), std::move(value)).second)
+			{
+				return false;
+			}
+			skip_whitespace();
+		} while (consume(','));
+
+		return consume('}');
+	}
+
+	bool read_array(json_value& value, int depth)
+	{
+		if (depth > max_depth || !consume('['))
+		{
+			return false;
+		}
+		value.type = json_value::kind::array;
+		skip_whitespace();
+		if (consume(']'))
+		{
+			return true;
+		}
+
+		do
+		{
+			skip_whitespace();
+			json_value element;
+			if (!read_value(element, depth))
+			{
+				return false;
+			}
+			if (element.type == json_value::kind::string)
+			{
+				value.strings.push_back(std::move(element.text));
+			}
+			skip_whitespace();
+		} while (consume(','));
+
+		return consume(']');
+	}
+
+	bool read_value(json_value& value, int depth)
+	{
+		if (pos_ >= text_.size())
+		{
+			return false;
+		}
+
+		switch (text_[pos_])
+		{
+		case '{':
+			value.type = json_value::kind::object;
+			return read_object(nullptr, depth + 1);
+		case '[':
+			return read_array(value, depth + 1);
+		case '"':
+			value.type = json_value::kind::string;
+			return read_string(value.text);
+		case 't':
+			value.type = json_value::kind::boolean;
+			return consume_literal("true");
+		case 'f':
+			value.type = json_value::kind::boolean;
+			return consume_literal("false");
+		case 'n':
+			value.type = json_value::kind::null;
+			return consume_literal("null");
+		default:
+			value.type = json_value::kind::number;
+			return read_number(value.number);
+		}
+	}
+
+	bool read_number(double& number)
+	{
+		auto start = pos_;
+		if (pos_ < text_.size() && text_[pos_] == '-')
+		{
+			++pos_;
+		}
+		while (pos_ < text_.size()
+			   && (std::isdigit(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '.'
+				   || text_[pos_] == 'e' || text_[pos_] == 'E' || text_[pos_] == '+'
+				   || text_[pos_] == '-'))
+		{
+			++pos_;
+		}
+		if (pos_ == start)
+		{
+			return false;
+		}
+
+		std::string digits(text_.substr(start, pos_ - start));
+		char* end = nullptr;
+		number = std::strtod(digits.c_str(), &end);
+		return end == digits.c_str() + digits.size() && std::isfinite(number);
+	}
+
+	bool read_string(std::string& out)
+	{
+		if (!consume('"'))
+		{
+			return false;
+		}
+
+		while (pos_ < text_.size())
+		{
+			char c = text_[pos_++];
+			if (c == '"')
+			{
+				return true;
+			}
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				return false;
+			}
+			if (c != '\\')
+			{
+				out.push_back(c);
+				continue;
+			}
+			if (pos_ >= text_.size())
+			{
+				return false;
+			}
+
+			switch (text_[pos_++])
+			{
+			case '"':
+				out.push_back('"');
+				break;
+			case '\\':
+				out.push_back('\\');
+				break;
+			case '/':
+				out.push_back('/');
+				break;
+			case 'b':
+				out.push_back('\b');
+				break;
+			case 'f':
+				out.push_back('\f');
+				break;
+			case 'n':
+				out.push_back('\n');
+				break;
+			case 'r':
+				out.push_back('\r');
+				break;
+			case 't':
+				out.push_back('\t');
+				break;
+			case 'u':
+				if (!read_unicode_escape(out))
+				{
+					return false;
+				}
+				break;
+			default:
+				return false;
+			}
+		}
+		return false;
+	}
+
+	bool read_hex4(uint32_t& value)
+	{
+		if (pos_ + 4 > text_.size())
+		{
+			return false;
+		}
+		value = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			char c = text_[pos_++];
+			value <<= 4;
+			if (c >= '0' && c <= '9')
+			{
+				value |= static_cast<uint32_t>(c - '0');
+			}
+			else if (c >= 'a' && c <= 'f')
+			{
+				value |= static_cast<uint32_t>(c - 'a' + 10);
+			}
+			else if (c >= 'A' && c <= 'F')
+			{
+				value |= static_cast<uint32_t>(c - 'A' + 10);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool read_unicode_escape(std::string& out)
+	{
+		uint32_t code = 0;
+		if (!read_hex4(code))
+		{
+			return false;
+		}
+		if (code >= 0xdc00 && code <= 0xdfff)
+		{
+			return false;
+		}
+		if (code >= 0xd800 && code <= 0xdbff)
+		{
+			uint32_t low = 0;
+			if (!consume('\\') || !consume('u') || !read_hex4(low) || low < 0xdc00
+				|| low > 0xdfff)
+			{
+				return false;
+			}
+			code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+		}
+
+		if (code < 0x80)
+		{
+			out.push_back(static_cast<char>(code));
+		}
+		else if (code < 0x800)
+		{
+			out.push_back(static_cast<char>(0xc0 | (code >> 6)));
+			out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+		}
+		else if (code < 0x10000)
+		{
+			out.push_back(static_cast<char>(0xe0 | (code >> 12)));
+			out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+			out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+		}
+		else
+		{
+			out.push_back(static_cast<char>(0xf0 | (code >> 18)));
+			out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3f)));
+			out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3f)));
+			out.push_back(static_cast<char>(0x80 | (code & 0x3f)));
+		}
+		return true;
+	}
+
+	bool consume(char expected)
+	{
+		if (pos_ < text_.size() && text_[pos_] == expected)
+		{
+			++pos_;
+			return true;
+		}
+		return false;
+	}
+
+	bool consume_literal(std::string_view literal)
+	{
+		if (text_.substr(pos_, literal.size()) != literal)
+		{
+			return false;
+		}
+		pos_ += literal.size();
+		return true;
+	}
+
+	void skip_whitespace()
+	{
+		while (pos_ < text_.size()
+			   && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n'
+				   || text_[pos_] == '\r'))
+		{
+			++pos_;
+		}
+	}
+
+private:
+	std::string_view text_;
+	size_t pos_ = 0;
+};
+
+std::optional<json_object> decode_segment(std::string_view segment)
+{
+	auto json = base64url_decode(segment);
+	if (!json)
+	{
+		return std::nullopt;
+	}
+
+	json_object object;
+	if (!json_reader(*json).read_document(object))
+	{
+		return std::nullopt;
+	}
+	return object;
+}
+
+const json_value* find_claim(const json_object& object, const std::string& name)
+{
+	auto it = object.find(name);
+	return it == object.end() ? nullptr : &it->second;
+}
+
+/**
+ * @brief Read a NumericDate claim (seconds, possibly fractional) as epoch ms
+ * @return nullopt if absent; sets valid to false if malformed
+ */
+std::optional<uint64_t> numeric_date_ms(const json_object& claims, const std::string& name,
+										bool& valid)
+{
+	const auto* claim = find_claim(claims, name);
+	if (!claim)
+	{
+		return std::nullopt;
+	}
+	if (claim->type != json_value::kind::number || claim->number < 0
+		|| claim->number > 1.0e13)
+	{
+		valid = false;
+		return std::nullopt;
+	}
+	return static_cast<uint64_t>(claim->number * 1000.0);
+}
+
+} // namespace
+
+jwt_validator::jwt_validator(jwt_config config)
+	: config_(std::move(config))
+{
+}
+
+void jwt_validator::add_key(const jwt_key& key)
+{
+	std::shared_ptr<const signing_key> entry;
+	if (key.algorithm == jwt_algorithm::hs512)
+	{
+		entry = std::make_shared<const signing_key>(
+			signing_key{ key.algorithm, hmac_sha512(key.secret) });
+	}
+	else
+	{
+		entry = std::make_shared<const signing_key>(
+			signing_key{ key.algorithm, hmac_sha256(key.secret) });
+	}
+
+	std::unique_lock<std::shared_mutex> lock(keys_mutex_);
+	keys_[key.kid] = std::move(entry);
+}
+
+bool jwt_validator::remove_key(const std::string& kid)
+{
+	std::unique_lock<std::shared_mutex> lock(keys_mutex_);
+	return keys_.erase(kid) > 0;
+}
+
+size_t jwt_validator::key_count() const
+{
+	std::shared_lock<std::shared_mutex> lock(keys_mutex_);
+	return keys_.size();
+}
+
+std::shared_ptr<const jwt_validator::signing_key> jwt_validator::find_key(
+	const std::string& kid) const
+{
+	std::shared_lock<std::shared_mutex> lock(keys_mutex_);
+	auto it = keys_.find(kid);
+	return it == keys_.end() ? nullptr : it->second;
+}
+
+auth_result jwt_validator::validate(const auth_token& token)
+{
+	return validate(token, current_timestamp_ms());
+}
+
+auth_result jwt_validator::validate(const auth_token& token, uint64_t now_ms) const
+{
+	const std::string_view compact = token.token;
+	if (compact.empty())
+	{
+		return failure("Token is empty");
+	}
+	if (compact.size() > config_.max_token_size)
+	{
+		return failure("Token is too large");
+	}
+
+	auto first_dot = compact.find('.');
+	auto second_dot = first_dot == std::string_view::npos ? std::string_view::npos
+														  : compact.find('.', first_dot + 1);
+	if (second_dot == std::string_view::npos
+		|| compact.find('.', second_dot + 1) != std::string_view::npos)
+	{
+		return failure("Malformed token");
+	}
+	auto signing_input = compact.substr(0, second_dot);
+
+	// Header: algorithm and key
+	auto header = decode_segment(compact.substr(0, first_dot));
+	if (!header)
+	{
+		return failure("Malformed token header");
+	}
+	if (find_claim(*header, "crit"))
+	{
+		return failure("Unsupported critical header");
+	}
+
+	const auto* alg = find_claim(*header, "alg");
+	if (!alg || alg->type != json_value::kind::string)
+	{
+		return failure("Missing token algorithm");
+	}
+
+	std::string kid;
+	if (const auto* kid_claim = find_claim(*header, "kid"))
+	{
+		if (kid_claim->type != json_value::kind::string)
+		{
+			return failure("Malformed key ID");
+		}
+		kid = kid_claim->text;
+	}
+
+	auto key = find_key(kid);
+	if (!key)
+	{
+		return failure("Unknown signing key");
+	}
+	if (alg->text != to_string(key->algorithm))
+	{
+		return failure("Token algorithm does not match its key");
+	}
+
+	// Signature
+	auto signature = base64url_decode(compact.substr(second_dot + 1));
+	if (!signature)
+	{
+		return failure("Malformed token signature");
+	}
+
+	verifications_.fetch_add(1, std::memory_order_relaxed);
+	bool signature_valid = std::visit(
+		[&](const auto& hmac)
+		{
+			auto expected = hmac.sign(signing_input);
+			return constant_time_equal(
+				*signature,
+				std::string_view(reinterpret_cast<const char*>(expected.data()),
+								 expected.size()));
+		},
+		key->hmac);
+	if (!signature_valid)
+	{
+		return failure("Invalid token signature");
+	}
+
+	// Claims
+	auto claims = decode_segment(compact.substr(first_dot + 1, second_dot - first_dot - 1));
+	if (!claims)
+	{
+		return failure("Malformed token claims");
+	}
+
+	bool dates_valid = true;
+	auto expires_at = numeric_date_ms(*claims, "exp", dates_valid);
+	auto not_before = numeric_date_ms(*claims, "nbf", dates_valid);
+	auto issued_at = numeric_date_ms(*claims, "iat", dates_valid);
+	if (!dates_valid)
+	{
+		return failure("Malformed token date");
+	}
+
+	if (!expires_at && config_.require_expiry)
+	{
+		return failure("Token has no expiry");
+	}
+	if (expires_at && now_ms >= *expires_at + config_.leeway_ms)
+	{
+		auto result = failure("Token has expired");
+		result.expires_at = *expires_at;
+		return result;
+	}
+	if (not_before && now_ms + config_.leeway_ms < *not_before)
+	{
+		return failure("Token is not yet valid");
+	}
+	if (issued_at && now_ms + config_.leeway_ms < *issued_at)
+	{
+		return failure("Token was issued in the future");
+	}
+
+	if (!config_.issuer.empty())
+	{
+		const auto* iss = find_claim(*claims, "iss");
+		if (!iss || iss->type != json_value::kind::string || iss->text != config_.issuer)
+		{
+			return failure("Token issuer not accepted");
+		}
+	}
+
+	if (!config_.audience.empty())
+	{
+		const auto* aud = find_claim(*claims, "aud");
+		bool accepted = false;
+		if (aud && aud->type == json_value::kind::string)
+		{
+			accepted = aud->text == config_.audience;
+		}
+		else if (aud && aud->type == json_value::kind::array)
+		{
+			for (const auto& entry : aud->strings)
+			{
+				accepted = accepted || entry == config_.audience;
+			}
+		}
+		if (!accepted)
+		{
+			return failure("Token audience not accepted");
+		}
+	}
+
+	const auto* sub = find_claim(*claims, "sub");
+	if (!sub || sub->type != json_value::kind::string || sub->text.empty())
+	{
+		return failure("Token has no subject");
+	}
+	if (!token.client_id.empty() && token.client_id != sub->text)
+	{
+		return failure("Token subject does not match client ID");
+	}
+
+	auth_result result;
+	result.success = true;
+	result.code = status_code::ok;
+	result.client_id = sub->text;
+	result.expires_at = expires_at.value_or(0);
+	result.issued_at = issued_at.value_or(0);
+
+	if (const auto* permissions = find_claim(*claims, config_.permissions_claim))
+	{
+		if (permissions->type == json_value::kind::array)
+		{
+			result.permissions = permissions->strings;
+		}
+		else if (permissions->type == json_value::kind::string)
+		{
+			std::string_view scope = permissions->text;
+			while (!scope.empty())
+			{
+				auto space = scope.find(' ');
+				if (space != 0)
+				{
+					result.permissions.emplace_back(scope.substr(0, space));
+				}
+				scope = space == std::string_view::npos ? std::string_view{}
+														: scope.substr(space + 1);
+			}
+		}
+	}
+
+	return result;
+}
+
+uint64_t jwt_validator::verifications() const noexcept
+{
+	return verifications_.load(std::memory_order_relaxed);
+}
+
+const jwt_config& jwt_validator::config() const noexcept
+{
+	return config_;
+}
+
+} // namespace database_server::gateway
@@ -0,0 +1,292 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file memory_governor.cpp
+ * @brief Implementation of the global memory budget
+ */
+
+#include <kcenon/database_server/gateway/memory_governor.h>
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace database_server::gateway
+{
+
+// ============================================================================
+// memory_reservation
+// ============================================================================
+
+memory_reservation::memory_reservation(memory_governor* governor, memory_subsystem subsystem,
+									   size_t bytes)
+	: governor_(governor)
+	, subsystem_(subsystem)
+	, bytes_(bytes)
+{
+}
+
+memory_reservation::~memory_reservation()
+{
+	release();
+}
+
+memory_reservation::memory_reservation(memory_reservation&& other) noexcept
+	: governor_(std::exchange(other.governor_, nullptr))
+	, subsystem_(other.subsystem_)
+	, bytes_(std::exchange(other.bytes_, 0))
+{
+}
+
+memory_reservation& memory_reservation::operator=(memory_reservation&& other) noexcept
+{
+	if (this != &other)
+	{
+		release();
+		governor_ = std::exchange(other.governor_, nullptr);
+		subsystem_ = other.subsystem_;
+		bytes_ = std::exchange(other.bytes_, 0);
+	}
+	return *this;
+}
+
+void memory_reservation::release() noexcept
+{
+	if (governor_ && bytes_ > 0)
+	{
+		governor_->release(subsystem_, bytes_);
+	}
+	governor_ = nullptr;
+	bytes_ = 0;
+}
+
+bool memory_reservation::resize(size_t bytes)
+{
+	if (!governor_ || bytes == bytes_)
+	{
+		return bytes == bytes_;
+	}
+
+	if (bytes < bytes_)
+	{
+		governor_->release(subsystem_, bytes_ - bytes);
+		bytes_ = bytes;
+		return true;
+	}
+
+	auto extra = governor_->reserve(subsystem_, bytes - bytes_);
+	if (extra.is_err())
+	{
+		return false;
+	}
+	extra.value().governor_ = nullptr;
+	bytes_ = bytes;
+	return true;
+}
+
+// ============================================================================
+// memory_governor
+// ============================================================================
+
+memory_governor::memory_governor(const memory_governor_config& config)
+	: config_(config)
+	, watermark_bytes_(static_cast<size_t>(static_cast<double>(config.budget_bytes)
+										   * std::clamp(config.pressure_ratio, 0.0, 1.0)))
+{
+}
+
+kcenon::common::Result<memory_reservation> memory_governor::reserve(memory_subsystem subsystem,
+																	size_t bytes)
+{
+	if (config_.budget_bytes == 0)
+	{
+		charge(subsystem, bytes);
+		return memory_reservation(this, subsystem, bytes);
+	}
+
+	if (!try_add(bytes, config_.budget_bytes))
+	{
+		auto total = total_.load();
+		reclaim(total + bytes > config_.budget_bytes ? total + bytes - config_.budget_bytes : 0);
+		if (!try_add(bytes, config_.budget_bytes))
+		{
+			metrics_.reservations_denied.fetch_add(1, std::memory_order_relaxed);
+			return kcenon::common::error_info{
+				-1,
+				"Memory budget exhausted: " + std::to_string(bytes) + " bytes requested for "
+					+ to_string(subsystem),
+				"memory_governor"
+			};
+		}
+	}
+	usage_[static_cast<size_t>(subsystem)].fetch_add(bytes);
+
+	// Restore headroom for the next reservation while memory is reclaimable
+	auto total = total_.load();
+	if (total > watermark_bytes_)
+	{
+		reclaim(total - watermark_bytes_);
+	}
+
+	return memory_reservation(this, subsystem, bytes);
+}
+
+bool memory_governor::try_charge(memory_subsystem subsystem, size_t bytes)
+{
+	if (config_.budget_bytes == 0)
+	{
+		charge(subsystem, bytes);
+		return true;
+	}
+
+	if (!try_add(bytes, watermark_bytes_))
+	{
+		metrics_.charges_denied.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	usage_[static_cast<size_t>(subsystem)].fetch_add(bytes);
+	return true;
+}
+
+void memory_governor::charge(memory_subsystem subsystem, size_t bytes) noexcept
+{
+	total_.fetch_add(bytes);
+	usage_[static_cast<size_t>(subsystem)].fetch_add(bytes);
+}
+
+void memory_governor::release(memory_subsystem subsystem, size_t bytes) noexcept
+{
+	usage_[static_cast<size_t>(subsystem)].fetch_sub(bytes);
+	total_.fetch_sub(bytes);
+}
+
+void memory_governor::set_reclaimer(memory_subsystem subsystem, reclaimer_t reclaimer)
+{
+	std::lock_guard<std::mutex> lock(reclaimers_mutex_);
+	reclaimers_[static_cast<size_t>(subsystem)] = std::move(reclaimer);
+}
+
+bool memory_governor::should_shed(const query_request& request)
+{
+	if (request.type != query_type::select || !under_pressure())
+	{
+		return false;
+	}
+
+	auto max_rows = request.options.max_rows;
+	if (max_rows != 0 && max_rows <= config_.large_query_rows)
+	{
+		return false;
+	}
+
+	metrics_.queries_shed.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+size_t memory_governor::estimate_result(const query_request& request) const noexcept
+{
+	if (request.type != query_type::select)
+	{
+		return sizeof(query_response);
+	}
+
+	auto rows = request.options.max_rows != 0 ? request.options.max_rows
+											   : config_.large_query_rows;
+	return sizeof(query_response) + static_cast<size_t>(rows) * config_.result_row_bytes;
+}
+
+bool memory_governor::under_pressure() const noexcept
+{
+	return config_.budget_bytes > 0 && total_.load() > watermark_bytes_;
+}
+
+size_t memory_governor::usage(memory_subsystem subsystem) const noexcept
+{
+	return usage_[static_cast<size_t>(subsystem)].load();
+}
+
+size_t memory_governor::total_usage() const noexcept
+{
+	return total_.load();
+}
+
+const memory_governor_metrics& memory_governor::metrics() const noexcept
+{
+	return metrics_;
+}
+
+const memory_governor_config& memory_governor::config() const noexcept
+{
+	return config_;
+}
+
+bool memory_governor::try_add(size_t bytes, size_t limit) noexcept
+{
+	auto total = total_.load();
+	do
+	{
+		if (total + bytes > limit)
+		{
+			return false;
+		}
+	} while (!total_.compare_exchange_weak(total, total + bytes));
+	return true;
+}
+
+size_t memory_governor::reclaim(size_t bytes)
+{
+	if (bytes == 0)
+	{
+		return 0;
+	}
+
+	// Held while calling so a subsystem can unregister before it is destroyed
+	std::lock_guard<std::mutex> lock(reclaimers_mutex_);
+
+	size_t freed = 0;
+	for (const auto& reclaimer : reclaimers_)
+	{
+		if (freed >= bytes)
+		{
+			break;
+		}
+		if (reclaimer)
+		{
+			freed += reclaimer(bytes - freed);
+		}
+	}
+
+	metrics_.bytes_reclaimed.fetch_add(freed, std::memory_order_relaxed);
+	return freed;
+}
+
+} // namespace database_server::gateway
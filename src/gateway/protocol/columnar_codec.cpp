@@ -0,0 +1,657 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file columnar_codec.cpp
+ * @brief Column-by-column encoding of result rows
+ *
+ * The encoder picks one encoding per column from the non-NULL cells:
+ * a column whose cells share one type gets the typed encoding for it,
+ * string columns with few distinct values are dictionary encoded, and
+ * integer columns are stored as fixed-width offsets from their minimum
+ * or, when non-decreasing and narrower that way, as deltas.
+ */
+
+#include "columnar_codec.h"
+
+#include <algorithm>
+#include <string_view>
+#include <unordered_map>
+
+namespace database_server::gateway::detail
+{
+
+namespace
+{
+
+/// A dictionary is used when each distinct string occurs this often on average
+constexpr size_t dictionary_min_repeats = 2;
+
+/// Largest dictionary (indices stay within 2 bytes)
+constexpr size_t dictionary_max_entries = 65536;
+
+uint8_t width_for(uint64_t max_value) noexcept
+{
+	if (max_value <= 0xff)
+	{
+		return 1;
+	}
+	if (max_value <= 0xffff)
+	{
+		return 2;
+	}
+	if (max_value <= 0xffffffff)
+	{
+		return 4;
+	}
+	return 8;
+}
+
+template<size_t Width>
+void pack_fixed(const uint64_t* values, size_t count, uint8_t* out) noexcept
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		for (size_t b = 0; b < Width; ++b)
+		{
+			out[i * Width + b] = static_cast<uint8_t>(values[i] >> (8 * b));
+		}
+	}
+}
+
+template<size_t Width>
+void unpack_fixed(const uint8_t* in, size_t count, uint64_t* values) noexcept
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		uint64_t value = 0;
+		for (size_t b = 0; b < Width; ++b)
+		{
+			value |= static_cast<uint64_t>(in[i * Width + b]) << (8 * b);
+		}
+		values[i] = value;
+	}
+}
+
+void pack_into(wire_writer& writer, std::span<const uint64_t> values, uint8_t width)
+{
+	auto& out = writer.buffer();
+	size_t offset = out.size();
+	out.resize(offset + values.size() * width);
+	uint8_t* dest = out.data() + offset;
+
+	switch (width)
+	{
+	case 1:
+		pack_fixed<1>(values.data(), values.size(), dest);
+		break;
+	case 2:
+		pack_fixed<2>(values.data(), values.size(), dest);
+		break;
+	case 4:
+		pack_fixed<4>(values.data(), values.size(), dest);
+		break;
+	default:
+		pack_fixed<8>(values.data(), values.size(), dest);
+		break;
+	}
+}
+
+std::vector<uint64_t> unpack_from(wire_reader& reader, size_t count, uint8_t width)
+{
+	if (width != 1 && width != 2 && width != 4 && width != 8)
+	{
+		reader.fail();
+		return {};
+	}
+	if (count > reader.remaining() / width)
+	{
+		reader.fail();
+		return {};
+	}
+
+	auto raw = reader.get_raw(count * width);
+	std::vector<uint64_t> values(count);
+	switch (width)
+	{
+	case 1:
+		unpack_fixed<1>(raw.data(), count, values.data());
+		break;
+	case 2:
+		unpack_fixed<2>(raw.data(), count, values.data());
+		break;
+	case 4:
+		unpack_fixed<4>(raw.data(), count, values.data());
+		break;
+	default:
+		unpack_fixed<8>(raw.data(), count, values.data());
+		break;
+	}
+	return values;
+}
+
+/**
+ * @brief Write values at the narrowest width that holds the largest one
+ */
+void put_fixed(wire_writer& writer, std::span<const uint64_t> values)
+{
+	uint64_t max_value = 0;
+	for (uint64_t value : values)
+	{
+		max_value = std::max(max_value, value);
+	}
+	uint8_t width = width_for(max_value);
+	writer.put_u8(width);
+	pack_into(writer, values, width);
+}
+
+std::vector<uint64_t> get_fixed(wire_reader& reader, size_t count)
+{
+	uint8_t width = reader.get_u8();
+	return unpack_from(reader, count, width);
+}
+
+size_t bitmap_size(size_t bits) noexcept
+{
+	return bits / 8 + (bits % 8 != 0 ? 1 : 0);
+}
+
+void put_bitmap(wire_writer& writer, const std::vector<uint8_t>& flags)
+{
+	auto& out = writer.buffer();
+	size_t offset = out.size();
+	out.resize(offset + bitmap_size(flags.size()), 0);
+	for (size_t i = 0; i < flags.size(); ++i)
+	{
+		out[offset + i / 8] |= static_cast<uint8_t>((flags[i] & 1) << (i % 8));
+	}
+}
+
+std::vector<uint8_t> get_bitmap(wire_reader& reader, size_t count)
+{
+	auto raw = reader.get_raw(bitmap_size(count));
+	if (reader.failed())
+	{
+		return {};
+	}
+	std::vector<uint8_t> flags(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		flags[i] = (raw[i / 8] >> (i % 8)) & 1;
+	}
+	return flags;
+}
+
+/**
+ * @brief Integer column: frame-of-reference, or deltas when that is narrower
+ */
+void put_int_column(wire_writer& writer, std::vector<uint64_t>& values, uint8_t has_nulls,
+					const std::vector<uint8_t>& nulls)
+{
+	auto as_signed = [](uint64_t value) { return static_cast<int64_t>(value); };
+
+	int64_t min_value = as_signed(values.front());
+	int64_t max_value = min_value;
+	uint64_t max_delta = 0;
+	bool non_decreasing = true;
+	for (size_t i = 1; i < values.size(); ++i)
+	{
+		int64_t value = as_signed(values[i]);
+		min_value = std::min(min_value, value);
+		max_value = std::max(max_value, value);
+		if (value < as_signed(values[i - 1]))
+		{
+			non_decreasing = false;
+		}
+		else
+		{
+			max_delta = std::max(max_delta, values[i] - values[i - 1]);
+		}
+	}
+
+	uint64_t range = static_cast<uint64_t>(max_value) - static_cast<uint64_t>(min_value);
+	bool use_delta = non_decreasing && values.size() > 1 && width_for(max_delta) < width_for(range);
+
+	writer.put_u8(static_cast<uint8_t>(use_delta ? column_encoding::int_delta
+												 : column_encoding::int_frame));
+	writer.put_u8(has_nulls);
+	if (has_nulls)
+	{
+		put_bitmap(writer, nulls);
+	}
+
+	if (use_delta)
+	{
+		writer.put_signed(as_signed(values.front()));
+		for (size_t i = values.size() - 1; i > 0; --i)
+		{
+			values[i] -= values[i - 1];
+		}
+		put_fixed(writer, std::span<const uint64_t>(values).subspan(1));
+	}
+	else
+	{
+		writer.put_signed(min_value);
+		for (auto& value : values)
+		{
+			value -= static_cast<uint64_t>(min_value);
+		}
+		put_fixed(writer, values);
+	}
+}
+
+/**
+ * @brief String or binary column, dictionary encoded when values repeat
+ */
+template<typename T>
+void put_text_column(wire_writer& writer, const std::vector<const result_row::cell_value*>& cells,
+					 uint8_t has_nulls, const std::vector<uint8_t>& nulls)
+{
+	auto view_of = [](const result_row::cell_value* cell)
+	{
+		const auto& value = std::get<T>(*cell);
+		return std::string_view(reinterpret_cast<const char*>(value.data()), value.size());
+	};
+
+	std::unordered_map<std::string_view, uint64_t> dictionary;
+	std::vector<std::string_view> entries;
+	std::vector<uint64_t> indices;
+	bool use_dictionary = false;
+
+	if constexpr (std::is_same_v<T, std::string>)
+	{
+		size_t limit = std::min(cells.size() / dictionary_min_repeats, dictionary_max_entries);
+		use_dictionary = limit > 0;
+		indices.reserve(cells.size());
+		for (const auto* cell : cells)
+		{
+			auto [it, inserted] = dictionary.try_emplace(view_of(cell), entries.size());
+			if (inserted)
+			{
+				entries.push_back(it->first);
+				if (entries.size() > limit)
+				{
+					use_dictionary = false;
+					break;
+				}
+			}
+			indices.push_back(it->second);
+		}
+	}
+
+	auto encoding = use_dictionary ? column_encoding::string_dict
+					: std::is_same_v<T, std::string> ? column_encoding::string
+													 : column_encoding::bytes;
+	writer.put_u8(static_cast<uint8_t>(encoding));
+	writer.put_u8(has_nulls);
+	if (has_nulls)
+	{
+		put_bitmap(writer, nulls);
+	}
+
+	if (use_dictionary)
+	{
+		writer.put_varint(entries.size());
+		for (auto entry : entries)
+		{
+			writer.put_string(entry);
+		}
+		put_fixed(writer, indices);
+		return;
+	}
+
+	std::vector<uint64_t> lengths;
+	lengths.reserve(cells.size());
+	for (const auto* cell : cells)
+	{
+		lengths.push_back(view_of(cell).size());
+	}
+	put_fixed(writer, lengths);
+	for (const auto* cell : cells)
+	{
+		auto view = view_of(cell);
+		writer.put_raw(view.data(), view.size());
+	}
+}
+
+void put_column(wire_writer& writer, const std::vector<result_row>& rows, size_t column)
+{
+	std::vector<uint8_t> nulls(rows.size(), 0);
+	std::vector<const result_row::cell_value*> cells;
+	cells.reserve(rows.size());
+
+	// Alternative shared by all non-NULL cells (variant_npos when mixed or none)
+	size_t kind = std::variant_npos;
+	bool mixed = false;
+	for (size_t i = 0; i < rows.size(); ++i)
+	{
+		const auto& cell = rows[i].cells[column];
+		if (std::holds_alternative<std::monostate>(cell))
+		{
+			nulls[i] = 1;
+			continue;
+		}
+		if (kind == std::variant_npos)
+		{
+			kind = cell.index();
+		}
+		else if (kind != cell.index())
+		{
+			mixed = true;
+		}
+		cells.push_back(&cell);
+	}
+
+	uint8_t has_nulls = cells.size() < rows.size() ? 1 : 0;
+	if (mixed)
+	{
+		kind = std::variant_npos;
+	}
+
+	auto put_header = [&](column_encoding encoding)
+	{
+		writer.put_u8(static_cast<uint8_t>(encoding));
+		writer.put_u8(has_nulls);
+		if (has_nulls)
+		{
+			put_bitmap(writer, nulls);
+		}
+	};
+
+	if (kind == 1) // bool
+	{
+		put_header(column_encoding::boolean);
+		std::vector<uint8_t> flags;
+		flags.reserve(cells.size());
+		for (const auto* cell : cells)
+		{
+			flags.push_back(std::get<bool>(*cell) ? 1 : 0);
+		}
+		put_bitmap(writer, flags);
+	}
+	else if (kind == 2) // int64_t
+	{
+		std::vector<uint64_t> values;
+		values.reserve(cells.size());
+		for (const auto* cell : cells)
+		{
+			values.push_back(static_cast<uint64_t>(std::get<int64_t>(*cell)));
+		}
+		put_int_column(writer, values, has_nulls, nulls);
+	}
+	else if (kind == 3) // double
+	{
+		put_header(column_encoding::float64);
+		std::vector<uint64_t> bits;
+		bits.reserve(cells.size());
+		for (const auto* cell : cells)
+		{
+			bits.push_back(std::bit_cast<uint64_t>(std::get<double>(*cell)));
+		}
+		pack_into(writer, bits, 8);
+	}
+	else if (kind == 4) // std::string
+	{
+		put_text_column<std::string>(writer, cells, has_nulls, nulls);
+	}
+	else if (kind == 5) // std::vector<uint8_t>
+	{
+		put_text_column<std::vector<uint8_t>>(writer, cells, has_nulls, nulls);
+	}
+	else
+	{
+		put_header(column_encoding::values);
+		for (const auto* cell : cells)
+		{
+			put_tagged_value(writer, *cell);
+		}
+	}
+}
+
+/**
+ * @brief Store the next non-NULL value of a column in each row whose cell is not NULL
+ */
+template<typename ValueAt>
+void scatter(std::vector<result_row>& rows, size_t column, const std::vector<uint8_t>& nulls,
+			 ValueAt&& value_at)
+{
+	size_t next = 0;
+	for (size_t i = 0; i < rows.size(); ++i)
+	{
+		if (nulls.empty() || nulls[i] == 0)
+		{
+			rows[i].cells[column] = value_at(next++);
+		}
+	}
+}
+
+std::vector<std::string_view> get_text_values(wire_reader& reader, size_t count)
+{
+	auto lengths = get_fixed(reader, count);
+	std::vector<std::string_view> values;
+	values.reserve(lengths.size());
+	for (uint64_t length : lengths)
+	{
+		auto raw = reader.get_raw(length);
+		values.emplace_back(reinterpret_cast<const char*>(raw.data()), raw.size());
+	}
+	return values;
+}
+
+void get_column(wire_reader& reader, std::vector<result_row>& rows, size_t column)
+{
+	auto encoding = static_cast<column_encoding>(reader.get_u8());
+	bool has_nulls = reader.get_u8() != 0;
+
+	std::vector<uint8_t> nulls;
+	size_t count = rows.size();
+	if (has_nulls)
+	{
+		nulls = get_bitmap(reader, rows.size());
+		count -= static_cast<size_t>(std::count(nulls.begin(), nulls.end(), uint8_t{ 1 }));
+	}
+	if (reader.failed())
+	{
+		return;
+	}
+
+	switch (encoding)
+	{
+	case column_encoding::values:
+		scatter(rows, column, nulls,
+				[&](size_t) { return get_tagged_value<result_row::cell_value>(reader); });
+		break;
+	case column_encoding::boolean:
+	{
+		auto flags = get_bitmap(reader, count);
+		if (!reader.failed())
+		{
+			scatter(rows, column, nulls, [&](size_t i) { return flags[i] != 0; });
+		}
+		break;
+	}
+	case column_encoding::int_frame:
+	{
+		uint64_t base = static_cast<uint64_t>(reader.get_signed());
+		auto offsets = get_fixed(reader, count);
+		if (!reader.failed())
+		{
+			scatter(rows, column, nulls,
+					[&](size_t i) { return static_cast<int64_t>(base + offsets[i]); });
+		}
+		break;
+	}
+	case column_encoding::int_delta:
+	{
+		if (count == 0)
+		{
+			reader.fail();
+			break;
+		}
+		uint64_t value = static_cast<uint64_t>(reader.get_signed());
+		auto deltas = get_fixed(reader, count - 1);
+		if (!reader.failed())
+		{
+			scatter(rows, column, nulls,
+					[&](size_t i)
+					{
+						if (i > 0)
+						{
+							value += deltas[i - 1];
+						}
+						return static_cast<int64_t>(value);
+					});
+		}
+		break;
+	}
+	case column_encoding::float64:
+	{
+		auto bits = unpack_from(reader, count, 8);
+		if (!reader.failed())
+		{
+			scatter(rows, column, nulls,
+					[&](size_t i) { return std::bit_cast<double>(bits[i]); });
+		}
+		break;
+	}
+	case column_encoding::string:
+	{
+		auto values = get_text_values(reader, count);
+		if (!reader.failed())
+		{
+			scatter(rows, column, nulls, [&](size_t i) { return std::string(values[i]); });
+		}
+		break;
+	}
+	case column_encoding::bytes:
+	{
+		auto values = get_text_values(reader, count);
+		if (!reader.failed())
+		{
+			scatter(rows, column, nulls,
+					[&](size_t i)
+					{
+						return std::vector<uint8_t>(values[i].begin(), values[i].end());
+					});
+		}
+		break;
+	}
+	case column_encoding::string_dict:
+	{
+		std::vector<std::string_view> entries(reader.get_length());
+		for (auto& entry : entries)
+		{
+			entry = reader.get_string_view();
+		}
+		auto indices = get_fixed(reader, count);
+		if (reader.failed())
+		{
+			break;
+		}
+		for (uint64_t index : indices)
+		{
+			if (index >= entries.size())
+			{
+				reader.fail();
+				return;
+			}
+		}
+		scatter(rows, column, nulls,
+				[&](size_t i) { return std::string(entries[indices[i]]); });
+		break;
+	}
+	default:
+		reader.fail();
+		break;
+	}
+}
+
+} // namespace
+
+bool is_columnar_compatible(const std::vector<result_row>& rows) noexcept
+{
+	if (rows.empty() || rows.front().cells.empty())
+	{
+		return false;
+	}
+	size_t columns = rows.front().cells.size();
+	return std::all_of(rows.begin(), rows.end(),
+					   [columns](const result_row& row) { return row.cells.size() == columns; });
+}
+
+void put_columnar_rows(wire_writer& writer, const std::vector<result_row>& rows)
+{
+	size_t columns = rows.empty() ? 0 : rows.front().cells.size();
+	writer.put_varint(rows.size());
+	writer.put_varint(columns);
+	for (size_t column = 0; column < columns; ++column)
+	{
+		put_column(writer, rows, column);
+	}
+}
+
+std::vector<result_row> get_columnar_rows(wire_reader& reader)
+{
+	uint64_t row_count = reader.get_varint();
+	// Encoding and null flag per column
+	size_t columns = reader.get_length(2);
+	if (reader.failed())
+	{
+		return {};
+	}
+
+	// Every column spends at least one bit per row, so the input bounds both counts
+	uint64_t min_column_size = row_count / 8 + (row_count % 8 != 0 ? 1 : 0);
+	if (row_count > 0
+		&& (columns == 0 || min_column_size > reader.remaining() / columns))
+	{
+		reader.fail();
+		return {};
+	}
+
+	std::vector<result_row> rows(static_cast<size_t>(row_count));
+	for (auto& row : rows)
+	{
+		row.cells.resize(columns);
+	}
+	for (size_t column = 0; column < columns && !reader.failed(); ++column)
+	{
+		get_column(reader, rows, column);
+	}
+
+	if (reader.failed())
+	{
+		return {};
+	}
+	return rows;
+}
+
+} // namespace database_server::gateway::detail
@@ -0,0 +1,89 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file columnar_codec.h
+ * @brief Columnar layout of result rows in v2 frames
+ *
+ * A columnar rows section stores each column as one block:
+ *
+ * @code
+ * rows     := row count varint | column count varint | column...
+ * column   := encoding u8 | has_nulls u8 | [null bitmap] | payload
+ * @endcode
+ *
+ * The null bitmap has one bit per row (LSB first, set = NULL) and the
+ * payload holds only the non-NULL cells. Integers, lengths and dictionary
+ * indices are stored at a fixed byte width chosen per column (1, 2, 4 or
+ * 8), so packing and unpacking are plain loops over contiguous arrays.
+ */
+
+#pragma once
+
+#include "wire_codec.h"
+
+#include <vector>
+
+namespace database_server::gateway::detail
+{
+
+/**
+ * @enum column_encoding
+ * @brief Payload format of one column block
+ */
+enum class column_encoding : uint8_t
+{
+	values = 0,      ///< Type-tagged cells (mixed types or all NULL)
+	boolean = 1,     ///< Bit-packed values
+	int_frame = 2,   ///< Minimum, then fixed-width offsets from it
+	int_delta = 3,   ///< First value, then fixed-width deltas (non-decreasing columns)
+	float64 = 4,     ///< 8-byte little-endian doubles
+	string = 5,      ///< Fixed-width lengths, then the concatenated bytes
+	string_dict = 6, ///< Distinct strings, then fixed-width indices into them
+	bytes = 7        ///< Like string, for binary cells
+};
+
+/**
+ * @brief Whether rows can be laid out by column (same non-zero cell count)
+ */
+[[nodiscard]] bool is_columnar_compatible(const std::vector<result_row>& rows) noexcept;
+
+/**
+ * @brief Write rows column by column (rows must be columnar compatible)
+ */
+void put_columnar_rows(wire_writer& writer, const std::vector<result_row>& rows);
+
+/**
+ * @brief Read rows written by put_columnar_rows()
+ */
+[[nodiscard]] std::vector<result_row> get_columnar_rows(wire_reader& reader);
+
+} // namespace database_server::gateway::detail
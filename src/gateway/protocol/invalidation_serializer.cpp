@@ -0,0 +1,199 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file invalidation_serializer.cpp
+ * @brief Implementation of invalidation_event serialization
+ */
+
+#include "serialization_helpers.h"
+
+#include <kcenon/database_server/gateway/wire_format.h>
+
+namespace database_server::gateway
+{
+
+std::shared_ptr<container_module::value_container> invalidation_event::serialize() const
+{
+#if KCENON_WITH_CONTAINER_SYSTEM
+	auto container = std::make_shared<container_module::value_container>();
+	container->set_message_type("invalidation_event");
+
+	// Header
+	container->set("version", static_cast<int>(header.version));
+	container->set("message_id", static_cast<long long>(header.message_id));
+	container->set("timestamp", static_cast<long long>(header.timestamp));
+	container->set("correlation_id", header.correlation_id);
+
+	// Event
+	container->set("sequence", static_cast<long long>(sequence));
+	container->set("resync", resync);
+
+	container->set("tables_count", static_cast<int>(tables.size()));
+	for (size_t i = 0; i < tables.size(); ++i)
+	{
+		container->set("table_" + std::to_string(i), tables[i]);
+	}
+
+	container->set("keys_count", static_cast<int>(cache_keys.size()));
+	for (size_t i = 0; i < cache_keys.size(); ++i)
+	{
+		container->set("key_" + std::to_string(i), cache_keys[i]);
+	}
+
+	return container;
+#else
+	return nullptr;
+#endif
+}
+
+kcenon::common::Result<invalidation_event>
+invalidation_event::deserialize(std::shared_ptr<container_module::value_container> container)
+{
+#if KCENON_WITH_CONTAINER_SYSTEM
+	if (!container)
+	{
+		return kcenon::common::error_info{ -1, "Null container", "query_protocol" };
+	}
+
+	invalidation_event event;
+
+	// Header
+	if (auto val = container->get("version"))
+	{
+		if (std::holds_alternative<int>(val->data))
+		{
+			event.header.version = static_cast<uint32_t>(std::get<int>(val->data));
+		}
+	}
+	if (auto val = container->get("message_id"))
+	{
+		if (std::holds_alternative<long long>(val->data))
+		{
+			event.header.message_id = static_cast<uint64_t>(std::get<long long>(val->data));
+		}
+	}
+	if (auto val = container->get("timestamp"))
+	{
+		if (std::holds_alternative<long long>(val->data))
+		{
+			event.header.timestamp = static_cast<uint64_t>(std::get<long long>(val->data));
+		}
+	}
+	if (auto val = container->get("correlation_id"))
+	{
+		if (std::holds_alternative<std::string>(val->data))
+		{
+			event.header.correlation_id = std::get<std::string>(val->data);
+		}
+	}
+
+	// Event
+	if (auto val = container->get("sequence"))
+	{
+		if (std::holds_alternative<long long>(val->data))
+		{
+			event.sequence = static_cast<uint64_t>(std::get<long long>(val->data));
+		}
+	}
+	if (auto val = container->get("resync"))
+	{
+		if (std::holds_alternative<bool>(val->data))
+		{
+			event.resync = std::get<bool>(val->data);
+		}
+	}
+
+	int tables_count = 0;
+	if (auto val = container->get("tables_count"))
+	{
+		if (std::holds_alternative<int>(val->data))
+		{
+			tables_count = std::get<int>(val->data);
+		}
+	}
+	for (int i = 0; i < tables_count; ++i)
+	{
+		if (auto val = container->get("table_" + std::to_string(i)))
+		{
+			if (std::holds_alternative<std::string>(val->data))
+			{
+				event.tables.push_back(std::get<std::string>(val->data));
+			}
+		}
+	}
+
+	int keys_count = 0;
+	if (auto val = container->get("keys_count"))
+	{
+		if (std::holds_alternative<int>(val->data))
+		{
+			keys_count = std::get<int>(val->data);
+		}
+	}
+	for (int i = 0; i < keys_count; ++i)
+	{
+		if (auto val = container->get("key_" + std::to_string(i)))
+		{
+			if (std::holds_alternative<std::string>(val->data))
+			{
+				event.cache_keys.push_back(std::get<std::string>(val->data));
+			}
+		}
+	}
+
+	return event;
+#else
+	return kcenon::common::error_info{
+		-2, "container_system not available", "query_protocol"
+	};
+#endif
+}
+
+kcenon::common::Result<invalidation_event>
+invalidation_event::deserialize(const std::vector<uint8_t>& data)
+{
+	if (is_wire_v2(data))
+	{
+		return decode_event_v2(data);
+	}
+
+#if KCENON_WITH_CONTAINER_SYSTEM
+	auto container = std::make_shared<container_module::value_container>(data, false);
+	return deserialize(container);
+#else
+	return kcenon::common::error_info{
+		-2, "container_system not available", "query_protocol"
+	};
+#endif
+}
+
+} // namespace database_server::gateway
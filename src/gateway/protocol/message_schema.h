@@ -0,0 +1,465 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file message_schema.h
+ * @brief Field descriptor tables for the protocol messages
+ *
+ * Each message struct lists its scalar fields once in message_schema<T>:
+ * the member, its v1 container key, its field id and the formats it takes
+ * part in. put_fields()/get_fields() expand the table at compile time into
+ * container set/get calls for v1 and into wire_writer/wire_reader calls for
+ * v2, so adding a field means adding one descriptor.
+ *
+ * v1 storage types follow the member type: bool, std::string and byte
+ * vectors are stored as-is, 64-bit integers as long long, and 32-bit
+ * integers and enums as int. v2 frames are positional: fields are written
+ * in id order, so new fields take the next id and are appended.
+ * query_request_view::parse() reads the same order without copying.
+ *
+ * Collections (params, columns, rows, delta) and v2 option flags are not
+ * scalar fields and stay with the message serializers.
+ */
+
+#pragma once
+
+#include "wire_codec.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+namespace database_server::gateway::detail
+{
+
+/**
+ * @brief Formats a field is serialized in
+ */
+enum field_format : uint8_t
+{
+	format_v1 = 0x01,
+	format_v2 = 0x02,
+	format_all = format_v1 | format_v2
+};
+
+/**
+ * @brief FNV-1a hash of a container key, evaluated at compile time
+ */
+constexpr uint32_t schema_key_hash(std::string_view key) noexcept
+{
+	uint32_t hash = 2166136261u;
+	for (char c : key)
+	{
+		hash ^= static_cast<uint8_t>(c);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+template <typename T>
+struct member_pointer_traits;
+
+template <typename Owner, typename Member>
+struct member_pointer_traits<Member Owner::*>
+{
+	using owner_type = Owner;
+	using value_type = Member;
+};
+
+/**
+ * @struct field
+ * @brief Describes one scalar member of a message
+ *
+ * @tparam Member Pointer to the described data member
+ */
+template <auto Member>
+struct field
+{
+	using owner_type = typename member_pointer_traits<decltype(Member)>::owner_type;
+	using value_type = typename member_pointer_traits<decltype(Member)>::value_type;
+
+	std::string_view key;             ///< v1 container key
+	uint8_t id = 0;                   ///< Position among the message's fields
+	uint8_t formats = format_all;     ///< field_format bits
+	bool (*present)(const owner_type&) = nullptr; ///< v1 only: omit the key when false
+
+	[[nodiscard]] constexpr uint32_t key_hash() const noexcept { return schema_key_hash(key); }
+
+	static const value_type& get(const owner_type& owner) noexcept { return owner.*Member; }
+	static value_type& get(owner_type& owner) noexcept { return owner.*Member; }
+};
+
+/**
+ * @brief Field table of a message, specialized per struct
+ */
+template <typename T>
+struct message_schema;
+
+template <>
+struct message_schema<message_header>
+{
+	// The v2 frame carries the version in its magic
+	static constexpr auto fields = std::tuple{
+		field<&message_header::version>{ "version", 0, format_v1 },
+		field<&message_header::message_id>{ "message_id", 1 },
+		field<&message_header::timestamp>{ "timestamp", 2 },
+		field<&message_header::correlation_id>{ "correlation_id", 3 },
+	};
+};
+
+template <>
+struct message_schema<auth_token>
+{
+	static constexpr auto fields = std::tuple{
+		field<&auth_token::token>{ "auth_token", 0 },
+		field<&auth_token::client_id>{ "client_id", 1 },
+		field<&auth_token::expires_at>{ "token_expires", 2 },
+	};
+};
+
+template <>
+struct message_schema<query_options>
+{
+	// v2 packs the booleans into one flags byte, see wire_v2_serializer.cpp
+	static constexpr auto fields = std::tuple{
+		field<&query_options::timeout_ms>{ "timeout_ms", 0, format_v1 },
+		field<&query_options::read_only>{ "read_only", 1, format_v1 },
+		field<&query_options::isolation_level>{ "isolation_level", 2, format_v1 },
+		field<&query_options::max_rows>{ "max_rows", 3, format_v1 },
+		field<&query_options::include_metadata>{ "include_metadata", 4, format_v1 },
+		field<&query_options::delta_key_column>{
+			"delta_key_column", 5, format_v1,
+			[](const query_options& options) { return !options.delta_key_column.empty(); } },
+		field<&query_options::delta_base_version>{
+			"delta_base_version", 6, format_v1,
+			[](const query_options& options) { return !options.delta_key_column.empty(); } },
+	};
+};
+
+template <>
+struct message_schema<blob_chunk>
+{
+	static constexpr auto fields = std::tuple{
+		field<&blob_chunk::upload_id>{ "chunk_upload_id", 0 },
+		field<&blob_chunk::offset>{ "chunk_offset", 1 },
+		field<&blob_chunk::data>{ "chunk_data", 2 },
+		field<&blob_chunk::last>{ "chunk_last", 3 },
+	};
+};
+
+template <>
+struct message_schema<query_request>
+{
+	static constexpr auto fields = std::tuple{
+		field<&query_request::type>{ "query_type", 0 },
+		field<&query_request::sql>{ "sql", 1 },
+	};
+};
+
+template <>
+struct message_schema<column_metadata>
+{
+	static constexpr auto fields = std::tuple{
+		field<&column_metadata::name>{ "name", 0 },
+		field<&column_metadata::type_name>{ "type_name", 1 },
+		field<&column_metadata::type_id>{ "type_id", 2 },
+		field<&column_metadata::nullable>{ "nullable", 3 },
+		field<&column_metadata::precision>{ "precision", 4 },
+		field<&column_metadata::scale>{ "scale", 5 },
+	};
+};
+
+template <>
+struct message_schema<query_response>
+{
+	static constexpr auto fields = std::tuple{
+		field<&query_response::status>{ "status", 0 },
+		field<&query_response::error_message>{ "error_message", 1 },
+		field<&query_response::affected_rows>{ "affected_rows", 2 },
+		field<&query_response::execution_time_us>{ "execution_time_us", 3 },
+		field<&query_response::result_version>{ "result_version", 4 },
+	};
+};
+
+template <typename T, typename Visitor>
+constexpr void for_each_field(Visitor&& visitor)
+{
+	std::apply([&](const auto&... fields) { (visitor(fields), ...); },
+			   message_schema<T>::fields);
+}
+
+/**
+ * @brief Check that field ids ascend from zero in table order
+ */
+template <typename T>
+constexpr bool schema_ids_ordered()
+{
+	bool ordered = true;
+	int expected = 0;
+	for_each_field<T>([&](const auto& f) { ordered = ordered && f.id == expected++; });
+	return ordered;
+}
+
+/**
+ * @brief Check that the v1 keys of messages sharing one container are distinct
+ */
+template <typename... Ts>
+constexpr bool schema_keys_unique()
+{
+	constexpr size_t count
+		= (std::tuple_size_v<std::remove_cv_t<decltype(message_schema<Ts>::fields)>> + ... + 0);
+	std::array<uint32_t, count> hashes{};
+	size_t used = 0;
+	auto collect = [&](const auto& f)
+	{
+		if (f.formats & format_v1)
+		{
+			hashes[used++] = f.key_hash();
+		}
+	};
+	(for_each_field<Ts>(collect), ...);
+
+	for (size_t i = 0; i < used; ++i)
+	{
+		for (size_t j = i + 1; j < used; ++j)
+		{
+			if (hashes[i] == hashes[j])
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static_assert(schema_ids_ordered<message_header>() && schema_ids_ordered<auth_token>()
+			  && schema_ids_ordered<query_options>() && schema_ids_ordered<blob_chunk>()
+			  && schema_ids_ordered<query_request>() && schema_ids_ordered<column_metadata>()
+			  && schema_ids_ordered<query_response>());
+static_assert(schema_keys_unique<message_header, auth_token, query_request, query_options,
+								 blob_chunk>(),
+			  "query_request container keys collide");
+static_assert(schema_keys_unique<message_header, query_response>(),
+			  "query_response container keys collide");
+
+// ============================================================================
+// v1 containers
+// ============================================================================
+
+/**
+ * @brief Container storage type of a member type
+ */
+template <typename V>
+using v1_storage_t = std::conditional_t<
+	std::is_same_v<V, bool> || std::is_same_v<V, std::string>
+		|| std::is_same_v<V, std::vector<uint8_t>>,
+	V,
+	std::conditional_t<sizeof(V) == 8, long long, int>>;
+
+#if KCENON_WITH_CONTAINER_SYSTEM
+
+/**
+ * @brief Key of a field as a string, built once per field
+ *
+ * Each member appears in a single table, so the field type identifies
+ * the key.
+ */
+template <typename Field>
+const std::string& v1_key(const Field& f)
+{
+	static const std::string key(f.key);
+	return key;
+}
+
+/**
+ * @brief Store the v1 fields of a message in a container
+ * @param prefix Prepended to every key (for repeated entries like columns)
+ */
+template <typename T>
+void put_fields(container_module::value_container& container, const T& message,
+				const std::string& prefix = {})
+{
+	for_each_field<T>(
+		[&](const auto& f)
+		{
+			using field_type = std::decay_t<decltype(f)>;
+			using value_type = typename field_type::value_type;
+			if (!(f.formats & format_v1) || (f.present && !f.present(message)))
+			{
+				return;
+			}
+			auto value = static_cast<v1_storage_t<value_type>>(field_type::get(message));
+			if (prefix.empty())
+			{
+				container.set(v1_key(f), value);
+			}
+			else
+			{
+				container.set(prefix + v1_key(f), value);
+			}
+		});
+}
+
+/**
+ * @brief Load the v1 fields of a message from a container
+ *
+ * Missing keys and values of the wrong type leave the member unchanged.
+ *
+ * @return Number of fields found
+ */
+template <typename T>
+size_t get_fields(const container_module::value_container& container, T& message,
+				  const std::string& prefix = {})
+{
+	size_t found = 0;
+	for_each_field<T>(
+		[&](const auto& f)
+		{
+			using field_type = std::decay_t<decltype(f)>;
+			using value_type = typename field_type::value_type;
+			using storage_type = v1_storage_t<value_type>;
+			if (!(f.formats & format_v1))
+			{
+				return;
+			}
+			auto val = prefix.empty() ? container.get(v1_key(f)) : container.get(prefix + v1_key(f));
+			if (val && std::holds_alternative<storage_type>(val->data))
+			{
+				field_type::get(message)
+					= static_cast<value_type>(std::move(std::get<storage_type>(val->data)));
+				++found;
+			}
+		});
+	return found;
+}
+
+#endif // KCENON_WITH_CONTAINER_SYSTEM
+
+// ============================================================================
+// v2 frames
+// ============================================================================
+
+/**
+ * @brief Append the v2 fields of a message in id order
+ */
+template <typename T>
+void put_fields(wire_writer& writer, const T& message)
+{
+	for_each_field<T>(
+		[&](const auto& f)
+		{
+			using field_type = std::decay_t<decltype(f)>;
+			using value_type = typename field_type::value_type;
+			if (!(f.formats & format_v2))
+			{
+				return;
+			}
+			const auto& value = field_type::get(message);
+			if constexpr (std::is_same_v<value_type, bool>)
+			{
+				writer.put_u8(value ? 1 : 0);
+			}
+			else if constexpr (std::is_same_v<value_type, std::string>)
+			{
+				writer.put_string(value);
+			}
+			else if constexpr (std::is_same_v<value_type, std::vector<uint8_t>>)
+			{
+				writer.put_bytes(value);
+			}
+			else if constexpr (std::is_enum_v<value_type> && sizeof(value_type) == 1)
+			{
+				writer.put_u8(static_cast<uint8_t>(value));
+			}
+			else
+			{
+				writer.put_varint(static_cast<uint64_t>(value));
+			}
+		});
+}
+
+/**
+ * @brief Read the v2 fields of a message in id order
+ *
+ * Out-of-range integers put the reader into its failed state.
+ */
+template <typename T>
+void get_fields(wire_reader& reader, T& message)
+{
+	for_each_field<T>(
+		[&](const auto& f)
+		{
+			using field_type = std::decay_t<decltype(f)>;
+			using value_type = typename field_type::value_type;
+			if (!(f.formats & format_v2))
+			{
+				return;
+			}
+			auto& value = field_type::get(message);
+			if constexpr (std::is_same_v<value_type, bool>)
+			{
+				value = reader.get_u8() != 0;
+			}
+			else if constexpr (std::is_same_v<value_type, std::string>)
+			{
+				value = reader.get_string();
+			}
+			else if constexpr (std::is_same_v<value_type, std::vector<uint8_t>>)
+			{
+				auto bytes = reader.get_bytes();
+				value.assign(bytes.begin(), bytes.end());
+			}
+			else if constexpr (std::is_enum_v<value_type> && sizeof(value_type) == 1)
+			{
+				value = static_cast<value_type>(reader.get_u8());
+			}
+			else
+			{
+				using integer_type = std::conditional_t<std::is_enum_v<value_type>,
+														std::underlying_type<value_type>,
+														std::type_identity<value_type>>::type;
+				uint64_t raw = reader.get_varint();
+				if (raw > std::numeric_limits<integer_type>::max())
+				{
+					reader.fail();
+					raw = 0;
+				}
+				value = static_cast<value_type>(raw);
+			}
+		});
+}
+
+} // namespace database_server::gateway::detail
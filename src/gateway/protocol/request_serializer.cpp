@@ -34,8 +34,11 @@
  * @brief Implementation of query_request serialization
  */
 
+#include "message_schema.h"
 #include "serialization_helpers.h"
 
+#include <kcenon/database_server/gateway/wire_format.h>
+
 namespace database_server::gateway
 {
 
@@ -66,31 +69,20 @@ std::shared_ptr<container_module::value_container> query_request::serialize() co
 	auto container = std::make_shared<container_module::value_container>();
 	container->set_message_type("query_request");
 
-	// Header
-	container->set("version", static_cast<int>(header.version));
-	container->set("message_id", static_cast<long long>(header.message_id));
-	container->set("timestamp", static_cast<long long>(header.timestamp));
-	container->set("correlation_id", header.correlation_id);
-
-	// Auth token
-	container->set("auth_token", token.token);
-	container->set("client_id", token.client_id);
-	container->set("token_expires", static_cast<long long>(token.expires_at));
-
-	// Query
-	container->set("query_type", static_cast<int>(type));
-	container->set("sql", sql);
-
-	// Options
-	container->set("timeout_ms", static_cast<int>(options.timeout_ms));
-	container->set("read_only", options.read_only);
-	container->set("isolation_level", options.isolation_level);
-	container->set("max_rows", static_cast<int>(options.max_rows));
-	container->set("include_metadata", options.include_metadata);
+	detail::put_fields(*container, header);
+	detail::put_fields(*container, token);
+	detail::put_fields(*container, *this);
+	detail::put_fields(*container, options);
 
 	// Parameters
 	detail::serialize_params(container, params);
 
+	// Upload chunk
+	if (chunk)
+	{
+		detail::put_fields(*container, *chunk);
+	}
+
 	return container;
 #else
 	return nullptr;
@@ -108,114 +100,20 @@ query_request::deserialize(std::shared_ptr<container_module::value_container> co
 
 	query_request request;
 
-	// Header
-	if (auto val = container->get("version"))
-	{
-		if (std::holds_alternative<int>(val->data))
-		{
-			request.header.version = static_cast<uint32_t>(std::get<int>(val->data));
-		}
-	}
-	if (auto val = container->get("message_id"))
-	{
-		if (std::holds_alternative<long long>(val->data))
-		{
-			request.header.message_id = static_cast<uint64_t>(std::get<long long>(val->data));
-		}
-	}
-	if (auto val = container->get("timestamp"))
-	{
-		if (std::holds_alternative<long long>(val->data))
-		{
-			request.header.timestamp = static_cast<uint64_t>(std::get<long long>(val->data));
-		}
-	}
-	if (auto val = container->get("correlation_id"))
-	{
-		if (std::holds_alternative<std::string>(val->data))
-		{
-			request.header.correlation_id = std::get<std::string>(val->data);
-		}
-	}
+	detail::get_fields(*container, request.header);
+	detail::get_fields(*container, request.token);
+	detail::get_fields(*container, request);
+	detail::get_fields(*container, request.options);
 
-	// Auth token
-	if (auto val = container->get("auth_token"))
-	{
-		if (std::holds_alternative<std::string>(val->data))
-		{
-			request.token.token = std::get<std::string>(val->data);
-		}
-	}
-	if (auto val = container->get("client_id"))
-	{
-		if (std::holds_alternative<std::string>(val->data))
-		{
-			request.token.client_id = std::get<std::string>(val->data);
-		}
-	}
-	if (auto val = container->get("token_expires"))
-	{
-		if (std::holds_alternative<long long>(val->data))
-		{
-			request.token.expires_at = static_cast<uint64_t>(std::get<long long>(val->data));
-		}
-	}
-
-	// Query
-	if (auto val = container->get("query_type"))
-	{
-		if (std::holds_alternative<int>(val->data))
-		{
-			request.type = static_cast<query_type>(std::get<int>(val->data));
-		}
-	}
-	if (auto val = container->get("sql"))
-	{
-		if (std::holds_alternative<std::string>(val->data))
-		{
-			request.sql = std::get<std::string>(val->data);
-		}
-	}
+	// Parameters
+	request.params = detail::deserialize_params(container);
 
-	// Options
-	if (auto val = container->get("timeout_ms"))
-	{
-		if (std::holds_alternative<int>(val->data))
-		{
-			request.options.timeout_ms = static_cast<uint32_t>(std::get<int>(val->data));
-		}
-	}
-	if (auto val = container->get("read_only"))
-	{
-		if (std::holds_alternative<bool>(val->data))
-		{
-			request.options.read_only = std::get<bool>(val->data);
-		}
-	}
-	if (auto val = container->get("isolation_level"))
-	{
-		if (std::holds_alternative<std::string>(val->data))
-		{
-			request.options.isolation_level = std::get<std::string>(val->data);
-		}
-	}
-	if (auto val = container->get("max_rows"))
+	// Upload chunk
+	blob_chunk chunk;
+	if (detail::get_fields(*container, chunk) > 0)
 	{
-		if (std::holds_alternative<int>(val->data))
-		{
-			request.options.max_rows = static_cast<uint32_t>(std::get<int>(val->data));
-		}
+		request.chunk = std::move(chunk);
 	}
-	if (auto val = container->get("include_metadata"))
-	{
-		if (std::holds_alternative<bool>(val->data))
-		{
-			request.options.include_metadata = std::get<bool>(val->data);
-		}
-	}
-
-	// Parameters
-	request.params = detail::deserialize_params(container);
 
 	return request;
 #else
@@ -228,6 +126,11 @@ query_request::deserialize(std::shared_ptr<container_module::value_container> co
 kcenon::common::Result<query_request>
 query_request::deserialize(const std::vector<uint8_t>& data)
 {
+	if (is_wire_v2(data))
+	{
+		return decode_request_v2(data);
+	}
+
 #if KCENON_WITH_CONTAINER_SYSTEM
 	auto container = std::make_shared<container_module::value_container>(data, false);
 	return deserialize(container);
@@ -245,7 +148,14 @@ bool query_request::is_valid() const noexcept
 		return false;
 	}
 
-	if (type != query_type::ping && sql.empty())
+	if (type == query_type::upload_chunk)
+	{
+		return chunk.has_value() && !chunk->upload_id.empty();
+	}
+
+	// Subscriptions name tables through params when no query is given
+	if (type != query_type::ping && type != query_type::subscribe
+		&& type != query_type::unsubscribe && sql.empty())
 	{
 		return false;
 	}
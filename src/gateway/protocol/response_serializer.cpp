@@ -34,8 +34,11 @@
  * @brief Implementation of query_response, column_metadata, result_row serialization
  */
 
+#include "message_schema.h"
 #include "serialization_helpers.h"
 
+#include <kcenon/database_server/gateway/wire_format.h>
+
 namespace database_server::gateway
 {
 
@@ -60,31 +63,14 @@ std::shared_ptr<container_module::value_container> query_response::serialize() c
 	auto container = std::make_shared<container_module::value_container>();
 	container->set_message_type("query_response");
 
-	// Header
-	container->set("version", static_cast<int>(header.version));
-	container->set("message_id", static_cast<long long>(header.message_id));
-	container->set("timestamp", static_cast<long long>(header.timestamp));
-	container->set("correlation_id", header.correlation_id);
-
-	// Status
-	container->set("status", static_cast<int>(status));
-	container->set("error_message", error_message);
-	container->set("affected_rows", static_cast<long long>(affected_rows));
-	container->set("execution_time_us", static_cast<long long>(execution_time_us));
+	detail::put_fields(*container, header);
+	detail::put_fields(*container, *this);
 
 	// Column metadata
 	container->set("columns_count", static_cast<int>(columns.size()));
 	for (size_t i = 0; i < columns.size(); ++i)
 	{
-		const auto& col = columns[i];
-		std::string prefix = "col_" + std::to_string(i) + "_";
-
-		container->set(prefix + "name", col.name);
-		container->set(prefix + "type_name", col.type_name);
-		container->set(prefix + "type_id", static_cast<int>(col.type_id));
-		container->set(prefix + "nullable", col.nullable);
-		container->set(prefix + "precision", static_cast<int>(col.precision));
-		container->set(prefix + "scale", static_cast<int>(col.scale));
+		detail::put_fields(*container, columns[i], "col_" + std::to_string(i) + "_");
 	}
 
 	// Rows
@@ -101,6 +87,22 @@ std::shared_ptr<container_module::value_container> query_response::serialize() c
 		}
 	}
 
+	// Delta (rows changed since delta->base_version)
+	container->set("delta_present", delta.has_value());
+	if (delta)
+	{
+		container->set("delta_base_version", static_cast<long long>(delta->base_version));
+		detail::serialize_rows(container, "delta_ins_", delta->inserted);
+		detail::serialize_rows(container, "delta_upd_", delta->updated);
+
+		container->set("delta_del_count", static_cast<int>(delta->deleted_keys.size()));
+		for (size_t i = 0; i < delta->deleted_keys.size(); ++i)
+		{
+			detail::serialize_variant_value(
+				container, "delta_del_" + std::to_string(i) + "_", delta->deleted_keys[i]);
+		}
+	}
+
 	return container;
 #else
 	return nullptr;
@@ -118,65 +120,8 @@ query_response::deserialize(std::shared_ptr<container_module::value_container> c
 
 	query_response response;
 
-	// Header
-	if (auto val = container->get("version"))
-	{
-		if (std::holds_alternative<int>(val->data))
-		{
-			response.header.version = static_cast<uint32_t>(std::get<int>(val->data));
-		}
-	}
-	if (auto val = container->get("message_id"))
-	{
-		if (std::holds_alternative<long long>(val->data))
-		{
-			response.header.message_id = static_cast<uint64_t>(std::get<long long>(val->data));
-		}
-	}
-	if (auto val = container->get("timestamp"))
-	{
-		if (std::holds_alternative<long long>(val->data))
-		{
-			response.header.timestamp = static_cast<uint64_t>(std::get<long long>(val->data));
-		}
-	}
-	if (auto val = container->get("correlation_id"))
-	{
-		if (std::holds_alternative<std::string>(val->data))
-		{
-			response.header.correlation_id = std::get<std::string>(val->data);
-		}
-	}
-
-	// Status
-	if (auto val = container->get("status"))
-	{
-		if (std::holds_alternative<int>(val->data))
-		{
-			response.status = static_cast<status_code>(std::get<int>(val->data));
-		}
-	}
-	if (auto val = container->get("error_message"))
-	{
-		if (std::holds_alternative<std::string>(val->data))
-		{
-			response.error_message = std::get<std::string>(val->data);
-		}
-	}
-	if (auto val = container->get("affected_rows"))
-	{
-		if (std::holds_alternative<long long>(val->data))
-		{
-			response.affected_rows = static_cast<uint64_t>(std::get<long long>(val->data));
-		}
-	}
-	if (auto val = container->get("execution_time_us"))
-	{
-		if (std::holds_alternative<long long>(val->data))
-		{
-			response.execution_time_us = static_cast<uint64_t>(std::get<long long>(val->data));
-		}
-	}
+	detail::get_fields(*container, response.header);
+	detail::get_fields(*container, response);
 
 	// Column metadata
 	int columns_count = 0;
@@ -190,52 +135,8 @@ query_response::deserialize(std::shared_ptr<container_module::value_container> c
 
 	for (int i = 0; i < columns_count; ++i)
 	{
-		std::string prefix = "col_" + std::to_string(i) + "_";
 		column_metadata col;
-
-		if (auto val = container->get(prefix + "name"))
-		{
-			if (std::holds_alternative<std::string>(val->data))
-			{
-				col.name = std::get<std::string>(val->data);
-			}
-		}
-		if (auto val = container->get(prefix + "type_name"))
-		{
-			if (std::holds_alternative<std::string>(val->data))
-			{
-				col.type_name = std::get<std::string>(val->data);
-			}
-		}
-		if (auto val = container->get(prefix + "type_id"))
-		{
-			if (std::holds_alternative<int>(val->data))
-			{
-				col.type_id = static_cast<uint32_t>(std::get<int>(val->data));
-			}
-		}
-		if (auto val = container->get(prefix + "nullable"))
-		{
-			if (std::holds_alternative<bool>(val->data))
-			{
-				col.nullable = std::get<bool>(val->data);
-			}
-		}
-		if (auto val = container->get(prefix + "precision"))
-		{
-			if (std::holds_alternative<int>(val->data))
-			{
-				col.precision = static_cast<uint32_t>(std::get<int>(val->data));
-			}
-		}
-		if (auto val = container->get(prefix + "scale"))
-		{
-			if (std::holds_alternative<int>(val->data))
-			{
-				col.scale = static_cast<uint32_t>(std::get<int>(val->data));
-			}
-		}
-
+		detail::get_fields(*container, col, "col_" + std::to_string(i) + "_");
 		response.columns.push_back(std::move(col));
 	}
 
@@ -264,6 +165,47 @@ query_response::deserialize(std::shared_ptr<container_module::value_container> c
 		response.rows.push_back(std::move(row));
 	}
 
+	// Delta
+	bool delta_present = false;
+	if (auto val = container->get("delta_present"))
+	{
+		if (std::holds_alternative<bool>(val->data))
+		{
+			delta_present = std::get<bool>(val->data);
+		}
+	}
+
+	if (delta_present)
+	{
+		result_delta delta;
+		if (auto val = container->get("delta_base_version"))
+		{
+			if (std::holds_alternative<long long>(val->data))
+			{
+				delta.base_version = static_cast<uint64_t>(std::get<long long>(val->data));
+			}
+		}
+
+		delta.inserted = detail::deserialize_rows(container, "delta_ins_", columns_count);
+		delta.updated = detail::deserialize_rows(container, "delta_upd_", columns_count);
+
+		int deleted_count = 0;
+		if (auto val = container->get("delta_del_count"))
+		{
+			if (std::holds_alternative<int>(val->data))
+			{
+				deleted_count = std::get<int>(val->data);
+			}
+		}
+		for (int i = 0; i < deleted_count; ++i)
+		{
+			delta.deleted_keys.push_back(detail::deserialize_variant_value<result_row::cell_value>(
+				container, "delta_del_" + std::to_string(i) + "_"));
+		}
+
+		response.delta = std::move(delta);
+	}
+
 	return response;
 #else
 	return kcenon::common::error_info{
@@ -275,6 +217,11 @@ query_response::deserialize(std::shared_ptr<container_module::value_container> c
 kcenon::common::Result<query_response>
 query_response::deserialize(const std::vector<uint8_t>& data)
 {
+	if (is_wire_v2(data))
+	{
+		return decode_response_v2(data);
+	}
+
 #if KCENON_WITH_CONTAINER_SYSTEM
 	auto container = std::make_shared<container_module::value_container>(data, false);
 	return deserialize(container);
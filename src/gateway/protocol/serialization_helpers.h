@@ -45,6 +45,7 @@
 
 #include <kcenon/database_server/gateway/container_compat.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <memory>
@@ -76,7 +77,8 @@ enum class value_type_tag : int
 	int64_value = 2,
 	double_value = 3,
 	string_value = 4,
-	bytes_value = 5
+	bytes_value = 5,
+	blob_ref_value = 6
 };
 
 #if KCENON_WITH_CONTAINER_SYSTEM
@@ -119,6 +121,10 @@ void serialize_variant_value(std::shared_ptr<container_module::value_container>&
 			{
 				container->set(prefix + "value_bytes", arg);
 			}
+			else if constexpr (std::is_same_v<T, blob_ref>)
+			{
+				container->set(prefix + "value_blob", arg.upload_id);
+			}
 		},
 		value);
 }
@@ -191,11 +197,78 @@ VariantT deserialize_variant_value(
 			}
 		}
 		break;
+	case static_cast<int>(value_type_tag::blob_ref_value):
+		if constexpr (std::is_constructible_v<VariantT, blob_ref>)
+		{
+			if (auto val = container->get(prefix + "value_blob"))
+			{
+				if (std::holds_alternative<std::string>(val->data))
+				{
+					result = blob_ref{ std::get<std::string>(val->data), nullptr };
+				}
+			}
+		}
+		break;
 	}
 
 	return result;
 }
 
+/**
+ * @brief Helper to serialize a list of result rows under a key prefix
+ *
+ * Stores `<prefix>count` followed by `<prefix><row>_cell_<col>_*` entries.
+ */
+inline void serialize_rows(std::shared_ptr<container_module::value_container>& container,
+						   const std::string& prefix,
+						   const std::vector<result_row>& rows)
+{
+	container->set(prefix + "count", static_cast<int>(rows.size()));
+	for (size_t row_idx = 0; row_idx < rows.size(); ++row_idx)
+	{
+		std::string row_prefix = prefix + std::to_string(row_idx) + "_";
+		const auto& cells = rows[row_idx].cells;
+		for (size_t cell_idx = 0; cell_idx < cells.size(); ++cell_idx)
+		{
+			serialize_variant_value(
+				container, row_prefix + "cell_" + std::to_string(cell_idx) + "_", cells[cell_idx]);
+		}
+	}
+}
+
+/**
+ * @brief Helper to deserialize a list of result rows written by serialize_rows()
+ */
+inline std::vector<result_row> deserialize_rows(
+	const std::shared_ptr<container_module::value_container>& container,
+	const std::string& prefix,
+	int cells_per_row)
+{
+	int count = 0;
+	if (auto val = container->get(prefix + "count"))
+	{
+		if (std::holds_alternative<int>(val->data))
+		{
+			count = std::get<int>(val->data);
+		}
+	}
+
+	std::vector<result_row> rows;
+	rows.reserve(static_cast<size_t>(std::max(count, 0)));
+	for (int row_idx = 0; row_idx < count; ++row_idx)
+	{
+		result_row row;
+		std::string row_prefix = prefix + std::to_string(row_idx) + "_";
+		for (int cell_idx = 0; cell_idx < cells_per_row; ++cell_idx)
+		{
+			row.cells.push_back(deserialize_variant_value<result_row::cell_value>(
+				container, row_prefix + "cell_" + std::to_string(cell_idx) + "_"));
+		}
+		rows.push_back(std::move(row));
+	}
+	return rows;
+}
+
 #endif // KCENON_WITH_CONTAINER_SYSTEM
 
 } // namespace database_server::gateway::detail
@@ -0,0 +1,358 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file wire_codec.h
+ * @brief Byte-level primitives of the v2 wire format
+ *
+ * wire_writer appends varints, zigzag-encoded signed integers, doubles and
+ * length-prefixed strings to a byte buffer; wire_reader reads them back
+ * from a span with bounds checks. A reader that runs past its input or
+ * meets a malformed varint enters a sticky failed state and returns zeros
+ * and empty views from then on, so decoders check failed() once at the end.
+ */
+
+#pragma once
+
+#include "serialization_helpers.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace database_server::gateway::detail
+{
+
+/**
+ * @brief Map a signed integer to an unsigned one with small magnitudes first
+ */
+constexpr uint64_t zigzag_encode(int64_t value) noexcept
+{
+	return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+constexpr int64_t zigzag_decode(uint64_t value) noexcept
+{
+	return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief Number of bytes a varint occupies
+ */
+constexpr size_t varint_size(uint64_t value) noexcept
+{
+	size_t size = 1;
+	while (value >= 0x80)
+	{
+		value >>= 7;
+		++size;
+	}
+	return size;
+}
+
+/**
+ * @class wire_writer
+ * @brief Appends v2 wire primitives to a byte buffer
+ */
+class wire_writer
+{
+public:
+	explicit wire_writer(std::vector<uint8_t>& out)
+		: out_(out)
+	{
+	}
+
+	void put_u8(uint8_t value) { out_.push_back(value); }
+
+	void put_tag(value_type_tag tag) { out_.push_back(static_cast<uint8_t>(tag)); }
+
+	void put_varint(uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out_.push_back(static_cast<uint8_t>(value | 0x80));
+			value >>= 7;
+		}
+		out_.push_back(static_cast<uint8_t>(value));
+	}
+
+	void put_signed(int64_t value) { put_varint(zigzag_encode(value)); }
+
+	void put_double(double value)
+	{
+		uint64_t bits = std::bit_cast<uint64_t>(value);
+		for (int shift = 0; shift < 64; shift += 8)
+		{
+			out_.push_back(static_cast<uint8_t>(bits >> shift));
+		}
+	}
+
+	void put_raw(const void* data, size_t size)
+	{
+		auto* bytes = static_cast<const uint8_t*>(data);
+		out_.insert(out_.end(), bytes, bytes + size);
+	}
+
+	void put_string(std::string_view value)
+	{
+		put_varint(value.size());
+		put_raw(value.data(), value.size());
+	}
+
+	void put_bytes(std::span<const uint8_t> value)
+	{
+		put_varint(value.size());
+		put_raw(value.data(), value.size());
+	}
+
+	[[nodiscard]] size_t size() const noexcept { return out_.size(); }
+	[[nodiscard]] std::vector<uint8_t>& buffer() noexcept { return out_; }
+
+private:
+	std::vector<uint8_t>& out_;
+};
+
+/**
+ * @class wire_reader
+ * @brief Reads v2 wire primitives from a byte span
+ */
+class wire_reader
+{
+public:
+	explicit wire_reader(std::span<const uint8_t> data)
+		: data_(data)
+	{
+	}
+
+	uint8_t get_u8()
+	{
+		if (!require(1))
+		{
+			return 0;
+		}
+		return data_[pos_++];
+	}
+
+	uint64_t get_varint()
+	{
+		uint64_t value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			if (!require(1))
+			{
+				return 0;
+			}
+			uint8_t byte = data_[pos_++];
+			value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				return value;
+			}
+		}
+		failed_ = true;
+		return 0;
+	}
+
+	uint32_t get_varint32()
+	{
+		uint64_t value = get_varint();
+		if (value > UINT32_MAX)
+		{
+			failed_ = true;
+			return 0;
+		}
+		return static_cast<uint32_t>(value);
+	}
+
+	int64_t get_signed() { return zigzag_decode(get_varint()); }
+
+	double get_double()
+	{
+		if (!require(8))
+		{
+			return 0.0;
+		}
+		uint64_t bits = 0;
+		for (int shift = 0; shift < 64; shift += 8)
+		{
+			bits |= static_cast<uint64_t>(data_[pos_++]) << shift;
+		}
+		return std::bit_cast<double>(bits);
+	}
+
+	std::span<const uint8_t> get_raw(size_t size)
+	{
+		if (!require(size))
+		{
+			return {};
+		}
+		auto raw = data_.subspan(pos_, size);
+		pos_ += size;
+		return raw;
+	}
+
+	std::span<const uint8_t> get_bytes() { return get_raw(get_length()); }
+
+	std::string_view get_string_view()
+	{
+		auto raw = get_bytes();
+		return { reinterpret_cast<const char*>(raw.data()), raw.size() };
+	}
+
+	std::string get_string() { return std::string(get_string_view()); }
+
+	/**
+	 * @brief Read a count or length that cannot exceed the remaining input
+	 * @param min_element_size Smallest encoding of one counted element
+	 */
+	size_t get_length(size_t min_element_size = 1)
+	{
+		uint64_t length = get_varint();
+		if (min_element_size > 0 && length > remaining() / min_element_size)
+		{
+			failed_ = true;
+			return 0;
+		}
+		return static_cast<size_t>(length);
+	}
+
+	[[nodiscard]] bool failed() const noexcept { return failed_; }
+	[[nodiscard]] size_t position() const noexcept { return pos_; }
+	[[nodiscard]] size_t remaining() const noexcept { return failed_ ? 0 : data_.size() - pos_; }
+	[[nodiscard]] bool at_end() const noexcept { return failed_ || pos_ == data_.size(); }
+	void fail() noexcept { failed_ = true; }
+
+private:
+	bool require(size_t size)
+	{
+		if (failed_ || data_.size() - pos_ < size)
+		{
+			failed_ = true;
+			return false;
+		}
+		return true;
+	}
+
+	std::span<const uint8_t> data_;
+	size_t pos_ = 0;
+	bool failed_ = false;
+};
+
+/**
+ * @brief Write a value prefixed with its value_type_tag
+ */
+template<typename VariantT>
+void put_tagged_value(wire_writer& writer, const VariantT& value)
+{
+	std::visit(
+		[&writer](auto&& arg)
+		{
+			using T = std::decay_t<decltype(arg)>;
+			if constexpr (std::is_same_v<T, std::monostate>)
+			{
+				writer.put_tag(value_type_tag::null_value);
+			}
+			else if constexpr (std::is_same_v<T, bool>)
+			{
+				writer.put_tag(value_type_tag::bool_value);
+				writer.put_u8(arg ? 1 : 0);
+			}
+			else if constexpr (std::is_same_v<T, int64_t>)
+			{
+				writer.put_tag(value_type_tag::int64_value);
+				writer.put_signed(arg);
+			}
+			else if constexpr (std::is_same_v<T, double>)
+			{
+				writer.put_tag(value_type_tag::double_value);
+				writer.put_double(arg);
+			}
+			else if constexpr (std::is_same_v<T, std::string>)
+			{
+				writer.put_tag(value_type_tag::string_value);
+				writer.put_string(arg);
+			}
+			else if constexpr (std::is_same_v<T, std::vector<uint8_t>>)
+			{
+				writer.put_tag(value_type_tag::bytes_value);
+				writer.put_bytes(arg);
+			}
+			else if constexpr (std::is_same_v<T, blob_ref>)
+			{
+				writer.put_tag(value_type_tag::blob_ref_value);
+				writer.put_string(arg.upload_id);
+			}
+		},
+		value);
+}
+
+/**
+ * @brief Read a type-tagged value written by put_tagged_value()
+ */
+template<typename VariantT>
+VariantT get_tagged_value(wire_reader& reader)
+{
+	switch (static_cast<value_type_tag>(reader.get_u8()))
+	{
+	case value_type_tag::null_value:
+		return std::monostate{};
+	case value_type_tag::bool_value:
+		return reader.get_u8() != 0;
+	case value_type_tag::int64_value:
+		return reader.get_signed();
+	case value_type_tag::double_value:
+		return reader.get_double();
+	case value_type_tag::string_value:
+		return reader.get_string();
+	case value_type_tag::bytes_value:
+	{
+		auto raw = reader.get_bytes();
+		return std::vector<uint8_t>(raw.begin(), raw.end());
+	}
+	case value_type_tag::blob_ref_value:
+		if constexpr (std::is_constructible_v<VariantT, blob_ref>)
+		{
+			return blob_ref{ reader.get_string(), nullptr };
+		}
+		[[fallthrough]];
+	default:
+		reader.fail();
+		return std::monostate{};
+	}
+}
+
+} // namespace database_server::gateway::detail
@@ -0,0 +1,733 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file wire_v2_serializer.cpp
+ * @brief Encoding and decoding of v2 (compact binary) frames
+ *
+ * Field order of the bodies:
+ * - request:  header, token (token, client_id, expires_at), type, sql,
+ *             params (count, {name, value}...), options (timeout_ms,
+ *             flags, isolation_level, max_rows, delta_key_column,
+ *             delta_base_version), chunk (present, upload_id, offset,
+ *             data, last)
+ * - response: header, status, error_message, affected_rows,
+ *             execution_time_us, result_version, columns (count,
+ *             {name, type_name, type_id, nullable, precision, scale}...),
+ *             rows (count, row...), delta (present, base_version,
+ *             inserted rows, updated rows, deleted keys)
+ * - event:    header, sequence, tables (count, string...), cache_keys
+ *             (count, string...), resync
+ *
+ * Header, token, chunk, status and column fields are written from the
+ * message_schema.h tables; params, options and rows are encoded here.
+ *
+ * Rows carry their encoded byte length so readers can skip them without
+ * decoding the cells. Columnar frames replace the response rows section
+ * with the layout of columnar_codec.h; delta rows always use rows.
+ *
+ * Requests are decoded through query_request_view, which maps the frame
+ * without copying; decode_request_v2() materializes the view.
+ */
+
+#include <kcenon/database_server/gateway/request_view.h>
+#include <kcenon/database_server/gateway/wire_format.h>
+
+#include "columnar_codec.h"
+#include "message_schema.h"
+
+#include <algorithm>
+
+namespace database_server::gateway
+{
+
+namespace
+{
+
+using detail::wire_reader;
+using detail::wire_writer;
+
+constexpr uint8_t option_read_only = 0x01;
+constexpr uint8_t option_include_metadata = 0x02;
+constexpr uint8_t option_columnar = 0x04;
+
+kcenon::common::error_info wire_error(const std::string& message)
+{
+	return kcenon::common::error_info{ -3, message, "query_protocol" };
+}
+
+void put_frame_header(wire_writer& writer, wire_message_kind kind, uint8_t flags = 0)
+{
+	writer.put_raw(wire_v2_magic.data(), wire_v2_magic.size());
+	writer.put_u8(static_cast<uint8_t>(kind));
+	writer.put_u8(flags);
+}
+
+void put_header(wire_writer& writer, const message_header& header)
+{
+	detail::put_fields(writer, header);
+}
+
+message_header get_header(wire_reader& reader)
+{
+	message_header header;
+	detail::get_fields(reader, header);
+	header.version = wire_version_v2;
+	return header;
+}
+
+/**
+ * @brief Read a type-tagged parameter value without copying its payload
+ */
+param_value_view get_value_view(wire_reader& reader)
+{
+	switch (static_cast<detail::value_type_tag>(reader.get_u8()))
+	{
+	case detail::value_type_tag::null_value:
+		return std::monostate{};
+	case detail::value_type_tag::bool_value:
+		return reader.get_u8() != 0;
+	case detail::value_type_tag::int64_value:
+		return reader.get_signed();
+	case detail::value_type_tag::double_value:
+		return reader.get_double();
+	case detail::value_type_tag::string_value:
+		return reader.get_string_view();
+	case detail::value_type_tag::bytes_value:
+		return reader.get_bytes();
+	case detail::value_type_tag::blob_ref_value:
+		return blob_ref_view{ reader.get_string_view() };
+	default:
+		reader.fail();
+		return std::monostate{};
+	}
+}
+
+/**
+ * @brief Encoded size of a cell, used to prefix rows with their length
+ */
+size_t cell_size(const result_row::cell_value& cell)
+{
+	return 1
+		   + std::visit(
+			   [](auto&& arg) -> size_t
+			   {
+				   using T = std::decay_t<decltype(arg)>;
+				   if constexpr (std::is_same_v<T, std::monostate>)
+				   {
+					   return 0;
+				   }
+				   else if constexpr (std::is_same_v<T, bool>)
+				   {
+					   return 1;
+				   }
+				   else if constexpr (std::is_same_v<T, int64_t>)
+				   {
+					   return detail::varint_size(detail::zigzag_encode(arg));
+				   }
+				   else if constexpr (std::is_same_v<T, double>)
+				   {
+					   return 8;
+				   }
+				   else
+				   {
+					   return detail::varint_size(arg.size()) + arg.size();
+				   }
+			   },
+			   cell);
+}
+
+void put_rows(wire_writer& writer, const std::vector<result_row>& rows)
+{
+	writer.put_varint(rows.size());
+	for (const auto& row : rows)
+	{
+		size_t body = detail::varint_size(row.cells.size());
+		for (const auto& cell : row.cells)
+		{
+			body += cell_size(cell);
+		}
+		writer.put_varint(body);
+		writer.put_varint(row.cells.size());
+		for (const auto& cell : row.cells)
+		{
+			detail::put_tagged_value(writer, cell);
+		}
+	}
+}
+
+std::vector<result_row> get_rows(wire_reader& reader)
+{
+	std::vector<result_row> rows;
+	// Each row needs at least its length and cell count
+	rows.resize(reader.get_length(2));
+	for (auto& row : rows)
+	{
+		size_t body = reader.get_length();
+		size_t start = reader.position();
+		row.cells.resize(reader.get_length());
+		for (auto& cell : row.cells)
+		{
+			cell = detail::get_tagged_value<result_row::cell_value>(reader);
+		}
+		if (reader.failed() || reader.position() - start != body)
+		{
+			reader.fail();
+			return {};
+		}
+	}
+	return rows;
+}
+
+void put_strings(wire_writer& writer, const std::vector<std::string>& strings)
+{
+	writer.put_varint(strings.size());
+	for (const auto& string : strings)
+	{
+		writer.put_string(string);
+	}
+}
+
+std::vector<std::string> get_strings(wire_reader& reader)
+{
+	std::vector<std::string> strings(reader.get_length(1));
+	for (auto& string : strings)
+	{
+		string = reader.get_string();
+	}
+	return strings;
+}
+
+/**
+ * @brief Validate the fixed frame header and position the reader at the body
+ * @param allowed_flags Flags the frame kind may carry
+ */
+bool check_frame(wire_reader& reader, wire_message_kind kind, uint8_t allowed_flags,
+				 uint8_t& flags)
+{
+	auto magic = reader.get_raw(wire_v2_magic.size());
+	if (reader.failed() || !std::equal(magic.begin(), magic.end(), wire_v2_magic.begin()))
+	{
+		return false;
+	}
+	if (reader.get_u8() != static_cast<uint8_t>(kind))
+	{
+		return false;
+	}
+	flags = reader.get_u8();
+	return !reader.failed() && (flags & ~allowed_flags) == 0;
+}
+
+} // namespace
+
+bool is_wire_v2(std::span<const uint8_t> data) noexcept
+{
+	return data.size() >= wire_v2_header_size
+		   && std::equal(wire_v2_magic.begin(), wire_v2_magic.end(), data.begin());
+}
+
+std::optional<wire_message_kind> wire_v2_kind(std::span<const uint8_t> data) noexcept
+{
+	if (!is_wire_v2(data))
+	{
+		return std::nullopt;
+	}
+	uint8_t kind = data[wire_v2_magic.size()];
+	if (kind < static_cast<uint8_t>(wire_message_kind::request)
+		|| kind > static_cast<uint8_t>(wire_message_kind::event))
+	{
+		return std::nullopt;
+	}
+	return static_cast<wire_message_kind>(kind);
+}
+
+std::vector<uint8_t> encode_wire_v2(const query_request& request)
+{
+	std::vector<uint8_t> out;
+	out.reserve(64 + request.sql.size() + request.token.token.size()
+				+ (request.chunk ? request.chunk->data.size() : 0));
+	wire_writer writer(out);
+
+	put_frame_header(writer, wire_message_kind::request);
+	put_header(writer, request.header);
+
+	detail::put_fields(writer, request.token);
+	detail::put_fields(writer, request);
+
+	writer.put_varint(request.params.size());
+	for (const auto& param : request.params)
+	{
+		writer.put_string(param.name);
+		detail::put_tagged_value(writer, param.value);
+	}
+
+	const auto& options = request.options;
+	writer.put_varint(options.timeout_ms);
+	writer.put_u8((options.read_only ? option_read_only : 0)
+				  | (options.include_metadata ? option_include_metadata : 0)
+				  | (options.columnar ? option_columnar : 0));
+	writer.put_string(options.isolation_level);
+	writer.put_varint(options.max_rows);
+	writer.put_string(options.delta_key_column);
+	writer.put_varint(options.delta_base_version);
+
+	writer.put_u8(request.chunk ? 1 : 0);
+	if (request.chunk)
+	{
+		detail::put_fields(writer, *request.chunk);
+	}
+
+	return out;
+}
+
+std::vector<uint8_t> encode_wire_v2(const query_response& response)
+{
+	std::vector<uint8_t> out;
+	encode_wire_v2(response, out);
+	return out;
+}
+
+void encode_wire_v2(const query_response& response, std::vector<uint8_t>& out,
+					wire_row_layout layout)
+{
+	bool columnar = layout == wire_row_layout::columnar
+					&& detail::is_columnar_compatible(response.rows);
+
+	// Rough lower bound so small results are encoded without regrowing
+	out.reserve(out.size() + 64 + response.error_message.size()
+				+ response.columns.size() * 16 + response.rows.size() * 8);
+	wire_writer writer(out);
+
+	put_frame_header(writer, wire_message_kind::response, columnar ? wire_flag_columnar : 0);
+	put_header(writer, response.header);
+
+	detail::put_fields(writer, response);
+
+	writer.put_varint(response.columns.size());
+	for (const auto& column : response.columns)
+	{
+		detail::put_fields(writer, column);
+	}
+
+	if (columnar)
+	{
+		detail::put_columnar_rows(writer, response.rows);
+	}
+	else
+	{
+		put_rows(writer, response.rows);
+	}
+
+	writer.put_u8(response.delta ? 1 : 0);
+	if (response.delta)
+	{
+		writer.put_varint(response.delta->base_version);
+		put_rows(writer, response.delta->inserted);
+		put_rows(writer, response.delta->updated);
+		writer.put_varint(response.delta->deleted_keys.size());
+		for (const auto& key : response.delta->deleted_keys)
+		{
+			detail::put_tagged_value(writer, key);
+		}
+	}
+}
+
+std::vector<uint8_t> encode_wire_v2(const invalidation_event& event)
+{
+	std::vector<uint8_t> out;
+	wire_writer writer(out);
+
+	put_frame_header(writer, wire_message_kind::event);
+	put_header(writer, event.header);
+
+	writer.put_varint(event.sequence);
+	put_strings(writer, event.tables);
+	put_strings(writer, event.cache_keys);
+	writer.put_u8(event.resync ? 1 : 0);
+
+	return out;
+}
+
+std::vector<uint8_t> encode_wire_v2_batch(
+	wire_message_kind kind, std::span<const std::vector<uint8_t>> frames, uint8_t flags)
+{
+	size_t size = wire_v2_header_size + detail::varint_size(frames.size());
+	for (const auto& frame : frames)
+	{
+		size += detail::varint_size(frame.size()) + frame.size();
+	}
+
+	std::vector<uint8_t> out;
+	out.reserve(size);
+	wire_writer writer(out);
+	put_frame_header(writer, kind, flags);
+	writer.put_varint(frames.size());
+	for (const auto& frame : frames)
+	{
+		writer.put_bytes(frame);
+	}
+	return out;
+}
+
+std::vector<uint8_t> encode_request_batch_v2(std::span<const query_request> requests,
+											 bool sequential)
+{
+	std::vector<std::vector<uint8_t>> frames;
+	frames.reserve(requests.size());
+	for (const auto& request : requests)
+	{
+		frames.push_back(encode_wire_v2(request));
+	}
+	return encode_wire_v2_batch(wire_message_kind::request_batch, frames,
+								sequential ? wire_flag_sequential : 0);
+}
+
+kcenon::common::Result<wire_batch> decode_wire_v2_batch(std::span<const uint8_t> data)
+{
+	auto kind = wire_v2_kind(data);
+	if (!kind
+		|| (*kind != wire_message_kind::request_batch
+			&& *kind != wire_message_kind::response_batch))
+	{
+		return wire_error("Not a v2 batch frame");
+	}
+
+	wire_reader reader(data);
+	wire_batch batch;
+	batch.kind = *kind;
+	uint8_t allowed = batch.kind == wire_message_kind::request_batch ? wire_flag_sequential : 0;
+	if (!check_frame(reader, batch.kind, allowed, batch.flags))
+	{
+		return wire_error("Malformed v2 batch frame");
+	}
+
+	// Each entry needs at least its length and a frame header
+	batch.frames.resize(reader.get_length(1 + wire_v2_header_size));
+	for (auto& frame : batch.frames)
+	{
+		frame = reader.get_bytes();
+	}
+
+	if (reader.failed() || !reader.at_end())
+	{
+		return wire_error("Malformed v2 batch frame");
+	}
+	return batch;
+}
+
+kcenon::common::Result<std::vector<query_response>> decode_response_batch_v2(
+	std::span<const uint8_t> data)
+{
+	auto batch = decode_wire_v2_batch(data);
+	if (batch.is_err())
+	{
+		return batch.error();
+	}
+	if (batch.value().kind != wire_message_kind::response_batch)
+	{
+		return wire_error("Not a v2 response batch frame");
+	}
+
+	std::vector<query_response> responses;
+	responses.reserve(batch.value().frames.size());
+	for (auto frame : batch.value().frames)
+	{
+		auto response = decode_response_v2(frame);
+		if (response.is_err())
+		{
+			return response.error();
+		}
+		responses.push_back(std::move(response.value()));
+	}
+	return responses;
+}
+
+kcenon::common::Result<query_request> decode_request_v2(std::span<const uint8_t> data)
+{
+	auto view = query_request_view::parse(data);
+	if (view.is_err())
+	{
+		return view.error();
+	}
+	return view.value().to_request();
+}
+
+// ============================================================================
+// query_request_view
+// ============================================================================
+
+kcenon::common::Result<query_request_view> query_request_view::parse(
+	std::span<const uint8_t> data)
+{
+	wire_reader reader(data);
+	uint8_t flags = 0;
+	if (!check_frame(reader, wire_message_kind::request, 0, flags))
+	{
+		return wire_error("Not a v2 request frame");
+	}
+
+	query_request_view view;
+	view.header.message_id = reader.get_varint();
+	view.header.timestamp = reader.get_varint();
+	view.header.correlation_id = reader.get_string_view();
+
+	view.token.token = reader.get_string_view();
+	view.token.client_id = reader.get_string_view();
+	view.token.expires_at = reader.get_varint();
+
+	view.type = static_cast<query_type>(reader.get_u8());
+	view.sql = reader.get_string_view();
+
+	// Validate the parameters now so iterating over them cannot fail.
+	// Each param needs at least a name length and a value tag.
+	size_t param_count = reader.get_length(2);
+	size_t params_begin = reader.position();
+	for (size_t i = 0; i < param_count && !reader.failed(); ++i)
+	{
+		reader.get_string_view();
+		get_value_view(reader);
+	}
+	if (!reader.failed())
+	{
+		view.params = param_list_view(
+			data.subspan(params_begin, reader.position() - params_begin), param_count);
+	}
+
+	auto& options = view.options;
+	options.timeout_ms = reader.get_varint32();
+	uint8_t option_flags = reader.get_u8();
+	options.read_only = (option_flags & option_read_only) != 0;
+	options.include_metadata = (option_flags & option_include_metadata) != 0;
+	options.columnar = (option_flags & option_columnar) != 0;
+	options.isolation_level = reader.get_string_view();
+	options.max_rows = reader.get_varint32();
+	options.delta_key_column = reader.get_string_view();
+	options.delta_base_version = reader.get_varint();
+
+	if (reader.get_u8() != 0)
+	{
+		blob_chunk_view chunk;
+		chunk.upload_id = reader.get_string_view();
+		chunk.offset = reader.get_varint();
+		chunk.data = reader.get_bytes();
+		chunk.last = reader.get_u8() != 0;
+		view.chunk = chunk;
+	}
+
+	if (reader.failed() || !reader.at_end())
+	{
+		return wire_error("Malformed v2 request frame");
+	}
+	return view;
+}
+
+query_request query_request_view::to_request() const
+{
+	query_request request;
+	request.header.version = wire_version_v2;
+	request.header.message_id = header.message_id;
+	request.header.timestamp = header.timestamp;
+	request.header.correlation_id = std::string(header.correlation_id);
+
+	request.token.token = std::string(token.token);
+	request.token.client_id = std::string(token.client_id);
+	request.token.expires_at = token.expires_at;
+
+	request.type = type;
+	request.sql = std::string(sql);
+	request.params = params.to_params();
+
+	request.options.timeout_ms = options.timeout_ms;
+	request.options.read_only = options.read_only;
+	request.options.include_metadata = options.include_metadata;
+	request.options.columnar = options.columnar;
+	request.options.isolation_level = std::string(options.isolation_level);
+	request.options.max_rows = options.max_rows;
+	request.options.delta_key_column = std::string(options.delta_key_column);
+	request.options.delta_base_version = options.delta_base_version;
+
+	if (chunk)
+	{
+		request.chunk = blob_chunk{ std::string(chunk->upload_id), chunk->offset,
+									std::vector<uint8_t>(chunk->data.begin(), chunk->data.end()),
+									chunk->last };
+	}
+	return request;
+}
+
+query_param query_param_view::to_param() const
+{
+	query_param param;
+	param.name = std::string(name);
+	param.value = std::visit(
+		[](auto&& arg) -> query_param::param_value
+		{
+			using T = std::decay_t<decltype(arg)>;
+			if constexpr (std::is_same_v<T, std::string_view>)
+			{
+				return std::string(arg);
+			}
+			else if constexpr (std::is_same_v<T, std::span<const uint8_t>>)
+			{
+				return std::vector<uint8_t>(arg.begin(), arg.end());
+			}
+			else if constexpr (std::is_same_v<T, blob_ref_view>)
+			{
+				return blob_ref{ std::string(arg.upload_id), nullptr };
+			}
+			else
+			{
+				return arg;
+			}
+		},
+		value);
+	return param;
+}
+
+param_list_view::iterator::iterator(std::span<const uint8_t> data, size_t remaining)
+	: data_(data)
+	, remaining_(remaining)
+{
+	if (remaining_ > 0)
+	{
+		decode();
+	}
+}
+
+param_list_view::iterator& param_list_view::iterator::operator++()
+{
+	if (remaining_ > 0 && --remaining_ > 0)
+	{
+		decode();
+	}
+	return *this;
+}
+
+void param_list_view::iterator::decode()
+{
+	wire_reader reader(data_);
+	current_.name = reader.get_string_view();
+	current_.value = get_value_view(reader);
+	data_ = data_.subspan(reader.position());
+}
+
+std::optional<query_param_view> param_list_view::find(std::string_view name) const
+{
+	for (const auto& param : *this)
+	{
+		if (param.name == name)
+		{
+			return param;
+		}
+	}
+	return std::nullopt;
+}
+
+std::vector<query_param> param_list_view::to_params() const
+{
+	std::vector<query_param> result;
+	result.reserve(count_);
+	for (const auto& param : *this)
+	{
+		result.push_back(param.to_param());
+	}
+	return result;
+}
+
+kcenon::common::Result<query_response> decode_response_v2(std::span<const uint8_t> data)
+{
+	wire_reader reader(data);
+	uint8_t flags = 0;
+	if (!check_frame(reader, wire_message_kind::response, wire_flag_columnar, flags))
+	{
+		return wire_error("Not a v2 response frame");
+	}
+
+	query_response response;
+	response.header = get_header(reader);
+
+	detail::get_fields(reader, response);
+
+	// name, type_name, type_id, nullable, precision, scale
+	response.columns.resize(reader.get_length(6));
+	for (auto& column : response.columns)
+	{
+		detail::get_fields(reader, column);
+	}
+
+	response.rows = (flags & wire_flag_columnar) != 0 ? detail::get_columnar_rows(reader)
+													 : get_rows(reader);
+
+	if (reader.get_u8() != 0)
+	{
+		result_delta delta;
+		delta.base_version = reader.get_varint();
+		delta.inserted = get_rows(reader);
+		delta.updated = get_rows(reader);
+		delta.deleted_keys.resize(reader.get_length());
+		for (auto& key : delta.deleted_keys)
+		{
+			key = detail::get_tagged_value<result_row::cell_value>(reader);
+		}
+		response.delta = std::move(delta);
+	}
+
+	if (reader.failed() || !reader.at_end())
+	{
+		return wire_error("Malformed v2 response frame");
+	}
+	return response;
+}
+
+kcenon::common::Result<invalidation_event> decode_event_v2(std::span<const uint8_t> data)
+{
+	wire_reader reader(data);
+	uint8_t flags = 0;
+	if (!check_frame(reader, wire_message_kind::event, 0, flags))
+	{
+		return wire_error("Not a v2 event frame");
+	}
+
+	invalidation_event event;
+	event.header = get_header(reader);
+	event.sequence = reader.get_varint();
+	event.tables = get_strings(reader);
+	event.cache_keys = get_strings(reader);
+	event.resync = reader.get_u8() != 0;
+
+	if (reader.failed() || !reader.at_end())
+	{
+		return wire_error("Malformed v2 event frame");
+	}
+	return event;
+}
+
+} // namespace database_server::gateway
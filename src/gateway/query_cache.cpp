@@ -31,9 +31,13 @@
 
 #include <kcenon/database_server/gateway/query_cache.h>
 
+#include <kcenon/database_server/gateway/blob_upload.h>
+
 #include <algorithm>
 #include <functional>
 #include <sstream>
+#include <string_view>
+#include <utility>
 
 namespace database_server::gateway
 {
@@ -43,6 +47,11 @@ query_cache::query_cache(const cache_config& config)
 {
 }
 
+query_cache::~query_cache()
+{
+	set_memory_governor(nullptr);
+}
+
 kcenon::common::Result<query_response> query_cache::get(const std::string& cache_key)
 {
 	if (!config_.enabled)
@@ -119,8 +128,35 @@ kcenon::common::VoidResult query_cache::put(
 			"query_cache"};
 	}
 
+	std::shared_ptr<memory_governor> governor;
+	{
+		std::shared_lock lock(mutex_);
+		governor = governor_;
+	}
+	if (governor && !governor->try_charge(memory_subsystem::cache, estimated_size))
+	{
+		++metrics_.skipped_memory_pressure;
+		return kcenon::common::error_info{
+			kcenon::common::error_codes::INVALID_ARGUMENT,
+			"Memory pressure, entry not cached",
+			"query_cache"};
+	}
+
 	std::unique_lock lock(mutex_);
 
+	// The governor was replaced meanwhile: move the charge to the current one
+	if (governor != governor_)
+	{
+		if (governor)
+		{
+			governor->release(memory_subsystem::cache, estimated_size);
+		}
+		if (governor_)
+		{
+			governor_->charge(memory_subsystem::cache, estimated_size);
+		}
+	}
+
 	auto existing = cache_map_.find(cache_key);
 	if (existing != cache_map_.end())
 	{
@@ -150,6 +186,7 @@ kcenon::common::VoidResult query_cache::put(
 
 	lru_list_.push_front(std::move(entry));
 	cache_map_[cache_key] = lru_list_.begin();
+	memory_bytes_ += estimated_size;
 
 	for (const auto& table : table_names)
 	{
@@ -197,11 +234,16 @@ std::string query_cache::make_key(const query_request& request)
 				}
 				else if constexpr (std::is_same_v<T, std::vector<uint8_t>>)
 				{
-					for (auto byte : arg)
-					{
-						hash_value ^= std::hash<uint8_t>{}(byte) + 0x9e3779b9 + (hash_value << 6)
-									  + (hash_value >> 2);
-					}
+					std::string_view bytes(reinterpret_cast<const char*>(arg.data()), arg.size());
+					hash_value ^= std::hash<std::string_view>{}(bytes) + 0x9e3779b9
+								  + (hash_value << 6) + (hash_value >> 2);
+				}
+				else if constexpr (std::is_same_v<T, blob_ref>)
+				{
+					// Digest computed during the upload; the id only before resolution
+					size_t blob_hash = arg.content ? static_cast<size_t>(arg.content->digest())
+												   : hasher(arg.upload_id);
+					hash_value ^= blob_hash + 0x9e3779b9 + (hash_value << 6) + (hash_value >> 2);
 				}
 			},
 			param.value);
@@ -217,54 +259,77 @@ std::string query_cache::make_key(const query_request& request)
 
 kcenon::common::VoidResult query_cache::invalidate(const std::string& table_name)
 {
-	std::unique_lock lock(mutex_);
-
-	auto it = table_map_.find(table_name);
-	if (it == table_map_.end())
+	std::vector<std::string> removed_keys;
 	{
-		return kcenon::common::ok(); // No entries to invalidate is not an error
-	}
+		std::unique_lock lock(mutex_);
 
-	// Copy keys to remove since remove_entry modifies table_map_
-	auto keys_to_remove = it->second;
+		auto it = table_map_.find(table_name);
+		if (it != table_map_.end())
+		{
+			// Copy keys to remove since remove_entry modifies table_map_
+			auto keys_to_remove = it->second;
 
-	// Clear the table mapping first to avoid iterator invalidation
-	table_map_.erase(it);
+			// Clear the table mapping first to avoid iterator invalidation
+			table_map_.erase(it);
 
-	for (const auto& key : keys_to_remove)
-	{
-		auto cache_it = cache_map_.find(key);
-		if (cache_it != cache_map_.end())
-		{
-			remove_entry(cache_it->second);
-			++metrics_.invalidations;
+			for (const auto& key : keys_to_remove)
+			{
+				auto cache_it = cache_map_.find(key);
+				if (cache_it != cache_map_.end())
+				{
+					remove_entry(cache_it->second);
+					++metrics_.invalidations;
+					removed_keys.push_back(key);
+				}
+			}
 		}
 	}
 
+	// No entries to invalidate is not an error, and subscribers still need to know
+	notify_invalidation(table_name, removed_keys);
 	return kcenon::common::ok();
 }
 
 kcenon::common::VoidResult query_cache::invalidate_key(const std::string& cache_key)
 {
-	std::unique_lock lock(mutex_);
-
-	auto it = cache_map_.find(cache_key);
-	if (it != cache_map_.end())
 	{
-		remove_entry(it->second);
-		++metrics_.invalidations;
+		std::unique_lock lock(mutex_);
+
+		auto it = cache_map_.find(cache_key);
+		if (it != cache_map_.end())
+		{
+			remove_entry(it->second);
+			++metrics_.invalidations;
+		}
 	}
 
+	notify_invalidation("", {cache_key});
 	return kcenon::common::ok();
 }
 
 void query_cache::clear()
 {
-	std::unique_lock lock(mutex_);
+	{
+		std::unique_lock lock(mutex_);
+
+		lru_list_.clear();
+		cache_map_.clear();
+		table_map_.clear();
+		if (governor_)
+		{
+			governor_->release(memory_subsystem::cache, memory_bytes_);
+		}
+		memory_bytes_ = 0;
+	}
 
-	lru_list_.clear();
-	cache_map_.clear();
-	table_map_.clear();
+	notify_invalidation("", {});
+}
+
+void query_cache::set_invalidation_listener(invalidation_listener_t listener)
+{
+	std::lock_guard<std::mutex> lock(listener_mutex_);
+	listener_ = listener ? std::make_shared<invalidation_listener_t>(std::move(listener))
+						 : nullptr;
 }
 
 const cache_metrics& query_cache::metrics() const noexcept
@@ -293,6 +358,57 @@ const cache_config& query_cache::config() const noexcept
 	return config_;
 }
 
+void query_cache::set_memory_governor(std::shared_ptr<memory_governor> governor)
+{
+	std::shared_ptr<memory_governor> previous;
+	{
+		std::unique_lock lock(mutex_);
+		if (governor == governor_)
+		{
+			return;
+		}
+		previous = std::exchange(governor_, governor);
+		if (previous)
+		{
+			previous->release(memory_subsystem::cache, memory_bytes_);
+		}
+		if (governor)
+		{
+			governor->charge(memory_subsystem::cache, memory_bytes_);
+		}
+	}
+
+	// Outside mutex_: the governor calls shrink() with its reclaimer lock held
+	if (previous)
+	{
+		previous->set_reclaimer(memory_subsystem::cache, nullptr);
+	}
+	if (governor)
+	{
+		governor->set_reclaimer(memory_subsystem::cache,
+								[this](size_t bytes) { return shrink(bytes); });
+	}
+}
+
+size_t query_cache::shrink(size_t bytes)
+{
+	std::unique_lock lock(mutex_);
+
+	size_t freed = 0;
+	while (freed < bytes && !lru_list_.empty())
+	{
+		freed += lru_list_.back().estimated_size;
+		evict_lru();
+	}
+	return freed;
+}
+
+size_t query_cache::memory_usage() const
+{
+	std::shared_lock lock(mutex_);
+	return memory_bytes_;
+}
+
 bool query_cache::is_expired(const cache_entry& entry) const noexcept
 {
 	if (config_.ttl_seconds == 0)
@@ -369,8 +485,29 @@ void query_cache::remove_entry(cache_list::iterator it)
 		}
 	}
 
+	memory_bytes_ -= std::min(memory_bytes_, entry.estimated_size);
+	if (governor_)
+	{
+		governor_->release(memory_subsystem::cache, entry.estimated_size);
+	}
+
 	cache_map_.erase(entry.key);
 	lru_list_.erase(it);
 }
 
+void query_cache::notify_invalidation(const std::string& table_name,
+									  const std::vector<std::string>& cache_keys)
+{
+	std::shared_ptr<invalidation_listener_t> listener;
+	{
+		std::lock_guard<std::mutex> lock(listener_mutex_);
+		listener = listener_;
+	}
+
+	if (listener)
+	{
+		(*listener)(table_name, cache_keys);
+	}
+}
+
 } // namespace database_server::gateway
@@ -29,15 +29,52 @@
 // ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
 // POSSIBILITY OF SUCH DAMAGE.
 
+#include <kcenon/database_server/gateway/client_quota.h>
+#include <kcenon/database_server/gateway/codel_controller.h>
 #include <kcenon/database_server/gateway/query_handlers.h>
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <regex>
 
 namespace database_server::gateway
 {
 
+namespace
+{
+
+/**
+ * @brief Report the time spent waiting for a pooled connection
+ */
+void record_acquisition_wait(const handler_context& context,
+							 std::chrono::steady_clock::time_point started)
+{
+	if (context.admission != nullptr)
+	{
+		context.admission->record(std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - started));
+	}
+}
+
+/**
+ * @brief Charge a pooled connection against the client's connection quota
+ * @return false if the client still held its quota of connections after
+ *         the configured queueing time
+ */
+bool acquire_connection_slot(const handler_context& context,
+							 client_quota_manager::slot& connection_slot)
+{
+	if (context.quotas == nullptr)
+	{
+		return true;
+	}
+	connection_slot = context.quotas->acquire(context.client_id, quota_kind::connection);
+	return static_cast<bool>(connection_slot);
+}
+
+} // namespace
+
 namespace detail
 {
 
@@ -146,9 +183,18 @@ query_response select_handler::handle_impl(const query_request& request,
 						  ? request.options.timeout_ms
 						  : context.default_timeout_ms;
 
+	client_quota_manager::slot connection_slot;
+	if (!acquire_connection_slot(context, connection_slot))
+	{
+		return query_response(request.header.message_id, status_code::rate_limited,
+							  "Too many connections held by client");
+	}
+
+	auto wait_started = std::chrono::steady_clock::now();
 	auto future = pool->acquire_connection(priority);
 
 	auto status = future.wait_for(std::chrono::milliseconds(timeout_ms));
+	record_acquisition_wait(context, wait_started);
 	if (status == std::future_status::timeout)
 	{
 		return query_response(request.header.message_id, status_code::timeout,
@@ -219,9 +265,17 @@ query_response select_handler::handle_impl(const query_request& request,
 				}
 			}
 
-			// Convert rows
+			// Convert rows, at most max_rows of them
+			size_t row_limit = request.options.max_rows != 0 ? request.options.max_rows
+															 : db_result.size();
+			response.rows.reserve(std::min(row_limit, db_result.size()));
 			for (const auto& db_row : db_result)
 			{
+				if (response.rows.size() >= row_limit)
+				{
+					break;
+				}
+
 				result_row row;
 				for (const auto& [col_name, cell] : db_row)
 				{
@@ -287,9 +341,18 @@ query_response insert_handler::handle_impl(const query_request& request,
 						  ? request.options.timeout_ms
 						  : context.default_timeout_ms;
 
+	client_quota_manager::slot connection_slot;
+	if (!acquire_connection_slot(context, connection_slot))
+	{
+		return query_response(request.header.message_id, status_code::rate_limited,
+							  "Too many connections held by client");
+	}
+
+	auto wait_started = std::chrono::steady_clock::now();
 	auto future = pool->acquire_connection(priority);
 
 	auto status = future.wait_for(std::chrono::milliseconds(timeout_ms));
+	record_acquisition_wait(context, wait_started);
 	if (status == std::future_status::timeout)
 	{
 		return query_response(request.header.message_id, status_code::timeout,
@@ -329,9 +392,10 @@ query_response insert_handler::handle_impl(const query_request& request,
 
 		pool->release_connection(connection);
 
-		// Invalidate cache for affected tables
+		// Invalidate cache for affected tables (also when result caching is
+		// disabled, so invalidation subscribers are still notified)
 		auto cache = context.cache;
-		if (cache && cache->is_enabled())
+		if (cache)
 		{
 			auto tables = detail::extract_table_names(request.sql, request.type);
 			for (const auto& table : tables)
@@ -369,9 +433,18 @@ query_response update_handler::handle_impl(const query_request& request,
 						  ? request.options.timeout_ms
 						  : context.default_timeout_ms;
 
+	client_quota_manager::slot connection_slot;
+	if (!acquire_connection_slot(context, connection_slot))
+	{
+		return query_response(request.header.message_id, status_code::rate_limited,
+							  "Too many connections held by client");
+	}
+
+	auto wait_started = std::chrono::steady_clock::now();
 	auto future = pool->acquire_connection(priority);
 
 	auto status = future.wait_for(std::chrono::milliseconds(timeout_ms));
+	record_acquisition_wait(context, wait_started);
 	if (status == std::future_status::timeout)
 	{
 		return query_response(request.header.message_id, status_code::timeout,
@@ -411,9 +484,10 @@ query_response update_handler::handle_impl(const query_request& request,
 
 		pool->release_connection(connection);
 
-		// Invalidate cache for affected tables
+		// Invalidate cache for affected tables (also when result caching is
+		// disabled, so invalidation subscribers are still notified)
 		auto cache = context.cache;
-		if (cache && cache->is_enabled())
+		if (cache)
 		{
 			auto tables = detail::extract_table_names(request.sql, request.type);
 			for (const auto& table : tables)
@@ -451,9 +525,18 @@ query_response delete_handler::handle_impl(const query_request& request,
 						  ? request.options.timeout_ms
 						  : context.default_timeout_ms;
 
+	client_quota_manager::slot connection_slot;
+	if (!acquire_connection_slot(context, connection_slot))
+	{
+		return query_response(request.header.message_id, status_code::rate_limited,
+							  "Too many connections held by client");
+	}
+
+	auto wait_started = std::chrono::steady_clock::now();
 	auto future = pool->acquire_connection(priority);
 
 	auto status = future.wait_for(std::chrono::milliseconds(timeout_ms));
+	record_acquisition_wait(context, wait_started);
 	if (status == std::future_status::timeout)
 	{
 		return query_response(request.header.message_id, status_code::timeout,
@@ -493,9 +576,10 @@ query_response delete_handler::handle_impl(const query_request& request,
 
 		pool->release_connection(connection);
 
-		// Invalidate cache for affected tables
+		// Invalidate cache for affected tables (also when result caching is
+		// disabled, so invalidation subscribers are still notified)
 		auto cache = context.cache;
-		if (cache && cache->is_enabled())
+		if (cache)
 		{
 			auto tables = detail::extract_table_names(request.sql, request.type);
 			for (const auto& table : tables)
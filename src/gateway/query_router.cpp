@@ -53,6 +53,26 @@ uint64_t current_timestamp_us()
 			.count());
 }
 
+/**
+ * @brief Classify a response status for the circuit breaker
+ */
+resilience::call_failure to_call_failure(status_code status) noexcept
+{
+	switch (status)
+	{
+	case status_code::ok:
+		return resilience::call_failure::none;
+	case status_code::connection_failed:
+		return resilience::call_failure::connection_failed;
+	case status_code::no_connection:
+		return resilience::call_failure::no_connection;
+	case status_code::timeout:
+		return resilience::call_failure::timeout;
+	default:
+		return resilience::call_failure::query_error;
+	}
+}
+
 } // namespace
 
 // ============================================================================
@@ -61,6 +81,10 @@ uint64_t current_timestamp_us()
 
 query_router::query_router(const router_config& config)
 	: config_(config)
+	, admission_(config.admission)
+	, client_quotas_(config.client_quotas)
+	, cost_limits_(config.cost_limits)
+	, breaker_(config.circuit_breaker)
 {
 	initialize_handlers();
 }
@@ -89,6 +113,8 @@ handler_context query_router::get_handler_context() const
 		ctx.cache = cache_;
 	}
 	ctx.default_timeout_ms = config_.default_timeout_ms;
+	ctx.admission = &admission_;
+	ctx.quotas = &client_quotas_;
 	return ctx;
 }
 
@@ -110,9 +136,11 @@ i_query_handler* query_router::find_handler(query_type type) const
 	return nullptr;
 }
 
-query_response query_router::execute_with_handler(const query_request& request)
+query_response query_router::execute_with_handler(const query_request& request,
+												  const std::string& client_id)
 {
 	auto ctx = get_handler_context();
+	ctx.client_id = client_id;
 
 	// Check for custom handler first
 	auto* custom_handler = find_handler(request.type);
@@ -158,6 +186,12 @@ void query_router::set_connection_pool(std::shared_ptr<pooling::connection_pool>
 }
 
 kcenon::common::Result<query_response> query_router::execute(const query_request& request)
+{
+	return execute(request, std::string{});
+}
+
+kcenon::common::Result<query_response> query_router::execute(const query_request& request,
+															 const std::string& client_id)
 {
 	auto start_time = current_timestamp_us();
 
@@ -171,11 +205,46 @@ kcenon::common::Result<query_response> query_router::execute(const query_request
 			"query_router"};
 	}
 
+	// Shed low-priority work while connections or workers have a standing queue
+	if (admission_.should_shed(is_sheddable(request.type)))
+	{
+		record_metrics(false, false, 0);
+		return kcenon::common::ok(query_response(request.header.message_id,
+												 status_code::server_busy,
+												 "Server overloaded, request shed"));
+	}
+
+	// Fail fast while the database is failing instead of waiting for timeouts
+	resilience::circuit_permit breaker_permit;
+	if (request.type != query_type::ping)
+	{
+		breaker_permit = breaker_.admit();
+		if (!breaker_permit.admitted)
+		{
+			record_metrics(false, false, 0);
+			return kcenon::common::ok(query_response(request.header.message_id,
+													 status_code::connection_failed,
+													 "Database unavailable (circuit open)"));
+		}
+	}
+
+	// Keep a single client from occupying the shared concurrency budget
+	auto quota_slot = client_quotas_.acquire(client_id, quota_kind::query);
+	if (!quota_slot)
+	{
+		breaker_.cancel(breaker_permit);
+		record_metrics(false, false, 0);
+		return kcenon::common::ok(query_response(request.header.message_id,
+												 status_code::rate_limited,
+												 "Too many concurrent queries for client"));
+	}
+
 	// Check concurrent query limit
 	auto current = active_queries_.fetch_add(1, std::memory_order_relaxed);
 	if (current >= config_.max_concurrent_queries)
 	{
 		active_queries_.fetch_sub(1, std::memory_order_relaxed);
+		breaker_.cancel(breaker_permit);
 		record_metrics(false, false, 0);
 		return kcenon::common::error_info{
 			kcenon::common::error_codes::INTERNAL_ERROR,
@@ -183,16 +252,30 @@ kcenon::common::Result<query_response> query_router::execute(const query_request
 			"query_router"};
 	}
 
+	// Charge the estimated cost now, the measured one once the query ran
+	auto cost_ticket = cost_limits_.admit(client_id, request.sql);
+	if (!cost_ticket.admitted)
+	{
+		active_queries_.fetch_sub(1, std::memory_order_relaxed);
+		breaker_.cancel(breaker_permit);
+		record_metrics(false, false, 0);
+		return kcenon::common::ok(query_response(request.header.message_id,
+												 status_code::rate_limited,
+												 "Query cost budget exceeded"));
+	}
+
 	// Execute using CRTP handlers
 	query_response response(request.header.message_id);
+	auto handler_started = current_timestamp_us();
 
 	try
 	{
-		response = execute_with_handler(request);
+		response = execute_with_handler(request, client_id);
 	}
 	catch (const std::exception& e)
 	{
 		active_queries_.fetch_sub(1, std::memory_order_relaxed);
+		breaker_.cancel(breaker_permit);
 		record_metrics(false, false, 0);
 		return kcenon::common::error_info{
 			kcenon::common::error_codes::INTERNAL_ERROR,
@@ -207,6 +290,15 @@ kcenon::common::Result<query_response> query_router::execute(const query_request
 	auto execution_time = end_time - start_time;
 	response.execution_time_us = execution_time;
 
+	// Time spent queueing for admission is not the query's cost
+	auto cost = cost_limiter::measure(response);
+	cost.execution_time_us = end_time - handler_started;
+	cost_limits_.settle(client_id, cost_ticket, cost);
+
+	breaker_.record(breaker_permit,
+					!resilience::is_backend_failure(to_call_failure(response.status)),
+					std::chrono::microseconds(cost.execution_time_us));
+
 	// Record metrics
 	bool is_success = response.is_success();
 	bool is_timeout = response.status == status_code::timeout;
@@ -223,10 +315,13 @@ class async_query_job : public kcenon::common::interfaces::IJob
 public:
 	async_query_job(query_router* router,
 					query_request request,
+					std::string client_id,
 					std::function<void(query_response)> callback)
 		: router_(router)
 		, request_(std::move(request))
+		, client_id_(std::move(client_id))
 		, callback_(std::move(callback))
+		, enqueued_at_(std::chrono::steady_clock::now())
 	{
 	}
 
@@ -234,7 +329,10 @@ public:
 	{
 		if (router_)
 		{
-			auto result = router_->execute(request_);
+			router_->admission_.record(std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - enqueued_at_));
+
+			auto result = router_->execute(request_, client_id_);
 			if (callback_)
 			{
 				if (result.is_ok())
@@ -261,11 +359,20 @@ public:
 private:
 	query_router* router_;
 	query_request request_;
+	std::string client_id_;
 	std::function<void(query_response)> callback_;
+	std::chrono::steady_clock::time_point enqueued_at_;
 };
 
 void query_router::execute_async(const query_request& request,
 								 std::function<void(query_response)> callback)
+{
+	execute_async(request, std::string{}, std::move(callback));
+}
+
+void query_router::execute_async(const query_request& request,
+								 const std::string& client_id,
+								 std::function<void(query_response)> callback)
 {
 	std::shared_ptr<kcenon::common::interfaces::IExecutor> exec;
 	{
@@ -276,7 +383,7 @@ void query_router::execute_async(const query_request& request,
 	if (exec)
 	{
 		// Use IExecutor for async execution
-		auto job = std::make_unique<async_query_job>(this, request, std::move(callback));
+		auto job = std::make_unique<async_query_job>(this, request, client_id, std::move(callback));
 		auto result = exec->execute(std::move(job));
 		// Fire and forget - the callback will be invoked when done
 		(void)result;
@@ -285,9 +392,9 @@ void query_router::execute_async(const query_request& request,
 	{
 		// Fallback to std::async if no executor provided
 		std::async(std::launch::async,
-				   [this, request, callback = std::move(callback)]()
+				   [this, request, client_id, callback = std::move(callback)]()
 				   {
-					   auto result = execute(request);
+					   auto result = execute(request, client_id);
 					   if (callback)
 					   {
 						   if (result.is_ok())
@@ -326,6 +433,26 @@ const router_config& query_router::config() const noexcept
 	return config_;
 }
 
+const client_quota_manager& query_router::client_quotas() const noexcept
+{
+	return client_quotas_;
+}
+
+const cost_limiter& query_router::cost_limits() const noexcept
+{
+	return cost_limits_;
+}
+
+const resilience::circuit_breaker& query_router::breaker() const noexcept
+{
+	return breaker_;
+}
+
+const codel_controller& query_router::admission() const noexcept
+{
+	return admission_;
+}
+
 bool query_router::is_ready() const noexcept
 {
 	std::lock_guard<std::mutex> lock(pool_mutex_);
@@ -0,0 +1,437 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <kcenon/database_server/gateway/query_cache.h>
+#include <kcenon/database_server/gateway/result_delta.h>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <variant>
+
+namespace database_server::gateway
+{
+
+namespace
+{
+
+constexpr uint64_t fnv_offset_basis = 14695981039346656037ULL;
+constexpr uint64_t fnv_prime = 1099511628211ULL;
+
+void fnv_mix(uint64_t& hash, const void* data, size_t size) noexcept
+{
+	const auto* bytes = static_cast<const uint8_t*>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= fnv_prime;
+	}
+}
+
+/**
+ * @brief Append the binary form of a cell (type tag + payload) to a buffer
+ */
+void encode_cell(const result_row::cell_value& cell, std::string& out)
+{
+	out.push_back(static_cast<char>(cell.index()));
+	std::visit(
+		[&out](auto&& arg)
+		{
+			using T = std::decay_t<decltype(arg)>;
+			if constexpr (std::is_same_v<T, bool>)
+			{
+				out.push_back(arg ? 1 : 0);
+			}
+			else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, double>)
+			{
+				char buf[sizeof(T)];
+				std::memcpy(buf, &arg, sizeof(T));
+				out.append(buf, sizeof(T));
+			}
+			else if constexpr (std::is_same_v<T, std::string>)
+			{
+				out.append(arg);
+			}
+			else if constexpr (std::is_same_v<T, std::vector<uint8_t>>)
+			{
+				out.append(reinterpret_cast<const char*>(arg.data()), arg.size());
+			}
+		},
+		cell);
+}
+
+/**
+ * @brief Reverse of encode_cell() for a single encoded key
+ */
+result_row::cell_value decode_cell(const std::string& encoded)
+{
+	if (encoded.empty())
+	{
+		return std::monostate{};
+	}
+
+	const char* payload = encoded.data() + 1;
+	size_t payload_size = encoded.size() - 1;
+
+	switch (static_cast<size_t>(static_cast<uint8_t>(encoded[0])))
+	{
+	case 1:
+		return payload_size > 0 && payload[0] != 0;
+	case 2:
+	{
+		int64_t value = 0;
+		std::memcpy(&value, payload, std::min(payload_size, sizeof(value)));
+		return value;
+	}
+	case 3:
+	{
+		double value = 0.0;
+		std::memcpy(&value, payload, std::min(payload_size, sizeof(value)));
+		return value;
+	}
+	case 4:
+		return std::string(payload, payload_size);
+	case 5:
+		return std::vector<uint8_t>(payload, payload + payload_size);
+	default:
+		return std::monostate{};
+	}
+}
+
+uint64_t fingerprint_row(const result_row& row, std::string& scratch)
+{
+	uint64_t hash = fnv_offset_basis;
+	for (const auto& cell : row.cells)
+	{
+		scratch.clear();
+		encode_cell(cell, scratch);
+		uint64_t length = scratch.size();
+		fnv_mix(hash, &length, sizeof(length));
+		fnv_mix(hash, scratch.data(), scratch.size());
+	}
+	return hash;
+}
+
+uint64_t layout_hash(const query_response& response, const std::string& key_column)
+{
+	uint64_t hash = fnv_offset_basis;
+	fnv_mix(hash, key_column.data(), key_column.size());
+	for (const auto& col : response.columns)
+	{
+		hash ^= 0x1f;
+		hash *= fnv_prime;
+		fnv_mix(hash, col.name.data(), col.name.size());
+	}
+	return hash;
+}
+
+size_t estimate_row_entry_size(const std::string& key)
+{
+	// Key storage + fingerprint + hash node (next pointer and cached hash)
+	return sizeof(std::string) + key.capacity() + sizeof(uint64_t) + 2 * sizeof(void*);
+}
+
+} // namespace
+
+result_delta_tracker::result_delta_tracker(const delta_config& config)
+	: config_(config)
+{
+}
+
+bool result_delta_tracker::is_eligible(const query_request& request,
+									   const query_response& response) const noexcept
+{
+	return config_.enabled && request.type == query_type::select
+		   && !request.options.delta_key_column.empty() && response.is_success()
+		   && !response.delta.has_value();
+}
+
+void result_delta_tracker::apply(const std::string& session_id,
+								 const query_request& request,
+								 query_response& response)
+{
+	if (!is_eligible(request, response))
+	{
+		return;
+	}
+
+	const auto& key_column = request.options.delta_key_column;
+	std::string id = session_id + '\x1f' + query_cache::make_key(request);
+
+	// An empty result may come without column metadata; it is compatible with
+	// any previous layout (everything was deleted).
+	bool layout_free = response.columns.empty() && response.rows.empty();
+
+	// Build the new snapshot image outside the lock
+	std::optional<snapshot> image;
+	if (response.rows.size() <= config_.max_rows_per_snapshot)
+	{
+		std::optional<size_t> key_index;
+		for (size_t i = 0; i < response.columns.size(); ++i)
+		{
+			if (response.columns[i].name == key_column)
+			{
+				key_index = i;
+				break;
+			}
+		}
+
+		if (key_index || layout_free)
+		{
+			snapshot candidate;
+			candidate.id = id;
+			candidate.session_id = session_id;
+			candidate.layout_hash = layout_hash(response, key_column);
+			candidate.rows.reserve(response.rows.size());
+			candidate.estimated_size = sizeof(snapshot) + id.size() + session_id.size();
+
+			bool valid = true;
+			std::string scratch;
+			for (const auto& row : response.rows)
+			{
+				if (*key_index >= row.cells.size()
+					|| std::holds_alternative<std::monostate>(row.cells[*key_index]))
+				{
+					valid = false;
+					break;
+				}
+
+				std::string key;
+				encode_cell(row.cells[*key_index], key);
+				auto fingerprint = fingerprint_row(row, scratch);
+
+				candidate.estimated_size += estimate_row_entry_size(key);
+				if (!candidate.rows.emplace(std::move(key), fingerprint).second)
+				{
+					valid = false; // Duplicate key: rows cannot be matched
+					break;
+				}
+			}
+			candidate.estimated_size += candidate.rows.bucket_count() * sizeof(void*);
+
+			if (valid && candidate.estimated_size <= config_.max_memory_bytes)
+			{
+				image = std::move(candidate);
+			}
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto existing = snapshot_map_.find(id);
+
+	if (!image)
+	{
+		// Result cannot be tracked; drop any stale snapshot so the client
+		// never applies a delta against the wrong base.
+		if (existing != snapshot_map_.end())
+		{
+			remove_snapshot(existing->second);
+		}
+		response.result_version = 0;
+		++metrics_.not_snapshotted;
+		++metrics_.full_responses;
+		return;
+	}
+
+	bool sent_delta = false;
+	uint64_t base_version = request.options.delta_base_version;
+
+	if (existing != snapshot_map_.end() && base_version != 0
+		&& existing->second->version == base_version
+		&& (layout_free || existing->second->layout_hash == image->layout_hash))
+	{
+		const auto& old_rows = existing->second->rows;
+
+		result_delta delta;
+		delta.base_version = base_version;
+
+		size_t key_index = 0;
+		for (size_t i = 0; i < response.columns.size(); ++i)
+		{
+			if (response.columns[i].name == key_column)
+			{
+				key_index = i;
+				break;
+			}
+		}
+
+		std::string key;
+		for (auto& row : response.rows)
+		{
+			key.clear();
+			encode_cell(row.cells[key_index], key);
+			auto old_it = old_rows.find(key);
+			if (old_it == old_rows.end())
+			{
+				delta.inserted.push_back(row);
+			}
+			else if (old_it->second != image->rows.at(key))
+			{
+				delta.updated.push_back(row);
+			}
+		}
+
+		for (const auto& [old_key, fingerprint] : old_rows)
+		{
+			(void)fingerprint;
+			if (image->rows.find(old_key) == image->rows.end())
+			{
+				delta.deleted_keys.push_back(decode_cell(old_key));
+			}
+		}
+
+		size_t changed = delta.inserted.size() + delta.updated.size() + delta.deleted_keys.size();
+		size_t reference = std::max(response.rows.size(), old_rows.size());
+
+		if (static_cast<double>(changed) <= config_.max_change_ratio * static_cast<double>(reference))
+		{
+			metrics_.rows_suppressed
+				+= response.rows.size() - delta.inserted.size() - delta.updated.size();
+			response.rows.clear();
+			response.delta = std::move(delta);
+			sent_delta = true;
+		}
+	}
+
+	if (sent_delta)
+	{
+		++metrics_.delta_responses;
+	}
+	else
+	{
+		++metrics_.full_responses;
+	}
+
+	if (existing != snapshot_map_.end())
+	{
+		if (layout_free)
+		{
+			image->layout_hash = existing->second->layout_hash;
+		}
+		remove_snapshot(existing->second);
+	}
+
+	evict_to_fit(image->estimated_size);
+
+	image->version = next_version_++;
+	response.result_version = image->version;
+
+	memory_usage_ += image->estimated_size;
+	session_map_[session_id].insert(id);
+	lru_list_.push_front(std::move(*image));
+	snapshot_map_[id] = lru_list_.begin();
+}
+
+void result_delta_tracker::remove_session(const std::string& session_id)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	auto it = session_map_.find(session_id);
+	if (it == session_map_.end())
+	{
+		return;
+	}
+
+	// Copy ids since remove_snapshot modifies session_map_
+	auto ids = it->second;
+	for (const auto& id : ids)
+	{
+		if (auto snap_it = snapshot_map_.find(id); snap_it != snapshot_map_.end())
+		{
+			remove_snapshot(snap_it->second);
+		}
+	}
+}
+
+void result_delta_tracker::clear()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	lru_list_.clear();
+	snapshot_map_.clear();
+	session_map_.clear();
+	memory_usage_ = 0;
+}
+
+size_t result_delta_tracker::snapshot_count() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return snapshot_map_.size();
+}
+
+size_t result_delta_tracker::memory_usage() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return memory_usage_;
+}
+
+const delta_metrics& result_delta_tracker::metrics() const noexcept
+{
+	return metrics_;
+}
+
+const delta_config& result_delta_tracker::config() const noexcept
+{
+	return config_;
+}
+
+void result_delta_tracker::remove_snapshot(snapshot_list::iterator it)
+{
+	const auto& snap = *it;
+
+	if (auto session_it = session_map_.find(snap.session_id); session_it != session_map_.end())
+	{
+		session_it->second.erase(snap.id);
+		if (session_it->second.empty())
+		{
+			session_map_.erase(session_it);
+		}
+	}
+
+	memory_usage_ -= std::min(memory_usage_, snap.estimated_size);
+	snapshot_map_.erase(snap.id);
+	lru_list_.erase(it);
+}
+
+void result_delta_tracker::evict_to_fit(size_t incoming_size)
+{
+	while (!lru_list_.empty()
+		   && (snapshot_map_.size() >= config_.max_snapshots
+			   || memory_usage_ + incoming_size > config_.max_memory_bytes))
+	{
+		remove_snapshot(std::prev(lru_list_.end()));
+		++metrics_.evictions;
+	}
+}
+
+} // namespace database_server::gateway
@@ -0,0 +1,486 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file shared_gcra_limiter.cpp
+ * @brief Implementation of the shared-memory GCRA rate limiter
+ */
+
+#include <kcenon/database_server/gateway/shared_gcra_limiter.h>
+
+#include <algorithm>
+#include <bit>
+#include <new>
+#include <thread>
+#include <utility>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace database_server::gateway
+{
+
+namespace
+{
+
+constexpr uint64_t segment_magic = 0x44425241544C4D54; // "DBRATLMT"
+constexpr uint32_t segment_version = 1;
+constexpr uint32_t min_slots = 64;
+constexpr uint32_t max_slots = uint32_t{1} << 24;
+
+// How long a process that lost the creation race waits for the creator
+constexpr auto init_timeout = std::chrono::seconds(1);
+constexpr auto init_poll_interval = std::chrono::milliseconds(1);
+
+#if defined(__linux__)
+kcenon::common::error_info errno_error(int code, const std::string& what)
+{
+	return kcenon::common::error_info{ code, what + ": " + std::strerror(errno),
+									   "shared_gcra_limiter" };
+}
+#endif
+
+} // namespace
+
+kcenon::common::Result<std::shared_ptr<shared_gcra_limiter>> shared_gcra_limiter::open(
+	const std::string& name, uint32_t requests_per_second, uint32_t burst_size,
+	uint32_t block_duration_ms, uint32_t slots)
+{
+#if !defined(__linux__)
+	(void)name;
+	(void)requests_per_second;
+	(void)burst_size;
+	(void)block_duration_ms;
+	(void)slots;
+	return kcenon::common::error_info{
+		-10, "Shared-memory rate limiting is not supported on this platform",
+		"shared_gcra_limiter"
+	};
+#else
+	if (name.size() < 2 || name.front() != '/' || name.find('/', 1) != std::string::npos)
+	{
+		return kcenon::common::error_info{ -1, "Invalid shared-memory name: " + name,
+										   "shared_gcra_limiter" };
+	}
+
+	auto params = gcra_params::from_rate(requests_per_second, burst_size);
+	auto block_ns = static_cast<int64_t>(block_duration_ms) * 1'000'000;
+	auto slot_count = std::bit_ceil(std::clamp(slots, min_slots, max_slots));
+	auto required_size = sizeof(segment_header) + size_t{slot_count} * sizeof(cell);
+
+	bool created = true;
+	int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (fd < 0 && errno == EEXIST)
+	{
+		created = false;
+		fd = ::shm_open(name.c_str(), O_RDWR, 0);
+	}
+	if (fd < 0)
+	{
+		return errno_error(-2, "shm_open() failed for " + name);
+	}
+
+	size_t mapping_size = required_size;
+	if (created)
+	{
+		if (::ftruncate(fd, static_cast<off_t>(mapping_size)) != 0)
+		{
+			auto error = errno_error(-3, "Failed to size shared segment " + name);
+			::close(fd);
+			::shm_unlink(name.c_str());
+			return error;
+		}
+	}
+	else
+	{
+		// The creator sizes the segment right after creating it
+		struct stat info{};
+		auto deadline = clock::now() + init_timeout;
+		while (::fstat(fd, &info) == 0 && info.st_size == 0 && clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(init_poll_interval);
+		}
+		mapping_size = static_cast<size_t>(std::max<off_t>(info.st_size, 0));
+		if (mapping_size < sizeof(segment_header))
+		{
+			::close(fd);
+			return kcenon::common::error_info{
+				-4, "Shared segment " + name + " was never initialized", "shared_gcra_limiter"
+			};
+		}
+	}
+
+	void* mapping = ::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (mapping == MAP_FAILED)
+	{
+		auto error = errno_error(-5, "mmap() failed for " + name);
+		if (created)
+		{
+			::shm_unlink(name.c_str());
+		}
+		return error;
+	}
+
+	segment_header* header = nullptr;
+	if (created)
+	{
+		// ftruncate() zero-fills, which is the initial state of every cell
+		header = new (mapping) segment_header();
+		header->version = segment_version;
+		header->slot_count = slot_count;
+		header->emission_ns = params.emission_ns;
+		header->tolerance_ns = params.tolerance_ns;
+		header->block_ns = block_ns;
+		header->magic.store(segment_magic, std::memory_order_release);
+	}
+	else
+	{
+		header = static_cast<segment_header*>(mapping);
+		auto deadline = clock::now() + init_timeout;
+		while (header->magic.load(std::memory_order_acquire) != segment_magic
+			   && clock::now() < deadline)
+		{
+			std::this_thread::sleep_for(init_poll_interval);
+		}
+
+		const char* mismatch = nullptr;
+		if (header->magic.load(std::memory_order_acquire) != segment_magic)
+		{
+			mismatch = " was never initialized";
+		}
+		else if (header->version != segment_version || mapping_size < required_size)
+		{
+			mismatch = " has an incompatible layout";
+		}
+		else if (header->slot_count != slot_count || header->emission_ns != params.emission_ns
+				 || header->tolerance_ns != params.tolerance_ns || header->block_ns != block_ns)
+		{
+			mismatch = " was created with a different rate limit configuration";
+		}
+		if (mismatch)
+		{
+			::munmap(mapping, mapping_size);
+			return kcenon::common::error_info{ -6, "Shared segment " + name + mismatch,
+											   "shared_gcra_limiter" };
+		}
+	}
+
+	return std::shared_ptr<shared_gcra_limiter>(
+		new shared_gcra_limiter(name, mapping, mapping_size));
+#endif
+}
+
+kcenon::common::VoidResult shared_gcra_limiter::remove(const std::string& name)
+{
+#if !defined(__linux__)
+	(void)name;
+	return kcenon::common::error_info{
+		-10, "Shared-memory rate limiting is not supported on this platform",
+		"shared_gcra_limiter"
+	};
+#else
+	if (::shm_unlink(name.c_str()) != 0 && errno != ENOENT)
+	{
+		return errno_error(-7, "shm_unlink() failed for " + name);
+	}
+	return kcenon::common::ok();
+#endif
+}
+
+shared_gcra_limiter::shared_gcra_limiter(std::string name, void* mapping, size_t mapping_size)
+	: name_(std::move(name))
+	, mapping_(mapping)
+	, mapping_size_(mapping_size)
+	, header_(static_cast<segment_header*>(mapping))
+	, cells_(reinterpret_cast<cell*>(header_ + 1))
+	, shift_(64 - static_cast<uint32_t>(std::countr_zero(header_->slot_count)))
+	, params_{ header_->emission_ns, header_->tolerance_ns }
+	, block_ns_(header_->block_ns)
+{
+}
+
+shared_gcra_limiter::~shared_gcra_limiter()
+{
+#if defined(__linux__)
+	::munmap(mapping_, mapping_size_);
+#endif
+}
+
+bool shared_gcra_limiter::allow_request(const std::string& client_id)
+{
+	return allow_request(client_id, clock::now());
+}
+
+bool shared_gcra_limiter::allow_request(const std::string& client_id, clock::time_point now)
+{
+	auto now_ns = to_ns(now);
+	auto* state = claim(hash_of(client_id), now_ns);
+	if (!state)
+	{
+		// Failing open keeps a full table from turning into an outage
+		header_->overflows.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+	return update(*state, now_ns);
+}
+
+uint32_t shared_gcra_limiter::remaining_requests(const std::string& client_id) const
+{
+	return remaining_requests(client_id, clock::now());
+}
+
+uint32_t shared_gcra_limiter::remaining_requests(const std::string& client_id,
+												 clock::time_point now) const
+{
+	auto now_ns = to_ns(now);
+	const auto* state = find(hash_of(client_id));
+	if (!state)
+	{
+		return params_.remaining(0, now_ns);
+	}
+	if (state->blocked_until.load(std::memory_order_relaxed) > now_ns)
+	{
+		return 0;
+	}
+	return params_.remaining(state->tat.load(std::memory_order_relaxed), now_ns);
+}
+
+bool shared_gcra_limiter::is_blocked(const std::string& client_id) const
+{
+	return is_blocked(client_id, clock::now());
+}
+
+bool shared_gcra_limiter::is_blocked(const std::string& client_id,
+									 clock::time_point now) const
+{
+	const auto* state = find(hash_of(client_id));
+	return state && state->blocked_until.load(std::memory_order_relaxed) > to_ns(now);
+}
+
+uint64_t shared_gcra_limiter::block_expires_at(const std::string& client_id) const
+{
+	const auto* state = find(hash_of(client_id));
+	if (!state)
+	{
+		return 0;
+	}
+	auto remaining_ns
+		= state->blocked_until.load(std::memory_order_relaxed) - to_ns(clock::now());
+	if (remaining_ns <= 0)
+	{
+		return 0;
+	}
+
+	auto expires = std::chrono::system_clock::now() + std::chrono::nanoseconds(remaining_ns);
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::milliseconds>(expires.time_since_epoch())
+			.count());
+}
+
+void shared_gcra_limiter::reset(const std::string& client_id)
+{
+	// The cell keeps its key so later clients in the probe chain stay reachable
+	if (auto* state = const_cast<cell*>(find(hash_of(client_id))))
+	{
+		state->blocked_until.store(0, std::memory_order_relaxed);
+		state->tat.store(0, std::memory_order_relaxed);
+	}
+}
+
+size_t shared_gcra_limiter::size() const
+{
+	return size(clock::now());
+}
+
+size_t shared_gcra_limiter::size(clock::time_point now) const
+{
+	auto now_ns = to_ns(now);
+	size_t count = 0;
+	for (size_t i = 0; i < capacity(); ++i)
+	{
+		if (cells_[i].key.load(std::memory_order_relaxed) != 0 && !is_idle(cells_[i], now_ns))
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+size_t shared_gcra_limiter::capacity() const noexcept
+{
+	return header_->slot_count;
+}
+
+uint64_t shared_gcra_limiter::overflows() const noexcept
+{
+	return header_->overflows.load(std::memory_order_relaxed);
+}
+
+const gcra_params& shared_gcra_limiter::params() const noexcept
+{
+	return params_;
+}
+
+const std::string& shared_gcra_limiter::name() const noexcept
+{
+	return name_;
+}
+
+int64_t shared_gcra_limiter::to_ns(clock::time_point time) noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch())
+		.count();
+}
+
+uint64_t shared_gcra_limiter::hash_of(const std::string& client_id) noexcept
+{
+	// FNV-1a rather than std::hash: every process and build must agree
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (unsigned char c : client_id)
+	{
+		hash ^= c;
+		hash *= 0x100000001b3ull;
+	}
+	return hash != 0 ? hash : 1; // 0 marks an unused cell
+}
+
+size_t shared_gcra_limiter::index_of(uint64_t hash) const noexcept
+{
+	return static_cast<size_t>((hash * 0x9E3779B97F4A7C15ull) >> shift_);
+}
+
+const shared_gcra_limiter::cell* shared_gcra_limiter::find(uint64_t hash) const noexcept
+{
+	auto mask = capacity() - 1;
+	auto index = index_of(hash);
+	for (size_t probe = 0; probe < max_probes; ++probe)
+	{
+		const auto& candidate = cells_[(index + probe) & mask];
+		auto key = candidate.key.load(std::memory_order_acquire);
+		if (key == hash)
+		{
+			return &candidate;
+		}
+		if (key == 0)
+		{
+			// Cells are never emptied, so the client is not further along
+			return nullptr;
+		}
+	}
+	return nullptr;
+}
+
+shared_gcra_limiter::cell* shared_gcra_limiter::claim(uint64_t hash, int64_t now) noexcept
+{
+	auto mask = capacity() - 1;
+	auto index = index_of(hash);
+	cell* idle = nullptr;
+	for (size_t probe = 0; probe < max_probes; ++probe)
+	{
+		auto& candidate = cells_[(index + probe) & mask];
+		auto key = candidate.key.load(std::memory_order_acquire);
+		if (key == 0)
+		{
+			// Another process may claim the cell first, possibly for this client
+			if (candidate.key.compare_exchange_strong(key, hash, std::memory_order_acq_rel)
+				|| key == hash)
+			{
+				return &candidate;
+			}
+		}
+		if (key == hash)
+		{
+			return &candidate;
+		}
+		if (!idle && is_idle(candidate, now))
+		{
+			idle = &candidate;
+		}
+	}
+
+	// An expired client's state is the same as a fresh one, so take it over
+	while (idle)
+	{
+		auto key = idle->key.load(std::memory_order_acquire);
+		if (key == hash)
+		{
+			return idle;
+		}
+		if (!is_idle(*idle, now))
+		{
+			return nullptr;
+		}
+		if (idle->key.compare_exchange_strong(key, hash, std::memory_order_acq_rel))
+		{
+			return idle;
+		}
+	}
+	return nullptr;
+}
+
+bool shared_gcra_limiter::is_idle(const cell& state, int64_t now) const noexcept
+{
+	return state.tat.load(std::memory_order_relaxed) <= now
+		   && state.blocked_until.load(std::memory_order_relaxed) <= now;
+}
+
+bool shared_gcra_limiter::update(cell& state, int64_t now) noexcept
+{
+	if (state.blocked_until.load(std::memory_order_relaxed) > now)
+	{
+		return false;
+	}
+
+	int64_t tat = state.tat.load(std::memory_order_relaxed);
+	do
+	{
+		if (!params_.conforms(tat, now))
+		{
+			if (block_ns_ > 0)
+			{
+				state.blocked_until.store(now + block_ns_, std::memory_order_relaxed);
+			}
+			return false;
+		}
+	} while (!state.tat.compare_exchange_weak(tat, params_.advance(tat, now),
+											  std::memory_order_relaxed));
+	return true;
+}
+
+} // namespace database_server::gateway
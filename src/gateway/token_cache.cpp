@@ -0,0 +1,346 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <kcenon/database_server/gateway/token_cache.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+
+namespace database_server::gateway
+{
+
+namespace
+{
+
+uint64_t current_timestamp_ms()
+{
+	return static_cast<uint64_t>(
+		std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::system_clock::now().time_since_epoch())
+			.count());
+}
+
+auth_result revoked_result(const auth_token& token)
+{
+	auth_result result;
+	result.success = false;
+	result.code = status_code::authentication_failed;
+	result.message = "Token has been revoked";
+	result.client_id = token.client_id;
+	return result;
+}
+
+} // namespace
+
+size_t token_cache::key_hash::operator()(const sha256_digest& key) const noexcept
+{
+	size_t hash;
+	std::memcpy(&hash, key.data(), sizeof(hash));
+	return hash;
+}
+
+token_cache::token_cache(size_t capacity, uint32_t ttl_ms, uint32_t refresh_window_ms,
+						 uint32_t revocation_ttl_ms, size_t revocation_capacity)
+	: shard_capacity_((capacity + shard_count - 1) / shard_count)
+	, ttl_ms_(ttl_ms)
+	, refresh_window_ms_(refresh_window_ms)
+	, revocation_ttl_ms_(revocation_ttl_ms)
+	, shard_revocation_capacity_(std::max<size_t>(1, (revocation_capacity + shard_count - 1)
+													   / shard_count))
+{
+}
+
+token_cache::shard& token_cache::shard_for(const sha256_digest& key) const noexcept
+{
+	// The bytes key_hash uses pick the bucket within the shard
+	return shards_[key.back() % shard_count];
+}
+
+std::optional<auth_result> token_cache::find(const auth_token& token) const
+{
+	return find(token, current_timestamp_ms());
+}
+
+std::optional<auth_result> token_cache::find(const auth_token& token,
+											 uint64_t now_ms) const
+{
+	auto key = sha256(token.token);
+	auto& target = shard_for(key);
+	std::shared_lock<std::shared_mutex> lock(target.mutex);
+
+	if (auto it = target.revoked.find(key); it != target.revoked.end() && it->second > now_ms)
+	{
+		return revoked_result(token);
+	}
+
+	auto it = target.entries.find(key);
+	if (it == target.entries.end())
+	{
+		return std::nullopt;
+	}
+
+	const auto& cached = it->second;
+	if (cached.valid_until <= now_ms || cached.client_id != token.client_id
+		|| cached.expires_at != token.expires_at)
+	{
+		return std::nullopt;
+	}
+	return cached.result;
+}
+
+bool token_cache::revoked(const auth_token& token, const auth_result& result) const
+{
+	return revoked(token, result, current_timestamp_ms());
+}
+
+bool token_cache::revoked(const auth_token& token, const auth_result& result,
+						  uint64_t now_ms) const
+{
+	// Validators may find the client in the token itself
+	const auto& client_id = result.client_id.empty() ? token.client_id : result.client_id;
+	if (client_revoked(client_id, result.issued_at, now_ms))
+	{
+		return true;
+	}
+
+	auto key = sha256(token.token);
+	auto& target = shard_for(key);
+	std::shared_lock<std::shared_mutex> lock(target.mutex);
+	auto it = target.revoked.find(key);
+	return it != target.revoked.end() && it->second > now_ms;
+}
+
+bool token_cache::client_revoked(const std::string& client_id, uint64_t issued_at,
+								 uint64_t now_ms) const
+{
+	if (revoked_client_count_.load(std::memory_order_acquire) == 0)
+	{
+		return false;
+	}
+
+	std::shared_lock<std::shared_mutex> lock(clients_mutex_);
+	auto it = revoked_clients_.find(client_id);
+	if (it == revoked_clients_.end() || it->second + revocation_ttl_ms_ <= now_ms)
+	{
+		return false;
+	}
+
+	// Without an issue time the token may predate the revocation
+	return issued_at == 0 || issued_at <= it->second;
+}
+
+uint64_t token_cache::epoch() const noexcept
+{
+	return epoch_.load(std::memory_order_acquire);
+}
+
+void token_cache::insert(const auth_token& token, const auth_result& result, uint64_t epoch)
+{
+	insert(token, result, epoch, current_timestamp_ms());
+}
+
+void token_cache::insert(const auth_token& token, const auth_result& result, uint64_t epoch,
+						 uint64_t now_ms)
+{
+	if (!result.success || token.token.empty() || shard_capacity_ == 0)
+	{
+		return;
+	}
+
+	// The earlier of the presented expiry and the one the validator found
+	uint64_t expires_at = token.expires_at;
+	if (result.expires_at != 0 && (expires_at == 0 || result.expires_at < expires_at))
+	{
+		expires_at = result.expires_at;
+	}
+
+	uint64_t valid_until = 0;
+	if (expires_at != 0)
+	{
+		valid_until = expires_at > refresh_window_ms_ ? expires_at - refresh_window_ms_ : 0;
+	}
+	else
+	{
+		valid_until = now_ms + ttl_ms_;
+	}
+	const auto& client_id = result.client_id.empty() ? token.client_id : result.client_id;
+	if (valid_until <= now_ms || client_revoked(client_id, result.issued_at, now_ms))
+	{
+		return;
+	}
+
+	auto key = sha256(token.token);
+	auto& target = shard_for(key);
+	std::unique_lock<std::shared_mutex> lock(target.mutex);
+
+	// Checked under the shard lock: revoke() bumps the epoch before taking
+	// it, so a revocation either is seen here or finds this entry
+	if (epoch_.load(std::memory_order_acquire) != epoch)
+	{
+		return;
+	}
+	if (auto it = target.revoked.find(key); it != target.revoked.end() && it->second > now_ms)
+	{
+		return;
+	}
+
+	auto it = target.entries.find(key);
+	if (it == target.entries.end())
+	{
+		make_room(target, now_ms);
+		it = target.entries.emplace(key, entry{}).first;
+	}
+
+	auto& cached = it->second;
+	cached.client_id = token.client_id;
+	cached.expires_at = token.expires_at;
+	cached.valid_until = valid_until;
+	cached.result = result;
+	cached.accepted_until = expires_at;
+}
+
+void token_cache::make_room(shard& target, uint64_t now_ms)
+{
+	std::erase_if(target.entries,
+				  [now_ms](const auto& item) { return item.second.valid_until <= now_ms; });
+
+	for (auto it = target.entries.begin();
+		 target.entries.size() >= shard_capacity_ && it != target.entries.end();)
+	{
+		it = target.entries.erase(it);
+	}
+}
+
+bool token_cache::revoke(const std::string& token)
+{
+	return revoke(token, current_timestamp_ms());
+}
+
+bool token_cache::revoke(const std::string& token, uint64_t now_ms)
+{
+	epoch_.fetch_add(1, std::memory_order_acq_rel);
+
+	auto key = sha256(token);
+	auto& target = shard_for(key);
+	std::unique_lock<std::shared_mutex> lock(target.mutex);
+
+	// Keep the revocation as long as the token could still be accepted
+	uint64_t until = now_ms + revocation_ttl_ms_;
+	if (auto it = target.entries.find(key); it != target.entries.end())
+	{
+		if (it->second.accepted_until != 0)
+		{
+			until = it->second.accepted_until;
+		}
+		target.entries.erase(it);
+	}
+
+	if (auto it = target.revoked.find(key); it != target.revoked.end())
+	{
+		it->second = std::max(it->second, until);
+		return true;
+	}
+
+	if (target.revoked.size() >= shard_revocation_capacity_)
+	{
+		std::erase_if(target.revoked,
+					  [now_ms](const auto& item) { return item.second <= now_ms; });
+		if (target.revoked.size() >= shard_revocation_capacity_)
+		{
+			return false;
+		}
+	}
+	target.revoked.emplace(key, until);
+	return true;
+}
+
+size_t token_cache::revoke_client(const std::string& client_id)
+{
+	return revoke_client(client_id, current_timestamp_ms());
+}
+
+size_t token_cache::revoke_client(const std::string& client_id, uint64_t now_ms)
+{
+	epoch_.fetch_add(1, std::memory_order_acq_rel);
+
+	{
+		std::unique_lock<std::shared_mutex> lock(clients_mutex_);
+		std::erase_if(revoked_clients_,
+					  [this, now_ms](const auto& item)
+					  { return item.second + revocation_ttl_ms_ <= now_ms; });
+		revoked_clients_[client_id] = now_ms;
+		revoked_client_count_.store(revoked_clients_.size(), std::memory_order_release);
+	}
+
+	size_t dropped = 0;
+	for (auto& target : shards_)
+	{
+		std::unique_lock<std::shared_mutex> lock(target.mutex);
+		dropped += std::erase_if(target.entries,
+								 [&client_id](const auto& item)
+								 {
+									 return item.second.client_id == client_id
+											|| item.second.result.client_id == client_id;
+								 });
+	}
+	return dropped;
+}
+
+void token_cache::clear()
+{
+	epoch_.fetch_add(1, std::memory_order_acq_rel);
+
+	for (auto& target : shards_)
+	{
+		std::unique_lock<std::shared_mutex> lock(target.mutex);
+		target.entries.clear();
+		target.revoked.clear();
+	}
+
+	std::unique_lock<std::shared_mutex> lock(clients_mutex_);
+	revoked_clients_.clear();
+	revoked_client_count_.store(0, std::memory_order_release);
+}
+
+size_t token_cache::size() const
+{
+	size_t total = 0;
+	for (const auto& target : shards_)
+	{
+		std::shared_lock<std::shared_mutex> lock(target.mutex);
+		total += target.entries.size() + target.revoked.size();
+	}
+	return total;
+}
+
+} // namespace database_server::gateway
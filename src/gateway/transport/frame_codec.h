@@ -0,0 +1,128 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file frame_codec.h
+ * @brief Length-prefixed message framing for stream transports
+ *
+ * Internal header shared by the stream listeners in src/gateway/transport.
+ * Each message is preceded by a 4-byte big-endian length. Stream sockets
+ * deliver arbitrary chunks, so frame_decoder reassembles complete messages.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace database_server::gateway::transport_detail
+{
+
+/// Size of the length prefix in bytes
+inline constexpr size_t frame_header_size = 4;
+
+/**
+ * @brief Encode a frame length prefix
+ */
+inline std::array<uint8_t, frame_header_size> encode_frame_header(uint32_t length) noexcept
+{
+	return {static_cast<uint8_t>(length >> 24), static_cast<uint8_t>(length >> 16),
+			static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)};
+}
+
+/**
+ * @brief Decode a frame length prefix
+ */
+inline uint32_t decode_frame_header(const uint8_t* header) noexcept
+{
+	return (static_cast<uint32_t>(header[0]) << 24) | (static_cast<uint32_t>(header[1]) << 16)
+		   | (static_cast<uint32_t>(header[2]) << 8) | static_cast<uint32_t>(header[3]);
+}
+
+/**
+ * @class frame_decoder
+ * @brief Reassembles length-prefixed frames from a byte stream
+ */
+class frame_decoder
+{
+public:
+	explicit frame_decoder(size_t max_frame_bytes) : max_frame_bytes_(max_frame_bytes) {}
+
+	/**
+	 * @brief Append received bytes and extract every complete frame
+	 * @param data Received bytes
+	 * @param size Number of bytes
+	 * @param frames Output for complete frame payloads
+	 * @return false if a frame exceeds the size limit (connection must be closed)
+	 */
+	bool feed(const uint8_t* data, size_t size, std::vector<std::vector<uint8_t>>& frames)
+	{
+		buffer_.insert(buffer_.end(), data, data + size);
+
+		size_t offset = 0;
+		while (buffer_.size() - offset >= frame_header_size)
+		{
+			auto length = decode_frame_header(buffer_.data() + offset);
+			if (length > max_frame_bytes_)
+			{
+				return false;
+			}
+			if (buffer_.size() - offset - frame_header_size < length)
+			{
+				break;
+			}
+
+			auto begin = buffer_.begin() + static_cast<std::ptrdiff_t>(offset + frame_header_size);
+			frames.emplace_back(begin, begin + length);
+			offset += frame_header_size + length;
+		}
+
+		if (offset > 0)
+		{
+			buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(offset));
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Get number of buffered bytes not yet forming a complete frame
+	 */
+	[[nodiscard]] size_t pending_bytes() const noexcept { return buffer_.size(); }
+
+private:
+	size_t max_frame_bytes_;
+	std::vector<uint8_t> buffer_;
+};
+
+} // namespace database_server::gateway::transport_detail
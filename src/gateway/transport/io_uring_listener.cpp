@@ -0,0 +1,1609 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file io_uring_listener.cpp
+ * @brief Implementation of the io_uring TCP listener
+ */
+
+#include <kcenon/database_server/gateway/io_uring_listener.h>
+
+#include "frame_codec.h"
+
+#include <array>
+#include <deque>
+#include <vector>
+
+#if DATABASE_SERVER_HAS_IO_URING
+#include "socket_utils.h"
+
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <future>
+#include <optional>
+
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace database_server::gateway
+{
+
+#if DATABASE_SERVER_HAS_IO_URING
+
+namespace transport_detail
+{
+
+namespace
+{
+
+/**
+ * @class uring
+ * @brief Minimal io_uring instance using the raw system calls
+ *
+ * Covers what the listener needs: SQE allocation, batched submission,
+ * completion draining and provided-buffer ring registration. All methods
+ * must be called from the thread that created the ring.
+ */
+class uring
+{
+public:
+	uring() = default;
+
+	~uring() { close(); }
+
+	uring(const uring&) = delete;
+	uring& operator=(const uring&) = delete;
+
+	/**
+	 * @brief Create the ring and map its queues
+	 * @return 0 on success, negative errno on failure
+	 */
+	int init(unsigned entries, unsigned cq_entries)
+	{
+		// Single-issuer rings with deferred task work avoid cross-thread
+		// wakeups for completions; fall back to defaults on older kernels
+		io_uring_params params{};
+		params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_COOP_TASKRUN
+					   | IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+		params.cq_entries = cq_entries;
+		fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+		if (fd_ < 0 && errno == EINVAL)
+		{
+			params = {};
+			params.flags = IORING_SETUP_CQSIZE;
+			params.cq_entries = cq_entries;
+			fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+		}
+		if (fd_ < 0)
+		{
+			return -errno;
+		}
+		if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP))
+		{
+			return -ENOSYS;
+		}
+
+		ring_size_ = std::max<size_t>(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+									  params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+		void* ring = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+							fd_, IORING_OFF_SQ_RING);
+		if (ring == MAP_FAILED)
+		{
+			return -errno;
+		}
+		ring_ = static_cast<uint8_t*>(ring);
+
+		sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+		void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+							fd_, IORING_OFF_SQES);
+		if (sqes == MAP_FAILED)
+		{
+			return -errno;
+		}
+		sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+		sq_head_ = reinterpret_cast<unsigned*>(ring_ + params.sq_off.head);
+		sq_tail_ = reinterpret_cast<unsigned*>(ring_ + params.sq_off.tail);
+		sq_mask_ = *reinterpret_cast<unsigned*>(ring_ + params.sq_off.ring_mask);
+		sq_entries_ = params.sq_entries;
+		auto* array = reinterpret_cast<unsigned*>(ring_ + params.sq_off.array);
+		for (unsigned i = 0; i < sq_entries_; ++i)
+		{
+			array[i] = i;
+		}
+		sqe_tail_ = *sq_tail_;
+
+		cq_head_ = reinterpret_cast<unsigned*>(ring_ + params.cq_off.head);
+		cq_tail_ = reinterpret_cast<unsigned*>(ring_ + params.cq_off.tail);
+		cq_mask_ = *reinterpret_cast<unsigned*>(ring_ + params.cq_off.ring_mask);
+		cqes_ = reinterpret_cast<io_uring_cqe*>(ring_ + params.cq_off.cqes);
+		return 0;
+	}
+
+	void close()
+	{
+		if (sqes_ != nullptr)
+		{
+			::munmap(sqes_, sqes_size_);
+			sqes_ = nullptr;
+		}
+		if (ring_ != nullptr)
+		{
+			::munmap(ring_, ring_size_);
+			ring_ = nullptr;
+		}
+		if (fd_ >= 0)
+		{
+			::close(fd_);
+			fd_ = -1;
+		}
+	}
+
+	/**
+	 * @brief Get a zeroed SQE, submitting queued ones first if the queue is full
+	 * @return nullptr if no entry is available
+	 */
+	io_uring_sqe* get_sqe()
+	{
+		if (sqe_tail_ - load_acquire(sq_head_) >= sq_entries_)
+		{
+			(void)submit(0);
+			if (sqe_tail_ - load_acquire(sq_head_) >= sq_entries_)
+			{
+				return nullptr;
+			}
+		}
+		auto* sqe = &sqes_[sqe_tail_ & sq_mask_];
+		++sqe_tail_;
+		std::memset(sqe, 0, sizeof(*sqe));
+		return sqe;
+	}
+
+	/**
+	 * @brief Submit queued SQEs and wait for completions in one system call
+	 * @return Number of SQEs consumed, or negative errno
+	 */
+	int submit(unsigned wait_nr)
+	{
+		std::atomic_ref<unsigned>(*sq_tail_).store(sqe_tail_, std::memory_order_release);
+		while (true)
+		{
+			unsigned pending = sqe_tail_ - load_acquire(sq_head_);
+
+			// GETEVENTS is always passed: with deferred task work it is what
+			// lets the kernel post completions
+			auto ret = ::syscall(__NR_io_uring_enter, fd_, pending, wait_nr,
+								 IORING_ENTER_GETEVENTS, nullptr, 0);
+			++enter_calls_;
+			if (ret >= 0)
+			{
+				sqes_submitted_ += static_cast<uint64_t>(ret);
+				return static_cast<int>(ret);
+			}
+			if (errno != EINTR)
+			{
+				return -errno;
+			}
+		}
+	}
+
+	/**
+	 * @brief Invoke a handler for every available completion
+	 *
+	 * Each CQE is copied and released before its handler runs, so handlers
+	 * may queue and submit new requests.
+	 */
+	template<typename Handler>
+	unsigned drain(Handler&& handler)
+	{
+		unsigned handled = 0;
+		unsigned head = *cq_head_;
+		while (head != load_acquire(cq_tail_))
+		{
+			io_uring_cqe cqe = cqes_[head & cq_mask_];
+			++head;
+			std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+			handler(cqe);
+			++handled;
+		}
+		cqes_processed_ += handled;
+		return handled;
+	}
+
+	/**
+	 * @brief Register a provided-buffer ring
+	 * @return 0 on success, negative errno on failure
+	 */
+	int register_buffer_ring(void* ring, unsigned entries, uint16_t group)
+	{
+		io_uring_buf_reg registration{};
+		registration.ring_addr = reinterpret_cast<uint64_t>(ring);
+		registration.ring_entries = entries;
+		registration.bgid = group;
+		if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &registration, 1) < 0)
+		{
+			return -errno;
+		}
+		return 0;
+	}
+
+	[[nodiscard]] uint64_t enter_calls() const noexcept { return enter_calls_; }
+	[[nodiscard]] uint64_t sqes_submitted() const noexcept { return sqes_submitted_; }
+	[[nodiscard]] uint64_t cqes_processed() const noexcept { return cqes_processed_; }
+
+private:
+	static unsigned load_acquire(unsigned* value)
+	{
+		return std::atomic_ref<unsigned>(*value).load(std::memory_order_acquire);
+	}
+
+	int fd_ = -1;
+	uint8_t* ring_ = nullptr;
+	size_t ring_size_ = 0;
+	io_uring_sqe* sqes_ = nullptr;
+	size_t sqes_size_ = 0;
+
+	unsigned* sq_head_ = nullptr;
+	unsigned* sq_tail_ = nullptr;
+	unsigned sq_mask_ = 0;
+	unsigned sq_entries_ = 0;
+	unsigned sqe_tail_ = 0;
+
+	unsigned* cq_head_ = nullptr;
+	unsigned* cq_tail_ = nullptr;
+	unsigned cq_mask_ = 0;
+	io_uring_cqe* cqes_ = nullptr;
+
+	uint64_t enter_calls_ = 0;
+	uint64_t sqes_submitted_ = 0;
+	uint64_t cqes_processed_ = 0;
+};
+
+/// Operation kind stored in the top byte of user_data; the rest is the session key
+enum class uring_op : uint64_t
+{
+	accept = 1,
+	wake = 2,
+	recv = 3,
+	send = 4,
+	cancel = 5,
+	provide = 6
+};
+
+constexpr uint64_t key_mask = (uint64_t{1} << 56) - 1;
+constexpr uint16_t buffer_group = 0;
+constexpr size_t max_frames_per_send = IOV_MAX / 2;
+
+constexpr uint64_t encode(uring_op op, uint64_t key = 0)
+{
+	return (static_cast<uint64_t>(op) << 56) | key;
+}
+
+} // namespace
+
+/**
+ * @brief Sessions with queued responses, shared between senders and the I/O thread
+ *
+ * Held by every session so a late send() after the listener stopped fails
+ * cleanly instead of touching a destroyed engine.
+ */
+struct io_uring_send_queue
+{
+	std::mutex mutex;
+	std::vector<std::shared_ptr<io_uring_session>> pending;
+	std::thread::id io_thread;
+	bool open = true;
+	int event_fd = -1;
+
+	~io_uring_send_queue()
+	{
+		if (event_fd >= 0)
+		{
+			::close(event_fd);
+		}
+	}
+
+	/**
+	 * @brief Queue a session for sending
+	 * @return false if the listener has stopped
+	 */
+	bool push(std::shared_ptr<io_uring_session> session)
+	{
+		bool notify = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (!open)
+			{
+				return false;
+			}
+			pending.push_back(std::move(session));
+
+			// Sends issued from the I/O thread (inside a receive callback)
+			// are flushed at the end of the current loop iteration
+			notify = pending.size() == 1 && std::this_thread::get_id() != io_thread;
+		}
+		if (notify)
+		{
+			uint64_t one = 1;
+			(void)!::write(event_fd, &one, sizeof(one));
+		}
+		return true;
+	}
+};
+
+/**
+ * @brief Queued frames taken for one vectored send
+ */
+struct send_batch
+{
+	std::vector<std::vector<uint8_t>> payloads;
+	std::vector<std::array<uint8_t, frame_header_size>> headers;
+	std::vector<struct iovec> iov;
+	struct msghdr message{};
+	size_t next = 0;
+
+	[[nodiscard]] bool empty() const noexcept { return next >= iov.size(); }
+
+	void build()
+	{
+		headers.resize(payloads.size());
+		iov.clear();
+		iov.reserve(payloads.size() * 2);
+		for (size_t i = 0; i < payloads.size(); ++i)
+		{
+			headers[i] = encode_frame_header(static_cast<uint32_t>(payloads[i].size()));
+			iov.push_back({headers[i].data(), headers[i].size()});
+			if (!payloads[i].empty())
+			{
+				iov.push_back({payloads[i].data(), payloads[i].size()});
+			}
+		}
+		next = 0;
+		update_message();
+	}
+
+	void advance(size_t bytes)
+	{
+		while (next < iov.size() && bytes >= iov[next].iov_len)
+		{
+			bytes -= iov[next].iov_len;
+			++next;
+		}
+		if (next < iov.size())
+		{
+			iov[next].iov_base = static_cast<uint8_t*>(iov[next].iov_base) + bytes;
+			iov[next].iov_len -= bytes;
+		}
+		update_message();
+	}
+
+	void clear()
+	{
+		payloads.clear();
+		iov.clear();
+		next = 0;
+	}
+
+private:
+	void update_message()
+	{
+		message = {};
+		message.msg_iov = iov.data() + next;
+		message.msg_iovlen = iov.size() - next;
+	}
+};
+
+} // namespace transport_detail
+
+// ============================================================================
+// io_uring_session
+// ============================================================================
+
+/**
+ * @class io_uring_session
+ * @brief One accepted TCP connection driven by the io_uring engine
+ *
+ * The descriptor is owned by the session and closed when the last
+ * reference is released; the engine keeps a reference while any request
+ * for the connection is in flight. A session detached for handoff gives
+ * up the descriptor instead.
+ */
+class io_uring_session : public session_transport,
+						 public std::enable_shared_from_this<io_uring_session>
+{
+public:
+	io_uring_session(int fd, uint64_t key, std::string id,
+					 std::shared_ptr<transport_detail::io_uring_send_queue> queue,
+					 const io_uring_config& config)
+		: fd_(fd)
+		, key_(key)
+		, id_(std::move(id))
+		, queue_(std::move(queue))
+		, max_send_queue_bytes_(config.max_send_queue_bytes)
+		, decoder_(config.max_frame_bytes)
+	{
+	}
+
+	~io_uring_session() override
+	{
+		if (!released_)
+		{
+			::close(fd_);
+		}
+	}
+
+	[[nodiscard]] std::string_view id() const override { return id_; }
+
+	[[nodiscard]] bool is_connected() const override { return connected_.load(); }
+
+	[[nodiscard]] kcenon::common::VoidResult send(std::vector<uint8_t>&& data) override
+	{
+		if (data.size() > UINT32_MAX)
+		{
+			return kcenon::common::error_info{ -1, "Message too large", "io_uring_listener" };
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			if (!connected_.load())
+			{
+				return kcenon::common::error_info{ -2, "Session closed", "io_uring_listener" };
+			}
+
+			if (queued_bytes_ + data.size() <= max_send_queue_bytes_)
+			{
+				queued_bytes_ += data.size();
+				outbound_.push_back(std::move(data));
+				if (queued_)
+				{
+					return kcenon::common::ok();
+				}
+				queued_ = true;
+			}
+			else
+			{
+				queued_bytes_ = max_send_queue_bytes_ + 1;
+			}
+		}
+
+		// A client that stops reading must not grow the queue without bound
+		if (queued_bytes_ > max_send_queue_bytes_ || !queue_->push(shared_from_this()))
+		{
+			close();
+			return kcenon::common::error_info{ -4, "Send queue full or listener stopped",
+											   "io_uring_listener" };
+		}
+		return kcenon::common::ok();
+	}
+
+	void close() override
+	{
+		// The pending receive completes with end-of-stream and the engine
+		// releases the session
+		if (connected_.exchange(false))
+		{
+			::shutdown(fd_, SHUT_RDWR);
+		}
+	}
+
+	[[nodiscard]] std::optional<peer_credentials> peer() const override { return std::nullopt; }
+
+	[[nodiscard]] std::string_view transport_name() const override { return "io_uring"; }
+
+	// ---- I/O thread only ----
+
+	/**
+	 * @brief Move queued frames into the send batch
+	 * @return true if there is anything to send
+	 */
+	bool take_batch()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			auto count = std::min(outbound_.size(), transport_detail::max_frames_per_send);
+			for (size_t i = 0; i < count; ++i)
+			{
+				queued_bytes_ -= outbound_.front().size();
+				batch_.payloads.push_back(std::move(outbound_.front()));
+				outbound_.pop_front();
+			}
+			if (outbound_.empty())
+			{
+				queued_ = false;
+			}
+		}
+		batch_.build();
+		return !batch_.empty();
+	}
+
+	/**
+	 * @brief Give up the descriptor without shutting it down
+	 * @return false if the session is closed or has queued responses
+	 */
+	bool detach()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if (!outbound_.empty() || !connected_.exchange(false))
+		{
+			return false;
+		}
+		released_ = true;
+		return true;
+	}
+
+	[[nodiscard]] int fd() const noexcept { return fd_; }
+	[[nodiscard]] uint64_t key() const noexcept { return key_; }
+
+	transport_detail::frame_decoder& decoder() noexcept { return decoder_; }
+	transport_detail::send_batch& batch() noexcept { return batch_; }
+
+	bool recv_armed = false;
+	bool send_inflight = false;
+	bool closing = false;
+	bool releasing = false;       ///< Receive cancelled for a handoff
+	bool release_aborted = false; ///< Traffic arrived while releasing
+
+private:
+	int fd_;
+	uint64_t key_;
+	std::string id_;
+	std::shared_ptr<transport_detail::io_uring_send_queue> queue_;
+	size_t max_send_queue_bytes_;
+	std::atomic<bool> connected_{true};
+	bool released_ = false;
+
+	std::mutex mutex_;
+	std::deque<std::vector<uint8_t>> outbound_;
+	size_t queued_bytes_ = 0;
+	bool queued_ = false; ///< In the send queue or picked up by the engine
+
+	transport_detail::frame_decoder decoder_;
+	transport_detail::send_batch batch_;
+};
+
+// ============================================================================
+// io_uring_engine
+// ============================================================================
+
+namespace transport_detail
+{
+
+/**
+ * @class io_uring_engine
+ * @brief Ring, buffers and connection state owned by the I/O thread
+ */
+class io_uring_engine
+{
+public:
+	explicit io_uring_engine(io_uring_listener& listener)
+		: listener_(listener)
+		, config_(listener.config_)
+		, queue_(std::make_shared<io_uring_send_queue>())
+	{
+	}
+
+	~io_uring_engine()
+	{
+		// Release the ring before the buffer memory it references
+		ring_.close();
+		if (buffer_ring_ != nullptr)
+		{
+			::munmap(buffer_ring_, buffer_ring_size_);
+		}
+		if (buffers_ != nullptr)
+		{
+			::munmap(buffers_, buffers_size_);
+		}
+	}
+
+	/**
+	 * @brief Create the ring and register receive buffers (on the I/O thread)
+	 */
+	kcenon::common::VoidResult setup()
+	{
+		queue_->io_thread = std::this_thread::get_id();
+		queue_->event_fd = ::eventfd(0, EFD_CLOEXEC);
+		if (queue_->event_fd < 0)
+		{
+			return errno_error(-20, "eventfd() failed", "io_uring_listener");
+		}
+
+		auto depth = std::max(config_.queue_depth, 64u);
+		if (int rc = ring_.init(depth, depth * 4); rc < 0)
+		{
+			return kcenon::common::error_info{
+				-21, std::string("io_uring setup failed: ") + std::strerror(-rc), "io_uring_listener"
+			};
+		}
+
+		buffer_count_ = std::bit_ceil(std::clamp(config_.buffer_count, 1u, 32768u));
+		buffer_size_ = std::max(config_.buffer_size, 1024u);
+		buffer_ring_size_ = buffer_count_ * sizeof(io_uring_buf);
+		buffers_size_ = static_cast<size_t>(buffer_count_) * buffer_size_;
+
+		void* ring_memory = ::mmap(nullptr, buffer_ring_size_, PROT_READ | PROT_WRITE,
+								   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		void* buffer_memory = ::mmap(nullptr, buffers_size_, PROT_READ | PROT_WRITE,
+									 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		buffer_ring_ = ring_memory == MAP_FAILED ? nullptr : static_cast<io_uring_buf*>(ring_memory);
+		buffers_ = buffer_memory == MAP_FAILED ? nullptr : static_cast<uint8_t*>(buffer_memory);
+		if (buffer_ring_ == nullptr || buffers_ == nullptr)
+		{
+			return errno_error(-22, "Failed to allocate receive buffers", "io_uring_listener");
+		}
+
+		// Kernels before 5.19 lack provided-buffer rings; hand the same
+		// buffers over with IORING_OP_PROVIDE_BUFFERS there
+		use_buffer_ring_ = ring_.register_buffer_ring(buffer_ring_, buffer_count_, buffer_group) == 0;
+		if (use_buffer_ring_)
+		{
+			for (uint32_t id = 0; id < buffer_count_; ++id)
+			{
+				recycle(static_cast<uint16_t>(id));
+			}
+			publish_buffers();
+		}
+		else
+		{
+			auto* sqe = ring_.get_sqe();
+			sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+			sqe->fd = static_cast<int>(buffer_count_);
+			sqe->addr = reinterpret_cast<uint64_t>(buffers_);
+			sqe->len = buffer_size_;
+			sqe->buf_group = buffer_group;
+			sqe->user_data = encode(uring_op::provide);
+
+			io_uring_cqe result{};
+			if (ring_.submit(1) < 0 || ring_.drain([&result](const io_uring_cqe& cqe) { result = cqe; }) == 0
+				|| result.res < 0)
+			{
+				return kcenon::common::error_info{
+					-23, "Failed to register receive buffers", "io_uring_listener"
+				};
+			}
+		}
+
+		arm_wake();
+		arm_accept();
+		return kcenon::common::ok();
+	}
+
+	/**
+	 * @brief Event loop; returns after the listener is stopped and all I/O has drained
+	 */
+	void run()
+	{
+		while (listener_.running_.load())
+		{
+			run_tasks();
+			flush_sends();
+			rearm_receives();
+
+			int rc = ring_.submit(1);
+			if (rc < 0 && rc != -EBUSY && rc != -EAGAIN)
+			{
+				break;
+			}
+
+			ring_.drain([this](const io_uring_cqe& cqe) { handle(cqe); });
+			publish_buffers();
+			publish_stats();
+		}
+
+		shutdown();
+	}
+
+	/**
+	 * @brief Wake the I/O thread (any thread)
+	 */
+	void wake()
+	{
+		uint64_t one = 1;
+		(void)!::write(queue_->event_fd, &one, sizeof(one));
+	}
+
+	/**
+	 * @brief Serve a connection accepted by this or another process
+	 */
+	void add_connection(int fd)
+	{
+		if (stopping_ || listener_.sessions_.size() >= config_.max_connections)
+		{
+			::close(fd);
+			return;
+		}
+
+		int one = 1;
+		::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		auto key = ++next_key_;
+		auto session = std::make_shared<io_uring_session>(
+			fd, key, "uring-" + std::to_string(key), queue_, config_);
+		{
+			std::lock_guard<std::mutex> lock(listener_.sessions_mutex_);
+			listener_.sessions_[key] = session;
+		}
+		listener_.connections_accepted_.fetch_add(1, std::memory_order_relaxed);
+
+		arm_recv(session);
+
+		if (listener_.connection_callback_)
+		{
+			listener_.connection_callback_(session);
+		}
+	}
+
+	/**
+	 * @brief Start detaching idle connections
+	 *
+	 * The multishot receive of every candidate is cancelled; a connection
+	 * is detached once its receive has ended without further traffic. The
+	 * promise is fulfilled when all candidates are settled.
+	 */
+	void begin_release(const std::function<bool(std::string_view)>& eligible,
+					   std::shared_ptr<std::promise<std::vector<int>>> promise)
+	{
+		if (stopping_ || release_)
+		{
+			promise->set_value({});
+			return;
+		}
+
+		release_.emplace();
+		release_->promise = std::move(promise);
+
+		std::vector<std::shared_ptr<io_uring_session>> candidates;
+		for (const auto& [key, session] : listener_.sessions_)
+		{
+			candidates.push_back(session);
+		}
+
+		for (const auto& session : candidates)
+		{
+			// A receive waiting for re-arm ran out of buffers, so data is pending
+			if (session->closing || !session->recv_armed || session->send_inflight
+				|| !session->batch().empty() || session->decoder().pending_bytes() > 0
+				|| (eligible && !eligible(session->id())))
+			{
+				continue;
+			}
+
+			auto* sqe = ring_.get_sqe();
+			if (sqe == nullptr)
+			{
+				break;
+			}
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->addr = encode(uring_op::recv, session->key());
+			sqe->user_data = encode(uring_op::cancel);
+			session->releasing = true;
+			session->release_aborted = false;
+			++release_->waiting;
+		}
+
+		complete_release();
+	}
+
+private:
+	struct release_request
+	{
+		std::shared_ptr<std::promise<std::vector<int>>> promise;
+		std::vector<int> fds;
+		size_t waiting = 0;
+	};
+
+	void run_tasks()
+	{
+		std::vector<std::function<void()>> tasks;
+		{
+			std::lock_guard<std::mutex> lock(listener_.tasks_mutex_);
+			tasks.swap(listener_.tasks_);
+		}
+		for (auto& task : tasks)
+		{
+			task();
+		}
+	}
+
+	/**
+	 * @brief Settle a releasing session after its receive has ended
+	 */
+	void finish_release(const std::shared_ptr<io_uring_session>& session)
+	{
+		session->releasing = false;
+		--release_->waiting;
+
+		if (!session->release_aborted && !session->closing && !stopping_
+			&& !session->send_inflight && session->batch().empty() && session->detach())
+		{
+			session->closing = true;
+			{
+				std::lock_guard<std::mutex> lock(listener_.sessions_mutex_);
+				listener_.sessions_.erase(session->key());
+			}
+			if (listener_.disconnection_callback_)
+			{
+				listener_.disconnection_callback_(session->id());
+			}
+			release_->fds.push_back(session->fd());
+		}
+		else if (!session->closing && !stopping_)
+		{
+			rearm_.push_back(session);
+		}
+
+		complete_release();
+	}
+
+	void complete_release()
+	{
+		if (release_ && release_->waiting == 0)
+		{
+			release_->promise->set_value(std::move(release_->fds));
+			release_.reset();
+		}
+	}
+
+	// ---- request submission ----
+
+	void arm_accept()
+	{
+		auto* sqe = ring_.get_sqe();
+		if (sqe == nullptr)
+		{
+			return;
+		}
+		sqe->opcode = IORING_OP_ACCEPT;
+		sqe->fd = listener_.listen_fd_;
+		sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+		sqe->accept_flags = SOCK_CLOEXEC;
+		sqe->user_data = encode(uring_op::accept);
+		accepting_ = true;
+		++outstanding_;
+	}
+
+	void arm_wake()
+	{
+		auto* sqe = ring_.get_sqe();
+		if (sqe == nullptr)
+		{
+			return;
+		}
+		sqe->opcode = IORING_OP_READ;
+		sqe->fd = queue_->event_fd;
+		sqe->addr = reinterpret_cast<uint64_t>(&wake_value_);
+		sqe->len = sizeof(wake_value_);
+		sqe->user_data = encode(uring_op::wake);
+		++outstanding_;
+	}
+
+	void arm_recv(const std::shared_ptr<io_uring_session>& session)
+	{
+		auto* sqe = ring_.get_sqe();
+		if (sqe == nullptr)
+		{
+			rearm_.push_back(session);
+			return;
+		}
+		sqe->opcode = IORING_OP_RECV;
+		sqe->fd = session->fd();
+		sqe->flags = IOSQE_BUFFER_SELECT;
+		sqe->buf_group = buffer_group;
+		sqe->ioprio = IORING_RECV_MULTISHOT;
+		sqe->user_data = encode(uring_op::recv, session->key());
+		session->recv_armed = true;
+		++outstanding_;
+	}
+
+	void submit_send(const std::shared_ptr<io_uring_session>& session)
+	{
+		if (session->send_inflight || session->closing)
+		{
+			return;
+		}
+		if (session->batch().empty() && !session->take_batch())
+		{
+			return;
+		}
+
+		auto* sqe = ring_.get_sqe();
+		if (sqe == nullptr)
+		{
+			retry_sends_.push_back(session);
+			return;
+		}
+		sqe->opcode = IORING_OP_SENDMSG;
+		sqe->fd = session->fd();
+		sqe->addr = reinterpret_cast<uint64_t>(&session->batch().message);
+		sqe->len = 1;
+		sqe->msg_flags = MSG_NOSIGNAL;
+		sqe->user_data = encode(uring_op::send, session->key());
+		session->send_inflight = true;
+		++outstanding_;
+	}
+
+	void flush_sends()
+	{
+		std::vector<std::shared_ptr<io_uring_session>> pending;
+		{
+			std::lock_guard<std::mutex> lock(queue_->mutex);
+			pending.swap(queue_->pending);
+		}
+		pending.insert(pending.end(), retry_sends_.begin(), retry_sends_.end());
+		retry_sends_.clear();
+
+		for (const auto& session : pending)
+		{
+			submit_send(session);
+		}
+	}
+
+	void rearm_receives()
+	{
+		if (!listener_.accept_enabled_.load(std::memory_order_relaxed))
+		{
+			// The listening socket now belongs to another process
+			accept_paused_ = false;
+			if (accepting_ && !accept_cancelled_)
+			{
+				if (auto* sqe = ring_.get_sqe())
+				{
+					sqe->opcode = IORING_OP_ASYNC_CANCEL;
+					sqe->addr = encode(uring_op::accept);
+					sqe->user_data = encode(uring_op::cancel);
+					accept_cancelled_ = true;
+				}
+			}
+		}
+		else if (accept_paused_ && listener_.sessions_.size() < config_.max_connections)
+		{
+			accept_paused_ = false;
+			arm_accept();
+		}
+
+		auto sessions = std::move(rearm_);
+		rearm_.clear();
+		for (const auto& session : sessions)
+		{
+			if (!session->recv_armed && !session->closing)
+			{
+				arm_recv(session);
+			}
+		}
+	}
+
+	// ---- completion handling ----
+
+	void handle(const io_uring_cqe& cqe)
+	{
+		auto op = static_cast<uring_op>(cqe.user_data >> 56);
+		auto key = cqe.user_data & key_mask;
+		bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+
+		switch (op)
+		{
+		case uring_op::accept:
+			on_accept(cqe.res);
+			if (!more)
+			{
+				--outstanding_;
+				accepting_ = false;
+				// Out of descriptors: wait for a connection to close before retrying
+				if (!stopping_ && listener_.accept_enabled_.load(std::memory_order_relaxed))
+				{
+					if (cqe.res == -EMFILE || cqe.res == -ENFILE)
+					{
+						accept_paused_ = true;
+					}
+					else
+					{
+						arm_accept();
+					}
+				}
+			}
+			break;
+		case uring_op::wake:
+			--outstanding_;
+			if (!stopping_)
+			{
+				arm_wake();
+			}
+			break;
+		case uring_op::recv:
+			on_recv(key, cqe, more);
+			break;
+		case uring_op::send:
+			on_send(key, cqe.res);
+			break;
+		case uring_op::cancel:
+		case uring_op::provide:
+			break;
+		}
+	}
+
+	void on_accept(int result)
+	{
+		if (result < 0)
+		{
+			return;
+		}
+
+		add_connection(result);
+	}
+
+	void on_recv(uint64_t key, const io_uring_cqe& cqe, bool more)
+	{
+		auto session = find(key);
+
+		if (cqe.flags & IORING_CQE_F_BUFFER)
+		{
+			auto id = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+			if (session && cqe.res > 0 && !session->closing)
+			{
+				auto* data = buffers_ + static_cast<size_t>(id) * buffer_size_;
+				if (!session->decoder().feed(data, static_cast<size_t>(cqe.res), frames_))
+				{
+					// Oversized frame: the stream can no longer be trusted
+					frames_.clear();
+					begin_close(session);
+				}
+			}
+			recycle(id);
+		}
+
+		if (!session)
+		{
+			return;
+		}
+
+		// Anything but the cancellation itself means the connection is not idle
+		if (session->releasing && cqe.res != -ECANCELED)
+		{
+			session->release_aborted = true;
+		}
+
+		if (!frames_.empty())
+		{
+			if (listener_.receive_callback_ && !stopping_)
+			{
+				for (const auto& frame : frames_)
+				{
+					listener_.receive_callback_(session->id(), frame);
+				}
+			}
+			frames_.clear();
+		}
+
+		if (cqe.res == -ENOBUFS)
+		{
+			// Every buffer is in use; the receive is re-armed once some are recycled
+			listener_.buffer_exhaustions_.fetch_add(1, std::memory_order_relaxed);
+		}
+		else if (cqe.res <= 0 && cqe.res != -ECANCELED)
+		{
+			begin_close(session);
+		}
+
+		if (!more)
+		{
+			session->recv_armed = false;
+			--outstanding_;
+			if (session->releasing)
+			{
+				finish_release(session);
+			}
+			else if (!session->closing && !stopping_)
+			{
+				rearm_.push_back(session);
+			}
+		}
+
+		maybe_finalize(session);
+	}
+
+	void on_send(uint64_t key, int result)
+	{
+		auto session = find(key);
+		--outstanding_;
+		if (!session)
+		{
+			return;
+		}
+
+		session->send_inflight = false;
+		if (result < 0)
+		{
+			session->batch().clear();
+			begin_close(session);
+		}
+		else
+		{
+			session->batch().advance(static_cast<size_t>(result));
+			if (session->batch().empty())
+			{
+				session->batch().clear();
+			}
+			submit_send(session);
+		}
+
+		maybe_finalize(session);
+	}
+
+	void begin_close(const std::shared_ptr<io_uring_session>& session)
+	{
+		if (!session->closing)
+		{
+			session->closing = true;
+			session->close();
+		}
+	}
+
+	/**
+	 * @brief Release a closing session once no request references it
+	 */
+	void maybe_finalize(const std::shared_ptr<io_uring_session>& session)
+	{
+		if (!session->closing || session->recv_armed || session->send_inflight)
+		{
+			return;
+		}
+
+		size_t erased = 0;
+		{
+			std::lock_guard<std::mutex> lock(listener_.sessions_mutex_);
+			erased = listener_.sessions_.erase(session->key());
+		}
+
+		if (erased > 0 && listener_.disconnection_callback_)
+		{
+			listener_.disconnection_callback_(session->id());
+		}
+	}
+
+	std::shared_ptr<io_uring_session> find(uint64_t key) const
+	{
+		// Only this thread modifies the map, so reading without the lock is safe
+		auto it = listener_.sessions_.find(key);
+		return it == listener_.sessions_.end() ? nullptr : it->second;
+	}
+
+	// ---- receive buffers ----
+
+	void recycle(uint16_t id)
+	{
+		if (!use_buffer_ring_)
+		{
+			// Completions of these requests are ignored
+			if (auto* sqe = ring_.get_sqe())
+			{
+				sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+				sqe->fd = 1;
+				sqe->addr = reinterpret_cast<uint64_t>(buffers_ + static_cast<size_t>(id) * buffer_size_);
+				sqe->len = buffer_size_;
+				sqe->buf_group = buffer_group;
+				sqe->off = id;
+				sqe->user_data = encode(uring_op::provide);
+			}
+			return;
+		}
+
+		// Assign fields individually: the ring tail overlays entry 0's resv
+		auto& entry = buffer_ring_[(buffer_tail_ + recycled_) & (buffer_count_ - 1)];
+		entry.addr = reinterpret_cast<uint64_t>(buffers_ + static_cast<size_t>(id) * buffer_size_);
+		entry.len = buffer_size_;
+		entry.bid = id;
+		++recycled_;
+	}
+
+	/**
+	 * @brief Tail of the buffer ring, which overlays the resv field of entry 0
+	 *
+	 * io_uring_buf_ring is not used: in C++ its flexible array member gets
+	 * a non-zero offset, so its bufs[] no longer matches the kernel layout.
+	 */
+	uint16_t* ring_tail() noexcept
+	{
+		return &buffer_ring_[0].resv;
+	}
+
+	void publish_buffers()
+	{
+		if (recycled_ == 0)
+		{
+			return;
+		}
+		buffer_tail_ = static_cast<uint16_t>(buffer_tail_ + recycled_);
+		recycled_ = 0;
+		std::atomic_ref<uint16_t>(*ring_tail()).store(buffer_tail_, std::memory_order_release);
+	}
+
+	void publish_stats()
+	{
+		listener_.enter_calls_.store(ring_.enter_calls(), std::memory_order_relaxed);
+		listener_.sqes_submitted_.store(ring_.sqes_submitted(), std::memory_order_relaxed);
+		listener_.cqes_processed_.store(ring_.cqes_processed(), std::memory_order_relaxed);
+	}
+
+	// ---- shutdown ----
+
+	void shutdown()
+	{
+		stopping_ = true;
+		{
+			std::lock_guard<std::mutex> lock(queue_->mutex);
+			queue_->open = false;
+			queue_->pending.clear();
+		}
+
+		// Tasks posted before this point still complete (adopted connections
+		// are closed); later posts fail
+		{
+			std::lock_guard<std::mutex> lock(listener_.tasks_mutex_);
+			listener_.tasks_open_ = false;
+		}
+		run_tasks();
+
+		retry_sends_.clear();
+		rearm_.clear();
+
+		std::vector<std::shared_ptr<io_uring_session>> sessions;
+		for (const auto& [key, session] : listener_.sessions_)
+		{
+			sessions.push_back(session);
+		}
+		for (const auto& session : sessions)
+		{
+			begin_close(session);
+			maybe_finalize(session);
+		}
+
+		// Cancel whatever is still in flight and wait until the kernel is
+		// done with every buffer this engine owns
+		if (auto* sqe = ring_.get_sqe())
+		{
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+			sqe->user_data = encode(uring_op::cancel);
+		}
+		while (outstanding_ > 0)
+		{
+			int rc = ring_.submit(1);
+			if (rc < 0 && rc != -EBUSY && rc != -EAGAIN)
+			{
+				break;
+			}
+			ring_.drain([this](const io_uring_cqe& cqe) { handle(cqe); });
+		}
+		if (release_)
+		{
+			release_->waiting = 0;
+			complete_release();
+		}
+		publish_stats();
+	}
+
+private:
+	io_uring_listener& listener_;
+	const io_uring_config& config_;
+	uring ring_;
+	std::shared_ptr<io_uring_send_queue> queue_;
+	uint64_t wake_value_ = 0;
+
+	io_uring_buf* buffer_ring_ = nullptr; ///< Provided-buffer ring entries
+	size_t buffer_ring_size_ = 0;
+	uint8_t* buffers_ = nullptr;
+	size_t buffers_size_ = 0;
+	uint32_t buffer_count_ = 0;
+	uint32_t buffer_size_ = 0;
+	uint16_t buffer_tail_ = 0;
+	uint16_t recycled_ = 0;
+	bool use_buffer_ring_ = false;
+
+	uint64_t next_key_ = 0;
+	size_t outstanding_ = 0; ///< Requests that will still produce a completion
+	bool accepting_ = false;
+	bool accept_paused_ = false;
+	bool accept_cancelled_ = false;
+	bool stopping_ = false;
+	std::optional<release_request> release_;
+
+	std::vector<std::shared_ptr<io_uring_session>> rearm_;
+	std::vector<std::shared_ptr<io_uring_session>> retry_sends_;
+	std::vector<std::vector<uint8_t>> frames_;
+};
+
+} // namespace transport_detail
+
+#else
+
+class io_uring_session
+{
+};
+
+namespace transport_detail
+{
+class io_uring_engine
+{
+};
+} // namespace transport_detail
+
+#endif // DATABASE_SERVER_HAS_IO_URING
+
+// ============================================================================
+// io_uring_listener
+// ============================================================================
+
+io_uring_listener::io_uring_listener(const io_uring_config& config)
+	: config_(config)
+{
+}
+
+io_uring_listener::~io_uring_listener()
+{
+	stop();
+}
+
+kcenon::common::VoidResult io_uring_listener::start()
+{
+#if !DATABASE_SERVER_HAS_IO_URING
+	return kcenon::common::error_info{
+		-10, "io_uring transport is not available in this build", "io_uring_listener"
+	};
+#else
+	if (running_.load())
+	{
+		return kcenon::common::error_info{ -1, "Listener already running", "io_uring_listener" };
+	}
+
+	// A socket adopted from a previous process is already bound and listening
+	if (listen_fd_ < 0)
+	{
+		auto listen_result = transport_detail::listen_tcp_socket(
+			config_.host, config_.port, "io_uring_listener");
+		if (listen_result.is_err())
+		{
+			return listen_result.error();
+		}
+		listen_fd_ = listen_result.value();
+	}
+	bound_port_ = transport_detail::local_port(listen_fd_);
+
+	// The ring is created on the I/O thread, which is its only submitter
+	engine_ = std::make_unique<transport_detail::io_uring_engine>(*this);
+	{
+		std::lock_guard<std::mutex> lock(tasks_mutex_);
+		tasks_open_ = true;
+	}
+	accept_enabled_ = true;
+	running_ = true;
+
+	std::promise<kcenon::common::VoidResult> ready;
+	auto setup_result = ready.get_future();
+	io_thread_ = std::thread(
+		[this, &ready]
+		{
+			auto result = engine_->setup();
+			bool ok = result.is_ok();
+			ready.set_value(std::move(result));
+			if (ok)
+			{
+				engine_->run();
+			}
+		});
+
+	auto result = setup_result.get();
+	if (result.is_err())
+	{
+		{
+			std::lock_guard<std::mutex> lock(tasks_mutex_);
+			tasks_open_ = false;
+			tasks_.clear();
+		}
+		running_ = false;
+		io_thread_.join();
+		engine_.reset();
+		::close(listen_fd_);
+		listen_fd_ = -1;
+		return result;
+	}
+
+	return kcenon::common::ok();
+#endif
+}
+
+void io_uring_listener::stop()
+{
+#if DATABASE_SERVER_HAS_IO_URING
+	if (!running_.exchange(false))
+	{
+		return;
+	}
+
+	engine_->wake();
+	if (io_thread_.joinable())
+	{
+		io_thread_.join();
+	}
+	engine_.reset();
+
+	::close(listen_fd_);
+	listen_fd_ = -1;
+#endif
+}
+
+bool io_uring_listener::is_running() const noexcept
+{
+	return running_.load();
+}
+
+size_t io_uring_listener::connection_count() const
+{
+	std::lock_guard<std::mutex> lock(sessions_mutex_);
+	return sessions_.size();
+}
+
+std::string_view io_uring_listener::transport_name() const
+{
+	return "io_uring";
+}
+
+int io_uring_listener::listen_fd() const noexcept
+{
+	return running_.load() ? listen_fd_ : -1;
+}
+
+bool io_uring_listener::adopt_listen_fd(int fd)
+{
+#if DATABASE_SERVER_HAS_IO_URING
+	if (running_.load() || fd < 0)
+	{
+		return false;
+	}
+	if (listen_fd_ >= 0)
+	{
+		::close(listen_fd_);
+	}
+	transport_detail::set_cloexec(fd);
+	listen_fd_ = fd;
+	return true;
+#else
+	(void)fd;
+	return false;
+#endif
+}
+
+void io_uring_listener::stop_accepting()
+{
+#if DATABASE_SERVER_HAS_IO_URING
+	if (accept_enabled_.exchange(false))
+	{
+		// The engine cancels the multishot accept on its next iteration
+		(void)post([] {});
+	}
+#endif
+}
+
+std::vector<int> io_uring_listener::release_idle_connections(
+	const std::function<bool(std::string_view transport_id)>& eligible)
+{
+#if DATABASE_SERVER_HAS_IO_URING
+	auto promise = std::make_shared<std::promise<std::vector<int>>>();
+	auto released = promise->get_future();
+	if (!post([this, promise, &eligible] { engine_->begin_release(eligible, promise); }))
+	{
+		return {};
+	}
+	return released.get();
+#else
+	(void)eligible;
+	return {};
+#endif
+}
+
+kcenon::common::VoidResult io_uring_listener::adopt_connection(int fd)
+{
+#if DATABASE_SERVER_HAS_IO_URING
+	if (fd >= 0 && post([this, fd] { engine_->add_connection(fd); }))
+	{
+		return kcenon::common::ok();
+	}
+#else
+	(void)fd;
+#endif
+	return kcenon::common::error_info{ -8, "Listener not running", "io_uring_listener" };
+}
+
+bool io_uring_listener::post(std::function<void()> task)
+{
+#if DATABASE_SERVER_HAS_IO_URING
+	{
+		std::lock_guard<std::mutex> lock(tasks_mutex_);
+		if (!tasks_open_)
+		{
+			return false;
+		}
+		tasks_.push_back(std::move(task));
+
+		// Under the lock: the engine outlives the tasks_open_ flag
+		engine_->wake();
+	}
+	return true;
+#else
+	(void)task;
+	return false;
+#endif
+}
+
+uint16_t io_uring_listener::bound_port() const noexcept
+{
+	return bound_port_;
+}
+
+io_uring_stats io_uring_listener::get_stats() const
+{
+	io_uring_stats stats;
+	stats.connections_accepted = connections_accepted_.load(std::memory_order_relaxed);
+	stats.enter_calls = enter_calls_.load(std::memory_order_relaxed);
+	stats.sqes_submitted = sqes_submitted_.load(std::memory_order_relaxed);
+	stats.cqes_processed = cqes_processed_.load(std::memory_order_relaxed);
+	stats.buffer_exhaustions = buffer_exhaustions_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+const io_uring_config& io_uring_listener::config() const noexcept
+{
+	return config_;
+}
+
+bool io_uring_listener::is_supported()
+{
+#if DATABASE_SERVER_HAS_IO_URING
+	io_uring_params params{};
+	int fd = static_cast<int>(::syscall(__NR_io_uring_setup, 1, &params));
+	if (fd < 0)
+	{
+		return false;
+	}
+	::close(fd);
+	return true;
+#else
+	return false;
+#endif
+}
+
+} // namespace database_server::gateway
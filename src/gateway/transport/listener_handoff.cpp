@@ -0,0 +1,663 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file listener_handoff.cpp
+ * @brief Implementation of the listening-socket handoff
+ */
+
+#include <kcenon/database_server/gateway/listener_handoff.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <string_view>
+
+#if !defined(_WIN32)
+#include "socket_utils.h"
+
+#include <poll.h>
+#endif
+
+namespace database_server::gateway
+{
+
+#if !defined(_WIN32)
+
+using transport_detail::errno_error;
+using transport_detail::send_flags;
+using transport_detail::set_cloexec;
+using transport_detail::set_nonblocking;
+
+namespace
+{
+
+enum class record_type : uint8_t
+{
+	takeover = 'T',   ///< new -> running: request the sockets
+	listener = 'L',   ///< running -> new: listening socket (carries a descriptor)
+	listening = 'A',  ///< new -> running: listening sockets are served
+	connection = 'C', ///< running -> new: idle connection (carries a descriptor)
+	end = 'E'         ///< running -> new: end of a descriptor list
+};
+
+constexpr uint8_t protocol_version = 1;
+
+struct handoff_record
+{
+	uint8_t type = 0;
+	uint8_t version = protocol_version;
+	std::array<char, 14> transport{}; ///< NUL-padded transport name
+};
+
+static_assert(sizeof(handoff_record) == 16);
+
+handoff_record make_record(record_type type, std::string_view transport = {})
+{
+	handoff_record record;
+	record.type = static_cast<uint8_t>(type);
+	transport.copy(record.transport.data(), std::min(transport.size(), record.transport.size()));
+	return record;
+}
+
+std::string record_transport(const handoff_record& record)
+{
+	const auto* begin = record.transport.data();
+	return std::string(begin, ::strnlen(begin, record.transport.size()));
+}
+
+bool is_record(const handoff_record& record, record_type type)
+{
+	return record.type == static_cast<uint8_t>(type) && record.version == protocol_version;
+}
+
+/**
+ * @brief Send one record, optionally carrying a descriptor
+ */
+bool send_record(int fd, const handoff_record& record, int attached_fd, int timeout_ms)
+{
+	struct iovec part{const_cast<handoff_record*>(&record), sizeof(record)};
+	alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int))]{};
+
+	struct msghdr message{};
+	message.msg_iov = &part;
+	message.msg_iovlen = 1;
+	if (attached_fd >= 0)
+	{
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		auto* cmsg = CMSG_FIRSTHDR(&message);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		std::memcpy(CMSG_DATA(cmsg), &attached_fd, sizeof(int));
+	}
+
+	while (true)
+	{
+		auto sent = ::sendmsg(fd, &message, send_flags);
+		if (sent == static_cast<ssize_t>(sizeof(record)))
+		{
+			return true;
+		}
+		if (sent < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			struct pollfd pfd{fd, POLLOUT, 0};
+			if (::poll(&pfd, 1, timeout_ms) > 0)
+			{
+				continue;
+			}
+		}
+		// Records are far smaller than a socket buffer; a short write means trouble
+		return false;
+	}
+}
+
+/**
+ * @brief Receive one record and the descriptor it carries, if any
+ *
+ * Data on @p wake_fd (the server's stop signal) aborts the wait.
+ */
+bool receive_record(int fd, handoff_record& record, int& attached_fd, int timeout_ms,
+					int wake_fd = -1)
+{
+	using clock = std::chrono::steady_clock;
+	auto deadline = clock::now() + std::chrono::milliseconds(timeout_ms);
+
+	attached_fd = -1;
+	auto* bytes = reinterpret_cast<uint8_t*>(&record);
+	size_t received = 0;
+
+	auto fail = [&attached_fd]
+	{
+		if (attached_fd >= 0)
+		{
+			::close(attached_fd);
+			attached_fd = -1;
+		}
+		return false;
+	};
+
+	while (received < sizeof(record))
+	{
+		auto remaining
+			= std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now());
+		struct pollfd fds[2] = {{fd, POLLIN, 0}, {wake_fd, POLLIN, 0}};
+		int ready = ::poll(fds, 2, static_cast<int>(std::max<int64_t>(remaining.count(), 0)));
+		if (ready < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (ready <= 0 || fds[1].revents != 0)
+		{
+			return fail();
+		}
+
+		struct iovec part{bytes + received, sizeof(record) - received};
+		alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(int) * 4)]{};
+
+		struct msghdr message{};
+		message.msg_iov = &part;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+#if defined(MSG_CMSG_CLOEXEC)
+		auto count = ::recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+#else
+		auto count = ::recvmsg(fd, &message, 0);
+#endif
+		if (count < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+		{
+			continue;
+		}
+
+		// Take ownership of whatever descriptors arrived before validating
+		for (auto* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr;
+			 cmsg = CMSG_NXTHDR(&message, cmsg))
+		{
+			if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+			{
+				continue;
+			}
+			auto fd_count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+			for (size_t i = 0; i < fd_count; ++i)
+			{
+				int passed = -1;
+				std::memcpy(&passed, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+				if (attached_fd < 0)
+				{
+					attached_fd = passed;
+					set_cloexec(passed);
+				}
+				else
+				{
+					::close(passed);
+				}
+			}
+		}
+
+		if (count <= 0 || (message.msg_flags & MSG_CTRUNC) != 0)
+		{
+			return fail();
+		}
+		received += static_cast<size_t>(count);
+	}
+
+	return true;
+}
+
+void close_all(std::vector<handoff_socket>& sockets)
+{
+	for (auto& socket : sockets)
+	{
+		close_handoff_socket(socket);
+	}
+	sockets.clear();
+}
+
+} // namespace
+
+#endif
+
+void close_handoff_socket(handoff_socket& socket) noexcept
+{
+#if !defined(_WIN32)
+	if (socket.fd >= 0)
+	{
+		::close(socket.fd);
+	}
+#endif
+	socket.fd = -1;
+}
+
+// ============================================================================
+// handoff_server
+// ============================================================================
+
+handoff_server::handoff_server(const handoff_config& config)
+	: config_(config)
+{
+}
+
+handoff_server::~handoff_server()
+{
+	stop();
+}
+
+void handoff_server::set_listeners_provider(listeners_provider_t provider)
+{
+	listeners_provider_ = std::move(provider);
+}
+
+void handoff_server::set_release_callback(release_callback_t callback)
+{
+	release_callback_ = std::move(callback);
+}
+
+void handoff_server::set_completion_callback(completion_callback_t callback)
+{
+	completion_callback_ = std::move(callback);
+}
+
+kcenon::common::VoidResult handoff_server::start()
+{
+#if defined(_WIN32)
+	return kcenon::common::error_info{
+		-10, "Socket handoff is not supported on this platform", "handoff_server"
+	};
+#else
+	if (running_.load())
+	{
+		return kcenon::common::error_info{ -1, "Handoff server already running", "handoff_server" };
+	}
+
+	auto listen_result
+		= transport_detail::listen_unix_socket(config_.path, config_.permissions, "handoff_server");
+	if (listen_result.is_err())
+	{
+		return listen_result.error();
+	}
+	listen_fd_ = listen_result.value();
+
+	if (::pipe(wake_fds_) != 0)
+	{
+		auto error = errno_error(-7, "pipe() failed", "handoff_server");
+		::close(listen_fd_);
+		listen_fd_ = -1;
+		::unlink(config_.path.c_str());
+		return error;
+	}
+	set_nonblocking(wake_fds_[0]);
+	set_cloexec(wake_fds_[0]);
+	set_cloexec(wake_fds_[1]);
+
+	completed_ = false;
+	running_ = true;
+	thread_ = std::thread([this] { serve(); });
+
+	return kcenon::common::ok();
+#endif
+}
+
+void handoff_server::stop()
+{
+#if !defined(_WIN32)
+	if (!running_.exchange(false))
+	{
+		return;
+	}
+
+	uint8_t signal = 1;
+	(void)!::write(wake_fds_[1], &signal, 1);
+	if (thread_.joinable())
+	{
+		thread_.join();
+	}
+
+	// After a takeover the path belongs to the successor's handoff socket
+	::close(listen_fd_);
+	listen_fd_ = -1;
+	if (!completed_.load())
+	{
+		::unlink(config_.path.c_str());
+	}
+
+	::close(wake_fds_[0]);
+	::close(wake_fds_[1]);
+	wake_fds_[0] = wake_fds_[1] = -1;
+#endif
+}
+
+bool handoff_server::is_running() const noexcept
+{
+	return running_.load();
+}
+
+bool handoff_server::completed() const noexcept
+{
+	return completed_.load();
+}
+
+const handoff_config& handoff_server::config() const noexcept
+{
+	return config_;
+}
+
+#if !defined(_WIN32)
+
+void handoff_server::serve()
+{
+	while (running_.load())
+	{
+		struct pollfd fds[2] = {{wake_fds_[0], POLLIN, 0}, {listen_fd_, POLLIN, 0}};
+		if (::poll(fds, 2, -1) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+
+		if (!running_.load())
+		{
+			break;
+		}
+
+		if ((fds[1].revents & POLLIN) == 0)
+		{
+			continue;
+		}
+
+		int fd = ::accept(listen_fd_, nullptr, nullptr);
+		if (fd < 0)
+		{
+			continue;
+		}
+		set_cloexec(fd);
+		set_nonblocking(fd);
+		transport_detail::set_nosigpipe(fd);
+
+		// Only a process of the same user may take the sockets over
+		auto peer = transport_detail::read_peer_credentials(fd);
+		bool trusted = peer && peer->uid == static_cast<uint32_t>(::geteuid());
+		bool done = trusted && exchange(fd);
+		::close(fd);
+
+		if (done)
+		{
+			completed_ = true;
+			if (completion_callback_)
+			{
+				completion_callback_();
+			}
+			break;
+		}
+	}
+}
+
+bool handoff_server::exchange(int fd)
+{
+	const int timeout_ms = static_cast<int>(config_.timeout_ms);
+
+	handoff_record record;
+	int attached = -1;
+	if (!receive_record(fd, record, attached, timeout_ms, wake_fds_[0]))
+	{
+		return false;
+	}
+	if (attached >= 0)
+	{
+		::close(attached);
+	}
+	if (!is_record(record, record_type::takeover))
+	{
+		return false;
+	}
+
+	// The listeners keep their descriptors; the successor gets duplicates
+	auto listeners = listeners_provider_ ? listeners_provider_() : std::vector<handoff_socket>{};
+	for (const auto& listener : listeners)
+	{
+		if (!send_record(fd, make_record(record_type::listener, listener.transport), listener.fd,
+						 timeout_ms))
+		{
+			return false;
+		}
+	}
+	if (!send_record(fd, make_record(record_type::end), -1, timeout_ms))
+	{
+		return false;
+	}
+
+	// Until the successor confirms, nothing has changed for this process
+	if (!receive_record(fd, record, attached, timeout_ms, wake_fds_[0]))
+	{
+		return false;
+	}
+	if (attached >= 0)
+	{
+		::close(attached);
+	}
+	if (!is_record(record, record_type::listening))
+	{
+		return false;
+	}
+
+	// The successor serves the listening sockets from here on, so the
+	// takeover counts as complete even if passing connections fails
+	auto connections = release_callback_ ? release_callback_() : std::vector<handoff_socket>{};
+	bool sent = true;
+	for (const auto& connection : connections)
+	{
+		sent = sent
+			   && send_record(fd, make_record(record_type::connection, connection.transport),
+							  connection.fd, timeout_ms);
+		::close(connection.fd);
+	}
+	if (sent)
+	{
+		(void)send_record(fd, make_record(record_type::end), -1, timeout_ms);
+	}
+	return true;
+}
+
+#else
+
+void handoff_server::serve() {}
+bool handoff_server::exchange(int) { return false; }
+
+#endif
+
+// ============================================================================
+// handoff_client
+// ============================================================================
+
+handoff_client::handoff_client(const handoff_config& config)
+	: config_(config)
+{
+}
+
+handoff_client::~handoff_client()
+{
+#if !defined(_WIN32)
+	if (fd_ >= 0)
+	{
+		::close(fd_);
+	}
+#endif
+}
+
+kcenon::common::Result<std::vector<handoff_socket>> handoff_client::receive_listeners()
+{
+#if defined(_WIN32)
+	return kcenon::common::error_info{
+		-10, "Socket handoff is not supported on this platform", "handoff_client"
+	};
+#else
+	if (fd_ >= 0)
+	{
+		return kcenon::common::error_info{ -1, "Takeover already requested", "handoff_client" };
+	}
+
+	struct sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (config_.path.empty() || config_.path.size() >= sizeof(address.sun_path))
+	{
+		return kcenon::common::error_info{ -2, "Invalid socket path: " + config_.path,
+										   "handoff_client" };
+	}
+	std::memcpy(address.sun_path, config_.path.c_str(), config_.path.size() + 1);
+
+	fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd_ < 0)
+	{
+		return errno_error(-4, "socket() failed", "handoff_client");
+	}
+	set_cloexec(fd_);
+	transport_detail::set_nosigpipe(fd_);
+
+	if (::connect(fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		int code = (errno == ENOENT || errno == ECONNREFUSED) ? no_predecessor : -4;
+		auto error = errno_error(code, "No gateway serves " + config_.path, "handoff_client");
+		::close(fd_);
+		fd_ = -1;
+		return error;
+	}
+	set_nonblocking(fd_);
+
+	const int timeout_ms = static_cast<int>(config_.timeout_ms);
+	std::vector<handoff_socket> listeners;
+	auto fail = [this, &listeners](const std::string& what) -> kcenon::common::error_info
+	{
+		close_all(listeners);
+		::close(fd_);
+		fd_ = -1;
+		return kcenon::common::error_info{ -5, what, "handoff_client" };
+	};
+
+	if (!send_record(fd_, make_record(record_type::takeover), -1, timeout_ms))
+	{
+		return fail("Failed to send takeover request");
+	}
+
+	while (true)
+	{
+		handoff_record record;
+		int attached = -1;
+		if (!receive_record(fd_, record, attached, timeout_ms))
+		{
+			return fail("Handoff interrupted while receiving listening sockets");
+		}
+		if (is_record(record, record_type::end))
+		{
+			if (attached >= 0)
+			{
+				::close(attached);
+			}
+			break;
+		}
+		if (!is_record(record, record_type::listener) || attached < 0)
+		{
+			if (attached >= 0)
+			{
+				::close(attached);
+			}
+			return fail("Unexpected handoff message");
+		}
+		listeners.push_back({record_transport(record), attached});
+	}
+
+	return listeners;
+#endif
+}
+
+kcenon::common::Result<std::vector<handoff_socket>> handoff_client::confirm_listening()
+{
+#if defined(_WIN32)
+	return kcenon::common::error_info{
+		-10, "Socket handoff is not supported on this platform", "handoff_client"
+	};
+#else
+	if (fd_ < 0)
+	{
+		return kcenon::common::error_info{ -1, "No takeover in progress", "handoff_client" };
+	}
+
+	const int timeout_ms = static_cast<int>(config_.timeout_ms);
+	std::vector<handoff_socket> connections;
+	auto finish = [this]
+	{
+		::close(fd_);
+		fd_ = -1;
+	};
+
+	if (!send_record(fd_, make_record(record_type::listening), -1, timeout_ms))
+	{
+		finish();
+		return kcenon::common::error_info{ -5, "Failed to confirm takeover", "handoff_client" };
+	}
+
+	// The previous process has stopped accepting once it reads the
+	// confirmation; connections that do not arrive stay with it and drain
+	while (true)
+	{
+		handoff_record record;
+		int attached = -1;
+		if (!receive_record(fd_, record, attached, timeout_ms))
+		{
+			break;
+		}
+		if (is_record(record, record_type::connection) && attached >= 0)
+		{
+			connections.push_back({record_transport(record), attached});
+			continue;
+		}
+		if (attached >= 0)
+		{
+			::close(attached);
+		}
+		break;
+	}
+
+	finish();
+	return connections;
+#endif
+}
+
+} // namespace database_server::gateway
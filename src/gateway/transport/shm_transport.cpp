@@ -0,0 +1,1350 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file shm_transport.cpp
+ * @brief Implementation of the shared-memory ring transport
+ */
+
+#include <kcenon/database_server/gateway/shm_transport.h>
+
+#include "frame_codec.h"
+
+#if defined(__linux__)
+#include "socket_utils.h"
+
+#include <algorithm>
+#include <bit>
+#include <new>
+
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#endif
+
+namespace database_server::gateway
+{
+
+namespace transport_detail
+{
+
+#if defined(__linux__)
+
+namespace
+{
+
+constexpr uint32_t shm_magic = 0x44425348; // "DBSH"
+constexpr uint32_t shm_version = 1;
+constexpr size_t min_ring_capacity = 4096;
+constexpr size_t max_ring_capacity = size_t{1} << 30;
+constexpr size_t channel_fd_count = 5; // memfd + four eventfds
+constexpr size_t cache_line = 64;
+
+/**
+ * @brief Handshake message sent with the segment descriptors
+ */
+struct shm_handshake
+{
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint64_t ring_capacity = 0;
+	uint64_t segment_size = 0;
+};
+
+/**
+ * @brief Shared control block of one ring
+ *
+ * Each field is written by one side only and lives on its own cache line.
+ * The waiting flags implement a Dekker-style handshake: a side that is
+ * about to sleep stores its flag and then re-reads the peer's position,
+ * while the peer stores its position and then reads the flag (all
+ * sequentially consistent), so at least one of them notices the other.
+ */
+struct shm_ring_header
+{
+	alignas(cache_line) std::atomic<uint64_t> head{0};          ///< Written by producer
+	alignas(cache_line) std::atomic<uint64_t> tail{0};          ///< Written by consumer
+	alignas(cache_line) std::atomic<uint32_t> consumer_waiting{0};
+	alignas(cache_line) std::atomic<uint32_t> producer_waiting{0};
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+			  "Shared-memory rings need address-free 64-bit atomics");
+
+constexpr size_t ring_span(size_t capacity)
+{
+	return sizeof(shm_ring_header) + capacity;
+}
+
+inline void cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#elif defined(__aarch64__)
+	asm volatile("yield" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Spin-then-sleep budget that adapts to how often spinning pays off
+ *
+ * Spinning only helps when the peer runs on another core and answers
+ * quickly. The budget doubles (up to the configured limit) whenever data
+ * arrives while spinning and halves whenever the waiter has to sleep
+ * anyway, so idle or oversubscribed peers quickly stop burning CPU. A
+ * small floor keeps probing so the budget can recover. Single-CPU hosts
+ * never spin.
+ */
+class spin_policy
+{
+public:
+	explicit spin_policy(uint32_t limit)
+		: limit_(std::thread::hardware_concurrency() > 1 ? limit : 0)
+		, floor_(limit_ / 16)
+		, budget_(limit_)
+	{
+	}
+
+	[[nodiscard]] uint32_t budget() const noexcept { return budget_; }
+
+	void spin_succeeded() noexcept { budget_ = std::min(limit_, std::max(budget_, 1u) * 2); }
+
+	void had_to_sleep() noexcept { budget_ = std::max(floor_, budget_ / 2); }
+
+private:
+	uint32_t limit_;
+	uint32_t floor_;
+	uint32_t budget_;
+};
+
+inline void signal_event(int fd)
+{
+	uint64_t one = 1;
+	(void)!::write(fd, &one, sizeof(one));
+}
+
+inline void drain_event(int fd)
+{
+	uint64_t count = 0;
+	(void)!::read(fd, &count, sizeof(count));
+}
+
+inline void close_fd(int& fd)
+{
+	if (fd >= 0)
+	{
+		::close(fd);
+		fd = -1;
+	}
+}
+
+/**
+ * @brief One side's view of a single-producer/single-consumer byte ring
+ *
+ * The side's own position is kept locally rather than re-read from shared
+ * memory, and the peer's position is validated before use, so a peer that
+ * scribbles over the control block cannot make this side read or write
+ * outside the ring.
+ */
+class shm_ring
+{
+public:
+	static constexpr size_t corrupted = SIZE_MAX;
+
+	shm_ring() = default;
+
+	shm_ring(shm_ring_header* header, uint8_t* data, uint64_t capacity, int data_fd, int space_fd)
+		: header_(header), data_(data), capacity_(capacity), data_fd_(data_fd), space_fd_(space_fd)
+	{
+	}
+
+	// ---- producer side ----
+
+	size_t write_some(const uint8_t* source, size_t size)
+	{
+		auto used = position_ - header_->tail.load(std::memory_order_acquire);
+		if (used > capacity_)
+		{
+			return corrupted;
+		}
+
+		auto count = std::min<uint64_t>(size, capacity_ - used);
+		if (count == 0)
+		{
+			return 0;
+		}
+
+		auto offset = position_ & (capacity_ - 1);
+		auto first = std::min<uint64_t>(count, capacity_ - offset);
+		std::memcpy(data_ + offset, source, first);
+		std::memcpy(data_, source + first, count - first);
+
+		position_ += count;
+		header_->head.store(position_, std::memory_order_seq_cst);
+		if (header_->consumer_waiting.load(std::memory_order_seq_cst) != 0)
+		{
+			signal_event(data_fd_);
+		}
+		return count;
+	}
+
+	[[nodiscard]] bool writable() const
+	{
+		return position_ - header_->tail.load(std::memory_order_seq_cst) != capacity_;
+	}
+
+	void set_producer_waiting(bool waiting)
+	{
+		header_->producer_waiting.store(waiting ? 1 : 0, std::memory_order_seq_cst);
+	}
+
+	// ---- consumer side ----
+
+	/**
+	 * @brief Pass every readable byte to a sink and release it
+	 * @return Bytes consumed, or corrupted
+	 */
+	template<typename Sink>
+	size_t consume(Sink&& sink)
+	{
+		auto available = header_->head.load(std::memory_order_acquire) - position_;
+		if (available > capacity_)
+		{
+			return corrupted;
+		}
+		if (available == 0)
+		{
+			return 0;
+		}
+
+		auto offset = position_ & (capacity_ - 1);
+		auto first = std::min<uint64_t>(available, capacity_ - offset);
+		if (!sink(data_ + offset, first)
+			|| (available > first && !sink(data_, available - first)))
+		{
+			return corrupted;
+		}
+
+		position_ += available;
+		header_->tail.store(position_, std::memory_order_seq_cst);
+		if (header_->producer_waiting.load(std::memory_order_seq_cst) != 0)
+		{
+			signal_event(space_fd_);
+		}
+		return available;
+	}
+
+	[[nodiscard]] bool readable() const
+	{
+		return header_->head.load(std::memory_order_seq_cst) != position_;
+	}
+
+	void set_consumer_waiting(bool waiting)
+	{
+		header_->consumer_waiting.store(waiting ? 1 : 0, std::memory_order_seq_cst);
+	}
+
+	[[nodiscard]] int data_fd() const noexcept { return data_fd_; }
+	[[nodiscard]] int space_fd() const noexcept { return space_fd_; }
+
+private:
+	shm_ring_header* header_ = nullptr;
+	uint8_t* data_ = nullptr;
+	uint64_t capacity_ = 0;
+	uint64_t position_ = 0; ///< Own head (producer) or tail (consumer)
+	int data_fd_ = -1;
+	int space_fd_ = -1;
+};
+
+} // namespace
+
+/**
+ * @class shm_channel
+ * @brief Mapped segment, ring pair and wakeup descriptors of one connection
+ *
+ * Ring 0 carries client-to-server bytes and ring 1 server-to-client bytes.
+ * Descriptor order in the handshake: memfd, ring 0 data, ring 0 space,
+ * ring 1 data, ring 1 space. The channel owns the control socket.
+ */
+class shm_channel
+{
+public:
+	/**
+	 * @brief Server side: create the segment and send it over the control socket
+	 *
+	 * Like open(), takes ownership of control_fd even when it fails.
+	 */
+	static kcenon::common::Result<std::unique_ptr<shm_channel>>
+	create(int control_fd, size_t ring_capacity, uint32_t spin_iterations)
+	{
+		auto capacity = std::bit_ceil(std::clamp(ring_capacity, min_ring_capacity, max_ring_capacity));
+		auto channel
+			= std::unique_ptr<shm_channel>(new shm_channel(control_fd, spin_iterations));
+		channel->mapping_size_ = 2 * ring_span(capacity);
+
+		int memfd = ::memfd_create("database_server_shm", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+		if (memfd < 0)
+		{
+			return errno_error(-20, "memfd_create() failed", "shm_transport");
+		}
+
+		// Sealing the size keeps a client from truncating the segment
+		// under the server's mapping
+		if (::ftruncate(memfd, static_cast<off_t>(channel->mapping_size_)) != 0
+			|| ::fcntl(memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0)
+		{
+			auto error = errno_error(-21, "Failed to size shared segment", "shm_transport");
+			::close(memfd);
+			return error;
+		}
+
+		if (!channel->map(memfd) || !channel->create_events())
+		{
+			auto error = errno_error(-22, "Failed to set up shared segment", "shm_transport");
+			::close(memfd);
+			return error;
+		}
+
+		new (channel->mapping_) shm_ring_header();
+		new (static_cast<uint8_t*>(channel->mapping_) + ring_span(capacity)) shm_ring_header();
+		channel->attach(capacity, true);
+
+		shm_handshake handshake{shm_magic, shm_version, capacity, channel->mapping_size_};
+		int fds[channel_fd_count] = {memfd, channel->events_[0], channel->events_[1],
+									 channel->events_[2], channel->events_[3]};
+		bool sent = send_with_fds(control_fd, handshake, fds);
+		::close(memfd);
+		if (!sent)
+		{
+			return errno_error(-23, "Failed to send handshake", "shm_transport");
+		}
+
+		return channel;
+	}
+
+	/**
+	 * @brief Client side: receive the segment from the control socket and map it
+	 */
+	static kcenon::common::Result<std::unique_ptr<shm_channel>>
+	open(int control_fd, int timeout_ms, uint32_t spin_iterations)
+	{
+		auto channel
+			= std::unique_ptr<shm_channel>(new shm_channel(control_fd, spin_iterations));
+
+		struct pollfd pfd{control_fd, POLLIN, 0};
+		if (::poll(&pfd, 1, timeout_ms) <= 0)
+		{
+			return kcenon::common::error_info{ -20, "Handshake timed out", "shm_transport" };
+		}
+
+		shm_handshake handshake{};
+		int fds[channel_fd_count] = {-1, -1, -1, -1, -1};
+		if (!receive_with_fds(control_fd, handshake, fds))
+		{
+			for (int& fd : fds)
+			{
+				close_fd(fd);
+			}
+			return kcenon::common::error_info{ -21, "Invalid handshake", "shm_transport" };
+		}
+		std::copy(fds + 1, fds + channel_fd_count, channel->events_);
+
+		auto capacity = handshake.ring_capacity;
+		struct stat segment{};
+		bool valid = handshake.magic == shm_magic && handshake.version == shm_version
+					 && capacity >= min_ring_capacity && capacity <= max_ring_capacity
+					 && std::has_single_bit(capacity)
+					 && handshake.segment_size == 2 * ring_span(capacity)
+					 && ::fstat(fds[0], &segment) == 0
+					 && static_cast<uint64_t>(segment.st_size) >= handshake.segment_size;
+		if (!valid)
+		{
+			::close(fds[0]);
+			return kcenon::common::error_info{ -22, "Incompatible shared segment", "shm_transport" };
+		}
+
+		channel->mapping_size_ = handshake.segment_size;
+		bool mapped = channel->map(fds[0]);
+		::close(fds[0]);
+		if (!mapped)
+		{
+			return errno_error(-23, "mmap() failed", "shm_transport");
+		}
+
+		channel->attach(capacity, false);
+		return channel;
+	}
+
+	~shm_channel()
+	{
+		if (mapping_ != nullptr)
+		{
+			::munmap(mapping_, mapping_size_);
+		}
+		for (int& fd : events_)
+		{
+			close_fd(fd);
+		}
+		close_fd(control_fd_);
+	}
+
+	shm_channel(const shm_channel&) = delete;
+	shm_channel& operator=(const shm_channel&) = delete;
+
+	/**
+	 * @brief Write one length-prefixed frame, waiting for ring space as needed
+	 *
+	 * Callers must not write concurrently.
+	 */
+	kcenon::common::VoidResult write_frame(const uint8_t* data, size_t size, uint32_t timeout_ms)
+	{
+		auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+		auto header = encode_frame_header(static_cast<uint32_t>(size));
+
+		auto result = write_all(header.data(), header.size(), deadline);
+		if (result.is_ok())
+		{
+			result = write_all(data, size, deadline);
+		}
+		return result;
+	}
+
+	/**
+	 * @brief Move every readable byte into a decoder
+	 * @return false if the ring is corrupted or a frame is oversized
+	 */
+	bool read_frames(frame_decoder& decoder, std::vector<std::vector<uint8_t>>& frames,
+					 bool& progressed)
+	{
+		auto consumed = inbound_.consume(
+			[&](const uint8_t* data, size_t size) { return decoder.feed(data, size, frames); });
+		progressed = consumed != 0;
+		return consumed != shm_ring::corrupted;
+	}
+
+	[[nodiscard]] bool readable() const { return inbound_.readable(); }
+
+	/**
+	 * @brief Advertise (or withdraw) that the inbound consumer is about to sleep
+	 */
+	void set_waiting(bool waiting)
+	{
+		inbound_.set_consumer_waiting(waiting);
+		if (!waiting)
+		{
+			drain_event(inbound_.data_fd());
+		}
+	}
+
+	[[nodiscard]] int control_fd() const noexcept { return control_fd_; }
+	[[nodiscard]] int inbound_event_fd() const noexcept { return inbound_.data_fd(); }
+
+	/**
+	 * @brief Spin budget for the inbound consumer (client side only; the
+	 *        server I/O thread keeps one budget for all sessions)
+	 */
+	spin_policy& read_spin() noexcept { return read_spin_; }
+
+	/**
+	 * @brief Signal end of session to the peer and to local waiters
+	 */
+	void shutdown() { ::shutdown(control_fd_, SHUT_RDWR); }
+
+private:
+	shm_channel(int control_fd, uint32_t spin_iterations)
+		: control_fd_(control_fd), read_spin_(spin_iterations), write_spin_(spin_iterations)
+	{
+	}
+
+	bool map(int memfd)
+	{
+		void* address = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+		if (address == MAP_FAILED)
+		{
+			return false;
+		}
+		mapping_ = address;
+		return true;
+	}
+
+	bool create_events()
+	{
+		for (int& fd : events_)
+		{
+			fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+			if (fd < 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void attach(uint64_t capacity, bool server)
+	{
+		auto* base = static_cast<uint8_t*>(mapping_);
+		auto ring_at = [&](size_t index)
+		{
+			auto* header = reinterpret_cast<shm_ring_header*>(base + index * ring_span(capacity));
+			return shm_ring(header, reinterpret_cast<uint8_t*>(header + 1), capacity,
+							events_[index * 2], events_[index * 2 + 1]);
+		};
+		inbound_ = ring_at(server ? 0 : 1);
+		outbound_ = ring_at(server ? 1 : 0);
+	}
+
+	kcenon::common::VoidResult write_all(const uint8_t* data, size_t size,
+										 std::chrono::steady_clock::time_point deadline)
+	{
+		auto& spin = write_spin_;
+		size_t offset = 0;
+		uint32_t spins = 0;
+		while (offset < size)
+		{
+			auto written = outbound_.write_some(data + offset, size - offset);
+			if (written == shm_ring::corrupted)
+			{
+				return kcenon::common::error_info{ -4, "Ring corrupted by peer", "shm_transport" };
+			}
+			if (written > 0)
+			{
+				if (spins > 0)
+				{
+					spin.spin_succeeded();
+				}
+				offset += written;
+				spins = 0;
+				continue;
+			}
+
+			if (spins < spin.budget())
+			{
+				++spins;
+				cpu_relax();
+				continue;
+			}
+
+			// Ring full: advertise, re-check, then sleep on the space eventfd
+			spin.had_to_sleep();
+			outbound_.set_producer_waiting(true);
+			if (outbound_.writable())
+			{
+				outbound_.set_producer_waiting(false);
+				continue;
+			}
+
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+				deadline - std::chrono::steady_clock::now());
+			if (remaining.count() <= 0)
+			{
+				outbound_.set_producer_waiting(false);
+				return kcenon::common::error_info{ -5, "Send timed out", "shm_transport" };
+			}
+
+			struct pollfd fds[2] = {{outbound_.space_fd(), POLLIN, 0}, {control_fd_, POLLIN, 0}};
+			int ready = ::poll(fds, 2, static_cast<int>(remaining.count()));
+			outbound_.set_producer_waiting(false);
+			drain_event(outbound_.space_fd());
+			spins = 0;
+
+			// The control socket carries no data after the handshake; any
+			// activity on it means the session is over
+			if (ready > 0 && fds[1].revents != 0)
+			{
+				return kcenon::common::error_info{ -2, "Session closed", "shm_transport" };
+			}
+		}
+		return kcenon::common::ok();
+	}
+
+	static bool send_with_fds(int socket_fd, const shm_handshake& handshake,
+							  const int (&fds)[channel_fd_count])
+	{
+		struct iovec part{const_cast<shm_handshake*>(&handshake), sizeof(handshake)};
+		alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(fds))]{};
+
+		struct msghdr message{};
+		message.msg_iov = &part;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		auto* cmsg = CMSG_FIRSTHDR(&message);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+		std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+		return ::sendmsg(socket_fd, &message, send_flags)
+			   == static_cast<ssize_t>(sizeof(handshake));
+	}
+
+	static bool receive_with_fds(int socket_fd, shm_handshake& handshake,
+								 int (&fds)[channel_fd_count])
+	{
+		struct iovec part{&handshake, sizeof(handshake)};
+		alignas(struct cmsghdr) char control[CMSG_SPACE(sizeof(fds))]{};
+
+		struct msghdr message{};
+		message.msg_iov = &part;
+		message.msg_iovlen = 1;
+		message.msg_control = control;
+		message.msg_controllen = sizeof(control);
+
+		auto received = ::recvmsg(socket_fd, &message, MSG_CMSG_CLOEXEC);
+
+		// Take ownership of whatever descriptors arrived before validating
+		auto* cmsg = CMSG_FIRSTHDR(&message);
+		bool complete = cmsg != nullptr && cmsg->cmsg_level == SOL_SOCKET
+						&& cmsg->cmsg_type == SCM_RIGHTS;
+		if (complete)
+		{
+			auto count = std::min((cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int), channel_fd_count);
+			std::memcpy(fds, CMSG_DATA(cmsg), count * sizeof(int));
+			complete = count == channel_fd_count;
+		}
+
+		return complete && received == static_cast<ssize_t>(sizeof(handshake))
+			   && (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) == 0;
+	}
+
+private:
+	int control_fd_;
+	void* mapping_ = nullptr;
+	size_t mapping_size_ = 0;
+	int events_[4] = {-1, -1, -1, -1};
+	shm_ring inbound_;
+	shm_ring outbound_;
+	spin_policy read_spin_;
+	spin_policy write_spin_;
+};
+
+#else
+
+class shm_channel
+{
+};
+
+#endif
+
+} // namespace transport_detail
+
+#if defined(__linux__)
+
+using transport_detail::cpu_relax;
+using transport_detail::errno_error;
+using transport_detail::set_cloexec;
+using transport_detail::set_nonblocking;
+
+// ============================================================================
+// shm_session
+// ============================================================================
+
+/**
+ * @class shm_session
+ * @brief One connected shared-memory client, as seen by the gateway
+ */
+class shm_session : public session_transport
+{
+public:
+	shm_session(std::unique_ptr<transport_detail::shm_channel> channel, std::string id,
+				std::optional<peer_credentials> peer, const shm_transport_config& config)
+		: channel_(std::move(channel))
+		, id_(std::move(id))
+		, peer_(peer)
+		, send_timeout_ms_(config.send_timeout_ms)
+		, decoder_(config.max_frame_bytes)
+	{
+	}
+
+	[[nodiscard]] std::string_view id() const override { return id_; }
+
+	[[nodiscard]] bool is_connected() const override { return connected_.load(); }
+
+	[[nodiscard]] kcenon::common::VoidResult send(std::vector<uint8_t>&& data) override
+	{
+		if (data.size() > UINT32_MAX)
+		{
+			return kcenon::common::error_info{ -1, "Message too large", "shm_transport" };
+		}
+
+		// Rings are single-producer: serialize concurrent senders
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		if (!connected_.load())
+		{
+			return kcenon::common::error_info{ -2, "Session closed", "shm_transport" };
+		}
+
+		auto result = channel_->write_frame(data.data(), data.size(), send_timeout_ms_);
+		if (result.is_err())
+		{
+			close();
+		}
+		return result;
+	}
+
+	void close() override
+	{
+		// The I/O thread sees the shutdown on the control socket and drops the session
+		if (connected_.exchange(false))
+		{
+			channel_->shutdown();
+		}
+	}
+
+	[[nodiscard]] std::optional<peer_credentials> peer() const override { return peer_; }
+
+	[[nodiscard]] std::string_view transport_name() const override { return "shm"; }
+
+	transport_detail::shm_channel& channel() noexcept { return *channel_; }
+
+	transport_detail::frame_decoder& decoder() noexcept { return decoder_; }
+
+private:
+	std::unique_ptr<transport_detail::shm_channel> channel_;
+	std::string id_;
+	std::optional<peer_credentials> peer_;
+	uint32_t send_timeout_ms_;
+	std::atomic<bool> connected_{true};
+	std::mutex write_mutex_;
+
+	// Touched only by the I/O thread
+	transport_detail::frame_decoder decoder_;
+};
+
+#else
+
+class shm_session
+{
+};
+
+#endif
+
+// ============================================================================
+// shm_transport_listener
+// ============================================================================
+
+shm_transport_listener::shm_transport_listener(const shm_transport_config& config)
+	: config_(config)
+{
+}
+
+shm_transport_listener::~shm_transport_listener()
+{
+	stop();
+}
+
+kcenon::common::VoidResult shm_transport_listener::start()
+{
+#if !defined(__linux__)
+	return kcenon::common::error_info{
+		-10, "Shared-memory transport is not supported on this platform", "shm_transport"
+	};
+#else
+	if (running_.load())
+	{
+		return kcenon::common::error_info{ -1, "Listener already running", "shm_transport" };
+	}
+
+	// A socket adopted from a previous process is already bound and listening
+	if (listen_fd_ < 0)
+	{
+		auto listen_result = transport_detail::listen_unix_socket(
+			config_.path, config_.permissions, "shm_transport");
+		if (listen_result.is_err())
+		{
+			return listen_result.error();
+		}
+		listen_fd_ = listen_result.value();
+	}
+
+	if (::pipe(wake_fds_) != 0)
+	{
+		auto error = errno_error(-7, "pipe() failed", "shm_transport");
+		::close(listen_fd_);
+		listen_fd_ = -1;
+		::unlink(config_.path.c_str());
+		return error;
+	}
+	set_nonblocking(wake_fds_[0]);
+	set_cloexec(wake_fds_[0]);
+	set_cloexec(wake_fds_[1]);
+
+	accepting_ = true;
+	owns_path_ = true;
+	running_ = true;
+	io_thread_ = std::thread([this] { io_loop(); });
+
+	return kcenon::common::ok();
+#endif
+}
+
+void shm_transport_listener::stop()
+{
+#if defined(__linux__)
+	if (!running_.exchange(false))
+	{
+		return;
+	}
+
+	wake();
+	if (io_thread_.joinable())
+	{
+		io_thread_.join();
+	}
+
+	::close(listen_fd_);
+	listen_fd_ = -1;
+	if (owns_path_.load())
+	{
+		::unlink(config_.path.c_str());
+	}
+
+	::close(wake_fds_[0]);
+	::close(wake_fds_[1]);
+	wake_fds_[0] = wake_fds_[1] = -1;
+#endif
+}
+
+bool shm_transport_listener::is_running() const noexcept
+{
+	return running_.load();
+}
+
+size_t shm_transport_listener::connection_count() const
+{
+	std::lock_guard<std::mutex> lock(sessions_mutex_);
+	return sessions_.size();
+}
+
+std::string_view shm_transport_listener::transport_name() const
+{
+	return "shm";
+}
+
+int shm_transport_listener::listen_fd() const noexcept
+{
+	return running_.load() ? listen_fd_ : -1;
+}
+
+bool shm_transport_listener::adopt_listen_fd(int fd)
+{
+#if defined(__linux__)
+	if (running_.load() || fd < 0)
+	{
+		return false;
+	}
+	if (listen_fd_ >= 0)
+	{
+		::close(listen_fd_);
+	}
+	set_cloexec(fd);
+	set_nonblocking(fd);
+	listen_fd_ = fd;
+	return true;
+#else
+	(void)fd;
+	return false;
+#endif
+}
+
+void shm_transport_listener::stop_accepting()
+{
+	owns_path_ = false;
+	if (accepting_.exchange(false) && running_.load())
+	{
+		// Must not race stop(), like start()
+		wake();
+	}
+}
+
+const shm_transport_config& shm_transport_listener::config() const noexcept
+{
+	return config_;
+}
+
+#if defined(__linux__)
+
+void shm_transport_listener::io_loop()
+{
+	// Sockets are checked periodically while rings are busy so new clients
+	// and disconnects are noticed without a syscall per ring poll
+	constexpr uint32_t socket_check_interval = 256;
+
+	std::vector<std::shared_ptr<shm_session>> sessions;
+	transport_detail::spin_policy spin(config_.spin_iterations);
+	uint32_t idle_spins = 0;
+	uint32_t since_socket_check = 0;
+	sessions_changed_ = true;
+
+	while (running_.load())
+	{
+		if (sessions_changed_)
+		{
+			sessions_changed_ = false;
+			sessions.clear();
+			std::lock_guard<std::mutex> lock(sessions_mutex_);
+			for (const auto& [fd, session] : sessions_)
+			{
+				sessions.push_back(session);
+			}
+		}
+
+		if (poll_rings(sessions))
+		{
+			if (idle_spins > 0)
+			{
+				spin.spin_succeeded();
+			}
+			idle_spins = 0;
+		}
+		else if (idle_spins < spin.budget())
+		{
+			++idle_spins;
+			cpu_relax();
+		}
+		else
+		{
+			spin.had_to_sleep();
+
+			// Advertise that we sleep, then re-check so a producer that
+			// wrote before seeing the flag is not missed
+			bool ready = false;
+			for (const auto& session : sessions)
+			{
+				session->channel().set_waiting(true);
+				ready = ready || session->channel().readable();
+			}
+
+			service_sockets(sessions, ready ? 0 : -1);
+
+			for (const auto& session : sessions)
+			{
+				session->channel().set_waiting(false);
+			}
+			idle_spins = 0;
+			since_socket_check = 0;
+			continue;
+		}
+
+		if (++since_socket_check >= socket_check_interval)
+		{
+			since_socket_check = 0;
+			service_sockets(sessions, 0);
+		}
+	}
+
+	// Shut down every remaining connection
+	std::vector<int> remaining;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		for (const auto& [fd, session] : sessions_)
+		{
+			remaining.push_back(fd);
+		}
+	}
+	for (int fd : remaining)
+	{
+		drop_client(fd);
+	}
+}
+
+bool shm_transport_listener::poll_rings(const std::vector<std::shared_ptr<shm_session>>& sessions)
+{
+	bool progressed_any = false;
+	std::vector<std::vector<uint8_t>> frames;
+
+	for (const auto& session : sessions)
+	{
+		if (!session->is_connected())
+		{
+			continue;
+		}
+
+		bool progressed = false;
+		bool intact = session->channel().read_frames(session->decoder(), frames, progressed);
+		progressed_any = progressed_any || progressed;
+
+		if (receive_callback_)
+		{
+			for (const auto& frame : frames)
+			{
+				receive_callback_(session->id(), frame);
+			}
+		}
+		frames.clear();
+
+		if (!intact)
+		{
+			// Corrupted ring or oversized frame: the stream can no longer be trusted
+			session->close();
+		}
+	}
+
+	return progressed_any;
+}
+
+void shm_transport_listener::service_sockets(
+	const std::vector<std::shared_ptr<shm_session>>& sessions, int timeout_ms)
+{
+	std::vector<struct pollfd> poll_fds;
+	poll_fds.reserve(2 + sessions.size() * 2);
+	poll_fds.push_back({wake_fds_[0], POLLIN, 0});
+	// poll() skips negative descriptors, keeping the indices stable
+	poll_fds.push_back({accepting_.load() ? listen_fd_ : -1, POLLIN, 0});
+	for (const auto& session : sessions)
+	{
+		poll_fds.push_back({session->channel().control_fd(), POLLIN, 0});
+		poll_fds.push_back({session->channel().inbound_event_fd(), POLLIN, 0});
+	}
+
+	if (::poll(poll_fds.data(), static_cast<nfds_t>(poll_fds.size()), timeout_ms) <= 0)
+	{
+		return;
+	}
+
+	if (poll_fds[0].revents != 0)
+	{
+		uint8_t drain[64];
+		while (::read(wake_fds_[0], drain, sizeof(drain)) > 0)
+		{
+		}
+	}
+
+	for (size_t i = 0; i < sessions.size(); ++i)
+	{
+		// Any activity on the control socket ends the session; requests
+		// written just before the client closed are still delivered
+		if (poll_fds[2 + i * 2].revents != 0)
+		{
+			poll_rings({sessions[i]});
+			drop_client(sessions[i]->channel().control_fd());
+		}
+	}
+
+	if (running_.load() && (poll_fds[1].revents & POLLIN))
+	{
+		accept_clients();
+	}
+}
+
+void shm_transport_listener::accept_clients()
+{
+	while (true)
+	{
+		int fd = ::accept(listen_fd_, nullptr, nullptr);
+		if (fd < 0)
+		{
+			// EAGAIN: backlog drained; other errors are per-connection
+			if (errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+			return;
+		}
+
+		set_cloexec(fd);
+
+		{
+			std::lock_guard<std::mutex> lock(sessions_mutex_);
+			if (sessions_.size() >= config_.max_connections)
+			{
+				::close(fd);
+				continue;
+			}
+		}
+
+		// The channel owns the descriptor from here on, including on failure
+		auto peer = transport_detail::read_peer_credentials(fd);
+		auto channel = transport_detail::shm_channel::create(fd, config_.ring_capacity,
+															 config_.spin_iterations);
+		if (channel.is_err())
+		{
+			continue;
+		}
+		set_nonblocking(fd);
+
+		auto session = std::make_shared<shm_session>(
+			std::move(channel.value()), "shm-" + std::to_string(++next_id_), peer, config_);
+		{
+			std::lock_guard<std::mutex> lock(sessions_mutex_);
+			sessions_[fd] = session;
+		}
+		sessions_changed_ = true;
+
+		if (connection_callback_)
+		{
+			connection_callback_(session);
+		}
+	}
+}
+
+void shm_transport_listener::drop_client(int fd)
+{
+	std::shared_ptr<shm_session> session;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		auto it = sessions_.find(fd);
+		if (it == sessions_.end())
+		{
+			return;
+		}
+		session = std::move(it->second);
+		sessions_.erase(it);
+	}
+	sessions_changed_ = true;
+
+	session->close();
+
+	if (disconnection_callback_)
+	{
+		disconnection_callback_(session->id());
+	}
+}
+
+void shm_transport_listener::wake()
+{
+	uint8_t signal = 1;
+	(void)!::write(wake_fds_[1], &signal, 1);
+}
+
+#else
+
+void shm_transport_listener::io_loop() {}
+bool shm_transport_listener::poll_rings(const std::vector<std::shared_ptr<shm_session>>&)
+{
+	return false;
+}
+void shm_transport_listener::service_sockets(const std::vector<std::shared_ptr<shm_session>>&,
+											 int)
+{
+}
+void shm_transport_listener::accept_clients() {}
+void shm_transport_listener::drop_client(int) {}
+void shm_transport_listener::wake() {}
+
+#endif
+
+// ============================================================================
+// shm_client
+// ============================================================================
+
+shm_client::shm_client(shm_client_config config)
+	: config_(config)
+{
+}
+
+shm_client::~shm_client()
+{
+	disconnect();
+}
+
+kcenon::common::VoidResult shm_client::connect(const std::string& path)
+{
+#if !defined(__linux__)
+	(void)path;
+	return kcenon::common::error_info{
+		-10, "Shared-memory transport is not supported on this platform", "shm_transport"
+	};
+#else
+	if (connected_.load())
+	{
+		return kcenon::common::error_info{ -1, "Already connected", "shm_transport" };
+	}
+
+	struct sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (path.empty() || path.size() >= sizeof(address.sun_path))
+	{
+		return kcenon::common::error_info{ -2, "Invalid socket path: " + path, "shm_transport" };
+	}
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0)
+	{
+		return errno_error(-4, "socket() failed", "shm_transport");
+	}
+	if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		auto error = errno_error(-5, "connect() failed for " + path, "shm_transport");
+		::close(fd);
+		return error;
+	}
+
+	// The channel owns the socket from here on, including on failure
+	auto channel = transport_detail::shm_channel::open(
+		fd, static_cast<int>(config_.connect_timeout_ms), config_.spin_iterations);
+	if (channel.is_err())
+	{
+		return channel.error();
+	}
+
+	channel_ = std::move(channel.value());
+	decoder_ = std::make_unique<transport_detail::frame_decoder>(config_.max_frame_bytes);
+	pending_.clear();
+	connected_ = true;
+	return kcenon::common::ok();
+#endif
+}
+
+void shm_client::disconnect()
+{
+	connected_ = false;
+	channel_.reset();
+	decoder_.reset();
+	pending_.clear();
+}
+
+bool shm_client::is_connected() const noexcept
+{
+	return connected_.load();
+}
+
+kcenon::common::VoidResult shm_client::send(const std::vector<uint8_t>& data)
+{
+#if !defined(__linux__)
+	(void)data;
+	return kcenon::common::error_info{ -2, "Not connected", "shm_transport" };
+#else
+	if (!connected_.load())
+	{
+		return kcenon::common::error_info{ -2, "Not connected", "shm_transport" };
+	}
+	if (data.size() > config_.max_frame_bytes || data.size() > UINT32_MAX)
+	{
+		return kcenon::common::error_info{ -1, "Message too large", "shm_transport" };
+	}
+
+	auto result = channel_->write_frame(data.data(), data.size(), config_.send_timeout_ms);
+	if (result.is_err())
+	{
+		// A partially written frame leaves the stream unusable
+		connected_ = false;
+		channel_->shutdown();
+	}
+	return result;
+#endif
+}
+
+kcenon::common::Result<std::vector<uint8_t>>
+shm_client::receive(std::chrono::milliseconds timeout)
+{
+#if !defined(__linux__)
+	(void)timeout;
+	return kcenon::common::error_info{ -2, "Not connected", "shm_transport" };
+#else
+	auto take_pending = [this]()
+	{
+		auto frame = std::move(pending_.front());
+		pending_.pop_front();
+		return frame;
+	};
+
+	if (!pending_.empty())
+	{
+		return take_pending();
+	}
+	if (!channel_)
+	{
+		return kcenon::common::error_info{ -2, "Not connected", "shm_transport" };
+	}
+
+	auto deadline = std::chrono::steady_clock::now() + timeout;
+	auto& spin = channel_->read_spin();
+	std::vector<std::vector<uint8_t>> frames;
+	uint32_t spins = 0;
+	bool slept = false;
+
+	while (true)
+	{
+		bool progressed = false;
+		if (!channel_->read_frames(*decoder_, frames, progressed))
+		{
+			connected_ = false;
+			return kcenon::common::error_info{ -3, "Protocol error", "shm_transport" };
+		}
+		if (!frames.empty())
+		{
+			if (spins > 0 && !slept)
+			{
+				spin.spin_succeeded();
+			}
+			std::move(frames.begin(), frames.end(), std::back_inserter(pending_));
+			return take_pending();
+		}
+		if (!connected_.load())
+		{
+			return kcenon::common::error_info{ -2, "Disconnected", "shm_transport" };
+		}
+
+		if (spins < spin.budget())
+		{
+			++spins;
+			cpu_relax();
+			continue;
+		}
+
+		if (!slept)
+		{
+			spin.had_to_sleep();
+			slept = true;
+		}
+		channel_->set_waiting(true);
+		if (channel_->readable())
+		{
+			channel_->set_waiting(false);
+			continue;
+		}
+
+		auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+			deadline - std::chrono::steady_clock::now());
+		if (remaining.count() <= 0)
+		{
+			channel_->set_waiting(false);
+			return kcenon::common::error_info{ -4, "Receive timed out", "shm_transport" };
+		}
+
+		struct pollfd fds[2] = {{channel_->inbound_event_fd(), POLLIN, 0},
+								{channel_->control_fd(), POLLIN, 0}};
+		int ready = ::poll(fds, 2, static_cast<int>(remaining.count()));
+		channel_->set_waiting(false);
+
+		// Server closed the session: deliver what is already in the ring first
+		if (ready > 0 && fds[1].revents != 0)
+		{
+			connected_ = false;
+		}
+	}
+#endif
+}
+
+} // namespace database_server::gateway
@@ -0,0 +1,260 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file socket_utils.h
+ * @brief POSIX socket helpers shared by the gateway transports
+ *
+ * Internal header for src/gateway/transport. Not available on Windows.
+ */
+
+#pragma once
+
+#if !defined(_WIN32)
+
+#include <kcenon/database_server/gateway/session_transport.h>
+
+#include <cerrno>
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace database_server::gateway::transport_detail
+{
+
+#if defined(MSG_NOSIGNAL)
+inline constexpr int send_flags = MSG_NOSIGNAL;
+#else
+inline constexpr int send_flags = 0;
+#endif
+
+inline bool set_nonblocking(int fd)
+{
+	int flags = ::fcntl(fd, F_GETFL, 0);
+	return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+inline bool set_cloexec(int fd)
+{
+	int flags = ::fcntl(fd, F_GETFD, 0);
+	return flags >= 0 && ::fcntl(fd, F_SETFD, flags | FD_CLOEXEC) == 0;
+}
+
+/**
+ * @brief Disable SIGPIPE on platforms without MSG_NOSIGNAL
+ */
+inline void set_nosigpipe(int fd)
+{
+#if defined(SO_NOSIGPIPE)
+	int one = 1;
+	::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#else
+	(void)fd;
+#endif
+}
+
+/**
+ * @brief Read kernel-verified credentials of a connected Unix socket peer
+ */
+inline std::optional<peer_credentials> read_peer_credentials(int fd)
+{
+#if defined(__linux__)
+	struct ucred cred{};
+	socklen_t length = sizeof(cred);
+	if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &length) == 0)
+	{
+		return peer_credentials{static_cast<int32_t>(cred.pid),
+								static_cast<uint32_t>(cred.uid),
+								static_cast<uint32_t>(cred.gid)};
+	}
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__NetBSD__)
+	uid_t uid = 0;
+	gid_t gid = 0;
+	if (::getpeereid(fd, &uid, &gid) == 0)
+	{
+		return peer_credentials{-1, static_cast<uint32_t>(uid), static_cast<uint32_t>(gid)};
+	}
+#else
+	(void)fd;
+#endif
+	return std::nullopt;
+}
+
+/**
+ * @brief Build an error_info from errno
+ */
+inline kcenon::common::error_info errno_error(int code, const std::string& what,
+											  const std::string& module)
+{
+	return kcenon::common::error_info{ code, what + ": " + std::strerror(errno), module };
+}
+
+/**
+ * @brief Create a listening Unix stream socket at a path
+ *
+ * A stale socket file left by a previous run is replaced; any other kind
+ * of file at the path is an error. The returned descriptor is non-blocking.
+ */
+inline kcenon::common::Result<int> listen_unix_socket(const std::string& path,
+													  uint32_t permissions,
+													  const std::string& module)
+{
+	struct sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (path.empty() || path.size() >= sizeof(address.sun_path))
+	{
+		return kcenon::common::error_info{ -2, "Invalid socket path: " + path, module };
+	}
+	std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+	struct stat existing{};
+	if (::lstat(path.c_str(), &existing) == 0)
+	{
+		if (!S_ISSOCK(existing.st_mode))
+		{
+			return kcenon::common::error_info{
+				-3, "Path exists and is not a socket: " + path, module
+			};
+		}
+		::unlink(path.c_str());
+	}
+
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+	{
+		return errno_error(-4, "socket() failed", module);
+	}
+	set_cloexec(fd);
+
+	if (::bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		auto error = errno_error(-5, "bind() failed for " + path, module);
+		::close(fd);
+		return error;
+	}
+
+	if (::chmod(path.c_str(), static_cast<mode_t>(permissions)) != 0
+		|| ::listen(fd, SOMAXCONN) != 0 || !set_nonblocking(fd))
+	{
+		auto error = errno_error(-6, "Failed to set up listener", module);
+		::close(fd);
+		::unlink(path.c_str());
+		return error;
+	}
+
+	return fd;
+}
+
+/**
+ * @brief Create a listening TCP socket on a numeric IPv4 or IPv6 address
+ *
+ * Port 0 binds an ephemeral port; see local_port(). The returned
+ * descriptor is blocking and close-on-exec.
+ */
+inline kcenon::common::Result<int> listen_tcp_socket(const std::string& host, uint16_t port,
+													 const std::string& module)
+{
+	struct sockaddr_storage address{};
+	socklen_t address_length = 0;
+	auto* v4 = reinterpret_cast<struct sockaddr_in*>(&address);
+	auto* v6 = reinterpret_cast<struct sockaddr_in6*>(&address);
+	if (::inet_pton(AF_INET, host.c_str(), &v4->sin_addr) == 1)
+	{
+		v4->sin_family = AF_INET;
+		v4->sin_port = htons(port);
+		address_length = sizeof(*v4);
+	}
+	else if (::inet_pton(AF_INET6, host.c_str(), &v6->sin6_addr) == 1)
+	{
+		v6->sin6_family = AF_INET6;
+		v6->sin6_port = htons(port);
+		address_length = sizeof(*v6);
+	}
+	else
+	{
+		return kcenon::common::error_info{ -2, "Invalid bind address: " + host, module };
+	}
+
+	int fd = ::socket(address.ss_family, SOCK_STREAM, 0);
+	if (fd < 0)
+	{
+		return errno_error(-4, "socket() failed", module);
+	}
+	set_cloexec(fd);
+
+	int one = 1;
+	::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+	if (::bind(fd, reinterpret_cast<struct sockaddr*>(&address), address_length) != 0
+		|| ::listen(fd, SOMAXCONN) != 0)
+	{
+		auto error = errno_error(
+			-5, "Failed to listen on " + host + ":" + std::to_string(port), module);
+		::close(fd);
+		return error;
+	}
+
+	return fd;
+}
+
+/**
+ * @brief Local port a TCP socket is bound to (0 if unknown)
+ */
+inline uint16_t local_port(int fd)
+{
+	struct sockaddr_storage address{};
+	socklen_t address_length = sizeof(address);
+	if (::getsockname(fd, reinterpret_cast<struct sockaddr*>(&address), &address_length) != 0)
+	{
+		return 0;
+	}
+	if (address.ss_family == AF_INET)
+	{
+		return ntohs(reinterpret_cast<struct sockaddr_in*>(&address)->sin_port);
+	}
+	if (address.ss_family == AF_INET6)
+	{
+		return ntohs(reinterpret_cast<struct sockaddr_in6*>(&address)->sin6_port);
+	}
+	return 0;
+}
+
+} // namespace database_server::gateway::transport_detail
+
+#endif // !_WIN32
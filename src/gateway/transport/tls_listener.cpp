@@ -0,0 +1,938 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file tls_listener.cpp
+ * @brief Implementation of the TLS listener
+ */
+
+#include <kcenon/database_server/gateway/tls_listener.h>
+#include <kcenon/database_server/metrics/metrics_base.h>
+
+#include "frame_codec.h"
+
+#include <chrono>
+#include <vector>
+
+#if DATABASE_SERVER_HAS_TLS
+#include "socket_utils.h"
+
+#include <algorithm>
+#include <array>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#endif
+
+namespace database_server::gateway
+{
+
+// ============================================================================
+// tls_stats
+// ============================================================================
+
+double tls_stats::resumption_ratio() const noexcept
+{
+	return metrics::metrics_utils::calculate_rate(
+		resumed_handshakes, full_handshakes + resumed_handshakes, 0.0);
+}
+
+double tls_stats::average_full_handshake_us() const noexcept
+{
+	return metrics::metrics_utils::average_us(full_handshake_us, full_handshakes);
+}
+
+double tls_stats::average_resumed_handshake_us() const noexcept
+{
+	return metrics::metrics_utils::average_us(resumed_handshake_us, resumed_handshakes);
+}
+
+double tls_stats::crypto_ns_per_byte() const noexcept
+{
+	return metrics::metrics_utils::calculate_ratio(record_crypto_ns,
+												   bytes_encrypted + bytes_decrypted);
+}
+
+namespace transport_detail
+{
+
+/**
+ * @struct tls_state
+ * @brief Server context and counters shared by the listener and its sessions
+ */
+struct tls_state
+{
+#if DATABASE_SERVER_HAS_TLS
+	SSL_CTX* context = nullptr;
+
+	~tls_state()
+	{
+		SSL_CTX_free(context);
+	}
+#endif
+
+	std::atomic<uint64_t> full_handshakes{0};
+	std::atomic<uint64_t> resumed_handshakes{0};
+	std::atomic<uint64_t> failed_handshakes{0};
+	std::atomic<uint64_t> full_handshake_ns{0};
+	std::atomic<uint64_t> resumed_handshake_ns{0};
+	std::atomic<double> handshakes_per_second{0.0};
+	std::atomic<uint64_t> bytes_encrypted{0};
+	std::atomic<uint64_t> bytes_decrypted{0};
+	std::atomic<uint64_t> record_crypto_ns{0};
+};
+
+} // namespace transport_detail
+
+#if DATABASE_SERVER_HAS_TLS
+
+using transport_detail::errno_error;
+using transport_detail::send_flags;
+using transport_detail::set_cloexec;
+using transport_detail::set_nonblocking;
+
+namespace
+{
+
+/// Largest plaintext carried by one TLS record
+constexpr size_t max_record_plaintext = 16 * 1024;
+
+/// Plaintext encrypted before the ciphertext is flushed to the socket
+constexpr size_t flush_threshold = 256 * 1024;
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point since)
+{
+	return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+									 std::chrono::steady_clock::now() - since)
+									 .count());
+}
+
+/**
+ * @brief Describe and clear the calling thread's OpenSSL error queue
+ */
+std::string ssl_error_string()
+{
+	unsigned long code = ERR_get_error();
+	ERR_clear_error();
+	if (code == 0)
+	{
+		return "unknown error";
+	}
+	char buffer[256];
+	ERR_error_string_n(code, buffer, sizeof(buffer));
+	return buffer;
+}
+
+kcenon::common::Result<SSL_CTX*> create_server_context(const tls_config& config)
+{
+	ERR_clear_error();
+
+	SSL_CTX* context = SSL_CTX_new(TLS_server_method());
+	if (context == nullptr)
+	{
+		return kcenon::common::error_info{
+			-11, "Failed to create TLS context: " + ssl_error_string(), "tls_listener"
+		};
+	}
+
+	SSL_CTX_set_min_proto_version(context, TLS1_2_VERSION);
+	// Idle connections give their record buffers back to the allocator
+	SSL_CTX_set_mode(context, SSL_MODE_RELEASE_BUFFERS);
+#if defined(SSL_OP_NO_RENEGOTIATION)
+	SSL_CTX_set_options(context, SSL_OP_NO_RENEGOTIATION);
+#endif
+
+	if (SSL_CTX_use_certificate_chain_file(context, config.cert_file.c_str()) != 1)
+	{
+		auto message = ssl_error_string();
+		SSL_CTX_free(context);
+		return kcenon::common::error_info{
+			-12, "Failed to load TLS certificate " + config.cert_file + ": " + message,
+			"tls_listener"
+		};
+	}
+
+	if (SSL_CTX_use_PrivateKey_file(context, config.key_file.c_str(), SSL_FILETYPE_PEM) != 1
+		|| SSL_CTX_check_private_key(context) != 1)
+	{
+		auto message = ssl_error_string();
+		SSL_CTX_free(context);
+		return kcenon::common::error_info{
+			-13, "Failed to load TLS private key " + config.key_file + ": " + message,
+			"tls_listener"
+		};
+	}
+
+	// Resumption: stateless tickets by default, the server-side cache otherwise.
+	// One ticket per connection is enough since every connection gets a fresh one.
+	static constexpr unsigned char session_id_context[] = "database_server";
+	SSL_CTX_set_session_id_context(context, session_id_context,
+								   sizeof(session_id_context) - 1);
+	SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+	SSL_CTX_sess_set_cache_size(context, static_cast<long>(config.session_cache_size));
+	SSL_CTX_set_timeout(context, static_cast<long>(config.session_lifetime_s));
+	SSL_CTX_set_num_tickets(context, 1);
+	if (!config.enable_session_tickets)
+	{
+		SSL_CTX_set_options(context, SSL_OP_NO_TICKET);
+	}
+
+	return context;
+}
+
+} // namespace
+
+// ============================================================================
+// tls_session
+// ============================================================================
+
+/**
+ * @class tls_session
+ * @brief One accepted TLS connection
+ *
+ * The TLS engine reads from and writes to memory BIOs; the session moves
+ * ciphertext between them and the socket. The engine is not thread-safe,
+ * so every use of it happens under engine_mutex_: the I/O thread feeds
+ * received ciphertext, any thread may send.
+ *
+ * The descriptor is owned by the session and closed when the last
+ * reference is released, so a concurrent send() can never write to a
+ * descriptor number that was reused by a later connection.
+ */
+class tls_session : public session_transport
+{
+public:
+	/**
+	 * @brief Outcome of feeding received ciphertext to the session
+	 */
+	enum class progress
+	{
+		handshaking, ///< Handshake still in progress
+		established, ///< Handshake completed by this call
+		open,        ///< Connection established earlier and still open
+		closed       ///< Peer closed the connection or the TLS layer failed
+	};
+
+	tls_session(int fd, std::string id, SSL* ssl,
+				std::shared_ptr<transport_detail::tls_state> state, const tls_config& config)
+		: fd_(fd)
+		, id_(std::move(id))
+		, ssl_(ssl)
+		, state_(std::move(state))
+		, send_timeout_ms_(static_cast<int>(config.send_timeout_ms))
+		, accepted_at_(std::chrono::steady_clock::now())
+		, decoder_(config.max_frame_bytes)
+	{
+		BIO* input = BIO_new(BIO_s_mem());
+		output_ = BIO_new(BIO_s_mem());
+		// An empty input BIO means "wait for more data", not end of stream
+		BIO_set_mem_eof_return(input, -1);
+		SSL_set_bio(ssl_, input, output_);
+		SSL_set_accept_state(ssl_);
+	}
+
+	~tls_session() override
+	{
+		SSL_free(ssl_);
+		::close(fd_);
+	}
+
+	[[nodiscard]] std::string_view id() const override { return id_; }
+
+	[[nodiscard]] bool is_connected() const override { return connected_.load(); }
+
+	[[nodiscard]] kcenon::common::VoidResult send(std::vector<uint8_t>&& data) override
+	{
+		if (data.size() > UINT32_MAX)
+		{
+			return kcenon::common::error_info{ -1, "Message too large", "tls_listener" };
+		}
+
+		auto header = transport_detail::encode_frame_header(static_cast<uint32_t>(data.size()));
+
+		std::lock_guard<std::mutex> lock(engine_mutex_);
+		if (!connected_.load())
+		{
+			return kcenon::common::error_info{ -2, "Session closed", "tls_listener" };
+		}
+
+		// The header shares the first record with the start of the payload,
+		// so small messages cost one record and later records are full
+		thread_local std::array<uint8_t, max_record_plaintext> first_record;
+		size_t head = std::min(data.size(), first_record.size() - header.size());
+		std::memcpy(first_record.data(), header.data(), header.size());
+		std::memcpy(first_record.data() + header.size(), data.data(), head);
+
+		if (!encrypt_locked(first_record.data(), header.size() + head)
+			|| !encrypt_locked(data.data() + head, data.size() - head))
+		{
+			close_locked();
+			return kcenon::common::error_info{ -3, "TLS send failed", "tls_listener" };
+		}
+
+		return kcenon::common::ok();
+	}
+
+	void close() override
+	{
+		std::lock_guard<std::mutex> lock(engine_mutex_);
+		close_locked();
+	}
+
+	[[nodiscard]] std::optional<peer_credentials> peer() const override { return std::nullopt; }
+
+	[[nodiscard]] std::string_view transport_name() const override { return "tls"; }
+
+	[[nodiscard]] int fd() const noexcept { return fd_; }
+
+	[[nodiscard]] bool is_established() const noexcept { return established_.load(); }
+
+	[[nodiscard]] std::chrono::steady_clock::time_point accepted_at() const noexcept
+	{
+		return accepted_at_;
+	}
+
+	/**
+	 * @brief Feed ciphertext read from the socket (I/O thread only)
+	 * @param data Received bytes
+	 * @param size Number of bytes
+	 * @param frames Receives complete decrypted messages
+	 */
+	progress receive(const uint8_t* data, size_t size, std::vector<std::vector<uint8_t>>& frames)
+	{
+		std::lock_guard<std::mutex> lock(engine_mutex_);
+		if (!connected_.load())
+		{
+			return progress::closed;
+		}
+
+		BIO_write(SSL_get_rbio(ssl_), data, static_cast<int>(size));
+
+		auto result = progress::open;
+		if (!established_.load())
+		{
+			auto start = std::chrono::steady_clock::now();
+			int rc = SSL_do_handshake(ssl_);
+			handshake_ns_ += elapsed_ns(start);
+
+			if (rc != 1)
+			{
+				int error = SSL_get_error(ssl_, rc);
+				// Send the next flight, or the alert explaining the failure
+				bool flushed = flush_locked(send_timeout_ms_);
+				if (error == SSL_ERROR_WANT_READ && flushed)
+				{
+					return progress::handshaking;
+				}
+				ERR_clear_error();
+				close_locked();
+				return progress::closed;
+			}
+
+			established_ = true;
+			if (SSL_session_reused(ssl_))
+			{
+				state_->resumed_handshakes.fetch_add(1, std::memory_order_relaxed);
+				state_->resumed_handshake_ns.fetch_add(handshake_ns_, std::memory_order_relaxed);
+			}
+			else
+			{
+				state_->full_handshakes.fetch_add(1, std::memory_order_relaxed);
+				state_->full_handshake_ns.fetch_add(handshake_ns_, std::memory_order_relaxed);
+			}
+			result = progress::established;
+		}
+
+		// Decrypt every complete record; application data may arrive in the
+		// same segment as the client's Finished message
+		uint8_t plaintext[max_record_plaintext];
+		bool open = true;
+		while (true)
+		{
+			size_t length = 0;
+			auto start = std::chrono::steady_clock::now();
+			int rc = SSL_read_ex(ssl_, plaintext, sizeof(plaintext), &length);
+			state_->record_crypto_ns.fetch_add(elapsed_ns(start), std::memory_order_relaxed);
+
+			if (rc == 1)
+			{
+				state_->bytes_decrypted.fetch_add(length, std::memory_order_relaxed);
+				if (!decoder_.feed(plaintext, length, frames))
+				{
+					// Oversized frame: the stream can no longer be trusted
+					open = false;
+					break;
+				}
+				continue;
+			}
+
+			// WANT_READ: waiting for the rest of a record. Anything else is
+			// the peer's close_notify or a fatal error.
+			open = SSL_get_error(ssl_, rc) == SSL_ERROR_WANT_READ;
+			ERR_clear_error();
+			break;
+		}
+
+		// Post-handshake messages (session tickets, key updates)
+		if (!flush_locked(send_timeout_ms_) || !open)
+		{
+			close_locked();
+			return progress::closed;
+		}
+		return result;
+	}
+
+private:
+	bool encrypt_locked(const uint8_t* data, size_t size)
+	{
+		while (size > 0)
+		{
+			size_t chunk = std::min(size, flush_threshold);
+			size_t written = 0;
+
+			auto start = std::chrono::steady_clock::now();
+			int rc = SSL_write_ex(ssl_, data, chunk, &written);
+			state_->record_crypto_ns.fetch_add(elapsed_ns(start), std::memory_order_relaxed);
+
+			if (rc != 1)
+			{
+				ERR_clear_error();
+				return false;
+			}
+			state_->bytes_encrypted.fetch_add(written, std::memory_order_relaxed);
+
+			if (!flush_locked(send_timeout_ms_))
+			{
+				return false;
+			}
+			data += written;
+			size -= written;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Write all pending ciphertext to the socket
+	 * @param timeout_ms Max wait for a full socket buffer
+	 */
+	bool flush_locked(int timeout_ms)
+	{
+		char* pending = nullptr;
+		long remaining = BIO_get_mem_data(output_, &pending);
+		while (remaining > 0)
+		{
+			auto written = ::send(fd_, pending, static_cast<size_t>(remaining), send_flags);
+			if (written < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				if (errno == EAGAIN || errno == EWOULDBLOCK)
+				{
+					struct pollfd pfd{fd_, POLLOUT, 0};
+					if (::poll(&pfd, 1, timeout_ms) > 0)
+					{
+						continue;
+					}
+				}
+				return false;
+			}
+			pending += written;
+			remaining -= written;
+		}
+		(void)BIO_reset(output_);
+		return true;
+	}
+
+	void close_locked()
+	{
+		// The I/O thread sees the shutdown as end-of-stream and drops the session
+		if (connected_.exchange(false))
+		{
+			if (established_.load())
+			{
+				// Best-effort close_notify; never wait on a slow peer here
+				SSL_shutdown(ssl_);
+				flush_locked(0);
+				ERR_clear_error();
+			}
+			::shutdown(fd_, SHUT_RDWR);
+		}
+	}
+
+	int fd_;
+	std::string id_;
+	SSL* ssl_;
+	BIO* output_ = nullptr;
+	std::shared_ptr<transport_detail::tls_state> state_;
+	int send_timeout_ms_;
+	const std::chrono::steady_clock::time_point accepted_at_;
+	std::atomic<bool> connected_{true};
+	std::atomic<bool> established_{false};
+	std::mutex engine_mutex_;
+
+	// Touched only by the I/O thread
+	uint64_t handshake_ns_ = 0;
+	transport_detail::frame_decoder decoder_;
+};
+
+#else
+
+class tls_session
+{
+};
+
+#endif
+
+// ============================================================================
+// tls_listener
+// ============================================================================
+
+tls_listener::tls_listener(const tls_config& config)
+	: config_(config)
+	, state_(std::make_shared<transport_detail::tls_state>())
+{
+}
+
+tls_listener::~tls_listener()
+{
+	stop();
+}
+
+kcenon::common::VoidResult tls_listener::start()
+{
+#if !DATABASE_SERVER_HAS_TLS
+	return kcenon::common::error_info{
+		-10, "TLS is not available in this build", "tls_listener"
+	};
+#else
+	if (running_.load())
+	{
+		return kcenon::common::error_info{ -1, "Listener already running", "tls_listener" };
+	}
+
+	auto context_result = create_server_context(config_);
+	if (context_result.is_err())
+	{
+		return context_result.error();
+	}
+	SSL_CTX_free(state_->context);
+	state_->context = context_result.value();
+
+	// A socket adopted from a previous process is already bound and listening
+	if (listen_fd_ < 0)
+	{
+		auto listen_result
+			= transport_detail::listen_tcp_socket(config_.host, config_.port, "tls_listener");
+		if (listen_result.is_err())
+		{
+			return listen_result.error();
+		}
+		listen_fd_ = listen_result.value();
+	}
+	bound_port_ = transport_detail::local_port(listen_fd_);
+	set_nonblocking(listen_fd_);
+
+	if (::pipe(wake_fds_) != 0)
+	{
+		auto error = errno_error(-7, "pipe() failed", "tls_listener");
+		::close(listen_fd_);
+		listen_fd_ = -1;
+		return error;
+	}
+	set_nonblocking(wake_fds_[0]);
+	set_cloexec(wake_fds_[0]);
+	set_cloexec(wake_fds_[1]);
+
+	accepting_ = true;
+	running_ = true;
+	io_thread_ = std::thread([this] { io_loop(); });
+
+	return kcenon::common::ok();
+#endif
+}
+
+void tls_listener::stop()
+{
+#if DATABASE_SERVER_HAS_TLS
+	if (!running_.exchange(false))
+	{
+		return;
+	}
+
+	wake();
+	if (io_thread_.joinable())
+	{
+		io_thread_.join();
+	}
+
+	::close(listen_fd_);
+	listen_fd_ = -1;
+
+	::close(wake_fds_[0]);
+	::close(wake_fds_[1]);
+	wake_fds_[0] = wake_fds_[1] = -1;
+#endif
+}
+
+bool tls_listener::is_running() const noexcept
+{
+	return running_.load();
+}
+
+size_t tls_listener::connection_count() const
+{
+	std::lock_guard<std::mutex> lock(sessions_mutex_);
+	return sessions_.size();
+}
+
+std::string_view tls_listener::transport_name() const
+{
+	return "tls";
+}
+
+int tls_listener::listen_fd() const noexcept
+{
+	return running_.load() ? listen_fd_ : -1;
+}
+
+bool tls_listener::adopt_listen_fd(int fd)
+{
+#if DATABASE_SERVER_HAS_TLS
+	if (running_.load() || fd < 0)
+	{
+		return false;
+	}
+	if (listen_fd_ >= 0)
+	{
+		::close(listen_fd_);
+	}
+	set_cloexec(fd);
+	listen_fd_ = fd;
+	return true;
+#else
+	(void)fd;
+	return false;
+#endif
+}
+
+void tls_listener::stop_accepting()
+{
+	// Takes effect within one poll tick (at most a second)
+	accepting_ = false;
+}
+
+uint16_t tls_listener::bound_port() const noexcept
+{
+	return bound_port_;
+}
+
+tls_stats tls_listener::get_stats() const
+{
+	tls_stats stats;
+	stats.full_handshakes = state_->full_handshakes.load(std::memory_order_relaxed);
+	stats.resumed_handshakes = state_->resumed_handshakes.load(std::memory_order_relaxed);
+	stats.failed_handshakes = state_->failed_handshakes.load(std::memory_order_relaxed);
+	stats.full_handshake_us = state_->full_handshake_ns.load(std::memory_order_relaxed) / 1000;
+	stats.resumed_handshake_us
+		= state_->resumed_handshake_ns.load(std::memory_order_relaxed) / 1000;
+	stats.handshakes_per_second = state_->handshakes_per_second.load(std::memory_order_relaxed);
+	stats.bytes_encrypted = state_->bytes_encrypted.load(std::memory_order_relaxed);
+	stats.bytes_decrypted = state_->bytes_decrypted.load(std::memory_order_relaxed);
+	stats.record_crypto_ns = state_->record_crypto_ns.load(std::memory_order_relaxed);
+	return stats;
+}
+
+const tls_config& tls_listener::config() const noexcept
+{
+	return config_;
+}
+
+bool tls_listener::is_available() noexcept
+{
+#if DATABASE_SERVER_HAS_TLS
+	return true;
+#else
+	return false;
+#endif
+}
+
+#if DATABASE_SERVER_HAS_TLS
+
+void tls_listener::io_loop()
+{
+	using clock = std::chrono::steady_clock;
+
+	std::vector<struct pollfd> poll_fds;
+	std::vector<std::shared_ptr<tls_session>> polled;
+
+	// Wake at least once a second to expire stalled handshakes and sample the rate
+	const int tick_ms
+		= static_cast<int>(std::clamp<uint32_t>(config_.handshake_timeout_ms, 10, 1000));
+	auto rate_sampled_at = clock::now();
+	uint64_t rate_base = state_->full_handshakes.load() + state_->resumed_handshakes.load();
+
+	while (running_.load())
+	{
+		poll_fds.clear();
+		polled.clear();
+		poll_fds.push_back({wake_fds_[0], POLLIN, 0});
+		// poll() skips negative descriptors, keeping the indices stable
+		poll_fds.push_back({accepting_.load() ? listen_fd_ : -1, POLLIN, 0});
+		{
+			std::lock_guard<std::mutex> lock(sessions_mutex_);
+			for (const auto& [fd, session] : sessions_)
+			{
+				poll_fds.push_back({fd, POLLIN, 0});
+				polled.push_back(session);
+			}
+		}
+
+		if (::poll(poll_fds.data(), static_cast<nfds_t>(poll_fds.size()), tick_ms) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+
+		if (poll_fds[0].revents != 0)
+		{
+			uint8_t drain[64];
+			while (::read(wake_fds_[0], drain, sizeof(drain)) > 0)
+			{
+			}
+		}
+
+		if (!running_.load())
+		{
+			break;
+		}
+
+		for (size_t i = 0; i < polled.size(); ++i)
+		{
+			if (poll_fds[i + 2].revents != 0)
+			{
+				read_client(polled[i]);
+			}
+		}
+
+		if (poll_fds[1].revents & POLLIN)
+		{
+			accept_clients();
+		}
+
+		expire_handshakes();
+
+		auto now = clock::now();
+		if (now - rate_sampled_at >= std::chrono::seconds(1))
+		{
+			uint64_t total = state_->full_handshakes.load() + state_->resumed_handshakes.load();
+			double seconds = std::chrono::duration<double>(now - rate_sampled_at).count();
+			state_->handshakes_per_second.store(static_cast<double>(total - rate_base) / seconds,
+												std::memory_order_relaxed);
+			rate_base = total;
+			rate_sampled_at = now;
+		}
+	}
+
+	// Shut down every remaining connection
+	std::vector<int> remaining;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		for (const auto& [fd, session] : sessions_)
+		{
+			remaining.push_back(fd);
+		}
+	}
+	for (int fd : remaining)
+	{
+		drop_client(fd);
+	}
+}
+
+void tls_listener::accept_clients()
+{
+	while (true)
+	{
+		int fd = ::accept(listen_fd_, nullptr, nullptr);
+		if (fd < 0)
+		{
+			// EAGAIN: backlog drained; other errors are per-connection
+			if (errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+			return;
+		}
+
+		set_cloexec(fd);
+		set_nonblocking(fd);
+		transport_detail::set_nosigpipe(fd);
+		int one = 1;
+		::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		SSL* ssl = sessions_.size() < config_.max_connections ? SSL_new(state_->context) : nullptr;
+		if (ssl == nullptr)
+		{
+			::close(fd);
+			continue;
+		}
+
+		// Presented to the gateway once the handshake completes (read_client)
+		sessions_[fd] = std::make_shared<tls_session>(
+			fd, "tls-" + std::to_string(++next_id_), ssl, state_, config_);
+	}
+}
+
+void tls_listener::read_client(const std::shared_ptr<tls_session>& session)
+{
+	uint8_t buffer[64 * 1024];
+	std::vector<std::vector<uint8_t>> frames;
+	bool established = false;
+	bool closed = false;
+
+	while (!closed)
+	{
+		auto received = ::recv(session->fd(), buffer, sizeof(buffer), 0);
+		if (received > 0)
+		{
+			auto progress = session->receive(buffer, static_cast<size_t>(received), frames);
+			established = established || progress == tls_session::progress::established;
+			closed = progress == tls_session::progress::closed;
+			continue;
+		}
+
+		if (received < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		// EAGAIN: drained for now; anything else is end of stream or an error
+		closed = !(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+		break;
+	}
+
+	if (established && connection_callback_)
+	{
+		connection_callback_(session);
+	}
+
+	if (receive_callback_)
+	{
+		for (const auto& frame : frames)
+		{
+			receive_callback_(session->id(), frame);
+		}
+	}
+
+	if (closed)
+	{
+		if (!session->is_established())
+		{
+			state_->failed_handshakes.fetch_add(1, std::memory_order_relaxed);
+		}
+		drop_client(session->fd());
+	}
+}
+
+void tls_listener::drop_client(int fd)
+{
+	std::shared_ptr<tls_session> session;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		auto it = sessions_.find(fd);
+		if (it == sessions_.end())
+		{
+			return;
+		}
+		session = std::move(it->second);
+		sessions_.erase(it);
+	}
+
+	session->close();
+
+	// Connections that never finished the handshake were never announced
+	if (session->is_established() && disconnection_callback_)
+	{
+		disconnection_callback_(session->id());
+	}
+}
+
+void tls_listener::expire_handshakes()
+{
+	auto deadline = std::chrono::steady_clock::now()
+					- std::chrono::milliseconds(config_.handshake_timeout_ms);
+
+	std::vector<int> expired;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		for (const auto& [fd, session] : sessions_)
+		{
+			if (!session->is_established() && session->accepted_at() < deadline)
+			{
+				expired.push_back(fd);
+			}
+		}
+	}
+
+	for (int fd : expired)
+	{
+		state_->failed_handshakes.fetch_add(1, std::memory_order_relaxed);
+		drop_client(fd);
+	}
+}
+
+void tls_listener::wake()
+{
+	uint8_t signal = 1;
+	(void)!::write(wake_fds_[1], &signal, 1);
+}
+
+#else
+
+void tls_listener::io_loop() {}
+void tls_listener::accept_clients() {}
+void tls_listener::read_client(const std::shared_ptr<tls_session>&) {}
+void tls_listener::drop_client(int) {}
+void tls_listener::expire_handshakes() {}
+void tls_listener::wake() {}
+
+#endif
+
+} // namespace database_server::gateway
@@ -0,0 +1,695 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file unix_socket_listener.cpp
+ * @brief Implementation of the Unix domain socket listener
+ */
+
+#include <kcenon/database_server/gateway/unix_socket_listener.h>
+
+#include "frame_codec.h"
+
+#include <future>
+#include <vector>
+
+#if !defined(_WIN32)
+#include "socket_utils.h"
+
+#include <poll.h>
+#include <sys/uio.h>
+#endif
+
+namespace database_server::gateway
+{
+
+#if !defined(_WIN32)
+
+using transport_detail::errno_error;
+using transport_detail::send_flags;
+using transport_detail::set_cloexec;
+using transport_detail::set_nonblocking;
+
+// ============================================================================
+// unix_socket_session
+// ============================================================================
+
+/**
+ * @class unix_socket_session
+ * @brief One accepted Unix domain socket connection
+ *
+ * The descriptor is owned by the session and closed when the last
+ * reference is released, so a concurrent send() can never write to a
+ * descriptor number that was reused by a later connection. A session
+ * detached for handoff gives up the descriptor instead.
+ */
+class unix_socket_session : public session_transport
+{
+public:
+	unix_socket_session(int fd, std::string id, std::optional<peer_credentials> peer,
+						const unix_socket_config& config)
+		: fd_(fd)
+		, id_(std::move(id))
+		, peer_(peer)
+		, send_timeout_ms_(static_cast<int>(config.send_timeout_ms))
+		, decoder_(config.max_frame_bytes)
+	{
+	}
+
+	~unix_socket_session() override
+	{
+		if (!released_)
+		{
+			::close(fd_);
+		}
+	}
+
+	[[nodiscard]] std::string_view id() const override { return id_; }
+
+	[[nodiscard]] bool is_connected() const override { return connected_.load(); }
+
+	[[nodiscard]] kcenon::common::VoidResult send(std::vector<uint8_t>&& data) override
+	{
+		if (data.size() > UINT32_MAX)
+		{
+			return kcenon::common::error_info{ -1, "Message too large", "unix_socket_listener" };
+		}
+
+		auto header = transport_detail::encode_frame_header(static_cast<uint32_t>(data.size()));
+
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		if (!connected_.load())
+		{
+			return kcenon::common::error_info{ -2, "Session closed", "unix_socket_listener" };
+		}
+
+		struct iovec parts[2];
+		parts[0].iov_base = header.data();
+		parts[0].iov_len = header.size();
+		parts[1].iov_base = data.data();
+		parts[1].iov_len = data.size();
+
+		struct msghdr message{};
+		message.msg_iov = parts;
+		message.msg_iovlen = 2;
+
+		// Write header and payload with one syscall in the common case,
+		// resuming after partial writes
+		while (message.msg_iovlen > 0)
+		{
+			auto written = ::sendmsg(fd_, &message, send_flags);
+			if (written < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+				if (errno == EAGAIN || errno == EWOULDBLOCK)
+				{
+					struct pollfd pfd{fd_, POLLOUT, 0};
+					if (::poll(&pfd, 1, send_timeout_ms_) > 0)
+					{
+						continue;
+					}
+				}
+				close_locked();
+				return errno_error(-3, "Send failed", "unix_socket_listener");
+			}
+
+			auto remaining = static_cast<size_t>(written);
+			while (message.msg_iovlen > 0 && remaining >= message.msg_iov[0].iov_len)
+			{
+				remaining -= message.msg_iov[0].iov_len;
+				++message.msg_iov;
+				--message.msg_iovlen;
+			}
+			if (message.msg_iovlen > 0)
+			{
+				message.msg_iov[0].iov_base
+					= static_cast<uint8_t*>(message.msg_iov[0].iov_base) + remaining;
+				message.msg_iov[0].iov_len -= remaining;
+			}
+		}
+
+		return kcenon::common::ok();
+	}
+
+	void close() override
+	{
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		close_locked();
+	}
+
+	[[nodiscard]] std::optional<peer_credentials> peer() const override { return peer_; }
+
+	[[nodiscard]] std::string_view transport_name() const override { return "unix"; }
+
+	[[nodiscard]] int fd() const noexcept { return fd_; }
+
+	transport_detail::frame_decoder& decoder() noexcept { return decoder_; }
+
+	/**
+	 * @brief Check for buffered or unread request bytes (I/O thread only)
+	 */
+	[[nodiscard]] bool is_idle()
+	{
+		if (decoder_.pending_bytes() > 0)
+		{
+			return false;
+		}
+		uint8_t probe = 0;
+		auto peeked = ::recv(fd_, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+		return peeked < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+	}
+
+	/**
+	 * @brief Give up the descriptor without shutting it down
+	 *
+	 * Waits for an in-progress send() so that no partial message is left
+	 * on the stream; later sends fail.
+	 *
+	 * @return false if the session is already closed
+	 */
+	bool detach()
+	{
+		std::lock_guard<std::mutex> lock(write_mutex_);
+		if (!connected_.exchange(false))
+		{
+			return false;
+		}
+		released_ = true;
+		return true;
+	}
+
+private:
+	void close_locked()
+	{
+		// The I/O thread sees the shutdown as end-of-stream and drops the session
+		if (connected_.exchange(false))
+		{
+			::shutdown(fd_, SHUT_RDWR);
+		}
+	}
+
+	int fd_;
+	std::string id_;
+	std::optional<peer_credentials> peer_;
+	int send_timeout_ms_;
+	std::atomic<bool> connected_{true};
+	bool released_ = false;
+	std::mutex write_mutex_;
+
+	// Touched only by the I/O thread
+	transport_detail::frame_decoder decoder_;
+};
+
+#else
+
+class unix_socket_session
+{
+};
+
+#endif
+
+// ============================================================================
+// unix_socket_listener
+// ============================================================================
+
+unix_socket_listener::unix_socket_listener(const unix_socket_config& config)
+	: config_(config)
+{
+}
+
+unix_socket_listener::~unix_socket_listener()
+{
+	stop();
+}
+
+kcenon::common::VoidResult unix_socket_listener::start()
+{
+#if defined(_WIN32)
+	return kcenon::common::error_info{
+		-10, "Unix domain sockets are not supported on this platform", "unix_socket_listener"
+	};
+#else
+	if (running_.load())
+	{
+		return kcenon::common::error_info{ -1, "Listener already running", "unix_socket_listener" };
+	}
+
+	// A socket adopted from a previous process is already bound and listening
+	if (listen_fd_ < 0)
+	{
+		auto listen_result = transport_detail::listen_unix_socket(
+			config_.path, config_.permissions, "unix_socket_listener");
+		if (listen_result.is_err())
+		{
+			return listen_result.error();
+		}
+		listen_fd_ = listen_result.value();
+	}
+
+	if (::pipe(wake_fds_) != 0)
+	{
+		auto error = errno_error(-7, "pipe() failed", "unix_socket_listener");
+		::close(listen_fd_);
+		listen_fd_ = -1;
+		::unlink(config_.path.c_str());
+		return error;
+	}
+	set_nonblocking(wake_fds_[0]);
+	set_cloexec(wake_fds_[0]);
+	set_cloexec(wake_fds_[1]);
+
+	{
+		std::lock_guard<std::mutex> lock(tasks_mutex_);
+		tasks_open_ = true;
+	}
+	accepting_ = true;
+	owns_path_ = true;
+	running_ = true;
+	io_thread_ = std::thread([this] { io_loop(); });
+
+	return kcenon::common::ok();
+#endif
+}
+
+void unix_socket_listener::stop()
+{
+#if !defined(_WIN32)
+	if (!running_.exchange(false))
+	{
+		return;
+	}
+
+	wake();
+	if (io_thread_.joinable())
+	{
+		io_thread_.join();
+	}
+
+	::close(listen_fd_);
+	listen_fd_ = -1;
+	if (owns_path_.load())
+	{
+		::unlink(config_.path.c_str());
+	}
+
+	::close(wake_fds_[0]);
+	::close(wake_fds_[1]);
+	wake_fds_[0] = wake_fds_[1] = -1;
+#endif
+}
+
+bool unix_socket_listener::is_running() const noexcept
+{
+	return running_.load();
+}
+
+size_t unix_socket_listener::connection_count() const
+{
+	std::lock_guard<std::mutex> lock(sessions_mutex_);
+	return sessions_.size();
+}
+
+std::string_view unix_socket_listener::transport_name() const
+{
+	return "unix";
+}
+
+int unix_socket_listener::listen_fd() const noexcept
+{
+	return running_.load() ? listen_fd_ : -1;
+}
+
+bool unix_socket_listener::adopt_listen_fd(int fd)
+{
+#if defined(_WIN32)
+	(void)fd;
+	return false;
+#else
+	if (running_.load() || fd < 0)
+	{
+		return false;
+	}
+	if (listen_fd_ >= 0)
+	{
+		::close(listen_fd_);
+	}
+	set_cloexec(fd);
+	set_nonblocking(fd);
+	listen_fd_ = fd;
+	return true;
+#endif
+}
+
+void unix_socket_listener::stop_accepting()
+{
+	owns_path_ = false;
+	if (accepting_.exchange(false))
+	{
+		// Wake the I/O thread so it drops the socket from its poll set
+		(void)post([] {});
+	}
+}
+
+std::vector<int> unix_socket_listener::release_idle_connections(
+	const std::function<bool(std::string_view transport_id)>& eligible)
+{
+#if defined(_WIN32)
+	(void)eligible;
+	return {};
+#else
+	// Sessions are only read and dropped on the I/O thread, so the idle
+	// check and the detach happen there as well
+	auto promise = std::make_shared<std::promise<std::vector<int>>>();
+	auto released = promise->get_future();
+	bool posted = post(
+		[this, promise, &eligible]
+		{
+			std::vector<std::shared_ptr<unix_socket_session>> candidates;
+			{
+				std::lock_guard<std::mutex> lock(sessions_mutex_);
+				for (const auto& [fd, session] : sessions_)
+				{
+					candidates.push_back(session);
+				}
+			}
+
+			std::vector<int> fds;
+			for (const auto& session : candidates)
+			{
+				if (!session->is_idle() || (eligible && !eligible(session->id()))
+					|| !session->detach())
+				{
+					continue;
+				}
+				{
+					std::lock_guard<std::mutex> lock(sessions_mutex_);
+					sessions_.erase(session->fd());
+				}
+				if (disconnection_callback_)
+				{
+					disconnection_callback_(session->id());
+				}
+				fds.push_back(session->fd());
+			}
+			promise->set_value(std::move(fds));
+		});
+	if (!posted)
+	{
+		return {};
+	}
+	return released.get();
+#endif
+}
+
+kcenon::common::VoidResult unix_socket_listener::adopt_connection(int fd)
+{
+	if (fd < 0 || !post([this, fd] { add_client(fd); }))
+	{
+		return kcenon::common::error_info{ -8, "Listener not running", "unix_socket_listener" };
+	}
+	return kcenon::common::ok();
+}
+
+const unix_socket_config& unix_socket_listener::config() const noexcept
+{
+	return config_;
+}
+
+#if !defined(_WIN32)
+
+void unix_socket_listener::io_loop()
+{
+	std::vector<struct pollfd> poll_fds;
+	std::vector<std::shared_ptr<unix_socket_session>> polled;
+
+	while (running_.load())
+	{
+		poll_fds.clear();
+		polled.clear();
+		poll_fds.push_back({wake_fds_[0], POLLIN, 0});
+		// poll() skips negative descriptors, keeping the indices stable
+		poll_fds.push_back({accepting_.load() ? listen_fd_ : -1, POLLIN, 0});
+		{
+			std::lock_guard<std::mutex> lock(sessions_mutex_);
+			for (const auto& [fd, session] : sessions_)
+			{
+				poll_fds.push_back({fd, POLLIN, 0});
+				polled.push_back(session);
+			}
+		}
+
+		if (::poll(poll_fds.data(), static_cast<nfds_t>(poll_fds.size()), -1) < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			break;
+		}
+
+		if (poll_fds[0].revents != 0)
+		{
+			uint8_t drain[64];
+			while (::read(wake_fds_[0], drain, sizeof(drain)) > 0)
+			{
+			}
+		}
+
+		if (!running_.load())
+		{
+			break;
+		}
+
+		for (size_t i = 0; i < polled.size(); ++i)
+		{
+			if (poll_fds[i + 2].revents != 0)
+			{
+				read_client(polled[i]);
+			}
+		}
+
+		if (poll_fds[1].revents & POLLIN)
+		{
+			accept_clients();
+		}
+
+		run_tasks();
+	}
+
+	// Tasks posted before the loop ended still complete; later posts fail
+	{
+		std::lock_guard<std::mutex> lock(tasks_mutex_);
+		tasks_open_ = false;
+	}
+	run_tasks();
+
+	// Shut down every remaining connection
+	std::vector<int> remaining;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		for (const auto& [fd, session] : sessions_)
+		{
+			remaining.push_back(fd);
+		}
+	}
+	for (int fd : remaining)
+	{
+		drop_client(fd);
+	}
+}
+
+void unix_socket_listener::accept_clients()
+{
+	while (true)
+	{
+		int fd = ::accept(listen_fd_, nullptr, nullptr);
+		if (fd < 0)
+		{
+			// EAGAIN: backlog drained; other errors are per-connection
+			if (errno == EINTR || errno == ECONNABORTED)
+			{
+				continue;
+			}
+			return;
+		}
+
+		add_client(fd);
+	}
+}
+
+void unix_socket_listener::add_client(int fd)
+{
+	set_cloexec(fd);
+	set_nonblocking(fd);
+	transport_detail::set_nosigpipe(fd);
+
+	std::shared_ptr<unix_socket_session> session;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		if (sessions_.size() >= config_.max_connections)
+		{
+			::close(fd);
+			return;
+		}
+
+		session = std::make_shared<unix_socket_session>(
+			fd, "uds-" + std::to_string(++next_id_), transport_detail::read_peer_credentials(fd), config_);
+		sessions_[fd] = session;
+	}
+
+	if (connection_callback_)
+	{
+		connection_callback_(session);
+	}
+}
+
+void unix_socket_listener::read_client(const std::shared_ptr<unix_socket_session>& session)
+{
+	uint8_t buffer[64 * 1024];
+	std::vector<std::vector<uint8_t>> frames;
+	bool closed = false;
+
+	// Bounded per round: the rest stays in the socket buffer, where it holds
+	// the client back, and poll() reports the connection again next round
+	size_t total = 0;
+	while (total < config_.max_read_bytes)
+	{
+		auto received = ::recv(session->fd(), buffer, sizeof(buffer), 0);
+		if (received > 0)
+		{
+			total += static_cast<size_t>(received);
+			if (!session->decoder().feed(buffer, static_cast<size_t>(received), frames))
+			{
+				// Oversized frame: the stream can no longer be trusted
+				drop_client(session->fd());
+				return;
+			}
+			continue;
+		}
+
+		if (received < 0 && errno == EINTR)
+		{
+			continue;
+		}
+
+		// EAGAIN: drained for now; anything else is end of stream or an error
+		closed = !(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+		break;
+	}
+
+	if (receive_callback_)
+	{
+		for (const auto& frame : frames)
+		{
+			receive_callback_(session->id(), frame);
+		}
+	}
+
+	if (closed)
+	{
+		drop_client(session->fd());
+	}
+}
+
+void unix_socket_listener::drop_client(int fd)
+{
+	std::shared_ptr<unix_socket_session> session;
+	{
+		std::lock_guard<std::mutex> lock(sessions_mutex_);
+		auto it = sessions_.find(fd);
+		if (it == sessions_.end())
+		{
+			return;
+		}
+		session = std::move(it->second);
+		sessions_.erase(it);
+	}
+
+	session->close();
+
+	if (disconnection_callback_)
+	{
+		disconnection_callback_(session->id());
+	}
+}
+
+bool unix_socket_listener::post(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(tasks_mutex_);
+		if (!tasks_open_)
+		{
+			return false;
+		}
+		tasks_.push_back(std::move(task));
+
+		// Under the lock: the wake pipe outlives the tasks_open_ flag
+		wake();
+	}
+	return true;
+}
+
+void unix_socket_listener::run_tasks()
+{
+	std::vector<std::function<void()>> tasks;
+	{
+		std::lock_guard<std::mutex> lock(tasks_mutex_);
+		tasks.swap(tasks_);
+	}
+	for (auto& task : tasks)
+	{
+		task();
+	}
+}
+
+void unix_socket_listener::wake()
+{
+	uint8_t signal = 1;
+	(void)!::write(wake_fds_[1], &signal, 1);
+}
+
+#else
+
+void unix_socket_listener::io_loop() {}
+void unix_socket_listener::accept_clients() {}
+void unix_socket_listener::add_client(int) {}
+void unix_socket_listener::read_client(const std::shared_ptr<unix_socket_session>&) {}
+void unix_socket_listener::drop_client(int) {}
+bool unix_socket_listener::post(std::function<void()>) { return false; }
+void unix_socket_listener::run_tasks() {}
+void unix_socket_listener::wake() {}
+
+#endif
+
+} // namespace database_server::gateway
@@ -56,6 +56,8 @@ void print_usage(const char* program_name)
 	std::cout << "Options:\n";
 	std::cout << "  -c, --config <file>  Path to configuration file (default: " << DEFAULT_CONFIG
 			  << ")\n";
+	std::cout << "  --takeover           Take the listening sockets over from the running server\n";
+	std::cout << "                       (requires network.handoff_socket_path)\n";
 	std::cout << "  -h, --help           Show this help message\n";
 	std::cout << "  -v, --version        Show version information\n";
 	std::cout << "\n";
@@ -77,6 +79,7 @@ void print_version()
 int main(int argc, char* argv[])
 {
 	std::string config_path = DEFAULT_CONFIG;
+	bool takeover = false;
 
 	// Parse command-line arguments
 	for (int i = 1; i < argc; ++i)
@@ -100,6 +103,12 @@ int main(int argc, char* argv[])
 			continue;
 		}
 
+		if (std::strcmp(argv[i], "--takeover") == 0)
+		{
+			takeover = true;
+			continue;
+		}
+
 		std::cerr << "Unknown option: " << argv[i] << "\n";
 		std::cerr << "Use --help for usage information.\n";
 		return 1;
@@ -120,6 +129,7 @@ int main(int argc, char* argv[])
 		std::cout << "Using default configuration\n";
 		config = database_server::server_config::default_config();
 	}
+	config.network.takeover = takeover;
 
 	auto init_result = app.initialize(config);
 	if (init_result.is_err())
@@ -13,7 +13,25 @@
  * - gateway_server, gateway_config: TCP server handling
  * - query_router, router_config: Query routing with load balancing
  * - query_cache, cache_config: Query result caching
+ * - result_delta_tracker, delta_config: Delta-encoded polling results
+ * - invalidation_broadcaster: Cache invalidation subscriptions
+ * - blob_upload_store, spill_buffer: Chunked upload of large binary parameters
+ * - codel_controller, codel_config: Queue-delay-based load shedding
+ * - client_quota_manager, client_quota_config: Per-client concurrency quotas
+ * - cost_limiter, cost_limit_config: Per-client rate limiting by measured query cost
+ * - memory_governor, memory_reservation: Global memory budget
+ * - encode_wire_v2, decode_request_v2, decode_response_v2: Compact binary wire format
+ * - query_request_view, param_list_view: Zero-copy request decoding
+ * - session_transport, unix_socket_listener, shm_transport_listener: Local client transports
+ * - io_uring_listener: io_uring TCP transport
+ * - tls_listener, tls_stats: TLS termination with session resumption
+ * - handoff_server, handoff_client: Listening-socket handoff between processes
  * - auth_middleware, auth_config: Authentication and rate limiting
+ * - gcra_limiter, gcra_params: Sharded per-client GCRA rate limiting
+ * - shared_gcra_limiter: GCRA rate limiting shared by processes through shared memory
+ * - token_cache: Cache of validated authentication tokens
+ * - audit_pipeline, audit_config: Asynchronous batched audit event delivery
+ * - jwt_validator, jwt_key, jwt_config: HS256/HS512 JSON Web Token validation
  * - generate_session_id: Session ID generation
  *
  * Part of the kcenon.database_server module.
@@ -33,6 +51,7 @@ module;
 #include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <variant>
@@ -44,8 +63,29 @@ module;
 #include "kcenon/database_server/gateway/query_handler_base.h"
 #include "kcenon/database_server/gateway/query_handlers.h"
 #include "kcenon/database_server/gateway/auth_middleware.h"
+#include "kcenon/database_server/gateway/gcra_limiter.h"
+#include "kcenon/database_server/gateway/shared_gcra_limiter.h"
+#include "kcenon/database_server/gateway/token_cache.h"
+#include "kcenon/database_server/gateway/audit_pipeline.h"
+#include "kcenon/database_server/gateway/hmac_sha2.h"
+#include "kcenon/database_server/gateway/jwt_validator.h"
 #include "kcenon/database_server/gateway/query_cache.h"
+#include "kcenon/database_server/gateway/result_delta.h"
+#include "kcenon/database_server/gateway/invalidation_broadcaster.h"
+#include "kcenon/database_server/gateway/blob_upload.h"
+#include "kcenon/database_server/gateway/codel_controller.h"
+#include "kcenon/database_server/gateway/client_quota.h"
+#include "kcenon/database_server/gateway/cost_limiter.h"
+#include "kcenon/database_server/gateway/memory_governor.h"
+#include "kcenon/database_server/gateway/request_view.h"
+#include "kcenon/database_server/gateway/wire_format.h"
 #include "kcenon/database_server/gateway/query_router.h"
+#include "kcenon/database_server/gateway/session_transport.h"
+#include "kcenon/database_server/gateway/io_uring_listener.h"
+#include "kcenon/database_server/gateway/tls_listener.h"
+#include "kcenon/database_server/gateway/shm_transport.h"
+#include "kcenon/database_server/gateway/listener_handoff.h"
+#include "kcenon/database_server/gateway/unix_socket_listener.h"
 #include "kcenon/database_server/gateway/gateway_server.h"
 #include "kcenon/database_server/gateway/session_id_generator.h"
 
@@ -83,6 +123,10 @@ using ::database_server::gateway::message_header;
 // Re-export authentication token
 using ::database_server::gateway::auth_token;
 
+// Re-export chunked upload messages
+using ::database_server::gateway::blob_ref;
+using ::database_server::gateway::blob_chunk;
+
 // Re-export query parameter
 using ::database_server::gateway::query_param;
 
@@ -98,9 +142,15 @@ using ::database_server::gateway::column_metadata;
 // Re-export result row
 using ::database_server::gateway::result_row;
 
+// Re-export result delta
+using ::database_server::gateway::result_delta;
+
 // Re-export query response
 using ::database_server::gateway::query_response;
 
+// Re-export invalidation event
+using ::database_server::gateway::invalidation_event;
+
 } // namespace database_server::gateway
 
 // ============================================================================
@@ -112,6 +162,7 @@ export namespace database_server::gateway {
 // Re-export auth configuration
 using ::database_server::gateway::auth_config;
 using ::database_server::gateway::rate_limit_config;
+using ::database_server::gateway::rate_limit_algorithm;
 
 // Re-export auth event types
 using ::database_server::gateway::auth_event_type;
@@ -119,6 +170,13 @@ using ::database_server::gateway::auth_event;
 
 // Re-export callback type
 using ::database_server::gateway::audit_callback_t;
+using ::database_server::gateway::audit_batch_callback_t;
+
+// Re-export asynchronous audit delivery
+using ::database_server::gateway::audit_overflow_policy;
+using ::database_server::gateway::audit_config;
+using ::database_server::gateway::audit_metrics;
+using ::database_server::gateway::audit_pipeline;
 
 // Re-export auth result
 using ::database_server::gateway::auth_result;
@@ -130,10 +188,24 @@ using ::database_server::gateway::simple_token_validator;
 // Re-export rate limit entry and limiter
 using ::database_server::gateway::rate_limit_entry;
 using ::database_server::gateway::rate_limiter;
+using ::database_server::gateway::gcra_params;
+using ::database_server::gateway::gcra_limiter;
+using ::database_server::gateway::shared_gcra_limiter;
 
 // Re-export auth metrics
 using ::database_server::gateway::auth_metrics;
 
+// Re-export token cache
+using ::database_server::gateway::token_cache;
+
+// Re-export JWT validation
+using ::database_server::gateway::jwt_algorithm;
+using ::database_server::gateway::jwt_key;
+using ::database_server::gateway::jwt_config;
+using ::database_server::gateway::jwt_validator;
+using ::database_server::gateway::hmac_sha256;
+using ::database_server::gateway::hmac_sha512;
+
 // Re-export auth middleware
 using ::database_server::gateway::auth_middleware;
 
@@ -151,11 +223,151 @@ using ::database_server::gateway::cache_config;
 // Re-export cache metrics
 using ::database_server::gateway::cache_metrics;
 
+// Re-export invalidation listener type
+using ::database_server::gateway::invalidation_listener_t;
+
 // Re-export query cache
 using ::database_server::gateway::query_cache;
 
 } // namespace database_server::gateway
 
+// ============================================================================
+// Delta-Encoded Results
+// ============================================================================
+
+export namespace database_server::gateway {
+
+// Re-export delta configuration and metrics
+using ::database_server::gateway::delta_config;
+using ::database_server::gateway::delta_metrics;
+
+// Re-export delta tracker
+using ::database_server::gateway::result_delta_tracker;
+
+} // namespace database_server::gateway
+
+// ============================================================================
+// Cache Invalidation Subscriptions
+// ============================================================================
+
+export namespace database_server::gateway {
+
+// Re-export invalidation configuration and metrics
+using ::database_server::gateway::invalidation_config;
+using ::database_server::gateway::invalidation_metrics;
+
+// Re-export sender callback type
+using ::database_server::gateway::invalidation_sender_t;
+
+// Re-export invalidation broadcaster
+using ::database_server::gateway::invalidation_broadcaster;
+
+} // namespace database_server::gateway
+
+// ============================================================================
+// Chunked Uploads
+// ============================================================================
+
+export namespace database_server::gateway {
+
+// Re-export upload configuration and metrics
+using ::database_server::gateway::blob_upload_config;
+using ::database_server::gateway::blob_upload_metrics;
+
+// Re-export spill buffer and upload store
+using ::database_server::gateway::spill_buffer;
+using ::database_server::gateway::blob_upload_store;
+
+} // namespace database_server::gateway
+
+// ============================================================================
+// Load Shedding
+// ============================================================================
+
+export namespace database_server::gateway {
+
+// Re-export shedding configuration and metrics
+using ::database_server::gateway::codel_config;
+using ::database_server::gateway::codel_metrics;
+
+// Re-export admission controller
+using ::database_server::gateway::is_sheddable;
+using ::database_server::gateway::codel_controller;
+
+// Re-export per-client concurrency quotas
+using ::database_server::gateway::client_quota_config;
+using ::database_server::gateway::quota_kind;
+using ::database_server::gateway::client_quota_usage;
+using ::database_server::gateway::client_quota_manager;
+
+// Re-export cost-based rate limiting
+using ::database_server::gateway::cost_limit_config;
+using ::database_server::gateway::query_cost;
+using ::database_server::gateway::cost_ticket;
+using ::database_server::gateway::cost_limit_metrics;
+using ::database_server::gateway::cost_limiter;
+
+} // namespace database_server::gateway
+
+// ============================================================================
+// Memory Governance
+// ============================================================================
+
+export namespace database_server::gateway {
+
+// Re-export subsystem identifiers and configuration
+using ::database_server::gateway::memory_subsystem;
+using ::database_server::gateway::memory_subsystem_count;
+using ::database_server::gateway::memory_governor_config;
+using ::database_server::gateway::memory_governor_metrics;
+
+// Re-export governor and reservation
+using ::database_server::gateway::memory_reservation;
+using ::database_server::gateway::memory_governor;
+
+} // namespace database_server::gateway
+
+// ============================================================================
+// Wire Format v2
+// ============================================================================
+
+export namespace database_server::gateway {
+
+// Re-export version constants and frame kinds
+using ::database_server::gateway::wire_version_v1;
+using ::database_server::gateway::wire_version_v2;
+using ::database_server::gateway::wire_v2_magic;
+using ::database_server::gateway::wire_v2_header_size;
+using ::database_server::gateway::wire_message_kind;
+using ::database_server::gateway::wire_flag_columnar;
+using ::database_server::gateway::wire_row_layout;
+using ::database_server::gateway::wire_flag_sequential;
+using ::database_server::gateway::wire_batch;
+
+// Re-export encoding and decoding functions
+using ::database_server::gateway::is_wire_v2;
+using ::database_server::gateway::encode_wire_v2;
+using ::database_server::gateway::decode_request_v2;
+using ::database_server::gateway::decode_response_v2;
+using ::database_server::gateway::wire_v2_kind;
+using ::database_server::gateway::encode_wire_v2_batch;
+using ::database_server::gateway::encode_request_batch_v2;
+using ::database_server::gateway::decode_wire_v2_batch;
+using ::database_server::gateway::decode_response_batch_v2;
+
+// Re-export request views
+using ::database_server::gateway::blob_ref_view;
+using ::database_server::gateway::param_value_view;
+using ::database_server::gateway::query_param_view;
+using ::database_server::gateway::param_list_view;
+using ::database_server::gateway::message_header_view;
+using ::database_server::gateway::auth_token_view;
+using ::database_server::gateway::query_options_view;
+using ::database_server::gateway::blob_chunk_view;
+using ::database_server::gateway::query_request_view;
+
+} // namespace database_server::gateway
+
 // ============================================================================
 // Query Handler CRTP Infrastructure
 // ============================================================================
@@ -205,6 +417,38 @@ using ::database_server::gateway::query_router;
 
 } // namespace database_server::gateway
 
+// ============================================================================
+// Session Transports
+// ============================================================================
+
+export namespace database_server::gateway {
+
+// Re-export transport interfaces
+using ::database_server::gateway::peer_credentials;
+using ::database_server::gateway::session_transport;
+using ::database_server::gateway::transport_listener;
+
+// Re-export Unix domain socket listener
+using ::database_server::gateway::unix_socket_config;
+using ::database_server::gateway::unix_socket_listener;
+using ::database_server::gateway::shm_transport_config;
+using ::database_server::gateway::shm_transport_listener;
+using ::database_server::gateway::shm_client_config;
+using ::database_server::gateway::shm_client;
+using ::database_server::gateway::io_uring_config;
+using ::database_server::gateway::io_uring_stats;
+using ::database_server::gateway::io_uring_listener;
+using ::database_server::gateway::tls_config;
+using ::database_server::gateway::tls_stats;
+using ::database_server::gateway::tls_listener;
+using ::database_server::gateway::handoff_config;
+using ::database_server::gateway::handoff_socket;
+using ::database_server::gateway::close_handoff_socket;
+using ::database_server::gateway::handoff_server;
+using ::database_server::gateway::handoff_client;
+
+} // namespace database_server::gateway
+
 // ============================================================================
 // Gateway Server
 // ============================================================================
@@ -212,6 +456,7 @@ using ::database_server::gateway::query_router;
 export namespace database_server::gateway {
 
 // Re-export gateway configuration
+using ::database_server::gateway::tcp_transport_type;
 using ::database_server::gateway::gateway_config;
 
 // Re-export client session
@@ -10,7 +10,9 @@
  * - health_status, health_check_config: Health monitoring configuration
  * - connection_health_monitor: Heartbeat-based health tracking
  * - reconnection_config, connection_state: Reconnection settings
- * - resilient_database_connection: Auto-reconnecting connection wrapper
+ * - resilient_database_connection: Connection wrapper with background reconnection
+ * - circuit_breaker, circuit_breaker_config, circuit_state: Fail-fast protection of a backend
+ * - call_failure, is_backend_failure: Which failures mean the backend is unavailable
  *
  * Part of the kcenon.database_server module.
  */
@@ -29,6 +31,7 @@ module;
 #include <vector>
 
 // Include existing headers in the global module fragment
+#include "kcenon/database_server/resilience/circuit_breaker.h"
 #include "kcenon/database_server/resilience/connection_health_monitor.h"
 #include "kcenon/database_server/resilience/resilient_database_connection.h"
 
@@ -72,3 +75,24 @@ using ::database_server::resilience::to_string;
 using ::database_server::resilience::resilient_database_connection;
 
 } // namespace database_server::resilience
+
+// ============================================================================
+// Circuit Breaker
+// ============================================================================
+
+export namespace database_server::resilience {
+
+// Re-export circuit breaker configuration and state
+using ::database_server::resilience::circuit_breaker_config;
+using ::database_server::resilience::circuit_state;
+using ::database_server::resilience::circuit_permit;
+using ::database_server::resilience::circuit_breaker_metrics;
+
+// Re-export failure classification shared by the breaker's callers
+using ::database_server::resilience::call_failure;
+using ::database_server::resilience::is_backend_failure;
+
+// Re-export circuit breaker
+using ::database_server::resilience::circuit_breaker;
+
+} // namespace database_server::resilience
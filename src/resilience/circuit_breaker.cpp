@@ -0,0 +1,260 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+#include <kcenon/database_server/resilience/circuit_breaker.h>
+
+#include <algorithm>
+
+namespace database_server::resilience
+{
+
+circuit_breaker::circuit_breaker(const circuit_breaker_config& config)
+	: config_(config)
+	, bucket_ns_(std::max<int64_t>(static_cast<int64_t>(config.window_ms) * 1'000'000
+									   / std::max<uint32_t>(config.window_buckets, 1),
+								   1))
+	, open_ns_(static_cast<int64_t>(config.open_duration_ms) * 1'000'000)
+	, slow_threshold_(std::chrono::milliseconds(config.slow_call_ms))
+	, buckets_(std::max<uint32_t>(config.window_buckets, 1))
+{
+}
+
+circuit_permit circuit_breaker::admit()
+{
+	return admit(clock::now());
+}
+
+circuit_permit circuit_breaker::admit(clock::time_point now)
+{
+	if (!config_.enabled)
+	{
+		return circuit_permit{ true, false, 0 };
+	}
+
+	// Read the generation first: a transition in between makes the permit stale
+	auto generation = generation_.load(std::memory_order_acquire);
+	auto current = state_.load(std::memory_order_acquire);
+	if (current == circuit_state::closed)
+	{
+		metrics_.admitted.fetch_add(1, std::memory_order_relaxed);
+		return circuit_permit{ true, false, generation };
+	}
+
+	auto now_ns = to_ns(now);
+	if (current == circuit_state::open
+		&& now_ns < open_until_.load(std::memory_order_relaxed))
+	{
+		metrics_.rejected.fetch_add(1, std::memory_order_relaxed);
+		return circuit_permit{};
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	current = state_.load(std::memory_order_relaxed);
+	if (current == circuit_state::closed)
+	{
+		metrics_.admitted.fetch_add(1, std::memory_order_relaxed);
+		return circuit_permit{ true, false, generation_.load(std::memory_order_relaxed) };
+	}
+	if (current == circuit_state::open)
+	{
+		if (now_ns < open_until_.load(std::memory_order_relaxed))
+		{
+			metrics_.rejected.fetch_add(1, std::memory_order_relaxed);
+			return circuit_permit{};
+		}
+		probes_in_flight_ = 0;
+		probe_successes_ = 0;
+		transition_locked(circuit_state::half_open);
+	}
+
+	if (probes_in_flight_ >= std::max<uint32_t>(config_.half_open_probes, 1))
+	{
+		metrics_.rejected.fetch_add(1, std::memory_order_relaxed);
+		return circuit_permit{};
+	}
+	++probes_in_flight_;
+	metrics_.admitted.fetch_add(1, std::memory_order_relaxed);
+	return circuit_permit{ true, true, generation_.load(std::memory_order_relaxed) };
+}
+
+void circuit_breaker::record(const circuit_permit& permit, bool success,
+							 clock::duration latency)
+{
+	record(permit, success, latency, clock::now());
+}
+
+void circuit_breaker::record(const circuit_permit& permit, bool success,
+							 clock::duration latency, clock::time_point now)
+{
+	if (!config_.enabled || !permit.admitted)
+	{
+		return;
+	}
+
+	bool slow = config_.slow_call_ms > 0 && latency >= slow_threshold_;
+	(success ? metrics_.successes : metrics_.failures).fetch_add(1, std::memory_order_relaxed);
+	if (slow)
+	{
+		metrics_.slow_calls.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	auto now_ns = to_ns(now);
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (permit.generation != generation_.load(std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	auto current = state_.load(std::memory_order_relaxed);
+	if (current == circuit_state::half_open)
+	{
+		--probes_in_flight_;
+		if (!success || slow)
+		{
+			open_locked(now_ns);
+		}
+		else if (++probe_successes_ >= std::max<uint32_t>(config_.half_open_probes, 1))
+		{
+			std::fill(buckets_.begin(), buckets_.end(), bucket{});
+			transition_locked(circuit_state::closed);
+		}
+		return;
+	}
+	if (current != circuit_state::closed)
+	{
+		return;
+	}
+
+	auto index = now_ns / bucket_ns_;
+	auto& target = buckets_[static_cast<size_t>(index) % buckets_.size()];
+	if (target.index != index)
+	{
+		target = bucket{ index, 0, 0, 0 };
+	}
+	++target.calls;
+	target.failures += success ? 0 : 1;
+	target.slow += slow ? 1 : 0;
+
+	if (should_open_locked(now_ns))
+	{
+		open_locked(now_ns);
+	}
+}
+
+void circuit_breaker::cancel(const circuit_permit& permit)
+{
+	if (!permit.probe)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (permit.generation == generation_.load(std::memory_order_relaxed)
+		&& probes_in_flight_ > 0)
+	{
+		--probes_in_flight_;
+	}
+}
+
+circuit_state circuit_breaker::state() const noexcept
+{
+	return state_.load(std::memory_order_acquire);
+}
+
+const circuit_breaker_metrics& circuit_breaker::metrics() const noexcept
+{
+	return metrics_;
+}
+
+const circuit_breaker_config& circuit_breaker::config() const noexcept
+{
+	return config_;
+}
+
+int64_t circuit_breaker::to_ns(clock::time_point time) noexcept
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch())
+		.count();
+}
+
+void circuit_breaker::open_locked(int64_t now)
+{
+	// Published before the state so the lock-free check sees the deadline
+	open_until_.store(now + open_ns_, std::memory_order_relaxed);
+	transition_locked(circuit_state::open);
+}
+
+void circuit_breaker::transition_locked(circuit_state next)
+{
+	state_.store(next, std::memory_order_release);
+	generation_.fetch_add(1, std::memory_order_release);
+
+	switch (next)
+	{
+	case circuit_state::open:
+		metrics_.opened.fetch_add(1, std::memory_order_relaxed);
+		break;
+	case circuit_state::half_open:
+		metrics_.half_opened.fetch_add(1, std::memory_order_relaxed);
+		break;
+	case circuit_state::closed:
+		metrics_.closed.fetch_add(1, std::memory_order_relaxed);
+		break;
+	}
+}
+
+bool circuit_breaker::should_open_locked(int64_t now) const
+{
+	auto oldest = now / bucket_ns_ - static_cast<int64_t>(buckets_.size()) + 1;
+	uint64_t calls = 0;
+	uint64_t failures = 0;
+	uint64_t slow = 0;
+	for (const auto& entry : buckets_)
+	{
+		if (entry.index >= oldest)
+		{
+			calls += entry.calls;
+			failures += entry.failures;
+			slow += entry.slow;
+		}
+	}
+
+	if (calls == 0 || calls < config_.min_calls)
+	{
+		return false;
+	}
+	auto total = static_cast<double>(calls);
+	return static_cast<double>(failures) >= config_.failure_ratio * total
+		   || (config_.slow_call_ms > 0
+			   && static_cast<double>(slow) >= config_.slow_call_ratio * total);
+}
+
+} // namespace database_server::resilience
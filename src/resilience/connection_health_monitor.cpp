@@ -133,6 +133,8 @@ kcenon::common::Result<health_status> connection_health_monitor::check_now()
 {
 	if (!backend_ || !backend_->is_initialized())
 	{
+		heartbeat_failed_ = true;
+
 		std::lock_guard<std::mutex> lock(mutex_);
 		current_status_.is_healthy = false;
 		current_status_.health_score = 0;
@@ -149,6 +151,7 @@ kcenon::common::Result<health_status> connection_health_monitor::check_now()
 	auto end = std::chrono::high_resolution_clock::now();
 
 	auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+	heartbeat_failed_ = result.is_err();
 
 	std::lock_guard<std::mutex> lock(mutex_);
 
@@ -221,6 +224,11 @@ bool connection_health_monitor::is_healthy() const noexcept
 		   && get_health_score() >= config_.min_health_score;
 }
 
+bool connection_health_monitor::heartbeat_failed() const noexcept
+{
+	return heartbeat_failed_;
+}
+
 uint32_t connection_health_monitor::get_health_score() const noexcept
 {
 	std::lock_guard<std::mutex> lock(mutex_);
@@ -269,6 +277,7 @@ void connection_health_monitor::reset_statistics()
 	failed_queries_ = 0;
 	consecutive_failures_ = 0;
 	consecutive_successes_ = 0;
+	heartbeat_failed_ = false;
 
 	std::lock_guard<std::mutex> lock(mutex_);
 	latency_history_.clear();
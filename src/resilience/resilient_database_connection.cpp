@@ -34,18 +34,50 @@
 #include <algorithm>
 #include <cmath>
 #include <functional>
-#include <thread>
+#include <random>
 
 namespace database_server::resilience
 {
 
+/**
+ * @class reconnect_job
+ * @brief IJob implementation for the background reconnection loop
+ */
+class reconnect_job : public kcenon::common::interfaces::IJob
+{
+public:
+	reconnect_job(resilient_database_connection* connection, uint64_t generation)
+		: connection_(connection)
+		, generation_(generation)
+	{
+	}
+
+	kcenon::common::VoidResult execute() override
+	{
+		if (connection_)
+		{
+			connection_->reconnect_loop(generation_);
+		}
+		return kcenon::common::ok();
+	}
+
+	std::string get_name() const override { return "database_reconnect_loop"; }
+	int get_priority() const override { return 0; }
+
+private:
+	resilient_database_connection* connection_;
+	uint64_t generation_;
+};
+
 resilient_database_connection::resilient_database_connection(
 	std::unique_ptr<database::core::database_backend> backend,
 	reconnection_config config,
-	std::shared_ptr<kcenon::common::interfaces::IExecutor> executor)
+	std::shared_ptr<kcenon::common::interfaces::IExecutor> executor,
+	std::shared_ptr<circuit_breaker> breaker)
 	: backend_(std::move(backend))
 	, config_(std::move(config))
 	, executor_(std::move(executor))
+	, breaker_(std::move(breaker))
 {
 	if (backend_)
 	{
@@ -56,6 +88,7 @@ resilient_database_connection::resilient_database_connection(
 
 resilient_database_connection::~resilient_database_connection()
 {
+	stop_reconnect();
 	stop_auto_recovery();
 	if (backend_ && backend_->is_initialized())
 	{
@@ -71,6 +104,14 @@ database::database_types resilient_database_connection::type() const
 kcenon::common::VoidResult resilient_database_connection::initialize(
 	const database::core::connection_config& config)
 {
+	// A reconnection task still backing off must not re-initialize the
+	// backend behind this call
+	stop_reconnect();
+	{
+		std::lock_guard<std::mutex> reconnect_lock(reconnect_mutex_);
+		reconnect_stopped_ = false;
+	}
+
 	std::lock_guard<std::mutex> lock(mutex_);
 
 	if (!backend_)
@@ -107,6 +148,7 @@ kcenon::common::VoidResult resilient_database_connection::initialize(
 
 kcenon::common::VoidResult resilient_database_connection::shutdown()
 {
+	stop_reconnect();
 	stop_auto_recovery();
 
 	if (health_monitor_)
@@ -249,7 +291,17 @@ kcenon::common::VoidResult resilient_database_connection::ensure_connected()
 		return kcenon::common::ok();
 	}
 
-	return attempt_reconnect();
+	auto scheduled = schedule_reconnect();
+	if (scheduled.is_err())
+	{
+		return scheduled;
+	}
+
+	return kcenon::common::error_info{
+		-5,
+		"Reconnecting to backend",
+		"resilient_database_connection"
+	};
 }
 
 kcenon::common::Result<health_status> resilient_database_connection::check_health()
@@ -290,7 +342,13 @@ uint32_t resilient_database_connection::get_retry_count() const noexcept
 	return retry_count_.load();
 }
 
-kcenon::common::VoidResult resilient_database_connection::attempt_reconnect()
+std::shared_ptr<circuit_breaker> resilient_database_connection::get_circuit_breaker()
+	const noexcept
+{
+	return breaker_;
+}
+
+kcenon::common::VoidResult resilient_database_connection::schedule_reconnect()
 {
 	if (!config_.enable_auto_reconnect)
 	{
@@ -301,61 +359,162 @@ kcenon::common::VoidResult resilient_database_connection::attempt_reconnect()
 		};
 	}
 
-	std::lock_guard<std::mutex> lock(mutex_);
-
-	if (retry_count_ >= config_.max_retries)
+	if (!backend_)
 	{
-		set_state(connection_state::failed);
-		last_error_message_ = "Max retries exceeded";
 		return kcenon::common::error_info{
-			-3,
-			"Max retries exceeded",
+			-1,
+			"Backend is null",
 			"resilient_database_connection"
 		};
 	}
 
-	set_state(connection_state::reconnecting);
+	std::future<void> previous;
+	std::unique_lock<std::mutex> lock(reconnect_mutex_);
 
-	// Calculate and apply backoff delay
-	auto delay = calculate_next_delay();
-	std::this_thread::sleep_for(delay);
+	if (reconnect_stopped_)
+	{
+		return kcenon::common::error_info{
+			-6,
+			"Connection is shut down",
+			"resilient_database_connection"
+		};
+	}
 
-	// Attempt reconnection
-	if (!backend_)
+	if (retry_count_ >= config_.max_retries)
 	{
 		set_state(connection_state::failed);
-		last_error_message_ = "Backend is null";
+		{
+			std::lock_guard<std::mutex> error_lock(mutex_);
+			last_error_message_ = "Max retries exceeded";
+		}
 		return kcenon::common::error_info{
-			-1,
-			"Backend is null",
+			-3,
+			"Max retries exceeded",
 			"resilient_database_connection"
 		};
 	}
 
-	backend_->shutdown();
+	// One task per connection; it leaves the reconnecting state on exit
+	auto current = state_.load();
+	do
+	{
+		if (current == connection_state::reconnecting)
+		{
+			return kcenon::common::ok();
+		}
+	} while (!state_.compare_exchange_weak(current, connection_state::reconnecting));
 
-	auto result = backend_->initialize(connection_config_);
+	// A previous task has left its loop or is told to by the new generation;
+	// it is reaped below without the lock, which its backoff wait needs
+	previous = std::move(reconnect_future_);
+	auto generation = ++reconnect_generation_;
 
-	if (result.is_err())
+	bool submitted = false;
+	if (executor_)
 	{
-		retry_count_++;
-		last_error_message_ = result.error().message;
-		set_state(connection_state::failed);
-		return result;
+		auto job = std::make_unique<reconnect_job>(this, generation);
+		auto result = executor_->execute(std::move(job));
+		if (result.is_ok())
+		{
+			reconnect_future_ = std::move(result.unwrap());
+			submitted = true;
+		}
 	}
 
-	set_state(connection_state::connected);
-	reset_retry_state();
-
-	if (health_monitor_)
+	if (!submitted)
 	{
-		health_monitor_->reset_statistics();
-		health_monitor_->start_monitoring();
+		// Fallback to std::async if no executor provided (or it refused the job)
+		reconnect_future_ = std::async(std::launch::async,
+									   [this, generation] { reconnect_loop(generation); });
 	}
 
+	lock.unlock();
+	reconnect_cv_.notify_all();
+	if (previous.valid())
+	{
+		previous.wait();
+	}
 	return kcenon::common::ok();
 }
 
+void resilient_database_connection::reconnect_loop(uint64_t generation)
+{
+	while (state_.load() == connection_state::reconnecting)
+	{
+		if (retry_count_ >= config_.max_retries)
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				last_error_message_ = "Max retries exceeded";
+			}
+			set_state(connection_state::failed);
+			return;
+		}
+
+		// Back off without holding mutex_; shutdown wakes the wait early
+		{
+			std::unique_lock<std::mutex> lock(reconnect_mutex_);
+			if (reconnect_cv_.wait_for(lock, calculate_next_delay(), [this, generation]
+									   { return reconnect_stopped_ || generation != reconnect_generation_; }))
+			{
+				return;
+			}
+		}
+
+		// initialize() may have restored the connection meanwhile
+		if (state_.load() != connection_state::reconnecting)
+		{
+			return;
+		}
+
+		bool reconnected = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			backend_->shutdown();
+			auto result = backend_->initialize(connection_config_);
+			reconnected = result.is_ok();
+			if (!reconnected)
+			{
+				last_error_message_ = result.error().message;
+			}
+		}
+
+		if (!reconnected)
+		{
+			retry_count_++;
+			continue;
+		}
+
+		reset_retry_state();
+		if (health_monitor_)
+		{
+			health_monitor_->reset_statistics();
+			health_monitor_->start_monitoring();
+		}
+
+		// Last action: a new task may be scheduled as soon as this is visible
+		set_state(connection_state::connected);
+		return;
+	}
+}
+
+void resilient_database_connection::stop_reconnect()
+{
+	std::future<void> pending;
+	{
+		std::lock_guard<std::mutex> lock(reconnect_mutex_);
+		reconnect_stopped_ = true;
+		pending = std::move(reconnect_future_);
+	}
+	reconnect_cv_.notify_all();
+
+	// The loop only blocks in the backoff wait or a single initialize()
+	if (pending.valid())
+	{
+		pending.wait();
+	}
+}
+
 template <typename Func>
 auto resilient_database_connection::execute_with_retry(Func&& operation)
 	-> decltype(operation())
@@ -377,6 +536,32 @@ auto resilient_database_connection::execute_with_retry(Func&& operation)
 		return operation();
 	}
 
+	// Fail fast while the background task owns the backend so the caller
+	// can take another pooled connection
+	if (state_.load() == connection_state::reconnecting)
+	{
+		return kcenon::common::error_info{
+			-5,
+			"Reconnecting to backend",
+			"resilient_database_connection"
+		};
+	}
+
+	// Fail fast while the backend is known to be down; no reconnect either
+	circuit_permit permit;
+	if (breaker_)
+	{
+		permit = breaker_->admit();
+		if (!permit.admitted)
+		{
+			return kcenon::common::error_info{
+				-4,
+				"Circuit breaker open: backend unavailable",
+				"resilient_database_connection"
+			};
+		}
+	}
+
 	auto start_time = std::chrono::high_resolution_clock::now();
 
 	// Try operation
@@ -386,6 +571,13 @@ auto resilient_database_connection::execute_with_retry(Func&& operation)
 	auto latency
 		= std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
+	// Only an unreachable backend counts against the breaker, as in query_router
+	auto failure = result.is_ok() ? call_failure::none : classify_failure();
+	if (breaker_)
+	{
+		breaker_->record(permit, !is_backend_failure(failure), end_time - start_time);
+	}
+
 	if (result.is_ok())
 	{
 		if (health_monitor_)
@@ -395,35 +587,43 @@ auto resilient_database_connection::execute_with_retry(Func&& operation)
 		return result;
 	}
 
-	// Operation failed - record and attempt reconnect if enabled
+	// Operation failed - record and hand reconnection to the background task
 	if (health_monitor_)
 	{
 		health_monitor_->record_failure(result.error().message);
 	}
 
-	if (!config_.enable_auto_reconnect)
 	{
 		std::lock_guard<std::mutex> lock(mutex_);
 		last_error_message_ = result.error().message;
-		return result;
 	}
 
-	// Attempt reconnection
-	auto reconnect_result = attempt_reconnect();
-	if (reconnect_result.is_err())
+	// Errors the database reported for the query itself are the caller's;
+	// only a lost connection is worth reconnecting. The caller gets the
+	// original error now rather than after the backoff.
+	if (config_.enable_auto_reconnect && is_backend_failure(failure))
 	{
-		return result; // Return original error
+		[[maybe_unused]] auto scheduled = schedule_reconnect();
 	}
 
-	// Retry operation after successful reconnection
-	auto retry_result = operation();
+	return result;
+}
+
+call_failure resilient_database_connection::classify_failure()
+{
+	if (!backend_ || !backend_->is_initialized())
+	{
+		return call_failure::connection_failed;
+	}
 
-	if (retry_result.is_ok() && health_monitor_)
+	// A database that rejected the query still answered the last heartbeat;
+	// probing again here would stall every failing caller
+	if (health_monitor_ && health_monitor_->heartbeat_failed())
 	{
-		health_monitor_->record_success(latency);
+		return call_failure::connection_failed;
 	}
 
-	return retry_result;
+	return call_failure::query_error;
 }
 
 std::chrono::milliseconds resilient_database_connection::calculate_next_delay()
@@ -434,6 +634,15 @@ std::chrono::milliseconds resilient_database_connection::calculate_next_delay()
 
 	delay_ms = std::min(delay_ms, static_cast<double>(config_.max_delay.count()));
 
+	// Spread out connections that lost the backend at the same moment
+	double jitter = std::clamp(config_.jitter, 0.0, 1.0);
+	if (jitter > 0.0)
+	{
+		thread_local std::mt19937_64 rng{ std::random_device{}() };
+		std::uniform_real_distribution<double> spread(1.0 - jitter, 1.0);
+		delay_ms *= spread(rng);
+	}
+
 	return std::chrono::milliseconds(static_cast<int64_t>(delay_ms));
 }
 
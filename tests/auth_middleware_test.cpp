@@ -37,19 +37,22 @@
  * - Token validation success/failure cases
  * - Token expiration handling
  * - Rate limiting integration
- * - Audit event emission
+ * - Audit event emission and asynchronous batched delivery
  * - Metrics collection
  * - Session management
  */
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
 #include <mutex>
 #include <thread>
 #include <vector>
 
+#include <kcenon/database_server/gateway/audit_pipeline.h>
 #include <kcenon/database_server/gateway/auth_middleware.h>
+#include <kcenon/database_server/gateway/token_cache.h>
 
 using namespace database_server::gateway;
 
@@ -74,6 +77,23 @@ uint64_t past_timestamp_ms(uint32_t offset_ms)
 	return current_timestamp_ms() - offset_ms;
 }
 
+/// Accepts non-empty tokens and counts how often it was asked
+class counting_validator : public auth_validator
+{
+public:
+	auth_result validate(const auth_token& token) override
+	{
+		calls.fetch_add(1);
+		auth_result result;
+		result.success = !token.token.empty();
+		result.code = result.success ? status_code::ok : status_code::authentication_failed;
+		result.client_id = token.client_id;
+		return result;
+	}
+
+	std::atomic<int> calls{0};
+};
+
 } // namespace
 
 // ============================================================================
@@ -298,6 +318,215 @@ TEST_F(AuthMetricsTest, ResetClearsAllMetrics)
 	EXPECT_EQ(metrics.permission_denied.load(), 0u);
 }
 
+TEST_F(AuthMetricsTest, ResetClearsTokenCacheCounters)
+{
+	auth_metrics metrics;
+	metrics.token_cache_hits.store(7);
+	metrics.token_cache_misses.store(3);
+
+	metrics.reset();
+
+	EXPECT_EQ(metrics.token_cache_hits.load(), 0u);
+	EXPECT_EQ(metrics.token_cache_misses.load(), 0u);
+}
+
+// ============================================================================
+// Token Cache Tests
+// ============================================================================
+
+class TokenCacheTest : public ::testing::Test
+{
+protected:
+	static constexpr uint64_t now_ = 1'000'000'000;
+
+	auth_token make_token(const std::string& value, uint64_t expires_at = 0)
+	{
+		auth_token token;
+		token.token = value;
+		token.client_id = "client-" + value;
+		token.expires_at = expires_at;
+		return token;
+	}
+
+	auth_result success_for(const auth_token& token)
+	{
+		auth_result result;
+		result.success = true;
+		result.client_id = token.client_id;
+		result.permissions = { "read" };
+		return result;
+	}
+};
+
+TEST_F(TokenCacheTest, CachesSuccessUntilRefreshWindow)
+{
+	token_cache cache(16, 1000, 100);
+	auto token = make_token("a", now_ + 1000);
+	cache.insert(token, success_for(token), cache.epoch(), now_);
+
+	auto hit = cache.find(token, now_ + 899);
+	ASSERT_TRUE(hit.has_value());
+	EXPECT_TRUE(hit->success);
+	EXPECT_EQ(hit->client_id, "client-a");
+	EXPECT_EQ(hit->permissions.size(), 1u);
+
+	EXPECT_FALSE(cache.find(token, now_ + 900).has_value());
+}
+
+TEST_F(TokenCacheTest, TokensWithoutExpiryUseTtl)
+{
+	token_cache cache(16, 500, 100);
+	auto token = make_token("a");
+	cache.insert(token, success_for(token), cache.epoch(), now_);
+
+	EXPECT_TRUE(cache.find(token, now_ + 499).has_value());
+	EXPECT_FALSE(cache.find(token, now_ + 500).has_value());
+}
+
+TEST_F(TokenCacheTest, SkipsFailuresAndTokensDueForRefresh)
+{
+	token_cache cache(16, 1000, 100);
+
+	auto failed = make_token("a");
+	auth_result failure;
+	failure.code = status_code::authentication_failed;
+	cache.insert(failed, failure, cache.epoch(), now_);
+
+	auto expiring = make_token("b", now_ + 50);
+	cache.insert(expiring, success_for(expiring), cache.epoch(), now_);
+
+	EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST_F(TokenCacheTest, MismatchedClaimsMiss)
+{
+	token_cache cache(16, 1000, 100);
+	auto token = make_token("a", now_ + 1000);
+	cache.insert(token, success_for(token), cache.epoch(), now_);
+
+	auto other_client = token;
+	other_client.client_id = "someone-else";
+	EXPECT_FALSE(cache.find(other_client, now_).has_value());
+
+	auto other_expiry = token;
+	other_expiry.expires_at += 1;
+	EXPECT_FALSE(cache.find(other_expiry, now_).has_value());
+}
+
+TEST_F(TokenCacheTest, RevokedTokenFails)
+{
+	token_cache cache(16, 1000, 100);
+	auto token = make_token("a", now_ + 1000);
+	cache.insert(token, success_for(token), cache.epoch(), now_);
+
+	cache.revoke("a");
+
+	auto hit = cache.find(token, now_);
+	ASSERT_TRUE(hit.has_value());
+	EXPECT_FALSE(hit->success);
+	EXPECT_EQ(hit->code, status_code::authentication_failed);
+
+	// A later successful validation does not undo the revocation
+	cache.insert(token, success_for(token), cache.epoch(), now_);
+	EXPECT_FALSE(cache.find(token, now_)->success);
+}
+
+TEST_F(TokenCacheTest, ValidationStartedBeforeRevocationIsNotCached)
+{
+	token_cache cache(16, 1000, 100);
+	auto token = make_token("a");
+
+	auto epoch = cache.epoch();
+	cache.revoke_client("client-a");
+	cache.insert(token, success_for(token), epoch, now_);
+
+	EXPECT_FALSE(cache.find(token, now_).has_value());
+}
+
+TEST_F(TokenCacheTest, RevokeClientRevokesAllItsTokens)
+{
+	token_cache cache(64, 1000, 100);
+	for (const auto* value : { "a", "b", "c" })
+	{
+		auto token = make_token(value);
+		token.client_id = value == std::string("c") ? "other" : "shared";
+		cache.insert(token, success_for(token), cache.epoch(), now_);
+	}
+
+	EXPECT_EQ(cache.revoke_client("shared"), 2u);
+
+	auto other = make_token("c");
+	other.client_id = "other";
+	EXPECT_TRUE(cache.find(other, now_)->success);
+}
+
+TEST_F(TokenCacheTest, CapacityBoundsEntriesButKeepsRevocations)
+{
+	token_cache cache(16, 1000, 100);
+	cache.revoke("revoked");
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto token = make_token(std::to_string(i));
+		cache.insert(token, success_for(token), cache.epoch(), now_);
+	}
+
+	EXPECT_LE(cache.size(), 17u);
+	auto revoked = make_token("revoked");
+	ASSERT_TRUE(cache.find(revoked, now_).has_value());
+	EXPECT_FALSE(cache.find(revoked, now_)->success);
+}
+
+TEST_F(TokenCacheTest, RevokedClientRejectsTokensIssuedBefore)
+{
+	token_cache cache(16, 1000, 100, 5000);
+	auto token = make_token("never-cached");
+	token.client_id = "client-a";
+
+	EXPECT_EQ(cache.revoke_client("client-a", now_), 0u);
+
+	// The validator's result for a token the cache never saw
+	auto unknown_issue = success_for(token);
+	EXPECT_TRUE(cache.revoked(token, unknown_issue, now_ + 1));
+	cache.insert(token, unknown_issue, cache.epoch(), now_ + 1);
+	EXPECT_FALSE(cache.find(token, now_ + 1).has_value());
+
+	auto issued_before = success_for(token);
+	issued_before.issued_at = now_ - 1;
+	EXPECT_TRUE(cache.revoked(token, issued_before, now_ + 1));
+
+	auto issued_after = success_for(token);
+	issued_after.issued_at = now_ + 1;
+	EXPECT_FALSE(cache.revoked(token, issued_after, now_ + 2));
+
+	// Once every earlier token has expired the record is dropped
+	EXPECT_FALSE(cache.revoked(token, unknown_issue, now_ + 5000));
+}
+
+TEST_F(TokenCacheTest, RevokingUnknownTokensIsBounded)
+{
+	token_cache cache(16, 1000, 100, 1000, 16);
+
+	std::vector<std::string> accepted;
+	for (int i = 0; i < 1000; ++i)
+	{
+		auto value = "unknown-" + std::to_string(i);
+		if (cache.revoke(value, now_))
+		{
+			accepted.push_back(value);
+		}
+	}
+	ASSERT_FALSE(accepted.empty());
+	EXPECT_LE(accepted.size(), 16u);
+	EXPECT_LE(cache.size(), 16u);
+
+	// Marks of tokens without a known expiry end after the revocation ttl
+	auto token = make_token(accepted.front());
+	ASSERT_TRUE(cache.find(token, now_).has_value());
+	EXPECT_FALSE(cache.find(token, now_ + 1000).has_value());
+	EXPECT_TRUE(cache.revoke("late", now_ + 1000));
+}
+
 // ============================================================================
 // Auth Middleware Basic Tests
 // ============================================================================
@@ -592,6 +821,7 @@ TEST_F(AuthMiddlewareAuditTest, CallbackInvokedOnSuccess)
 
 	middleware.authenticate("session1", token);
 
+	middleware.flush_audit_events();
 	std::lock_guard<std::mutex> lock(events_mutex);
 	ASSERT_EQ(events.size(), 1u);
 	EXPECT_EQ(events[0].type, auth_event_type::auth_success);
@@ -619,6 +849,7 @@ TEST_F(AuthMiddlewareAuditTest, CallbackInvokedOnFailure)
 
 	middleware.authenticate("session1", token);
 
+	middleware.flush_audit_events();
 	std::lock_guard<std::mutex> lock(events_mutex);
 	ASSERT_GE(events.size(), 1u);
 	EXPECT_EQ(events[0].type, auth_event_type::token_invalid);
@@ -651,6 +882,7 @@ TEST_F(AuthMiddlewareAuditTest, CallbackInvokedOnRateLimit)
 		middleware.check_rate_limit("client1");
 	}
 
+	middleware.flush_audit_events();
 	std::lock_guard<std::mutex> lock(events_mutex);
 	bool found_rate_limited = false;
 	for (const auto& event : events)
@@ -699,6 +931,7 @@ TEST_F(AuthMiddlewareSessionTest, SessionCreatedEventEmitted)
 
 	middleware.on_session_created("session1", "client1");
 
+	middleware.flush_audit_events();
 	std::lock_guard<std::mutex> lock(events_mutex);
 	ASSERT_EQ(events.size(), 1u);
 	EXPECT_EQ(events[0].type, auth_event_type::session_created);
@@ -726,6 +959,7 @@ TEST_F(AuthMiddlewareSessionTest, SessionDestroyedEventEmitted)
 	// Then destroy
 	middleware.on_session_destroyed("session1");
 
+	middleware.flush_audit_events();
 	std::lock_guard<std::mutex> lock(events_mutex);
 	ASSERT_GE(events.size(), 2u);
 	EXPECT_EQ(events[1].type, auth_event_type::session_destroyed);
@@ -733,6 +967,50 @@ TEST_F(AuthMiddlewareSessionTest, SessionDestroyedEventEmitted)
 	EXPECT_EQ(events[1].client_id, "client1");
 }
 
+TEST_F(AuthMiddlewareSessionTest, TrustedPeerAuthenticated)
+{
+	auth_cfg_.trusted_peer_uids = {1000};
+	auth_middleware middleware(auth_cfg_, rate_cfg_);
+
+	std::vector<auth_event> events;
+	middleware.set_audit_callback([&events](const auth_event& event) { events.push_back(event); });
+
+	peer_credentials peer;
+	peer.pid = 4242;
+	peer.uid = 1000;
+	peer.gid = 1000;
+
+	auto result = middleware.authenticate_peer("session1", peer);
+	middleware.flush_audit_events();
+
+	EXPECT_TRUE(result.success);
+	EXPECT_EQ(result.client_id, "uid:1000");
+	EXPECT_EQ(middleware.metrics().successful_auths.load(), 1u);
+	ASSERT_EQ(events.size(), 1u);
+	EXPECT_EQ(events[0].type, auth_event_type::auth_success);
+	EXPECT_EQ(events[0].client_id, "uid:1000");
+}
+
+TEST_F(AuthMiddlewareSessionTest, UntrustedPeerRejectedWithoutEvent)
+{
+	auth_cfg_.trusted_peer_uids = {1000};
+	auth_middleware middleware(auth_cfg_, rate_cfg_);
+
+	std::vector<auth_event> events;
+	middleware.set_audit_callback([&events](const auth_event& event) { events.push_back(event); });
+
+	peer_credentials peer;
+	peer.uid = 1001;
+
+	auto result = middleware.authenticate_peer("session1", peer);
+	middleware.flush_audit_events();
+
+	EXPECT_FALSE(result.success);
+	EXPECT_EQ(result.code, status_code::authentication_failed);
+	EXPECT_EQ(middleware.metrics().total_auth_attempts.load(), 0u);
+	EXPECT_TRUE(events.empty());
+}
+
 // ============================================================================
 // Auth Middleware Configuration Access Tests
 // ============================================================================
@@ -772,3 +1050,399 @@ TEST_F(AuthMiddlewareConfigTest, GetRateLimiter)
 	auto& limiter = middleware.get_rate_limiter();
 	EXPECT_EQ(limiter.config().requests_per_second, 50u);
 }
+
+// ============================================================================
+// Auth Middleware Token Cache Tests
+// ============================================================================
+
+class AuthMiddlewareTokenCacheTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		rate_cfg_.enabled = false;
+		validator_ = std::make_shared<counting_validator>();
+	}
+
+	auth_token make_token(const std::string& value)
+	{
+		auth_token token;
+		token.token = value;
+		token.client_id = "client-1";
+		token.expires_at = future_timestamp_ms(3600000);
+		return token;
+	}
+
+	auth_config auth_cfg_;
+	rate_limit_config rate_cfg_;
+	std::shared_ptr<counting_validator> validator_;
+};
+
+TEST_F(AuthMiddlewareTokenCacheTest, ValidatesTokenOnce)
+{
+	auth_middleware middleware(auth_cfg_, rate_cfg_, validator_);
+	auto token = make_token("token-1");
+
+	for (int i = 0; i < 5; ++i)
+	{
+		EXPECT_TRUE(middleware.authenticate("session-1", token).success);
+	}
+
+	EXPECT_EQ(validator_->calls.load(), 1);
+	EXPECT_EQ(middleware.metrics().token_cache_hits.load(), 4u);
+	EXPECT_EQ(middleware.metrics().token_cache_misses.load(), 1u);
+	EXPECT_EQ(middleware.metrics().successful_auths.load(), 5u);
+}
+
+TEST_F(AuthMiddlewareTokenCacheTest, FailuresAreNotCached)
+{
+	auth_middleware middleware(auth_cfg_, rate_cfg_, validator_);
+	auto token = make_token("");
+
+	EXPECT_FALSE(middleware.authenticate("session-1", token).success);
+	EXPECT_FALSE(middleware.authenticate("session-1", token).success);
+
+	EXPECT_EQ(validator_->calls.load(), 2);
+	EXPECT_EQ(middleware.metrics().token_cache_hits.load(), 0u);
+}
+
+TEST_F(AuthMiddlewareTokenCacheTest, TokensNearExpiryAreRevalidated)
+{
+	auth_middleware middleware(auth_cfg_, rate_cfg_, validator_);
+	auto token = make_token("token-1");
+	token.expires_at = future_timestamp_ms(auth_cfg_.token_refresh_window_ms / 2);
+
+	EXPECT_TRUE(middleware.authenticate("session-1", token).success);
+	EXPECT_TRUE(middleware.authenticate("session-1", token).success);
+
+	EXPECT_EQ(validator_->calls.load(), 2);
+}
+
+TEST_F(AuthMiddlewareTokenCacheTest, RevokedTokenRejected)
+{
+	auth_middleware middleware(auth_cfg_, rate_cfg_, validator_);
+	auto token = make_token("token-1");
+	ASSERT_TRUE(middleware.authenticate("session-1", token).success);
+
+	middleware.revoke_token("token-1");
+
+	auto result = middleware.authenticate("session-1", token);
+	EXPECT_FALSE(result.success);
+	EXPECT_EQ(result.code, status_code::authentication_failed);
+	EXPECT_EQ(validator_->calls.load(), 1);
+	EXPECT_EQ(middleware.metrics().invalid_tokens.load(), 1u);
+
+	EXPECT_TRUE(middleware.authenticate("session-1", make_token("token-2")).success);
+	EXPECT_EQ(middleware.revoke_client_tokens("client-1"), 1u);
+	EXPECT_FALSE(middleware.authenticate("session-1", make_token("token-2")).success);
+}
+
+TEST_F(AuthMiddlewareTokenCacheTest, CacheCanBeDisabled)
+{
+	auth_cfg_.cache_validated_tokens = false;
+	auth_middleware middleware(auth_cfg_, rate_cfg_, validator_);
+	auto token = make_token("token-1");
+
+	EXPECT_TRUE(middleware.authenticate("session-1", token).success);
+	EXPECT_TRUE(middleware.authenticate("session-1", token).success);
+
+	EXPECT_EQ(validator_->calls.load(), 2);
+	EXPECT_EQ(middleware.metrics().token_cache_misses.load(), 0u);
+
+	// Revocations do not depend on the cache
+	EXPECT_TRUE(middleware.revoke_token("token-1"));
+	EXPECT_FALSE(middleware.authenticate("session-1", token).success);
+	EXPECT_EQ(middleware.revoke_client_tokens("client-1"), 0u);
+	EXPECT_FALSE(middleware.authenticate("session-1", make_token("token-2")).success);
+}
+
+TEST_F(AuthMiddlewareTokenCacheTest, RevokedClientTokensFailWhenNotCached)
+{
+	auth_middleware middleware(auth_cfg_, rate_cfg_, validator_);
+	ASSERT_TRUE(middleware.authenticate("session-1", make_token("token-1")).success);
+
+	middleware.revoke_client_tokens("client-1");
+
+	// A token the cache never saw still reaches the validator, then fails
+	auto result = middleware.authenticate("session-1", make_token("token-2"));
+	EXPECT_FALSE(result.success);
+	EXPECT_EQ(result.code, status_code::authentication_failed);
+	EXPECT_EQ(validator_->calls.load(), 2);
+
+	auto other = make_token("token-3");
+	other.client_id = "client-2";
+	EXPECT_TRUE(middleware.authenticate("session-2", other).success);
+}
+
+TEST_F(AuthMiddlewareTokenCacheTest, CheckUsesVerifiedResult)
+{
+	auth_middleware middleware(auth_cfg_, rate_cfg_, validator_);
+	auto token = make_token("token-1");
+
+	auto verified = middleware.verify(token);
+	ASSERT_TRUE(verified.success);
+	EXPECT_EQ(validator_->calls.load(), 1);
+	EXPECT_EQ(middleware.metrics().total_auth_attempts.load(), 0u);
+
+	EXPECT_TRUE(middleware.check("session-1", token, verified).success);
+	EXPECT_EQ(validator_->calls.load(), 1);
+	EXPECT_EQ(middleware.metrics().successful_auths.load(), 1u);
+
+	auth_result rejected;
+	rejected.code = status_code::authentication_failed;
+	rejected.message = "bad signature";
+	auto result = middleware.check("session-2", token, rejected);
+	EXPECT_FALSE(result.success);
+	EXPECT_EQ(result.code, status_code::authentication_failed);
+	EXPECT_EQ(validator_->calls.load(), 1);
+}
+
+// ============================================================================
+// Audit Pipeline Tests
+// ============================================================================
+
+class AuditPipelineTest : public ::testing::Test
+{
+protected:
+	static auth_event make_event(int index)
+	{
+		auth_event event;
+		event.type = auth_event_type::auth_success;
+		event.client_id = "client" + std::to_string(index);
+		return event;
+	}
+
+	static int index_of(const auth_event& event)
+	{
+		return std::stoi(event.client_id.substr(6));
+	}
+};
+
+TEST_F(AuditPipelineTest, DeliversEventsInOrder)
+{
+	std::vector<int> received;
+	audit_pipeline pipeline;
+	pipeline.set_callback([&received](const auth_event& event)
+						  { received.push_back(index_of(event)); });
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		EXPECT_TRUE(pipeline.publish(make_event(i)));
+	}
+	pipeline.flush();
+
+	ASSERT_EQ(received.size(), 1000u);
+	for (int i = 0; i < 1000; ++i)
+	{
+		EXPECT_EQ(received[i], i);
+	}
+	EXPECT_EQ(pipeline.metrics().delivered.load(), 1000u);
+	EXPECT_EQ(pipeline.metrics().dropped(), 0u);
+}
+
+TEST_F(AuditPipelineTest, DeliversInBatches)
+{
+	audit_config config;
+	config.max_batch = 8;
+	audit_pipeline pipeline(config);
+
+	std::mutex gate;
+	std::vector<size_t> batch_sizes;
+	pipeline.set_batch_callback(
+		[&](const std::vector<auth_event>& batch)
+		{
+			std::lock_guard<std::mutex> lock(gate);
+			batch_sizes.push_back(batch.size());
+		});
+
+	{
+		// Hold the sink so events accumulate behind the first batch
+		std::lock_guard<std::mutex> lock(gate);
+		for (int i = 0; i < 100; ++i)
+		{
+			pipeline.publish(make_event(i));
+		}
+	}
+	pipeline.flush();
+
+	size_t total = 0;
+	for (auto size : batch_sizes)
+	{
+		EXPECT_LE(size, 8u);
+		total += size;
+	}
+	EXPECT_EQ(total, 100u);
+	EXPECT_LT(batch_sizes.size(), 100u);
+	EXPECT_EQ(pipeline.metrics().batches.load(), batch_sizes.size());
+}
+
+TEST_F(AuditPipelineTest, DropOldestKeepsNewestEvents)
+{
+	audit_config config;
+	config.queue_capacity = 16;
+	audit_pipeline pipeline(config);
+
+	std::mutex gate;
+	std::vector<int> received;
+	pipeline.set_callback(
+		[&](const auth_event& event)
+		{
+			std::lock_guard<std::mutex> lock(gate);
+			received.push_back(index_of(event));
+		});
+
+	{
+		// The sink stays blocked while the queue overflows
+		std::lock_guard<std::mutex> lock(gate);
+		for (int i = 0; i < 100; ++i)
+		{
+			EXPECT_TRUE(pipeline.publish(make_event(i)));
+		}
+	}
+	pipeline.flush();
+
+	EXPECT_EQ(pipeline.capacity(), 16u);
+	EXPECT_GT(pipeline.metrics().dropped_oldest.load(), 0u);
+	EXPECT_EQ(pipeline.metrics().delivered.load() + pipeline.metrics().dropped_oldest.load(),
+			  100u);
+	ASSERT_FALSE(received.empty());
+	EXPECT_EQ(received.back(), 99);
+}
+
+TEST_F(AuditPipelineTest, SamplePolicyKeepsFractionOfOverflow)
+{
+	audit_config config;
+	config.queue_capacity = 16;
+	config.max_batch = 1;
+	config.overflow = audit_overflow_policy::sample;
+	config.sample_rate = 4;
+	audit_pipeline pipeline(config);
+
+	std::mutex gate;
+	std::atomic<int> received{0};
+	pipeline.set_callback(
+		[&](const auth_event&)
+		{
+			std::lock_guard<std::mutex> lock(gate);
+			++received;
+		});
+
+	size_t accepted = 0;
+	{
+		std::lock_guard<std::mutex> lock(gate);
+		for (int i = 0; i < 1000; ++i)
+		{
+			accepted += pipeline.publish(make_event(i)) ? 1 : 0;
+		}
+	}
+	pipeline.flush();
+
+	const auto& metrics = pipeline.metrics();
+	EXPECT_GT(metrics.dropped_sampled.load(), 0u);
+	EXPECT_EQ(accepted + metrics.dropped_sampled.load(), 1000u);
+	EXPECT_EQ(metrics.published.load(), accepted);
+	EXPECT_EQ(static_cast<uint64_t>(received.load()) + metrics.dropped_oldest.load(), accepted);
+	// Roughly one in four of the overflowing events was kept
+	EXPECT_LT(accepted, 400u);
+}
+
+TEST_F(AuditPipelineTest, ConcurrentPublishersLoseNothingWithRoom)
+{
+	audit_config config;
+	config.queue_capacity = 1 << 16;
+	audit_pipeline pipeline(config);
+
+	std::atomic<int> received{0};
+	pipeline.set_callback([&](const auth_event&) { ++received; });
+
+	std::vector<std::thread> publishers;
+	for (int t = 0; t < 8; ++t)
+	{
+		publishers.emplace_back(
+			[&pipeline, t]
+			{
+				for (int i = 0; i < 2000; ++i)
+				{
+					pipeline.publish(make_event(t * 2000 + i));
+				}
+			});
+	}
+	for (auto& publisher : publishers)
+	{
+		publisher.join();
+	}
+	pipeline.flush();
+
+	EXPECT_EQ(received.load(), 16000);
+	EXPECT_EQ(pipeline.metrics().dropped(), 0u);
+}
+
+TEST_F(AuditPipelineTest, StopDeliversQueuedEvents)
+{
+	std::atomic<int> received{0};
+	{
+		audit_pipeline pipeline;
+		pipeline.set_callback(
+			[&](const auth_event&)
+			{
+				std::this_thread::sleep_for(std::chrono::microseconds(10));
+				++received;
+			});
+		for (int i = 0; i < 200; ++i)
+		{
+			pipeline.publish(make_event(i));
+		}
+	}
+	EXPECT_EQ(received.load(), 200);
+}
+
+TEST_F(AuditPipelineTest, SlowSinkDoesNotBlockAuthentication)
+{
+	auth_config auth_cfg;
+	rate_limit_config rate_cfg;
+	rate_cfg.enabled = false;
+	auth_middleware middleware(auth_cfg, rate_cfg);
+
+	std::mutex gate;
+	std::atomic<int> received{0};
+	middleware.set_audit_callback(
+		[&](const auth_event&)
+		{
+			std::lock_guard<std::mutex> lock(gate);
+			++received;
+		});
+
+	auth_token token;
+	token.token = "valid-token";
+	token.client_id = "client1";
+	{
+		// The sink cannot make progress while the gate is held
+		std::lock_guard<std::mutex> lock(gate);
+		for (int i = 0; i < 10; ++i)
+		{
+			EXPECT_TRUE(middleware.authenticate("session1", token).success);
+		}
+	}
+	middleware.flush_audit_events();
+
+	ASSERT_NE(middleware.get_audit_pipeline(), nullptr);
+	EXPECT_EQ(received.load(), 10);
+}
+
+TEST_F(AuditPipelineTest, SynchronousDeliveryWhenDisabled)
+{
+	auth_config auth_cfg;
+	auth_cfg.audit.asynchronous = false;
+	rate_limit_config rate_cfg;
+	auth_middleware middleware(auth_cfg, rate_cfg);
+
+	std::vector<size_t> batch_sizes;
+	middleware.set_audit_batch_callback([&](const std::vector<auth_event>& batch)
+										{ batch_sizes.push_back(batch.size()); });
+
+	middleware.on_session_created("session1", "client1");
+	middleware.on_session_destroyed("session1");
+
+	EXPECT_EQ(middleware.get_audit_pipeline(), nullptr);
+	EXPECT_EQ(batch_sizes, (std::vector<size_t>{1, 1}));
+}
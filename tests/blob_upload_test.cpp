@@ -0,0 +1,354 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file blob_upload_test.cpp
+ * @brief Unit tests for chunked binary uploads
+ *
+ * Tests cover:
+ * - spill_buffer in memory and after spilling to disk
+ * - Chunking-independent content digest
+ * - Upload offsets, completion and limits
+ * - Resolving blob_ref parameters and session cleanup
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <kcenon/database_server/gateway/blob_upload.h>
+#include <kcenon/database_server/gateway/query_cache.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+std::vector<uint8_t> make_bytes(size_t size, uint8_t seed = 0)
+{
+	std::vector<uint8_t> bytes(size);
+	std::iota(bytes.begin(), bytes.end(), seed);
+	return bytes;
+}
+
+blob_chunk make_chunk(const std::string& id, uint64_t offset, std::vector<uint8_t> data,
+					  bool last = false)
+{
+	blob_chunk chunk;
+	chunk.upload_id = id;
+	chunk.offset = offset;
+	chunk.data = std::move(data);
+	chunk.last = last;
+	return chunk;
+}
+
+} // namespace
+
+// ============================================================================
+// spill_buffer Tests
+// ============================================================================
+
+TEST(SpillBufferTest, SmallContentStaysInMemory)
+{
+	spill_buffer buffer(1024);
+	auto bytes = make_bytes(100);
+
+	ASSERT_TRUE(buffer.append(bytes.data(), bytes.size()).is_ok());
+
+	EXPECT_FALSE(buffer.is_spilled());
+	EXPECT_EQ(buffer.size(), 100u);
+	EXPECT_EQ(buffer.memory_bytes(), 100u);
+	auto content = buffer.read_all();
+	ASSERT_TRUE(content.is_ok());
+	EXPECT_EQ(content.value(), bytes);
+}
+
+TEST(SpillBufferTest, SpillsPastMemoryLimit)
+{
+	spill_buffer buffer(1024);
+	auto first = make_bytes(1000, 1);
+	auto second = make_bytes(1000, 7);
+
+	ASSERT_TRUE(buffer.append(first.data(), first.size()).is_ok());
+	ASSERT_TRUE(buffer.append(second.data(), second.size()).is_ok());
+
+	EXPECT_TRUE(buffer.is_spilled());
+	EXPECT_EQ(buffer.memory_bytes(), 0u);
+	EXPECT_EQ(buffer.size(), 2000u);
+
+	auto expected = first;
+	expected.insert(expected.end(), second.begin(), second.end());
+	auto content = buffer.read_all();
+	ASSERT_TRUE(content.is_ok());
+	EXPECT_EQ(content.value(), expected);
+}
+
+TEST(SpillBufferTest, ReadsRangesFromDisk)
+{
+	spill_buffer buffer(0);
+	auto bytes = make_bytes(500);
+	ASSERT_TRUE(buffer.append(bytes.data(), bytes.size()).is_ok());
+	ASSERT_TRUE(buffer.is_spilled());
+
+	std::vector<uint8_t> out(64);
+	auto read = buffer.read(490, out.data(), out.size());
+	ASSERT_TRUE(read.is_ok());
+	ASSERT_EQ(read.value(), 10u);
+	EXPECT_TRUE(std::equal(out.begin(), out.begin() + 10, bytes.begin() + 490));
+
+	auto past_end = buffer.read(500, out.data(), out.size());
+	ASSERT_TRUE(past_end.is_ok());
+	EXPECT_EQ(past_end.value(), 0u);
+}
+
+TEST(SpillBufferTest, DigestIgnoresChunkBoundaries)
+{
+	auto bytes = make_bytes(1001);
+
+	spill_buffer whole(4096);
+	ASSERT_TRUE(whole.append(bytes.data(), bytes.size()).is_ok());
+
+	spill_buffer pieces(16);
+	for (size_t offset = 0; offset < bytes.size(); offset += 13)
+	{
+		size_t size = std::min<size_t>(13, bytes.size() - offset);
+		ASSERT_TRUE(pieces.append(bytes.data() + offset, size).is_ok());
+	}
+
+	EXPECT_EQ(whole.digest(), pieces.digest());
+
+	spill_buffer other(4096);
+	bytes[500] ^= 0x01;
+	ASSERT_TRUE(other.append(bytes.data(), bytes.size()).is_ok());
+	EXPECT_NE(whole.digest(), other.digest());
+}
+
+TEST(SpillBufferTest, DigestCoversLength)
+{
+	std::vector<uint8_t> zeros(8, 0);
+	spill_buffer empty(64);
+	spill_buffer padded(64);
+	ASSERT_TRUE(padded.append(zeros.data(), zeros.size()).is_ok());
+
+	EXPECT_NE(empty.digest(), padded.digest());
+}
+
+// ============================================================================
+// blob_upload_store Tests
+// ============================================================================
+
+TEST(BlobUploadStoreTest, AppendsChunksInOrder)
+{
+	blob_upload_store store;
+
+	auto first = store.append("s1", make_chunk("photo", 0, make_bytes(100)));
+	ASSERT_TRUE(first.is_ok());
+	EXPECT_EQ(first.value(), 100u);
+
+	auto second = store.append("s1", make_chunk("photo", 100, make_bytes(50), true));
+	ASSERT_TRUE(second.is_ok());
+	EXPECT_EQ(second.value(), 150u);
+
+	EXPECT_EQ(store.upload_count(), 1u);
+	EXPECT_EQ(store.metrics().chunks_received.load(), 2u);
+	EXPECT_EQ(store.metrics().bytes_received.load(), 150u);
+	EXPECT_EQ(store.metrics().uploads_completed.load(), 1u);
+}
+
+TEST(BlobUploadStoreTest, RejectsOffsetMismatch)
+{
+	blob_upload_store store;
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 0, make_bytes(100))).is_ok());
+
+	EXPECT_TRUE(store.append("s1", make_chunk("photo", 50, make_bytes(10))).is_err());
+	EXPECT_TRUE(store.append("s1", make_chunk("missing", 10, make_bytes(10))).is_err());
+
+	// The upload itself is unaffected and can continue
+	auto resumed = store.append("s1", make_chunk("photo", 100, make_bytes(10)));
+	ASSERT_TRUE(resumed.is_ok());
+	EXPECT_EQ(resumed.value(), 110u);
+}
+
+TEST(BlobUploadStoreTest, RejectsChunksAfterCompletion)
+{
+	blob_upload_store store;
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 0, make_bytes(10), true)).is_ok());
+
+	EXPECT_TRUE(store.append("s1", make_chunk("photo", 10, make_bytes(10))).is_err());
+}
+
+TEST(BlobUploadStoreTest, DropsUploadOverSizeLimit)
+{
+	blob_upload_config config;
+	config.max_upload_bytes = 100;
+	blob_upload_store store(config);
+
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 0, make_bytes(80))).is_ok());
+	EXPECT_TRUE(store.append("s1", make_chunk("photo", 80, make_bytes(30))).is_err());
+
+	EXPECT_EQ(store.upload_count(), 0u);
+	EXPECT_EQ(store.memory_bytes(), 0u);
+	EXPECT_EQ(store.metrics().uploads_rejected.load(), 1u);
+}
+
+TEST(BlobUploadStoreTest, LimitsUploadsPerSession)
+{
+	blob_upload_config config;
+	config.max_uploads_per_session = 2;
+	blob_upload_store store(config);
+
+	ASSERT_TRUE(store.append("s1", make_chunk("a", 0, make_bytes(1))).is_ok());
+	ASSERT_TRUE(store.append("s1", make_chunk("b", 0, make_bytes(1))).is_ok());
+	EXPECT_TRUE(store.append("s1", make_chunk("c", 0, make_bytes(1))).is_err());
+
+	// Other sessions have their own allowance
+	EXPECT_TRUE(store.append("s2", make_chunk("c", 0, make_bytes(1))).is_ok());
+}
+
+TEST(BlobUploadStoreTest, SpillsWhenSharedMemoryBudgetIsExhausted)
+{
+	blob_upload_config config;
+	config.memory_threshold_bytes = 1024;
+	config.max_memory_bytes = 1500;
+	blob_upload_store store(config);
+
+	ASSERT_TRUE(store.append("s1", make_chunk("a", 0, make_bytes(1000))).is_ok());
+	EXPECT_EQ(store.memory_bytes(), 1000u);
+
+	// Fits the upload's own threshold but not the shared budget
+	ASSERT_TRUE(store.append("s2", make_chunk("b", 0, make_bytes(1000))).is_ok());
+	EXPECT_EQ(store.memory_bytes(), 1000u);
+	EXPECT_EQ(store.metrics().uploads_spilled.load(), 1u);
+
+	// Exceeds the upload's threshold
+	ASSERT_TRUE(store.append("s1", make_chunk("a", 1000, make_bytes(100))).is_ok());
+	EXPECT_EQ(store.memory_bytes(), 0u);
+	EXPECT_EQ(store.metrics().uploads_spilled.load(), 2u);
+}
+
+TEST(BlobUploadStoreTest, TakeRequiresCompleteUpload)
+{
+	blob_upload_store store;
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 0, make_bytes(10))).is_ok());
+
+	EXPECT_TRUE(store.take("s1", "photo").is_err());
+	EXPECT_TRUE(store.take("s2", "photo").is_err());
+
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 10, make_bytes(10, 10), true)).is_ok());
+	auto content = store.take("s1", "photo");
+	ASSERT_TRUE(content.is_ok());
+	EXPECT_EQ(content.value()->size(), 20u);
+	EXPECT_EQ(store.upload_count(), 0u);
+	EXPECT_EQ(store.memory_bytes(), 0u);
+
+	// Consumed
+	EXPECT_TRUE(store.take("s1", "photo").is_err());
+}
+
+TEST(BlobUploadStoreTest, ResolvesBlobReferences)
+{
+	blob_upload_store store;
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 0, make_bytes(300), true)).is_ok());
+
+	query_request request("INSERT INTO photos VALUES (?, ?, ?)", query_type::insert);
+	request.params.emplace_back("id", int64_t{1});
+	request.params.emplace_back("data", blob_ref{ "photo", nullptr });
+	request.params.emplace_back("copy", blob_ref{ "photo", nullptr });
+
+	ASSERT_TRUE(store.resolve("s1", request).is_ok());
+
+	const auto& data = std::get<blob_ref>(request.params[1].value);
+	const auto& copy = std::get<blob_ref>(request.params[2].value);
+	ASSERT_NE(data.content, nullptr);
+	EXPECT_EQ(data.content, copy.content);
+	auto bytes = data.content->read_all();
+	ASSERT_TRUE(bytes.is_ok());
+	EXPECT_EQ(bytes.value(), make_bytes(300));
+}
+
+TEST(BlobUploadStoreTest, ResolveFailsForUnknownUpload)
+{
+	blob_upload_store store;
+
+	query_request request("INSERT INTO photos VALUES (?)", query_type::insert);
+	request.params.emplace_back("data", blob_ref{ "photo", nullptr });
+
+	EXPECT_TRUE(store.resolve("s1", request).is_err());
+}
+
+TEST(BlobUploadStoreTest, UploadsAreScopedToSession)
+{
+	blob_upload_store store;
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 0, make_bytes(10), true)).is_ok());
+	ASSERT_TRUE(store.append("s2", make_chunk("photo", 0, make_bytes(20))).is_ok());
+
+	store.remove_session("s1");
+
+	EXPECT_EQ(store.upload_count(), 1u);
+	EXPECT_EQ(store.memory_bytes(), 20u);
+	EXPECT_TRUE(store.take("s1", "photo").is_err());
+}
+
+// ============================================================================
+// Cache Key Tests
+// ============================================================================
+
+TEST(BlobUploadStoreTest, CacheKeyFollowsResolvedContent)
+{
+	blob_upload_store store;
+	auto bytes = make_bytes(64);
+	ASSERT_TRUE(store.append("s1", make_chunk("a", 0, bytes, true)).is_ok());
+	ASSERT_TRUE(store.append(
+		"s2", make_chunk("b", 0, std::vector<uint8_t>(bytes.begin(), bytes.begin() + 20))).is_ok());
+	ASSERT_TRUE(store.append(
+		"s2", make_chunk("b", 20, std::vector<uint8_t>(bytes.begin() + 20, bytes.end()), true))
+					.is_ok());
+	ASSERT_TRUE(store.append("s2", make_chunk("c", 0, make_bytes(64, 1), true)).is_ok());
+
+	query_request first("SELECT * FROM files WHERE data = ?", query_type::select);
+	first.params.emplace_back("data", blob_ref{ "a", nullptr });
+	ASSERT_TRUE(store.resolve("s1", first).is_ok());
+
+	// Same bytes under another id, uploaded in different chunks
+	query_request second("SELECT * FROM files WHERE data = ?", query_type::select);
+	second.params.emplace_back("data", blob_ref{ "b", nullptr });
+	ASSERT_TRUE(store.resolve("s2", second).is_ok());
+
+	query_request third("SELECT * FROM files WHERE data = ?", query_type::select);
+	third.params.emplace_back("data", blob_ref{ "c", nullptr });
+	ASSERT_TRUE(store.resolve("s2", third).is_ok());
+
+	EXPECT_EQ(query_cache::make_key(first), query_cache::make_key(second));
+	EXPECT_NE(query_cache::make_key(first), query_cache::make_key(third));
+}
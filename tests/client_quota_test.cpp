@@ -0,0 +1,292 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file client_quota_test.cpp
+ * @brief Unit tests for per-client concurrency quotas
+ *
+ * Tests cover:
+ * - Granting slots up to the per-client limit and rejecting beyond it
+ * - Independence of clients and of query and connection quotas
+ * - Queueing over-quota requests until a slot is released or the wait expires
+ * - Usage and rejection reporting per client
+ * - Untracked (disabled or anonymous) acquisitions
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <kcenon/database_server/gateway/client_quota.h>
+
+using namespace database_server::gateway;
+using namespace std::chrono_literals;
+
+class ClientQuotaTest : public ::testing::Test
+{
+protected:
+	client_quota_config make_config(uint32_t queries, uint32_t connections,
+									uint32_t queue_timeout_ms = 0)
+	{
+		client_quota_config config;
+		config.enabled = true;
+		config.max_in_flight_queries = queries;
+		config.max_held_connections = connections;
+		config.queue_timeout_ms = queue_timeout_ms;
+		return config;
+	}
+};
+
+TEST_F(ClientQuotaTest, RejectsQueriesBeyondLimit)
+{
+	client_quota_manager quotas(make_config(2, 0));
+
+	auto first = quotas.acquire("heavy", quota_kind::query);
+	auto second = quotas.acquire("heavy", quota_kind::query);
+	auto third = quotas.acquire("heavy", quota_kind::query);
+
+	EXPECT_TRUE(first);
+	EXPECT_TRUE(second);
+	EXPECT_FALSE(third);
+
+	auto usage = quotas.usage("heavy");
+	ASSERT_TRUE(usage.has_value());
+	EXPECT_EQ(usage->in_flight_queries, 2u);
+	EXPECT_EQ(usage->admitted, 2u);
+	EXPECT_EQ(usage->rejected_queries, 1u);
+	EXPECT_EQ(usage->rejected_connections, 0u);
+}
+
+TEST_F(ClientQuotaTest, ReleasingSlotAdmitsNextQuery)
+{
+	client_quota_manager quotas(make_config(1, 0));
+
+	{
+		auto slot = quotas.acquire("heavy", quota_kind::query);
+		ASSERT_TRUE(slot);
+		EXPECT_FALSE(quotas.acquire("heavy", quota_kind::query));
+	}
+
+	EXPECT_TRUE(quotas.acquire("heavy", quota_kind::query));
+	EXPECT_EQ(quotas.usage("heavy")->in_flight_queries, 0u);
+}
+
+TEST_F(ClientQuotaTest, ClientsHaveIndependentQuotas)
+{
+	client_quota_manager quotas(make_config(1, 0));
+
+	auto heavy = quotas.acquire("heavy", quota_kind::query);
+	auto light = quotas.acquire("light", quota_kind::query);
+
+	EXPECT_TRUE(heavy);
+	EXPECT_TRUE(light);
+	EXPECT_FALSE(quotas.acquire("heavy", quota_kind::query));
+	EXPECT_EQ(quotas.usage("light")->rejected_queries, 0u);
+}
+
+TEST_F(ClientQuotaTest, ConnectionQuotaIsSeparateFromQueryQuota)
+{
+	client_quota_manager quotas(make_config(4, 1));
+
+	auto query = quotas.acquire("heavy", quota_kind::query);
+	auto connection = quotas.acquire("heavy", quota_kind::connection);
+	auto second_query = quotas.acquire("heavy", quota_kind::query);
+
+	EXPECT_TRUE(query);
+	EXPECT_TRUE(connection);
+	EXPECT_TRUE(second_query);
+	EXPECT_FALSE(quotas.acquire("heavy", quota_kind::connection));
+
+	auto usage = quotas.usage("heavy");
+	EXPECT_EQ(usage->in_flight_queries, 2u);
+	EXPECT_EQ(usage->held_connections, 1u);
+	EXPECT_EQ(usage->rejected_connections, 1u);
+	EXPECT_EQ(usage->rejected_queries, 0u);
+}
+
+TEST_F(ClientQuotaTest, ZeroLimitIsUnlimitedButTracked)
+{
+	client_quota_manager quotas(make_config(0, 0));
+
+	std::vector<client_quota_manager::slot> slots;
+	for (int i = 0; i < 100; ++i)
+	{
+		slots.push_back(quotas.acquire("heavy", quota_kind::query));
+		ASSERT_TRUE(slots.back());
+	}
+	EXPECT_EQ(quotas.usage("heavy")->in_flight_queries, 100u);
+}
+
+TEST_F(ClientQuotaTest, DisabledOrAnonymousIsNotTracked)
+{
+	client_quota_manager disabled(client_quota_config{});
+	EXPECT_TRUE(disabled.acquire("heavy", quota_kind::query));
+	EXPECT_EQ(disabled.size(), 0u);
+
+	client_quota_manager quotas(make_config(1, 1));
+	auto first = quotas.acquire("", quota_kind::query);
+	auto second = quotas.acquire("", quota_kind::query);
+	EXPECT_TRUE(first);
+	EXPECT_TRUE(second);
+	EXPECT_EQ(quotas.size(), 0u);
+}
+
+TEST_F(ClientQuotaTest, QueuedRequestAdmittedWhenSlotReleased)
+{
+	client_quota_manager quotas(make_config(1, 0, 5000));
+
+	auto held = quotas.acquire("heavy", quota_kind::query);
+	ASSERT_TRUE(held);
+
+	std::thread releaser(
+		[&]
+		{
+			while (quotas.usage("heavy")->queued == 0)
+			{
+				std::this_thread::sleep_for(1ms);
+			}
+			held.release();
+		});
+
+	auto waited = quotas.acquire("heavy", quota_kind::query);
+	releaser.join();
+
+	EXPECT_TRUE(waited);
+	auto usage = quotas.usage("heavy");
+	EXPECT_EQ(usage->delayed, 1u);
+	EXPECT_EQ(usage->queued, 0u);
+	EXPECT_EQ(usage->in_flight_queries, 1u);
+	EXPECT_EQ(usage->rejected_queries, 0u);
+}
+
+TEST_F(ClientQuotaTest, QueuedRequestRejectedAfterTimeout)
+{
+	client_quota_manager quotas(make_config(1, 0, 20));
+
+	auto held = quotas.acquire("heavy", quota_kind::query);
+	auto started = std::chrono::steady_clock::now();
+	auto waited = quotas.acquire("heavy", quota_kind::query);
+
+	EXPECT_FALSE(waited);
+	EXPECT_GE(std::chrono::steady_clock::now() - started, 20ms);
+	auto usage = quotas.usage("heavy");
+	EXPECT_EQ(usage->delayed, 1u);
+	EXPECT_EQ(usage->rejected_queries, 1u);
+}
+
+TEST_F(ClientQuotaTest, RejectsAtOnceWhenQueueIsFull)
+{
+	auto config = make_config(1, 0, 5000);
+	config.max_queued = 0;
+	client_quota_manager quotas(config);
+
+	auto held = quotas.acquire("heavy", quota_kind::query);
+	auto started = std::chrono::steady_clock::now();
+	EXPECT_FALSE(quotas.acquire("heavy", quota_kind::query));
+	EXPECT_LT(std::chrono::steady_clock::now() - started, 1s);
+	EXPECT_EQ(quotas.usage("heavy")->delayed, 0u);
+}
+
+TEST_F(ClientQuotaTest, MovedSlotReleasesOnce)
+{
+	client_quota_manager quotas(make_config(1, 0));
+
+	auto slot = quotas.acquire("heavy", quota_kind::query);
+	client_quota_manager::slot moved = std::move(slot);
+	EXPECT_FALSE(slot);
+	EXPECT_TRUE(moved);
+
+	slot.release();
+	EXPECT_EQ(quotas.usage("heavy")->in_flight_queries, 1u);
+	moved.release();
+	moved.release();
+	EXPECT_EQ(quotas.usage("heavy")->in_flight_queries, 0u);
+}
+
+TEST_F(ClientQuotaTest, ReportsUsageForEveryClient)
+{
+	client_quota_manager quotas(make_config(1, 0));
+
+	auto a = quotas.acquire("a", quota_kind::query);
+	auto b = quotas.acquire("b", quota_kind::query);
+	(void)quotas.acquire("b", quota_kind::query);
+
+	auto usage = quotas.usage();
+	ASSERT_EQ(usage.size(), 2u);
+	for (const auto& client : usage)
+	{
+		EXPECT_EQ(client.in_flight_queries, 1u);
+		EXPECT_EQ(client.rejected_queries, client.client_id == "b" ? 1u : 0u);
+	}
+	EXPECT_FALSE(quotas.usage("c").has_value());
+}
+
+TEST_F(ClientQuotaTest, ConcurrentClientsNeverExceedLimit)
+{
+	constexpr uint32_t limit = 3;
+	client_quota_manager quotas(make_config(limit, 0, 1000));
+
+	std::atomic<uint32_t> running{0};
+	std::atomic<uint32_t> peak{0};
+	std::vector<std::thread> workers;
+	for (int t = 0; t < 8; ++t)
+	{
+		workers.emplace_back(
+			[&]
+			{
+				for (int i = 0; i < 50; ++i)
+				{
+					auto slot = quotas.acquire("heavy", quota_kind::query);
+					if (!slot)
+					{
+						continue;
+					}
+					auto now = running.fetch_add(1) + 1;
+					auto seen = peak.load();
+					while (now > seen && !peak.compare_exchange_weak(seen, now))
+					{
+					}
+					std::this_thread::yield();
+					running.fetch_sub(1);
+				}
+			});
+	}
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	EXPECT_LE(peak.load(), limit);
+	EXPECT_EQ(quotas.usage("heavy")->in_flight_queries, 0u);
+}
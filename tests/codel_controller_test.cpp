@@ -0,0 +1,194 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file codel_controller_test.cpp
+ * @brief Unit tests for queue-delay-based load shedding
+ *
+ * Tests cover:
+ * - Entering overload only after a full interval above the target
+ * - Short bursts that do not trigger shedding
+ * - Leaving overload on a short wait or an idle interval
+ * - Which request types may be shed
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#include <kcenon/database_server/gateway/codel_controller.h>
+
+using namespace database_server::gateway;
+using namespace std::chrono_literals;
+
+class CodelControllerTest : public ::testing::Test
+{
+protected:
+	codel_config make_config()
+	{
+		codel_config config;
+		config.target_delay_us = 5000;
+		config.interval_us = 100000;
+		return config;
+	}
+
+	// Record one wait per millisecond from start until start + span
+	void record_for(codel_controller& controller, std::chrono::microseconds sojourn,
+					codel_controller::clock::time_point start,
+					std::chrono::milliseconds span)
+	{
+		for (auto t = 0ms; t <= span; t += 1ms)
+		{
+			controller.record(sojourn, start + t);
+		}
+	}
+
+	codel_controller::clock::time_point t0_ = codel_controller::clock::now();
+};
+
+TEST_F(CodelControllerTest, AdmitsEverythingWithoutSamples)
+{
+	codel_controller controller(make_config());
+
+	EXPECT_FALSE(controller.is_overloaded());
+	EXPECT_FALSE(controller.should_shed(true, t0_));
+	EXPECT_EQ(controller.metrics().shed.load(), 0u);
+}
+
+TEST_F(CodelControllerTest, ShedsAfterIntervalAboveTarget)
+{
+	codel_controller controller(make_config());
+
+	record_for(controller, 20ms, t0_, 99ms);
+	EXPECT_FALSE(controller.is_overloaded());
+	EXPECT_FALSE(controller.should_shed(true, t0_ + 99ms));
+
+	// The first interval closes with the next sample
+	controller.record(20ms, t0_ + 100ms);
+	EXPECT_TRUE(controller.is_overloaded());
+	EXPECT_TRUE(controller.should_shed(true, t0_ + 102ms));
+	EXPECT_EQ(controller.metrics().shed.load(), 1u);
+	EXPECT_EQ(controller.metrics().overload_episodes.load(), 1u);
+}
+
+TEST_F(CodelControllerTest, NeverShedsProtectedWork)
+{
+	codel_controller controller(make_config());
+
+	record_for(controller, 20ms, t0_, 101ms);
+
+	ASSERT_TRUE(controller.is_overloaded());
+	EXPECT_FALSE(controller.should_shed(false, t0_ + 102ms));
+	EXPECT_EQ(controller.metrics().shed.load(), 0u);
+}
+
+TEST_F(CodelControllerTest, AbsorbsShortBursts)
+{
+	codel_controller controller(make_config());
+
+	// A burst queues briefly, then the queue drains within the interval
+	record_for(controller, 20ms, t0_, 50ms);
+	controller.record(1ms, t0_ + 60ms);
+	record_for(controller, 20ms, t0_ + 70ms, 40ms);
+
+	EXPECT_FALSE(controller.is_overloaded());
+	EXPECT_FALSE(controller.should_shed(true, t0_ + 111ms));
+}
+
+TEST_F(CodelControllerTest, ShortWaitEndsOverload)
+{
+	codel_controller controller(make_config());
+
+	record_for(controller, 20ms, t0_, 101ms);
+	ASSERT_TRUE(controller.is_overloaded());
+
+	controller.record(1ms, t0_ + 102ms);
+	EXPECT_FALSE(controller.is_overloaded());
+	EXPECT_FALSE(controller.should_shed(true, t0_ + 103ms));
+}
+
+TEST_F(CodelControllerTest, IdleIntervalEndsOverload)
+{
+	codel_controller controller(make_config());
+
+	record_for(controller, 20ms, t0_, 101ms);
+	ASSERT_TRUE(controller.is_overloaded());
+
+	// Still shedding within the interval that saw the standing queue
+	EXPECT_TRUE(controller.should_shed(true, t0_ + 150ms));
+
+	// No wait recorded for a whole interval: nothing is queued any more
+	EXPECT_TRUE(controller.should_shed(true, t0_ + 202ms));
+	EXPECT_FALSE(controller.should_shed(true, t0_ + 303ms));
+	EXPECT_FALSE(controller.is_overloaded());
+}
+
+TEST_F(CodelControllerTest, CountsOverloadEpisodes)
+{
+	codel_controller controller(make_config());
+
+	record_for(controller, 20ms, t0_, 101ms);
+	controller.record(1ms, t0_ + 102ms);
+	record_for(controller, 20ms, t0_ + 300ms, 101ms);
+	record_for(controller, 20ms, t0_ + 402ms, 101ms);
+
+	EXPECT_TRUE(controller.is_overloaded());
+	EXPECT_EQ(controller.metrics().overload_episodes.load(), 2u);
+	EXPECT_GT(controller.metrics().samples.load(), 0u);
+}
+
+TEST_F(CodelControllerTest, DisabledControllerNeverSheds)
+{
+	auto config = make_config();
+	config.enabled = false;
+	codel_controller controller(config);
+
+	record_for(controller, 20ms, t0_, 201ms);
+
+	EXPECT_FALSE(controller.is_overloaded());
+	EXPECT_FALSE(controller.should_shed(true, t0_ + 202ms));
+	EXPECT_EQ(controller.metrics().samples.load(), 0u);
+}
+
+TEST(CodelSheddableTest, ShedsReadsAndSessionWorkOnly)
+{
+	EXPECT_TRUE(is_sheddable(query_type::select));
+	EXPECT_TRUE(is_sheddable(query_type::subscribe));
+	EXPECT_TRUE(is_sheddable(query_type::upload_chunk));
+
+	EXPECT_FALSE(is_sheddable(query_type::insert));
+	EXPECT_FALSE(is_sheddable(query_type::update));
+	EXPECT_FALSE(is_sheddable(query_type::del));
+	EXPECT_FALSE(is_sheddable(query_type::execute));
+	EXPECT_FALSE(is_sheddable(query_type::batch));
+	EXPECT_FALSE(is_sheddable(query_type::ping));
+	EXPECT_FALSE(is_sheddable(query_type::unsubscribe));
+}
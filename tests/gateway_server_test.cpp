@@ -0,0 +1,743 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file gateway_server_test.cpp
+ * @brief Request processing tests for the gateway server
+ *
+ * Clients talk wire v2 over the Unix socket transport. Tests cover:
+ * - Requests handed off the transport thread to the executor
+ * - Per-session ordering and the queued-bytes limit
+ * - Dispatch admission fed by the wait for an executor worker
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kcenon/database_server/gateway/gateway_server.h>
+#include <kcenon/database_server/gateway/wire_format.h>
+
+#include <kcenon/thread/adapters/common_executor_adapter.h>
+#include <kcenon/thread/core/thread_pool.h>
+
+#if !defined(_WIN32)
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+std::string make_socket_path()
+{
+	static std::atomic<int> counter{0};
+	return "/tmp/dbgw_server_test_" + std::to_string(::getpid()) + "_"
+		   + std::to_string(counter.fetch_add(1)) + ".sock";
+}
+
+std::shared_ptr<kcenon::common::interfaces::IExecutor> make_executor(size_t workers)
+{
+	auto pool = std::make_shared<kcenon::thread::thread_pool>("gateway_test", workers);
+	pool->start();
+	return kcenon::thread::adapters::common_executor_factory::create_from_thread_pool(pool);
+}
+
+/**
+ * @brief Blocking wire v2 client on the gateway's Unix socket
+ */
+class test_client
+{
+public:
+	explicit test_client(const std::string& path)
+	{
+		fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		struct sockaddr_un address{};
+		address.sun_family = AF_UNIX;
+		std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+		if (::connect(fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+		{
+			::close(fd_);
+			fd_ = -1;
+			return;
+		}
+
+		// A missing reply fails the test instead of hanging it
+		struct timeval timeout{};
+		timeout.tv_sec = 5;
+		::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	}
+
+	~test_client()
+	{
+		if (fd_ >= 0)
+		{
+			::close(fd_);
+		}
+	}
+
+	test_client(const test_client&) = delete;
+	test_client& operator=(const test_client&) = delete;
+
+	[[nodiscard]] bool connected() const { return fd_ >= 0; }
+
+	bool send(const query_request& request) { return send_payload(encode_wire_v2(request)); }
+
+	bool send_payload(const std::vector<uint8_t>& payload)
+	{
+		auto length = static_cast<uint32_t>(payload.size());
+		std::vector<uint8_t> bytes = {static_cast<uint8_t>(length >> 24),
+									  static_cast<uint8_t>(length >> 16),
+									  static_cast<uint8_t>(length >> 8),
+									  static_cast<uint8_t>(length)};
+		bytes.insert(bytes.end(), payload.begin(), payload.end());
+		return write_all(bytes);
+	}
+
+	std::optional<query_response> receive()
+	{
+		auto payload = receive_payload();
+		if (!payload)
+		{
+			return std::nullopt;
+		}
+		auto response = decode_response_v2(*payload);
+		if (response.is_err())
+		{
+			return std::nullopt;
+		}
+		return std::move(response.value());
+	}
+
+	std::optional<invalidation_event> receive_event()
+	{
+		auto payload = receive_payload();
+		if (!payload)
+		{
+			return std::nullopt;
+		}
+		auto event = decode_event_v2(*payload);
+		if (event.is_err())
+		{
+			return std::nullopt;
+		}
+		return std::move(event.value());
+	}
+
+	std::optional<std::vector<query_response>> receive_batch()
+	{
+		auto payload = receive_payload();
+		if (!payload)
+		{
+			return std::nullopt;
+		}
+		auto responses = decode_response_batch_v2(*payload);
+		if (responses.is_err())
+		{
+			return std::nullopt;
+		}
+		return std::move(responses.value());
+	}
+
+	/// True once the server has closed the connection
+	bool closed_by_server()
+	{
+		uint8_t byte;
+		while (true)
+		{
+			auto received = ::recv(fd_, &byte, 1, 0);
+			if (received == 0)
+			{
+				return true;
+			}
+			if (received < 0)
+			{
+				return errno == ECONNRESET;
+			}
+		}
+	}
+
+private:
+	std::optional<std::vector<uint8_t>> receive_payload()
+	{
+		uint8_t header[4];
+		if (!read_exact(header, 4))
+		{
+			return std::nullopt;
+		}
+		uint32_t length = (uint32_t{header[0]} << 24) | (uint32_t{header[1]} << 16)
+						  | (uint32_t{header[2]} << 8) | uint32_t{header[3]};
+		std::vector<uint8_t> payload(length);
+		if (!read_exact(payload.data(), length))
+		{
+			return std::nullopt;
+		}
+		return payload;
+	}
+
+	bool write_all(const std::vector<uint8_t>& bytes)
+	{
+		size_t offset = 0;
+		while (offset < bytes.size())
+		{
+			auto written = ::send(fd_, bytes.data() + offset, bytes.size() - offset, MSG_NOSIGNAL);
+			if (written <= 0)
+			{
+				return false;
+			}
+			offset += static_cast<size_t>(written);
+		}
+		return true;
+	}
+
+	bool read_exact(uint8_t* out, size_t size)
+	{
+		size_t offset = 0;
+		while (offset < size)
+		{
+			auto received = ::recv(fd_, out + offset, size - offset, 0);
+			if (received <= 0)
+			{
+				return false;
+			}
+			offset += static_cast<size_t>(received);
+		}
+		return true;
+	}
+
+	int fd_ = -1;
+};
+
+query_request make_request(uint64_t message_id, const std::string& sql)
+{
+	query_request request(sql, query_type::select);
+	request.header.message_id = message_id;
+	return request;
+}
+
+/// Accepts every token once the test opens the gate, recording its threads
+class gated_validator : public auth_validator
+{
+public:
+	explicit gated_validator(std::shared_future<void> gate) : gate_(std::move(gate)) {}
+
+	auth_result validate(const auth_token& token) override
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			threads.push_back(std::this_thread::get_id());
+		}
+		gate_.wait();
+
+		auth_result result;
+		result.success = true;
+		result.client_id = token.client_id;
+		return result;
+	}
+
+	std::mutex mutex;
+	std::vector<std::thread::id> threads;
+
+private:
+	std::shared_future<void> gate_;
+};
+
+} // namespace
+
+// ============================================================================
+// Gateway Server Tests
+// ============================================================================
+
+class GatewayServerTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		config_.port = 0;
+		config_.require_auth = false;
+		config_.unix_socket_path = make_socket_path();
+	}
+
+	void TearDown() override
+	{
+		release();
+		if (server_ && server_->is_running())
+		{
+			(void)server_->stop();
+		}
+		::unlink(config_.unix_socket_path.c_str());
+	}
+
+	/// False (with skip_reason_ set) when the host cannot bind the transports
+	bool start_server(std::shared_ptr<kcenon::common::interfaces::IExecutor> executor)
+	{
+		server_ = std::make_unique<gateway_server>(config_);
+		server_->set_executor(std::move(executor));
+		if (validator_)
+		{
+			server_->set_token_validator(validator_);
+		}
+		if (auth_executor_)
+		{
+			server_->get_auth_middleware().set_executor(auth_executor_);
+		}
+		server_->set_request_handler(
+			[this](const client_session&, const query_request& request)
+			{
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					handled_.push_back(request.header.message_id);
+					handler_threads_.push_back(std::this_thread::get_id());
+				}
+				if (request.sql == "BLOCK")
+				{
+					blocked_.wait();
+				}
+				if (request.sql == "THROW")
+				{
+					throw std::runtime_error("handler failed");
+				}
+				return query_response(request.header.message_id);
+			});
+
+		auto result = server_->start();
+		if (result.is_err())
+		{
+			skip_reason_ = result.error().message;
+			return false;
+		}
+		return true;
+	}
+
+	/// Lets requests waiting on "BLOCK" finish
+	void release()
+	{
+		if (!released_.exchange(true))
+		{
+			release_.set_value();
+		}
+	}
+
+	gateway_config config_;
+	std::unique_ptr<gateway_server> server_;
+	std::string skip_reason_;
+
+	std::shared_ptr<auth_validator> validator_;
+	std::shared_ptr<kcenon::common::interfaces::IExecutor> auth_executor_;
+
+	std::mutex mutex_;
+	std::vector<uint64_t> handled_;
+	std::vector<std::thread::id> handler_threads_;
+	std::promise<void> release_;
+	std::shared_future<void> blocked_ = release_.get_future().share();
+	std::atomic<bool> released_{false};
+};
+
+TEST_F(GatewayServerTest, SlowRequestDoesNotStallOtherSessions)
+{
+	if (!start_server(make_executor(2)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client slow(config_.unix_socket_path);
+	test_client fast(config_.unix_socket_path);
+	ASSERT_TRUE(slow.connected());
+	ASSERT_TRUE(fast.connected());
+
+	// The transport thread keeps reading while the executor holds "BLOCK"
+	ASSERT_TRUE(slow.send(make_request(1, "BLOCK")));
+	ASSERT_TRUE(fast.send(make_request(2, "SELECT 1")));
+
+	auto reply = fast.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->header.message_id, 2u);
+
+	release();
+	reply = slow.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->header.message_id, 1u);
+}
+
+TEST_F(GatewayServerTest, SessionRequestsAnsweredInOrder)
+{
+	if (!start_server(make_executor(4)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	for (uint64_t id = 1; id <= 50; ++id)
+	{
+		ASSERT_TRUE(client.send(make_request(id, "SELECT " + std::to_string(id))));
+	}
+
+	for (uint64_t id = 1; id <= 50; ++id)
+	{
+		auto reply = client.receive();
+		ASSERT_TRUE(reply.has_value());
+		EXPECT_EQ(reply->header.message_id, id);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ASSERT_EQ(handled_.size(), 50u);
+	for (uint64_t id = 1; id <= 50; ++id)
+	{
+		EXPECT_EQ(handled_[id - 1], id);
+	}
+}
+
+TEST_F(GatewayServerTest, QueuedBytesLimitDisconnectsSession)
+{
+	config_.max_queued_bytes = 4096;
+	if (!start_server(make_executor(1)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	// Everything after "BLOCK" waits in the session's queue
+	ASSERT_TRUE(client.send(make_request(1, "BLOCK")));
+	for (uint64_t id = 2; id <= 64; ++id)
+	{
+		if (!client.send(make_request(id, std::string(256, 'x'))))
+		{
+			break;
+		}
+	}
+
+	EXPECT_TRUE(client.closed_by_server());
+	release();
+}
+
+TEST_F(GatewayServerTest, RunsInlineWithoutExecutor)
+{
+	if (!start_server(nullptr))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	ASSERT_TRUE(client.send(make_request(7, "SELECT 1")));
+	auto reply = client.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->header.message_id, 7u);
+}
+
+TEST_F(GatewayServerTest, DispatchAdmissionSamplesExecutorWait)
+{
+	if (!start_server(make_executor(2)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	ASSERT_TRUE(client.send(make_request(1, "SELECT 1")));
+	ASSERT_TRUE(client.receive().has_value());
+	EXPECT_GE(server_->get_dispatch_admission().metrics().samples.load(), 1u);
+}
+
+TEST_F(GatewayServerTest, DispatchAdmissionIdleWithoutExecutor)
+{
+	// Nothing queues in front of inline processing
+	if (!start_server(nullptr))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	ASSERT_TRUE(client.send(make_request(1, "SELECT 1")));
+	ASSERT_TRUE(client.receive().has_value());
+	EXPECT_EQ(server_->get_dispatch_admission().metrics().samples.load(), 0u);
+}
+
+TEST_F(GatewayServerTest, TokenVerificationRunsOnAuthExecutor)
+{
+	config_.require_auth = true;
+	auto validator = std::make_shared<gated_validator>(blocked_);
+	validator_ = validator;
+	auth_executor_ = make_executor(1);
+	if (!start_server(make_executor(1)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client verifying(config_.unix_socket_path);
+	test_client pinging(config_.unix_socket_path);
+	ASSERT_TRUE(verifying.connected());
+	ASSERT_TRUE(pinging.connected());
+
+	auto request = make_request(1, "SELECT 1");
+	request.token.token = "token";
+	request.token.client_id = "client";
+	ASSERT_TRUE(verifying.send(request));
+
+	// The only gateway worker stays free while the token is being verified
+	query_request ping;
+	ping.type = query_type::ping;
+	ping.header.message_id = 2;
+	ASSERT_TRUE(pinging.send(ping));
+	auto reply = pinging.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->header.message_id, 2u);
+
+	release();
+	reply = verifying.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->header.message_id, 1u);
+	EXPECT_EQ(reply->status, status_code::ok);
+
+	std::lock_guard<std::mutex> validator_lock(validator->mutex);
+	std::lock_guard<std::mutex> lock(mutex_);
+	ASSERT_EQ(validator->threads.size(), 1u);
+	ASSERT_EQ(handler_threads_.size(), 1u);
+	EXPECT_NE(validator->threads[0], handler_threads_[0]);
+}
+
+TEST_F(GatewayServerTest, PendingVerificationKeepsSessionOrder)
+{
+	config_.require_auth = true;
+	auto validator = std::make_shared<gated_validator>(blocked_);
+	validator_ = validator;
+	auth_executor_ = make_executor(1);
+	if (!start_server(make_executor(4)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	// Requests behind the first wait for its verification, not for their own
+	for (uint64_t id = 1; id <= 10; ++id)
+	{
+		auto request = make_request(id, "SELECT " + std::to_string(id));
+		request.token.token = "token";
+		request.token.client_id = "client";
+		ASSERT_TRUE(client.send(request));
+	}
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		EXPECT_TRUE(handled_.empty());
+	}
+	release();
+
+	for (uint64_t id = 1; id <= 10; ++id)
+	{
+		auto reply = client.receive();
+		ASSERT_TRUE(reply.has_value());
+		EXPECT_EQ(reply->header.message_id, id);
+		EXPECT_EQ(reply->status, status_code::ok);
+	}
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ASSERT_EQ(handled_.size(), 10u);
+	for (uint64_t id = 1; id <= 10; ++id)
+	{
+		EXPECT_EQ(handled_[id - 1], id);
+	}
+}
+
+TEST_F(GatewayServerTest, BatchRunsOnExecutorAndIsolatesFailures)
+{
+	// More batch concurrency than workers: the caller drains the batch itself
+	config_.batch_concurrency = 4;
+	if (!start_server(make_executor(1)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	std::vector<query_request> requests;
+	for (uint64_t id = 1; id <= 8; ++id)
+	{
+		requests.push_back(make_request(id, id == 3 ? "THROW" : "SELECT 1"));
+	}
+	ASSERT_TRUE(client.send_payload(encode_request_batch_v2(requests)));
+
+	auto replies = client.receive_batch();
+	ASSERT_TRUE(replies.has_value());
+	ASSERT_EQ(replies->size(), 8u);
+	for (uint64_t id = 1; id <= 8; ++id)
+	{
+		const auto& reply = (*replies)[id - 1];
+		EXPECT_EQ(reply.header.message_id, id);
+		EXPECT_EQ(reply.status, id == 3 ? status_code::error : status_code::ok);
+	}
+
+	// The session keeps working after the failed request
+	ASSERT_TRUE(client.send(make_request(9, "SELECT 1")));
+	auto reply = client.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->header.message_id, 9u);
+}
+
+TEST_F(GatewayServerTest, BatchTokensVerifiedOnAuthExecutorInOrder)
+{
+	config_.require_auth = true;
+	auto validator = std::make_shared<gated_validator>(blocked_);
+	validator_ = validator;
+	auth_executor_ = make_executor(1);
+	if (!start_server(make_executor(2)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	std::vector<query_request> requests;
+	for (uint64_t id = 1; id <= 4; ++id)
+	{
+		requests.push_back(make_request(id, "SELECT 1"));
+		requests.back().token.token = "token";
+		requests.back().token.client_id = "client";
+	}
+	ASSERT_TRUE(client.send_payload(encode_request_batch_v2(requests)));
+
+	// A request after the batch waits for the batch's verification
+	auto later = make_request(5, "SELECT 1");
+	later.token = requests.front().token;
+	ASSERT_TRUE(client.send(later));
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		EXPECT_TRUE(handled_.empty());
+	}
+	release();
+
+	auto replies = client.receive_batch();
+	ASSERT_TRUE(replies.has_value());
+	ASSERT_EQ(replies->size(), 4u);
+	for (const auto& reply : *replies)
+	{
+		EXPECT_EQ(reply.status, status_code::ok);
+	}
+	auto reply = client.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->header.message_id, 5u);
+
+	std::lock_guard<std::mutex> validator_lock(validator->mutex);
+	std::lock_guard<std::mutex> lock(mutex_);
+	ASSERT_FALSE(validator->threads.empty());
+	ASSERT_EQ(handler_threads_.size(), 5u);
+	for (const auto& thread : handler_threads_)
+	{
+		EXPECT_NE(thread, validator->threads.front());
+	}
+	EXPECT_EQ(handled_.back(), 5u);
+}
+
+TEST_F(GatewayServerTest, ResultReservedBeforeHandlerRuns)
+{
+	config_.memory.budget_bytes = 64 * 1024;
+	if (!start_server(make_executor(1)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	// An unbounded SELECT is expected to return more than the budget
+	ASSERT_TRUE(client.send(make_request(1, "SELECT 1")));
+	auto reply = client.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->status, status_code::server_busy);
+
+	auto bounded = make_request(2, "SELECT 1");
+	bounded.options.max_rows = 10;
+	ASSERT_TRUE(client.send(bounded));
+	reply = client.receive();
+	ASSERT_TRUE(reply.has_value());
+	EXPECT_EQ(reply->status, status_code::ok);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	ASSERT_EQ(handled_.size(), 1u);
+	EXPECT_EQ(handled_[0], 2u);
+}
+
+TEST_F(GatewayServerTest, EventsFollowSessionWireVersion)
+{
+	if (!start_server(make_executor(1)))
+	{
+		GTEST_SKIP() << skip_reason_;
+	}
+
+	test_client client(config_.unix_socket_path);
+	ASSERT_TRUE(client.connected());
+
+	query_request subscribe;
+	subscribe.type = query_type::subscribe;
+	subscribe.header.message_id = 1;
+	subscribe.params = { query_param("table", std::string("users")) };
+	ASSERT_TRUE(client.send(subscribe));
+	auto reply = client.receive();
+	ASSERT_TRUE(reply.has_value());
+	ASSERT_EQ(reply->status, status_code::ok);
+
+	server_->get_invalidation_broadcaster().publish("users", {});
+
+	auto event = client.receive_event();
+	ASSERT_TRUE(event.has_value());
+	EXPECT_EQ(event->sequence, 1u);
+	ASSERT_EQ(event->tables.size(), 1u);
+	EXPECT_EQ(event->tables[0], "users");
+}
+
+#endif // !defined(_WIN32)
@@ -245,6 +245,7 @@ TEST_F(AuthMiddlewareIntegrationTest, AuditCallbackReceivesEvents)
 
 	(void)middleware_->authenticate("session-001", valid_token);
 	(void)middleware_->authenticate("session-002", expired_token);
+	middleware_->flush_audit_events();
 
 	std::lock_guard<std::mutex> lock(events_mutex);
 	EXPECT_GE(captured_events.size(), 2);
@@ -0,0 +1,290 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file invalidation_broadcaster_test.cpp
+ * @brief Unit tests for cache invalidation subscriptions
+ *
+ * Tests cover:
+ * - Table and query subscriptions
+ * - Per-session sequence numbers
+ * - Resync after failed delivery and on cache clear
+ * - Subscription limits and session cleanup
+ * - Invalidation event serialization
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <kcenon/database_server/gateway/invalidation_broadcaster.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+/**
+ * @brief Records delivered events per session
+ */
+struct recording_sender
+{
+	std::map<std::string, std::vector<invalidation_event>> received;
+	bool fail = false;
+
+	invalidation_sender_t make()
+	{
+		return [this](const std::string& session_id, const invalidation_event& event)
+		{
+			if (fail)
+			{
+				return false;
+			}
+			received[session_id].push_back(event);
+			return true;
+		};
+	}
+};
+
+} // namespace
+
+// ============================================================================
+// Subscription Tests
+// ============================================================================
+
+class InvalidationBroadcasterTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		broadcaster_.set_sender(sender_.make());
+	}
+
+	recording_sender sender_;
+	invalidation_broadcaster broadcaster_;
+};
+
+TEST_F(InvalidationBroadcasterTest, TableSubscriptionReceivesEvent)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s1", {"users"}).is_ok());
+
+	broadcaster_.publish("users", {});
+
+	ASSERT_EQ(sender_.received["s1"].size(), 1u);
+	const auto& event = sender_.received["s1"][0];
+	EXPECT_EQ(event.sequence, 1u);
+	EXPECT_FALSE(event.resync);
+	ASSERT_EQ(event.tables.size(), 1u);
+	EXPECT_EQ(event.tables[0], "users");
+	EXPECT_EQ(event.header.message_id, 0u);
+}
+
+TEST_F(InvalidationBroadcasterTest, UnrelatedTableNotDelivered)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s1", {"users"}).is_ok());
+
+	broadcaster_.publish("orders", {"k1"});
+
+	EXPECT_TRUE(sender_.received.empty());
+}
+
+TEST_F(InvalidationBroadcasterTest, TableNamesAreCaseInsensitive)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s1", {"Users"}).is_ok());
+
+	broadcaster_.publish("USERS", {});
+
+	EXPECT_EQ(sender_.received["s1"].size(), 1u);
+}
+
+TEST_F(InvalidationBroadcasterTest, QuerySubscriptionNotifiedByTableWrite)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_query("s1", "key-a", {"users", "orders"}).is_ok());
+
+	broadcaster_.publish("orders", {});
+
+	ASSERT_EQ(sender_.received["s1"].size(), 1u);
+	const auto& event = sender_.received["s1"][0];
+	EXPECT_TRUE(event.tables.empty());
+	ASSERT_EQ(event.cache_keys.size(), 1u);
+	EXPECT_EQ(event.cache_keys[0], "key-a");
+}
+
+TEST_F(InvalidationBroadcasterTest, QuerySubscriptionNotifiedByKey)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_query("s1", "key-a", {"users"}).is_ok());
+
+	// Key reported both via the table and explicitly is listed once
+	broadcaster_.publish("users", {"key-a"});
+	broadcaster_.publish("", {"key-a"});
+
+	ASSERT_EQ(sender_.received["s1"].size(), 2u);
+	EXPECT_EQ(sender_.received["s1"][0].cache_keys.size(), 1u);
+	EXPECT_EQ(sender_.received["s1"][1].cache_keys.size(), 1u);
+}
+
+TEST_F(InvalidationBroadcasterTest, SequenceIsPerSession)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s1", {"users"}).is_ok());
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s2", {"users", "orders"}).is_ok());
+
+	broadcaster_.publish("orders", {});
+	broadcaster_.publish("users", {});
+	broadcaster_.publish("users", {});
+
+	ASSERT_EQ(sender_.received["s1"].size(), 2u);
+	EXPECT_EQ(sender_.received["s1"][0].sequence, 1u);
+	EXPECT_EQ(sender_.received["s1"][1].sequence, 2u);
+
+	ASSERT_EQ(sender_.received["s2"].size(), 3u);
+	EXPECT_EQ(sender_.received["s2"][2].sequence, 3u);
+}
+
+TEST_F(InvalidationBroadcasterTest, FailedDeliveryTriggersResync)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s1", {"users"}).is_ok());
+
+	sender_.fail = true;
+	broadcaster_.publish("users", {});
+	EXPECT_EQ(broadcaster_.metrics().send_failures.load(), 1u);
+
+	sender_.fail = false;
+	broadcaster_.publish("users", {});
+
+	ASSERT_EQ(sender_.received["s1"].size(), 1u);
+	const auto& event = sender_.received["s1"][0];
+	EXPECT_EQ(event.sequence, 2u);
+	EXPECT_TRUE(event.resync);
+
+	broadcaster_.publish("users", {});
+	EXPECT_FALSE(sender_.received["s1"][1].resync);
+}
+
+TEST_F(InvalidationBroadcasterTest, EmptyPublishIsResync)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s1", {"users"}).is_ok());
+	ASSERT_TRUE(broadcaster_.subscribe_query("s2", "key-a", {"orders"}).is_ok());
+
+	broadcaster_.publish("", {});
+
+	ASSERT_EQ(sender_.received["s1"].size(), 1u);
+	ASSERT_EQ(sender_.received["s2"].size(), 1u);
+	EXPECT_TRUE(sender_.received["s1"][0].resync);
+	EXPECT_TRUE(sender_.received["s2"][0].resync);
+	EXPECT_EQ(broadcaster_.metrics().resyncs.load(), 2u);
+}
+
+TEST_F(InvalidationBroadcasterTest, UnsubscribeStopsDelivery)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s1", {"users", "orders"}).is_ok());
+	ASSERT_TRUE(broadcaster_.subscribe_query("s1", "key-a", {"products"}).is_ok());
+	EXPECT_EQ(broadcaster_.subscription_count("s1"), 3u);
+
+	broadcaster_.unsubscribe_tables("s1", {"users"});
+	broadcaster_.unsubscribe_query("s1", "key-a");
+	EXPECT_EQ(broadcaster_.subscription_count("s1"), 1u);
+
+	broadcaster_.publish("users", {});
+	broadcaster_.publish("products", {"key-a"});
+	EXPECT_TRUE(sender_.received.empty());
+
+	broadcaster_.publish("orders", {});
+	EXPECT_EQ(sender_.received["s1"].size(), 1u);
+}
+
+TEST_F(InvalidationBroadcasterTest, RemoveSessionDropsSubscriptions)
+{
+	ASSERT_TRUE(broadcaster_.subscribe_tables("s1", {"users"}).is_ok());
+	ASSERT_TRUE(broadcaster_.subscribe_query("s1", "key-a", {"users"}).is_ok());
+	EXPECT_EQ(broadcaster_.session_count(), 1u);
+
+	broadcaster_.remove_session("s1");
+
+	EXPECT_EQ(broadcaster_.session_count(), 0u);
+	EXPECT_EQ(broadcaster_.subscription_count("s1"), 0u);
+
+	broadcaster_.publish("users", {"key-a"});
+	broadcaster_.publish_resync();
+	EXPECT_TRUE(sender_.received.empty());
+}
+
+TEST(InvalidationLimitTest, SubscriptionLimitEnforced)
+{
+	invalidation_config config;
+	config.max_subscriptions_per_session = 2;
+	invalidation_broadcaster broadcaster(config);
+
+	EXPECT_TRUE(broadcaster.subscribe_tables("s1", {"a", "b"}).is_ok());
+	EXPECT_TRUE(broadcaster.subscribe_tables("s1", {"a"}).is_ok()); // Already held
+	EXPECT_TRUE(broadcaster.subscribe_tables("s1", {"c"}).is_err());
+	EXPECT_TRUE(broadcaster.subscribe_query("s1", "key-a", {"a"}).is_err());
+	EXPECT_EQ(broadcaster.subscription_count("s1"), 2u);
+}
+
+TEST(InvalidationLimitTest, PublishWithoutSenderCountsFailure)
+{
+	invalidation_broadcaster broadcaster;
+	ASSERT_TRUE(broadcaster.subscribe_tables("s1", {"users"}).is_ok());
+
+	broadcaster.publish("users", {});
+
+	EXPECT_EQ(broadcaster.metrics().send_failures.load(), 1u);
+	EXPECT_EQ(broadcaster.metrics().events_sent.load(), 0u);
+}
+
+// ============================================================================
+// Serialization Tests
+// ============================================================================
+
+#if KCENON_WITH_CONTAINER_SYSTEM
+
+TEST(InvalidationEventTest, SerializeRoundTrip)
+{
+	invalidation_event event;
+	event.header = message_header(0);
+	event.sequence = 42;
+	event.tables = {"users", "orders"};
+	event.cache_keys = {"key-a"};
+	event.resync = true;
+
+	auto result = invalidation_event::deserialize(event.serialize());
+	ASSERT_TRUE(result.is_ok());
+
+	const auto& restored = result.value();
+	EXPECT_EQ(restored.sequence, 42u);
+	EXPECT_EQ(restored.tables, event.tables);
+	EXPECT_EQ(restored.cache_keys, event.cache_keys);
+	EXPECT_TRUE(restored.resync);
+}
+
+#endif
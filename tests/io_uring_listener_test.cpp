@@ -0,0 +1,418 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file io_uring_listener_test.cpp
+ * @brief Unit tests for the io_uring TCP listener
+ *
+ * Tests cover:
+ * - Framed request/response round trip
+ * - Frames split across and coalesced within reads
+ * - Batched responses and large payloads
+ * - Disconnect handling (client close, server close, oversized frame)
+ * - Connection limit and receive buffer exhaustion
+ *
+ * Tests are skipped when the kernel does not provide io_uring.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kcenon/database_server/gateway/io_uring_listener.h>
+
+#if defined(__linux__)
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+int connect_client(uint16_t port)
+{
+	int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+std::vector<uint8_t> frame(const std::string& payload)
+{
+	auto length = static_cast<uint32_t>(payload.size());
+	std::vector<uint8_t> bytes = {static_cast<uint8_t>(length >> 24),
+								  static_cast<uint8_t>(length >> 16),
+								  static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)};
+	bytes.insert(bytes.end(), payload.begin(), payload.end());
+	return bytes;
+}
+
+void write_all(int fd, const std::vector<uint8_t>& bytes)
+{
+	size_t offset = 0;
+	while (offset < bytes.size())
+	{
+		auto written = ::write(fd, bytes.data() + offset, bytes.size() - offset);
+		ASSERT_GT(written, 0);
+		offset += static_cast<size_t>(written);
+	}
+}
+
+bool read_exact(int fd, uint8_t* out, size_t size)
+{
+	size_t offset = 0;
+	while (offset < size)
+	{
+		auto received = ::read(fd, out + offset, size - offset);
+		if (received <= 0)
+		{
+			return false;
+		}
+		offset += static_cast<size_t>(received);
+	}
+	return true;
+}
+
+std::string read_frame(int fd)
+{
+	uint8_t header[4];
+	if (!read_exact(fd, header, 4))
+	{
+		return {};
+	}
+	uint32_t length = (uint32_t{header[0]} << 24) | (uint32_t{header[1]} << 16)
+					  | (uint32_t{header[2]} << 8) | uint32_t{header[3]};
+	std::string payload(length, '\0');
+	if (!read_exact(fd, reinterpret_cast<uint8_t*>(payload.data()), length))
+	{
+		return {};
+	}
+	return payload;
+}
+
+} // namespace
+
+// ============================================================================
+// Listener Tests
+// ============================================================================
+
+class IoUringListenerTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		if (!io_uring_listener::is_supported())
+		{
+			GTEST_SKIP() << "io_uring is not available";
+		}
+		config_.host = "127.0.0.1";
+		config_.port = 0;
+		config_.queue_depth = 256;
+		config_.buffer_count = 64;
+		config_.buffer_size = 4096;
+	}
+
+	void TearDown() override
+	{
+		if (listener_)
+		{
+			listener_->stop();
+		}
+	}
+
+	void start_listener()
+	{
+		listener_ = std::make_unique<io_uring_listener>(config_);
+
+		listener_->set_connection_callback(
+			[this](std::shared_ptr<session_transport> session)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				sessions_.push_back(std::move(session));
+				cv_.notify_all();
+			});
+
+		listener_->set_disconnection_callback(
+			[this](std::string_view id)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				disconnected_.emplace_back(id);
+				cv_.notify_all();
+			});
+
+		listener_->set_receive_callback(
+			[this](std::string_view id, const std::vector<uint8_t>& data)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				messages_.emplace_back(std::string(id), std::string(data.begin(), data.end()));
+				cv_.notify_all();
+			});
+
+		auto result = listener_->start();
+		ASSERT_TRUE(result.is_ok()) << result.error().message;
+		ASSERT_NE(listener_->bound_port(), 0);
+	}
+
+	template<typename Predicate>
+	bool wait_for(Predicate predicate)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		return cv_.wait_for(lock, std::chrono::seconds(5), predicate);
+	}
+
+	io_uring_config config_;
+	std::unique_ptr<io_uring_listener> listener_;
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<std::shared_ptr<session_transport>> sessions_;
+	std::vector<std::pair<std::string, std::string>> messages_;
+	std::vector<std::string> disconnected_;
+};
+
+TEST_F(IoUringListenerTest, RequestResponseRoundTrip)
+{
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	write_all(client, frame("hello"));
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 1; }));
+	EXPECT_EQ(messages_[0].first, sessions_[0]->id());
+	EXPECT_EQ(messages_[0].second, "hello");
+
+	std::string reply = "world";
+	ASSERT_TRUE(sessions_[0]->send(std::vector<uint8_t>(reply.begin(), reply.end())).is_ok());
+	EXPECT_EQ(read_frame(client), "world");
+
+	EXPECT_EQ(sessions_[0]->transport_name(), "io_uring");
+	EXPECT_EQ(listener_->connection_count(), 1u);
+	EXPECT_EQ(listener_->get_stats().connections_accepted, 1u);
+	::close(client);
+}
+
+TEST_F(IoUringListenerTest, ReassemblesSplitAndCoalescedFrames)
+{
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+
+	auto both = frame("first");
+	auto second = frame("second");
+	both.insert(both.end(), second.begin(), second.end());
+	write_all(client, both);
+
+	for (auto byte : frame("third"))
+	{
+		write_all(client, {byte});
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 3; }));
+	EXPECT_EQ(messages_[0].second, "first");
+	EXPECT_EQ(messages_[1].second, "second");
+	EXPECT_EQ(messages_[2].second, "third");
+	::close(client);
+}
+
+TEST_F(IoUringListenerTest, DeliversQueuedResponsesInOrder)
+{
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	// Larger than the socket buffer so sends complete partially
+	std::string large(4 * 1024 * 1024, 'L');
+	ASSERT_TRUE(sessions_[0]->send(std::vector<uint8_t>(large.begin(), large.end())).is_ok());
+	for (int i = 0; i < 100; ++i)
+	{
+		auto text = std::to_string(i);
+		ASSERT_TRUE(sessions_[0]->send(std::vector<uint8_t>(text.begin(), text.end())).is_ok());
+	}
+
+	EXPECT_EQ(read_frame(client), large);
+	for (int i = 0; i < 100; ++i)
+	{
+		EXPECT_EQ(read_frame(client), std::to_string(i));
+	}
+	::close(client);
+}
+
+TEST_F(IoUringListenerTest, ClientCloseReportsDisconnection)
+{
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	::close(client);
+
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	EXPECT_EQ(disconnected_[0], sessions_[0]->id());
+	EXPECT_FALSE(sessions_[0]->is_connected());
+	EXPECT_TRUE(sessions_[0]->send({1, 2, 3}).is_err());
+	EXPECT_EQ(listener_->connection_count(), 0u);
+}
+
+TEST_F(IoUringListenerTest, ServerCloseEndsClientStream)
+{
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	sessions_[0]->close();
+
+	uint8_t byte;
+	EXPECT_EQ(::read(client, &byte, 1), 0);
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	::close(client);
+}
+
+TEST_F(IoUringListenerTest, OversizedFrameDropsConnection)
+{
+	config_.max_frame_bytes = 16;
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+
+	write_all(client, frame(std::string(64, 'x')));
+
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	EXPECT_TRUE(messages_.empty());
+	::close(client);
+}
+
+TEST_F(IoUringListenerTest, ConnectionLimitEnforced)
+{
+	config_.max_connections = 1;
+	start_listener();
+
+	int first = connect_client(listener_->bound_port());
+	ASSERT_GE(first, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	int second = connect_client(listener_->bound_port());
+	ASSERT_GE(second, 0);
+
+	uint8_t byte;
+	EXPECT_EQ(::read(second, &byte, 1), 0);
+	EXPECT_EQ(listener_->connection_count(), 1u);
+
+	::close(first);
+	::close(second);
+}
+
+TEST_F(IoUringListenerTest, RecoversFromBufferExhaustion)
+{
+	config_.buffer_count = 1;
+	config_.buffer_size = 1024;
+	start_listener();
+
+	std::vector<int> clients;
+	for (int i = 0; i < 8; ++i)
+	{
+		clients.push_back(connect_client(listener_->bound_port()));
+		ASSERT_GE(clients.back(), 0);
+	}
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 8; }));
+
+	std::string payload(16 * 1024, 'p');
+	for (int fd : clients)
+	{
+		write_all(fd, frame(payload));
+	}
+
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 8; }));
+	for (const auto& [id, message] : messages_)
+	{
+		EXPECT_EQ(message, payload);
+	}
+	for (int fd : clients)
+	{
+		::close(fd);
+	}
+}
+
+TEST_F(IoUringListenerTest, StopDisconnectsSessions)
+{
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	listener_->stop();
+
+	EXPECT_FALSE(listener_->is_running());
+	EXPECT_EQ(disconnected_.size(), 1u);
+	EXPECT_EQ(listener_->connection_count(), 0u);
+	EXPECT_TRUE(sessions_[0]->send({1}).is_err());
+
+	uint8_t byte;
+	EXPECT_EQ(::read(client, &byte, 1), 0);
+	::close(client);
+}
+
+TEST_F(IoUringListenerTest, RejectsInvalidBindAddress)
+{
+	config_.host = "not-an-address";
+	io_uring_listener listener(config_);
+	EXPECT_TRUE(listener.start().is_err());
+	EXPECT_FALSE(listener.is_running());
+}
+
+#endif // __linux__
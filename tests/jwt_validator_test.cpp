@@ -0,0 +1,517 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file jwt_validator_test.cpp
+ * @brief Unit tests for jwt_validator and the SHA-2/HMAC primitives
+ *
+ * Tests cover:
+ * - SHA-256/SHA-512 and HMAC against FIPS 180-4 and RFC 4231 vectors
+ * - The RFC 7515 HS256 example token
+ * - Signature, algorithm and key selection (kid rotation)
+ * - exp/nbf/iat, issuer, audience and subject checks
+ * - Permissions and expiry handed to the token cache
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <kcenon/database_server/gateway/hmac_sha2.h>
+#include <kcenon/database_server/gateway/jwt_validator.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+template <typename Digest>
+std::string to_hex(const Digest& digest)
+{
+	static constexpr char digits[] = "0123456789abcdef";
+	std::string hex;
+	for (auto byte : digest)
+	{
+		hex.push_back(digits[byte >> 4]);
+		hex.push_back(digits[byte & 0x0f]);
+	}
+	return hex;
+}
+
+std::string base64url_encode(std::string_view data)
+{
+	static constexpr char alphabet[]
+		= "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+	std::string out;
+	uint32_t buffer = 0;
+	int bits = 0;
+	for (unsigned char c : data)
+	{
+		buffer = (buffer << 8) | c;
+		bits += 8;
+		while (bits >= 6)
+		{
+			bits -= 6;
+			out.push_back(alphabet[(buffer >> bits) & 0x3f]);
+		}
+	}
+	if (bits > 0)
+	{
+		out.push_back(alphabet[(buffer << (6 - bits)) & 0x3f]);
+	}
+	return out;
+}
+
+std::string base64url_decode(std::string_view text)
+{
+	std::string out;
+	uint32_t buffer = 0;
+	int bits = 0;
+	for (char c : text)
+	{
+		int value = c >= 'A' && c <= 'Z'   ? c - 'A'
+					: c >= 'a' && c <= 'z' ? c - 'a' + 26
+					: c >= '0' && c <= '9' ? c - '0' + 52
+					: c == '-'             ? 62
+										   : 63;
+		buffer = (buffer << 6) | static_cast<uint32_t>(value);
+		bits += 6;
+		if (bits >= 8)
+		{
+			bits -= 8;
+			out.push_back(static_cast<char>((buffer >> bits) & 0xff));
+		}
+	}
+	return out;
+}
+
+constexpr uint64_t now_ms = 1'800'000'000'000; // 2027-01-15
+constexpr uint64_t now_s = now_ms / 1000;
+constexpr const char* test_secret = "0123456789abcdef0123456789abcdef";
+
+/// Build a signed compact JWS from header and claim JSON
+std::string sign_token(const std::string& header, const std::string& claims,
+					   const std::string& secret = test_secret,
+					   jwt_algorithm algorithm = jwt_algorithm::hs256)
+{
+	auto input = base64url_encode(header) + "." + base64url_encode(claims);
+	std::string signature;
+	if (algorithm == jwt_algorithm::hs512)
+	{
+		auto mac = hmac_sha512(secret).sign(input);
+		signature.assign(reinterpret_cast<const char*>(mac.data()), mac.size());
+	}
+	else
+	{
+		auto mac = hmac_sha256(secret).sign(input);
+		signature.assign(reinterpret_cast<const char*>(mac.data()), mac.size());
+	}
+	return input + "." + base64url_encode(signature);
+}
+
+auth_token make_token(std::string compact, std::string client_id = "")
+{
+	auth_token token;
+	token.token = std::move(compact);
+	token.client_id = std::move(client_id);
+	return token;
+}
+
+std::string claims_for(const std::string& sub, uint64_t exp, const std::string& extra = "")
+{
+	return R"({"sub":")" + sub + R"(","exp":)" + std::to_string(exp) + extra + "}";
+}
+
+} // namespace
+
+// ============================================================================
+// SHA-2 / HMAC Tests
+// ============================================================================
+
+TEST(Sha2Test, Sha256Vectors)
+{
+	EXPECT_EQ(to_hex(sha256("")),
+			  "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+	EXPECT_EQ(to_hex(sha256("abc")),
+			  "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+	EXPECT_EQ(to_hex(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+			  "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+	EXPECT_EQ(to_hex(sha256(std::string(1000000, 'a'))),
+			  "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST(Sha2Test, Sha512Vectors)
+{
+	EXPECT_EQ(to_hex(sha512("abc")),
+			  "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+			  "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f");
+	EXPECT_EQ(to_hex(sha512("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+							"hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu")),
+			  "8e959b75dae313da8cf4f72814fc143f8f7779c6eb9f7fa17299aeadb6889018"
+			  "501d289e4900f7e4331b99dec4b5433ac7d329eeb6dd26545e96e55b874be909");
+}
+
+TEST(Sha2Test, PaddingBoundaries)
+{
+	// Lengths around the point where the length field spills into a second block
+	EXPECT_EQ(to_hex(sha256(std::string(55, 'a'))),
+			  "9f4390f8d30c2dd92ec9f095b65e2b9ae9b0a925a5258e241c9f1e910f734318");
+	EXPECT_EQ(to_hex(sha256(std::string(56, 'a'))),
+			  "b35439a4ac6f0948b6d6f9e3c6af0f5f590ce20f1bde7090ef7970686ec6738a");
+	EXPECT_EQ(to_hex(sha256(std::string(64, 'a'))),
+			  "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb");
+}
+
+TEST(HmacTest, Rfc4231Vectors)
+{
+	// Test case 1
+	EXPECT_EQ(to_hex(hmac_sha256(std::string(20, '\x0b')).sign("Hi There")),
+			  "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+	EXPECT_EQ(to_hex(hmac_sha512(std::string(20, '\x0b')).sign("Hi There")),
+			  "87aa7cdea5ef619d4ff0b4241a1d6cb02379f4e2ce4ec2787ad0b30545e17cde"
+			  "daa833b7d6b8a702038b274eaea3f4e4be9d914eeb61f1702e696c203a126854");
+
+	// Test case 2: key shorter than the output
+	EXPECT_EQ(to_hex(hmac_sha256("Jefe").sign("what do ya want for nothing?")),
+			  "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+	// Test case 6: key longer than the block is hashed first
+	const std::string long_key(131, '\xaa');
+	const std::string message = "Test Using Larger Than Block-Size Key - Hash Key First";
+	EXPECT_EQ(to_hex(hmac_sha256(long_key).sign(message)),
+			  "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+	EXPECT_EQ(to_hex(hmac_sha512(long_key).sign(message)),
+			  "80b24263c7c1a3ebb71493c1dd7be8b49b46d1f41b4aeec1121b013783f8f352"
+			  "6b56d037e05f2598bd0fd2215d6a1e5295e64f73f63f0aec8b915a985d786598");
+}
+
+TEST(HmacTest, ConstantTimeEqual)
+{
+	EXPECT_TRUE(constant_time_equal("abc", "abc"));
+	EXPECT_FALSE(constant_time_equal("abc", "abd"));
+	EXPECT_FALSE(constant_time_equal("abc", "abcd"));
+	EXPECT_TRUE(constant_time_equal("", ""));
+}
+
+// ============================================================================
+// JWT Validator Tests
+// ============================================================================
+
+class JwtValidatorTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		validator_.add_key({ "", jwt_algorithm::hs256, secret_ });
+	}
+
+	const std::string secret_ = test_secret;
+	const std::string header_ = R"({"alg":"HS256","typ":"JWT"})";
+	jwt_validator validator_;
+};
+
+TEST_F(JwtValidatorTest, Rfc7515ExampleSignature)
+{
+	// RFC 7515 appendix A.1; the example has no subject, so it fails only
+	// after the signature and expiry checks have passed
+	jwt_validator validator;
+	validator.add_key({ "", jwt_algorithm::hs256,
+						base64url_decode("AyM1SysPpbyDfgZld3umj1qzKObwVMkoqQ-EstJQLr_T-1qS0gZH"
+										 "75aKtMN3Yj0iPS4hcgUuTwjAzZr1Z9CAow") });
+	auto token = make_token(
+		"eyJ0eXAiOiJKV1QiLA0KICJhbGciOiJIUzI1NiJ9"
+		".eyJpc3MiOiJqb2UiLA0KICJleHAiOjEzMDA4MTkzODAsDQogImh0dHA6Ly9leGFtcGxlLmNvbS9pc19yb290Ijp0cnVlfQ"
+		".dBjftJeZ4CVP-mB92K27uhbUJU1p1r_wW1gFWFOEjXk");
+
+	auto result = validator.validate(token, 1300819370000);
+	EXPECT_FALSE(result.success);
+	EXPECT_EQ(result.message, "Token has no subject");
+	EXPECT_EQ(validator.verifications(), 1u);
+
+	token.token[token.token.size() - 5] ^= 1;
+	EXPECT_EQ(validator.validate(token, 1300819370000).message, "Invalid token signature");
+}
+
+TEST_F(JwtValidatorTest, ValidTokenSucceeds)
+{
+	auto token = make_token(sign_token(header_, claims_for("alice", now_s + 600)), "alice");
+
+	auto result = validator_.validate(token, now_ms);
+	EXPECT_TRUE(result.success);
+	EXPECT_EQ(result.code, status_code::ok);
+	EXPECT_EQ(result.client_id, "alice");
+	EXPECT_EQ(result.expires_at, (now_s + 600) * 1000);
+}
+
+TEST_F(JwtValidatorTest, ClientIdTakenFromSubject)
+{
+	auto token = make_token(sign_token(header_, claims_for("alice", now_s + 600)));
+
+	auto result = validator_.validate(token, now_ms);
+	EXPECT_TRUE(result.success);
+	EXPECT_EQ(result.client_id, "alice");
+
+	token.client_id = "mallory";
+	EXPECT_FALSE(validator_.validate(token, now_ms).success);
+}
+
+TEST_F(JwtValidatorTest, TamperedTokensFail)
+{
+	auto compact = sign_token(header_, claims_for("alice", now_s + 600));
+	auto dot = compact.find('.');
+
+	// Claims replaced, signature kept
+	auto forged = compact.substr(0, dot + 1)
+				  + base64url_encode(claims_for("admin", now_s + 600))
+				  + compact.substr(compact.rfind('.'));
+	EXPECT_EQ(validator_.validate(make_token(forged), now_ms).message, "Invalid token signature");
+
+	// Signed with another secret
+	auto other = sign_token(header_, claims_for("alice", now_s + 600), "wrong secret");
+	EXPECT_FALSE(validator_.validate(make_token(other), now_ms).success);
+}
+
+TEST_F(JwtValidatorTest, MalformedTokensFail)
+{
+	for (const std::string compact : { "", "abc", "a.b", "a.b.c.d", "!!.e30.", "e30.e30.***" })
+	{
+		EXPECT_FALSE(validator_.validate(make_token(compact), now_ms).success) << compact;
+	}
+
+	auto bad_json = sign_token(header_, R"({"sub":"alice","exp":)");
+	EXPECT_FALSE(validator_.validate(make_token(bad_json), now_ms).success);
+
+	auto duplicate = sign_token(header_, R"({"sub":"alice","sub":"admin","exp":)"
+											 + std::to_string(now_s + 600) + "}");
+	EXPECT_FALSE(validator_.validate(make_token(duplicate), now_ms).success);
+
+	jwt_config config;
+	config.max_token_size = 16;
+	jwt_validator small(config);
+	small.add_key({ "", jwt_algorithm::hs256, secret_ });
+	auto token = make_token(sign_token(header_, claims_for("alice", now_s + 600)));
+	EXPECT_EQ(small.validate(token, now_ms).message, "Token is too large");
+}
+
+TEST_F(JwtValidatorTest, AlgorithmMustMatchKey)
+{
+	auto none = base64url_encode(R"({"alg":"none"})") + "."
+				+ base64url_encode(claims_for("alice", now_s + 600)) + ".";
+	EXPECT_FALSE(validator_.validate(make_token(none), now_ms).success);
+
+	auto hs512 = sign_token(R"({"alg":"HS512"})", claims_for("alice", now_s + 600), secret_,
+							jwt_algorithm::hs512);
+	EXPECT_EQ(validator_.validate(make_token(hs512), now_ms).message,
+			  "Token algorithm does not match its key");
+	EXPECT_EQ(validator_.verifications(), 0u);
+}
+
+TEST_F(JwtValidatorTest, KeyRotationByKid)
+{
+	jwt_validator validator;
+	validator.add_key({ "2026-09", jwt_algorithm::hs256, "old secret" });
+	validator.add_key({ "2026-10", jwt_algorithm::hs512, "new secret" });
+	EXPECT_EQ(validator.key_count(), 2u);
+
+	auto old_token = make_token(sign_token(R"({"alg":"HS256","kid":"2026-09"})",
+										   claims_for("alice", now_s + 600), "old secret"));
+	auto new_token = make_token(sign_token(R"({"alg":"HS512","kid":"2026-10"})",
+										   claims_for("alice", now_s + 600), "new secret",
+										   jwt_algorithm::hs512));
+	EXPECT_TRUE(validator.validate(old_token, now_ms).success);
+	EXPECT_TRUE(validator.validate(new_token, now_ms).success);
+
+	// A token naming one key but signed with the other
+	auto mixed = make_token(sign_token(R"({"alg":"HS256","kid":"2026-09"})",
+									   claims_for("alice", now_s + 600), "new secret"));
+	EXPECT_FALSE(validator.validate(mixed, now_ms).success);
+
+	EXPECT_TRUE(validator.remove_key("2026-09"));
+	EXPECT_FALSE(validator.remove_key("2026-09"));
+	EXPECT_EQ(validator.validate(old_token, now_ms).message, "Unknown signing key");
+	EXPECT_TRUE(validator.validate(new_token, now_ms).success);
+}
+
+TEST_F(JwtValidatorTest, ExpiryAndNotBefore)
+{
+	auto expired = make_token(sign_token(header_, claims_for("alice", now_s - 60)));
+	auto result = validator_.validate(expired, now_ms);
+	EXPECT_FALSE(result.success);
+	EXPECT_EQ(result.message, "Token has expired");
+	EXPECT_EQ(result.expires_at, (now_s - 60) * 1000);
+
+	// Within the default 30 s leeway
+	auto recent = make_token(sign_token(header_, claims_for("alice", now_s - 10)));
+	EXPECT_TRUE(validator_.validate(recent, now_ms).success);
+
+	auto no_expiry = make_token(sign_token(header_, R"({"sub":"alice"})"));
+	EXPECT_EQ(validator_.validate(no_expiry, now_ms).message, "Token has no expiry");
+
+	auto future = make_token(sign_token(
+		header_, claims_for("alice", now_s + 600, R"(,"nbf":)" + std::to_string(now_s + 300))));
+	EXPECT_EQ(validator_.validate(future, now_ms).message, "Token is not yet valid");
+
+	auto issued_later = make_token(sign_token(
+		header_, claims_for("alice", now_s + 600, R"(,"iat":)" + std::to_string(now_s + 300))));
+	EXPECT_FALSE(validator_.validate(issued_later, now_ms).success);
+
+	auto bad_date = make_token(sign_token(header_, R"({"sub":"alice","exp":"tomorrow"})"));
+	EXPECT_EQ(validator_.validate(bad_date, now_ms).message, "Malformed token date");
+}
+
+TEST_F(JwtValidatorTest, OptionalExpiry)
+{
+	jwt_config config;
+	config.require_expiry = false;
+	jwt_validator validator(config);
+	validator.add_key({ "", jwt_algorithm::hs256, secret_ });
+
+	auto result = validator.validate(make_token(sign_token(header_, R"({"sub":"alice"})")), now_ms);
+	EXPECT_TRUE(result.success);
+	EXPECT_EQ(result.expires_at, 0u);
+}
+
+TEST_F(JwtValidatorTest, IssuerAndAudience)
+{
+	jwt_config config;
+	config.issuer = "https://auth.example.com";
+	config.audience = "database_server";
+	jwt_validator validator(config);
+	validator.add_key({ "", jwt_algorithm::hs256, secret_ });
+
+	auto sign = [&](const std::string& extra)
+	{ return make_token(sign_token(header_, claims_for("alice", now_s + 600, extra))); };
+
+	EXPECT_TRUE(validator
+					.validate(sign(R"(,"iss":"https://auth.example.com","aud":"database_server")"),
+							  now_ms)
+					.success);
+	EXPECT_TRUE(
+		validator
+			.validate(sign(R"(,"iss":"https://auth.example.com","aud":["web","database_server"])"),
+					  now_ms)
+			.success);
+	EXPECT_EQ(validator.validate(sign(R"(,"iss":"https://evil.example.com","aud":"database_server")"),
+								 now_ms)
+				  .message,
+			  "Token issuer not accepted");
+	EXPECT_EQ(
+		validator.validate(sign(R"(,"iss":"https://auth.example.com","aud":["web"])"), now_ms)
+			.message,
+		"Token audience not accepted");
+	EXPECT_FALSE(validator.validate(sign(""), now_ms).success);
+}
+
+TEST_F(JwtValidatorTest, PermissionsFromScopeOrArray)
+{
+	auto scoped = make_token(sign_token(
+		header_, claims_for("alice", now_s + 600, R"(,"scope":"read  write admin")")));
+	auto result = validator_.validate(scoped, now_ms);
+	ASSERT_TRUE(result.success);
+	EXPECT_EQ(result.permissions, (std::vector<std::string>{ "read", "write", "admin" }));
+
+	jwt_config config;
+	config.permissions_claim = "permissions";
+	jwt_validator validator(config);
+	validator.add_key({ "", jwt_algorithm::hs256, secret_ });
+	auto listed = make_token(sign_token(
+		header_, claims_for("alice", now_s + 600, R"(,"permissions":["read",{"x":1},"write"])")));
+	result = validator.validate(listed, now_ms);
+	ASSERT_TRUE(result.success);
+	EXPECT_EQ(result.permissions, (std::vector<std::string>{ "read", "write" }));
+}
+
+TEST_F(JwtValidatorTest, EscapedStrings)
+{
+	auto token = make_token(sign_token(
+		header_, R"({"sub":"alice 😀 \"q\"","exp":)" + std::to_string(now_s + 600) + "}"));
+
+	auto result = validator_.validate(token, now_ms);
+	ASSERT_TRUE(result.success);
+	EXPECT_EQ(result.client_id, "alice \xF0\x9F\x98\x80 \"q\"");
+}
+
+// ============================================================================
+// Middleware Integration Tests
+// ============================================================================
+
+TEST(JwtMiddlewareTest, TokenVerifiedOncePerLifetime)
+{
+	auto validator = std::make_shared<jwt_validator>();
+	validator->add_key({ "k1", jwt_algorithm::hs256, "secret" });
+
+	rate_limit_config rate_cfg;
+	rate_cfg.enabled = false;
+	auth_middleware middleware(auth_config{}, rate_cfg, validator);
+
+	auto exp_s = static_cast<uint64_t>(
+					 std::chrono::duration_cast<std::chrono::seconds>(
+						 std::chrono::system_clock::now().time_since_epoch())
+						 .count())
+				 + 3600;
+	auto token = make_token(
+		sign_token(R"({"alg":"HS256","kid":"k1"})", claims_for("alice", exp_s), "secret"), "alice");
+
+	EXPECT_TRUE(middleware.needs_validation(token));
+	for (int i = 0; i < 10; ++i)
+	{
+		EXPECT_TRUE(middleware.authenticate("session-1", token).success);
+	}
+	EXPECT_FALSE(middleware.needs_validation(token));
+	EXPECT_EQ(validator->verifications(), 1u);
+
+	middleware.revoke_token(token.token);
+	EXPECT_FALSE(middleware.authenticate("session-1", token).success);
+}
+
+TEST(JwtMiddlewareTest, ShortLivedTokenNotCachedPastItsExpiry)
+{
+	auto validator = std::make_shared<jwt_validator>();
+	validator->add_key({ "", jwt_algorithm::hs256, "secret" });
+
+	rate_limit_config rate_cfg;
+	rate_cfg.enabled = false;
+	auth_middleware middleware(auth_config{}, rate_cfg, validator);
+
+	// Inside the refresh window: the client sent no expiry, but the claim
+	// keeps the token out of the cache
+	auto exp_s = static_cast<uint64_t>(
+					 std::chrono::duration_cast<std::chrono::seconds>(
+						 std::chrono::system_clock::now().time_since_epoch())
+						 .count())
+				 + 60;
+	auto token = make_token(sign_token(R"({"alg":"HS256"})", claims_for("alice", exp_s), "secret"));
+
+	EXPECT_TRUE(middleware.authenticate("session-1", token).success);
+	EXPECT_TRUE(middleware.authenticate("session-1", token).success);
+	EXPECT_EQ(validator->verifications(), 2u);
+}
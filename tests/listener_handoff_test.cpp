@@ -0,0 +1,506 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file listener_handoff_test.cpp
+ * @brief Unit tests for the listening-socket handoff
+ *
+ * Both sides of the handoff run in the test process. Tests cover:
+ * - Missing predecessor
+ * - Listening socket shared with the successor, socket file kept
+ * - Idle Unix socket and io_uring connections moved to the successor
+ * - Connections with a partial frame buffered staying with the old listener
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kcenon/database_server/gateway/io_uring_listener.h>
+#include <kcenon/database_server/gateway/listener_handoff.h>
+#include <kcenon/database_server/gateway/unix_socket_listener.h>
+
+#if !defined(_WIN32)
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+std::string make_socket_path(const std::string& kind)
+{
+	static std::atomic<int> counter{0};
+	return "/tmp/dbgw_handoff_" + kind + "_" + std::to_string(::getpid()) + "_"
+		   + std::to_string(counter.fetch_add(1)) + ".sock";
+}
+
+int connect_unix(const std::string& path)
+{
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	struct sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+	if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+int connect_tcp(uint16_t port)
+{
+	int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+std::vector<uint8_t> frame(const std::string& payload)
+{
+	auto length = static_cast<uint32_t>(payload.size());
+	std::vector<uint8_t> bytes = {static_cast<uint8_t>(length >> 24),
+								  static_cast<uint8_t>(length >> 16),
+								  static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)};
+	bytes.insert(bytes.end(), payload.begin(), payload.end());
+	return bytes;
+}
+
+void write_all(int fd, const uint8_t* data, size_t size)
+{
+	size_t offset = 0;
+	while (offset < size)
+	{
+		auto written = ::send(fd, data + offset, size - offset, MSG_NOSIGNAL);
+		ASSERT_GT(written, 0);
+		offset += static_cast<size_t>(written);
+	}
+}
+
+bool read_exact(int fd, uint8_t* out, size_t size)
+{
+	size_t offset = 0;
+	while (offset < size)
+	{
+		auto received = ::read(fd, out + offset, size - offset);
+		if (received <= 0)
+		{
+			return false;
+		}
+		offset += static_cast<size_t>(received);
+	}
+	return true;
+}
+
+std::string read_frame(int fd)
+{
+	uint8_t header[4];
+	if (!read_exact(fd, header, 4))
+	{
+		return {};
+	}
+	uint32_t length = (uint32_t{header[0]} << 24) | (uint32_t{header[1]} << 16)
+					  | (uint32_t{header[2]} << 8) | uint32_t{header[3]};
+	std::string payload(length, '\0');
+	if (!read_exact(fd, reinterpret_cast<uint8_t*>(payload.data()), length))
+	{
+		return {};
+	}
+	return payload;
+}
+
+std::string round_trip(int fd, const std::string& payload)
+{
+	auto bytes = frame(payload);
+	write_all(fd, bytes.data(), bytes.size());
+	return read_frame(fd);
+}
+
+/**
+ * Echoes every message back prefixed with the owner's name, so a client
+ * can tell which "process" served it.
+ */
+class echo_process
+{
+public:
+	echo_process(std::string name, std::unique_ptr<transport_listener> listener)
+		: name_(std::move(name)), listener_(std::move(listener))
+	{
+		listener_->set_connection_callback(
+			[this](std::shared_ptr<session_transport> session)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				sessions_[std::string(session->id())] = std::move(session);
+			});
+
+		listener_->set_disconnection_callback(
+			[this](std::string_view id)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				sessions_.erase(std::string(id));
+			});
+
+		listener_->set_receive_callback(
+			[this](std::string_view id, const std::vector<uint8_t>& data)
+			{
+				std::shared_ptr<session_transport> session;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					auto it = sessions_.find(std::string(id));
+					if (it == sessions_.end())
+					{
+						return;
+					}
+					session = it->second;
+				}
+				auto reply = name_ + ":" + std::string(data.begin(), data.end());
+				(void)session->send(std::vector<uint8_t>(reply.begin(), reply.end()));
+			});
+	}
+
+	~echo_process() { listener_->stop(); }
+
+	transport_listener& listener() { return *listener_; }
+
+	size_t session_count()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		return sessions_.size();
+	}
+
+private:
+	std::string name_;
+	std::unique_ptr<transport_listener> listener_;
+	std::mutex mutex_;
+	std::map<std::string, std::shared_ptr<session_transport>> sessions_;
+};
+
+/// Serves a takeover of a single listener from a background thread.
+std::unique_ptr<handoff_server> serve_handoff(const handoff_config& config,
+											  transport_listener& listener,
+											  std::atomic<bool>& completed)
+{
+	auto server = std::make_unique<handoff_server>(config);
+	server->set_listeners_provider(
+		[&listener]
+		{
+			return std::vector<handoff_socket>{
+				{std::string(listener.transport_name()), listener.listen_fd()}};
+		});
+	server->set_release_callback(
+		[&listener]
+		{
+			listener.stop_accepting();
+			std::vector<handoff_socket> released;
+			for (int fd : listener.release_idle_connections([](std::string_view) { return true; }))
+			{
+				released.push_back({std::string(listener.transport_name()), fd});
+			}
+			return released;
+		});
+	server->set_completion_callback([&completed] { completed = true; });
+	return server;
+}
+
+template<typename Predicate>
+bool wait_until(Predicate predicate)
+{
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!predicate())
+	{
+		if (std::chrono::steady_clock::now() > deadline)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	return true;
+}
+
+} // namespace
+
+// ============================================================================
+// Handoff Protocol Tests
+// ============================================================================
+
+TEST(ListenerHandoffTest, ClientReportsMissingPredecessor)
+{
+	handoff_config config;
+	config.path = make_socket_path("missing");
+
+	handoff_client client(config);
+	auto result = client.receive_listeners();
+
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().code, handoff_client::no_predecessor);
+}
+
+TEST(ListenerHandoffTest, StaleSocketFileMeansNoPredecessor)
+{
+	handoff_config config;
+	config.path = make_socket_path("stale");
+
+	// A crashed process leaves its socket file behind
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	struct sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", config.path.c_str());
+	ASSERT_EQ(::bind(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)), 0);
+	::close(fd);
+
+	handoff_client client(config);
+	auto result = client.receive_listeners();
+
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().code, handoff_client::no_predecessor);
+	::unlink(config.path.c_str());
+}
+
+TEST(ListenerHandoffTest, ServerRemovesSocketFileWhenStoppedWithoutTakeover)
+{
+	handoff_config config;
+	config.path = make_socket_path("idle");
+
+	handoff_server server(config);
+	ASSERT_TRUE(server.start().is_ok());
+	EXPECT_TRUE(server.is_running());
+	EXPECT_EQ(::access(config.path.c_str(), F_OK), 0);
+
+	server.stop();
+
+	EXPECT_FALSE(server.is_running());
+	EXPECT_FALSE(server.completed());
+	EXPECT_NE(::access(config.path.c_str(), F_OK), 0);
+}
+
+// ============================================================================
+// Unix Socket Takeover Tests
+// ============================================================================
+
+class UnixSocketHandoffTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		listener_config_.path = make_socket_path("unix");
+		handoff_config_.path = make_socket_path("ctl");
+	}
+
+	void TearDown() override
+	{
+		::unlink(listener_config_.path.c_str());
+		::unlink(handoff_config_.path.c_str());
+	}
+
+	unix_socket_config listener_config_;
+	handoff_config handoff_config_;
+};
+
+TEST_F(UnixSocketHandoffTest, SuccessorServesSameSocketAndIdleConnections)
+{
+	auto old_process = std::make_unique<echo_process>(
+		"old", std::make_unique<unix_socket_listener>(listener_config_));
+	ASSERT_TRUE(old_process->listener().start().is_ok());
+
+	std::atomic<bool> completed{false};
+	auto server = serve_handoff(handoff_config_, old_process->listener(), completed);
+	ASSERT_TRUE(server->start().is_ok());
+
+	int idle = connect_unix(listener_config_.path);
+	ASSERT_GE(idle, 0);
+	EXPECT_EQ(round_trip(idle, "one"), "old:one");
+
+	// Half a frame header: must not move, the old process would lose it
+	int partial = connect_unix(listener_config_.path);
+	ASSERT_GE(partial, 0);
+	auto pending = frame("two");
+	write_all(partial, pending.data(), 2);
+	ASSERT_TRUE(wait_until([&] { return old_process->session_count() == 2; }));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+	// Successor
+	handoff_client client(handoff_config_);
+	auto listeners = client.receive_listeners();
+	ASSERT_TRUE(listeners.is_ok()) << listeners.error().message;
+	ASSERT_EQ(listeners.value().size(), 1u);
+	EXPECT_EQ(listeners.value()[0].transport, "unix");
+
+	auto new_process = std::make_unique<echo_process>(
+		"new", std::make_unique<unix_socket_listener>(listener_config_));
+	ASSERT_TRUE(new_process->listener().adopt_listen_fd(listeners.value()[0].fd));
+	ASSERT_TRUE(new_process->listener().start().is_ok());
+
+	auto connections = client.confirm_listening();
+	ASSERT_TRUE(connections.is_ok()) << connections.error().message;
+	ASSERT_EQ(connections.value().size(), 1u);
+	EXPECT_EQ(connections.value()[0].transport, "unix");
+	ASSERT_TRUE(new_process->listener().adopt_connection(connections.value()[0].fd).is_ok());
+
+	ASSERT_TRUE(wait_until([&] { return completed.load(); }));
+	EXPECT_TRUE(server->completed());
+
+	// The idle connection continues on the successor
+	EXPECT_EQ(round_trip(idle, "three"), "new:three");
+
+	// The busy one finishes on the old process
+	write_all(partial, pending.data() + 2, pending.size() - 2);
+	EXPECT_EQ(read_frame(partial), "old:two");
+
+	// New connections reach the successor, also after the old one exits
+	int fresh = connect_unix(listener_config_.path);
+	ASSERT_GE(fresh, 0);
+	EXPECT_EQ(round_trip(fresh, "four"), "new:four");
+
+	server->stop();
+	old_process.reset();
+	EXPECT_EQ(::access(listener_config_.path.c_str(), F_OK), 0);
+	EXPECT_EQ(::access(handoff_config_.path.c_str(), F_OK), 0);
+
+	int late = connect_unix(listener_config_.path);
+	ASSERT_GE(late, 0);
+	EXPECT_EQ(round_trip(late, "five"), "new:five");
+
+	::close(idle);
+	::close(partial);
+	::close(fresh);
+	::close(late);
+}
+
+TEST_F(UnixSocketHandoffTest, ReleaseSkipsIneligibleConnections)
+{
+	auto old_process = std::make_unique<echo_process>(
+		"old", std::make_unique<unix_socket_listener>(listener_config_));
+	ASSERT_TRUE(old_process->listener().start().is_ok());
+
+	int client_fd = connect_unix(listener_config_.path);
+	ASSERT_GE(client_fd, 0);
+	EXPECT_EQ(round_trip(client_fd, "one"), "old:one");
+
+	auto released = old_process->listener().release_idle_connections(
+		[](std::string_view) { return false; });
+	EXPECT_TRUE(released.empty());
+	EXPECT_EQ(round_trip(client_fd, "two"), "old:two");
+
+	::close(client_fd);
+}
+
+// ============================================================================
+// io_uring Takeover Tests
+// ============================================================================
+
+TEST(IoUringHandoffTest, SuccessorServesSamePortAndIdleConnections)
+{
+	if (!io_uring_listener::is_supported())
+	{
+		GTEST_SKIP() << "io_uring is not available";
+	}
+
+	io_uring_config listener_config;
+	listener_config.host = "127.0.0.1";
+	listener_config.port = 0;
+	listener_config.queue_depth = 256;
+	listener_config.buffer_count = 64;
+	listener_config.buffer_size = 4096;
+
+	handoff_config config;
+	config.path = make_socket_path("uring");
+
+	auto old_listener = std::make_unique<io_uring_listener>(listener_config);
+	auto* old_uring = old_listener.get();
+	auto old_process = std::make_unique<echo_process>("old", std::move(old_listener));
+	ASSERT_TRUE(old_process->listener().start().is_ok());
+	uint16_t port = old_uring->bound_port();
+	ASSERT_NE(port, 0);
+
+	std::atomic<bool> completed{false};
+	auto server = serve_handoff(config, old_process->listener(), completed);
+	ASSERT_TRUE(server->start().is_ok());
+
+	int idle = connect_tcp(port);
+	ASSERT_GE(idle, 0);
+	EXPECT_EQ(round_trip(idle, "one"), "old:one");
+
+	handoff_client client(config);
+	auto listeners = client.receive_listeners();
+	ASSERT_TRUE(listeners.is_ok()) << listeners.error().message;
+	ASSERT_EQ(listeners.value().size(), 1u);
+	EXPECT_EQ(listeners.value()[0].transport, "io_uring");
+
+	auto new_listener = std::make_unique<io_uring_listener>(listener_config);
+	auto* new_uring = new_listener.get();
+	auto new_process = std::make_unique<echo_process>("new", std::move(new_listener));
+	ASSERT_TRUE(new_process->listener().adopt_listen_fd(listeners.value()[0].fd));
+	ASSERT_TRUE(new_process->listener().start().is_ok());
+	EXPECT_EQ(new_uring->bound_port(), port);
+
+	auto connections = client.confirm_listening();
+	ASSERT_TRUE(connections.is_ok()) << connections.error().message;
+	ASSERT_EQ(connections.value().size(), 1u);
+	ASSERT_TRUE(new_process->listener().adopt_connection(connections.value()[0].fd).is_ok());
+	ASSERT_TRUE(wait_until([&] { return completed.load(); }));
+
+	EXPECT_EQ(round_trip(idle, "two"), "new:two");
+
+	server->stop();
+	old_process.reset();
+
+	int fresh = connect_tcp(port);
+	ASSERT_GE(fresh, 0);
+	EXPECT_EQ(round_trip(fresh, "three"), "new:three");
+
+	::close(idle);
+	::close(fresh);
+	::unlink(config.path.c_str());
+}
+
+#endif // !defined(_WIN32)
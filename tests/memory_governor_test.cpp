@@ -0,0 +1,363 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file memory_governor_test.cpp
+ * @brief Unit tests for the global memory budget
+ *
+ * Tests cover:
+ * - Reservations, optional charges and per-subsystem usage
+ * - Reclaiming cache memory when a reservation does not fit
+ * - Shedding large queries under pressure
+ * - Query cache and upload store accounting
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <kcenon/database_server/gateway/blob_upload.h>
+#include <kcenon/database_server/gateway/memory_governor.h>
+#include <kcenon/database_server/gateway/query_cache.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+memory_governor_config make_config(size_t budget)
+{
+	memory_governor_config config;
+	config.budget_bytes = budget;
+	config.pressure_ratio = 0.5;
+	config.large_query_rows = 100;
+	return config;
+}
+
+query_response make_response(size_t payload_bytes)
+{
+	query_response response(1);
+	result_row row;
+	row.cells.emplace_back(std::string(payload_bytes, 'x'));
+	response.rows.push_back(std::move(row));
+	return response;
+}
+
+blob_chunk make_chunk(const std::string& id, size_t size, bool last = false)
+{
+	blob_chunk chunk;
+	chunk.upload_id = id;
+	chunk.offset = 0;
+	chunk.data.assign(size, 0x5a);
+	chunk.last = last;
+	return chunk;
+}
+
+} // namespace
+
+// ============================================================================
+// memory_governor
+// ============================================================================
+
+TEST(MemoryGovernorTest, ReservationIsReleasedOnDestruction)
+{
+	memory_governor governor(make_config(1000));
+
+	{
+		auto reservation = governor.reserve(memory_subsystem::results, 300);
+		ASSERT_TRUE(reservation.is_ok());
+		EXPECT_EQ(reservation.value().size(), 300u);
+		EXPECT_EQ(governor.usage(memory_subsystem::results), 300u);
+		EXPECT_EQ(governor.total_usage(), 300u);
+	}
+
+	EXPECT_EQ(governor.usage(memory_subsystem::results), 0u);
+	EXPECT_EQ(governor.total_usage(), 0u);
+}
+
+TEST(MemoryGovernorTest, MovedReservationReleasesOnce)
+{
+	memory_governor governor(make_config(1000));
+
+	auto reserved = governor.reserve(memory_subsystem::results, 200);
+	ASSERT_TRUE(reserved.is_ok());
+	memory_reservation reservation = std::move(reserved.value());
+	memory_reservation moved = std::move(reservation);
+	EXPECT_EQ(governor.usage(memory_subsystem::results), 200u);
+
+	moved.release();
+	moved.release();
+	EXPECT_EQ(governor.total_usage(), 0u);
+}
+
+TEST(MemoryGovernorTest, DeniesReservationOverBudget)
+{
+	memory_governor governor(make_config(1000));
+
+	auto first = governor.reserve(memory_subsystem::results, 800);
+	ASSERT_TRUE(first.is_ok());
+
+	auto second = governor.reserve(memory_subsystem::results, 300);
+	EXPECT_TRUE(second.is_err());
+	EXPECT_EQ(governor.metrics().reservations_denied.load(), 1u);
+	EXPECT_EQ(governor.total_usage(), 800u);
+}
+
+TEST(MemoryGovernorTest, ZeroBudgetOnlyAccounts)
+{
+	memory_governor governor(make_config(0));
+
+	auto reservation = governor.reserve(memory_subsystem::results, 1ull << 40);
+	EXPECT_TRUE(reservation.is_ok());
+	EXPECT_TRUE(governor.try_charge(memory_subsystem::cache, 1ull << 40));
+	EXPECT_FALSE(governor.under_pressure());
+	EXPECT_EQ(governor.usage(memory_subsystem::cache), 1ull << 40);
+
+	governor.release(memory_subsystem::cache, 1ull << 40);
+}
+
+TEST(MemoryGovernorTest, OptionalChargeStopsAtWatermark)
+{
+	memory_governor governor(make_config(1000));
+
+	EXPECT_TRUE(governor.try_charge(memory_subsystem::cache, 400));
+	EXPECT_FALSE(governor.try_charge(memory_subsystem::cache, 200));
+	EXPECT_EQ(governor.metrics().charges_denied.load(), 1u);
+	EXPECT_EQ(governor.usage(memory_subsystem::cache), 400u);
+
+	governor.release(memory_subsystem::cache, 400);
+	EXPECT_EQ(governor.total_usage(), 0u);
+}
+
+TEST(MemoryGovernorTest, ReclaimsToFitReservation)
+{
+	memory_governor governor(make_config(1000));
+	governor.charge(memory_subsystem::cache, 900);
+
+	size_t requested = 0;
+	governor.set_reclaimer(memory_subsystem::cache,
+						   [&](size_t bytes)
+						   {
+							   requested += bytes;
+							   size_t freed = std::min<size_t>(bytes, governor.usage(
+								   memory_subsystem::cache));
+							   governor.release(memory_subsystem::cache, freed);
+							   return freed;
+						   });
+
+	auto reservation = governor.reserve(memory_subsystem::results, 400);
+	ASSERT_TRUE(reservation.is_ok());
+	EXPECT_GT(requested, 0u);
+
+	// The cache is shrunk back below the watermark, not only to fit
+	EXPECT_LE(governor.total_usage(), 500u);
+	EXPECT_EQ(governor.usage(memory_subsystem::results), 400u);
+	EXPECT_GE(governor.metrics().bytes_reclaimed.load(), 300u);
+
+	governor.set_reclaimer(memory_subsystem::cache, nullptr);
+}
+
+TEST(MemoryGovernorTest, ShedsLargeQueriesUnderPressure)
+{
+	memory_governor governor(make_config(1000));
+
+	query_request unbounded("SELECT * FROM events", query_type::select);
+	query_request bounded("SELECT * FROM events", query_type::select);
+	bounded.options.max_rows = 50;
+	query_request write("INSERT INTO events VALUES (1)", query_type::insert);
+
+	EXPECT_FALSE(governor.should_shed(unbounded));
+
+	governor.charge(memory_subsystem::results, 600);
+	ASSERT_TRUE(governor.under_pressure());
+	EXPECT_TRUE(governor.should_shed(unbounded));
+	EXPECT_FALSE(governor.should_shed(bounded));
+	EXPECT_FALSE(governor.should_shed(write));
+	EXPECT_EQ(governor.metrics().queries_shed.load(), 1u);
+
+	governor.release(memory_subsystem::results, 600);
+	EXPECT_FALSE(governor.should_shed(unbounded));
+}
+
+TEST(MemoryGovernorTest, ReservationResizesToActualSize)
+{
+	memory_governor governor(make_config(1000));
+
+	auto reserved = governor.reserve(memory_subsystem::results, 300);
+	ASSERT_TRUE(reserved.is_ok());
+	auto& reservation = reserved.value();
+
+	EXPECT_TRUE(reservation.resize(100));
+	EXPECT_EQ(reservation.size(), 100u);
+	EXPECT_EQ(governor.usage(memory_subsystem::results), 100u);
+
+	EXPECT_TRUE(reservation.resize(900));
+	EXPECT_EQ(governor.total_usage(), 900u);
+
+	// Growing past the budget keeps the current size
+	EXPECT_FALSE(reservation.resize(1200));
+	EXPECT_EQ(reservation.size(), 900u);
+	EXPECT_EQ(governor.total_usage(), 900u);
+
+	reservation.release();
+	EXPECT_EQ(governor.total_usage(), 0u);
+}
+
+TEST(MemoryGovernorTest, EstimatesResultsFromRowLimit)
+{
+	auto config = make_config(1000);
+	config.result_row_bytes = 10;
+	memory_governor governor(config);
+
+	query_request unbounded("SELECT * FROM events", query_type::select);
+	query_request bounded("SELECT * FROM events", query_type::select);
+	bounded.options.max_rows = 5;
+	query_request write("INSERT INTO events VALUES (1)", query_type::insert);
+
+	EXPECT_EQ(governor.estimate_result(unbounded), sizeof(query_response) + 100 * 10);
+	EXPECT_EQ(governor.estimate_result(bounded), sizeof(query_response) + 5 * 10);
+	EXPECT_EQ(governor.estimate_result(write), sizeof(query_response));
+}
+
+// ============================================================================
+// Subsystem integration
+// ============================================================================
+
+TEST(MemoryGovernorCacheTest, CacheChargesAndReleasesEntries)
+{
+	auto governor = std::make_shared<memory_governor>(make_config(1 << 20));
+	cache_config config;
+	config.enabled = true;
+	query_cache cache(config);
+	cache.set_memory_governor(governor);
+
+	auto response = make_response(1000);
+	ASSERT_TRUE(cache.put("a", response).is_ok());
+	EXPECT_EQ(governor->usage(memory_subsystem::cache), query_cache::estimate_size(response));
+	EXPECT_EQ(cache.memory_usage(), query_cache::estimate_size(response));
+
+	ASSERT_TRUE(cache.invalidate_key("a").is_ok());
+	EXPECT_EQ(governor->usage(memory_subsystem::cache), 0u);
+
+	ASSERT_TRUE(cache.put("b", response).is_ok());
+	cache.clear();
+	EXPECT_EQ(governor->total_usage(), 0u);
+}
+
+TEST(MemoryGovernorCacheTest, CacheSkipsEntriesUnderPressure)
+{
+	auto governor = std::make_shared<memory_governor>(make_config(100000));
+	cache_config config;
+	config.enabled = true;
+	query_cache cache(config);
+	cache.set_memory_governor(governor);
+
+	auto reservation = governor->reserve(memory_subsystem::results, 49000);
+	ASSERT_TRUE(reservation.is_ok());
+
+	EXPECT_TRUE(cache.put("a", make_response(2000)).is_err());
+	EXPECT_EQ(cache.metrics().skipped_memory_pressure.load(), 1u);
+	EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(MemoryGovernorCacheTest, ReservationEvictsCacheEntries)
+{
+	auto governor = std::make_shared<memory_governor>(make_config(100000));
+	cache_config config;
+	config.enabled = true;
+	query_cache cache(config);
+	cache.set_memory_governor(governor);
+
+	for (int i = 0; i < 20; ++i)
+	{
+		ASSERT_TRUE(cache.put("key" + std::to_string(i), make_response(2000)).is_ok());
+	}
+	auto cached = cache.memory_usage();
+	ASSERT_GT(cached, 40000u);
+
+	auto reservation = governor->reserve(memory_subsystem::results, 30000);
+	ASSERT_TRUE(reservation.is_ok());
+	EXPECT_LT(cache.memory_usage(), cached);
+	EXPECT_LE(governor->total_usage(), 50000u);
+
+	// Least recently used entries go first
+	EXPECT_TRUE(cache.get("key0").is_err());
+	EXPECT_TRUE(cache.get("key19").is_ok());
+}
+
+TEST(MemoryGovernorCacheTest, AttachingChargesExistingEntries)
+{
+	auto governor = std::make_shared<memory_governor>(make_config(1 << 20));
+	{
+		cache_config config;
+		config.enabled = true;
+		query_cache cache(config);
+		ASSERT_TRUE(cache.put("a", make_response(1000)).is_ok());
+
+		cache.set_memory_governor(governor);
+		EXPECT_EQ(governor->usage(memory_subsystem::cache), cache.memory_usage());
+	}
+	EXPECT_EQ(governor->total_usage(), 0u);
+}
+
+TEST(MemoryGovernorUploadTest, UploadsAreChargedAsSessionState)
+{
+	auto governor = std::make_shared<memory_governor>(make_config(1 << 20));
+	blob_upload_store store;
+	store.set_memory_governor(governor);
+
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 1000)).is_ok());
+	EXPECT_EQ(governor->usage(memory_subsystem::sessions), 1000u);
+
+	store.remove_session("s1");
+	EXPECT_EQ(governor->usage(memory_subsystem::sessions), 0u);
+}
+
+TEST(MemoryGovernorUploadTest, UploadsSpillUnderPressure)
+{
+	auto governor = std::make_shared<memory_governor>(make_config(10000));
+	blob_upload_store store;
+	store.set_memory_governor(governor);
+
+	governor->charge(memory_subsystem::results, 6000);
+	ASSERT_TRUE(store.append("s1", make_chunk("photo", 1000, true)).is_ok());
+	EXPECT_EQ(governor->usage(memory_subsystem::sessions), 0u);
+	EXPECT_EQ(store.metrics().uploads_spilled.load(), 1u);
+
+	auto content = store.take("s1", "photo");
+	ASSERT_TRUE(content.is_ok());
+	EXPECT_TRUE(content.value()->is_spilled());
+	EXPECT_EQ(content.value()->size(), 1000u);
+
+	governor->release(memory_subsystem::results, 6000);
+}
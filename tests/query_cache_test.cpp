@@ -46,6 +46,7 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <string>
 #include <thread>
 #include <vector>
 
@@ -370,6 +371,48 @@ TEST_F(CacheInvalidationTest, InvalidateNonexistentTableNoOp)
 	EXPECT_TRUE(cache.get("key1").is_ok());
 }
 
+TEST_F(CacheInvalidationTest, ListenerReceivesRemovedKeys)
+{
+	query_cache cache(config_);
+
+	std::vector<std::pair<std::string, std::vector<std::string>>> notifications;
+	cache.set_invalidation_listener(
+		[&notifications](const std::string& table, const std::vector<std::string>& keys)
+		{ notifications.emplace_back(table, keys); });
+
+	query_response response(1);
+	(void)cache.put("key1", response, {"users"});
+	(void)cache.put("key2", response, {"orders"});
+
+	(void)cache.invalidate("users");
+	(void)cache.invalidate_key("key2");
+	cache.clear();
+
+	ASSERT_EQ(notifications.size(), 3);
+	EXPECT_EQ(notifications[0].first, "users");
+	EXPECT_EQ(notifications[0].second, std::vector<std::string>{"key1"});
+	EXPECT_EQ(notifications[1].first, "");
+	EXPECT_EQ(notifications[1].second, std::vector<std::string>{"key2"});
+	EXPECT_EQ(notifications[2].first, "");
+	EXPECT_TRUE(notifications[2].second.empty());
+}
+
+TEST_F(CacheInvalidationTest, ListenerNotifiedWhenNothingCached)
+{
+	config_.enabled = false;
+	query_cache cache(config_);
+
+	std::vector<std::string> tables;
+	cache.set_invalidation_listener(
+		[&tables](const std::string& table, const std::vector<std::string>&)
+		{ tables.push_back(table); });
+
+	(void)cache.invalidate("users");
+
+	ASSERT_EQ(tables.size(), 1);
+	EXPECT_EQ(tables[0], "users");
+}
+
 // ============================================================================
 // Cache Key Generation Tests
 // ============================================================================
@@ -39,15 +39,22 @@
  * - Query request creation and validation
  * - Query response creation
  * - Serialization/deserialization round-trips (when container_system available)
+ * - Compact binary (v2) wire format round-trips and malformed frames
+ * - Columnar result layout (dictionary, delta, null bitmaps)
+ * - Zero-copy request views over v2 frames
+ * - Multi-request batch frames
  */
 
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <limits>
 #include <thread>
 
 #include <kcenon/database_server/gateway/query_protocol.h>
 #include <kcenon/database_server/gateway/query_types.h>
+#include <kcenon/database_server/gateway/request_view.h>
+#include <kcenon/database_server/gateway/wire_format.h>
 
 #include <kcenon/common/config/feature_flags.h>
 
@@ -113,6 +120,13 @@ TEST_F(QueryTypesTest, ParseQueryTypeLowercase)
 	EXPECT_EQ(parse_query_type("ping"), query_type::ping);
 }
 
+TEST_F(QueryTypesTest, UploadChunkNames)
+{
+	EXPECT_EQ(to_string(query_type::upload_chunk), "UPLOAD_CHUNK");
+	EXPECT_EQ(parse_query_type("UPLOAD_CHUNK"), query_type::upload_chunk);
+	EXPECT_EQ(parse_query_type("upload_chunk"), query_type::upload_chunk);
+}
+
 TEST_F(QueryTypesTest, ParseQueryTypeUnknown)
 {
 	EXPECT_EQ(parse_query_type("INVALID"), query_type::unknown);
@@ -350,6 +364,18 @@ TEST_F(QueryRequestTest, IsValidPingWithEmptySql)
 	EXPECT_TRUE(request.is_valid());
 }
 
+TEST_F(QueryRequestTest, IsValidUploadChunkRequiresChunk)
+{
+	query_request request("", query_type::upload_chunk);
+	EXPECT_FALSE(request.is_valid());
+
+	request.chunk = blob_chunk{};
+	EXPECT_FALSE(request.is_valid());
+
+	request.chunk->upload_id = "photo";
+	EXPECT_TRUE(request.is_valid());
+}
+
 TEST_F(QueryRequestTest, DefaultOptions)
 {
 	query_request request;
@@ -451,6 +477,76 @@ TEST_F(QueryRequestTest, SerializeWithAllParamTypes)
 			  (std::vector<uint8_t>{ 0x01, 0x02, 0x03 }));
 }
 
+TEST_F(QueryRequestTest, SerializeUploadChunkRoundTrip)
+{
+	query_request original("", query_type::upload_chunk);
+	original.header.message_id = 7;
+	original.chunk = blob_chunk{ "photo", 4096, { 0xde, 0xad, 0xbe, 0xef }, true };
+
+	auto result = query_request::deserialize(original.serialize());
+	ASSERT_TRUE(result.is_ok());
+
+	const auto& deserialized = result.value();
+	EXPECT_EQ(deserialized.type, query_type::upload_chunk);
+	ASSERT_TRUE(deserialized.chunk.has_value());
+	EXPECT_EQ(deserialized.chunk->upload_id, "photo");
+	EXPECT_EQ(deserialized.chunk->offset, 4096u);
+	EXPECT_EQ(deserialized.chunk->data, (std::vector<uint8_t>{ 0xde, 0xad, 0xbe, 0xef }));
+	EXPECT_TRUE(deserialized.chunk->last);
+	EXPECT_TRUE(deserialized.is_valid());
+}
+
+TEST_F(QueryRequestTest, SerializeAllScalarFieldsRoundTrip)
+{
+	query_request original("SELECT * FROM orders", query_type::select);
+	original.header.message_id = 99;
+	original.header.timestamp = 1700000000000ULL;
+	original.token.expires_at = 1800000000000ULL;
+	original.options.isolation_level = "SERIALIZABLE";
+	original.options.max_rows = 500;
+	original.options.include_metadata = false;
+	original.options.delta_key_column = "id";
+	original.options.delta_base_version = 17;
+
+	auto result = query_request::deserialize(original.serialize());
+	ASSERT_TRUE(result.is_ok());
+
+	const auto& deserialized = result.value();
+	EXPECT_EQ(deserialized.header.version, original.header.version);
+	EXPECT_EQ(deserialized.header.timestamp, original.header.timestamp);
+	EXPECT_EQ(deserialized.token.expires_at, original.token.expires_at);
+	EXPECT_EQ(deserialized.options.isolation_level, "SERIALIZABLE");
+	EXPECT_EQ(deserialized.options.max_rows, 500u);
+	EXPECT_FALSE(deserialized.options.include_metadata);
+	EXPECT_EQ(deserialized.options.delta_key_column, "id");
+	EXPECT_EQ(deserialized.options.delta_base_version, 17u);
+	EXPECT_FALSE(deserialized.chunk.has_value());
+
+	// The base version is only sent along with a delta key column
+	original.options.delta_key_column.clear();
+	auto plain = query_request::deserialize(original.serialize());
+	ASSERT_TRUE(plain.is_ok());
+	EXPECT_TRUE(plain.value().options.delta_key_column.empty());
+	EXPECT_EQ(plain.value().options.delta_base_version, 0u);
+}
+
+TEST_F(QueryRequestTest, SerializeBlobRefParam)
+{
+	query_request original("INSERT INTO photos (data) VALUES (?)", query_type::insert);
+	original.params.emplace_back("data", blob_ref{ "photo", nullptr });
+
+	auto result = query_request::deserialize(original.serialize());
+	ASSERT_TRUE(result.is_ok());
+
+	const auto& deserialized = result.value();
+	ASSERT_EQ(deserialized.params.size(), 1u);
+	ASSERT_TRUE(std::holds_alternative<blob_ref>(deserialized.params[0].value));
+	const auto& ref = std::get<blob_ref>(deserialized.params[0].value);
+	EXPECT_EQ(ref.upload_id, "photo");
+	EXPECT_EQ(ref.content, nullptr);
+	EXPECT_FALSE(deserialized.chunk.has_value());
+}
+
 #endif // KCENON_WITH_CONTAINER_SYSTEM
 
 // ============================================================================
@@ -666,6 +762,40 @@ TEST_F(QueryResponseTest, SerializeWithAllCellTypes)
 			  (std::vector<uint8_t>{ 0xDE, 0xAD, 0xBE, 0xEF }));
 }
 
+TEST_F(QueryResponseTest, SerializeDeltaRoundTrip)
+{
+	query_response original(7);
+	original.result_version = 12;
+
+	column_metadata col;
+	col.name = "id";
+	original.columns.push_back(col);
+
+	result_delta delta;
+	delta.base_version = 11;
+	result_row inserted;
+	inserted.cells.emplace_back(static_cast<int64_t>(5));
+	delta.inserted.push_back(inserted);
+	delta.deleted_keys.emplace_back(static_cast<int64_t>(3));
+	original.delta = delta;
+
+	auto container = original.serialize();
+	ASSERT_NE(container, nullptr);
+
+	auto result = query_response::deserialize(container);
+	ASSERT_TRUE(result.is_ok());
+
+	const auto& deserialized = result.value();
+	EXPECT_EQ(deserialized.result_version, 12);
+	ASSERT_TRUE(deserialized.delta.has_value());
+	EXPECT_EQ(deserialized.delta->base_version, 11);
+	ASSERT_EQ(deserialized.delta->inserted.size(), 1);
+	EXPECT_EQ(std::get<int64_t>(deserialized.delta->inserted[0].cells[0]), 5);
+	EXPECT_TRUE(deserialized.delta->updated.empty());
+	ASSERT_EQ(deserialized.delta->deleted_keys.size(), 1);
+	EXPECT_EQ(std::get<int64_t>(deserialized.delta->deleted_keys[0]), 3);
+}
+
 #endif // KCENON_WITH_CONTAINER_SYSTEM
 
 // ============================================================================
@@ -744,3 +874,685 @@ TEST_F(ColumnMetadataTest, NumericColumn)
 	EXPECT_EQ(col.precision, 10);
 	EXPECT_EQ(col.scale, 2);
 }
+
+// ============================================================================
+// Wire Protocol v2 Tests
+// ============================================================================
+
+class WireFormatV2Test : public ::testing::Test
+{
+protected:
+	static query_request make_request()
+	{
+		query_request request("SELECT * FROM t WHERE a = $1", query_type::select);
+		request.header.message_id = 300;
+		request.header.timestamp = 1700000000123ULL;
+		request.header.correlation_id = "corr-1";
+		request.token.token = "jwt.token.value";
+		request.token.client_id = "client-7";
+		request.token.expires_at = 1800000000000ULL;
+		request.params.emplace_back("null", std::monostate{});
+		request.params.emplace_back("flag", true);
+		request.params.emplace_back("neg", int64_t{ -123456789012 });
+		request.params.emplace_back("pi", 3.14159);
+		request.params.emplace_back("name", std::string("alice"));
+		request.params.emplace_back("raw", std::vector<uint8_t>{ 0, 1, 255 });
+		request.params.emplace_back("blob", blob_ref{ "upload-1", nullptr });
+		request.options.timeout_ms = 1500;
+		request.options.read_only = true;
+		request.options.include_metadata = false;
+		request.options.isolation_level = "SERIALIZABLE";
+		request.options.max_rows = 50;
+		request.options.delta_key_column = "id";
+		request.options.delta_base_version = 9;
+		return request;
+	}
+
+	static query_response make_response()
+	{
+		query_response response(300);
+		response.header.correlation_id = "corr-1";
+		response.affected_rows = 2;
+		response.execution_time_us = 777;
+		response.result_version = 10;
+
+		column_metadata id;
+		id.name = "id";
+		id.type_name = "BIGINT";
+		id.type_id = 20;
+		id.nullable = false;
+		column_metadata price;
+		price.name = "price";
+		price.type_name = "NUMERIC";
+		price.precision = 10;
+		price.scale = 2;
+		response.columns = { id, price };
+
+		result_row row;
+		row.cells = { int64_t{ 1 }, 9.5, std::string("x"), std::vector<uint8_t>{ 7, 8 },
+					  std::monostate{}, false };
+		response.rows.push_back(row);
+		response.rows.push_back(result_row{});
+		return response;
+	}
+};
+
+TEST_F(WireFormatV2Test, RequestRoundTrip)
+{
+	auto original = make_request();
+	auto frame = encode_wire_v2(original);
+	ASSERT_TRUE(is_wire_v2(frame));
+
+	auto result = decode_request_v2(frame);
+	ASSERT_TRUE(result.is_ok()) << result.error().message;
+	const auto& decoded = result.value();
+
+	EXPECT_EQ(decoded.header.version, wire_version_v2);
+	EXPECT_EQ(decoded.header.message_id, 300);
+	EXPECT_EQ(decoded.header.timestamp, 1700000000123ULL);
+	EXPECT_EQ(decoded.header.correlation_id, "corr-1");
+	EXPECT_EQ(decoded.token.token, "jwt.token.value");
+	EXPECT_EQ(decoded.token.client_id, "client-7");
+	EXPECT_EQ(decoded.token.expires_at, 1800000000000ULL);
+	EXPECT_EQ(decoded.type, query_type::select);
+	EXPECT_EQ(decoded.sql, original.sql);
+
+	ASSERT_EQ(decoded.params.size(), original.params.size());
+	EXPECT_TRUE(std::holds_alternative<std::monostate>(decoded.params[0].value));
+	EXPECT_EQ(std::get<bool>(decoded.params[1].value), true);
+	EXPECT_EQ(std::get<int64_t>(decoded.params[2].value), -123456789012);
+	EXPECT_DOUBLE_EQ(std::get<double>(decoded.params[3].value), 3.14159);
+	EXPECT_EQ(std::get<std::string>(decoded.params[4].value), "alice");
+	EXPECT_EQ(std::get<std::vector<uint8_t>>(decoded.params[5].value),
+			  (std::vector<uint8_t>{ 0, 1, 255 }));
+	EXPECT_EQ(std::get<blob_ref>(decoded.params[6].value).upload_id, "upload-1");
+	EXPECT_EQ(decoded.params[4].name, "name");
+
+	EXPECT_EQ(decoded.options.timeout_ms, 1500);
+	EXPECT_TRUE(decoded.options.read_only);
+	EXPECT_FALSE(decoded.options.include_metadata);
+	EXPECT_EQ(decoded.options.isolation_level, "SERIALIZABLE");
+	EXPECT_EQ(decoded.options.max_rows, 50);
+	EXPECT_EQ(decoded.options.delta_key_column, "id");
+	EXPECT_EQ(decoded.options.delta_base_version, 9);
+	EXPECT_FALSE(decoded.chunk.has_value());
+}
+
+TEST_F(WireFormatV2Test, UploadChunkRoundTrip)
+{
+	query_request request;
+	request.type = query_type::upload_chunk;
+	request.chunk = blob_chunk{ "upload-2", 4096, std::vector<uint8_t>(300, 0xab), true };
+
+	auto result = decode_request_v2(encode_wire_v2(request));
+	ASSERT_TRUE(result.is_ok());
+	ASSERT_TRUE(result.value().chunk.has_value());
+	EXPECT_EQ(result.value().chunk->upload_id, "upload-2");
+	EXPECT_EQ(result.value().chunk->offset, 4096);
+	EXPECT_EQ(result.value().chunk->data, std::vector<uint8_t>(300, 0xab));
+	EXPECT_TRUE(result.value().chunk->last);
+}
+
+TEST_F(WireFormatV2Test, ResponseRoundTrip)
+{
+	auto original = make_response();
+	auto result = decode_response_v2(encode_wire_v2(original));
+	ASSERT_TRUE(result.is_ok()) << result.error().message;
+	const auto& decoded = result.value();
+
+	EXPECT_EQ(decoded.header.version, wire_version_v2);
+	EXPECT_EQ(decoded.header.message_id, 300);
+	EXPECT_EQ(decoded.status, status_code::ok);
+	EXPECT_EQ(decoded.affected_rows, 2);
+	EXPECT_EQ(decoded.execution_time_us, 777);
+	EXPECT_EQ(decoded.result_version, 10);
+
+	ASSERT_EQ(decoded.columns.size(), 2);
+	EXPECT_EQ(decoded.columns[0].name, "id");
+	EXPECT_EQ(decoded.columns[0].type_id, 20);
+	EXPECT_FALSE(decoded.columns[0].nullable);
+	EXPECT_EQ(decoded.columns[1].precision, 10);
+	EXPECT_EQ(decoded.columns[1].scale, 2);
+
+	ASSERT_EQ(decoded.rows.size(), 2);
+	EXPECT_EQ(decoded.rows[0].cells, original.rows[0].cells);
+	EXPECT_TRUE(decoded.rows[1].cells.empty());
+	EXPECT_FALSE(decoded.delta.has_value());
+}
+
+TEST_F(WireFormatV2Test, ErrorResponseRoundTrip)
+{
+	query_response original(42, status_code::server_busy, "Server overloaded");
+
+	auto result = decode_response_v2(encode_wire_v2(original));
+	ASSERT_TRUE(result.is_ok());
+	EXPECT_EQ(result.value().status, status_code::server_busy);
+	EXPECT_EQ(result.value().error_message, "Server overloaded");
+	EXPECT_TRUE(result.value().rows.empty());
+}
+
+TEST_F(WireFormatV2Test, DeltaRoundTrip)
+{
+	query_response original(5);
+	original.result_version = 3;
+	result_delta delta;
+	delta.base_version = 2;
+	delta.inserted.push_back(result_row{ { int64_t{ 4 }, std::string("new") } });
+	delta.updated.push_back(result_row{ { int64_t{ 1 }, std::string("changed") } });
+	delta.deleted_keys = { int64_t{ 2 }, std::string("k") };
+	original.delta = delta;
+
+	auto result = decode_response_v2(encode_wire_v2(original));
+	ASSERT_TRUE(result.is_ok());
+	ASSERT_TRUE(result.value().delta.has_value());
+	const auto& decoded = *result.value().delta;
+	EXPECT_EQ(decoded.base_version, 2);
+	ASSERT_EQ(decoded.inserted.size(), 1);
+	EXPECT_EQ(decoded.inserted[0].cells, delta.inserted[0].cells);
+	ASSERT_EQ(decoded.updated.size(), 1);
+	EXPECT_EQ(decoded.updated[0].cells, delta.updated[0].cells);
+	EXPECT_EQ(decoded.deleted_keys, delta.deleted_keys);
+}
+
+TEST_F(WireFormatV2Test, EventRoundTrip)
+{
+	invalidation_event original;
+	original.header.correlation_id = "sub-1";
+	original.sequence = 300;
+	original.tables = { "users", "orders" };
+	original.cache_keys = { "k1" };
+	original.resync = true;
+
+	auto frame = encode_wire_v2(original);
+	EXPECT_EQ(wire_v2_kind(frame), wire_message_kind::event);
+
+	auto result = invalidation_event::deserialize(frame);
+	ASSERT_TRUE(result.is_ok());
+	EXPECT_EQ(result.value().header.version, wire_version_v2);
+	EXPECT_EQ(result.value().header.correlation_id, "sub-1");
+	EXPECT_EQ(result.value().sequence, 300u);
+	EXPECT_EQ(result.value().tables, original.tables);
+	EXPECT_EQ(result.value().cache_keys, original.cache_keys);
+	EXPECT_TRUE(result.value().resync);
+
+	// An event frame is neither a request nor a response
+	EXPECT_TRUE(decode_request_v2(frame).is_err());
+	EXPECT_TRUE(decode_response_v2(frame).is_err());
+	for (size_t size = 0; size < frame.size(); ++size)
+	{
+		std::span<const uint8_t> prefix(frame.data(), size);
+		EXPECT_TRUE(decode_event_v2(prefix).is_err()) << size;
+	}
+}
+
+TEST_F(WireFormatV2Test, VarintBoundaries)
+{
+	query_request request("SELECT 1", query_type::select);
+	for (uint64_t id : { uint64_t{ 0 }, uint64_t{ 127 }, uint64_t{ 128 }, uint64_t{ 16383 },
+						 uint64_t{ 16384 }, std::numeric_limits<uint64_t>::max() })
+	{
+		request.header.message_id = id;
+		request.params = { query_param("v", static_cast<int64_t>(id)) };
+
+		auto result = decode_request_v2(encode_wire_v2(request));
+		ASSERT_TRUE(result.is_ok()) << id;
+		EXPECT_EQ(result.value().header.message_id, id);
+		EXPECT_EQ(std::get<int64_t>(result.value().params[0].value), static_cast<int64_t>(id));
+	}
+
+	request.params = { query_param("min", std::numeric_limits<int64_t>::min()) };
+	auto result = decode_request_v2(encode_wire_v2(request));
+	ASSERT_TRUE(result.is_ok());
+	EXPECT_EQ(std::get<int64_t>(result.value().params[0].value),
+			  std::numeric_limits<int64_t>::min());
+}
+
+TEST_F(WireFormatV2Test, RejectsTruncatedFrames)
+{
+	auto request_frame = encode_wire_v2(make_request());
+	for (size_t size = 0; size < request_frame.size(); ++size)
+	{
+		std::span<const uint8_t> prefix(request_frame.data(), size);
+		EXPECT_TRUE(decode_request_v2(prefix).is_err()) << size;
+	}
+
+	auto response_frame = encode_wire_v2(make_response());
+	for (size_t size = 0; size < response_frame.size(); ++size)
+	{
+		std::span<const uint8_t> prefix(response_frame.data(), size);
+		EXPECT_TRUE(decode_response_v2(prefix).is_err()) << size;
+	}
+}
+
+TEST_F(WireFormatV2Test, RejectsMalformedFrames)
+{
+	auto frame = encode_wire_v2(make_request());
+
+	auto trailing = frame;
+	trailing.push_back(0);
+	EXPECT_TRUE(decode_request_v2(trailing).is_err());
+
+	auto bad_magic = frame;
+	bad_magic[0] = 'X';
+	EXPECT_FALSE(is_wire_v2(bad_magic));
+	EXPECT_TRUE(decode_request_v2(bad_magic).is_err());
+
+	// A request frame is not a response
+	EXPECT_TRUE(decode_response_v2(frame).is_err());
+
+	// Element count far larger than the remaining input
+	std::vector<uint8_t> huge_count(wire_v2_magic.begin(), wire_v2_magic.end());
+	huge_count.insert(huge_count.end(), { 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 });
+	huge_count.insert(huge_count.end(), { 0xff, 0xff, 0xff, 0xff, 0x0f });
+	EXPECT_TRUE(decode_response_v2(huge_count).is_err());
+}
+
+TEST_F(WireFormatV2Test, DeserializeDetectsVersion)
+{
+	auto request = query_request::deserialize(encode_wire_v2(make_request()));
+	ASSERT_TRUE(request.is_ok());
+	EXPECT_EQ(request.value().header.version, wire_version_v2);
+	EXPECT_EQ(request.value().token.client_id, "client-7");
+
+	auto response = query_response::deserialize(encode_wire_v2(make_response()));
+	ASSERT_TRUE(response.is_ok());
+	EXPECT_EQ(response.value().rows.size(), 2);
+}
+
+TEST_F(WireFormatV2Test, CompactRowEncoding)
+{
+	auto response = make_response();
+	for (int i = 0; i < 100; ++i)
+	{
+		response.rows.push_back(response.rows.front());
+	}
+
+	// Each row costs a length, a count and its tagged cells only
+	auto frame = encode_wire_v2(response);
+	EXPECT_LT(frame.size(), 100 * 32);
+}
+
+// ============================================================================
+// Columnar Result Layout Tests
+// ============================================================================
+
+class ColumnarResultTest : public ::testing::Test
+{
+protected:
+	static query_response decode(const std::vector<uint8_t>& frame)
+	{
+		auto result = decode_response_v2(frame);
+		EXPECT_TRUE(result.is_ok()) << (result.is_err() ? result.error().message : "");
+		return result.is_ok() ? result.value() : query_response{};
+	}
+
+	static std::vector<uint8_t> encode(const query_response& response, wire_row_layout layout)
+	{
+		std::vector<uint8_t> frame;
+		encode_wire_v2(response, frame, layout);
+		return frame;
+	}
+
+	// id (monotonic), status (4 distinct), score (double), note (unique, some NULL),
+	// active (bool), payload (bytes), mixed types
+	static query_response make_table(size_t rows)
+	{
+		static const char* statuses[] = { "active", "pending", "closed", "archived" };
+		query_response response(1);
+		for (size_t i = 0; i < rows; ++i)
+		{
+			result_row row;
+			row.cells.push_back(int64_t{ 1000000 } + static_cast<int64_t>(i) * 3);
+			row.cells.push_back(std::string(statuses[i % 4]));
+			row.cells.push_back(static_cast<double>(i) / 7.0);
+			if (i % 5 == 0)
+			{
+				row.cells.push_back(std::monostate{});
+			}
+			else
+			{
+				row.cells.push_back("note-" + std::to_string(i));
+			}
+			row.cells.push_back(i % 3 == 0);
+			row.cells.push_back(std::vector<uint8_t>(i % 4, static_cast<uint8_t>(i)));
+			if (i % 2 == 0)
+			{
+				row.cells.push_back(static_cast<int64_t>(i));
+			}
+			else
+			{
+				row.cells.push_back(std::string("x"));
+			}
+			response.rows.push_back(std::move(row));
+		}
+		return response;
+	}
+};
+
+TEST_F(ColumnarResultTest, RoundTripMatchesRowLayout)
+{
+	auto response = make_table(200);
+	auto columnar = encode(response, wire_row_layout::columnar);
+	ASSERT_GE(columnar.size(), wire_v2_header_size);
+	EXPECT_EQ(columnar[5], wire_flag_columnar);
+
+	auto decoded = decode(columnar);
+	ASSERT_EQ(decoded.rows.size(), response.rows.size());
+	for (size_t i = 0; i < response.rows.size(); ++i)
+	{
+		EXPECT_EQ(decoded.rows[i].cells, response.rows[i].cells) << "row " << i;
+	}
+}
+
+TEST_F(ColumnarResultTest, SmallerThanRowLayoutForRepetitiveColumns)
+{
+	query_response response(1);
+	for (int64_t i = 0; i < 1000; ++i)
+	{
+		response.rows.push_back(result_row{
+			{ int64_t{ 1700000000000 } + i * 1000, std::string(i % 3 ? "ok" : "failed"),
+			  int64_t{ 5 } } });
+	}
+
+	auto rows = encode(response, wire_row_layout::rows);
+	auto columnar = encode(response, wire_row_layout::columnar);
+	EXPECT_LT(columnar.size() * 4, rows.size());
+
+	auto decoded = decode(columnar);
+	ASSERT_EQ(decoded.rows.size(), 1000);
+	EXPECT_EQ(decoded.rows[999].cells, response.rows[999].cells);
+}
+
+TEST_F(ColumnarResultTest, IntegerExtremesAndDecreasingValues)
+{
+	query_response response(1);
+	for (int64_t value : { std::numeric_limits<int64_t>::max(), int64_t{ 0 },
+						   std::numeric_limits<int64_t>::min(), int64_t{ -1 }, int64_t{ 42 } })
+	{
+		response.rows.push_back(result_row{ { value } });
+	}
+	auto decoded = decode(encode(response, wire_row_layout::columnar));
+	ASSERT_EQ(decoded.rows.size(), 5);
+	for (size_t i = 0; i < response.rows.size(); ++i)
+	{
+		EXPECT_EQ(decoded.rows[i].cells, response.rows[i].cells);
+	}
+
+	// Non-decreasing with a huge spread between neighbours
+	query_response spread(1);
+	spread.rows.push_back(result_row{ { std::numeric_limits<int64_t>::min() } });
+	spread.rows.push_back(result_row{ { std::numeric_limits<int64_t>::max() } });
+	decoded = decode(encode(spread, wire_row_layout::columnar));
+	ASSERT_EQ(decoded.rows.size(), 2);
+	EXPECT_EQ(decoded.rows[1].cells, spread.rows[1].cells);
+}
+
+TEST_F(ColumnarResultTest, AllNullColumn)
+{
+	query_response response(1);
+	for (int i = 0; i < 17; ++i)
+	{
+		response.rows.push_back(result_row{ { std::monostate{}, int64_t{ i } } });
+	}
+	auto decoded = decode(encode(response, wire_row_layout::columnar));
+	ASSERT_EQ(decoded.rows.size(), 17);
+	EXPECT_TRUE(std::holds_alternative<std::monostate>(decoded.rows[16].cells[0]));
+	EXPECT_EQ(std::get<int64_t>(decoded.rows[16].cells[1]), 16);
+}
+
+TEST_F(ColumnarResultTest, RaggedRowsFallBackToRowLayout)
+{
+	query_response response(1);
+	response.rows.push_back(result_row{ { int64_t{ 1 }, std::string("a") } });
+	response.rows.push_back(result_row{ { int64_t{ 2 } } });
+
+	auto frame = encode(response, wire_row_layout::columnar);
+	EXPECT_EQ(frame[5], 0);
+	auto decoded = decode(frame);
+	ASSERT_EQ(decoded.rows.size(), 2);
+	EXPECT_EQ(decoded.rows[1].cells.size(), 1);
+}
+
+TEST_F(ColumnarResultTest, RejectsTruncatedAndCorruptFrames)
+{
+	auto frame = encode(make_table(20), wire_row_layout::columnar);
+	for (size_t size = 0; size < frame.size(); ++size)
+	{
+		std::span<const uint8_t> prefix(frame.data(), size);
+		EXPECT_TRUE(decode_response_v2(prefix).is_err()) << size;
+	}
+
+	// Unknown frame flags
+	auto flagged = frame;
+	flagged[5] = 0x80;
+	EXPECT_TRUE(decode_response_v2(flagged).is_err());
+
+	// Request frames carry no flags
+	auto request = encode_wire_v2(query_request("SELECT 1", query_type::select));
+	request[5] = wire_flag_columnar;
+	EXPECT_TRUE(decode_request_v2(request).is_err());
+}
+
+TEST_F(ColumnarResultTest, RequestFlagRoundTrip)
+{
+	query_request request("SELECT * FROM events", query_type::select);
+	request.options.columnar = true;
+
+	auto result = decode_request_v2(encode_wire_v2(request));
+	ASSERT_TRUE(result.is_ok());
+	EXPECT_TRUE(result.value().options.columnar);
+	EXPECT_FALSE(query_options{}.columnar);
+}
+
+// ============================================================================
+// Request View Tests
+// ============================================================================
+
+class RequestViewTest : public WireFormatV2Test
+{
+protected:
+	static bool points_into(std::string_view value, const std::vector<uint8_t>& frame)
+	{
+		auto* begin = reinterpret_cast<const char*>(frame.data());
+		return value.data() >= begin && value.data() + value.size() <= begin + frame.size();
+	}
+};
+
+TEST_F(RequestViewTest, FieldsReferToFrame)
+{
+	auto frame = encode_wire_v2(make_request());
+	auto result = query_request_view::parse(frame);
+	ASSERT_TRUE(result.is_ok()) << result.error().message;
+	const auto& view = result.value();
+
+	EXPECT_EQ(view.header.message_id, 300);
+	EXPECT_EQ(view.header.correlation_id, "corr-1");
+	EXPECT_EQ(view.token.client_id, "client-7");
+	EXPECT_EQ(view.type, query_type::select);
+	EXPECT_EQ(view.sql, "SELECT * FROM t WHERE a = $1");
+	EXPECT_EQ(view.options.isolation_level, "SERIALIZABLE");
+	EXPECT_EQ(view.options.delta_base_version, 9);
+	EXPECT_TRUE(view.options.read_only);
+	EXPECT_FALSE(view.chunk.has_value());
+
+	EXPECT_TRUE(points_into(view.sql, frame));
+	EXPECT_TRUE(points_into(view.token.token, frame));
+	EXPECT_TRUE(points_into(view.options.delta_key_column, frame));
+}
+
+TEST_F(RequestViewTest, IteratesParamsLazily)
+{
+	auto frame = encode_wire_v2(make_request());
+	auto view = query_request_view::parse(frame).value();
+	ASSERT_EQ(view.params.size(), 7);
+
+	std::vector<std::string_view> names;
+	for (const auto& param : view.params)
+	{
+		names.push_back(param.name);
+	}
+	EXPECT_EQ(names, (std::vector<std::string_view>{ "null", "flag", "neg", "pi", "name", "raw",
+													 "blob" }));
+
+	auto name = view.params.find("name");
+	ASSERT_TRUE(name.has_value());
+	auto text = std::get<std::string_view>(name->value);
+	EXPECT_EQ(text, "alice");
+	EXPECT_TRUE(points_into(text, frame));
+
+	auto raw = view.params.find("raw");
+	ASSERT_TRUE(raw.has_value());
+	auto bytes = std::get<std::span<const uint8_t>>(raw->value);
+	EXPECT_EQ(std::vector<uint8_t>(bytes.begin(), bytes.end()), (std::vector<uint8_t>{ 0, 1, 255 }));
+
+	EXPECT_EQ(std::get<blob_ref_view>(view.params.find("blob")->value).upload_id, "upload-1");
+	EXPECT_EQ(std::get<int64_t>(view.params.find("neg")->value), -123456789012);
+	EXPECT_FALSE(view.params.find("missing").has_value());
+}
+
+TEST_F(RequestViewTest, ToRequestMatchesDecoder)
+{
+	auto original = make_request();
+	auto frame = encode_wire_v2(original);
+	auto request = query_request_view::parse(frame).value().to_request();
+
+	EXPECT_EQ(request.header.version, wire_version_v2);
+	EXPECT_EQ(request.sql, original.sql);
+	EXPECT_EQ(request.token.token, original.token.token);
+	ASSERT_EQ(request.params.size(), original.params.size());
+	for (size_t i = 0; i < original.params.size(); ++i)
+	{
+		EXPECT_EQ(request.params[i].name, original.params[i].name);
+		EXPECT_EQ(request.params[i].value.index(), original.params[i].value.index());
+	}
+	EXPECT_EQ(std::get<std::string>(request.params[4].value), "alice");
+	EXPECT_EQ(std::get<blob_ref>(request.params[6].value).upload_id, "upload-1");
+	EXPECT_EQ(request.options.delta_key_column, "id");
+}
+
+TEST_F(RequestViewTest, ChunkDataIsNotCopied)
+{
+	query_request request;
+	request.type = query_type::upload_chunk;
+	request.chunk = blob_chunk{ "upload-3", 10, std::vector<uint8_t>(1000, 0x5a), false };
+	auto frame = encode_wire_v2(request);
+
+	auto view = query_request_view::parse(frame).value();
+	ASSERT_TRUE(view.chunk.has_value());
+	EXPECT_EQ(view.chunk->data.size(), 1000);
+	EXPECT_GE(view.chunk->data.data(), frame.data());
+	EXPECT_LE(view.chunk->data.data() + 1000, frame.data() + frame.size());
+	EXPECT_EQ(view.to_request().chunk->data, request.chunk->data);
+}
+
+TEST_F(RequestViewTest, RejectsMalformedParams)
+{
+	query_request request("SELECT 1", query_type::select);
+	request.params.emplace_back("p", std::string("value"));
+	auto frame = encode_wire_v2(request);
+
+	// Corrupt the value tag of the only parameter
+	std::string_view bytes(reinterpret_cast<const char*>(frame.data()), frame.size());
+	auto tag_pos = bytes.find("value") - 2;
+	ASSERT_EQ(frame[tag_pos], 4);
+	frame[tag_pos] = 0x7f;
+	EXPECT_TRUE(query_request_view::parse(frame).is_err());
+}
+
+// ============================================================================
+// Batch Frame Tests
+// ============================================================================
+
+class WireBatchTest : public ::testing::Test
+{
+};
+
+TEST_F(WireBatchTest, RequestBatchRoundTrip)
+{
+	std::vector<query_request> requests;
+	for (uint64_t i = 1; i <= 3; ++i)
+	{
+		query_request request("SELECT " + std::to_string(i), query_type::select);
+		request.header.message_id = i;
+		requests.push_back(std::move(request));
+	}
+
+	auto frame = encode_request_batch_v2(requests, true);
+	EXPECT_EQ(wire_v2_kind(frame), wire_message_kind::request_batch);
+
+	auto batch = decode_wire_v2_batch(frame);
+	ASSERT_TRUE(batch.is_ok()) << batch.error().message;
+	EXPECT_EQ(batch.value().kind, wire_message_kind::request_batch);
+	EXPECT_EQ(batch.value().flags, wire_flag_sequential);
+	ASSERT_EQ(batch.value().frames.size(), 3);
+	for (size_t i = 0; i < 3; ++i)
+	{
+		auto request = decode_request_v2(batch.value().frames[i]);
+		ASSERT_TRUE(request.is_ok());
+		EXPECT_EQ(request.value().header.message_id, i + 1);
+		EXPECT_EQ(request.value().sql, requests[i].sql);
+	}
+}
+
+TEST_F(WireBatchTest, ResponseBatchRoundTrip)
+{
+	std::vector<std::vector<uint8_t>> frames;
+	frames.push_back(encode_wire_v2(query_response(1)));
+	frames.push_back(encode_wire_v2(query_response(2, status_code::rate_limited, "slow down")));
+
+	auto responses
+		= decode_response_batch_v2(encode_wire_v2_batch(wire_message_kind::response_batch, frames));
+	ASSERT_TRUE(responses.is_ok()) << responses.error().message;
+	ASSERT_EQ(responses.value().size(), 2);
+	EXPECT_EQ(responses.value()[0].header.message_id, 1);
+	EXPECT_EQ(responses.value()[1].status, status_code::rate_limited);
+	EXPECT_EQ(responses.value()[1].error_message, "slow down");
+}
+
+TEST_F(WireBatchTest, EmptyBatch)
+{
+	auto batch = decode_wire_v2_batch(encode_request_batch_v2({}));
+	ASSERT_TRUE(batch.is_ok());
+	EXPECT_TRUE(batch.value().frames.empty());
+}
+
+TEST_F(WireBatchTest, SingleFramesAreNotBatches)
+{
+	auto frame = encode_wire_v2(query_request("SELECT 1", query_type::select));
+	EXPECT_EQ(wire_v2_kind(frame), wire_message_kind::request);
+	EXPECT_TRUE(decode_wire_v2_batch(frame).is_err());
+
+	// A batch is not a single request either
+	auto batch = encode_request_batch_v2(std::vector<query_request>(1));
+	EXPECT_TRUE(decode_request_v2(batch).is_err());
+	EXPECT_TRUE(query_request::deserialize(batch).is_err());
+}
+
+TEST_F(WireBatchTest, RejectsMalformedBatches)
+{
+	std::vector<query_request> requests(2, query_request("SELECT 1", query_type::select));
+	auto frame = encode_request_batch_v2(requests);
+
+	for (size_t size = 0; size < frame.size(); ++size)
+	{
+		std::span<const uint8_t> prefix(frame.data(), size);
+		EXPECT_TRUE(decode_wire_v2_batch(prefix).is_err()) << size;
+	}
+
+	auto trailing = frame;
+	trailing.push_back(0);
+	EXPECT_TRUE(decode_wire_v2_batch(trailing).is_err());
+
+	// Response batches carry no flags
+	std::vector<std::vector<uint8_t>> frames{ encode_wire_v2(query_response(1)) };
+	auto responses = encode_wire_v2_batch(wire_message_kind::response_batch, frames);
+	responses[5] = wire_flag_sequential;
+	EXPECT_TRUE(decode_wire_v2_batch(responses).is_err());
+
+	// A request batch is not a response batch
+	EXPECT_TRUE(decode_response_batch_v2(frame).is_err());
+
+	std::vector<uint8_t> unknown_kind(wire_v2_magic.begin(), wire_v2_magic.end());
+	unknown_kind.insert(unknown_kind.end(), { 9, 0, 0 });
+	EXPECT_FALSE(wire_v2_kind(unknown_kind).has_value());
+}
@@ -35,6 +35,9 @@
  *
  * Tests cover:
  * - Sliding window algorithm correctness
+ * - GCRA limiter rate, burst, expiry and sharding
+ * - Shared-memory GCRA budget across instances and processes
+ * - Cost-based limiting: estimates, settlement and query fingerprints
  * - Burst handling
  * - Block duration behavior
  * - Concurrent access safety
@@ -43,12 +46,21 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
 #include <future>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include <kcenon/database_server/gateway/auth_middleware.h>
+#include <kcenon/database_server/gateway/cost_limiter.h>
+#include <kcenon/database_server/gateway/shared_gcra_limiter.h>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 using namespace database_server::gateway;
 
@@ -526,3 +538,569 @@ TEST_F(RateLimiterConcurrencyTest, ConcurrentDifferentClients)
 		EXPECT_GT(allowed, 0);
 	}
 }
+
+// ============================================================================
+// GCRA Limiter Tests
+// ============================================================================
+
+class GcraLimiterTest : public ::testing::Test
+{
+protected:
+	using clock = gcra_limiter::clock;
+
+	clock::time_point start_ = clock::now();
+};
+
+TEST_F(GcraLimiterTest, ParamsFromRate)
+{
+	auto params = gcra_params::from_rate(10, 5);
+
+	EXPECT_EQ(params.emission_ns, 100'000'000);
+	EXPECT_EQ(params.tolerance_ns, 400'000'000);
+	EXPECT_EQ(params.remaining(0, 1'000), 5u);
+}
+
+TEST_F(GcraLimiterTest, AllowsBurstThenRejects)
+{
+	gcra_limiter limiter(10, 5, 0);
+
+	for (int i = 0; i < 5; ++i)
+	{
+		EXPECT_TRUE(limiter.allow_request("client1", start_)) << "Request " << i;
+	}
+	EXPECT_FALSE(limiter.allow_request("client1", start_));
+	EXPECT_EQ(limiter.remaining_requests("client1", start_), 0u);
+}
+
+TEST_F(GcraLimiterTest, RefillsAtSustainedRate)
+{
+	gcra_limiter limiter(10, 5, 0);
+
+	for (int i = 0; i < 5; ++i)
+	{
+		ASSERT_TRUE(limiter.allow_request("client1", start_));
+	}
+
+	// One request every 100 ms
+	EXPECT_FALSE(limiter.allow_request("client1", start_ + std::chrono::milliseconds(99)));
+	EXPECT_TRUE(limiter.allow_request("client1", start_ + std::chrono::milliseconds(100)));
+	EXPECT_FALSE(limiter.allow_request("client1", start_ + std::chrono::milliseconds(150)));
+
+	// A full second refills the whole burst
+	EXPECT_EQ(limiter.remaining_requests("client1", start_ + std::chrono::seconds(2)), 5u);
+}
+
+TEST_F(GcraLimiterTest, RemainingDecreasesWithRequests)
+{
+	gcra_limiter limiter(10, 20, 0);
+
+	EXPECT_EQ(limiter.remaining_requests("client1", start_), 20u);
+	for (int i = 0; i < 5; ++i)
+	{
+		ASSERT_TRUE(limiter.allow_request("client1", start_));
+	}
+	EXPECT_EQ(limiter.remaining_requests("client1", start_), 15u);
+}
+
+TEST_F(GcraLimiterTest, BlocksAfterExceedingLimit)
+{
+	gcra_limiter limiter(10, 2, 1000);
+
+	ASSERT_TRUE(limiter.allow_request("client1", start_));
+	ASSERT_TRUE(limiter.allow_request("client1", start_));
+	EXPECT_FALSE(limiter.allow_request("client1", start_));
+
+	// Blocked even though the rate would admit a request again
+	auto later = start_ + std::chrono::milliseconds(500);
+	EXPECT_TRUE(limiter.is_blocked("client1", later));
+	EXPECT_FALSE(limiter.allow_request("client1", later));
+	EXPECT_GT(limiter.block_expires_at("client1"), 0u);
+
+	auto after_block = start_ + std::chrono::milliseconds(1001);
+	EXPECT_FALSE(limiter.is_blocked("client1", after_block));
+	EXPECT_TRUE(limiter.allow_request("client1", after_block));
+}
+
+TEST_F(GcraLimiterTest, ClientsAreIndependent)
+{
+	gcra_limiter limiter(10, 1, 0);
+
+	EXPECT_TRUE(limiter.allow_request("client1", start_));
+	EXPECT_FALSE(limiter.allow_request("client1", start_));
+	EXPECT_TRUE(limiter.allow_request("client2", start_));
+}
+
+TEST_F(GcraLimiterTest, CleanupDropsExpiredClients)
+{
+	gcra_limiter limiter(10, 5, 0);
+
+	ASSERT_TRUE(limiter.allow_request("client1", start_));
+	ASSERT_TRUE(limiter.allow_request("client2", start_ + std::chrono::seconds(1)));
+	EXPECT_EQ(limiter.size(), 2u);
+
+	// client1's TAT has passed, client2's has not
+	EXPECT_EQ(limiter.cleanup(start_ + std::chrono::milliseconds(1050)), 1u);
+	EXPECT_EQ(limiter.size(), 1u);
+}
+
+TEST_F(GcraLimiterTest, GrowingShardsExpireIdleClients)
+{
+	gcra_limiter limiter(1000, 1, 0);
+
+	// Enough clients for every shard to pass its sweep threshold
+	constexpr int num_clients = 100000;
+	for (int i = 0; i < num_clients; ++i)
+	{
+		ASSERT_TRUE(limiter.allow_request("client_" + std::to_string(i), start_));
+	}
+
+	// Every earlier client is idle a second later and is swept on insert
+	auto later = start_ + std::chrono::seconds(1);
+	for (int i = 0; i < num_clients; ++i)
+	{
+		ASSERT_TRUE(limiter.allow_request("other_" + std::to_string(i), later));
+	}
+	EXPECT_LT(limiter.size(), 2u * num_clients);
+}
+
+TEST_F(GcraLimiterTest, ConcurrentRequestsNeverExceedBurst)
+{
+	gcra_limiter limiter(1, 100, 0);
+
+	constexpr int num_threads = 8;
+	std::vector<std::future<int>> futures;
+	for (int t = 0; t < num_threads; ++t)
+	{
+		futures.push_back(std::async(std::launch::async,
+									 [&limiter, this]()
+									 {
+										 int allowed = 0;
+										 for (int i = 0; i < 100; ++i)
+										 {
+											 allowed += limiter.allow_request("shared", start_);
+										 }
+										 return allowed;
+									 }));
+	}
+
+	int total_allowed = 0;
+	for (auto& future : futures)
+	{
+		total_allowed += future.get();
+	}
+	EXPECT_EQ(total_allowed, 100);
+}
+
+TEST_F(GcraLimiterTest, RateLimiterUsesGcra)
+{
+	rate_limit_config config;
+	config.requests_per_second = 10;
+	config.burst_size = 3;
+	config.block_duration_ms = 1000;
+	config.algorithm = rate_limit_algorithm::gcra;
+
+	rate_limiter limiter(config);
+
+	EXPECT_EQ(limiter.remaining_requests("client1"), 3u);
+	for (int i = 0; i < 3; ++i)
+	{
+		EXPECT_TRUE(limiter.allow_request("client1"));
+	}
+	EXPECT_FALSE(limiter.allow_request("client1"));
+	EXPECT_TRUE(limiter.is_blocked("client1"));
+
+	limiter.reset("client1");
+	EXPECT_FALSE(limiter.is_blocked("client1"));
+	EXPECT_TRUE(limiter.allow_request("client1"));
+}
+
+// ============================================================================
+// Shared GCRA Limiter Tests
+// ============================================================================
+
+#if defined(__linux__)
+
+class SharedGcraLimiterTest : public ::testing::Test
+{
+protected:
+	using clock = shared_gcra_limiter::clock;
+
+	void SetUp() override
+	{
+		static std::atomic<int> counter{0};
+		name_ = "/dbgw_ratelimit_test_" + std::to_string(::getpid()) + "_"
+				+ std::to_string(counter.fetch_add(1));
+	}
+
+	void TearDown() override { (void)shared_gcra_limiter::remove(name_); }
+
+	std::shared_ptr<shared_gcra_limiter> open(uint32_t rate, uint32_t burst,
+											  uint32_t block_ms = 0,
+											  uint32_t slots = shared_gcra_limiter::default_slots)
+	{
+		auto opened = shared_gcra_limiter::open(name_, rate, burst, block_ms, slots);
+		EXPECT_TRUE(opened.is_ok()) << (opened.is_err() ? opened.error().message : "");
+		return opened.is_ok() ? opened.value() : nullptr;
+	}
+
+	std::string name_;
+	clock::time_point start_ = clock::now();
+};
+
+TEST_F(SharedGcraLimiterTest, InstancesShareOneBudget)
+{
+	auto first = open(10, 4);
+	auto second = open(10, 4);
+	ASSERT_TRUE(first && second);
+
+	EXPECT_TRUE(first->allow_request("client1", start_));
+	EXPECT_TRUE(second->allow_request("client1", start_));
+	EXPECT_TRUE(first->allow_request("client1", start_));
+	EXPECT_TRUE(second->allow_request("client1", start_));
+	EXPECT_FALSE(first->allow_request("client1", start_));
+	EXPECT_FALSE(second->allow_request("client1", start_));
+	EXPECT_EQ(second->remaining_requests("client1", start_), 0u);
+
+	// Both refill at the one sustained rate
+	EXPECT_TRUE(second->allow_request("client1", start_ + std::chrono::milliseconds(100)));
+	EXPECT_FALSE(first->allow_request("client1", start_ + std::chrono::milliseconds(100)));
+	EXPECT_TRUE(first->allow_request("client2", start_));
+}
+
+TEST_F(SharedGcraLimiterTest, ProcessesShareOneBudget)
+{
+	auto limiter = open(1, 10);
+	ASSERT_TRUE(limiter);
+
+	pid_t child = ::fork();
+	ASSERT_GE(child, 0);
+	if (child == 0)
+	{
+		auto opened = shared_gcra_limiter::open(name_, 1, 10, 0);
+		int allowed = 0;
+		for (int i = 0; opened.is_ok() && i < 6; ++i)
+		{
+			allowed += opened.value()->allow_request("client1", start_);
+		}
+		::_exit(allowed);
+	}
+
+	int status = 0;
+	ASSERT_EQ(::waitpid(child, &status, 0), child);
+	ASSERT_TRUE(WIFEXITED(status));
+	EXPECT_EQ(WEXITSTATUS(status), 6);
+
+	int allowed = 0;
+	for (int i = 0; i < 10; ++i)
+	{
+		allowed += limiter->allow_request("client1", start_);
+	}
+	EXPECT_EQ(allowed, 4);
+}
+
+TEST_F(SharedGcraLimiterTest, RejectsDifferentConfiguration)
+{
+	auto limiter = open(10, 4, 1000, 1024);
+	ASSERT_TRUE(limiter);
+	EXPECT_EQ(limiter->capacity(), 1024u);
+
+	EXPECT_TRUE(shared_gcra_limiter::open(name_, 10, 4, 1000, 1000).is_ok());
+	EXPECT_TRUE(shared_gcra_limiter::open(name_, 20, 4, 1000, 1024).is_err());
+	EXPECT_TRUE(shared_gcra_limiter::open(name_, 10, 8, 1000, 1024).is_err());
+	EXPECT_TRUE(shared_gcra_limiter::open(name_, 10, 4, 0, 1024).is_err());
+	EXPECT_TRUE(shared_gcra_limiter::open(name_, 10, 4, 1000, 2048).is_err());
+	EXPECT_TRUE(shared_gcra_limiter::open("no-leading-slash", 10, 4, 1000).is_err());
+
+	// A removed segment is recreated with the new configuration
+	ASSERT_TRUE(shared_gcra_limiter::remove(name_).is_ok());
+	EXPECT_TRUE(shared_gcra_limiter::open(name_, 20, 4, 1000, 1024).is_ok());
+}
+
+TEST_F(SharedGcraLimiterTest, BlockAndResetApplyToEveryInstance)
+{
+	auto first = open(10, 2, 1000);
+	auto second = open(10, 2, 1000);
+	ASSERT_TRUE(first && second);
+
+	ASSERT_TRUE(first->allow_request("client1", start_));
+	ASSERT_TRUE(first->allow_request("client1", start_));
+	EXPECT_FALSE(first->allow_request("client1", start_));
+
+	auto later = start_ + std::chrono::milliseconds(500);
+	EXPECT_TRUE(second->is_blocked("client1", later));
+	EXPECT_FALSE(second->allow_request("client1", later));
+	EXPECT_GT(second->block_expires_at("client1"), 0u);
+
+	second->reset("client1");
+	EXPECT_FALSE(first->is_blocked("client1", later));
+	EXPECT_EQ(first->remaining_requests("client1", later), 2u);
+}
+
+TEST_F(SharedGcraLimiterTest, FullTableFailsOpenUntilCellsExpire)
+{
+	auto limiter = open(1000, 1, 0, 64);
+	ASSERT_TRUE(limiter);
+
+	for (int i = 0; i < 200; ++i)
+	{
+		EXPECT_TRUE(limiter->allow_request("client_" + std::to_string(i), start_));
+	}
+	EXPECT_LE(limiter->size(start_), limiter->capacity());
+	auto overflows = limiter->overflows();
+	EXPECT_GT(overflows, 0u);
+
+	// Every cell has expired a second later and is taken over by new clients
+	auto later = start_ + std::chrono::seconds(1);
+	for (int i = 0; i < 32; ++i)
+	{
+		EXPECT_TRUE(limiter->allow_request("other_" + std::to_string(i), later));
+		EXPECT_FALSE(limiter->allow_request("other_" + std::to_string(i), later));
+	}
+	EXPECT_EQ(limiter->overflows(), overflows);
+}
+
+TEST_F(SharedGcraLimiterTest, ConcurrentInstancesNeverExceedBurst)
+{
+	auto first = open(1, 100);
+	auto second = open(1, 100);
+	ASSERT_TRUE(first && second);
+
+	constexpr int num_threads = 8;
+	std::vector<std::future<int>> futures;
+	for (int t = 0; t < num_threads; ++t)
+	{
+		auto limiter = t % 2 == 0 ? first : second;
+		futures.push_back(std::async(std::launch::async,
+									 [limiter, this]()
+									 {
+										 int allowed = 0;
+										 for (int i = 0; i < 100; ++i)
+										 {
+											 allowed += limiter->allow_request("shared", start_);
+										 }
+										 return allowed;
+									 }));
+	}
+
+	int total_allowed = 0;
+	for (auto& future : futures)
+	{
+		total_allowed += future.get();
+	}
+	EXPECT_EQ(total_allowed, 100);
+}
+
+TEST_F(SharedGcraLimiterTest, RateLimiterUsesSharedSegment)
+{
+	rate_limit_config config;
+	config.requests_per_second = 10;
+	config.burst_size = 3;
+	config.block_duration_ms = 1000;
+	config.algorithm = rate_limit_algorithm::shared_gcra;
+	config.shared_segment_name = name_;
+	config.shared_segment_slots = 1024;
+
+	rate_limiter first(config);
+	rate_limiter second(config);
+	ASSERT_TRUE(first.is_shared()) << first.shared_error();
+	ASSERT_TRUE(second.is_shared());
+
+	EXPECT_TRUE(first.allow_request("client1"));
+	EXPECT_TRUE(second.allow_request("client1"));
+	EXPECT_TRUE(first.allow_request("client1"));
+	EXPECT_FALSE(second.allow_request("client1"));
+	EXPECT_TRUE(first.is_blocked("client1"));
+
+	first.reset("client1");
+	EXPECT_FALSE(second.is_blocked("client1"));
+}
+
+TEST_F(SharedGcraLimiterTest, RateLimiterFallsBackToLocalGcra)
+{
+	rate_limit_config config;
+	config.requests_per_second = 10;
+	config.burst_size = 2;
+	config.algorithm = rate_limit_algorithm::shared_gcra;
+	config.shared_segment_name = "invalid/name";
+
+	rate_limiter limiter(config);
+	EXPECT_FALSE(limiter.is_shared());
+	EXPECT_FALSE(limiter.shared_error().empty());
+
+	EXPECT_TRUE(limiter.allow_request("client1"));
+	EXPECT_TRUE(limiter.allow_request("client1"));
+	EXPECT_FALSE(limiter.allow_request("client1"));
+}
+
+#endif // __linux__
+
+// ============================================================================
+// Cost Limiter Tests
+// ============================================================================
+
+class CostLimiterTest : public ::testing::Test
+{
+protected:
+	using clock = cost_limiter::clock;
+
+	cost_limit_config make_config()
+	{
+		cost_limit_config config;
+		config.enabled = true;
+		config.units_per_second = 100.0;
+		config.burst_units = 100.0;
+		config.estimate_weight = 0.5;
+		return config;
+	}
+
+	query_cost cost_of_ms(uint64_t ms)
+	{
+		query_cost cost;
+		cost.execution_time_us = ms * 1000;
+		return cost;
+	}
+
+	clock::time_point start_ = clock::now();
+};
+
+TEST_F(CostLimiterTest, CheapQueriesUseTheBurst)
+{
+	cost_limiter limiter(make_config());
+
+	for (int i = 0; i < 100; ++i)
+	{
+		EXPECT_TRUE(limiter.admit("client1", "SELECT 1", start_).admitted) << "Query " << i;
+	}
+	EXPECT_FALSE(limiter.admit("client1", "SELECT 1", start_).admitted);
+	EXPECT_EQ(limiter.metrics().admitted.load(), 100u);
+	EXPECT_EQ(limiter.metrics().rejected.load(), 1u);
+}
+
+TEST_F(CostLimiterTest, ExpensiveQueryLeavesDebt)
+{
+	cost_limiter limiter(make_config());
+
+	// Estimated at 1 unit, measured at 500 ms = 500 units
+	auto ticket = limiter.admit("client1", "SELECT sum(x) FROM big", start_);
+	ASSERT_TRUE(ticket.admitted);
+	limiter.settle("client1", ticket, cost_of_ms(500));
+
+	EXPECT_DOUBLE_EQ(limiter.available_units("client1", start_), 0.0);
+	EXPECT_FALSE(limiter.admit("client1", "SELECT 1", start_ + std::chrono::seconds(3)).admitted);
+	EXPECT_TRUE(limiter.admit("client1", "SELECT 1", start_ + std::chrono::seconds(5)).admitted);
+	EXPECT_EQ(limiter.metrics().underestimated.load(), 1u);
+	EXPECT_EQ(limiter.metrics().settled_units.load(), 500u);
+}
+
+TEST_F(CostLimiterTest, CheaperThanEstimatedIsRefunded)
+{
+	auto config = make_config();
+	config.initial_estimate_units = 50.0;
+	cost_limiter limiter(config);
+
+	auto ticket = limiter.admit("client1", "SELECT * FROM t WHERE id = 1", start_);
+	ASSERT_TRUE(ticket.admitted);
+	EXPECT_NEAR(limiter.available_units("client1", start_), 50.0, 0.01);
+
+	limiter.settle("client1", ticket, cost_of_ms(2));
+	EXPECT_NEAR(limiter.available_units("client1", start_), 98.0, 0.01);
+}
+
+TEST_F(CostLimiterTest, EstimatesFollowMeasuredCost)
+{
+	cost_limiter limiter(make_config());
+	const std::string sql = "SELECT * FROM orders WHERE customer = 42";
+
+	EXPECT_DOUBLE_EQ(limiter.estimate(sql), 1.0);
+
+	auto first = limiter.admit("client1", sql, start_);
+	limiter.settle("client1", first, cost_of_ms(40));
+	EXPECT_DOUBLE_EQ(limiter.estimate(sql), 40.0);
+
+	auto second = limiter.admit("client1", sql, start_ + std::chrono::seconds(1));
+	EXPECT_DOUBLE_EQ(second.estimated_units, 40.0);
+	limiter.settle("client1", second, cost_of_ms(20));
+	EXPECT_DOUBLE_EQ(limiter.estimate(sql), 30.0);
+
+	// Other literal values share the estimate
+	EXPECT_DOUBLE_EQ(limiter.estimate("select *  from orders where customer = 7"), 30.0);
+}
+
+TEST_F(CostLimiterTest, IdleClientMayRunQueryAboveBurst)
+{
+	cost_limiter limiter(make_config());
+	const std::string sql = "SELECT * FROM huge";
+
+	auto ticket = limiter.admit("client1", sql, start_);
+	limiter.settle("client1", ticket, cost_of_ms(1000));
+	ASSERT_GT(limiter.estimate(sql), 100.0);
+
+	auto later = start_ + std::chrono::seconds(20);
+	EXPECT_TRUE(limiter.admit("client1", sql, later).admitted);
+	EXPECT_FALSE(limiter.admit("client1", sql, later).admitted);
+}
+
+TEST_F(CostLimiterTest, CostModelCountsTimeRowsAndBytes)
+{
+	cost_limiter limiter(make_config());
+
+	query_cost cost;
+	EXPECT_DOUBLE_EQ(limiter.units(cost), 1.0);
+
+	cost.execution_time_us = 3000;
+	cost.rows = 200;
+	cost.bytes = 65536;
+	EXPECT_DOUBLE_EQ(limiter.units(cost), 6.0);
+
+	query_response response(1);
+	response.affected_rows = 7;
+	response.execution_time_us = 1500;
+	auto measured = cost_limiter::measure(response);
+	EXPECT_EQ(measured.rows, 7u);
+	EXPECT_EQ(measured.execution_time_us, 1500u);
+	EXPECT_EQ(measured.bytes, 0u);
+}
+
+TEST_F(CostLimiterTest, ClientsHaveSeparateBudgets)
+{
+	cost_limiter limiter(make_config());
+
+	auto ticket = limiter.admit("heavy", "SELECT * FROM big", start_);
+	limiter.settle("heavy", ticket, cost_of_ms(1000));
+
+	EXPECT_FALSE(limiter.admit("heavy", "SELECT 1", start_).admitted);
+	EXPECT_TRUE(limiter.admit("light", "SELECT 1", start_).admitted);
+}
+
+TEST_F(CostLimiterTest, DisabledOrAnonymousIsNotLimited)
+{
+	cost_limiter disabled(cost_limit_config{});
+	auto ticket = disabled.admit("client1", "SELECT 1", start_);
+	EXPECT_TRUE(ticket.admitted);
+	disabled.settle("client1", ticket, cost_of_ms(100000));
+	EXPECT_TRUE(disabled.admit("client1", "SELECT 1", start_).admitted);
+	EXPECT_EQ(disabled.size(), 0u);
+
+	cost_limiter limiter(make_config());
+	for (int i = 0; i < 1000; ++i)
+	{
+		ASSERT_TRUE(limiter.admit("", "SELECT 1", start_).admitted);
+	}
+	EXPECT_EQ(limiter.size(), 0u);
+}
+
+TEST(CostFingerprintTest, NormalisesLiteralsCaseAndWhitespace)
+{
+	auto base = cost_limiter::fingerprint("SELECT name FROM users WHERE id = 1 AND tag = 'a'");
+
+	EXPECT_EQ(cost_limiter::fingerprint("select name from users where id = 99 and tag = 'it''s'"),
+			  base);
+	EXPECT_EQ(cost_limiter::fingerprint("  SELECT name\n FROM users WHERE id = 1.5 AND tag = 'b'  "),
+			  base);
+	EXPECT_NE(cost_limiter::fingerprint("SELECT name FROM accounts WHERE id = 1 AND tag = 'a'"),
+			  base);
+
+	// Digits inside identifiers are kept
+	EXPECT_NE(cost_limiter::fingerprint("SELECT * FROM t1"),
+			  cost_limiter::fingerprint("SELECT * FROM t2"));
+}
@@ -40,13 +40,17 @@
  * - Connection state enum
  * - Connection health monitor basic functionality
  * - Resilient database connection basic functionality
+ * - Circuit breaker window, transitions and fail-fast
  */
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
 #include <memory>
+#include <thread>
 
+#include <kcenon/database_server/resilience/circuit_breaker.h>
 #include <kcenon/database_server/resilience/connection_health_monitor.h>
 #include <kcenon/database_server/resilience/resilient_database_connection.h>
 
@@ -170,6 +174,7 @@ TEST_F(ReconnectionConfigTest, DefaultValues)
 	EXPECT_DOUBLE_EQ(config.backoff_multiplier, 2.0);
 	EXPECT_EQ(config.max_retries, 10u);
 	EXPECT_TRUE(config.enable_auto_reconnect);
+	EXPECT_DOUBLE_EQ(config.jitter, 0.5);
 }
 
 TEST_F(ReconnectionConfigTest, CustomValues)
@@ -432,3 +437,492 @@ TEST_F(ResilientDatabaseConnectionTest, StartStopAutoRecovery)
 	conn.start_auto_recovery();
 	conn.stop_auto_recovery();
 }
+
+// ============================================================================
+// Circuit Breaker Tests
+// ============================================================================
+
+class CircuitBreakerTest : public ::testing::Test
+{
+protected:
+	using clock = circuit_breaker::clock;
+
+	circuit_breaker_config make_config()
+	{
+		circuit_breaker_config config;
+		config.enabled = true;
+		config.window_ms = 10000;
+		config.window_buckets = 10;
+		config.min_calls = 4;
+		config.failure_ratio = 0.5;
+		config.open_duration_ms = 1000;
+		config.half_open_probes = 2;
+		return config;
+	}
+
+	void record_calls(circuit_breaker& breaker, int successes, int failures,
+					  clock::time_point now, clock::duration latency = 1ms)
+	{
+		for (int i = 0; i < successes + failures; ++i)
+		{
+			auto permit = breaker.admit(now);
+			ASSERT_TRUE(permit.admitted);
+			breaker.record(permit, i < successes, latency, now);
+		}
+	}
+
+	clock::time_point start_ = clock::now();
+};
+
+TEST_F(CircuitBreakerTest, StateToString)
+{
+	EXPECT_STREQ(to_string(circuit_state::closed), "closed");
+	EXPECT_STREQ(to_string(circuit_state::open), "open");
+	EXPECT_STREQ(to_string(circuit_state::half_open), "half_open");
+}
+
+TEST_F(CircuitBreakerTest, DisabledAlwaysAdmits)
+{
+	circuit_breaker breaker;
+
+	record_calls(breaker, 0, 100, start_);
+
+	EXPECT_EQ(breaker.state(), circuit_state::closed);
+	EXPECT_TRUE(breaker.admit(start_).admitted);
+	EXPECT_EQ(breaker.metrics().opened.load(), 0u);
+}
+
+TEST_F(CircuitBreakerTest, OpensAtFailureRatio)
+{
+	circuit_breaker breaker(make_config());
+
+	record_calls(breaker, 2, 1, start_);
+	EXPECT_EQ(breaker.state(), circuit_state::closed);
+
+	record_calls(breaker, 0, 1, start_);
+	EXPECT_EQ(breaker.state(), circuit_state::open);
+	EXPECT_EQ(breaker.metrics().opened.load(), 1u);
+
+	EXPECT_FALSE(breaker.admit(start_ + 999ms).admitted);
+	EXPECT_EQ(breaker.metrics().rejected.load(), 1u);
+}
+
+TEST_F(CircuitBreakerTest, NeedsMinimumCalls)
+{
+	auto config = make_config();
+	config.min_calls = 10;
+	circuit_breaker breaker(config);
+
+	record_calls(breaker, 0, 9, start_);
+	EXPECT_EQ(breaker.state(), circuit_state::closed);
+
+	record_calls(breaker, 0, 1, start_);
+	EXPECT_EQ(breaker.state(), circuit_state::open);
+}
+
+TEST_F(CircuitBreakerTest, OpensOnSlowCalls)
+{
+	auto config = make_config();
+	config.slow_call_ms = 100;
+	config.slow_call_ratio = 0.75;
+	circuit_breaker breaker(config);
+
+	record_calls(breaker, 1, 0, start_);
+	record_calls(breaker, 2, 0, start_, 150ms);
+	EXPECT_EQ(breaker.state(), circuit_state::closed);
+
+	record_calls(breaker, 1, 0, start_, 100ms);
+	EXPECT_EQ(breaker.state(), circuit_state::open);
+	EXPECT_EQ(breaker.metrics().slow_calls.load(), 3u);
+}
+
+TEST_F(CircuitBreakerTest, OldOutcomesLeaveTheWindow)
+{
+	circuit_breaker breaker(make_config());
+
+	record_calls(breaker, 0, 3, start_);
+
+	// Ten seconds later the failures above are out of the window
+	record_calls(breaker, 3, 1, start_ + 10s);
+	EXPECT_EQ(breaker.state(), circuit_state::closed);
+}
+
+TEST_F(CircuitBreakerTest, HalfOpenAdmitsLimitedProbesThenCloses)
+{
+	circuit_breaker breaker(make_config());
+	record_calls(breaker, 0, 4, start_);
+	ASSERT_EQ(breaker.state(), circuit_state::open);
+
+	auto after_open = start_ + 1s;
+	auto first = breaker.admit(after_open);
+	auto second = breaker.admit(after_open);
+	EXPECT_TRUE(first.admitted && first.probe);
+	EXPECT_TRUE(second.admitted && second.probe);
+	EXPECT_EQ(breaker.state(), circuit_state::half_open);
+	EXPECT_FALSE(breaker.admit(after_open).admitted);
+
+	breaker.record(first, true, 1ms, after_open);
+	EXPECT_EQ(breaker.state(), circuit_state::half_open);
+	breaker.record(second, true, 1ms, after_open);
+	EXPECT_EQ(breaker.state(), circuit_state::closed);
+
+	EXPECT_EQ(breaker.metrics().opened.load(), 1u);
+	EXPECT_EQ(breaker.metrics().half_opened.load(), 1u);
+	EXPECT_EQ(breaker.metrics().closed.load(), 1u);
+
+	// The failures from before the outage are forgotten
+	record_calls(breaker, 0, 1, after_open);
+	EXPECT_EQ(breaker.state(), circuit_state::closed);
+}
+
+TEST_F(CircuitBreakerTest, FailedProbeReopens)
+{
+	circuit_breaker breaker(make_config());
+	record_calls(breaker, 0, 4, start_);
+
+	auto after_open = start_ + 1s;
+	auto probe = breaker.admit(after_open);
+	ASSERT_TRUE(probe.probe);
+	breaker.record(probe, false, 1ms, after_open);
+
+	EXPECT_EQ(breaker.state(), circuit_state::open);
+	EXPECT_EQ(breaker.metrics().opened.load(), 2u);
+	EXPECT_FALSE(breaker.admit(after_open + 999ms).admitted);
+	EXPECT_TRUE(breaker.admit(after_open + 1s).admitted);
+}
+
+TEST_F(CircuitBreakerTest, CancelledProbeFreesItsSlot)
+{
+	auto config = make_config();
+	config.half_open_probes = 1;
+	circuit_breaker breaker(config);
+	record_calls(breaker, 0, 4, start_);
+
+	auto after_open = start_ + 1s;
+	auto probe = breaker.admit(after_open);
+	ASSERT_TRUE(probe.probe);
+	EXPECT_FALSE(breaker.admit(after_open).admitted);
+
+	breaker.cancel(probe);
+	EXPECT_TRUE(breaker.admit(after_open).admitted);
+}
+
+TEST_F(CircuitBreakerTest, ResultsFromBeforeTheTransitionAreIgnored)
+{
+	circuit_breaker breaker(make_config());
+
+	auto slow_call = breaker.admit(start_);
+	ASSERT_TRUE(slow_call.admitted);
+	record_calls(breaker, 0, 4, start_);
+
+	auto after_open = start_ + 1s;
+	auto probe = breaker.admit(after_open);
+	ASSERT_TRUE(probe.probe);
+
+	// Neither closes nor reopens the half-open breaker
+	breaker.record(slow_call, true, 1s, after_open);
+	breaker.record(slow_call, false, 1s, after_open);
+	EXPECT_EQ(breaker.state(), circuit_state::half_open);
+}
+
+namespace
+{
+
+/**
+ * @brief Backend whose queries fail while it is marked down
+ */
+class flaky_backend : public database::core::database_backend
+{
+public:
+	explicit flaky_backend(std::shared_ptr<std::atomic<int>> calls) : calls_(std::move(calls)) {}
+
+	std::atomic<bool> down{ true };
+	std::atomic<int> failed_connects{ 0 }; ///< Remaining initialize() calls that fail
+	std::atomic<bool> reject_queries{ false }; ///< Fail every query but the heartbeat
+
+	database::database_types type() const override { return database::database_types::none; }
+	kcenon::common::VoidResult initialize(const database::core::connection_config&) override
+	{
+		if (failed_connects.fetch_sub(1) > 0)
+		{
+			return kcenon::common::error_info{ -1, "connection refused", "flaky_backend" };
+		}
+		return kcenon::common::ok();
+	}
+	kcenon::common::VoidResult shutdown() override { return kcenon::common::ok(); }
+	bool is_initialized() const override { return !down; }
+	kcenon::common::Result<uint64_t> insert_query(const std::string& sql) override
+	{
+		return count(sql);
+	}
+	kcenon::common::Result<uint64_t> update_query(const std::string& sql) override
+	{
+		return count(sql);
+	}
+	kcenon::common::Result<uint64_t> delete_query(const std::string& sql) override
+	{
+		return count(sql);
+	}
+	kcenon::common::Result<database::core::database_result> select_query(
+		const std::string& sql) override
+	{
+		auto result = count(sql);
+		if (result.is_err())
+		{
+			return result.error();
+		}
+		return database::core::database_result{};
+	}
+	kcenon::common::VoidResult execute_query(const std::string& sql) override
+	{
+		auto result = count(sql);
+		if (result.is_err())
+		{
+			return result.error();
+		}
+		return kcenon::common::ok();
+	}
+	kcenon::common::VoidResult begin_transaction() override { return kcenon::common::ok(); }
+	kcenon::common::VoidResult commit_transaction() override { return kcenon::common::ok(); }
+	kcenon::common::VoidResult rollback_transaction() override { return kcenon::common::ok(); }
+	bool in_transaction() const override { return false; }
+	std::string last_error() const override { return {}; }
+	std::map<std::string, std::string> connection_info() const override { return {}; }
+
+private:
+	kcenon::common::Result<uint64_t> count(const std::string& sql)
+	{
+		calls_->fetch_add(1);
+		if (down)
+		{
+			return kcenon::common::error_info{ -1, "connection refused", "flaky_backend" };
+		}
+		if (reject_queries && sql != "SELECT 1")
+		{
+			return kcenon::common::error_info{ -2, "syntax error", "flaky_backend" };
+		}
+		return uint64_t{1};
+	}
+
+	std::shared_ptr<std::atomic<int>> calls_;
+};
+
+} // namespace
+
+TEST_F(CircuitBreakerTest, ResilientConnectionFailsFastWhileOpen)
+{
+	auto calls = std::make_shared<std::atomic<int>>(0);
+	reconnection_config recon_config;
+	recon_config.enable_auto_reconnect = false;
+	auto breaker = std::make_shared<circuit_breaker>(make_config());
+
+	resilient_database_connection conn(std::make_unique<flaky_backend>(calls), recon_config,
+									   nullptr, breaker);
+	EXPECT_EQ(conn.get_circuit_breaker(), breaker);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		EXPECT_TRUE(conn.select_query("SELECT 1").is_err());
+	}
+	EXPECT_EQ(calls->load(), 4);
+	EXPECT_EQ(breaker->state(), circuit_state::open);
+
+	// Rejected without reaching the backend
+	auto result = conn.insert_query("INSERT INTO t VALUES (1)");
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().message, "Circuit breaker open: backend unavailable");
+	EXPECT_EQ(calls->load(), 4);
+	EXPECT_EQ(breaker->metrics().rejected.load(), 1u);
+}
+
+TEST_F(CircuitBreakerTest, ResilientConnectionIgnoresQueryErrors)
+{
+	auto calls = std::make_shared<std::atomic<int>>(0);
+	auto backend = std::make_unique<flaky_backend>(calls);
+	backend->down = false;
+	backend->reject_queries = true;
+	reconnection_config recon_config;
+	recon_config.enable_auto_reconnect = false;
+	auto breaker = std::make_shared<circuit_breaker>(make_config());
+
+	resilient_database_connection conn(std::move(backend), recon_config, nullptr, breaker);
+
+	// The backend is up and its heartbeat has not failed, so these are the client's errors
+	for (int i = 0; i < 8; ++i)
+	{
+		EXPECT_TRUE(conn.select_query("SELEC 1").is_err());
+	}
+	EXPECT_EQ(breaker->state(), circuit_state::closed);
+	EXPECT_EQ(breaker->metrics().failures.load(), 0u);
+
+	// Classified without a heartbeat on the caller's thread
+	EXPECT_EQ(calls->load(), 8);
+}
+
+// ============================================================================
+// Background Reconnection Tests
+// ============================================================================
+
+class BackgroundReconnectTest : public ::testing::Test
+{
+protected:
+	bool wait_for_state(const resilient_database_connection& conn, connection_state expected)
+	{
+		for (int i = 0; i < 500 && conn.get_state() != expected; ++i)
+		{
+			std::this_thread::sleep_for(10ms);
+		}
+		return conn.get_state() == expected;
+	}
+};
+
+TEST_F(BackgroundReconnectTest, FailedQueryReturnsWithoutWaitingForBackoff)
+{
+	auto calls = std::make_shared<std::atomic<int>>(0);
+	auto backend = std::make_unique<flaky_backend>(calls);
+	auto* raw = backend.get();
+	raw->down = false;
+
+	reconnection_config recon_config;
+	recon_config.initial_delay = 300ms;
+	recon_config.jitter = 0.0;
+	resilient_database_connection conn(std::move(backend), recon_config);
+	ASSERT_TRUE(conn.initialize(database::core::connection_config{}).is_ok());
+
+	raw->down = true;
+	auto start = std::chrono::steady_clock::now();
+	EXPECT_TRUE(conn.select_query("SELECT 1").is_err());
+	EXPECT_LT(std::chrono::steady_clock::now() - start, 200ms);
+	EXPECT_EQ(conn.get_state(), connection_state::reconnecting);
+
+	// Other callers are turned away instead of queuing behind the reconnect
+	auto result = conn.insert_query("INSERT INTO t VALUES (1)");
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().message, "Reconnecting to backend");
+	EXPECT_TRUE(conn.ensure_connected().is_err());
+
+	raw->down = false;
+	ASSERT_TRUE(wait_for_state(conn, connection_state::connected));
+	EXPECT_EQ(conn.get_retry_count(), 0u);
+	EXPECT_TRUE(conn.select_query("SELECT 1").is_ok());
+}
+
+TEST_F(BackgroundReconnectTest, RetriesUntilExhausted)
+{
+	auto calls = std::make_shared<std::atomic<int>>(0);
+	auto backend = std::make_unique<flaky_backend>(calls);
+	backend->failed_connects = 100;
+
+	reconnection_config recon_config;
+	recon_config.initial_delay = 1ms;
+	recon_config.max_retries = 3;
+	resilient_database_connection conn(std::move(backend), recon_config);
+
+	auto result = conn.ensure_connected();
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().message, "Reconnecting to backend");
+
+	ASSERT_TRUE(wait_for_state(conn, connection_state::failed));
+	EXPECT_EQ(conn.get_retry_count(), 3u);
+	EXPECT_EQ(conn.last_error(), "Max retries exceeded");
+
+	result = conn.ensure_connected();
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().message, "Max retries exceeded");
+}
+
+TEST_F(BackgroundReconnectTest, RecoversAfterFailedAttempts)
+{
+	auto calls = std::make_shared<std::atomic<int>>(0);
+	auto backend = std::make_unique<flaky_backend>(calls);
+	auto* raw = backend.get();
+	raw->failed_connects = 2;
+
+	reconnection_config recon_config;
+	recon_config.initial_delay = 1ms;
+	recon_config.jitter = 1.0;
+	resilient_database_connection conn(std::move(backend), recon_config);
+
+	EXPECT_TRUE(conn.ensure_connected().is_err());
+	raw->down = false;
+	ASSERT_TRUE(wait_for_state(conn, connection_state::connected));
+	EXPECT_EQ(conn.get_retry_count(), 0u);
+	EXPECT_TRUE(conn.ensure_connected().is_ok());
+}
+
+TEST_F(BackgroundReconnectTest, QueryErrorsDoNotTriggerReconnect)
+{
+	auto calls = std::make_shared<std::atomic<int>>(0);
+	auto backend = std::make_unique<flaky_backend>(calls);
+	auto* raw = backend.get();
+	raw->down = false;
+	raw->reject_queries = true;
+
+	resilient_database_connection conn(std::move(backend));
+	ASSERT_TRUE(conn.initialize(database::core::connection_config{}).is_ok());
+
+	auto result = conn.insert_query("INSERT INTO missing VALUES (1)");
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().message, "syntax error");
+	EXPECT_EQ(conn.get_state(), connection_state::connected);
+
+	// Other callers are unaffected
+	raw->reject_queries = false;
+	EXPECT_TRUE(conn.select_query("SELECT * FROM t").is_ok());
+}
+
+TEST_F(BackgroundReconnectTest, RestoredDuringBackoffThenLostAgain)
+{
+	auto calls = std::make_shared<std::atomic<int>>(0);
+	auto backend = std::make_unique<flaky_backend>(calls);
+	auto* raw = backend.get();
+	raw->down = false;
+
+	reconnection_config recon_config;
+	recon_config.initial_delay = 200ms;
+	recon_config.jitter = 0.0;
+	resilient_database_connection conn(std::move(backend), recon_config);
+	ASSERT_TRUE(conn.initialize(database::core::connection_config{}).is_ok());
+
+	raw->down = true;
+	EXPECT_TRUE(conn.select_query("SELECT 1").is_err());
+	ASSERT_EQ(conn.get_state(), connection_state::reconnecting);
+
+	// Restored by hand while the task is still backing off
+	raw->down = false;
+	ASSERT_TRUE(conn.initialize(database::core::connection_config{}).is_ok());
+	EXPECT_EQ(conn.get_state(), connection_state::connected);
+
+	// Losing it again starts a fresh task instead of waiting on the old one
+	raw->down = true;
+	auto start = std::chrono::steady_clock::now();
+	EXPECT_TRUE(conn.select_query("SELECT 1").is_err());
+	EXPECT_LT(std::chrono::steady_clock::now() - start, 150ms);
+	EXPECT_EQ(conn.get_state(), connection_state::reconnecting);
+
+	raw->down = false;
+	ASSERT_TRUE(wait_for_state(conn, connection_state::connected));
+	EXPECT_TRUE(conn.select_query("SELECT 1").is_ok());
+}
+
+TEST_F(BackgroundReconnectTest, ShutdownInterruptsBackoff)
+{
+	auto calls = std::make_shared<std::atomic<int>>(0);
+	reconnection_config recon_config;
+	recon_config.initial_delay = 30s;
+	recon_config.jitter = 0.0;
+	resilient_database_connection conn(std::make_unique<flaky_backend>(calls), recon_config);
+
+	EXPECT_TRUE(conn.ensure_connected().is_err());
+	EXPECT_EQ(conn.get_state(), connection_state::reconnecting);
+
+	auto start = std::chrono::steady_clock::now();
+	EXPECT_TRUE(conn.shutdown().is_ok());
+	EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+	EXPECT_EQ(conn.get_state(), connection_state::disconnected);
+
+	// No new reconnection after shutdown until initialize()
+	auto result = conn.ensure_connected();
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().message, "Connection is shut down");
+}
@@ -0,0 +1,317 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file result_delta_test.cpp
+ * @brief Unit tests for delta-encoded polling results
+ *
+ * Tests cover:
+ * - Opt-in eligibility
+ * - Full first response with a snapshot version
+ * - Inserted, updated and deleted row detection
+ * - Fallback to full results on version mismatch or large changes
+ * - Snapshot memory and count bounds
+ * - Session cleanup
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include <kcenon/database_server/gateway/result_delta.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+query_request make_poll_request(uint64_t base_version)
+{
+	query_request request("SELECT id, name FROM users", query_type::select);
+	request.options.delta_key_column = "id";
+	request.options.delta_base_version = base_version;
+	return request;
+}
+
+query_response make_users_response(const std::vector<std::pair<int64_t, std::string>>& users)
+{
+	query_response response(1);
+
+	column_metadata id_col;
+	id_col.name = "id";
+	column_metadata name_col;
+	name_col.name = "name";
+	response.columns = {id_col, name_col};
+
+	for (const auto& [id, name] : users)
+	{
+		result_row row;
+		row.cells = {id, name};
+		response.rows.push_back(std::move(row));
+	}
+	return response;
+}
+
+} // namespace
+
+// ============================================================================
+// Result Delta Tracker Tests
+// ============================================================================
+
+class ResultDeltaTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		config_.max_change_ratio = 1.0;
+	}
+
+	/**
+	 * @brief Send a full result and return the version the client would hold
+	 */
+	uint64_t prime(result_delta_tracker& tracker,
+				   const std::vector<std::pair<int64_t, std::string>>& users)
+	{
+		auto request = make_poll_request(0);
+		auto response = make_users_response(users);
+		tracker.apply("session-1", request, response);
+		return response.result_version;
+	}
+
+	delta_config config_;
+};
+
+TEST_F(ResultDeltaTest, IgnoresRequestsWithoutKeyColumn)
+{
+	result_delta_tracker tracker(config_);
+
+	query_request request("SELECT id, name FROM users", query_type::select);
+	auto response = make_users_response({{1, "a"}, {2, "b"}});
+	tracker.apply("session-1", request, response);
+
+	EXPECT_EQ(response.result_version, 0u);
+	EXPECT_FALSE(response.delta.has_value());
+	EXPECT_EQ(response.rows.size(), 2u);
+	EXPECT_EQ(tracker.snapshot_count(), 0u);
+}
+
+TEST_F(ResultDeltaTest, FirstResponseIsFullWithVersion)
+{
+	result_delta_tracker tracker(config_);
+
+	auto request = make_poll_request(0);
+	auto response = make_users_response({{1, "a"}, {2, "b"}});
+	tracker.apply("session-1", request, response);
+
+	EXPECT_NE(response.result_version, 0u);
+	EXPECT_FALSE(response.delta.has_value());
+	EXPECT_EQ(response.rows.size(), 2u);
+	EXPECT_EQ(tracker.snapshot_count(), 1u);
+	EXPECT_GT(tracker.memory_usage(), 0u);
+}
+
+TEST_F(ResultDeltaTest, UnchangedResultProducesEmptyDelta)
+{
+	result_delta_tracker tracker(config_);
+	auto version = prime(tracker, {{1, "a"}, {2, "b"}});
+
+	auto request = make_poll_request(version);
+	auto response = make_users_response({{1, "a"}, {2, "b"}});
+	tracker.apply("session-1", request, response);
+
+	ASSERT_TRUE(response.delta.has_value());
+	EXPECT_EQ(response.delta->base_version, version);
+	EXPECT_TRUE(response.delta->inserted.empty());
+	EXPECT_TRUE(response.delta->updated.empty());
+	EXPECT_TRUE(response.delta->deleted_keys.empty());
+	EXPECT_TRUE(response.rows.empty());
+	EXPECT_GT(response.result_version, version);
+	EXPECT_EQ(tracker.metrics().rows_suppressed.load(), 2u);
+}
+
+TEST_F(ResultDeltaTest, DetectsInsertedUpdatedAndDeletedRows)
+{
+	result_delta_tracker tracker(config_);
+	auto version = prime(tracker, {{1, "a"}, {2, "b"}, {3, "c"}});
+
+	auto request = make_poll_request(version);
+	auto response = make_users_response({{1, "a"}, {2, "B"}, {4, "d"}});
+	tracker.apply("session-1", request, response);
+
+	ASSERT_TRUE(response.delta.has_value());
+	ASSERT_EQ(response.delta->inserted.size(), 1u);
+	EXPECT_EQ(std::get<int64_t>(response.delta->inserted[0].cells[0]), 4);
+
+	ASSERT_EQ(response.delta->updated.size(), 1u);
+	EXPECT_EQ(std::get<std::string>(response.delta->updated[0].cells[1]), "B");
+
+	ASSERT_EQ(response.delta->deleted_keys.size(), 1u);
+	EXPECT_EQ(std::get<int64_t>(response.delta->deleted_keys[0]), 3);
+}
+
+TEST_F(ResultDeltaTest, ChainedDeltasFollowLatestVersion)
+{
+	result_delta_tracker tracker(config_);
+	auto version = prime(tracker, {{1, "a"}});
+
+	auto request = make_poll_request(version);
+	auto response = make_users_response({{1, "a"}, {2, "b"}});
+	tracker.apply("session-1", request, response);
+	ASSERT_TRUE(response.delta.has_value());
+
+	auto next_request = make_poll_request(response.result_version);
+	auto next_response = make_users_response({{1, "a"}, {2, "b"}});
+	tracker.apply("session-1", next_request, next_response);
+
+	ASSERT_TRUE(next_response.delta.has_value());
+	EXPECT_TRUE(next_response.delta->inserted.empty());
+}
+
+TEST_F(ResultDeltaTest, StaleBaseVersionGetsFullResult)
+{
+	result_delta_tracker tracker(config_);
+	auto version = prime(tracker, {{1, "a"}});
+
+	auto request = make_poll_request(version + 100);
+	auto response = make_users_response({{1, "a"}});
+	tracker.apply("session-1", request, response);
+
+	EXPECT_FALSE(response.delta.has_value());
+	EXPECT_EQ(response.rows.size(), 1u);
+	EXPECT_NE(response.result_version, 0u);
+}
+
+TEST_F(ResultDeltaTest, LargeChangeFallsBackToFullResult)
+{
+	config_.max_change_ratio = 0.25;
+	result_delta_tracker tracker(config_);
+	auto version = prime(tracker, {{1, "a"}, {2, "b"}, {3, "c"}, {4, "d"}});
+
+	auto request = make_poll_request(version);
+	auto response = make_users_response({{1, "x"}, {2, "y"}, {3, "c"}, {4, "d"}});
+	tracker.apply("session-1", request, response);
+
+	EXPECT_FALSE(response.delta.has_value());
+	EXPECT_EQ(response.rows.size(), 4u);
+	EXPECT_NE(response.result_version, 0u);
+}
+
+TEST_F(ResultDeltaTest, DuplicateKeysAreNotSnapshotted)
+{
+	result_delta_tracker tracker(config_);
+
+	auto request = make_poll_request(0);
+	auto response = make_users_response({{1, "a"}, {1, "b"}});
+	tracker.apply("session-1", request, response);
+
+	EXPECT_EQ(response.result_version, 0u);
+	EXPECT_EQ(tracker.snapshot_count(), 0u);
+	EXPECT_EQ(tracker.metrics().not_snapshotted.load(), 1u);
+}
+
+TEST_F(ResultDeltaTest, UnknownKeyColumnIsNotSnapshotted)
+{
+	result_delta_tracker tracker(config_);
+
+	auto request = make_poll_request(0);
+	request.options.delta_key_column = "missing";
+	auto response = make_users_response({{1, "a"}});
+	tracker.apply("session-1", request, response);
+
+	EXPECT_EQ(response.result_version, 0u);
+	EXPECT_EQ(response.rows.size(), 1u);
+}
+
+TEST_F(ResultDeltaTest, SnapshotCountIsBounded)
+{
+	config_.max_snapshots = 2;
+	result_delta_tracker tracker(config_);
+
+	for (int i = 0; i < 5; ++i)
+	{
+		auto request = make_poll_request(0);
+		auto response = make_users_response({{1, "a"}});
+		tracker.apply("session-" + std::to_string(i), request, response);
+	}
+
+	EXPECT_EQ(tracker.snapshot_count(), 2u);
+	EXPECT_EQ(tracker.metrics().evictions.load(), 3u);
+}
+
+TEST_F(ResultDeltaTest, SnapshotMemoryIsBounded)
+{
+	config_.max_memory_bytes = 4096;
+	result_delta_tracker tracker(config_);
+
+	std::vector<std::pair<int64_t, std::string>> users;
+	for (int64_t i = 0; i < 1000; ++i)
+	{
+		users.emplace_back(i, "user");
+	}
+
+	auto request = make_poll_request(0);
+	auto response = make_users_response(users);
+	tracker.apply("session-1", request, response);
+
+	EXPECT_EQ(response.result_version, 0u);
+	EXPECT_LE(tracker.memory_usage(), config_.max_memory_bytes);
+}
+
+TEST_F(ResultDeltaTest, RemoveSessionDropsSnapshots)
+{
+	result_delta_tracker tracker(config_);
+	prime(tracker, {{1, "a"}});
+
+	auto request = make_poll_request(0);
+	auto response = make_users_response({{1, "a"}});
+	tracker.apply("session-2", request, response);
+	EXPECT_EQ(tracker.snapshot_count(), 2u);
+
+	tracker.remove_session("session-1");
+	EXPECT_EQ(tracker.snapshot_count(), 1u);
+
+	tracker.clear();
+	EXPECT_EQ(tracker.snapshot_count(), 0u);
+	EXPECT_EQ(tracker.memory_usage(), 0u);
+}
+
+TEST_F(ResultDeltaTest, SnapshotsAreIsolatedPerSession)
+{
+	result_delta_tracker tracker(config_);
+	auto version = prime(tracker, {{1, "a"}});
+
+	auto request = make_poll_request(version);
+	auto response = make_users_response({{1, "a"}});
+	tracker.apply("session-2", request, response);
+
+	EXPECT_FALSE(response.delta.has_value());
+}
@@ -0,0 +1,386 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file shm_transport_test.cpp
+ * @brief Unit tests for the shared-memory ring transport
+ *
+ * Tests cover:
+ * - Request/response round trip and peer credentials
+ * - Messages larger than a ring (streamed in chunks)
+ * - Many back-to-back messages in both directions
+ * - Wakeup after the consumer has gone to sleep
+ * - Disconnect handling (client close, server close, oversized frame)
+ * - Connection limit and receive timeout
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kcenon/database_server/gateway/shm_transport.h>
+
+#if defined(__linux__)
+
+#include <unistd.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+std::string make_socket_path()
+{
+	static std::atomic<int> counter{0};
+	return "/tmp/dbgw_shm_test_" + std::to_string(::getpid()) + "_"
+		   + std::to_string(counter.fetch_add(1)) + ".sock";
+}
+
+std::vector<uint8_t> bytes(const std::string& text)
+{
+	return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+std::string text(const std::vector<uint8_t>& data)
+{
+	return std::string(data.begin(), data.end());
+}
+
+} // namespace
+
+// ============================================================================
+// Transport Tests
+// ============================================================================
+
+class ShmTransportTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		config_.path = make_socket_path();
+		config_.ring_capacity = 4096;
+	}
+
+	void TearDown() override
+	{
+		if (listener_)
+		{
+			listener_->stop();
+		}
+		::unlink(config_.path.c_str());
+	}
+
+	void start_listener(bool echo = false)
+	{
+		listener_ = std::make_unique<shm_transport_listener>(config_);
+
+		listener_->set_connection_callback(
+			[this](std::shared_ptr<session_transport> session)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				sessions_.push_back(std::move(session));
+				cv_.notify_all();
+			});
+
+		listener_->set_disconnection_callback(
+			[this](std::string_view id)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				disconnected_.emplace_back(id);
+				cv_.notify_all();
+			});
+
+		listener_->set_receive_callback(
+			[this, echo](std::string_view id, const std::vector<uint8_t>& data)
+			{
+				std::shared_ptr<session_transport> session;
+				{
+					std::lock_guard<std::mutex> lock(mutex_);
+					messages_.emplace_back(std::string(id), text(data));
+					session = sessions_.empty() ? nullptr : sessions_.back();
+					cv_.notify_all();
+				}
+				if (echo && session)
+				{
+					(void)session->send(std::vector<uint8_t>(data));
+				}
+			});
+
+		ASSERT_TRUE(listener_->start().is_ok());
+	}
+
+	template<typename Predicate>
+	bool wait_for(Predicate predicate)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		return cv_.wait_for(lock, std::chrono::seconds(5), predicate);
+	}
+
+	shm_transport_config config_;
+	std::unique_ptr<shm_transport_listener> listener_;
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<std::shared_ptr<session_transport>> sessions_;
+	std::vector<std::pair<std::string, std::string>> messages_;
+	std::vector<std::string> disconnected_;
+};
+
+TEST_F(ShmTransportTest, RequestResponseRoundTrip)
+{
+	start_listener();
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	ASSERT_TRUE(client.send(bytes("hello")).is_ok());
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 1; }));
+	EXPECT_EQ(messages_[0].first, sessions_[0]->id());
+	EXPECT_EQ(messages_[0].second, "hello");
+
+	ASSERT_TRUE(sessions_[0]->send(bytes("world")).is_ok());
+	auto reply = client.receive(std::chrono::seconds(5));
+	ASSERT_TRUE(reply.is_ok());
+	EXPECT_EQ(text(reply.value()), "world");
+
+	EXPECT_EQ(sessions_[0]->transport_name(), "shm");
+	EXPECT_EQ(listener_->connection_count(), 1u);
+}
+
+TEST_F(ShmTransportTest, ProvidesPeerCredentials)
+{
+	start_listener();
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	auto peer = sessions_[0]->peer();
+	ASSERT_TRUE(peer.has_value());
+	EXPECT_EQ(peer->uid, static_cast<uint32_t>(::getuid()));
+	EXPECT_EQ(peer->pid, static_cast<int32_t>(::getpid()));
+}
+
+TEST_F(ShmTransportTest, StreamsMessagesLargerThanRing)
+{
+	start_listener(true);
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+
+	std::string large(config_.ring_capacity * 5 + 123, '\0');
+	for (size_t i = 0; i < large.size(); ++i)
+	{
+		large[i] = static_cast<char>('a' + i % 26);
+	}
+
+	// The echo is written while this thread is still sending, so receive
+	// on a second thread to keep both rings draining
+	std::vector<uint8_t> echoed;
+	std::thread receiver(
+		[&]
+		{
+			auto reply = client.receive(std::chrono::seconds(5));
+			if (reply.is_ok())
+			{
+				echoed = std::move(reply.value());
+			}
+		});
+
+	ASSERT_TRUE(client.send(bytes(large)).is_ok());
+	receiver.join();
+	EXPECT_EQ(text(echoed), large);
+}
+
+TEST_F(ShmTransportTest, ManyMessagesInOrder)
+{
+	start_listener(true);
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+
+	constexpr int count = 2000;
+	std::thread receiver(
+		[&]
+		{
+			for (int i = 0; i < count; ++i)
+			{
+				auto reply = client.receive(std::chrono::seconds(5));
+				ASSERT_TRUE(reply.is_ok());
+				ASSERT_EQ(text(reply.value()), "message-" + std::to_string(i));
+			}
+		});
+
+	for (int i = 0; i < count; ++i)
+	{
+		ASSERT_TRUE(client.send(bytes("message-" + std::to_string(i))).is_ok());
+	}
+	receiver.join();
+}
+
+TEST_F(ShmTransportTest, WakesSleepingConsumers)
+{
+	config_.spin_iterations = 0;
+	start_listener(true);
+
+	shm_client_config client_config;
+	client_config.spin_iterations = 0;
+	shm_client client(client_config);
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+
+	// Both sides are asleep on their eventfds between messages
+	for (int i = 0; i < 3; ++i)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		ASSERT_TRUE(client.send(bytes("ping")).is_ok());
+		auto reply = client.receive(std::chrono::seconds(5));
+		ASSERT_TRUE(reply.is_ok());
+		EXPECT_EQ(text(reply.value()), "ping");
+	}
+}
+
+TEST_F(ShmTransportTest, ReceiveTimesOut)
+{
+	start_listener();
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+
+	auto reply = client.receive(std::chrono::milliseconds(20));
+	EXPECT_TRUE(reply.is_err());
+	EXPECT_TRUE(client.is_connected());
+}
+
+TEST_F(ShmTransportTest, ClientCloseReportsDisconnection)
+{
+	start_listener();
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	ASSERT_TRUE(client.send(bytes("last words")).is_ok());
+	client.disconnect();
+
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	EXPECT_EQ(disconnected_[0], sessions_[0]->id());
+	EXPECT_FALSE(sessions_[0]->is_connected());
+	EXPECT_TRUE(sessions_[0]->send({1, 2, 3}).is_err());
+	EXPECT_EQ(listener_->connection_count(), 0u);
+
+	// Data written before closing is still delivered
+	ASSERT_EQ(messages_.size(), 1u);
+	EXPECT_EQ(messages_[0].second, "last words");
+}
+
+TEST_F(ShmTransportTest, ServerCloseEndsClientSession)
+{
+	start_listener();
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	ASSERT_TRUE(sessions_[0]->send(bytes("goodbye")).is_ok());
+	sessions_[0]->close();
+
+	// Already queued messages are delivered before the disconnect
+	auto reply = client.receive(std::chrono::seconds(5));
+	ASSERT_TRUE(reply.is_ok());
+	EXPECT_EQ(text(reply.value()), "goodbye");
+
+	EXPECT_TRUE(client.receive(std::chrono::seconds(5)).is_err());
+	EXPECT_FALSE(client.is_connected());
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+}
+
+TEST_F(ShmTransportTest, OversizedFrameDropsConnection)
+{
+	config_.max_frame_bytes = 16;
+	start_listener();
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+
+	ASSERT_TRUE(client.send(bytes(std::string(64, 'x'))).is_ok());
+
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	EXPECT_TRUE(messages_.empty());
+}
+
+TEST_F(ShmTransportTest, ConnectionLimitEnforced)
+{
+	config_.max_connections = 1;
+	start_listener();
+
+	shm_client first;
+	ASSERT_TRUE(first.connect(config_.path).is_ok());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	shm_client_config second_config;
+	second_config.connect_timeout_ms = 1000;
+	shm_client second(second_config);
+	EXPECT_TRUE(second.connect(config_.path).is_err());
+	EXPECT_EQ(listener_->connection_count(), 1u);
+}
+
+TEST_F(ShmTransportTest, StopDisconnectsClients)
+{
+	start_listener();
+
+	shm_client client;
+	ASSERT_TRUE(client.connect(config_.path).is_ok());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	listener_->stop();
+
+	EXPECT_FALSE(listener_->is_running());
+	EXPECT_NE(::access(config_.path.c_str(), F_OK), 0);
+	EXPECT_TRUE(client.receive(std::chrono::seconds(5)).is_err());
+	EXPECT_FALSE(client.is_connected());
+}
+
+TEST(ShmClientTest, ConnectFailsWithoutListener)
+{
+	shm_client client;
+	EXPECT_TRUE(client.connect("/tmp/dbgw_shm_missing.sock").is_err());
+	EXPECT_FALSE(client.is_connected());
+	EXPECT_TRUE(client.send(bytes("x")).is_err());
+}
+
+#endif // __linux__
@@ -0,0 +1,588 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file tls_listener_test.cpp
+ * @brief Unit tests for the TLS listener
+ *
+ * Tests cover:
+ * - Framed request/response round trip over TLS
+ * - Session resumption through tickets and through the server cache
+ * - Messages spanning many TLS records
+ * - Failed and stalled handshakes
+ * - Disconnect handling and certificate loading errors
+ * - Derived statistics (resumption ratio, per-byte crypto cost)
+ *
+ * A self-signed certificate is generated per test run. Listener tests are
+ * compiled only when the build has TLS support.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kcenon/database_server/gateway/tls_listener.h>
+
+using namespace database_server::gateway;
+
+// ============================================================================
+// Statistics Tests
+// ============================================================================
+
+TEST(TlsStatsTest, DerivedValuesHandleEmptyCounters)
+{
+	tls_stats stats;
+	EXPECT_DOUBLE_EQ(stats.resumption_ratio(), 0.0);
+	EXPECT_DOUBLE_EQ(stats.average_full_handshake_us(), 0.0);
+	EXPECT_DOUBLE_EQ(stats.average_resumed_handshake_us(), 0.0);
+	EXPECT_DOUBLE_EQ(stats.crypto_ns_per_byte(), 0.0);
+}
+
+TEST(TlsStatsTest, DerivedValues)
+{
+	tls_stats stats;
+	stats.full_handshakes = 1;
+	stats.resumed_handshakes = 3;
+	stats.full_handshake_us = 900;
+	stats.resumed_handshake_us = 300;
+	stats.bytes_encrypted = 600;
+	stats.bytes_decrypted = 400;
+	stats.record_crypto_ns = 2000;
+
+	EXPECT_DOUBLE_EQ(stats.resumption_ratio(), 75.0);
+	EXPECT_DOUBLE_EQ(stats.average_full_handshake_us(), 900.0);
+	EXPECT_DOUBLE_EQ(stats.average_resumed_handshake_us(), 100.0);
+	EXPECT_DOUBLE_EQ(stats.crypto_ns_per_byte(), 2.0);
+}
+
+#if !DATABASE_SERVER_HAS_TLS
+
+TEST(TlsListenerTest, StartFailsWithoutTlsSupport)
+{
+	tls_listener listener(tls_config{});
+	EXPECT_FALSE(tls_listener::is_available());
+	EXPECT_TRUE(listener.start().is_err());
+}
+
+#else
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+namespace
+{
+
+int connect_client(uint16_t port)
+{
+	int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	struct sockaddr_in address{};
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+std::vector<uint8_t> frame(const std::string& payload)
+{
+	auto length = static_cast<uint32_t>(payload.size());
+	std::vector<uint8_t> bytes = {static_cast<uint8_t>(length >> 24),
+								  static_cast<uint8_t>(length >> 16),
+								  static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)};
+	bytes.insert(bytes.end(), payload.begin(), payload.end());
+	return bytes;
+}
+
+/**
+ * @brief Write a self-signed P-256 certificate and key for localhost
+ */
+void write_test_certificate(const std::string& cert_path, const std::string& key_path)
+{
+	EVP_PKEY* key = nullptr;
+	EVP_PKEY_CTX* key_context = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+	EVP_PKEY_keygen_init(key_context);
+	EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_context, NID_X9_62_prime256v1);
+	EVP_PKEY_keygen(key_context, &key);
+	EVP_PKEY_CTX_free(key_context);
+
+	X509* cert = X509_new();
+	ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+	X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+	X509_gmtime_adj(X509_getm_notAfter(cert), 24 * 3600);
+	X509_set_pubkey(cert, key);
+	X509_NAME* name = X509_get_subject_name(cert);
+	X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+							   reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+	X509_set_issuer_name(cert, name);
+	X509_sign(cert, key, EVP_sha256());
+
+	FILE* file = std::fopen(cert_path.c_str(), "w");
+	PEM_write_X509(file, cert);
+	std::fclose(file);
+	file = std::fopen(key_path.c_str(), "w");
+	PEM_write_PrivateKey(file, key, nullptr, nullptr, 0, nullptr, nullptr);
+	std::fclose(file);
+
+	X509_free(cert);
+	EVP_PKEY_free(key);
+}
+
+/**
+ * @brief Blocking TLS client that trusts the test certificate
+ */
+class tls_client
+{
+public:
+	tls_client(SSL_CTX* context, uint16_t port, SSL_SESSION* session = nullptr)
+		: fd_(connect_client(port))
+		, ssl_(SSL_new(context))
+	{
+		SSL_set_fd(ssl_, fd_);
+		if (session != nullptr)
+		{
+			SSL_set_session(ssl_, session);
+		}
+		connected_ = fd_ >= 0 && SSL_connect(ssl_) == 1;
+	}
+
+	~tls_client()
+	{
+		SSL_free(ssl_);
+		if (fd_ >= 0)
+		{
+			::close(fd_);
+		}
+	}
+
+	[[nodiscard]] bool connected() const { return connected_; }
+
+	[[nodiscard]] bool resumed() const { return SSL_session_reused(ssl_) == 1; }
+
+	/// Session to resume later; TLS 1.3 tickets arrive after the handshake,
+	/// so call this after reading at least one message
+	[[nodiscard]] SSL_SESSION* session() const { return SSL_get1_session(ssl_); }
+
+	bool write(const std::vector<uint8_t>& bytes)
+	{
+		return SSL_write(ssl_, bytes.data(), static_cast<int>(bytes.size()))
+			   == static_cast<int>(bytes.size());
+	}
+
+	std::string read_frame()
+	{
+		uint8_t header[4];
+		if (!read_exact(header, 4))
+		{
+			return {};
+		}
+		uint32_t length = (uint32_t{header[0]} << 24) | (uint32_t{header[1]} << 16)
+						  | (uint32_t{header[2]} << 8) | uint32_t{header[3]};
+		std::string payload(length, '\0');
+		if (!read_exact(reinterpret_cast<uint8_t*>(payload.data()), length))
+		{
+			return {};
+		}
+		return payload;
+	}
+
+	void close()
+	{
+		SSL_shutdown(ssl_);
+		::close(fd_);
+		fd_ = -1;
+	}
+
+private:
+	bool read_exact(uint8_t* out, size_t size)
+	{
+		size_t offset = 0;
+		while (offset < size)
+		{
+			size_t received = 0;
+			if (SSL_read_ex(ssl_, out + offset, size - offset, &received) != 1)
+			{
+				return false;
+			}
+			offset += received;
+		}
+		return true;
+	}
+
+	int fd_;
+	SSL* ssl_;
+	bool connected_ = false;
+};
+
+} // namespace
+
+// ============================================================================
+// Listener Tests
+// ============================================================================
+
+class TlsListenerTest : public ::testing::Test
+{
+protected:
+	static void SetUpTestSuite()
+	{
+		directory_ = std::filesystem::temp_directory_path()
+					 / ("tls_listener_test_" + std::to_string(::getpid()));
+		std::filesystem::create_directories(directory_);
+		write_test_certificate((directory_ / "server.crt").string(),
+							   (directory_ / "server.key").string());
+	}
+
+	static void TearDownTestSuite()
+	{
+		std::filesystem::remove_all(directory_);
+	}
+
+	void SetUp() override
+	{
+		config_.host = "127.0.0.1";
+		config_.port = 0;
+		config_.cert_file = (directory_ / "server.crt").string();
+		config_.key_file = (directory_ / "server.key").string();
+
+		client_context_ = SSL_CTX_new(TLS_client_method());
+		SSL_CTX_set_verify(client_context_, SSL_VERIFY_PEER, nullptr);
+		SSL_CTX_load_verify_locations(client_context_, config_.cert_file.c_str(), nullptr);
+		SSL_CTX_set_session_cache_mode(client_context_, SSL_SESS_CACHE_CLIENT);
+	}
+
+	void TearDown() override
+	{
+		if (listener_)
+		{
+			listener_->stop();
+		}
+		SSL_CTX_free(client_context_);
+	}
+
+	void start_listener()
+	{
+		listener_ = std::make_unique<tls_listener>(config_);
+
+		listener_->set_connection_callback(
+			[this](std::shared_ptr<session_transport> session)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				sessions_.push_back(std::move(session));
+				cv_.notify_all();
+			});
+
+		listener_->set_disconnection_callback(
+			[this](std::string_view id)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				disconnected_.emplace_back(id);
+				cv_.notify_all();
+			});
+
+		listener_->set_receive_callback(
+			[this](std::string_view id, const std::vector<uint8_t>& data)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				messages_.emplace_back(std::string(id), std::string(data.begin(), data.end()));
+				cv_.notify_all();
+			});
+
+		auto result = listener_->start();
+		ASSERT_TRUE(result.is_ok()) << result.error().message;
+		ASSERT_NE(listener_->bound_port(), 0);
+	}
+
+	template<typename Predicate>
+	bool wait_for(Predicate predicate)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		return cv_.wait_for(lock, std::chrono::seconds(5), predicate);
+	}
+
+	/**
+	 * @brief Connect, exchange one message and return the session for resumption
+	 */
+	SSL_SESSION* connect_and_echo(SSL_SESSION* resume, bool expect_resumed)
+	{
+		size_t index = 0;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			index = sessions_.size();
+		}
+
+		tls_client client(client_context_, listener_->bound_port(), resume);
+		EXPECT_TRUE(client.connected());
+		EXPECT_EQ(client.resumed(), expect_resumed);
+		EXPECT_TRUE(wait_for([&] { return sessions_.size() == index + 1; }));
+		EXPECT_TRUE(client.write(frame("ping")));
+		EXPECT_TRUE(wait_for([&] { return messages_.size() == index + 1; }));
+
+		std::string reply = "pong";
+		EXPECT_TRUE(sessions_[index]->send(std::vector<uint8_t>(reply.begin(), reply.end())).is_ok());
+		EXPECT_EQ(client.read_frame(), "pong");
+
+		SSL_SESSION* session = client.session();
+		client.close();
+		EXPECT_TRUE(wait_for([&] { return disconnected_.size() == index + 1; }));
+		return session;
+	}
+
+	static inline std::filesystem::path directory_;
+
+	tls_config config_;
+	std::unique_ptr<tls_listener> listener_;
+	SSL_CTX* client_context_ = nullptr;
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<std::shared_ptr<session_transport>> sessions_;
+	std::vector<std::pair<std::string, std::string>> messages_;
+	std::vector<std::string> disconnected_;
+};
+
+TEST_F(TlsListenerTest, RequestResponseRoundTrip)
+{
+	EXPECT_TRUE(tls_listener::is_available());
+	start_listener();
+
+	tls_client client(client_context_, listener_->bound_port());
+	ASSERT_TRUE(client.connected());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	ASSERT_TRUE(client.write(frame("hello")));
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 1; }));
+	EXPECT_EQ(messages_[0].first, sessions_[0]->id());
+	EXPECT_EQ(messages_[0].second, "hello");
+
+	std::string reply = "world";
+	ASSERT_TRUE(sessions_[0]->send(std::vector<uint8_t>(reply.begin(), reply.end())).is_ok());
+	EXPECT_EQ(client.read_frame(), "world");
+
+	EXPECT_EQ(sessions_[0]->transport_name(), "tls");
+	EXPECT_EQ(listener_->connection_count(), 1u);
+
+	auto stats = listener_->get_stats();
+	EXPECT_EQ(stats.full_handshakes, 1u);
+	EXPECT_EQ(stats.resumed_handshakes, 0u);
+	EXPECT_EQ(stats.bytes_decrypted, 9u);
+	EXPECT_EQ(stats.bytes_encrypted, 9u);
+	EXPECT_GT(stats.full_handshake_us, 0u);
+}
+
+TEST_F(TlsListenerTest, ResumesSessionWithTicket)
+{
+	start_listener();
+
+	SSL_SESSION* session = connect_and_echo(nullptr, false);
+	ASSERT_NE(session, nullptr);
+	SSL_SESSION* resumed = connect_and_echo(session, true);
+	SSL_SESSION_free(session);
+	SSL_SESSION_free(resumed);
+
+	auto stats = listener_->get_stats();
+	EXPECT_EQ(stats.full_handshakes, 1u);
+	EXPECT_EQ(stats.resumed_handshakes, 1u);
+	EXPECT_DOUBLE_EQ(stats.resumption_ratio(), 50.0);
+}
+
+TEST_F(TlsListenerTest, ResumesSessionFromServerCacheWithoutTickets)
+{
+	config_.enable_session_tickets = false;
+	start_listener();
+
+	SSL_SESSION* session = connect_and_echo(nullptr, false);
+	ASSERT_NE(session, nullptr);
+	SSL_SESSION* resumed = connect_and_echo(session, true);
+	SSL_SESSION_free(session);
+	SSL_SESSION_free(resumed);
+
+	EXPECT_EQ(listener_->get_stats().resumed_handshakes, 1u);
+}
+
+TEST_F(TlsListenerTest, ResumesTls12Session)
+{
+	SSL_CTX_set_max_proto_version(client_context_, TLS1_2_VERSION);
+	start_listener();
+
+	SSL_SESSION* session = connect_and_echo(nullptr, false);
+	ASSERT_NE(session, nullptr);
+	SSL_SESSION* resumed = connect_and_echo(session, true);
+	SSL_SESSION_free(session);
+	SSL_SESSION_free(resumed);
+
+	EXPECT_EQ(listener_->get_stats().resumed_handshakes, 1u);
+}
+
+TEST_F(TlsListenerTest, LargeMessagesSpanRecords)
+{
+	start_listener();
+
+	tls_client client(client_context_, listener_->bound_port());
+	ASSERT_TRUE(client.connected());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	std::string large(1024 * 1024 + 7, 'L');
+	ASSERT_TRUE(client.write(frame(large)));
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 1; }));
+	EXPECT_EQ(messages_[0].second, large);
+
+	// Reply from another thread while the client reads
+	std::thread sender(
+		[this, &large]
+		{
+			EXPECT_TRUE(sessions_[0]->send(std::vector<uint8_t>(large.begin(), large.end())).is_ok());
+			EXPECT_TRUE(sessions_[0]->send({'e', 'n', 'd'}).is_ok());
+		});
+	EXPECT_EQ(client.read_frame(), large);
+	EXPECT_EQ(client.read_frame(), "end");
+	sender.join();
+
+	EXPECT_GT(listener_->get_stats().record_crypto_ns, 0u);
+}
+
+TEST_F(TlsListenerTest, NonTlsClientFailsHandshake)
+{
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+	auto bytes = frame("not a client hello");
+	ASSERT_EQ(::write(client, bytes.data(), bytes.size()), static_cast<ssize_t>(bytes.size()));
+
+	// The server answers with an alert (if anything) and closes the connection
+	uint8_t buffer[256];
+	while (::read(client, buffer, sizeof(buffer)) > 0)
+	{
+	}
+	::close(client);
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (listener_->get_stats().failed_handshakes == 0
+		   && std::chrono::steady_clock::now() < deadline)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	EXPECT_EQ(listener_->get_stats().failed_handshakes, 1u);
+	EXPECT_TRUE(sessions_.empty());
+	EXPECT_TRUE(disconnected_.empty());
+}
+
+TEST_F(TlsListenerTest, StalledHandshakeTimesOut)
+{
+	config_.handshake_timeout_ms = 100;
+	start_listener();
+
+	int client = connect_client(listener_->bound_port());
+	ASSERT_GE(client, 0);
+
+	uint8_t byte;
+	EXPECT_EQ(::read(client, &byte, 1), 0);
+	EXPECT_EQ(listener_->get_stats().failed_handshakes, 1u);
+	EXPECT_EQ(listener_->connection_count(), 0u);
+	EXPECT_TRUE(sessions_.empty());
+	::close(client);
+}
+
+TEST_F(TlsListenerTest, ServerCloseEndsClientStream)
+{
+	start_listener();
+
+	tls_client client(client_context_, listener_->bound_port());
+	ASSERT_TRUE(client.connected());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	sessions_[0]->close();
+
+	EXPECT_EQ(client.read_frame(), "");
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	EXPECT_TRUE(sessions_[0]->send({1, 2, 3}).is_err());
+}
+
+TEST_F(TlsListenerTest, StopDisconnectsSessions)
+{
+	start_listener();
+
+	tls_client client(client_context_, listener_->bound_port());
+	ASSERT_TRUE(client.connected());
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	listener_->stop();
+
+	EXPECT_FALSE(listener_->is_running());
+	EXPECT_EQ(disconnected_.size(), 1u);
+	EXPECT_EQ(listener_->connection_count(), 0u);
+	EXPECT_TRUE(sessions_[0]->send({1}).is_err());
+	EXPECT_EQ(client.read_frame(), "");
+}
+
+TEST_F(TlsListenerTest, MissingCertificateFailsStart)
+{
+	config_.cert_file = (directory_ / "missing.crt").string();
+	tls_listener listener(config_);
+
+	auto result = listener.start();
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().code, -12);
+	EXPECT_FALSE(listener.is_running());
+}
+
+TEST_F(TlsListenerTest, MismatchedKeyFailsStart)
+{
+	auto other = directory_ / "other";
+	std::filesystem::create_directories(other);
+	write_test_certificate((other / "server.crt").string(), (other / "server.key").string());
+	config_.key_file = (other / "server.key").string();
+	tls_listener listener(config_);
+
+	auto result = listener.start();
+	ASSERT_TRUE(result.is_err());
+	EXPECT_EQ(result.error().code, -13);
+}
+
+#endif // DATABASE_SERVER_HAS_TLS
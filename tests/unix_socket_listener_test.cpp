@@ -0,0 +1,411 @@
+// BSD 3-Clause License
+//
+// Copyright (c) 2025, kcenon
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file unix_socket_listener_test.cpp
+ * @brief Unit tests for the Unix domain socket listener
+ *
+ * Tests cover:
+ * - Framed request/response round trip
+ * - Frames split across and coalesced within reads
+ * - Peer credentials
+ * - Disconnect handling (client close, server close, oversized frame)
+ * - Connection limit and socket file handling
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kcenon/database_server/gateway/unix_socket_listener.h>
+
+#if !defined(_WIN32)
+
+#include <fstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace database_server::gateway;
+
+namespace
+{
+
+std::string make_socket_path()
+{
+	static std::atomic<int> counter{0};
+	return "/tmp/dbgw_test_" + std::to_string(::getpid()) + "_"
+		   + std::to_string(counter.fetch_add(1)) + ".sock";
+}
+
+int connect_client(const std::string& path)
+{
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	struct sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path.c_str());
+	if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0)
+	{
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+std::vector<uint8_t> frame(const std::string& payload)
+{
+	auto length = static_cast<uint32_t>(payload.size());
+	std::vector<uint8_t> bytes = {static_cast<uint8_t>(length >> 24),
+								  static_cast<uint8_t>(length >> 16),
+								  static_cast<uint8_t>(length >> 8), static_cast<uint8_t>(length)};
+	bytes.insert(bytes.end(), payload.begin(), payload.end());
+	return bytes;
+}
+
+void write_all(int fd, const std::vector<uint8_t>& bytes)
+{
+	size_t offset = 0;
+	while (offset < bytes.size())
+	{
+		auto written = ::write(fd, bytes.data() + offset, bytes.size() - offset);
+		ASSERT_GT(written, 0);
+		offset += static_cast<size_t>(written);
+	}
+}
+
+bool read_exact(int fd, uint8_t* out, size_t size)
+{
+	size_t offset = 0;
+	while (offset < size)
+	{
+		auto received = ::read(fd, out + offset, size - offset);
+		if (received <= 0)
+		{
+			return false;
+		}
+		offset += static_cast<size_t>(received);
+	}
+	return true;
+}
+
+std::string read_frame(int fd)
+{
+	uint8_t header[4];
+	if (!read_exact(fd, header, 4))
+	{
+		return {};
+	}
+	uint32_t length = (uint32_t{header[0]} << 24) | (uint32_t{header[1]} << 16)
+					  | (uint32_t{header[2]} << 8) | uint32_t{header[3]};
+	std::string payload(length, '\0');
+	if (!read_exact(fd, reinterpret_cast<uint8_t*>(payload.data()), length))
+	{
+		return {};
+	}
+	return payload;
+}
+
+} // namespace
+
+// ============================================================================
+// Listener Tests
+// ============================================================================
+
+class UnixSocketListenerTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		config_.path = make_socket_path();
+	}
+
+	void TearDown() override
+	{
+		if (listener_)
+		{
+			listener_->stop();
+		}
+		::unlink(config_.path.c_str());
+	}
+
+	void start_listener()
+	{
+		listener_ = std::make_unique<unix_socket_listener>(config_);
+
+		listener_->set_connection_callback(
+			[this](std::shared_ptr<session_transport> session)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				sessions_.push_back(std::move(session));
+				cv_.notify_all();
+			});
+
+		listener_->set_disconnection_callback(
+			[this](std::string_view id)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				disconnected_.emplace_back(id);
+				cv_.notify_all();
+			});
+
+		listener_->set_receive_callback(
+			[this](std::string_view id, const std::vector<uint8_t>& data)
+			{
+				std::lock_guard<std::mutex> lock(mutex_);
+				messages_.emplace_back(std::string(id), std::string(data.begin(), data.end()));
+				cv_.notify_all();
+			});
+
+		ASSERT_TRUE(listener_->start().is_ok());
+	}
+
+	template<typename Predicate>
+	bool wait_for(Predicate predicate)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		return cv_.wait_for(lock, std::chrono::seconds(5), predicate);
+	}
+
+	unix_socket_config config_;
+	std::unique_ptr<unix_socket_listener> listener_;
+
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::vector<std::shared_ptr<session_transport>> sessions_;
+	std::vector<std::pair<std::string, std::string>> messages_;
+	std::vector<std::string> disconnected_;
+};
+
+TEST_F(UnixSocketListenerTest, RequestResponseRoundTrip)
+{
+	start_listener();
+
+	int client = connect_client(config_.path);
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	write_all(client, frame("hello"));
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 1; }));
+	EXPECT_EQ(messages_[0].first, sessions_[0]->id());
+	EXPECT_EQ(messages_[0].second, "hello");
+
+	std::string reply = "world";
+	ASSERT_TRUE(sessions_[0]->send(std::vector<uint8_t>(reply.begin(), reply.end())).is_ok());
+	EXPECT_EQ(read_frame(client), "world");
+
+	EXPECT_EQ(sessions_[0]->transport_name(), "unix");
+	EXPECT_EQ(listener_->connection_count(), 1u);
+	::close(client);
+}
+
+TEST_F(UnixSocketListenerTest, ReassemblesSplitAndCoalescedFrames)
+{
+	start_listener();
+
+	int client = connect_client(config_.path);
+	ASSERT_GE(client, 0);
+
+	// Two frames in one write, then one frame split byte by byte
+	auto both = frame("first");
+	auto second = frame("second");
+	both.insert(both.end(), second.begin(), second.end());
+	write_all(client, both);
+
+	for (auto byte : frame("third"))
+	{
+		write_all(client, {byte});
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 3; }));
+	EXPECT_EQ(messages_[0].second, "first");
+	EXPECT_EQ(messages_[1].second, "second");
+	EXPECT_EQ(messages_[2].second, "third");
+	::close(client);
+}
+
+TEST_F(UnixSocketListenerTest, BoundedReadsDeliverEveryFrame)
+{
+	// One recv() per poll round; the remainder waits in the socket buffer
+	config_.max_read_bytes = 1;
+	start_listener();
+
+	int client = connect_client(config_.path);
+	ASSERT_GE(client, 0);
+
+	std::vector<uint8_t> burst;
+	for (int i = 0; i < 200; ++i)
+	{
+		auto next = frame("frame-" + std::to_string(i));
+		burst.insert(burst.end(), next.begin(), next.end());
+	}
+	write_all(client, burst);
+
+	ASSERT_TRUE(wait_for([this] { return messages_.size() == 200; }));
+	for (int i = 0; i < 200; ++i)
+	{
+		EXPECT_EQ(messages_[i].second, "frame-" + std::to_string(i));
+	}
+	::close(client);
+}
+
+TEST_F(UnixSocketListenerTest, ProvidesPeerCredentials)
+{
+	start_listener();
+
+	int client = connect_client(config_.path);
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	auto peer = sessions_[0]->peer();
+	ASSERT_TRUE(peer.has_value());
+	EXPECT_EQ(peer->uid, static_cast<uint32_t>(::getuid()));
+	EXPECT_EQ(peer->gid, static_cast<uint32_t>(::getgid()));
+#if defined(__linux__)
+	EXPECT_EQ(peer->pid, static_cast<int32_t>(::getpid()));
+#endif
+	::close(client);
+}
+
+TEST_F(UnixSocketListenerTest, ClientCloseReportsDisconnection)
+{
+	start_listener();
+
+	int client = connect_client(config_.path);
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	::close(client);
+
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	EXPECT_EQ(disconnected_[0], sessions_[0]->id());
+	EXPECT_FALSE(sessions_[0]->is_connected());
+	EXPECT_TRUE(sessions_[0]->send({1, 2, 3}).is_err());
+	EXPECT_EQ(listener_->connection_count(), 0u);
+}
+
+TEST_F(UnixSocketListenerTest, ServerCloseEndsClientStream)
+{
+	start_listener();
+
+	int client = connect_client(config_.path);
+	ASSERT_GE(client, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	sessions_[0]->close();
+
+	uint8_t byte;
+	EXPECT_EQ(::read(client, &byte, 1), 0);
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	::close(client);
+}
+
+TEST_F(UnixSocketListenerTest, OversizedFrameDropsConnection)
+{
+	config_.max_frame_bytes = 16;
+	start_listener();
+
+	int client = connect_client(config_.path);
+	ASSERT_GE(client, 0);
+
+	write_all(client, frame(std::string(64, 'x')));
+
+	ASSERT_TRUE(wait_for([this] { return disconnected_.size() == 1; }));
+	EXPECT_TRUE(messages_.empty());
+	::close(client);
+}
+
+TEST_F(UnixSocketListenerTest, ConnectionLimitEnforced)
+{
+	config_.max_connections = 1;
+	start_listener();
+
+	int first = connect_client(config_.path);
+	ASSERT_GE(first, 0);
+	ASSERT_TRUE(wait_for([this] { return sessions_.size() == 1; }));
+
+	int second = connect_client(config_.path);
+	ASSERT_GE(second, 0);
+
+	// The second connection is accepted and closed immediately
+	uint8_t byte;
+	EXPECT_EQ(::read(second, &byte, 1), 0);
+	EXPECT_EQ(listener_->connection_count(), 1u);
+
+	::close(first);
+	::close(second);
+}
+
+TEST_F(UnixSocketListenerTest, StopRemovesSocketFile)
+{
+	start_listener();
+	EXPECT_EQ(::access(config_.path.c_str(), F_OK), 0);
+
+	listener_->stop();
+
+	EXPECT_FALSE(listener_->is_running());
+	EXPECT_NE(::access(config_.path.c_str(), F_OK), 0);
+}
+
+TEST_F(UnixSocketListenerTest, ReplacesStaleSocket)
+{
+	start_listener();
+	listener_->stop();
+
+	// Simulate a crashed previous run that left its socket behind
+	int stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	struct sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", config_.path.c_str());
+	ASSERT_EQ(::bind(stale, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)), 0);
+	::close(stale);
+
+	unix_socket_listener listener(config_);
+	EXPECT_TRUE(listener.start().is_ok());
+	listener.stop();
+}
+
+TEST_F(UnixSocketListenerTest, RefusesToReplaceRegularFile)
+{
+	std::ofstream(config_.path) << "not a socket";
+
+	unix_socket_listener listener(config_);
+	EXPECT_TRUE(listener.start().is_err());
+	EXPECT_EQ(::access(config_.path.c_str(), F_OK), 0);
+}
+
+#endif // !_WIN32